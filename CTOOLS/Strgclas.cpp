@@ -153,7 +153,7 @@ void STRING::setText( const STRING &source )
 		text = source.text;
 		if( text )
 		{
-			text->usageCount++;
+			incUC( text );
 		}
 	}
 }
@@ -169,7 +169,7 @@ void STRING::setText( STR *source )
 	text = source;
 	if( text )
 	{
-		text->usageCount++;
+		incUC( text );
 	}
 }
 
@@ -261,7 +261,12 @@ int STRING::compare( const char *string ) const
 
 int STRING::compare( const STRING &string ) const
 {
-	if( isEmpty() && gak::isEmpty( string ) )
+	// shared buffers, e.g. interned names, are always equal
+	if( text == string.text )
+	{
+		return 0;
+	}
+	else if( isEmpty() && gak::isEmpty( string ) )
 	{
 		return 0;
 	}
@@ -306,7 +311,11 @@ int STRING::compareI( const char *string ) const
 
 int STRING::compareI( const STRING &string ) const
 {
-	if( isEmpty() && gak::isEmpty( string ) )
+	if( text == string.text )
+	{
+		return 0;
+	}
+	else if( isEmpty() && gak::isEmpty( string ) )
 	{
 		return 0;
 	}
@@ -590,11 +599,7 @@ void STRING::readLine( std::istream &theStream )
 
 	if( text )
 	{
-		if( !--(text->usageCount) )
-		{
-			free( text );
-		}
-
+		releaseStr( text );
 		text = nullptr;
 	}
 
@@ -42,6 +42,8 @@
 #include <gak/XPath.h>
 #include <gak/xml.h>
 #include <gak/numericString.h>
+#include <gak/hashMap.h>
+#include <gak/locker.h>
 #include <gak/logfile.h>
 
 // --------------------------------------------------------------------- //
@@ -79,6 +81,138 @@ namespace xml
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	the sinks receive the elements found by a location path
+*/
+class XPathArraySink
+{
+	XmlArray	&m_result;
+
+	public:
+	XPathArraySink( XmlArray &result ) : m_result( result )
+	{
+	}
+	void operator() ( Element *theElement )
+	{
+		m_result += theElement;
+	}
+};
+
+class XPathValueSink
+{
+	const STRING	&m_attribute;
+	STRING			&m_result;
+
+	public:
+	XPathValueSink( const STRING &attribute, STRING &result )
+	: m_attribute( attribute ), m_result( result )
+	{
+	}
+	void operator() ( Element *theElement )
+	{
+		if( m_attribute.isEmpty() )
+			m_result += theElement->getValue( PLAIN_MODE );
+		else
+			m_result += theElement->getAttribute( m_attribute );
+	}
+};
+
+class XPathCountSink
+{
+	const Element	*m_candidate;
+	bool			&m_found;
+	std::size_t		&m_count;
+
+	public:
+	XPathCountSink( const Element *candidate, bool &found, std::size_t &count )
+	: m_candidate( candidate ), m_found( found ), m_count( count )
+	{
+	}
+	void operator() ( Element *theElement )
+	{
+		if( theElement == m_candidate )
+			m_found = true;
+		++m_count;
+	}
+};
+
+/*
+	passes all elements of an axis with the tag of the step to the sink
+*/
+template <class SinkT>
+class XPathTagFilter
+{
+	const STRING	&m_baseTag;
+	bool			m_anyTag;
+	SinkT			&m_sink;
+
+	public:
+	XPathTagFilter( const STRING &baseTag, SinkT &sink )
+	: m_baseTag( baseTag ), m_anyTag( baseTag == "*" ), m_sink( sink )
+	{
+	}
+	void operator() ( Element *theElement, const STRING &tag )
+	{
+		if( m_anyTag || tag == m_baseTag )
+			m_sink( theElement );
+	}
+};
+
+/*
+	a least recently used cache of compiled expressions
+*/
+class ExpressionCache
+{
+	static const std::size_t	NO_ENTRY = std::size_t(-1);
+
+	struct Entry
+	{
+		STRING				text;
+		XPathExpressionPtr	expression;
+		std::size_t			prev, next;
+	};
+
+	Critical					m_lock;
+	bool						m_select;
+	HashMap<STRING,std::size_t>	m_index;
+	Array<Entry>				m_entries;
+	std::size_t					m_first, m_last;
+
+	void unlink( std::size_t pos );
+	void linkFirst( std::size_t pos );
+
+	public:
+	ExpressionCache( bool select )
+	: m_select( select ), m_first( NO_ENTRY ), m_last( NO_ENTRY )
+	{
+	}
+
+	XPathExpressionPtr get( const STRING &text );
+	void clear();
+};
+
+template <class SinkT>
+struct XPathLocation::StepSink
+{
+	const XPathLocation	&m_location;
+	std::size_t			m_stepIdx;
+	bool				m_inclPcData;
+	SinkT				&m_sink;
+
+	StepSink(
+		const XPathLocation &location, std::size_t stepIdx, bool inclPcData,
+		SinkT &sink
+	)
+	: m_location( location ), m_stepIdx( stepIdx ), m_inclPcData( inclPcData ),
+	m_sink( sink )
+	{
+	}
+	void operator() ( Element *theElement )
+	{
+		m_location.locate( m_stepIdx, theElement, m_inclPcData, m_sink );
+	}
+};
+
 // --------------------------------------------------------------------- //
 // ----- exported datas ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -87,6 +221,9 @@ namespace xml
 // ----- module static data -------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+static ExpressionCache	s_expressionCache( false );
+static ExpressionCache	s_selectCache( true );
+
 // --------------------------------------------------------------------- //
 // ----- class static data --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -99,6 +236,240 @@ namespace xml
 // ----- module functions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	the axis iterators visit the same elements in the same order like the
+	functions Element::getChildren, Element::getDescendants ... without
+	building an XmlArray
+*/
+template <class FuncT>
+static void forEachChild( Element *parent, bool inclPcData, FuncT &func )
+{
+	size_t	numElements = parent->getNumObjects();
+	for( size_t i=0; i<numElements; i++ )
+	{
+		Element	*theChild = parent->getElement( i );
+		STRING	tag = theChild->getTag();
+		if( inclPcData || !tag.isEmpty() )		// test tag due to xslt
+			func( theChild, tag );
+	}
+}
+
+template <class FuncT>
+static void forEachDescendant( Element *parent, bool inclPcData, FuncT &func )
+{
+	size_t	numElements = parent->getNumObjects();
+	for( size_t i=0; i<numElements; i++ )
+	{
+		Element	*theChild = parent->getElement( i );
+		STRING	tag = theChild->getTag();
+		if( inclPcData || !tag.isEmpty() )		// test tag due to xslt
+		{
+			func( theChild, tag );
+			forEachDescendant( theChild, inclPcData, func );
+		}
+	}
+}
+
+template <class FuncT>
+static void forEachReverseDescendant( Element *parent, bool inclPcData, FuncT &func )
+{
+	size_t	numElements = parent->getNumObjects();
+	for( size_t i=numElements-1; i<numElements; i-- )
+	{
+		Element	*theChild = parent->getElement( i );
+		STRING	tag = theChild->getTag();
+		if( inclPcData || !tag.isEmpty() )		// test tag due to xslt
+		{
+			forEachReverseDescendant( theChild, inclPcData, func );
+			func( theChild, tag );
+		}
+	}
+}
+
+template <class FuncT>
+static void forEachFollowing(
+	Element *context, bool inclPcData, bool descendants, FuncT &func
+)
+{
+	Element	*parent = context->getParent();
+	if( parent )
+	{
+		size_t	numElements = parent->getNumObjects();
+		for( size_t i = context->getIndex()+1; i<numElements; i++ )
+		{
+			Element	*sibling = parent->getElement( i );
+			STRING	tag = sibling->getTag();
+			if( inclPcData || !tag.isEmpty() )		// test tag due to xslt
+			{
+				func( sibling, tag );
+				if( descendants )
+					forEachDescendant( sibling, inclPcData, func );
+			}
+		}
+	}
+}
+
+template <class FuncT>
+static void forEachPreceding(
+	Element *context, bool inclPcData, bool descendants, FuncT &func
+)
+{
+	Element	*parent = context->getParent();
+	if( parent )
+	{
+		for( long i = context->getIndex()-1; i>=0; i-- )
+		{
+			Element	*sibling = parent->getElement( i );
+			STRING	tag = sibling->getTag();
+			if( inclPcData || !tag.isEmpty() )		// test tag due to xslt
+			{
+				if( descendants )
+					forEachReverseDescendant( sibling, inclPcData, func );
+				func( sibling, tag );
+			}
+		}
+	}
+}
+
+template <class FuncT>
+static void forEachAxisElement(
+	Element *context, xpathAxis axis, bool inclPcData, FuncT &func
+)
+{
+	switch( axis )
+	{
+		case XPATH_CHILD:
+			forEachChild( context, inclPcData, func );
+			break;
+		case XPATH_DESCENDANT:
+			forEachDescendant( context, inclPcData, func );
+			break;
+		case XPATH_FOLLOWING:
+			forEachFollowing( context, inclPcData, true, func );
+			break;
+		case XPATH_FOLLOWING_SIBLING:
+			forEachFollowing( context, inclPcData, false, func );
+			break;
+		case XPATH_PRECEDING:
+			forEachPreceding( context, inclPcData, true, func );
+			break;
+		case XPATH_PRECEDING_SIBLING:
+			forEachPreceding( context, inclPcData, false, func );
+			break;
+		case XPATH_SELF:
+			func( context, context->getTag() );
+			break;
+		case XPATH_PARENT:
+		{
+			Element	*parent = context->getParent();
+			if( parent )
+				func( parent, parent->getTag() );
+			break;
+		}
+		default:
+			break;
+	}
+}
+
+static xpathAxis getAxis( STRING axis )
+{
+	axis.stripBlanks();
+	if( axis == "child" )
+		return XPATH_CHILD;
+	else if( axis == "descendant" )
+		return XPATH_DESCENDANT;
+	else if( axis == "following" )
+		return XPATH_FOLLOWING;
+	else if( axis == "following-sibling" )
+		return XPATH_FOLLOWING_SIBLING;
+	else if( axis == "preceding" )
+		return XPATH_PRECEDING;
+	else if( axis == "preceding-sibling" )
+		return XPATH_PRECEDING_SIBLING;
+	else if( axis == "self" )
+		return XPATH_SELF;
+	else if( axis == "parent" )
+		return XPATH_PARENT;
+
+	return XPATH_UNKNOWN_AXIS;
+}
+
+static bool isPosition( const STRING &expression )
+{
+	for( size_t i=0; i<expression.strlen(); i++ )
+	{
+		if( !isdigit( expression[i] ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool toBool( const STRING &value )
+{
+	return !value.isEmpty() && value != "0";
+}
+
+static int toInt( const STRING &value )
+{
+	return value.isEmpty() ? 0 : value.getValueE<int>();
+}
+
+/*
+	applies an operator to the values of its operands
+*/
+static STRING applyOperator(
+	xsltOperator theOperator, const STRING &left, const STRING &right
+)
+{
+	STRING	result;
+
+	switch( theOperator )
+	{
+		case XSLT_EQUAL:
+			result = (left == right) ? "1" : "0";
+			break;
+		case XSLT_NOT_EQUAL:
+			result = (left != right) ? "1" : "0";
+			break;
+		case XSLT_LOG_AND:
+			result = (toBool( left ) && toBool( right )) ? "1" : "0";
+			break;
+		case XSLT_LOG_OR:
+			result = (toBool( left ) || toBool( right )) ? "1" : "0";
+			break;
+		case XSLT_MODULO:
+		case XSLT_DIVISION:
+		{
+			int	leftI = toInt( left );
+			int	rightI = toInt( right );
+			if( rightI )
+			{
+				result = formatNumber(
+					theOperator == XSLT_MODULO ? leftI % rightI : leftI / rightI
+				);
+			}
+			else
+				result = "NaN";
+			break;
+		}
+		case XSLT_PLUS:
+			result = formatNumber( toInt( left ) + toInt( right ) );
+			break;
+		case XSLT_MINUS:
+			result = formatNumber( toInt( left ) - toInt( right ) );
+			break;
+		case XSLT_MULTIPLY:
+			result = formatNumber( toInt( left ) * toInt( right ) );
+			break;
+		default:
+			break;
+	}
+
+	return result;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class inlines ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -111,21 +482,487 @@ namespace xml
 // ----- class static functions ---------------------------------------- //
 // --------------------------------------------------------------------- //
 
+XPathExpressionPtr XPathExpression::compile( const STRING &expression )
+{
+	return s_expressionCache.get( expression );
+}
+
+XPathExpressionPtr XPathExpression::compileSelect( const STRING &select )
+{
+	return s_selectCache.get( select );
+}
+
+void XPathExpression::clearCache()
+{
+	s_expressionCache.clear();
+	s_selectCache.clear();
+}
+
 // --------------------------------------------------------------------- //
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+void ExpressionCache::unlink( std::size_t pos )
+{
+	Entry	&entry = m_entries[pos];
+
+	if( entry.prev != NO_ENTRY )
+		m_entries[entry.prev].next = entry.next;
+	else
+		m_first = entry.next;
+
+	if( entry.next != NO_ENTRY )
+		m_entries[entry.next].prev = entry.prev;
+	else
+		m_last = entry.prev;
+}
+
+void ExpressionCache::linkFirst( std::size_t pos )
+{
+	Entry	&entry = m_entries[pos];
+
+	entry.prev = NO_ENTRY;
+	entry.next = m_first;
+	if( m_first != NO_ENTRY )
+		m_entries[m_first].prev = pos;
+	else
+		m_last = pos;
+	m_first = pos;
+}
+
+template <class SinkT>
+void XPathLocation::locate(
+	std::size_t stepIdx, Element *context, bool inclPcData, SinkT &sink
+) const
+{
+	if( stepIdx >= m_steps.size() )
+	{
+		sink( context );
+/*@*/	return;
+	}
+
+	const Step	&step = m_steps[stepIdx];
+	if( step.type == stROOT )
+	{
+		Element	*root = context;
+		for( Element *parent = root->getParent(); parent; parent = parent->getParent() )
+			root = parent;
+
+		locate( stepIdx+1, root, inclPcData, sink );
+	}
+	else if( step.type == stPARENT )
+	{
+		Element	*parent = context->getParent();
+		locate( stepIdx+1, parent ? parent : context, inclPcData, sink );
+	}
+	else if( step.type == stSELF )
+	{
+		locate( stepIdx+1, context, inclPcData, sink );
+	}
+	else
+	{
+		StepSink<SinkT>	nextStep( *this, stepIdx+1, inclPcData, sink );
+
+		if( !step.predicates.size() )
+		{
+			// no need to collect the elements
+			XPathTagFilter< StepSink<SinkT> >	filter( step.baseTag, nextStep );
+			forEachAxisElement( context, step.axis, inclPcData, filter );
+/*@*/		return;
+		}
+
+		XmlArray						testElements;
+		XPathArraySink					collector( testElements );
+		XPathTagFilter<XPathArraySink>	filter( step.baseTag, collector );
+
+		forEachAxisElement( context, step.axis, inclPcData, filter );
+
+		for(
+			size_t i=0;
+			i<step.predicates.size() && testElements.size();
+			i++
+		)
+		{
+			const Predicate	&predicate = step.predicates[i];
+			if( predicate.position )
+			{
+				Element *foundElement =
+					(predicate.position <= testElements.size())
+					? testElements[predicate.position-1]
+					: NULL;
+
+				testElements.clear();
+				if( foundElement )
+					testElements += foundElement;
+			}
+			else
+			{
+				testElements.first();
+				while( testElements.current() )
+				{
+					if( predicate.expression->evaluate( &testElements ) != "1" )
+						testElements.removeCurrent();
+					else
+						testElements.next();
+				}
+			}
+		}
+
+		for( size_t i=0; i<testElements.size(); i++ )
+		{
+			nextStep( testElements[i] );
+		}
+	}
+}
+
 // --------------------------------------------------------------------- //
 // ----- class protected ----------------------------------------------- //
 // --------------------------------------------------------------------- //
 
-// --------------------------------------------------------------------- //
-// ----- class virtuals ------------------------------------------------ //
-// --------------------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+XPathExpressionPtr ExpressionCache::get( const STRING &text )
+{
+	CriticalScope	scope( m_lock );
+
+	size_t	index = m_index.getElementIndex( text );
+	if( index != m_index.no_index )
+	{
+		size_t	pos = m_index.getValueAt( index );
+		if( pos != m_first )
+		{
+			unlink( pos );
+			linkFirst( pos );
+		}
+/*@*/	return m_entries[pos].expression;
+	}
+
+	XPathExpressionPtr	expression = new XPathExpression;
+	if( m_select )
+		expression->parseSelect( text );
+	else
+		expression->parseExpression( text );
+
+	size_t	pos;
+	if( m_entries.size() < XPATH_CACHE_SIZE )
+	{
+		pos = m_entries.size();
+		m_entries.createElement();
+	}
+	else
+	{
+		// replace the least recently used expression
+		pos = m_last;
+		unlink( pos );
+		m_index.removeElementByKey( m_entries[pos].text );
+	}
+
+	Entry	&entry = m_entries[pos];
+	entry.text = text;
+	entry.expression = expression;
+	linkFirst( pos );
+	m_index[text] = pos;
+
+	return expression;
+}
+
+void ExpressionCache::clear()
+{
+	CriticalScope	scope( m_lock );
+
+	m_index.clear();
+	m_entries.clear();
+	m_first = m_last = NO_ENTRY;
+}
+
+void XPathLocation::compile( const STRING &path )
+{
+	STRING	localPath = path;
+
+	m_steps.clear();
+	m_attribute = "";
+
+	/*
+		split the path with the rules of the old recursive locateElements
+	*/
+	while( true )
+	{
+		/*
+			handle abreviations
+		*/
+		if( localPath[0U] == '/' )
+		{
+			m_steps.createElement().type = stROOT;
+			localPath += (size_t)1;
+/*^*/		continue;
+		}
+		else if( localPath.beginsWith( "../" ) )
+		{
+			m_steps.createElement().type = stPARENT;
+			localPath += (size_t)3;
+/*^*/		continue;
+		}
+
+		if( localPath.beginsWith( "./" ) )
+			localPath += (size_t)2;
+
+		/*
+			attribute selection
+		*/
+		if( localPath.beginsWith( '@' ) )
+		{
+			m_steps.createElement().type = stSELF;
+			m_attribute = localPath;
+			m_attribute += (size_t)1;
+/*v*/		break;
+		}
+		else if( localPath.isEmpty() || localPath == "." )
+		{
+			m_steps.createElement().type = stSELF;
+/*v*/		break;
+		}
+
+		// find the next slash
+		size_t	i=0, len = localPath.strlen();
+		size_t	parenthesisCount = 0;
+		STRING	selector = localPath;
+		char	c = 0;
+		while( i<len )
+		{
+			c = localPath[i++];
+
+			if( c=='(' || c=='[' )
+				parenthesisCount++;
+			else if( c==')' || c==']' )
+				parenthesisCount--;
+			else if (c == '"' || c == '\'' )
+			{
+				while( i<len && localPath[i++] != c )
+					;
+			}
+			else if( c=='/' && !parenthesisCount )
+			{
+				break;
+			}
+		}
+		if( c == '/' )
+			selector = localPath.leftString( i-1 );
+		localPath = localPath.subString( i );
+
+		/*
+			the rest of the path is the attribute selection
+		*/
+		if( localPath[0U] == '@' )
+		{
+			m_attribute = localPath;
+			localPath = "";
+			m_attribute += (size_t)1;
+		}
+
+		Step	&step = m_steps.createElement();
+		step.type = stAXIS;
+
+		size_t	axisDelimiter = selector.searchText( "::" );
+		if( axisDelimiter != selector.no_index )
+		{
+			step.axis = getAxis( selector.leftString(axisDelimiter) );
+			selector += axisDelimiter+2;
+		}
+		else
+			step.axis = XPATH_CHILD;
+
+		size_t	bracketPos = selector.searchChar( '[' );
+		if( bracketPos != selector.no_index )
+		{
+			step.baseTag = selector.leftString( bracketPos );
+			selector += bracketPos;
+		}
+		else
+		{
+			step.baseTag = selector;
+			selector = "";
+		}
+		step.baseTag.stripBlanks();
+
+		/*
+			extract the predicates
+		*/
+		selector.stripBlanks();
+		while( selector.beginsWith('[') )
+		{
+			STRING	expression;
+			bool	complete = false;
+
+			parenthesisCount = 0;
+			len = selector.strlen();
+			i = 0;
+			while( i<len )
+			{
+				c = selector[i++];
+
+				if( c=='(' || c=='[' )
+					parenthesisCount++;
+				else if( c==')' || c==']' )
+				{
+					parenthesisCount--;
+					if( !parenthesisCount )
+					{
+						expression = selector.subString( 1, i-2 );
+						expression.stripBlanks();
+						selector += i;
+						selector.stripBlanks();
+						complete = true;
+/*v*/					break;
+					}
+				}
+				else if (c == '"' || c == '\'' )
+				{
+					while( i<len && selector[i++] != c )
+						;
+				}
+			}
+			if( !complete )
+			{
+				// missing bracket: ignore the rest
+/*v*/			break;
+			}
+
+			if( !expression.isEmpty() )
+			{
+				Predicate	&predicate = step.predicates.createElement();
+				if( isPosition( expression ) )
+				{
+					predicate.position = expression.getValueE<std::size_t>();
+					if( !predicate.position )
+					{
+						// [0] can never match
+						predicate.position = std::numeric_limits<std::size_t>::max();
+					}
+				}
+				else
+				{
+					predicate.position = 0;
+					predicate.expression = new XPathExpression;
+					predicate.expression->parseExpression( expression );
+				}
+			}
+		}
+
+		if( localPath.isEmpty() )
+/*v*/		break;
+	}
+}
+
+const STRING &XPathLocation::locate(
+	Element *context, XmlArray *result, bool inclPcData
+) const
+{
+	XPathArraySink	sink( *result );
+
+	locate( 0, context, inclPcData, sink );
+
+	return m_attribute;
+}
+
+STRING XPathLocation::valueOf( Element *context ) const
+{
+	STRING			result;
+	XPathValueSink	sink( m_attribute, result );
+
+	locate( 0, context, true, sink );
+
+	return result;
+}
+
+std::size_t XPathLocation::count(
+	Element *context, const Element *candidate, bool *found, bool inclPcData
+) const
+{
+	std::size_t		count = 0;
+	XPathCountSink	sink( candidate, *found, count );
+
+	*found = false;
+	locate( 0, context, inclPcData, sink );
+
+	return count;
+}
+
+void XPathExpression::parseExpression( const STRING &text )
+{
+	STRING	left, right, expression = stripExpression( text );
+
+	m_operator = locateOperator( expression, &left, &right );
+	if( m_operator )
+	{
+		m_type = etOPERATOR;
+		m_left = new XPathExpression;
+		m_left->parseExpression( left );
+		m_right = new XPathExpression;
+		m_right->parseExpression( right );
+	}
+	else if( (expression[0U] == '\'' || expression[0U] == '\"')
+	&& expression.strlen() >= 2
+	&& expression[expression.strlen()-1] == expression[0U] )
+	{
+		m_type = etCONSTANT;
+		m_constant = expression.subString( 1, expression.strlen() -2 );
+	}
+	else
+	{
+		m_type = etCONSTANT;
+		m_constant = expression;
+		for( size_t i=0; i<expression.strlen(); i++ )
+		{
+			char c = expression[i];
+			if( !isdigit( c ) && c != '.' )
+			{
+				parseSelect( expression );
+				break;
+			}
+		}
+	}
+}
+
+void XPathExpression::parseSelect( const STRING &select )
+{
+	m_operator = NO_OP;
+	if( select == "position()" )
+		m_type = etPOSITION;
+	else if( select == "last()" )
+		m_type = etLAST;
+	else
+		m_type = etLOCATION;
 
-// --------------------------------------------------------------------- //
-// ----- class publics ------------------------------------------------- //
-// --------------------------------------------------------------------- //
+	m_location.compile( select );
+}
+
+STRING XPathExpression::evaluate( XmlArray *source ) const
+{
+	switch( m_type )
+	{
+		case etOPERATOR:
+			return applyOperator(
+				m_operator, m_left->evaluate( source ), m_right->evaluate( source )
+			);
+		case etPOSITION:
+			return formatNumber( source->position() );
+		case etLAST:
+			return formatNumber( source->last() );
+		case etLOCATION:
+		{
+			Element	*context = source->current();
+			return context ? m_location.valueOf( context ) : STRING();
+		}
+		default:
+			return m_constant;
+	}
+}
 
 void Element::getChildren( XmlArray *result, bool inclPcData )
 {
@@ -247,260 +1084,9 @@ void Element::getPrecedings( XmlArray *result, bool inclPcData )
 
 STRING Element::locateElements( const STRING &path, XmlArray *result, bool inclPcData )
 {
-	/*
-		handle abreviations
-	*/
-	if( path[0U] == '/' )
-	{
-		STRING newPath = path;
-
-		newPath += (size_t)1;
-
-		Element	*parent = this;
-		Element *newParent = this;
-		while( true )
-		{
-			newParent = newParent->getParent();
-			if( newParent )
-				parent = newParent;
-			else
-/*v*/			break;
-		}
-
-/***/	return parent->locateElements( newPath, result, inclPcData );
-	}
-	else if( path.beginsWith( "../" ) )
-	{
-		STRING newPath = path;
-		newPath += (size_t)3;
-		Element	*parent = getParent();
-		if( !parent )
-			parent = this;
-
-/***/	return parent->locateElements( newPath, result, inclPcData );
-	}
-
-	STRING	attribute, localPath = path;
-	if( localPath.beginsWith( "./" ) )
-		localPath += (size_t)2;
-
-	/*
-		attribute selection
-	*/
-	if( localPath.beginsWith( '@' ) )
-	{
-		/*
-			return my self and the attribute name
-		*/
-		*result += this;
-		attribute = localPath;
-		attribute += (size_t)1;
-	}
-	else if( localPath.isEmpty() || localPath == "." )
-	{
-		/*
-			return my self and no attribute name
-		*/
-		*result += this;
-		attribute = "";
-	}
-	else
-	{
-		// find the next slash
-		size_t	i=0, len = localPath.strlen();
-		size_t	parenthesisCount = 0;
-		STRING	selector = localPath;
-		char	c = 0;
-		while( i<len )
-		{
-			c = localPath[i++];
-
-			if( c=='(' || c=='[' )
-				parenthesisCount++;
-			else if( c==')' || c==']' )
-				parenthesisCount--;
-			else if (c == '"' || c == '\'' )
-			{
-				while( i<len && localPath[i++] != c )
-					;
-			}
-			else if( c=='/' && !parenthesisCount )
-			{
-				break;
-			}
-		}
-		if( c == '/' )
-			selector = localPath.leftString( i-1 );
-		localPath = localPath.subString( i );
-
-
-		/*
-			the rest of the path is the attribute selection
-		*/
-		if( localPath[0U] == '@' )
-		{
-			attribute = localPath;
-			localPath = "";
-			attribute += (size_t)1;
-		}
-
-		size_t	axisDelimiter = selector.searchText( "::" );
-		STRING axis = ( axisDelimiter != selector.no_index )
-			? selector.leftString(axisDelimiter)
-			: (STRING)"child"
-		;
-
-		if( axisDelimiter != selector.no_index )
-			selector += axisDelimiter+2;
-
-		size_t	bracketPos = selector.searchChar( '[' );
-		STRING	baseTag = ( bracketPos != selector.no_index )
-			? selector.leftString( bracketPos )
-			: selector;
-
-		if( bracketPos != selector.no_index )
-			selector += bracketPos;
-		else
-			selector = "";
-
-		XmlArray	axisElements;
-
-		axis.stripBlanks();
-		if( axis == "child" )
-			getChildren( &axisElements, inclPcData );
-		else if( axis == "descendant" )
-			getDescendants( &axisElements, inclPcData );
-		else if( axis == "following" )
-			getFollowing( &axisElements, inclPcData );
-		else if( axis == "following-sibling" )
-			getFollowingSiblings( &axisElements, inclPcData );
-		else if( axis == "preceding" )
-			getPrecedings( &axisElements, inclPcData );
-		else if( axis == "preceding-sibling" )
-			getPrecedingSiblings( &axisElements, inclPcData );
-		else if( axis == "self" )
-			axisElements += this;
-		else if( axis == "parent" )
-		{
-			if( parent )
-			{
-				axisElements += static_cast<Element*>(parent);
-			}
-		}
-
-		XmlArray	testElements;
-		size_t numElements = axisElements.size();
-		baseTag.stripBlanks();
-		for( i=0; i<numElements; i++ )
-		{
-			Element	*theElement = axisElements[i];
-			if( theElement->getTag() == baseTag || baseTag == "*" )
-			{
-				testElements += theElement;
-			}
-		}
-
-
-		STRING	expression, expResult;
-		bool	isNumber;
-		size_t	position;
-		selector.stripBlanks();
-		while( selector.beginsWith('[') && testElements.size() )
-		{
-			/* extraxt the next expresseion */
-			parenthesisCount = 0;
-			len = selector.strlen();
-			expression = "";
-			i = 0;
-
-			while( i<len )
-			{
-				c = selector[i++];
-
-				if( c=='(' || c=='[' )
-					parenthesisCount++;
-				else if( c==')' || c==']' )
-				{
-					parenthesisCount--;
-					if( !parenthesisCount )
-					{
-						expression = selector.subString( 1, i-2 );
-						expression.stripBlanks();
-						selector += i;
-						selector.stripBlanks();
-/*v*/					break;
-					}
-
-				}
-				else if (c == '"' || c == '\'' )
-				{
-					while( i<len && localPath[i++] != c )
-						;
-				}
-			}
-
-			if( !expression.isEmpty() )
-			{
-				isNumber = true;
-				for( i=0; i<expression.strlen(); i++ )
-				{
-					if( !isdigit( expression[i] ) )
-					{
-						isNumber = false;
-/*v*/					break;
-					}
-				}
-
-				if( isNumber )
-				{
-					position = expression.getValueE<std::size_t>();
-					position--;
-					Element *foundElement =
-						(position < testElements.size())
-						? testElements[position]
-						: NULL;
-
-					testElements.clear();
-					testElements += foundElement;
-				}
-				else
-				{
-					testElements.first();
-					while( testElements.current() )
-					{
-						expResult = evaluate( expression, &testElements );
-						if( expResult != "1" )
-						{
-							testElements.removeCurrent();
-						}
-						else
-							testElements.next();
-					}
-				}
-			}
-		}
-
-		if( localPath.isEmpty() )
-		{
-			result->addElements( testElements );
-		}
-		else
-		{
-			for( i=0; i<testElements.size(); i++ )
-			{
-				if( attribute.isEmpty() )
-					attribute = testElements[i]->locateElements(
-						localPath, result, inclPcData
-					);
-				else
-					testElements[i]->locateElements(
-						localPath, result, inclPcData
-					);
-			}
-		}
-	}
-
-	return attribute;
+	return XPathExpression::compileSelect( path )->getLocation().locate(
+		this, result, inclPcData
+	);
 }
 
 // --------------------------------------------------------------------- //
@@ -509,34 +1095,7 @@ STRING Element::locateElements( const STRING &path, XmlArray *result, bool inclP
 
 STRING valueOf( XmlArray *sourceArray, const STRING &select )
 {
-	STRING		result;
-	if( select == "position()" )
-	{
-		result += formatNumber( sourceArray->position() );
-	}
-	else if( select == "last()" )
-	{
-		result += formatNumber( sourceArray->last() );
-	}
-	else
-	{
-		XmlArray	docElements;
-		Element	*source = sourceArray->current();
-		STRING		attribute = source->locateElements( select, &docElements, true );
-
-		if( attribute.isEmpty() )
-		{
-			for( size_t i=0; i<docElements.size(); i++ )
-				result += docElements[i]->getValue( PLAIN_MODE );
-		}
-		else
-		{
-			for( size_t i=0; i<docElements.size(); i++ )
-				result += docElements[i]->getAttribute( attribute );
-		}
-	}
-
-	return result;
+	return XPathExpression::compileSelect( select )->evaluate( sourceArray );
 }
 
 STRING stripExpression( const STRING &expression )
@@ -710,222 +1269,74 @@ STRING performEqual( STRING left, STRING right, XmlArray *source )
 {
 	doEnterFunction( "XML_TRANSFORMATOR::performEqual()" );
 
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	return (left == right) ? "1" : "0";
+	return applyOperator(
+		XSLT_EQUAL, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performNotEqual( STRING left, STRING right, XmlArray *source )
 {
 	doEnterFunction( "XML_TRANSFORMATOR::performNotEqual()" );
 
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	return (left != right) ? "1" : "0";
+	return applyOperator(
+		XSLT_NOT_EQUAL, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performLogAnd( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	bool	leftBool = (!left.isEmpty() && (left != "0"));
-	bool	rightBool = (!right.isEmpty() && (right != "0"));
-
-	return (leftBool && rightBool) ? "1" : "0";
+	return applyOperator(
+		XSLT_LOG_AND, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performLogOr( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	bool	leftBool = (!left.isEmpty() && (left != "0"));
-	bool	rightBool = (!right.isEmpty() && (right != "0"));
-
-	return (leftBool || rightBool) ? "1" : "0";
+	return applyOperator(
+		XSLT_LOG_OR, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performModulo( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	int		leftI, rightI;
-
-	if( left.isEmpty() )
-		leftI = 0;
-	else
-		leftI = left.getValueE<int>();
-
-	if( right.isEmpty() )
-		rightI = 0;
-	else
-		rightI = right.getValueE<int>();
-
-	STRING	result;
-	if( rightI )
-	{
-		int resultI = leftI % rightI;
-		result += formatNumber( resultI );
-	}
-	else
-		result = "NaN";
-
-	return result;
+	return applyOperator(
+		XSLT_MODULO, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performDivision( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	int		leftI, rightI;
-
-	if( left.isEmpty() )
-		leftI = 0;
-	else
-		leftI = left.getValueE<int>();
-
-	if( right.isEmpty() )
-		rightI = 0;
-	else
-		rightI = right.getValueE<int>();
-
-	STRING	result;
-	if( rightI )
-	{
-		int resultI = leftI / rightI;
-		result += formatNumber( resultI );
-	}
-	else
-		result = "NaN";
-
-	return result;
+	return applyOperator(
+		XSLT_DIVISION, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performPlus( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	int		leftI, rightI;
-
-	if( left.isEmpty() )
-		leftI = 0;
-	else
-		leftI = left.getValueE<int>();
-
-	if( right.isEmpty() )
-		rightI = 0;
-	else
-		rightI = right.getValueE<int>();
-
-	int		resultI = leftI + rightI;
-	STRING	result = formatNumber( resultI );
-
-	return result;
+	return applyOperator(
+		XSLT_PLUS, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performMinus( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	int		leftI, rightI;
-
-	if( left.isEmpty() )
-		leftI = 0;
-	else
-		leftI = left.getValueE<int>();
-
-	if( right.isEmpty() )
-		rightI = 0;
-	else
-		rightI = right.getValueE<int>();
-
-	int		resultI = leftI - rightI;
-	STRING	result = formatNumber( resultI );
-
-	return result;
+	return applyOperator(
+		XSLT_MINUS, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING performMultiply( STRING left, STRING right, XmlArray *source )
 {
-	left = evaluate( left, source );
-	right = evaluate( right, source );
-
-	int		leftI, rightI;
-
-	if( left.isEmpty() )
-		leftI = 0;
-	else
-		leftI = left.getValueE<int>();
-
-	if( right.isEmpty() )
-		rightI = 0;
-	else
-		rightI = right.getValueE<int>();
-
-	int		resultI = leftI * rightI;
-	STRING	result = formatNumber( resultI );
-
-	return result;
+	return applyOperator(
+		XSLT_MULTIPLY, evaluate( left, source ), evaluate( right, source )
+	);
 }
 
 STRING evaluate( STRING expression, XmlArray *source )
 {
 	doEnterFunction( "evaluate()" );
 
-	STRING	result, left, op, right;
-
-	expression = stripExpression( expression );
-
-	xsltOperator theOperator = locateOperator( expression, &left, &right );
-	if( theOperator )
-	{
-		if( theOperator == XSLT_EQUAL )
-			result = performEqual( left, right, source );
-		else if( theOperator == XSLT_NOT_EQUAL )
-			result = performNotEqual( left, right, source );
-		else if( theOperator == XSLT_LOG_AND )
-			result = performLogAnd( left, right, source );
-		else if( theOperator == XSLT_LOG_OR )
-			result = performLogOr( left, right, source );
-		else if( theOperator == XSLT_MODULO )
-			result = performModulo( left, right, source );
-		else if( theOperator == XSLT_PLUS )
-			result = performPlus( left, right, source );
-		else if( theOperator == XSLT_MINUS )
-			result = performMinus( left, right, source );
-		else if( theOperator == XSLT_MULTIPLY )
-			result = performMultiply( left, right, source );
-		else if( theOperator == XSLT_DIVISION )
-			result = performDivision( left, right, source );
-	}
-	else if( (expression[0U] == '\'' || expression[0U] == '\"')
-	&& expression.strlen() >= 2
-	&& expression[expression.strlen()-1] == expression[0U] )
-	{
-		result = expression.subString( 1, expression.strlen() -2 );
-	}
-	else
-	{
-		char c;
-		result = expression;
-		for( size_t i=0; i<expression.strlen(); i++ )
-		{
-			c = expression[i];
-			if( !isdigit( c ) && c != '.' )
-			{
-				result = valueOf( source, expression );
-				break;
-			}
-		}
-	}
-	return result;
+	return XPathExpression::compile( expression )->evaluate( source );
 }
 
 }	// namespace xml
@@ -40,6 +40,7 @@
 #include <gak/httpBaseServer.h>
 #include <gak/t_string.h>
 #include <gak/numericString.h>
+#include <gak/stringStream.h>
 #include <gak/logfile.h>
 
 // --------------------------------------------------------------------- //
@@ -89,6 +90,8 @@ namespace net
 // ----- class static data --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+HTTPfileCache	HTTPserverBase::s_fileCache;
+
 // --------------------------------------------------------------------- //
 // ----- prototypes ---------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -97,6 +100,103 @@ namespace net
 // ----- module functions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+static const char *parseRangeNumber( const char *cp, uint64 *value, bool *found )
+{
+	*value = 0;
+	*found = false;
+	while( *cp == ' ' )
+	{
+		++cp;
+	}
+	while( *cp >= '0' && *cp <= '9' )
+	{
+		*value = *value * 10 + uint64(*cp - '0');
+		*found = true;
+		++cp;
+	}
+	while( *cp == ' ' )
+	{
+		++cp;
+	}
+	return cp;
+}
+
+/*
+	returns true if the path contains a parent directory segment that
+	could leave the document root
+*/
+static bool hasParentSegment( const STRING &fileName )
+{
+	const char	*cp = fileName;
+	bool		segmentStart = true;
+
+	while( *cp )
+	{
+		if( segmentStart && cp[0] == '.' && cp[1] == '.' && (!cp[2] || cp[2] == '/' || cp[2] == '\\') )
+		{
+/*@*/		return true;
+		}
+		segmentStart = (*cp == '/' || *cp == '\\');
+		cp++;
+	}
+
+	return false;
+}
+
+/*
+	parses the Range header field, only one byte range is supported
+	returns 1 for a valid range, 0 if the range is ignored and -1 if the
+	range is not satisfiable
+*/
+static int parseByteRange( const STRING &range, uint64 fileSize, uint64 *first, uint64 *count )
+{
+	static const char	BYTES[] = "bytes=";
+
+	const char	*cp = range;
+	uint64		start, end;
+	bool		hasStart, hasEnd;
+
+	if( strncmpi( cp, BYTES, sizeof( BYTES )-1 ) || strchr( cp, ',' ) )
+	{
+/*@*/	return 0;
+	}
+	cp = parseRangeNumber( cp + sizeof( BYTES )-1, &start, &hasStart );
+	if( *cp++ != '-' )
+	{
+/*@*/	return 0;
+	}
+	cp = parseRangeNumber( cp, &end, &hasEnd );
+	if( *cp || (!hasStart && !hasEnd) || (hasStart && hasEnd && end < start) )
+	{
+/*@*/	return 0;
+	}
+
+	if( !hasStart )
+	{
+		// the last bytes of the file
+		if( !end || !fileSize )
+		{
+/*@*/		return -1;
+		}
+		*first = end < fileSize ? fileSize - end : 0;
+	}
+	else if( start >= fileSize )
+	{
+/*@*/	return -1;
+	}
+	else
+	{
+		*first = start;
+		if( hasEnd && end < fileSize )
+		{
+			fileSize = end + 1;
+		}
+	}
+	*count = fileSize - *first;
+
+	return 1;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class inlines ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -109,6 +209,47 @@ namespace net
 // ----- class static functions ---------------------------------------- //
 // --------------------------------------------------------------------- //
 
+bool HTTPserverBase::isRequestComplete( const char *data, size_t size )
+{
+	static const char	CONTENT_LENGTH[] = "Content-Length:";
+
+	const char	*endData = data + size;
+	const char	*body = nullptr;
+	size_t		contentLength = 0;
+
+	// the header ends with an empty line
+	for( const char *line = data; line < endData; )
+	{
+		const char	*endLine = static_cast<const char *>(
+			memchr( line, '\n', size_t(endData - line) )
+		);
+		if( !endLine )
+		{
+/*v*/		break;
+		}
+		if( endLine == line || (endLine == line+1 && *line == '\r') )
+		{
+			body = endLine+1;
+/*v*/		break;
+		}
+		if( size_t(endLine - line) > sizeof( CONTENT_LENGTH )-1
+		&& !strncmpi( line, CONTENT_LENGTH, sizeof( CONTENT_LENGTH )-1 ) )
+		{
+			contentLength = 0;
+			for( const char *cp = line + sizeof( CONTENT_LENGTH )-1; cp < endLine; ++cp )
+			{
+				if( *cp >= '0' && *cp <= '9' )
+				{
+					contentLength = contentLength*10 + size_t(*cp - '0');
+				}
+			}
+		}
+		line = endLine+1;
+	}
+
+	return body && size_t(endData - body) >= contentLength;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -118,27 +259,143 @@ namespace net
 // --------------------------------------------------------------------- //
 
 void HTTPserverBase::sendResponse(  void  )
+{
+	sendResponse( response.getBodyArray() );
+}
+
+void HTTPserverBase::sendResponse( const ArrayOfData &body  )
 {
 	if( !response.getStatusCode() )
 	{
 		response.setStatusCode( 500 );
 	}
 
-	std::ostream	out( this );
-	response.flushData( out );
-	out.flush();
+	/*
+		the put area shares the buffer with pipelined requests not yet
+		read, thus the response is sent with one call
+	*/
+	ArrayOfData	data;
+	{
+		oBinaryStream	out( data );
+		response.flushData( out, body );
+	}
+	sendData( data.getDataBuffer(), data.size() );
 }
 
-void HTTPserverBase::sendResponse( const ArrayOfData &body  )
+int HTTPserverBase::sendStaticFile( const STRING &fileName, const STRING &contentType )
 {
-	if( !response.getStatusCode() )
+	doEnterFunction("HTTPserverBase::sendStaticFile");
+
+	if( hasParentSegment( fileName ) )
 	{
-		response.setStatusCode( 500 );
+/*@*/	return 403;
+	}
+
+	DirectoryEntry	entry;
+
+	try
+	{
+		entry = DirectoryEntry( fileName );
+	}
+	catch( ... )
+	{
+/*@*/	return 404;
+	}
+	if( entry.directory )
+	{
+/*@*/	return 403;
+	}
+
+	const uint64		fileSize = entry.fileSize;
+	const std::time_t	modified = entry.modifiedDate.getUtcUnixSeconds();
+	const STRING		eTag = '"' + formatNumber( fileSize ) + '-' + formatNumber( modified ) + '"';
+
+	response.setETag( eTag );
+	response.setLastModified( entry.modifiedDate );
+	response.setAcceptRanges( true );
+	if( !contentType.isEmpty() )
+	{
+		response.setContentType( contentType );
+	}
+
+	uint64	first = 0, count = fileSize;
+	int		status = 200;
+
+	STRING	ifNoneMatch = request.headerLines["If-None-Match"];
+	STRING	ifModifiedSince = request.headerLines["If-Modified-Since"];
+	if( !ifNoneMatch.isEmpty() )
+	{
+		if( ifNoneMatch == "*" || ifNoneMatch.searchText( eTag ) != ifNoneMatch.no_index )
+		{
+			status = 304;
+		}
+	}
+	else if( !ifModifiedSince.isEmpty() )
+	{
+		try
+		{
+			DateTime	since;
+
+			since.setInetTime( ifModifiedSince );
+			if( modified <= since.getUtcUnixSeconds() )
+			{
+				status = 304;
+			}
+		}
+		catch( ... )
+		{
+			// invalid dates are ignored
+		}
+	}
+
+	STRING	range = request.headerLines["Range"];
+	if( status == 200 && !range.isEmpty() )
+	{
+		int	rangeFound = parseByteRange( range, fileSize, &first, &count );
+		if( rangeFound > 0 )
+		{
+			status = 206;
+			response.setContentRange(
+				"bytes " + formatNumber( first ) + '-' + formatNumber( first+count-1 ) + '/' + formatNumber( fileSize )
+			);
+		}
+		else if( rangeFound < 0 )
+		{
+			status = 416;
+			response.setContentRange( "bytes */" + formatNumber( fileSize ) );
+		}
+	}
+	if( status != 200 && status != 206 )
+	{
+		count = 0;
+	}
+	response.setStatusCode( status );
+
+	ArrayOfData	data;
+	bool		sendBody;
+	{
+		oBinaryStream	out( data );
+		sendBody = response.flushHeader( out, count );
+	}
+	if( !sendBody || !count )
+	{
+		sendData( data.getDataBuffer(), data.size() );
+/*@*/	return 0;
+	}
+
+	HTTPfileCache::CachedFilePtr	cachedFile = s_fileCache.getFile( entry );
+	if( cachedFile )
+	{
+		// small files are sent with the header
+		data.addElements( cachedFile->getData().getDataBuffer() + first, size_t(count) );
+		sendData( data.getDataBuffer(), data.size() );
+	}
+	else
+	{
+		SocketStreambuf::sendFile( data.getDataBuffer(), data.size(), fileName, first, count );
 	}
 
-	std::ostream	out( this );
-	response.flushData( out, body );
-	out.flush();
+	return 0;
 }
 
 // --------------------------------------------------------------------- //
@@ -147,7 +404,7 @@ void HTTPserverBase::sendResponse( const ArrayOfData &body  )
 
 int HTTPserverBase::underflow( void )
 {
-	if( headerReading || !request.contentLength || bytesStreamed < requestSize )
+	if( headerReading || !hasContentLength || bytesStreamed < requestSize )
 	{
 		int returnChar = ServerProcessorBase::underflow();
 
@@ -185,7 +442,8 @@ int HTTPserverBase::handlePostRequest( const STRING &url )
 	size_t	i=0;
 	int		c;
 
-	while( (c=getNextByte()) >= 0 )
+	// do not read the next request of a persistent connection
+	while( (!hasContentLength || i < request.contentLength) && (c=getNextByte()) >= 0 )
 	{
 		body[i++] = (unsigned char)c;
 	}
@@ -211,12 +469,20 @@ void HTTPserverBase::runServerThread( void )
 	int			status;
 
 	headerReading = true;
-	bytesStreamed =	m_bytesRead = 0;
+	hasContentLength = false;
+	m_bytesRead = requestSize = 0;
+	// a SocketReactor or the previous request may already have received the request
+	bytesStreamed = egptr() - gptr();
+
+	request.headerLines.clear();
+	request.body.clear();
+	response.reset();
 
 	// first line must be the method + URL
 	headerLine = getNextLine();
 	request.method = headerLine.getFirstToken( " " );
 	request.url = headerLine.getNextToken();
+	request.version = headerLine.getNextToken();
 	request.contentLength = 0;
 	do
 	{
@@ -233,6 +499,7 @@ void HTTPserverBase::runServerThread( void )
 				{
 					requestSize = fieldValue.getValueE<size_t>();
 					request.contentLength = requestSize;
+					hasContentLength = true;
 				}
 				else
 					request.headerLines[fieldName] = fieldValue;
@@ -250,6 +517,13 @@ void HTTPserverBase::runServerThread( void )
 	headerReading = false;
 	requestSize += m_bytesRead;
 
+	CI_STRING	connection = STRING( request.headerLines["Connection"] );
+	bool		keepAlive = mayKeepAlive() && !m_socketError && !request.method.isEmpty()
+		&& (request.version == "HTTP/1.1" ? connection != "close" : connection == "keep-alive")
+		&& (hasContentLength || (request.method != "post" && request.method != "put"));
+
+	response.setKeepAlive( keepAlive );
+
 	if( request.method == "get" )
 		status = handleGetRequest( request.url );
 	else if( request.method == "head" )
@@ -268,6 +542,14 @@ void HTTPserverBase::runServerThread( void )
 
 		sendResponse();
 	}
+
+	if( keepAlive )
+	{
+		// skip the body the handler did not read
+		while( m_bytesRead < requestSize && getNextByte() >= 0 )
+			;
+		setKeepAlive( !m_socketError );
+	}
 }
 
 // --------------------------------------------------------------------- //
@@ -0,0 +1,256 @@
+/*
+		Project:		GAKLIB
+		Module:			httpFileCache.cpp
+		Description:	In-memory cache for static files of an HTTP server
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/httpFileCache.h>
+#include <gak/arrayFile.h>
+#include <gak/logfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace net
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void HTTPfileCache::removeLeastRecentlyUsed( size_t maxSize )
+{
+	while( m_size > maxSize && m_files.size() )
+	{
+		size_t	oldest = 0;
+
+		for( size_t i=1; i<m_files.size(); ++i )
+		{
+			if( m_files.getValueAt( i )->m_lastUse < m_files.getValueAt( oldest )->m_lastUse )
+			{
+				oldest = i;
+			}
+		}
+		m_size -= m_files.getValueAt( oldest )->m_data.size();
+		m_files.removeElementAt( oldest );
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+void HTTPfileCache::setLimits( size_t maxSize, size_t maxFileSize )
+{
+	CriticalScope	scope( m_lock );
+
+	m_maxSize = maxSize;
+	m_maxFileSize = maxFileSize;
+
+	for( size_t i=m_files.size(); i--; )
+	{
+		const ArrayOfData &data = m_files.getValueAt( i )->m_data;
+		if( data.size() > maxFileSize )
+		{
+			m_size -= data.size();
+			m_files.removeElementAt( i );
+		}
+	}
+	removeLeastRecentlyUsed( maxSize );
+}
+
+HTTPfileCache::CachedFilePtr HTTPfileCache::getFile( const DirectoryEntry &entry )
+{
+	doEnterFunction( "HTTPfileCache::getFile" );
+
+	const STRING		fileName = entry.fileName;
+	const std::time_t	modified = entry.modifiedDate.getUtcUnixSeconds();
+
+	{
+		CriticalScope	scope( m_lock );
+
+		if( entry.fileSize > m_maxFileSize )
+		{
+/*@*/		return CachedFilePtr();
+		}
+
+		size_t	index = m_files.getElementIndex( fileName );
+		if( index != m_files.no_index )
+		{
+			CachedFilePtr	file = m_files.getValueAt( index );
+			if( file->m_fileSize == entry.fileSize && file->m_modified == modified )
+			{
+				file->m_lastUse = ++m_useCounter;
+				++m_numHits;
+/*@*/			return file;
+			}
+
+			// the file was modified
+			m_size -= file->m_data.size();
+			m_files.removeElementAt( index );
+		}
+		++m_numMisses;
+	}
+
+	// do not block the other workers while reading the file
+	CachedFilePtr	file = new CachedFile;
+	try
+	{
+		readFromFile( &file->m_data, fileName );
+	}
+	catch( ... )
+	{
+/*@*/	return CachedFilePtr();
+	}
+	if( file->m_data.size() != entry.fileSize )
+	{
+		// the file was modified while reading
+/*@*/	return CachedFilePtr();
+	}
+	file->m_fileSize = entry.fileSize;
+	file->m_modified = modified;
+
+	CriticalScope	scope( m_lock );
+
+	size_t	index = m_files.getElementIndex( fileName );
+	if( index != m_files.no_index )
+	{
+		// another worker was faster
+		m_size -= m_files.getValueAt( index )->m_data.size();
+		m_files.removeElementAt( index );
+	}
+	if( file->m_data.size() <= m_maxSize )
+	{
+		removeLeastRecentlyUsed( m_maxSize - file->m_data.size() );
+		file->m_lastUse = ++m_useCounter;
+		m_files[fileName] = file;
+		m_size += file->m_data.size();
+	}
+
+	return file;
+}
+
+void HTTPfileCache::clear()
+{
+	CriticalScope	scope( m_lock );
+
+	m_files.clear();
+	m_size = 0;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace net
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
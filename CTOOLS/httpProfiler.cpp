@@ -39,8 +39,15 @@
 
 #include <gak/httpProfiler.h>
 #include <gak/numericString.h>
+#include <gak/t_string.h>
+#include <gak/thread.h>
+#include <gak/compare.h>
 #include <gak/logfile.h>
 
+#ifndef _Windows
+#	include <sys/time.h>
+#endif
+
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -62,6 +69,33 @@ namespace net
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	one client of HTTPprofiler::loadTest
+*/
+class HTTPloadClient : public Thread
+{
+	STRING			m_host;
+	int				m_port;
+	STRING			m_request;
+	size_t			m_numRequests, m_pipelineDepth;
+
+	virtual void ExecuteThread();
+
+	public:
+	Array<double>	m_latencies;
+	size_t			m_numErrors;
+
+	HTTPloadClient(
+		const STRING &host, int port, const STRING &path,
+		size_t numRequests, size_t pipelineDepth
+	) : m_host( host ), m_port( port ),
+		m_numRequests( numRequests ), m_pipelineDepth( pipelineDepth ? pipelineDepth : 1 ),
+		m_numErrors( 0 )
+	{
+		m_request = "GET " + path + " HTTP/1.1\r\nHost: " + host + "\r\n\r\n";
+	}
+};
+
 // --------------------------------------------------------------------- //
 // ----- module static data -------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -90,6 +124,84 @@ namespace net
 // ----- module functions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	returns a time in milliseconds with a resolution of microseconds
+*/
+static double getLoadTime()
+{
+#ifdef _Windows
+	LARGE_INTEGER	frequency, counter;
+
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &counter );
+
+	return double(counter.QuadPart) * 1000.0 / double(frequency.QuadPart);
+#else
+	timeval	now;
+
+	gettimeofday( &now, NULL );
+
+	return double(now.tv_sec) * 1000.0 + double(now.tv_usec) / 1000.0;
+#endif
+}
+
+/*
+	reads one response of a persistent connection, the body is skipped
+*/
+static bool readLoadResponse( SocketStreambuf &socket, bool *closed )
+{
+	T_STRING	line = socket.getNextLine();
+	size_t		contentLength = 0;
+
+	*closed = false;
+	if( line.isEmpty() )
+	{
+		*closed = true;
+/*@*/	return false;
+	}
+
+	line.getFirstToken( " " );
+	int status = getValue<int>( line.getNextToken() );
+
+	for(;;)
+	{
+		line = socket.getNextLine();
+		if( line.isEmpty() )
+		{
+/*v*/		break;
+		}
+
+		size_t colonPos = line.searchChar( ':' );
+		if( colonPos != line.no_index )
+		{
+			CI_STRING	fieldName = line.leftString( colonPos );
+			STRING		fieldValue = line.subString( colonPos+1 ).stripBlanks();
+
+			if( fieldName == "Content-Length" )
+			{
+				contentLength = getValue<size_t>( fieldValue );
+			}
+			else if( fieldName == "Connection" )
+			{
+				*closed = CI_STRING( fieldValue ) == "close";
+			}
+		}
+	}
+
+	while( contentLength && socket.getNextByte() >= 0 )
+	{
+		--contentLength;
+	}
+
+	if( contentLength )
+	{
+		*closed = true;
+/*@*/	return false;
+	}
+
+	return status >= 200 && status < 400;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class inlines ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -102,6 +214,80 @@ namespace net
 // ----- class static functions ---------------------------------------- //
 // --------------------------------------------------------------------- //
 
+HTTPloadStatistic HTTPprofiler::loadTest(
+	const STRING &url, size_t numClients, size_t numRequests, size_t pipelineDepth
+)
+{
+	doEnterFunction( "HTTPprofiler::loadTest" );
+
+	HTTPloadStatistic	statistic = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	STRING				host, path;
+	int					port = 80;
+
+	// http://host[:port]/path
+	size_t	hostStart = url.searchText( "://" );
+	hostStart = hostStart == url.no_index ? 0 : hostStart+3;
+
+	size_t	pathStart = url.searchChar( '/', hostStart );
+	if( pathStart == url.no_index )
+	{
+		host = url.subString( hostStart );
+		path = "/";
+	}
+	else
+	{
+		host = url.subString( hostStart, pathStart-hostStart );
+		path = url.subString( pathStart );
+	}
+
+	size_t	colonPos = host.searchChar( ':' );
+	if( colonPos != host.no_index )
+	{
+		port = getValue<int>( host.subString( colonPos+1 ) );
+		host = host.leftString( colonPos );
+	}
+
+	Array< SharedObjectPointer<HTTPloadClient> >	clients;
+	double	startTime = getLoadTime();
+
+	for( size_t i=0; i<numClients; ++i )
+	{
+		SharedObjectPointer<HTTPloadClient>	client = new HTTPloadClient(
+			host, port, path, numRequests, pipelineDepth
+		);
+		client->StartThread( "HTTPloadClient" );
+		clients += client;
+	}
+
+	Array<double>	latencies;
+	for( size_t i=0; i<numClients; ++i )
+	{
+		clients[i]->join();
+		latencies.addElements( clients[i]->m_latencies );
+		statistic.numErrors += clients[i]->m_numErrors;
+	}
+
+	statistic.totalTime = getLoadTime() - startTime;
+	statistic.numRequests = latencies.size() + statistic.numErrors;
+	if( latencies.size() )
+	{
+		latencies.sort( FixedComparator<double>() );
+
+		const size_t	last = latencies.size() - 1;
+
+		statistic.latency50 = latencies[last * 50 / 100];
+		statistic.latency90 = latencies[last * 90 / 100];
+		statistic.latency99 = latencies[last * 99 / 100];
+		statistic.maxLatency = latencies[last];
+		if( statistic.totalTime > 0 )
+		{
+			statistic.requestsPerSecond = double(statistic.numRequests) * 1000.0 / statistic.totalTime;
+		}
+	}
+
+	return statistic;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -327,6 +513,75 @@ size_t HTTPprofiler::GetTree(
 // ----- class virtuals ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+void HTTPloadClient::ExecuteThread()
+{
+	doEnterFunction( "HTTPloadClient::ExecuteThread" );
+
+	SocketStreambuf	socket;
+	bool			connected = false;
+	size_t			numDone = 0;
+
+	while( numDone < m_numRequests && !terminated )
+	{
+		if( !connected )
+		{
+			if( socket.connect( m_host, m_port ) )
+			{
+				m_numErrors += m_numRequests - numDone;
+/*v*/			break;
+			}
+			connected = true;
+		}
+
+		size_t		numPipelined = m_numRequests - numDone;
+		ArrayOfData	requests;
+
+		if( numPipelined > m_pipelineDepth )
+		{
+			numPipelined = m_pipelineDepth;
+		}
+		for( size_t i=0; i<numPipelined; ++i )
+		{
+			requests.addElements( m_request, m_request.strlen() );
+		}
+
+		double	startTime = getLoadTime();
+		bool	closed = false;
+
+		if( socket.sendData( requests.getDataBuffer(), requests.size() ) )
+		{
+			m_numErrors += numPipelined;
+			numDone += numPipelined;
+			closed = true;
+		}
+		for( size_t i=0; i<numPipelined && !closed; ++i )
+		{
+			bool ok = readLoadResponse( socket, &closed );
+
+			++numDone;
+			if( ok )
+			{
+				m_latencies += getLoadTime() - startTime;
+			}
+			else
+			{
+				++m_numErrors;
+			}
+			// pipelined requests without a response are sent again with a new connection
+		}
+		if( closed )
+		{
+			socket.disconnect();
+			connected = false;
+		}
+	}
+
+	if( connected )
+	{
+		socket.disconnect();
+	}
+}
+
 // --------------------------------------------------------------------- //
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
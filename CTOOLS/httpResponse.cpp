@@ -92,11 +92,14 @@ struct HTTP_STATUS_CODES
 } httpStatusCodes[] =
 {
 	{ 200, "OK" },
+	{ 206, "Partial Content" },
 	{ 301, "Moved Permanently" },
 	{ 302, "Found" },
 	{ 304, "Not Modified" },
 	{ 401, "Unauthorized" },
+	{ 403, "Forbidden" },
 	{ 404, "Object Not Found" },
+	{ 416, "Range Not Satisfiable" },
 	{ 500, "Internal Server Error" },
 	{ 501, "Not Implemented" },
 	{ -1, NULL },
@@ -190,7 +193,7 @@ STRING HTTPcgiResponse::getLocation( const STRING &location ) const
 	return newLocation;
 }
 
-void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
+bool HTTPserverResponse::flushHeader( std::ostream &out, uint64 contentLength )
 {
 	if( m_statusCode )
 	{
@@ -214,7 +217,7 @@ void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
 		sendStatusCode( out );
 	}
 
-	out << "Connection: close" << m_endln;
+	out << "Connection: " << (m_keepAlive ? "keep-alive" : "close") << m_endln;
 	out << "Server: GAKLIB Web Server Toolkit (" __DATE__ "-" __TIME__ ")" << m_endln;
 	out << "Date: " << DateTime().getLocalTime() << m_endln;
 
@@ -229,8 +232,11 @@ void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
 		out << "Pragma: no-cache" << m_endln
 			<< "Cache-Control: no-cache" << m_endln
 			<< "Content-Type: text/html" << m_endln
+			<< "Content-Length: " << value.strlen() << m_endln
 			<< m_endln
 			<< value;
+
+/*@*/	return false;
 	}
 	else
 	{
@@ -281,6 +287,8 @@ void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
 				<< (m_location.strlen()+strlen(m_endln)) << m_endln
 				<< m_endln
 				<< m_location << m_endln;
+
+/*@*/		return false;
 		}
 		else
 		{
@@ -292,6 +300,14 @@ void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
 			{
 				out << "ETag: " << m_eTag << m_endln;
 			}
+			if( m_acceptRanges )
+			{
+				out << "Accept-Ranges: bytes" << m_endln;
+			}
+			if( !m_contentRange.isEmpty() )
+			{
+				out << "Content-Range: " << m_contentRange << m_endln;
+			}
 
 			out << "Content-Type: "
 				<< (m_contentType.isEmpty()
@@ -303,16 +319,20 @@ void HTTPserverResponse::flushData( std::ostream &out, const ArrayOfData &body )
 			}
 			out << m_endln;
 
-			if( body.size() )
+			/*
+				the client of a persistent connection needs the end of the response,
+				a 304 ends with the header and its Content-Length would be taken
+				as the size of the document (RFC 7230 3.3.2)
+			*/
+			if( m_statusCode != 304 )
 			{
-				out << "Content-Length: " << body.size() << m_endln
-					<< m_endln;
-
-				out.write( body.getDataBuffer(), body.size() );
+				out << "Content-Length: " << contentLength << m_endln;
 			}
+			out << m_endln;
 		}
 	}
-	out.flush();
+
+	return true;
 }
 
 // --------------------------------------------------------------------- //
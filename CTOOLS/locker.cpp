@@ -111,35 +111,65 @@ namespace gak
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
-bool Locker::lock( const StopWatch &sw, unsigned long timeOut )
+bool Locker::lockContended( ThreadID threadId, unsigned long timeOut )
 {
-	ThreadID	threadId = GetCurrentThreadID();
-
-	while( !isAvail(threadId) && timeOut > (unsigned long)sw.getMillis() )
+	// spin as long as spinning was successful for the previous locks
+	uint32	spinLimit = m_spinLimit.load();
+	for( uint32 i=0; i<spinLimit; ++i )
 	{
-		m_conditional.wait( timeOut - sw.getMillis() );
-	}
-
-	{
-		CriticalScope	scope( m_cs );
-
-		if( isAvail(threadId) )
+		cpuRelax();
+		if( tryAcquire() )
 		{
-			// lock object and if successfull increase counter
-			m_lockedBy = threadId;
-			m_lockCount++;
+			acquired( threadId );
+			++m_contentions;
+			if( spinLimit < MAX_SPIN )
+			{
+				m_spinLimit.store( spinLimit*2 );
+			}
 /***/		return true;
 		}
 	}
-
-	if( timeOut > (unsigned long)sw.getMillis() )
+	if( spinLimit > MIN_SPIN )
 	{
-		return lock( sw, timeOut );
+		m_spinLimit.store( spinLimit/2 );
 	}
-	else
+
+	// block until the owner unlocks this mutex
+	StopWatch	sw( timeOut != WAIT_FOREVER );
+	size_t		waits = 0;
+	for(;;)
 	{
-		return false;		// give up
+		unsigned long	remaining = WAIT_FOREVER;
+		if( timeOut != WAIT_FOREVER )
+		{
+			unsigned long	ellapsed = static_cast<unsigned long>(sw.getMillis());
+			if( ellapsed >= timeOut )
+			{
+				++m_timeouts;
+/***/			return false;		// give up
+			}
+			remaining = timeOut - ellapsed;
+		}
+
+		uint32 key = m_released.prepareWait();
+		if( tryAcquire() )
+		{
+			m_released.cancelWait();
+			break;
+		}
+		++waits;
+		m_released.wait( key, remaining );
+		if( tryAcquire() )
+		{
+			break;
+		}
 	}
+
+	acquired( threadId );
+	++m_contentions;
+	m_waits += waits;
+
+	return true;
 }
 
 // --------------------------------------------------------------------- //
@@ -154,16 +184,13 @@ bool Locker::lock( const StopWatch &sw, unsigned long timeOut )
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
-bool Locker::lock( unsigned long timeOut )
+void Locker::resetStatistics()
 {
-	if( m_lockedBy == GetCurrentThreadID() )
-	{
-		m_lockCount++;
-/***/	return true;
-	}
-	else
+	if( lock() )
 	{
-		return lock( StopWatch( true ), timeOut );
+		m_contentions = m_waits = 0;
+		m_timeouts.store( 0 );
+		unlock();
 	}
 }
 
@@ -0,0 +1,286 @@
+/*
+		Project:		GAKLIB
+		Module:			memoryMappedFile.cpp
+		Description:	read only memory mapped files
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#if defined( __unix__ ) || defined( __MACH__ )
+#	include <sys/types.h>
+#	include <sys/stat.h>
+#	include <sys/mman.h>
+#	include <fcntl.h>
+#	include <unistd.h>
+#endif
+
+#include <gak/memoryMappedFile.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+MemoryMappedFile::MemoryMappedFile() : m_data( nullptr ), m_size( 0 )
+{
+#if defined( _Windows )
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#endif
+}
+
+MemoryMappedFile::MemoryMappedFile( const STRING &fileName ) : m_data( nullptr ), m_size( 0 )
+{
+#if defined( _Windows )
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#endif
+	open( fileName );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+void MemoryMappedFile::open( const STRING &fileName )
+{
+	close();
+
+#if defined( _Windows )
+	m_fileHandle = CreateFileA(
+		fileName, GENERIC_READ, FILE_SHARE_READ, NULL,
+		OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL
+	);
+	if( m_fileHandle == INVALID_HANDLE_VALUE )
+	{
+/*@*/	throw OpenReadError( fileName );
+	}
+
+	LARGE_INTEGER	fileSize;
+	if( !GetFileSizeEx( m_fileHandle, &fileSize ) || uint64(fileSize.QuadPart) > std::size_t(-1) )
+	{
+		close();
+/*@*/	throw OpenReadError( fileName );
+	}
+	m_size = std::size_t( fileSize.QuadPart );
+	if( m_size )
+	{
+		m_mappingHandle = CreateFileMapping( m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL );
+		if( m_mappingHandle )
+		{
+			m_data = static_cast<const char *>( MapViewOfFile( m_mappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+		}
+		if( !m_data )
+		{
+			close();
+/*@*/		throw OpenReadError( fileName );
+		}
+	}
+#else
+	int	fd = ::open( fileName, O_RDONLY );
+	if( fd < 0 )
+	{
+/*@*/	throw OpenReadError( fileName );
+	}
+
+	struct stat	fileStat;
+	if( fstat( fd, &fileStat ) || uint64(fileStat.st_size) > std::size_t(-1) )
+	{
+		::close( fd );
+/*@*/	throw OpenReadError( fileName );
+	}
+	m_size = std::size_t( fileStat.st_size );
+	if( m_size )
+	{
+		void *data = mmap( nullptr, m_size, PROT_READ, MAP_SHARED, fd, 0 );
+		if( data == MAP_FAILED )
+		{
+			::close( fd );
+			m_size = 0;
+/*@*/		throw OpenReadError( fileName );
+		}
+		m_data = static_cast<const char *>( data );
+	}
+	// the mapping keeps its own reference to the file
+	::close( fd );
+#endif
+
+	if( !m_data )
+	{
+		// an empty file cannot be mapped, but it is a valid file
+		static const char emptyFile[1] = { 0 };
+		m_data = emptyFile;
+	}
+	m_fileName = fileName;
+}
+
+void MemoryMappedFile::close()
+{
+#if defined( _Windows )
+	if( m_data && m_size )
+	{
+		UnmapViewOfFile( m_data );
+	}
+	if( m_mappingHandle )
+	{
+		CloseHandle( m_mappingHandle );
+		m_mappingHandle = NULL;
+	}
+	if( m_fileHandle != INVALID_HANDLE_VALUE )
+	{
+		CloseHandle( m_fileHandle );
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if( m_data && m_size )
+	{
+		munmap( const_cast<char *>( m_data ), m_size );
+	}
+#endif
+	m_data = nullptr;
+	m_size = 0;
+	m_fileName = NULL_STRING;
+}
+
+void MemoryMappedFile::prefetch( std::size_t offset, std::size_t length ) const
+{
+	if( !m_size || offset >= m_size )
+	{
+		return;
+	}
+	if( length > m_size - offset )
+	{
+		length = m_size - offset;
+	}
+#if defined( __unix__ ) || defined( __MACH__ )
+	static const std::size_t	pageSize = std::size_t( sysconf( _SC_PAGESIZE ) );
+	std::size_t					start = offset - offset % pageSize;
+
+	madvise( const_cast<char *>( m_data + start ), length + (offset - start), MADV_WILLNEED );
+#else
+	// touch one byte of each page
+	static const std::size_t	pageSize = 4096;
+	volatile char				sum = 0;
+	for( std::size_t i=0; i<length; i += pageSize )
+	{
+		sum += m_data[offset+i];
+	}
+#endif
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
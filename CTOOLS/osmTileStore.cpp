@@ -0,0 +1,844 @@
+/*
+		Project:		GAKLIB
+		Module:			osmTileStore.cpp
+		Description:	memory mapped tiles of an OpenStreetMap
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <fstream>
+#include <cstring>
+
+#include <gak/osmTileStore.h>
+#include <gak/logfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+OsmTileStore::OsmTileStore( const STRING &path, std::size_t maxSize, bool prefetch )
+: m_path( path ), m_maxSize( maxSize ), m_size( 0 ),
+  m_useCounter( 0 ), m_numHits( 0 ), m_numMisses( 0 ), m_numPrefetched( 0 ),
+  m_prefetch( prefetch ), m_pool( 1, "OsmTilePrefetch" ), m_future( PoolFuture::create() )
+{
+	if( m_prefetch )
+	{
+		m_pool.start();
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+OsmTileLayout OsmTile::getLayout( const OsmTileHeader &header )
+{
+	OsmTileLayout	layout;
+	std::size_t		offset = align( sizeof( OsmTileHeader ) );
+
+	layout.m_nodes = offset;
+	offset = align( offset + header.m_numNodes * sizeof( OsmTileNode ) );
+	layout.m_outgoing = offset;
+	offset = align( offset + header.m_numOutgoing * sizeof( uint32 ) );
+	layout.m_links = offset;
+	offset = align( offset + header.m_numLinks * sizeof( OsmTileLink ) );
+	layout.m_nodeLayers = offset;
+	offset = align( offset + header.m_numNodeLayers * sizeof( OsmTileLayer ) );
+	layout.m_nodeEntries = offset;
+	offset = align( offset + header.m_numNodeEntries * sizeof( OsmTileNodeEntry ) );
+	layout.m_nodeBoxes = offset;
+	offset = align( offset + header.m_numNodeBoxes * sizeof( SpatialBox ) );
+	layout.m_places = offset;
+	offset = align( offset + header.m_numPlaces * sizeof( OsmTilePlace ) );
+	layout.m_placeLayers = offset;
+	offset = align( offset + header.m_numPlaceLayers * sizeof( OsmTileLayer ) );
+	layout.m_placeEntries = offset;
+	offset = align( offset + header.m_numPlaces * sizeof( OsmTilePlaceEntry ) );
+	layout.m_placeBoxes = offset;
+	offset = align( offset + header.m_numPlaceBoxes * sizeof( SpatialBox ) );
+	layout.m_placeOrder = offset;
+	offset = align( offset + header.m_numPlaces * sizeof( uint32 ) );
+	layout.m_areas = offset;
+	offset = align( offset + header.m_numAreas * sizeof( OsmTileArea ) );
+	layout.m_areaLayers = offset;
+	offset = align( offset + header.m_numAreaLayers * sizeof( OsmTileLayer ) );
+	layout.m_areaEntries = offset;
+	offset = align( offset + header.m_numAreas * sizeof( OsmTileAreaEntry ) );
+	layout.m_areaBoxes = offset;
+	offset = align( offset + header.m_numAreaBoxes * sizeof( SpatialBox ) );
+	layout.m_areaOrder = offset;
+	offset = align( offset + header.m_numAreas * sizeof( uint32 ) );
+	layout.m_vertices = offset;
+	offset = align( offset + header.m_numVertices * sizeof( OsmPosition ) );
+	layout.m_names = offset;
+	layout.m_size = align( offset + header.m_namesSize );
+
+	return layout;
+}
+
+/*
+	the entries and the boxes of each layer must be within the arrays of the tile,
+	the number of boxes of a tree does not depend on the type of its entries
+*/
+bool OsmTile::checkLayers(
+	const OsmTileLayer *layers, std::size_t numLayers, std::size_t numEntries, std::size_t numBoxes
+)
+{
+	for( std::size_t i=0; i<numLayers; ++i )
+	{
+		const OsmTileLayer	&layer = layers[i];
+		if( layer.m_first > numEntries || layer.m_count > numEntries - layer.m_first
+		|| layer.m_firstBox > numBoxes
+		|| SpatialTree<OsmTileNodeEntry>::getNumBoxes( layer.m_count ) > numBoxes - layer.m_firstBox )
+		{
+/*@*/		return false;
+		}
+	}
+
+	return true;
+}
+
+std::size_t OsmTile::findNodeIndex( const PODarray<OsmTileNode> &nodes, OsmNodeKeyT key )
+{
+	std::size_t	first = 0;
+	std::size_t	last = nodes.size();
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( nodes[middle].m_key < key )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < nodes.size() && nodes[first].m_key == key ? first : Container::no_index;
+}
+
+std::size_t OsmTile::findLayer( const OsmTileLayer *layers, std::size_t numLayers, OsmLayerKeyT layerKey )
+{
+	// the layers are sorted by their keys
+	std::size_t	first = 0;
+	std::size_t	last = numLayers;
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( layers[middle].m_layerKey < layerKey )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < numLayers && layers[first].m_layerKey == layerKey ? first : Container::no_index;
+}
+
+void OsmTileStore::getTileIDs( const BoundingBox &region, math::TileIDsSet *result )
+{
+	const math::tileid_t	bottomLeft = math::GeoPosition<double>::getTileID(
+		region.topLeft.longitude, region.bottomRight.latitude
+	);
+	const math::tileid_t	topRight = math::GeoPosition<double>::getTileID(
+		region.bottomRight.longitude, region.topLeft.latitude
+	);
+	const math::tileid_t	minLon = bottomLeft % math::maxTileIdPerLine;
+	const math::tileid_t	maxLon = topRight % math::maxTileIdPerLine;
+	const math::tileid_t	minLat = bottomLeft / math::maxTileIdPerLine;
+	const math::tileid_t	maxLat = topRight / math::maxTileIdPerLine;
+
+	for( math::tileid_t lat = minLat; lat <= maxLat; ++lat )
+	{
+		for( math::tileid_t lon = minLon; lon <= maxLon; ++lon )
+		{
+			result->addElement( lat * math::maxTileIdPerLine + lon );
+		}
+	}
+}
+
+void OsmTileStore::getNeighbours( math::tileid_t tileID, math::TileIDsSet *result )
+{
+	const math::tileid_t	maxLat = math::tileid_t( 180/math::degreePerTile+0.5 );
+	const math::tileid_t	lon = tileID % math::maxTileIdPerLine;
+	const math::tileid_t	lat = tileID / math::maxTileIdPerLine;
+
+	for( int latOffset = -1; latOffset <= 1; ++latOffset )
+	{
+		if( (!lat && latOffset < 0) || (lat+1 >= maxLat && latOffset > 0) )
+		{
+/*^*/		continue;
+		}
+		for( int lonOffset = -1; lonOffset <= 1; ++lonOffset )
+		{
+			if( !latOffset && !lonOffset )
+			{
+/*^*/			continue;
+			}
+			// the longitude wraps around at the date line
+			math::tileid_t	neighbourLon = (lon + math::maxTileIdPerLine + lonOffset) % math::maxTileIdPerLine;
+			result->addElement( (lat + latOffset) * math::maxTileIdPerLine + neighbourLon );
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+std::size_t OsmTile::findNode( OsmNodeKeyT key ) const
+{
+	std::size_t	first = 0;
+	std::size_t	last = getNumNodes();
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( m_nodes[middle].m_key < key )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < getNumNodes() && m_nodes[first].m_key == key ? first : Container::no_index;
+}
+
+std::size_t OsmTile::findLink( OsmLinkKeyT key ) const
+{
+	std::size_t	first = 0;
+	std::size_t	last = getNumLinks();
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( m_links[middle].m_key < key )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < getNumLinks() && m_links[first].m_key == key ? first : Container::no_index;
+}
+
+std::size_t OsmTile::findPlace( OsmPlaceKeyT key ) const
+{
+	// m_placeOrder contains the place indices sorted by their keys
+	std::size_t	first = 0;
+	std::size_t	last = getNumPlaces();
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( m_places[m_placeOrder[middle]].m_key < key )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < getNumPlaces() && m_places[m_placeOrder[first]].m_key == key
+		? m_placeOrder[first]
+		: Container::no_index;
+}
+
+std::size_t OsmTile::findArea( OsmAreaKeyT key ) const
+{
+	// m_areaOrder contains the area indices sorted by their keys
+	std::size_t	first = 0;
+	std::size_t	last = getNumAreas();
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		if( m_areas[m_areaOrder[middle]].m_key < key )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return first < getNumAreas() && m_areas[m_areaOrder[first]].m_key == key
+		? m_areaOrder[first]
+		: Container::no_index;
+}
+
+void OsmTile::setPointers( const char *data )
+{
+	m_header = reinterpret_cast<const OsmTileHeader *>( data );
+
+	OsmTileLayout	layout = getLayout( *m_header );
+
+	m_nodes = reinterpret_cast<const OsmTileNode *>( data + layout.m_nodes );
+	m_outgoing = reinterpret_cast<const uint32 *>( data + layout.m_outgoing );
+	m_links = reinterpret_cast<const OsmTileLink *>( data + layout.m_links );
+	m_nodeLayers = reinterpret_cast<const OsmTileLayer *>( data + layout.m_nodeLayers );
+	m_nodeEntries = reinterpret_cast<const OsmTileNodeEntry *>( data + layout.m_nodeEntries );
+	m_nodeBoxes = reinterpret_cast<const SpatialBox *>( data + layout.m_nodeBoxes );
+	m_places = reinterpret_cast<const OsmTilePlace *>( data + layout.m_places );
+	m_placeLayers = reinterpret_cast<const OsmTileLayer *>( data + layout.m_placeLayers );
+	m_placeEntries = reinterpret_cast<const OsmTilePlaceEntry *>( data + layout.m_placeEntries );
+	m_placeBoxes = reinterpret_cast<const SpatialBox *>( data + layout.m_placeBoxes );
+	m_placeOrder = reinterpret_cast<const uint32 *>( data + layout.m_placeOrder );
+	m_areas = reinterpret_cast<const OsmTileArea *>( data + layout.m_areas );
+	m_areaLayers = reinterpret_cast<const OsmTileLayer *>( data + layout.m_areaLayers );
+	m_areaEntries = reinterpret_cast<const OsmTileAreaEntry *>( data + layout.m_areaEntries );
+	m_areaBoxes = reinterpret_cast<const SpatialBox *>( data + layout.m_areaBoxes );
+	m_areaOrder = reinterpret_cast<const uint32 *>( data + layout.m_areaOrder );
+	m_vertices = reinterpret_cast<const OsmPosition *>( data + layout.m_vertices );
+	m_names = data + layout.m_names;
+}
+
+/*
+	the indices of a mapped file are used without any further check, thus all
+	ranges and indices must be within the arrays of the tile
+*/
+bool OsmTile::checkIndices() const
+{
+	const OsmTileHeader	&header = *m_header;
+
+	for( std::size_t i=0; i<header.m_numNodes; ++i )
+	{
+		const OsmTileNode	&node = m_nodes[i];
+		if( node.m_firstLink > node.m_lastLink || node.m_lastLink > header.m_numOutgoing )
+		{
+/*@*/		return false;
+		}
+	}
+	for( std::size_t i=0; i<header.m_numOutgoing; ++i )
+	{
+		if( m_outgoing[i] >= header.m_numLinks )
+		{
+/*@*/		return false;
+		}
+	}
+
+	if( !checkLayers( m_nodeLayers, header.m_numNodeLayers, header.m_numNodeEntries, header.m_numNodeBoxes )
+	|| !checkLayers( m_placeLayers, header.m_numPlaceLayers, header.m_numPlaces, header.m_numPlaceBoxes )
+	|| !checkLayers( m_areaLayers, header.m_numAreaLayers, header.m_numAreas, header.m_numAreaBoxes ) )
+	{
+/*@*/	return false;
+	}
+
+	for( std::size_t i=0; i<header.m_numPlaces; ++i )
+	{
+		const OsmTilePlace	&place = m_places[i];
+		if( m_placeOrder[i] >= header.m_numPlaces
+		|| place.m_nameOffset > header.m_namesSize || place.m_nameLength > header.m_namesSize - place.m_nameOffset )
+		{
+/*@*/		return false;
+		}
+	}
+	for( std::size_t i=0; i<header.m_numAreas; ++i )
+	{
+		const OsmTileArea	&area = m_areas[i];
+		if( m_areaOrder[i] >= header.m_numAreas
+		|| area.m_firstVertex > header.m_numVertices || area.m_numVertices > header.m_numVertices - area.m_firstVertex )
+		{
+/*@*/		return false;
+		}
+	}
+
+	return true;
+}
+
+void OsmTileStore::removeLeastRecentlyUsed( std::size_t maxSize, bool prefetchedOnly )
+{
+	while( m_size > maxSize && m_tiles.size() )
+	{
+		std::size_t	oldest = 0;
+		for( std::size_t i=1; i<m_tiles.size(); ++i )
+		{
+			if( m_tiles.getValueAt( i ).m_lastUse < m_tiles.getValueAt( oldest ).m_lastUse )
+			{
+				oldest = i;
+			}
+		}
+		if( prefetchedOnly && m_tiles.getValueAt( oldest ).m_lastUse )
+		{
+/*v*/		break;
+		}
+		m_size -= m_tiles.getValueAt( oldest ).m_tile->getDataSize();
+		m_tiles.removeElementAt( oldest );
+	}
+}
+
+OsmTilePtr OsmTileStore::findTile( math::tileid_t tileID, bool *missing )
+{
+	CriticalScope	scope( m_lock );
+
+	*missing = m_missingTiles.hasElement( tileID );
+	std::size_t	index = m_tiles.getElementIndex( tileID );
+	if( index != m_tiles.no_index )
+	{
+		CachedTile	&cached = m_tiles.getValueAt( index );
+		cached.m_lastUse = ++m_useCounter;
+/*@*/	return cached.m_tile;
+	}
+	return OsmTilePtr();
+}
+
+OsmTilePtr OsmTileStore::loadTile( math::tileid_t tileID )
+{
+	doEnterFunctionEx( gakLogging::llDetail, "OsmTileStore::loadTile" );
+
+	OsmTilePtr	tile = new OsmTile;
+	try
+	{
+		tile->open( getOsmTileFileName( m_path, tileID ) );
+	}
+	catch( OpenReadError & )
+	{
+		// there is no data for this tile, e.g. the sea
+		CriticalScope	scope( m_lock );
+		m_missingTiles.addElement( tileID );
+/*@*/	return OsmTilePtr();
+	}
+	return tile;
+}
+
+OsmTilePtr OsmTileStore::addTile( math::tileid_t tileID, const OsmTilePtr &tile, bool prefetched )
+{
+	CriticalScope	scope( m_lock );
+
+	std::size_t	index = m_tiles.getElementIndex( tileID );
+	if( index != m_tiles.no_index )
+	{
+		// another thread was faster
+		CachedTile	&cached = m_tiles.getValueAt( index );
+		if( !prefetched )
+		{
+			cached.m_lastUse = ++m_useCounter;
+		}
+/*@*/	return cached.m_tile;
+	}
+
+	const std::size_t	size = tile->getDataSize();
+	if( size <= m_maxSize )
+	{
+		// a prefetched tile must not release a tile that was used
+		removeLeastRecentlyUsed( m_maxSize - size, prefetched );
+		if( m_size + size <= m_maxSize )
+		{
+			CachedTile	&cached = m_tiles[tileID];
+			cached.m_tile = tile;
+			cached.m_lastUse = prefetched ? 0 : ++m_useCounter;
+			m_size += size;
+		}
+	}
+	return tile;
+}
+
+void OsmTileStore::prefetchTile( math::tileid_t tileID )
+{
+	doEnterFunctionEx( gakLogging::llDetail, "OsmTileStore::prefetchTile" );
+
+	bool	found;
+	{
+		// findTile would count this as a use
+		CriticalScope	scope( m_lock );
+		found = m_tiles.hasElement( tileID ) || m_missingTiles.hasElement( tileID );
+	}
+
+	if( !found )
+	{
+		OsmTilePtr	tile;
+		try
+		{
+			tile = loadTile( tileID );
+		}
+		catch( LibraryException & )
+		{
+			// getTile will report the error, if the tile is needed
+		}
+		if( tile )
+		{
+			tile->prefetch();
+			addTile( tileID, tile, true );
+
+			CriticalScope	scope( m_lock );
+			if( m_tiles.hasElement( tileID ) )
+			{
+				++m_numPrefetched;
+			}
+		}
+	}
+
+	CriticalScope	scope( m_lock );
+	m_pendingTiles.removeElement( tileID );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+void OsmTile::open( const STRING &fileName )
+{
+	doEnterFunction("OsmTile::open");
+
+	clear();
+	m_file.open( fileName );
+
+	const char			*data = m_file.getData();
+	std::size_t			fileSize = m_file.size();
+	const OsmTileHeader	*header = reinterpret_cast<const OsmTileHeader *>( data );
+
+	if( fileSize < sizeof( OsmTileHeader )
+	|| header->m_magic != OSM_TILE_MAGIC
+	|| header->m_version != OSM_TILE_VERSION
+	|| header->m_headerSize != sizeof( OsmTileHeader )
+	|| header->m_fileSize != fileSize
+	|| getLayout( *header ).m_size != fileSize )
+	{
+		m_file.close();
+		clear();
+/*@*/	throw BadHeaderError( fileName );
+	}
+
+	setPointers( data );
+	if( !checkIndices() )
+	{
+		clear();
+/*@*/	throw BadHeaderError( fileName );
+	}
+}
+
+void OsmTile::writeToFile( const STRING &fileName ) const
+{
+	std::ofstream	stream( fileName, std::ios_base::binary );
+
+	if( !stream )
+	{
+/*@*/	throw OpenWriteError( fileName );
+	}
+
+	stream.write( getData(), std::streamsize( getDataSize() ) );
+	if( !stream )
+	{
+/*@*/	throw WriteError( fileName );
+	}
+}
+
+void OsmTile::clear()
+{
+	OsmTileHeader	header;
+
+	std::memset( &header, 0, sizeof( header ) );
+	header.m_magic = OSM_TILE_MAGIC;
+	header.m_version = OSM_TILE_VERSION;
+	header.m_headerSize = uint16( sizeof( OsmTileHeader ) );
+
+	OsmTileLayout	layout = getLayout( header );
+	header.m_fileSize = layout.m_size;
+
+	m_file.close();
+	m_buffer.setSize( layout.m_size );
+	std::memset( m_buffer.getDataBuffer(), 0, layout.m_size );
+	std::memcpy( m_buffer.getDataBuffer(), &header, sizeof( header ) );
+	setPointers( m_buffer.getDataBuffer() );
+}
+
+const OsmTileNode &OsmTile::getNode( OsmNodeKeyT key ) const
+{
+	std::size_t	index = findNode( key );
+	if( index == Container::no_index )
+	{
+		throw NodeNotFoundError();
+	}
+	return m_nodes[index];
+}
+
+const OsmTileLink &OsmTile::getLink( OsmLinkKeyT key ) const
+{
+	std::size_t	index = findLink( key );
+	if( index == Container::no_index )
+	{
+		throw LinkNotFoundError();
+	}
+	return m_links[index];
+}
+
+void OsmTile::getRegion( OsmLayerKeyT layerKey, const SpatialBox &region, Array<OsmNodeKeyT> *result ) const
+{
+	std::size_t	layerIndex = findLayer( m_nodeLayers, m_header->m_numNodeLayers, layerKey );
+	if( layerIndex != Container::no_index )
+	{
+		getLayerTree( m_nodeLayers[layerIndex], m_nodeEntries, m_nodeBoxes ).getRegion( region, result );
+	}
+}
+
+OsmPlace OsmTile::getPlace( OsmPlaceKeyT key ) const
+{
+	std::size_t	index = findPlace( key );
+	if( index == Container::no_index )
+	{
+		throw IndexError();
+	}
+
+	const OsmTilePlace	&place = m_places[index];
+	OsmPlace			result;
+
+	result.pos = place.m_pos;
+	result.name = STRING( m_names + place.m_nameOffset, place.m_nameLength );
+
+	return result;
+}
+
+void OsmTile::getPlaces( OsmLayerKeyT layerKey, const SpatialBox &region, Array<OsmPlaceKeyT> *result ) const
+{
+	std::size_t	layerIndex = findLayer( m_placeLayers, m_header->m_numPlaceLayers, layerKey );
+	if( layerIndex != Container::no_index )
+	{
+		getLayerTree( m_placeLayers[layerIndex], m_placeEntries, m_placeBoxes ).getRegion( region, result );
+	}
+}
+
+Area OsmTile::getArea( OsmAreaKeyT key ) const
+{
+	std::size_t	index = findArea( key );
+	if( index == Container::no_index )
+	{
+		throw IndexError();
+	}
+
+	const OsmTileArea	&area = m_areas[index];
+	Area				result;
+
+	result.points.setChunkSize( area.m_numVertices );
+	for( std::size_t i=0; i<area.m_numVertices; ++i )
+	{
+		result.points.addElement( m_vertices[area.m_firstVertex + i] );
+	}
+
+	return result;
+}
+
+void OsmTile::getAreas( OsmLayerKeyT layerKey, const SpatialBox &region, Set<OsmAreaKeyT> *result ) const
+{
+	std::size_t	layerIndex = findLayer( m_areaLayers, m_header->m_numAreaLayers, layerKey );
+	if( layerIndex != Container::no_index )
+	{
+		getLayerTree( m_areaLayers[layerIndex], m_areaEntries, m_areaBoxes ).getRegion( region, result );
+	}
+}
+
+void OsmTileStore::setMaxSize( std::size_t maxSize )
+{
+	CriticalScope	scope( m_lock );
+	m_maxSize = maxSize;
+	removeLeastRecentlyUsed( maxSize );
+}
+
+OsmTilePtr OsmTileStore::getTile( math::tileid_t tileID )
+{
+	doEnterFunction( "OsmTileStore::getTile" );
+
+	bool		missing;
+	OsmTilePtr	tile = findTile( tileID, &missing );
+
+	{
+		CriticalScope	scope( m_lock );
+		if( tile || missing )
+		{
+			++m_numHits;
+/*@*/		return tile;
+		}
+		++m_numMisses;
+	}
+
+	// do not block the other threads while opening the file
+	tile = loadTile( tileID );
+	if( tile )
+	{
+		tile = addTile( tileID, tile, false );
+	}
+	return tile;
+}
+
+void OsmTileStore::getTiles( const BoundingBox &region, Array<OsmTilePtr> *result )
+{
+	math::TileIDsSet	tileIDs;
+	getTileIDs( region, &tileIDs );
+
+	for(
+		math::TileIDsSet::const_iterator it = tileIDs.cbegin(), endIT = tileIDs.cend();
+		it != endIT;
+		++it
+	)
+	{
+		OsmTilePtr	tile = getTile( *it );
+		if( tile )
+		{
+			result->addElement( tile );
+		}
+	}
+	for(
+		math::TileIDsSet::const_iterator it = tileIDs.cbegin(), endIT = tileIDs.cend();
+		it != endIT;
+		++it
+	)
+	{
+		prefetchNeighbours( *it );
+	}
+}
+
+void OsmTileStore::prefetchNeighbours( math::tileid_t tileID )
+{
+	if( !m_prefetch )
+	{
+/*@*/	return;
+	}
+
+	math::TileIDsSet	neighbours;
+	getNeighbours( tileID, &neighbours );
+
+	CriticalScope	scope( m_lock );
+	for(
+		math::TileIDsSet::const_iterator it = neighbours.cbegin(), endIT = neighbours.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const math::tileid_t	neighbour = *it;
+		if( !m_tiles.hasElement( neighbour )
+		&& !m_missingTiles.hasElement( neighbour )
+		&& !m_pendingTiles.hasElement( neighbour ) )
+		{
+			m_pendingTiles.addElement( neighbour );
+			m_pool.process( PrefetchJob( this, neighbour ), m_future );
+		}
+	}
+}
+
+void OsmTileStore::clear()
+{
+	flush();
+
+	CriticalScope	scope( m_lock );
+	m_tiles.clear();
+	m_missingTiles.clear();
+	m_size = 0;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
@@ -0,0 +1,557 @@
+/*
+		Project:		GAKLIB
+		Module:			socketReactor.cpp
+		Description:	multiplexes the connections of a server with epoll
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cerrno>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#endif
+
+#include <gak/socketReactor.h>
+#include <gak/logfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace net
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static const int			REACTOR_MAX_EVENTS = 64;
+static const int			REACTOR_WAIT_TIME = 1000;
+static const std::size_t	REACTOR_READ_SIZE = 4096;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+SocketReactor::SocketReactor( unsigned idleTimeout )
+: m_epoll( -1 ), m_listenSocket( INVALID_SOCKET ), m_port( 0 ), m_idleTimeout( idleTimeout ),
+  m_idleConnections( nullptr ), m_numConnections( 0 ), m_nextCheck( 0 ), m_running( false )
+{
+	m_listener.m_lastActivity = 0;
+	m_listener.m_prev = m_listener.m_next = nullptr;
+	m_listener.m_closing = false;
+}
+
+SocketReactor::~SocketReactor()
+{
+	stop();
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+bool SocketReactor::isAvailable()
+{
+#ifdef __linux__
+	return true;
+#else
+	return false;
+#endif
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void SocketReactor::link( Connection *connection )
+{
+	connection->m_prev = nullptr;
+	connection->m_next = m_idleConnections;
+	if( m_idleConnections )
+	{
+		m_idleConnections->m_prev = connection;
+	}
+	m_idleConnections = connection;
+	++m_numConnections;
+}
+
+void SocketReactor::unlink( Connection *connection )
+{
+	if( connection->m_prev )
+	{
+		connection->m_prev->m_next = connection->m_next;
+	}
+	else
+	{
+		m_idleConnections = connection->m_next;
+	}
+	if( connection->m_next )
+	{
+		connection->m_next->m_prev = connection->m_prev;
+	}
+	connection->m_prev = connection->m_next = nullptr;
+	--m_numConnections;
+}
+
+#ifdef __linux__
+
+bool SocketReactor::arm( Connection *connection, int operation )
+{
+	epoll_event	event;
+
+	/*
+		one shot: an event is reported to one thread, only, and the
+		connection is not reported again until it is armed again
+	*/
+	event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+	event.data.ptr = connection;
+
+	return !epoll_ctl( m_epoll, operation, connection->m_connection.m_socket, &event );
+}
+
+bool SocketReactor::waitForRequest( Connection *connection, int operation )
+{
+	CriticalScope	scope( m_lock );
+
+	if( !m_running )
+	{
+/*@*/	return false;
+	}
+
+	link( connection );
+	if( !arm( connection, operation ) )
+	{
+		unlink( connection );
+/*@*/	return false;
+	}
+
+	return true;
+}
+
+void SocketReactor::closeConnection( Connection *connection )
+{
+	close( connection->m_connection.m_socket );
+	delete connection;
+}
+
+void SocketReactor::acceptConnections()
+{
+	doEnterFunction("SocketReactor::acceptConnections");
+
+	// the listen socket does not block, thus we can accept all pending connections
+	for(;;)
+	{
+		ClientConnection	connection;
+		socklen_t			clientSize = sizeof( connection.m_client );
+
+		connection.m_socket = ::accept(
+			m_listenSocket, reinterpret_cast<SOCKADDR*>(&connection.m_client), &clientSize
+		);
+		if( connection.m_socket == INVALID_SOCKET )
+		{
+			if( errno == EINTR )
+			{
+/*^*/			continue;
+			}
+/*v*/		break;
+		}
+
+		connection.m_port = m_port;
+		resume( connection );
+	}
+
+	CriticalScope	scope( m_lock );
+	if( m_running )
+	{
+		arm( &m_listener, EPOLL_CTL_MOD );
+	}
+}
+
+void SocketReactor::handleInput( Connection *connection )
+{
+	doEnterFunction("SocketReactor::handleInput");
+
+	{
+		CriticalScope	scope( m_lock );
+		unlink( connection );
+	}
+
+	SOCKET		socket = connection->m_connection.m_socket;
+	ArrayOfData	&received = connection->m_connection.m_received;
+	bool		closed = connection->m_closing;
+	char		buffer[REACTOR_READ_SIZE];
+
+	while( !closed )
+	{
+		ssize_t	size = recv( socket, buffer, sizeof( buffer ), MSG_DONTWAIT );
+		if( size > 0 )
+		{
+			received.addElements( buffer, std::size_t(size) );
+			connection->m_lastActivity = std::time( nullptr );
+			if( std::size_t(size) < sizeof( buffer ) )
+			{
+/*v*/			break;
+			}
+		}
+		else if( size < 0 && errno == EINTR )
+		{
+/*^*/		continue;
+		}
+		else if( size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) )
+		{
+/*v*/		break;
+		}
+		else
+		{
+			// the client has closed the connection or there was an error
+			closed = true;
+		}
+	}
+
+	if( !connection->m_closing && received.size()
+	&& (received.size() >= REACTOR_MAX_PENDING || isRequestComplete( received.getDataBuffer(), received.size() )) )
+	{
+		// a client may close its side of the connection after the request
+		epoll_ctl( m_epoll, EPOLL_CTL_DEL, socket, nullptr );
+		dispatch( connection->m_connection );
+		delete connection;
+	}
+	else if( closed || !waitForRequest( connection, EPOLL_CTL_MOD ) )
+	{
+		closeConnection( connection );
+	}
+}
+
+void SocketReactor::checkIdleConnections()
+{
+	std::time_t		now = std::time( nullptr );
+	CriticalScope	scope( m_lock );
+
+	if( now < m_nextCheck )
+	{
+/*@*/	return;
+	}
+	m_nextCheck = now + 1;
+
+	/*
+		the connections are not closed here, since another thread may
+		already handle an event of that connection. The shutdown creates
+		a new event and the thread handling the event closes the socket.
+	*/
+	for( Connection *connection = m_idleConnections; connection; connection = connection->m_next )
+	{
+		if( !connection->m_closing && now - connection->m_lastActivity > std::time_t(m_idleTimeout) )
+		{
+			connection->m_closing = true;
+			shutdown( connection->m_connection.m_socket, SHUT_RDWR );
+		}
+	}
+}
+
+void SocketReactor::runEventLoop( const Thread &thread )
+{
+	doEnterFunction("SocketReactor::runEventLoop");
+
+	epoll_event	events[REACTOR_MAX_EVENTS];
+
+	while( !thread.terminated )
+	{
+		int count = epoll_wait( m_epoll, events, REACTOR_MAX_EVENTS, REACTOR_WAIT_TIME );
+		for( int i=0; i<count; ++i )
+		{
+			Connection	*connection = static_cast<Connection *>( events[i].data.ptr );
+			if( connection == &m_listener )
+			{
+				acceptConnections();
+			}
+			else
+			{
+				handleInput( connection );
+			}
+		}
+		checkIdleConnections();
+	}
+}
+
+#else	// __linux__
+
+bool SocketReactor::arm( Connection *, int )
+{
+	return false;
+}
+
+bool SocketReactor::waitForRequest( Connection *, int )
+{
+	return false;
+}
+
+void SocketReactor::closeConnection( Connection *connection )
+{
+#ifdef _Windows
+	closesocket( connection->m_connection.m_socket );
+#else
+	close( connection->m_connection.m_socket );
+#endif
+	delete connection;
+}
+
+void SocketReactor::acceptConnections()
+{
+}
+
+void SocketReactor::handleInput( Connection * )
+{
+}
+
+void SocketReactor::checkIdleConnections()
+{
+}
+
+void SocketReactor::runEventLoop( const Thread & )
+{
+}
+
+#endif	// __linux__
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void SocketReactor::EventThread::ExecuteThread()
+{
+	m_reactor.runEventLoop( *this );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+int SocketReactor::start( SOCKET listenSocket, unsigned short port, std::size_t numThreads )
+{
+	doEnterFunction("SocketReactor::start");
+
+#ifdef __linux__
+	stop();
+
+	m_epoll = epoll_create1( EPOLL_CLOEXEC );
+	if( m_epoll < 0 )
+	{
+/*@*/	return errno;
+	}
+
+	int	flags = fcntl( listenSocket, F_GETFL, 0 );
+	if( flags < 0 || fcntl( listenSocket, F_SETFL, flags | O_NONBLOCK ) < 0 )
+	{
+		int error = errno;
+		close( m_epoll );
+		m_epoll = -1;
+/*@*/	return error;
+	}
+
+	m_listenSocket = listenSocket;
+	m_port = port;
+	m_listener.m_connection.m_socket = listenSocket;
+	m_listener.m_connection.m_port = port;
+	m_running = true;
+
+	if( !arm( &m_listener, EPOLL_CTL_ADD ) )
+	{
+		int error = errno;
+		m_running = false;
+		close( m_epoll );
+		m_epoll = -1;
+/*@*/	return error;
+	}
+
+	if( !numThreads )
+	{
+		numThreads = 1;
+	}
+	for( std::size_t i=0; i<numThreads; ++i )
+	{
+		Thread::Ptr	eventThread = new EventThread( *this );
+		m_threads.addElement( eventThread );
+		eventThread->StartThread( "SocketReactor" );
+	}
+
+	return 0;
+#else
+	(void)listenSocket;
+	(void)port;
+	(void)numThreads;
+
+	return -1;
+#endif
+}
+
+void SocketReactor::stop()
+{
+	doEnterFunction("SocketReactor::stop");
+
+	{
+		CriticalScope	scope( m_lock );
+		if( !m_running )
+		{
+/*@*/		return;
+		}
+		m_running = false;
+	}
+
+	for( std::size_t i=0; i<m_threads.size(); ++i )
+	{
+		m_threads[i]->StopThread();
+	}
+	for( std::size_t i=0; i<m_threads.size(); ++i )
+	{
+		m_threads[i]->join();
+	}
+	m_threads.clear();
+
+	CriticalScope	scope( m_lock );
+	while( m_idleConnections )
+	{
+		Connection	*connection = m_idleConnections;
+		unlink( connection );
+		closeConnection( connection );
+	}
+
+#ifdef __linux__
+	close( m_epoll );
+#endif
+	m_epoll = -1;
+}
+
+void SocketReactor::resume( const ClientConnection &connection )
+{
+	Connection	*newConnection = new Connection;
+
+	newConnection->m_connection = connection;
+	newConnection->m_lastActivity = std::time( nullptr );
+	newConnection->m_closing = false;
+
+#ifdef __linux__
+	// the client may already have sent the next request
+	if( m_running && connection.m_received.size()
+	&& isRequestComplete( connection.m_received.getDataBuffer(), connection.m_received.size() ) )
+	{
+		try
+		{
+			dispatch( connection );
+			delete newConnection;
+		}
+		catch( LibraryException & )
+		{
+			// the reactor was stopped while we were checking the request
+			closeConnection( newConnection );
+		}
+/*@*/	return;
+	}
+
+	if( !waitForRequest( newConnection, EPOLL_CTL_ADD ) )
+#endif
+	{
+		closeConnection( newConnection );
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace net
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
@@ -37,11 +37,19 @@
 // ----- includes ------------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+#include <fstream>
+
 #include <gak/socketbuf.h>
 #include <gak/hostResolver.h>
 #include <gak/logfile.h>
 #include <gak/htmlParser.h>
 
+#ifdef __linux__
+#	include <fcntl.h>
+#	include <unistd.h>
+#	include <sys/sendfile.h>
+#endif
+
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -175,6 +183,49 @@ void SocketStreambuf::flush( void )
 	}
 }
 
+int SocketStreambuf::copyFile(
+	const char *header, size_t headerSize,
+	const STRING &fileName, uint64 offset, uint64 count
+)
+{
+	doEnterFunction("SocketStreambuf::copyFile");
+
+	std::ifstream	in( fileName, std::ios::in|std::ios::binary );
+	if( !in )
+	{
+		m_errorText = "Open failed";
+/*@*/	return m_socketError = SOCKET_ERROR;
+	}
+	in.seekg( std::streamoff(offset) );
+
+	// the header is sent with the first block
+	ArrayOfData	block;
+	const size_t	BLOCK_SIZE = 64*1024;
+
+	block.addElements( header, headerSize );
+	do
+	{
+		size_t	blockSize = count > BLOCK_SIZE ? BLOCK_SIZE : size_t(count);
+		char	*data = block.createElements( blockSize );
+
+		in.read( data, std::streamsize(blockSize) );
+		if( size_t(in.gcount()) != blockSize )
+		{
+			m_errorText = "Read failed";
+/*@*/		return m_socketError = SOCKET_ERROR;
+		}
+		int	error = sendData( block.getDataBuffer(), block.size() );
+		if( error )
+		{
+/*@*/		return error;
+		}
+		count -= blockSize;
+		block.clear();
+	} while( count );
+
+	return 0;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class virtuals ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -289,6 +340,76 @@ int SocketStreambuf::sendData( const char *data, size_t numData )
 	return m_socketError;
 }
 
+int SocketStreambuf::sendFile(
+	const char *header, size_t headerSize,
+	const STRING &fileName, uint64 offset, uint64 count
+)
+{
+	doEnterFunction("SocketStreambuf::sendFile");
+
+#ifdef __linux__
+	if( !m_connected )
+	{
+		m_socketError = WSAENOTCONN;
+/*@*/	return SOCKET_ERROR;
+	}
+
+	int	fd = open( fileName, O_RDONLY );
+	if( fd < 0 )
+	{
+		m_socketError = errno;
+		m_errorText = "Open failed";
+/*@*/	return m_socketError;
+	}
+
+	clock_t sendTime = clock();
+
+	// MSG_MORE: the header and the first block of the file share the packets
+	m_socketError = 0;
+	while( headerSize )
+	{
+		ssize_t	numSentData = ::send( m_socket, header, headerSize, MSG_MORE );
+		if( numSentData < 0 )
+		{
+			m_socketError = errno;
+/*v*/		break;
+		}
+		headerSize -= size_t(numSentData);
+		header += numSentData;
+	}
+
+	off_t	position = off_t(offset);
+	while( count && !m_socketError )
+	{
+		size_t	blockSize = count > 0x40000000 ? 0x40000000 : size_t(count);
+		ssize_t	numSentData = ::sendfile( m_socket, fd, &position, blockSize );
+
+		if( numSentData < 0 && errno == EINTR )
+		{
+/*^*/		continue;
+		}
+		if( numSentData <= 0 )
+		{
+			m_socketError = numSentData < 0 ? errno : EIO;
+/*v*/		break;
+		}
+		count -= uint64(numSentData);
+	}
+	close( fd );
+
+	m_sendTime += clock()-sendTime;
+
+	if( m_socketError )
+	{
+		m_errorText = "Send failed";
+	}
+
+	return m_socketError;
+#else
+	return copyFile( header, headerSize, fileName, offset, count );
+#endif
+}
+
 void SocketStreambuf::disconnect( void )
 {
 	doEnterFunction("SocketStreambuf::disconnect");
@@ -352,7 +473,7 @@ int SocketStreambuf::underflow( void )
 		if( m_dataBuffer )
 		{
 			timeval	timeout;
-			timeout.tv_sec = 10;
+			timeout.tv_sec = m_timeout;
 			timeout.tv_usec = 0;
 			fd_set	sockets;
 
@@ -521,6 +642,21 @@ ClientConnection SocketStreambuf::accept( void )
 	return connection;
 }
 
+void SocketStreambuf::accept( const ClientConnection &connection, int bufferSize )
+{
+	int	numReceived = int(connection.m_received.size());
+
+	accept( connection.m_socket, numReceived > bufferSize ? numReceived : bufferSize );
+	if( numReceived && m_dataBuffer && numReceived <= m_bufferSize )
+	{
+		char *base = eback();
+
+		std::memcpy( base, connection.m_received.getDataBuffer(), numReceived );
+		setg( base, base, base+numReceived );
+		setp( base, base+numReceived );
+	}
+}
+
 STRING SocketStreambuf::getNextLine( void )
 {
 	int		c;
@@ -0,0 +1,438 @@
+/*
+		Project:		GAKLIB
+		Module:			strArena.cpp
+		Description:	small string cache and arena for the buffers of STRING objects
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#if defined( _MSC_VER ) || defined( __BORLANDC__ )
+#	define GAK_THREAD_LOCAL	__declspec( thread )
+#else
+#	define GAK_THREAD_LOCAL	__thread
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <stdlib.h>
+#include <string.h>
+
+#if defined( _MSC_VER )
+#	include <malloc.h>
+#endif
+
+#include <gak/strArena.h>
+#include <gak/atomic.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the buffer size of small strings, must be the same as DEFSIZE in string.c
+static const std::size_t SMALL_BUFFER = 32;
+/// the block size of small strings
+static const std::size_t SMALL_BLOCK = sizeof( STR ) + SMALL_BUFFER;
+/// the max. number of small blocks cached per thread
+static const std::size_t SMALL_CACHE_SIZE = 256;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+struct ArenaChunk
+{
+	StrArenaData	*owner;
+	ArenaChunk		*next;
+	void			*memory;
+	char			*pos;
+	char			*end;
+};
+
+struct StrArenaData
+{
+	/// one reference for the arena itself and one for each buffer
+	Atomic<std::size_t>	refs;
+	ArenaChunk			*chunks;
+	std::size_t			chunkCount;
+	std::size_t			usedBytes;
+
+	StrArenaData() : refs( 1 ), chunks( NULL ), chunkCount( 0 ), usedBytes( 0 )
+	{
+	}
+	~StrArenaData();
+
+	STR *allocate( std::size_t size );
+	void release()
+	{
+		if( refs.fetchSub( 1, moAcqRel ) == 1 )
+		{
+			delete this;
+		}
+	}
+};
+
+struct SmallBlock
+{
+	SmallBlock	*next;
+};
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	the caches are plain pointers, since the old compilers cannot destroy
+	thread local objects. Thread flushes the cache of its threads
+*/
+static GAK_THREAD_LOCAL SmallBlock		*s_smallCache = NULL;
+static GAK_THREAD_LOCAL std::size_t		s_smallCount = 0;
+static GAK_THREAD_LOCAL StrArenaData	*s_currentArena = NULL;
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static void *allocChunk( void )
+{
+#if defined( _MSC_VER )
+	return _aligned_malloc( StrArena::CHUNK_SIZE, StrArena::CHUNK_SIZE );
+#elif defined( __BORLANDC__ )
+	return NULL;
+#else
+	void	*memory;
+	return posix_memalign( &memory, StrArena::CHUNK_SIZE, StrArena::CHUNK_SIZE ) ? NULL : memory;
+#endif
+}
+
+static void freeChunk( void *memory )
+{
+#if defined( _MSC_VER )
+	_aligned_free( memory );
+#else
+	free( memory );
+#endif
+}
+
+static inline ArenaChunk *findChunk( STR *str )
+{
+	return reinterpret_cast<ArenaChunk *>(
+		reinterpret_cast<std::size_t>( str ) & ~(StrArena::CHUNK_SIZE-1)
+	);
+}
+
+static STR *allocSmall( void )
+{
+	SmallBlock	*block = s_smallCache;
+	if( block )
+	{
+		s_smallCache = block->next;
+		--s_smallCount;
+		return reinterpret_cast<STR *>( block );
+	}
+	return static_cast<STR *>( malloc( SMALL_BLOCK ) );
+}
+
+static void freeSmall( STR *str )
+{
+	if( s_smallCount < SMALL_CACHE_SIZE )
+	{
+		SmallBlock	*block = reinterpret_cast<SmallBlock *>( str );
+		block->next = s_smallCache;
+		s_smallCache = block;
+		++s_smallCount;
+	}
+	else
+	{
+		free( str );
+	}
+}
+
+static STR *allocNew( std::size_t size )
+{
+	STR	*str;
+
+	if( s_currentArena && size <= StrArena::MAX_BLOCK_SIZE )
+	{
+		str = s_currentArena->allocate( size );
+		if( str )
+		{
+			str->storage = STR_ARENA;
+			return str;
+		}
+	}
+	if( size <= SMALL_BLOCK )
+	{
+		str = allocSmall();
+		if( str )
+		{
+			str->storage = STR_SMALL;
+		}
+	}
+	else
+	{
+		str = static_cast<STR *>( malloc( size ) );
+		if( str )
+		{
+			str->storage = STR_HEAP;
+		}
+	}
+	return str;
+}
+
+static STR *moveStr( STR *str, std::size_t oldSize, std::size_t size )
+{
+	STR	*newStr = allocNew( size );
+	if( newStr )
+	{
+		unsigned char storage = newStr->storage;
+		memcpy( newStr, str, oldSize < size ? oldSize : size );
+		newStr->storage = storage;
+		freeStr( str );
+	}
+	return newStr;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+StrArenaData::~StrArenaData()
+{
+	while( chunks )
+	{
+		ArenaChunk	*next = chunks->next;
+		freeChunk( chunks->memory );
+		chunks = next;
+	}
+}
+
+StrArena::StrArena() : m_data( new StrArenaData )
+{
+}
+
+StrArena::~StrArena()
+{
+	if( s_currentArena == m_data )
+	{
+		s_currentArena = NULL;
+	}
+	m_data->release();
+}
+
+StrArenaScope::StrArenaScope( StrArena &arena )
+{
+	m_previous = s_currentArena;
+	s_currentArena = arena.getData();
+}
+
+StrArenaScope::~StrArenaScope()
+{
+	s_currentArena = m_previous;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+STR *StrArenaData::allocate( std::size_t size )
+{
+	// keep the buffers aligned
+	size = (size + sizeof(void*)-1) & ~(sizeof(void*)-1);
+
+	if( !chunks || chunks->pos + size > chunks->end )
+	{
+		void	*memory = allocChunk();
+		if( !memory )
+		{
+			return NULL;
+		}
+		ArenaChunk	*chunk = static_cast<ArenaChunk *>( memory );
+		chunk->owner = this;
+		chunk->next = chunks;
+		chunk->memory = memory;
+		chunk->pos = static_cast<char *>( memory ) + sizeof( ArenaChunk );
+		chunk->end = static_cast<char *>( memory ) + StrArena::CHUNK_SIZE;
+		chunks = chunk;
+		++chunkCount;
+	}
+
+	STR	*str = reinterpret_cast<STR *>( chunks->pos );
+	chunks->pos += size;
+	usedBytes += size;
+	refs.fetchAdd( 1, moRelaxed );
+
+	return str;
+}
+
+std::size_t StrArena::getChunkCount() const
+{
+	return m_data->chunkCount;
+}
+
+std::size_t StrArena::getBlockCount() const
+{
+	return m_data->refs.load() - 1;
+}
+
+std::size_t StrArena::getUsedBytes() const
+{
+	return m_data->usedBytes;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+extern "C" STR *reallocStr( STR *str, size_t size )
+{
+	if( !str )
+	{
+		return allocNew( size );
+	}
+
+	switch( str->storage )
+	{
+		case STR_SMALL:
+			return size <= SMALL_BLOCK ? str : moveStr( str, SMALL_BLOCK, size );
+		case STR_ARENA:
+		{
+			std::size_t	oldSize = sizeof( STR ) + str->bufSize;
+			return size <= oldSize ? str : moveStr( str, oldSize, size );
+		}
+		default:
+		{
+			STR	*newStr = static_cast<STR *>( realloc( str, size ) );
+			if( newStr )
+			{
+				newStr->storage = STR_HEAP;
+			}
+			return newStr;
+		}
+	}
+}
+
+extern "C" void freeStr( STR *str )
+{
+	if( str )
+	{
+		switch( str->storage )
+		{
+			case STR_SMALL:
+				freeSmall( str );
+				break;
+			case STR_ARENA:
+				findChunk( str )->owner->release();
+				break;
+			default:
+				free( str );
+				break;
+		}
+	}
+}
+
+extern "C" void flushStrCache( void )
+{
+	while( s_smallCache )
+	{
+		SmallBlock	*next = s_smallCache->next;
+		free( s_smallCache );
+		s_smallCache = next;
+	}
+	s_smallCount = 0;
+}
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
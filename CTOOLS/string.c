@@ -118,7 +118,7 @@ STR *resizeStr( STR *str, size_t newSize, cBool exact )
 
 	if( !str || (newSize != str->bufSize && newSize >= str->minSize) )
 	{
-		if( (newTmpStr = (STR*)realloc( str, newSize + sizeof( STR ))) != NULL )
+		if( (newTmpStr = (STR*)reallocStr( str, newSize + sizeof( STR ))) != NULL )
 		{
 			newTmpStr->bufSize = newSize;
 			newTmpStr->minSize = minSize;
@@ -133,7 +133,7 @@ STR *resizeStr( STR *str, size_t newSize, cBool exact )
 		}
 		else if( str )
 		{
-			free( str );
+			freeStr( str );
 		}
 	}
 	else
@@ -576,7 +576,7 @@ STR *replaceText( STR *str, size_t startPos, size_t len, const char *newText )
 		{
 			newTextStr = addStr( newTextStr, str->string + startPos + len );
 		}
-		free( str );
+		freeStr( str );
 	}
 	return newTextStr;
 }
@@ -967,7 +967,7 @@ STR *replaceLineEnds( STR *str, RLINE_ENDS newLineEnd )
 		*cpDest = 0;
 
 		newData->actSize = cpDest-newData->string;
-		free( str );
+		freeStr( str );
 		str = newData;
 	}
 	else
@@ -1033,7 +1033,7 @@ STR *pad( STR *str, size_t len, STR_PADDING mode )
 			char	*cp;
 
 			STR *newStr = rightString( str, len );
-			free( str );
+			freeStr( str );
 			str = newStr;
 			cp = str->string;
 			while( count-- )
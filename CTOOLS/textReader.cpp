@@ -38,6 +38,7 @@
 // --------------------------------------------------------------------- //
 
 #include <ctype.h>
+#include <cstring>
 
 #include <gak/textReader.h>
 #include <gak/gaklib.h>
@@ -83,6 +84,62 @@ const char UTF_8[]		= "UTF-8";
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	a lookup table for the characters that terminate a scan
+*/
+class TextReader::DelimiterTable
+{
+	bool	m_table[256];
+	char	m_single;
+
+	struct BlankTable
+	{
+		bool	m_table[256];
+
+		BlankTable()
+		{
+			for( int c=0; c<256; ++c )
+			{
+				m_table[c] = isSpace( static_cast<unsigned char>(c) );
+			}
+		}
+	};
+
+	public:
+	DelimiterTable( const char *delimiters, bool withBlanks, bool withNull )
+	{
+		static const BlankTable	blanks;
+
+		if( withBlanks )
+		{
+			std::memcpy( m_table, blanks.m_table, sizeof( m_table ) );
+		}
+		else
+		{
+			std::memset( m_table, 0, sizeof( m_table ) );
+		}
+		for( const char *cp = delimiters; *cp; ++cp )
+		{
+			m_table[static_cast<unsigned char>(*cp)] = true;
+		}
+		m_table[0] = withNull;
+
+		// a single delimiter can be found with memchr
+		m_single = !withBlanks && !withNull && delimiters[0] && !delimiters[1]
+			? delimiters[0]
+			: char(0);
+	}
+
+	bool contains( char c ) const
+	{
+		return m_table[static_cast<unsigned char>(c)];
+	}
+	char getSingle() const
+	{
+		return m_single;
+	}
+};
+
 // --------------------------------------------------------------------- //
 // ----- exported datas ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -126,6 +183,31 @@ static int getBase64Val( int c )
 /*
 	convert a 6-bit value to ascii
 */
+/*
+	appends len characters to dest and sets the charset like STRING::add( char )
+*/
+static void appendText( STRING *dest, const char *text, std::size_t len )
+{
+	std::size_t	oldLen = dest->strlen();
+	STR_CHARSET	charset = dest->getCharSet();
+
+	std::memcpy( dest->setActSize( oldLen + len ) + oldLen, text, len );
+
+	if( charset == STR_CS_UNKNOWN || charset == STR_ASCII )
+	{
+		charset = STR_ASCII;
+		for( const char *cp = text, *end = text+len; cp < end; ++cp )
+		{
+			if( !isAscii( *cp ) )
+			{
+				charset = STR_ANSI;
+				break;
+			}
+		}
+		dest->setCharSet( charset );
+	}
+}
+
 static char getBase64Code( unsigned char c )
 {
 	assert( c < 64 );
@@ -160,39 +242,95 @@ static char getBase64Code( unsigned char c )
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
-// --------------------------------------------------------------------- //
-// ----- class protected ----------------------------------------------- //
-// --------------------------------------------------------------------- //
+bool TextReader::fillBuffer()
+{
+	if( !m_inputStream )
+	{
+		return false;
+	}
 
-// --------------------------------------------------------------------- //
-// ----- class virtuals ------------------------------------------------ //
-// --------------------------------------------------------------------- //
+	// the characters that are no longer in the buffer must be counted
+	countPosition();
 
-// --------------------------------------------------------------------- //
-// ----- class publics ------------------------------------------------- //
-// --------------------------------------------------------------------- //
+	std::size_t	keep = std::min( std::size_t(m_cur - m_begin), PUTBACK_SIZE );
+	char		*buffer = m_buffer;
+	if( !buffer || m_blockSize < MAX_BLOCK_SIZE )
+	{
+		if( buffer )
+		{
+			m_blockSize *= 2;
+		}
+		buffer = new char[PUTBACK_SIZE + m_blockSize];
+	}
+	if( keep )
+	{
+		std::memmove( buffer + PUTBACK_SIZE - keep, m_cur - keep, keep );
+	}
+	if( buffer != m_buffer )
+	{
+		delete [] m_buffer;
+		m_buffer = buffer;
+	}
+
+	m_inputStream->read( m_buffer + PUTBACK_SIZE, m_blockSize );
+	std::size_t	count = std::size_t(m_inputStream->gcount());
+
+	m_begin = m_buffer + PUTBACK_SIZE - keep;
+	m_cur = m_counted = m_buffer + PUTBACK_SIZE;
+	m_end = m_cur + count;
 
-char TextReader::getNextWithBlank( void )
+	return count > 0;
+}
+
+void TextReader::countPosition() const
 {
-	doEnterFunctionEx(gakLogging::llDetail,"TextReader::getNextWithBlankXXX");
-	int c = m_inputStream->get();
-	doLogValueEx(gakLogging::llDetail, c);
+	const char	*cp = m_counted;
 
-	if( c == '\n' )
+	while( cp < m_cur )
 	{
+		const char *nl = static_cast<const char *>(
+			std::memchr( cp, '\n', std::size_t(m_cur - cp) )
+		);
+		if( !nl )
+		{
+			if( m_utf8 )
+			{
+				// the following bytes of an UTF-8 sequence are no columns
+				for( ; cp < m_cur; ++cp )
+				{
+					if( (*cp & 0xC0) != 0x80 )
+					{
+						m_position.m_column++;
+					}
+				}
+			}
+			else
+			{
+				m_position.m_column += std::size_t(m_cur - cp);
+			}
+			break;
+		}
 		m_position.m_lineNo++;
 		m_position.m_column = 0;
+		cp = nl+1;
 	}
-	else if( c == EOF || m_inputStream->eof() || m_inputStream->fail() )
-	{
-		c = 0;
-	}
-	else
+	m_counted = m_cur;
+}
+
+char TextReader::readNextChar()
+{
+	doEnterFunctionEx(gakLogging::llDetail,"TextReader::readNextChar");
+
+	if( m_cur >= m_end && !fillBuffer() )
 	{
-		m_position.m_column++;
+		m_eof = true;
+		return 0;
 	}
 
-	if( c>127 && m_encoding == UTF_8 )
+	int c = static_cast<unsigned char>(*m_cur++);
+	doLogValueEx(gakLogging::llDetail, c);
+
+	if( c>127 && m_utf8 )
 	{
 		int				byteCount;
 		unsigned long	byteValue = c;
@@ -219,12 +357,17 @@ char TextReader::getNextWithBlank( void )
 		{
 			while( --byteCount > 0 )
 			{
-				c = m_inputStream->get();
+				if( m_cur >= m_end && !fillBuffer() )
+				{
+					m_eof = true;
+					break;
+				}
+				c = static_cast<unsigned char>(*m_cur);
 				if( c <=127 )
 				{
-					putback( char(c) );
 					break;
 				}
+				++m_cur;
 				byteValue = (byteValue << 6) | (c & ~0xC0);
 			}
 		}
@@ -241,6 +384,81 @@ char TextReader::getNextWithBlank( void )
 	return char(c);
 }
 
+/*
+	appends all characters until one of delimiters to result, the delimiter
+	is not read, returns false at the end of the stream
+*/
+bool TextReader::appendUntil( const DelimiterTable &delimiters, STRING *result )
+{
+	const char	single = delimiters.getSingle();
+
+	for(;;)
+	{
+		if( m_cur >= m_end && !fillBuffer() )
+		{
+			m_eof = true;
+			return false;
+		}
+
+		const char	*start = m_cur;
+		if( m_utf8 )
+		{
+			while( m_cur < m_end && !(*m_cur & 0x80) && !delimiters.contains( *m_cur ) )
+			{
+				++m_cur;
+			}
+		}
+		else if( single )
+		{
+			m_cur = static_cast<const char *>(
+				std::memchr( m_cur, single, std::size_t(m_end - m_cur) )
+			);
+			if( !m_cur )
+			{
+				m_cur = m_end;
+			}
+		}
+		else
+		{
+			while( m_cur < m_end && !delimiters.contains( *m_cur ) )
+			{
+				++m_cur;
+			}
+		}
+
+		if( result && m_cur > start )
+		{
+			appendText( result, start, std::size_t(m_cur - start) );
+		}
+		if( m_cur < m_end )
+		{
+			if( delimiters.contains( *m_cur ) )
+			{
+				return true;
+			}
+
+			// an UTF-8 sequence
+			char c = readNextChar();
+			if( result )
+			{
+				*result += c;
+			}
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
 char TextReader::getNextNonBlank( void )
 {
 	char c;
@@ -251,27 +469,98 @@ char TextReader::getNextNonBlank( void )
 	return c;
 }
 
-STRING TextReader::readString( char stringDelimiter )
+void TextReader::putback( char c )
 {
-	STRING	value;
+	countPosition();
+	if( c == '\n' )
+	{
+		m_position.m_lineNo--;
+	}
+	else
+	{
+		m_position.m_column--;
+	}
 
-	char	c;
+	// like std::istream we cannot put back after the end of the stream
+	if( !m_eof && m_cur > m_begin )
+	{
+		--m_cur;
+		// go back to the first byte of an UTF-8 sequence
+		while( m_utf8 && m_cur > m_begin && (*m_cur & 0xC0) == 0x80 )
+		{
+			--m_cur;
+		}
+	}
+	m_counted = m_cur;
+}
+
+STRING TextReader::readString( char stringDelimiter )
+{
+	char			delimiters[] = { stringDelimiter, 0 };
+	DelimiterTable	table( delimiters, false, false );
+	STRING			value;
 
 	// read the string until delimiter
-	while( !eof() )
+	if( !m_eof && appendUntil( table, &value ) )
+	{
+		++m_cur;
+	}
+
+	return value;
+}
+
+STRING TextReader::readUntil( const char *delimiters )
+{
+	DelimiterTable	table( delimiters, false, false );
+	STRING			value;
+
+	if( !m_eof )
 	{
-		c = getNextWithBlank();
-		if( c != stringDelimiter )
+		appendUntil( table, &value );
+	}
+
+	return value;
+}
+
+char TextReader::skipUntil( const char *delimiters )
+{
+	DelimiterTable	table( delimiters, false, true );
+
+	return !m_eof && appendUntil( table, NULL ) ? *m_cur++ : char(0);
+}
+
+void TextReader::skipBlanks()
+{
+	while( !m_eof )
+	{
+		if( m_cur >= m_end && !fillBuffer() )
 		{
-			value += c;
+			m_eof = true;
+			break;
 		}
-		else
+		while( m_cur < m_end && !(m_utf8 && (*m_cur & 0x80)) && isSpace( *m_cur ) )
+		{
+			++m_cur;
+		}
+		if( m_cur < m_end )
 		{
 			break;
 		}
 	}
+}
 
-	return value;
+STRING TextReader::readToken( const char *delimiters )
+{
+	DelimiterTable	table( delimiters, true, true );
+	STRING			token;
+
+	skipBlanks();
+	if( !m_eof )
+	{
+		appendUntil( table, &token );
+	}
+
+	return token;
 }
 
 STRING TextReader::getErrors( void )
@@ -270,6 +270,7 @@ void Thread::RunThread()
 		std::cerr << "Thread Crash " << FindCurrentThreadIdx() << std::endl;
 		doLogMessageEx(gakLogging::llFatal,"Thread Crash");
 	}
+	flushStrCache();
 	clrRunning();
 }
 
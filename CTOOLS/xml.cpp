@@ -37,6 +37,7 @@
 
 #include <gak/xml.h>
 #include <gak/xmlValidator.h>
+#include <gak/xmlIndex.h>
 
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
@@ -83,6 +84,40 @@ const char XMLNS_NS_SCHEMALOCATION[]	= "noNamespaceSchemaLocation";
 
 const char XSLT_PUBLIC[]				= "doctype-public";
 
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	changing these attributes invalidates the element index
+*/
+static inline bool isIndexedAttribute( const STRING &name )
+{
+	return !name.compareI( "id" ) || !name.compareI( "class" );
+}
+
+/*
+	the search of Element::findElement without any index
+*/
+static Element *findElementInTree(
+	const Element *context, const STRING &tag, const STRING &nameSpace
+)
+{
+	Element *theElement = context->getElement( tag, nameSpace );
+	if( !theElement )
+	{
+		size_t i, numElems = context->getNumObjects();
+		for( i = 0; i<numElems; i++ )
+		{
+			theElement = findElementInTree( context->getElement(i), tag, nameSpace );
+			if( theElement )
+/*v*/			break;
+		}
+	}
+
+	return theElement;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class constructors/destructors -------------------------------- //
 // --------------------------------------------------------------------- //
@@ -108,6 +143,11 @@ Element::~Element()
 	if( theCssStyle )
 		delete theCssStyle;
 };
+
+Document::~Document()
+{
+	delete m_index;
+}
 // --------------------------------------------------------------------- //
 // ----- class static functions ---------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -355,6 +395,7 @@ Element *XmlContainer::addObject( Element *newObject, bool parserMode )
 		hasPCdata = true;
 
 	objects += newObject;
+	treeChanged();
 
 	return newObject;
 }
@@ -380,6 +421,7 @@ Element *XmlContainer::removeObject( size_t i )
 	Element	*oldObject = getElement( i );
 	if( oldObject )
 	{
+		treeChanged();
 		oldObject->parent = NULL;
 		objects.removeElementAt( i );
 	}
@@ -407,6 +449,7 @@ Element *XmlContainer::removeObject( Element *oldObject )
 	index = getIndex( oldObject );
 	if( index >= 0 )
 	{
+		treeChanged();
 		oldObject->parent = NULL;
 		objects.removeElementAt( (size_t)index );
 
@@ -450,6 +493,7 @@ Element	*XmlContainer::replaceObject(
 	index = getIndex( oldObject );
 	if( index >= 0 )
 	{
+		treeChanged();
 		oldObject->parent = NULL;
 		objects[(size_t)index] = newObject;
 		newObject->parent = this;
@@ -562,6 +606,23 @@ Element *XmlContainer::getElement(
 	STRING		theTag, xmlnsTag, prefix;
 	Element	*theElem;
 
+	if( numElems >= MIN_INDEXED_CHILDREN )
+	{
+		ElementIndex	*index = getTreeIndex();
+		if( index && index->hasElement( this ) )
+		{
+			const XmlArray *candidates = index->getElementsByTag( tag );
+			if( !candidates )
+			{
+/*@*/			return NULL;
+			}
+			if( candidates->size() < numElems )
+			{
+/*@*/			return index->getChild( this, tag, nameSpace );
+			}
+		}
+	}
+
 	for( i = 0; i<numElems; i++ )
 	{
 		theElem = objects[i];
@@ -580,19 +641,16 @@ Element *XmlContainer::getElement(
 */
 Element *Element::findElement( const STRING &tag, const STRING &nameSpace ) const
 {
-	Element *theElement = getElement( tag, nameSpace );
-	if( !theElement )
+	if( getNumObjects() )
 	{
-		size_t i, numElems = getNumObjects();
-		for( i = 0; i<numElems; i++ )
+		ElementIndex	*index = getTreeIndex();
+		if( index && index->hasElement( this ) )
 		{
-			theElement = getElement(i)->findElement( tag, nameSpace );
-			if( theElement )
-/*v*/			break;
+/*@*/		return index->findElement( this, tag, nameSpace );
 		}
 	}
 
-	return theElement;
+	return findElementInTree( this, tag, nameSpace );
 }
 
 /*
@@ -841,6 +899,9 @@ Element *XmlWithAttributes::setStringAttribute( const STRING &name, const STRING
 {
 	if( byParser || isValidAttribute( name, value ) )
 	{
+		if( isIndexedAttribute( name ) )
+			treeChanged();
+
 //		if( isCaseSensitive() )
 			attributes.updateField( name, value );
 /*
@@ -862,6 +923,9 @@ Element *XmlWithAttributes::setStringAttribute( const STRING &name, const STRING
 
 Element *XmlWithAttributes::setStringAttribute( size_t i, const STRING &value )
 {
+	if( isIndexedAttribute( attributes[i].getKey() ) )
+		treeChanged();
+
 	attributes[i].setValue( value );
 	return this;
 }
@@ -893,6 +957,9 @@ void XmlWithAttributes::deleteAttribute( const STRING &name )
 
 void XmlWithAttributes::deleteAttribute( size_t i )
 {
+	if( isIndexedAttribute( attributes[i].getKey() ) )
+		treeChanged();
+
 	attributes.removeElementAt( i );
 }
 
@@ -953,6 +1020,9 @@ void Document::setAttributeName( size_t, const STRING & )
 
 void XmlWithAttributes::setAttributeName( size_t i, const STRING &name )
 {
+	if( isIndexedAttribute( name ) || isIndexedAttribute( attributes[i].getKey() ) )
+		treeChanged();
+
 	attributes[i].setKey( name );
 }
 
@@ -1061,7 +1131,7 @@ STRING Document::getTag( void ) const
 
 STRING Any::getTag( void ) const
 {
-	return tag;
+	return tag.getName();
 }
 
 STRING Mark::getTag( void ) const
@@ -1069,6 +1139,21 @@ STRING Mark::getTag( void ) const
 	return piTag;
 }
 
+/*
+---------------------------------------------------------------------------
+	getTagAtom
+---------------------------------------------------------------------------
+*/
+Atom Element::getTagAtom( void ) const
+{
+	return Atom( getTag() );
+}
+
+Atom Any::getTagAtom( void ) const
+{
+	return tag;
+}
+
 /*
 ---------------------------------------------------------------------------
 	getPath
@@ -1106,14 +1191,44 @@ void Element::setTag( const STRING & )
 
 void Any::setTag( const STRING &tag )
 {
-	this->tag = tag;
+	treeChanged();
+	this->tag = Atom( tag );
 }
 
 void Mark::setTag( const STRING &tag )
 {
+	treeChanged();
 	piTag = tag;
 }
 
+/*
+---------------------------------------------------------------------------
+	element index
+---------------------------------------------------------------------------
+*/
+ElementIndex *Element::getEnabledIndex()
+{
+	return NULL;	// no document => no index
+}
+
+ElementIndex *Document::getEnabledIndex()
+{
+	return m_indexEnabled ? &getIndex() : NULL;
+}
+
+void Element::clearIndex()
+{
+}
+
+void Document::clearIndex()
+{
+	if( m_index )
+	{
+		delete m_index;
+		m_index = NULL;
+	}
+}
+
 /*
 ---------------------------------------------------------------------------
 	setValue
@@ -1717,6 +1832,19 @@ Element *Document::getRoot( const STRING &tag, const STRING &nameSpace )
 	return theRoot;
 }
 
+ElementIndex &Document::getIndex()
+{
+	if( !m_index )
+		m_index = new ElementIndex( this );
+
+	return *m_index;
+}
+
+Element *Document::getElementById( const STRING &id )
+{
+	return getIndex().getElementById( id );
+}
+
 Element *Element::findRoot( void ) const
 {
 	if( parent )
@@ -0,0 +1,410 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlAtom.cpp
+		Description:	interned names of XML tags and attributes
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstring>
+
+#include <gak/xmlAtom.h>
+#include <gak/array.h>
+#include <gak/hashMap.h>
+#include <gak/locker.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static const std::size_t MIN_ATOM_SLOTS = 256;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	an open addressing hash table of names
+
+	HashMap<STRING> would need a STRING for each lookup, but the PullParser
+	shall not copy the names that are already known.
+*/
+class XmlAtomTable
+{
+	Critical				m_lock;
+	Array<Atom::Data *>		m_atoms;
+	Array<std::size_t>		m_slots;	// 0 or index of m_atoms + 1
+	std::size_t				m_size, m_maxSize;
+
+	static std::size_t hash( const char *name, std::size_t length )
+	{
+		uint32	hash = FNV_OFFSET_BASIS;
+		for( std::size_t i=0; i<length; ++i )
+		{
+			hash = (hash ^ (unsigned char)name[i]) * FNV_PRIME;
+		}
+		return hash;
+	}
+	static bool isEqual(
+		const Atom::Data *data, const char *name, std::size_t length,
+		STR_CHARSET charset
+	)
+	{
+		return data->m_name.strlen() == length
+			&& data->m_name.getCharSet() == charset
+			&& !std::memcmp( (const char *)data->m_name, name, length );
+	}
+	void resetSlots( std::size_t numSlots )
+	{
+		m_slots.clear();
+		std::size_t	*slots = m_slots.createElements( numSlots );
+		std::memset( slots, 0, numSlots * sizeof( std::size_t ) );
+	}
+	static std::size_t getAtomSize( std::size_t length )
+	{
+		return sizeof( Atom::Data ) + length + 1;
+	}
+	void grow();
+	const Atom::Data *insert(
+		const char *name, std::size_t length, STR_CHARSET charset, bool isLocalName
+	);
+
+	public:
+	XmlAtomTable() : m_size( 0 ), m_maxSize( XML_ATOM_TABLE_SIZE )
+	{
+		resetSlots( MIN_ATOM_SLOTS );
+	}
+	const Atom::Data *intern(
+		const char *name, std::size_t length, STR_CHARSET charset
+	);
+	std::size_t size()
+	{
+		CriticalScope	scope( m_lock );
+		return m_atoms.size();
+	}
+	std::size_t getSize()
+	{
+		CriticalScope	scope( m_lock );
+		return m_size;
+	}
+	void setMaxSize( std::size_t maxSize )
+	{
+		CriticalScope	scope( m_lock );
+		m_maxSize = maxSize;
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+const STRING Atom::s_noName;
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	the table is created with the first atom and never destroyed, thus
+	atoms of static objects are valid during start and exit
+*/
+static XmlAtomTable &getAtomTable()
+{
+	static XmlAtomTable *theTable = new XmlAtomTable;
+	return *theTable;
+}
+
+static STR_CHARSET getNameCharset(
+	const char *name, std::size_t length, STR_CHARSET charset
+)
+{
+	for( std::size_t i=0; i<length; ++i )
+	{
+		if( (unsigned char)name[i] >= 0x80 )
+		{
+/*@*/		return charset;
+		}
+	}
+	return STR_ASCII;
+}
+
+std::size_t hashValue( const Atom &atom )
+{
+	return atom.isInterned() ? atom.getId() : hashValue( atom.getName() );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+Atom::Atom( const STRING &name )
+{
+	std::size_t	length = name.strlen();
+	const char	*text = name;
+
+	intern( text, length, getNameCharset( text, length, name.getCharSet() ) );
+}
+
+Atom::Atom( const char *name )
+{
+	std::size_t	length = name ? std::strlen( name ) : 0;
+
+	intern( name, length, getNameCharset( name, length, STR_ANSI ) );
+}
+
+Atom::Atom( const char *name, std::size_t length, bool utf8 )
+{
+	intern( name, length, getNameCharset( name, length, utf8 ? STR_UTF8 : STR_ANSI ) );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+std::size_t Atom::getNumAtoms()
+{
+	return getAtomTable().size();
+}
+
+std::size_t Atom::getTableSize()
+{
+	return getAtomTable().getSize();
+}
+
+void Atom::setMaxTableSize( std::size_t maxSize )
+{
+	getAtomTable().setMaxSize( maxSize );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void Atom::intern( const char *name, std::size_t length, STR_CHARSET charset )
+{
+	m_data = length ? getAtomTable().intern( name, length, charset ) : NULL;
+	if( length && !m_data )
+	{
+		// the table is full
+		m_name = STRING( name, length );
+		if( charset == STR_UTF8 )
+		{
+			m_name.setCharSet( STR_UTF8 );
+		}
+	}
+}
+
+void XmlAtomTable::grow()
+{
+	std::size_t	numSlots = m_slots.size() * 2;
+	std::size_t	mask = numSlots - 1;
+
+	resetSlots( numSlots );
+	for( std::size_t i=0; i<m_atoms.size(); ++i )
+	{
+		const STRING	&name = m_atoms[i]->m_name;
+		std::size_t		slot = hash( name, name.strlen() ) & mask;
+
+		while( m_slots[slot] )
+		{
+			slot = (slot+1) & mask;
+		}
+		m_slots[slot] = i+1;
+	}
+}
+
+const Atom::Data *XmlAtomTable::insert(
+	const char *name, std::size_t length, STR_CHARSET charset, bool isLocalName
+)
+{
+	std::size_t	mask = m_slots.size() - 1;
+	std::size_t	slot = hash( name, length ) & mask;
+
+	for( ; m_slots[slot]; slot = (slot+1) & mask )
+	{
+		const Atom::Data	*data = m_atoms[m_slots[slot]-1];
+		if( isEqual( data, name, length, charset ) )
+		{
+/*@*/		return data;
+		}
+	}
+
+	// the space for the local name was reserved with its qualified name
+	if( !isLocalName && m_size + 2*getAtomSize( length ) > m_maxSize )
+	{
+/*@*/	return NULL;
+	}
+	if( (m_atoms.size()+1) * 2 > m_slots.size() )
+	{
+		grow();
+		mask = m_slots.size() - 1;
+		for( slot = hash( name, length ) & mask; m_slots[slot]; slot = (slot+1) & mask )
+			;
+	}
+	m_size += getAtomSize( length );
+
+	Atom::Data	*data = new Atom::Data;
+	data->m_name = STRING( name, length );
+	if( charset == STR_UTF8 )
+	{
+		data->m_name.setCharSet( STR_UTF8 );
+	}
+	data->m_id = m_atoms.size()+1;
+	data->m_localName = data;
+
+	m_atoms += data;
+	m_slots[slot] = data->m_id;
+
+	const char	*colon = static_cast<const char *>(
+		std::memchr( name, ':', length )
+	);
+	if( colon && colon+1 < name+length )
+	{
+		const char	*localName = colon+1;
+		std::size_t	localLength = std::size_t(name + length - localName);
+
+		data->m_localName = insert(
+			localName, localLength,
+			getNameCharset( localName, localLength, charset ), true
+		);
+	}
+
+	return data;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+const Atom::Data *XmlAtomTable::intern(
+	const char *name, std::size_t length, STR_CHARSET charset
+)
+{
+	CriticalScope	scope( m_lock );
+	return insert( name, length, charset, false );
+}
+
+Atom Atom::getLocalName() const
+{
+	if( m_data )
+	{
+/*@*/	return Atom( m_data->m_localName );
+	}
+
+	const char	*name = m_name;
+	std::size_t	length = m_name.strlen();
+	const char	*colon = length
+		? static_cast<const char *>( std::memchr( name, ':', length ) )
+		: NULL;
+
+	if( !colon || colon+1 >= name+length )
+	{
+/*@*/	return *this;
+	}
+
+	const char	*localName = colon+1;
+	std::size_t	localLength = std::size_t(name + length - localName);
+	Atom		result;
+
+	result.intern(
+		localName, localLength, getNameCharset( localName, localLength, m_name.getCharSet() )
+	);
+	return result;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
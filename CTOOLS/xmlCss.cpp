@@ -36,6 +36,7 @@
 #include <fstream>
 
 #include <gak/xml.h>
+#include <gak/xmlIndex.h>
 #include <gak/directory.h>
 #include <gak/stringStream.h>
 #include <gak/logfile.h>
@@ -65,6 +66,16 @@ namespace xml
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+bool Document::matchSelector( const css::SelectorPart &part, Element *element )
+{
+	if( m_index && m_index->hasElement( element ) )
+	{
+/*@*/	return m_index->match( part, element );
+	}
+
+	return part.match( element );
+}
+
 css::Value Document::findCssValue(
 	Element *element, const CI_STRING &media, size_t offset
 )
@@ -96,7 +107,7 @@ css::Value Document::findCssValue(
 
 			css::Selector	&theSelector = theRule.selectorList[j];
 
-			if( !theSelector.match( element ) )
+			if( !matchSelector( theSelector, element ) )
 /*^*/			continue;
 
 			if( theSelector.hasPredessor() )
@@ -110,7 +121,7 @@ css::Value Document::findCssValue(
 					if( theSpec.isSibling() )
 					{
 						parent = parent->getPrevious();
-						if( theSpec.match( parent ) )
+						if( parent && matchSelector( theSpec, parent ) )
 						{
 							matchFound = true;
 						}
@@ -124,7 +135,7 @@ css::Value Document::findCssValue(
 						)
 						{
 
-							if( theSpec.match( parent ) )
+							if( matchSelector( theSpec, parent ) )
 							{
 								matchFound = true;
 /*v*/							break;
@@ -231,7 +242,7 @@ css::Value Document::findBackgroundImage(
 
 			css::Selector	&theSelector = theRule.selectorList[j];
 
-			if( !theSelector.match( element ) )
+			if( !matchSelector( theSelector, element ) )
 /*^*/			continue;
 
 			if( theSelector.hasPredessor() )
@@ -245,7 +256,7 @@ css::Value Document::findBackgroundImage(
 					if( theSpec.isSibling() )
 					{
 						parent = parent->getPrevious();
-						if( theSpec.match( parent ) )
+						if( parent && matchSelector( theSpec, parent ) )
 						{
 							matchFound = true;
 						}
@@ -259,7 +270,7 @@ css::Value Document::findBackgroundImage(
 						)
 						{
 
-							if( theSpec.match( parent ) )
+							if( matchSelector( theSpec, parent ) )
 							{
 								matchFound = true;
 /*v*/							break;
@@ -359,6 +370,16 @@ void Document::readCssRules( bool toLowerCase )
 	}
 }
 
+void Document::readCssRules( std::istream *theInputStream, bool toLowerCase )
+{
+	doEnterFunction("Document::readCssRules( std::istream *theInputStream, bool toLowerCase )");
+	cssRules.readCssFile( theInputStream, toLowerCase );
+
+	// the rules may have been moved
+	if( m_index )
+		m_index->clearSelectors();
+}
+
 void Document::readCssRules( const STRING &styles, bool toLowerCase )
 {
 	doEnterFunction("Document::readCssRules( const STRING &styles, bool toLowerCase )");
@@ -368,6 +389,27 @@ void Document::readCssRules( const STRING &styles, bool toLowerCase )
 	readCssRules( &theInputStream, toLowerCase );
 }
 
+void Document::clearCssRules()
+{
+	cssRules.clear();
+	clearCss();
+
+	if( m_index )
+		m_index->clearSelectors();
+}
+
+void Document::applyCssRules( const CI_STRING &media )
+{
+	Element *theRoot = getRoot();
+
+	if( theRoot && cssRules.size() )
+	{
+		// each selector part is matched with all elements only once
+		getIndex();
+		applyCssRules( theRoot, media );
+	}
+}
+
 STRING Document::getBackgroundImage(
 	Element *element, const CI_STRING &media
 )
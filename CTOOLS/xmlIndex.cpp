@@ -0,0 +1,364 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlIndex.cpp
+		Description:	hashed lookup of XML elements by tag, id and class
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/xmlIndex.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+ElementIndex::ElementIndex( Element *root )
+{
+	addElement( root );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+std::size_t ElementIndex::lowerBound(
+	const XmlArray &elements, std::size_t position
+) const
+{
+	std::size_t	first = 0, last = elements.size();
+
+	while( first < last )
+	{
+		std::size_t	middle = (first + last) / 2;
+		if( m_extents[elements[middle]].m_first < position )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+
+	return first;
+}
+
+Element *ElementIndex::findFirst(
+	const Element *context, const XmlArray &candidates,
+	const STRING &tag, const STRING &nameSpace
+) const
+{
+	/*
+		the descendants of context are a range of the candidates
+	*/
+	const Extent	&extent = m_extents[context];
+	std::size_t		first = lowerBound( candidates, extent.m_first+1 );
+	std::size_t		end = lowerBound( candidates, extent.m_end );
+	Element			*firstMatch = NULL;
+
+	/*
+		findElement searches the children before the grand children
+	*/
+	for( std::size_t i=first; i<end; ++i )
+	{
+		Element	*theElement = candidates[i];
+		if( (theElement->getParent() == context || !firstMatch)
+		&& isMatch( theElement, tag, nameSpace ) )
+		{
+			if( theElement->getParent() == context )
+			{
+/*@*/			return theElement;
+			}
+			firstMatch = theElement;
+		}
+	}
+
+	if( !firstMatch )
+	{
+/*@*/	return NULL;
+	}
+
+	/*
+		the first match in document order is a descendant of the first child
+		with a match
+	*/
+	Element	*child = firstMatch;
+	while( child->getParent() != context )
+	{
+		child = child->getParent();
+	}
+
+	return findFirst( child, candidates, tag, nameSpace );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void ElementIndex::addElement( Element *theElement )
+{
+	Extent	&extent = m_extents[theElement];
+	extent.m_first = m_all.size();
+	m_all += theElement;
+
+	STRING	tag = theElement->getTag();
+	if( !tag.isEmpty() )
+	{
+		m_tags[Element::getLocalName( tag )] += theElement;
+
+		STRING	id = theElement->getId();
+		if( !id.isEmpty() )
+		{
+			m_ids[id] += theElement;
+		}
+
+		STRING	elementClass = theElement->getClass();
+		if( !elementClass.isEmpty() )
+		{
+			// split like css::SelectorPart::match does
+			ArrayOfStrings	elementClasses;
+			elementClasses.createElements( elementClass, " " );
+			for( std::size_t i=0; i<elementClasses.size(); ++i )
+			{
+				if( !elementClasses[i].isEmpty() )
+				{
+					m_classes[elementClasses[i]] += theElement;
+				}
+			}
+		}
+	}
+
+	std::size_t	numElements = theElement->getNumObjects();
+	for( std::size_t i=0; i<numElements; ++i )
+	{
+		addElement( theElement->getElement( i ) );
+	}
+
+	// the map may have been resized
+	m_extents[theElement].m_end = m_all.size();
+}
+
+const ElementIndex::ElementSet &ElementIndex::getSelectorMatches(
+	const css::SelectorPart &part
+)
+{
+	std::size_t	index = m_selectors.getElementIndex( &part );
+	if( index != m_selectors.no_index )
+	{
+/*@*/	return m_selectors.getValueAt( index );
+	}
+
+	ElementSet	&matches = m_selectors[&part];
+
+	/*
+		use the most selective key to find the candidates
+	*/
+	const ArrayOfStrings	&cssClasses = part.getCssClasses();
+	Array<const XmlArray *>	candidates;
+	if( !part.getId().isEmpty() )
+	{
+		candidates += getElementsById( part.getId() );
+	}
+	else if( cssClasses.size() )
+	{
+		for( std::size_t i=0; i<cssClasses.size(); ++i )
+		{
+			candidates += getElementsByClass( cssClasses[i] );
+		}
+	}
+	else if( !part.getTag().isEmpty() && part.getTag() != "*" )
+	{
+		candidates += getElementsByTag( Element::getLocalName( part.getTag() ) );
+	}
+	else
+	{
+		candidates += &m_all;
+	}
+
+	for( std::size_t i=0; i<candidates.size(); ++i )
+	{
+		const XmlArray	*elements = candidates[i];
+		if( elements )
+		{
+			for( std::size_t j=0; j<elements->size(); ++j )
+			{
+				Element	*theElement = (*elements)[j];
+				if( part.match( theElement ) )
+				{
+					matches += theElement;
+				}
+			}
+		}
+	}
+
+	return matches;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+Element *ElementIndex::getElementById( const STRING &id ) const
+{
+	const XmlArray	*candidates = getElementsById( id );
+	if( candidates )
+	{
+		for( std::size_t i=0; i<candidates->size(); ++i )
+		{
+			Element	*theElement = (*candidates)[i];
+			if( theElement->getId() == id )
+			{
+/*@*/			return theElement;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+Element *ElementIndex::getChild(
+	const Element *parent, const STRING &tag, const STRING &nameSpace
+) const
+{
+	const XmlArray	*candidates = getElementsByTag( tag );
+	if( candidates )
+	{
+		for( std::size_t i=0; i<candidates->size(); ++i )
+		{
+			Element	*theElement = (*candidates)[i];
+			if( theElement->getParent() == parent
+			&& isMatch( theElement, tag, nameSpace ) )
+			{
+/*@*/			return theElement;
+			}
+		}
+	}
+
+	return NULL;
+}
+
+Element *ElementIndex::findElement(
+	const Element *context, const STRING &tag, const STRING &nameSpace
+) const
+{
+	const XmlArray	*candidates = getElementsByTag( tag );
+	if( !candidates )
+	{
+/*@*/	return NULL;
+	}
+
+	return findFirst( context, *candidates, tag, nameSpace );
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
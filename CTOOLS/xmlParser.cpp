@@ -342,14 +342,7 @@ bool Parser::processTag( Element *theXMLData, bool includeBlanks, int level, con
 
 char Parser::findNextMetaChar( const char *meta )
 {
-	char c;
-
-	do
-	{
-		c = getNextNonBlank();
-	} while( !eof() && !strchr( meta, c ) );
-
-	return c;
+	return skipUntil( meta );
 }
 
 /*
@@ -487,6 +480,11 @@ STRING Parser::readProcessingInstruction( void )
 
 STRING Parser::parseEntities( const STRING &value )
 {
+	if( value.searchChar( '&' ) == value.no_index )
+	{
+/*@*/	return value;
+	}
+
 	STRING		newValue, entity;
 	char		c;
 	std::size_t	i = 0;
@@ -531,22 +529,7 @@ STRING Parser::parseEntities( const STRING &value )
 
 STRING Parser::readPCdata( void )
 {
-	STRING	pcData;
-	char	c;
-
-	while( !eof() )
-	{
-		c = getNextWithBlank();
-		if( c == '<' )
-		{
-			putback( c );
-			break;
-		}
-		else
-		{
-			pcData += c;
-		}
-	}
+	STRING	pcData = readUntil( "<" );
 
 	fixCharset( &pcData );
 	return parseEntities( pcData );
@@ -622,31 +605,10 @@ STRING Parser::readCdata( void )
 */
 STRING Parser::readIdentifier( void )
 {
-	STRING	token;
-	const char *delimiters = "?=&<>\"\'/";
-
-	char	c;
-
-	// eat white space
-	do
-	{
-		c = getNextNonBlank();
-	} while( !eof() && isspace( c ) );
-
-	// read the identifier
-	while( !eof()
-	&& !isspace( c )
-	&& !strchr( delimiters, c ) )
-	{
-		token += c;
-		c = getNextWithBlank();
-	}
-
-	// put back the delimiter
-	putback( c );
+	STRING	token = readToken( "?=&<>\"\'/" );
 
 	fixCharset( &token );
-	return m_identifiers.addElement( token );
+	return Atom( token ).getName();
 }
 
 Element *Parser::readObject( Element *theXMLData, bool includeBlanks, int level )
@@ -666,7 +628,7 @@ Element *Parser::readObject( Element *theXMLData, bool includeBlanks, int level
 		}
 
 		// read the tag
-		STRING theTag = m_identifiers.addElement( getNextTag() );
+		STRING theTag = Atom( getNextTag() ).getName();
 
 		if( theTag[0U] == '/' )
 		{
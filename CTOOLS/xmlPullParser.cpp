@@ -0,0 +1,641 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlPullParser.cpp
+		Description:	a pull parser for XML with zero copy tokens
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstdlib>
+
+#include <gak/xmlPullParser.h>
+#include <gak/ansiChar.h>
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static const char COMMENT_START[] = "!--";
+static const char COMMENT_END[] = "-->";
+static const char CDATA_START[] = "![CDATA[";
+static const char CDATA_END[] = "]]>";
+static const char DOCTYPE_START[] = "!DOCTYPE";
+static const char PI_END[] = "?>";
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	same delimiters as Parser::readIdentifier
+*/
+static inline bool isNameChar( char c )
+{
+	switch( c )
+	{
+		case '?':
+		case '=':
+		case '&':
+		case '<':
+		case '>':
+		case '"':
+		case '\'':
+		case '/':
+			return false;
+		default:
+			return !isSpace( c );
+	}
+}
+
+static inline bool startsWith( const char *cur, const char *end, const char *text, std::size_t len )
+{
+	return std::size_t(end - cur) >= len && !std::memcmp( cur, text, len );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+PullParser::PullParser( const STRING &fileName )
+: m_mappedFile( fileName ), m_position( fileName )
+{
+	setBuffer( m_mappedFile.getData(), m_mappedFile.size() );
+}
+
+PullParser::PullParser( std::istream *theInput, const STRING &fileName )
+: m_position( fileName )
+{
+	char	buffer[10240];
+
+	while( theInput->read( buffer, sizeof( buffer ) ), theInput->gcount() > 0 )
+	{
+		m_buffer.addElements( buffer, std::size_t(theInput->gcount()) );
+	}
+	setBuffer( m_buffer.getDataBuffer(), m_buffer.size() );
+}
+
+PullParser::PullParser( const char *text, std::size_t length, const STRING &fileName )
+: m_position( fileName )
+{
+	setBuffer( text, length );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+void PullParser::setBuffer( const char *data, std::size_t size )
+{
+	if( !data )
+	{
+		data = "";
+		size = 0;
+	}
+	m_start = m_cur = data;
+	m_end = data + size;
+
+	m_event = etEND_DOCUMENT;
+	m_inTag = m_emptyElement = m_utf8 = false;
+}
+
+const char *PullParser::find( const char *text, std::size_t len ) const
+{
+	for( const char *cur = m_cur; cur < m_end; ++cur )
+	{
+		cur = static_cast<const char *>(
+			std::memchr( cur, *text, std::size_t(m_end - cur) )
+		);
+		if( !cur )
+		{
+			break;
+		}
+		if( startsWith( cur, m_end, text, len ) )
+		{
+			return cur;
+		}
+	}
+	return m_end;
+}
+
+StringView PullParser::readName()
+{
+	skipBlanks();
+
+	const char *name = m_cur;
+	while( m_cur < m_end && isNameChar( *m_cur ) )
+	{
+		++m_cur;
+	}
+
+	return StringView( name, std::size_t(m_cur - name) );
+}
+
+PullParser::EventType PullParser::readAttribute()
+{
+	for(;;)
+	{
+		skipBlanks();
+		if( m_cur >= m_end )
+		{
+			addError( "Unexpected end of file in tag " + m_name.toString() );
+			m_inTag = false;
+			return m_event = etEND_DOCUMENT;
+		}
+
+		char c = *m_cur;
+		if( c == '>' )
+		{
+			++m_cur;
+			m_inTag = false;
+/*@*/		return next();
+		}
+		else if( c == '/' )
+		{
+			// this element is terminated with its start tag
+			m_cur = find( '>' );
+			if( m_cur < m_end )
+			{
+				++m_cur;
+			}
+			m_inTag = false;
+			m_emptyElement = true;
+			m_value = StringView();
+/*@*/		return m_event = etEND_TAG;
+		}
+
+		StringView attribute = readName();
+		if( attribute.isEmpty() )
+		{
+			addError( STRING("Unexpected character ") + c + " in tag " + m_name.toString() );
+			++m_cur;
+/*^*/		continue;
+		}
+
+		skipBlanks();
+		if( m_cur < m_end && *m_cur == '=' )
+		{
+			++m_cur;
+			skipBlanks();
+		}
+		else
+		{
+			addError( "Missing value for attribute " + attribute.toString() );
+		}
+
+		char delimiter = m_cur < m_end ? *m_cur : 0;
+		if( delimiter == '"' || delimiter == '\'' )
+		{
+			const char *value = ++m_cur;
+			m_cur = find( delimiter );
+			m_value = StringView( value, std::size_t(m_cur - value) );
+			if( m_cur < m_end )
+			{
+				++m_cur;
+			}
+		}
+		else
+		{
+			// accept unquoted values like HTML does
+			m_value = readName();
+		}
+
+		m_name = attribute;
+		return m_event = etATTRIBUTE;
+	}
+}
+
+PullParser::EventType PullParser::readStartTag()
+{
+	m_name = readName();
+	m_value = StringView();
+	m_inTag = true;
+	m_emptyElement = false;
+
+	return m_event = etSTART_TAG;
+}
+
+PullParser::EventType PullParser::readEndTag()
+{
+	++m_cur;	// the '/'
+	m_name = readName();
+	m_value = StringView();
+	m_emptyElement = false;
+
+	m_cur = find( '>' );
+	if( m_cur < m_end )
+	{
+		++m_cur;
+	}
+
+	return m_event = etEND_TAG;
+}
+
+PullParser::EventType PullParser::readSpecialTag()
+{
+	const char	*content;
+
+	m_name = StringView();
+	if( startsWith( m_cur, m_end, COMMENT_START, sizeof(COMMENT_START)-1 ) )
+	{
+		content = m_cur += sizeof(COMMENT_START)-1;
+		m_cur = find( COMMENT_END, sizeof(COMMENT_END)-1 );
+		m_value = StringView( content, std::size_t(m_cur - content) );
+		m_cur += m_cur < m_end ? sizeof(COMMENT_END)-1 : 0;
+		return m_event = etCOMMENT;
+	}
+	else if( startsWith( m_cur, m_end, CDATA_START, sizeof(CDATA_START)-1 ) )
+	{
+		content = m_cur += sizeof(CDATA_START)-1;
+		m_cur = find( CDATA_END, sizeof(CDATA_END)-1 );
+		m_value = StringView( content, std::size_t(m_cur - content) );
+		m_cur += m_cur < m_end ? sizeof(CDATA_END)-1 : 0;
+		return m_event = etCDATA;
+	}
+	else if( startsWith( m_cur, m_end, DOCTYPE_START, sizeof(DOCTYPE_START)-1 ) )
+	{
+		// the document type may contain an internal subset with tags
+		std::size_t	counter = 0;
+
+		content = m_cur += sizeof(DOCTYPE_START)-1;
+		for( ; m_cur < m_end; ++m_cur )
+		{
+			if( *m_cur == '>' )
+			{
+				if( !counter )
+				{
+					break;
+				}
+				--counter;
+			}
+			else if( *m_cur == '<' )
+			{
+				++counter;
+			}
+		}
+		m_value = StringView( content, std::size_t(m_cur - content) );
+		m_cur += m_cur < m_end ? 1 : 0;
+		return m_event = etDOCTYPE;
+	}
+
+	addError( "Unknown tag <" + StringView( m_cur, std::size_t(find( '>' ) - m_cur) ).toString() );
+	m_cur = find( '>' );
+	m_cur += m_cur < m_end ? 1 : 0;
+
+	return next();
+}
+
+PullParser::EventType PullParser::readProcessingInstruction()
+{
+	++m_cur;	// the '?'
+	m_name = readName();
+	m_emptyElement = false;
+
+	const char *content = m_cur;
+	m_cur = find( PI_END, sizeof(PI_END)-1 );
+	m_value = StringView( content, std::size_t(m_cur - content) );
+	m_cur += m_cur < m_end ? sizeof(PI_END)-1 : 0;
+
+	if( m_name == "xml" || m_name == "XML" )
+	{
+		processXMLdeclaration();
+/*@*/	return next();
+	}
+
+	return m_event = etPROCESSING_INSTRUCTION;
+}
+
+void PullParser::processXMLdeclaration()
+{
+	// the declaration has the same syntax as the attributes of a tag
+	PullParser	declaration( m_value.begin(), m_value.size() );
+
+	declaration.m_inTag = true;
+	while( declaration.next() == etATTRIBUTE )
+	{
+		if( declaration.m_name == "encoding" )
+		{
+			CI_STRING encoding = declaration.m_value.toString();
+			m_utf8 = encoding == UTF_8;
+		}
+	}
+}
+
+void PullParser::addError( const STRING &theError )
+{
+	TextPosition	position = getPosition();
+	STRING			newError = formatNumber( position.m_lineNo ) + '.' + formatNumber( position.m_column );
+
+	newError += ": ";
+	newError += theError;
+
+	m_errors += newError;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+bool StringView::isBlank() const
+{
+	for( const char *cp = begin(), *endText = end(); cp < endText; ++cp )
+	{
+		if( !isSpace( *cp ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+STRING StringView::toString() const
+{
+	STRING	result;
+
+	if( m_length )
+	{
+		// STRING( text, maxLen ) would copy the entire rest of the buffer
+		std::memcpy( result.setActSize( m_length ), m_text, m_length );
+		result.setCharSet( result.testCharSet() );
+	}
+
+	return result;
+}
+
+StringView StringView::stripBlanks() const
+{
+	const char	*first = begin();
+	const char	*last = end();
+
+	while( first < last && isSpace( *first ) )
+	{
+		++first;
+	}
+	while( first < last && isSpace( last[-1] ) )
+	{
+		--last;
+	}
+
+	return StringView( first, std::size_t(last - first) );
+}
+
+PullParser::EventType PullParser::next()
+{
+	if( m_inTag )
+	{
+/*@*/	return readAttribute();
+	}
+
+	m_emptyElement = false;
+	if( m_cur >= m_end )
+	{
+		m_name = m_value = StringView();
+/*@*/	return m_event = etEND_DOCUMENT;
+	}
+
+	if( *m_cur != '<' )
+	{
+		const char *text = m_cur;
+
+		m_cur = find( '<' );
+		m_name = StringView();
+		m_value = StringView( text, std::size_t(m_cur - text) );
+/*@*/	return m_event = etTEXT;
+	}
+
+	++m_cur;	// the '<'
+	if( m_cur >= m_end )
+	{
+		addError( "Unexpected end of file" );
+		m_name = m_value = StringView();
+/*@*/	return m_event = etEND_DOCUMENT;
+	}
+
+	switch( *m_cur )
+	{
+		case '/':
+			return readEndTag();
+		case '!':
+			return readSpecialTag();
+		case '?':
+			return readProcessingInstruction();
+		default:
+			return readStartTag();
+	}
+}
+
+STRING PullParser::decodeValue() const
+{
+	if( m_event == etTEXT || m_event == etATTRIBUTE )
+	{
+/*@*/	return decode( m_value );
+	}
+
+	return fixCharset( m_value.toString() );
+}
+
+STRING PullParser::decode( const StringView &text ) const
+{
+	if( !text.hasEntities() )
+	{
+/*@*/	return fixCharset( text.toString() );
+	}
+
+	const STR_CHARSET	cs = fixCharset( text.toString() ).getCharSet();
+	ArrayOfData			decoded;
+
+	for( const char *cp = text.begin(), *endText = text.end(); cp < endText; )
+	{
+		const char	*amp = static_cast<const char *>(
+			std::memchr( cp, '&', std::size_t(endText - cp) )
+		);
+		if( !amp )
+		{
+			amp = endText;
+		}
+		decoded.addElements( cp, std::size_t(amp - cp) );
+		if( amp == endText )
+		{
+			break;
+		}
+
+		const char	*semicolon = amp+1;
+		while( semicolon < endText && *semicolon != ';' && !isSpace( *semicolon ) )
+		{
+			++semicolon;
+		}
+		if( semicolon < endText && *semicolon == ';' )
+		{
+			++semicolon;
+
+			STRING	entityChar;
+			entityChar.setCharSet( cs );
+			entityChar += amp[1] == '#'
+				? char( amp[2] == 'x' || amp[2] == 'X'
+					? std::strtoul( amp+3, nullptr, 16 )
+					: std::strtoul( amp+2, nullptr, 10 ) )
+				: PCData::xml2ASCII( StringView( amp, std::size_t(semicolon - amp) ).toString() );
+			decoded.addElements( entityChar, entityChar.strlen() );
+		}
+		else
+		{
+			// not an entity => keep the text
+			decoded.addElements( amp, std::size_t(semicolon - amp) );
+		}
+		cp = semicolon;
+	}
+
+	STRING	value = StringView( decoded.getDataBuffer(), decoded.size() ).toString();
+	if( cs != STR_ASCII )
+	{
+		value.setCharSet( cs );
+	}
+	return value;
+}
+
+TextPosition PullParser::getPosition() const
+{
+	TextPosition	position = m_position;
+	const char		*lineStart = m_start;
+
+	for( const char *cp = m_start; cp < m_cur; ++cp )
+	{
+		cp = static_cast<const char *>(
+			std::memchr( cp, '\n', std::size_t(m_cur - cp) )
+		);
+		if( !cp )
+		{
+			break;
+		}
+		++position.m_lineNo;
+		lineStart = cp+1;
+	}
+	position.m_column = std::size_t(m_cur - lineStart);
+
+	return position;
+}
+
+STRING PullParser::getErrors() const
+{
+	STRING	theErrors;
+	STRING	fileName = m_position.m_fileName;
+
+	if( !fileName.isEmpty() )
+	{
+		fileName += ' ';
+	}
+
+	for( ArrayOfStrings::const_iterator it = m_errors.cbegin(), endIT = m_errors.cend(); it != endIT; ++it )
+	{
+		theErrors += fileName + *it + '\n';
+	}
+	return theErrors;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
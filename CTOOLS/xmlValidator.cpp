@@ -88,6 +88,13 @@ namespace xml
 
 static Array<Validator*>	dummy;
 
+// the model groups are compared with the interned local names of the schema
+static const Atom SCHEMA_ELEMENT( "element" );
+static const Atom SCHEMA_GROUP( "group" );
+static const Atom SCHEMA_CHOICE( "choice" );
+static const Atom SCHEMA_SEQUENCE( "sequence" );
+static const Atom SCHEMA_ALL( "all" );
+
 // --------------------------------------------------------------------- //
 // ----- class static data --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -659,7 +666,8 @@ bool Validator::testSequence(
 	doEnterFunction( "Validator::testSequence" );
 
 	Element		*child;
-	STRING			modelElementTag, allowedTag, childTag, value, tmp;
+	Atom			modelElementTag;
+	STRING			allowedTag, childTag, value, tmp;
 	size_t			i, count, min, max,
 					curIndex = begIndex,
 					numChildren=children.size();
@@ -668,9 +676,7 @@ bool Validator::testSequence(
 	for( i=0; i<sequence->getNumObjects(); i++ )
 	{
 		Element *theSchemaElement = sequence->getElement(i);
-		modelElementTag = Element::getLocalName(
-			theSchemaElement->getTag()
-		);
+		modelElementTag = theSchemaElement->getLocalNameAtom();
 
 		tmp = theSchemaElement->getAttribute( "minOccurs" );
 		if( tmp.isEmpty() )
@@ -684,7 +690,7 @@ bool Validator::testSequence(
 			max = tmp.getValueE<size_t>();
 		count = 0;
 
-		if( modelElementTag == "element" )
+		if( modelElementTag == SCHEMA_ELEMENT )
 		{
 			allowedTag = theSchemaElement->getAttribute( "name" );
 			for( ; curIndex<numChildren; curIndex++ )
@@ -706,7 +712,7 @@ bool Validator::testSequence(
 /*v*/				break;
 			}
 		}
-		else if( modelElementTag == "group" )
+		else if( modelElementTag == SCHEMA_GROUP )
 		{
 			while( curIndex<numChildren
 			&& testGroup(
@@ -715,7 +721,7 @@ bool Validator::testSequence(
 			) )
 				count++;
 		}
-		else if( modelElementTag == "choice" )
+		else if( modelElementTag == SCHEMA_CHOICE )
 		{
 			while( curIndex<numChildren
 			&& testChoice(
@@ -724,7 +730,7 @@ bool Validator::testSequence(
 			) )
 				count++;
 		}
-		else if( modelElementTag == "sequence" )
+		else if( modelElementTag == SCHEMA_SEQUENCE )
 		{
 			while( curIndex<numChildren
 			&& testSequence(
@@ -794,7 +800,8 @@ bool Validator::testChoice(
 
 	bool			found = false;
 	Element		*child = NULL;
-	STRING			modelElementTag, allowedTag, childTag, value, tmp;
+	Atom			modelElementTag;
+	STRING			allowedTag, childTag, value, tmp;
 	size_t			i,
 					curIndex = begIndex,
 					numChildren = children.size();
@@ -828,10 +835,8 @@ bool Validator::testChoice(
 		for( i=0; !found && i<choice->getNumObjects(); i++ )
 		{
 			Element *theSchemaElement = choice->getElement(i);
-			modelElementTag = Element::getLocalName(
-				theSchemaElement->getTag()
-			);
-			if( modelElementTag == "element" )
+			modelElementTag = theSchemaElement->getLocalNameAtom();
+			if( modelElementTag == SCHEMA_ELEMENT )
 			{
 				allowedTag = theSchemaElement->getAttribute( "name" );
 
@@ -853,24 +858,22 @@ bool Validator::testChoice(
 		for( i=0; !found && i<choice->getNumObjects(); i++ )
 		{
 			Element *theSchemaElement = choice->getElement(i);
-			modelElementTag = Element::getLocalName(
-				theSchemaElement->getTag()
-			);
-			if( modelElementTag == "group" )
+			modelElementTag = theSchemaElement->getLocalNameAtom();
+			if( modelElementTag == SCHEMA_GROUP )
 			{
 				found = testGroup(
 					docElement, children,
 					curIndex, theSchemaElement, mixed, endIndex
 				);
 			}
-			else if( modelElementTag == "sequence" )
+			else if( modelElementTag == SCHEMA_SEQUENCE )
 			{
 				found = testSequence(
 					docElement, children,
 					curIndex, theSchemaElement, mixed, endIndex
 				);
 			}
-			else if( modelElementTag == "choice" )
+			else if( modelElementTag == SCHEMA_CHOICE )
 			{
 				found = testChoice(
 					docElement, children,
@@ -1116,12 +1119,10 @@ bool Validator::testXML( Element *docElement )
 			{
 				size_t		curIndex = 0;
 
-				STRING		modelType = Element::getLocalName(
-					theModel->getTag()
-				);
+				Atom		modelType = theModel->getLocalNameAtom();
 
 
-				if( modelType == "sequence" )
+				if( modelType == SCHEMA_SEQUENCE )
 				{
 					if( !testSequence(
 						docElement, children, 0, theModel, mixed, &curIndex
@@ -1130,7 +1131,7 @@ bool Validator::testXML( Element *docElement )
 /*@*/					return false;
 					}
 				}
-				else if( modelType == "choice" )
+				else if( modelType == SCHEMA_CHOICE )
 				{
 					if( !testChoice(
 						docElement, children, 0, theModel, mixed, &curIndex
@@ -1139,7 +1140,7 @@ bool Validator::testXML( Element *docElement )
 /*@*/					return false;
 					}
 				}
-				else if( modelType == "all" )
+				else if( modelType == SCHEMA_ALL )
 				{
 					if( !testAll(
 						docElement, children, 0, theModel, mixed, &curIndex
@@ -1148,7 +1149,7 @@ bool Validator::testXML( Element *docElement )
 /*@*/					return false;
 					}
 				}
-				else if( modelType == "group" )
+				else if( modelType == SCHEMA_GROUP )
 				{
 					if( !testGroup(
 						docElement, children, 0, theModel, mixed, &curIndex
@@ -96,6 +96,16 @@ extern const char XSL_PUBLIC[]	= "doctype-public";
 // ----- module static data -------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+// the instructions are compared with the interned local names of the template
+static const Atom XSL_VALUE_OF( "value-of" );
+static const Atom XSL_ATTRIBUTE( "attribute" );
+static const Atom XSL_TEXT( "text" );
+static const Atom XSL_IF( "if" );
+static const Atom XSL_APPLY_TEMPLATES( "apply-templates" );
+static const Atom XSL_COPY_OF( "copy-of" );
+static const Atom XSL_FOR_EACH( "for-each" );
+static const Atom XSL_PROCESSING_INSTRUCTION( "processing-instruction" );
+
 // --------------------------------------------------------------------- //
 // ----- class static data --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -184,9 +194,10 @@ void Transformator::applyTemplates(
 	doEnterFunction("Transformator::applyTemplates");
 
 	Element	*sourceChild, *minTemplate, *theTemplate;
-	XmlArray	sourceChildren, templateMatch;
+	XmlArray	sourceChildren;
 	STRING		match, tmplMode;
-	size_t		minCount;
+	size_t		minCount, matchCount;
+	bool		found;
 
 	if( !allTemplates.size() )
 	{
@@ -212,13 +223,14 @@ void Transformator::applyTemplates(
 			tmplMode = theTemplate->getAttribute( "mode" );
 			if( !match.isEmpty() && mode == tmplMode )
 			{
-				templateMatch.clear();
-				source->locateElements( match, &templateMatch, false );
-				if( templateMatch.findElement( sourceChild ) != templateMatch.no_index )
+				// we need the number of matches, only, not the elements
+				matchCount = XPathExpression::compileSelect( match )
+					->getLocation().count( source, sourceChild, &found, false );
+				if( found )
 				{
-					if( templateMatch.size() < minCount )
+					if( matchCount < minCount )
 					{
-						minCount = templateMatch.size();
+						minCount = matchCount;
 						minTemplate = theTemplate;
 					}
 				}
@@ -264,8 +276,8 @@ void Transformator::transform(
 	for( size_t	i=0; i<theTemplate->getNumObjects(); i++ )
 	{
 		Element	*tmplElement = theTemplate->getElement( i );
-		STRING		tmplTag = tmplElement->getLocalName();
-		if( tmplTag.isEmpty() )
+		Atom		tmplTag = tmplElement->getLocalNameAtom();
+		if( tmplTag.isNull() )
 		{
 			if( target )
 				target->addObject(
@@ -276,7 +288,7 @@ void Transformator::transform(
 		}
 		else if( tmplElement->getPrefix() == xsltRoot->getPrefix() )
 		{
-			if( tmplTag == "value-of" )
+			if( tmplTag == XSL_VALUE_OF )
 			{
 				if( target )
 				{
@@ -292,7 +304,7 @@ void Transformator::transform(
 				}
 				// otherwise ignore
 			}
-			else if( tmplTag == "attribute" )
+			else if( tmplTag == XSL_ATTRIBUTE )
 			{
 				if( target )
 				{
@@ -310,7 +322,7 @@ void Transformator::transform(
 				}
 				// otherwise ignore
 			}
-			else if( tmplTag == "text" )
+			else if( tmplTag == XSL_TEXT )
 			{
 				if( target )
 				{
@@ -323,7 +335,7 @@ void Transformator::transform(
 				}
 				// otherwise ignore
 			}
-			else if( tmplTag == "if" )
+			else if( tmplTag == XSL_IF )
 			{
 				STRING	test = tmplElement->getAttribute( "test" );
 				STRING	result = evaluate( test, source );
@@ -333,7 +345,7 @@ void Transformator::transform(
 				}
 
 			}
-			else if( tmplTag == "apply-templates" )
+			else if( tmplTag == XSL_APPLY_TEMPLATES )
 			{
 				STRING	select = tmplElement->getAttribute( "select" );
 				STRING	mode = tmplElement->getAttribute( "mode" );
@@ -341,17 +353,17 @@ void Transformator::transform(
 					select = "*";
 				applyTemplates( select, mode, source->current(), target );
 			}
-			else if( tmplTag == "copy-of" )
+			else if( tmplTag == XSL_COPY_OF )
 			{
 				STRING	select = tmplElement->getAttribute( "select" );
 				copyOf( source->current(), select, target );
 			}
-			else if( tmplTag == "for-each" )
+			else if( tmplTag == XSL_FOR_EACH )
 			{
 				STRING	select = tmplElement->getAttribute( "select" );
 				forEach( tmplElement, select, source->current(), target );
 			}
-			else if( tmplTag == "processing-instruction" )
+			else if( tmplTag == XSL_PROCESSING_INSTRUCTION )
 			{
 				if( !theFactory )
 				{
@@ -394,7 +406,8 @@ void Transformator::transform(
 		{
 			if( !theFactory )
 			{
-				if( tmplTag == "html" || tmplTag == "HTML" )
+				const STRING &tmplName = tmplTag.getName();
+				if( tmplName == "html" || tmplName == "HTML" )
 				{
 					this->method = XO_HTML;
 					theFactory = new html::Factory;
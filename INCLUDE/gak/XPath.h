@@ -41,6 +41,8 @@
 // --------------------------------------------------------------------- //
 
 #include <gak/string.h>
+#include <gak/array.h>
+#include <gak/shared.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -64,6 +66,9 @@ namespace xml
 // ----- constants ----------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// max. number of compiled expressions kept by each cache of XPathExpression
+const std::size_t XPATH_CACHE_SIZE = 256;
+
 // --------------------------------------------------------------------- //
 // ----- macros -------------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -78,6 +83,13 @@ enum xsltOperator
 	XSLT_PLUS, XSLT_MINUS, XSLT_MULTIPLY, XSLT_DIVISION,
 };
 
+enum xpathAxis
+{
+	XPATH_CHILD, XPATH_DESCENDANT, XPATH_FOLLOWING, XPATH_FOLLOWING_SIBLING,
+	XPATH_PRECEDING, XPATH_PRECEDING_SIBLING, XPATH_SELF, XPATH_PARENT,
+	XPATH_UNKNOWN_AXIS
+};
+
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -90,6 +102,181 @@ class XmlArray;
 #	pragma option -RT-
 #endif
 
+class XPathExpression;
+typedef SharedObjectPointer<XPathExpression>	XPathExpressionPtr;
+
+/**
+	@brief a location path split into its steps
+
+	The path is parsed with the same rules as Element::locateElements used
+	before. Predicates are compiled to XPathExpression objects, positions
+	([1]) are converted to numbers.
+
+	The steps are processed depth first. Each element found by a step is
+	passed to the next step immediately. Only steps with a predicate that
+	is no position collect their elements in an XmlArray since position()
+	and last() need the entire node set.
+*/
+class XPathLocation
+{
+	public:
+	enum StepType
+	{
+		stROOT,			///< go to the root of the document (/)
+		stPARENT,		///< go to the parent (../)
+		stSELF,			///< the context element itself (. or \@attribute)
+		stAXIS			///< search an axis for a tag
+	};
+	struct Predicate
+	{
+		/// the position to select (starting with 1) or 0
+		std::size_t			position;
+		/// the expression to test if position is 0
+		XPathExpressionPtr	expression;
+	};
+	struct Step
+	{
+		StepType			type;
+		xpathAxis			axis;
+		STRING				baseTag;
+		Array<Predicate>	predicates;
+	};
+
+	private:
+	Array<Step>		m_steps;
+	STRING			m_attribute;
+
+	template <class SinkT>
+	struct StepSink;
+
+	template <class SinkT>
+	void locate(
+		std::size_t stepIdx, Element *context, bool inclPcData, SinkT &sink
+	) const;
+
+	public:
+	/// splits a path into its steps
+	void compile( const STRING &path );
+
+	/// returns the attribute name selected by the last step (@attribute) or an empty string
+	const STRING &getAttribute() const
+	{
+		return m_attribute;
+	}
+	/// returns the steps of the path
+	const Array<Step> &getSteps() const
+	{
+		return m_steps;
+	}
+
+	/**
+		@brief searches all elements matching the path
+		@param [in] context the element to start with
+		@param [out] result receives the elements found
+		@param [in] inclPcData true if text elements should be found, too
+		@return the attribute name selected by the path
+	*/
+	const STRING &locate(
+		Element *context, XmlArray *result, bool inclPcData
+	) const;
+	/**
+		@brief concatenates the values of all elements matching the path
+
+		If the path selects an attribute, the attribute values are
+		concatenated. No node set is built.
+	*/
+	STRING valueOf( Element *context ) const;
+	/**
+		@brief counts the elements matching the path
+		@param [in] context the element to start with
+		@param [in] candidate an element to search for
+		@param [out] found receives true if candidate was found
+		@param [in] inclPcData true if text elements should be counted, too
+		@return the number of elements found
+	*/
+	std::size_t count(
+		Element *context, const Element *candidate, bool *found,
+		bool inclPcData
+	) const;
+};
+
+/**
+	@brief an XPath expression compiled into a tree
+
+	The expression text is parsed once with the same rules as the function
+	evaluate. The tree contains operators with their two operands, constant
+	values, the functions position() and last() and location paths.
+
+	Use @ref compile for expressions like the test of xsl:if and
+	@ref compileSelect for the select of xsl:value-of. Both functions keep
+	the last XPATH_CACHE_SIZE compiled expressions in a least recently used
+	cache, thus the text of an expression is parsed only once even if the
+	same template is applied to many elements.
+
+	A compiled expression is never changed. Thus it can be shared by
+	multiple threads.
+*/
+class XPathExpression : public SharedObject
+{
+	public:
+	enum ExpressionType
+	{
+		etOPERATOR,		///< an operator with left and right operand
+		etCONSTANT,		///< a string literal or a number
+		etPOSITION,		///< position()
+		etLAST,			///< last()
+		etLOCATION		///< a location path
+	};
+
+	private:
+	ExpressionType		m_type;
+	xsltOperator		m_operator;
+	XPathExpressionPtr	m_left, m_right;
+	STRING				m_constant;
+	XPathLocation		m_location;
+
+	// no copy
+	XPathExpression( const XPathExpression & );
+	const XPathExpression & operator = ( const XPathExpression & );
+
+	public:
+	XPathExpression() : m_type( etCONSTANT ), m_operator( NO_OP )
+	{
+	}
+
+	/// parses an expression without using the cache
+	void parseExpression( const STRING &expression );
+	/// parses a select of xsl:value-of without using the cache
+	void parseSelect( const STRING &select );
+
+	/// returns a compiled expression for the text from the cache
+	static XPathExpressionPtr compile( const STRING &expression );
+	/// returns a compiled select for the text from the cache
+	static XPathExpressionPtr compileSelect( const STRING &select );
+	/// removes all compiled expressions from both caches
+	static void clearCache();
+
+	ExpressionType getType() const
+	{
+		return m_type;
+	}
+	xsltOperator getOperator() const
+	{
+		return m_operator;
+	}
+	const XPathLocation &getLocation() const
+	{
+		return m_location;
+	}
+
+	/**
+		@brief evaluates the expression
+		@param [in] source the node set with the current context element
+		@return the result, boolean results are "1" or "0"
+	*/
+	STRING evaluate( XmlArray *source ) const;
+};
+
 // --------------------------------------------------------------------- //
 // ----- exported datas ------------------------------------------------ //
 // --------------------------------------------------------------------- //
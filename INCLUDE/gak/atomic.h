@@ -0,0 +1,610 @@
+/*
+		Project:		GAKLIB
+		Module:			atomic.h
+		Description:	lock free integral values and parking of waiting threads
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_ATOMIC_H
+#define GAK_ATOMIC_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#if defined( __linux__ )
+#	define GAK_USE_FUTEX	1
+#else
+#	define GAK_USE_FUTEX	0
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <limits.h>
+
+#include <gak/types.h>
+
+#if defined( _Windows )
+#	include <gak/win_tools.h>
+#elif defined( __MACH__ ) || defined( __unix__ )
+#	include <errno.h>
+#	include <pthread.h>
+#	include <sys/time.h>
+#	if GAK_USE_FUTEX
+#		include <unistd.h>
+#		include <sys/syscall.h>
+#		include <linux/futex.h>
+#	endif
+#else
+#	error "Unknown operating system"
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the memory ordering of an atomic operation, ignored on Windows where all operations are full barriers
+enum MemoryOrder
+{
+#if defined( _Windows )
+	moRelaxed, moAcquire, moRelease, moAcqRel, moSeqCst
+#else
+	moRelaxed = __ATOMIC_RELAXED,
+	moAcquire = __ATOMIC_ACQUIRE,
+	moRelease = __ATOMIC_RELEASE,
+	moAcqRel = __ATOMIC_ACQ_REL,
+	moSeqCst = __ATOMIC_SEQ_CST
+#endif
+};
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief reads a value that may be changed by other threads
+	@param [in] value the address of the value with 4 or 8 bytes
+	@param [in] order the memory ordering
+	@return the current value
+*/
+template <typename T>
+inline T atomicLoad( const volatile T *value, MemoryOrder order=moAcquire )
+{
+#if defined( _Windows )
+	volatile T *ptr = const_cast<volatile T *>(value);
+	if( sizeof(T) == sizeof(LONG) )
+	{
+		return T(InterlockedCompareExchange( reinterpret_cast<volatile LONG *>(ptr), 0, 0 ));
+	}
+	return T(InterlockedCompareExchange64( reinterpret_cast<volatile LONGLONG *>(ptr), 0, 0 ));
+#else
+	return __atomic_load_n( value, order );
+#endif
+}
+
+/**
+	@brief changes a value that may be read by other threads
+	@param [in] value the address of the value with 4 or 8 bytes
+	@param [in] newValue the value to store
+	@param [in] order the memory ordering
+*/
+template <typename T>
+inline void atomicStore( volatile T *value, T newValue, MemoryOrder order=moRelease )
+{
+#if defined( _Windows )
+	if( sizeof(T) == sizeof(LONG) )
+	{
+		InterlockedExchange( reinterpret_cast<volatile LONG *>(value), LONG(newValue) );
+	}
+	else
+	{
+		InterlockedExchange64( reinterpret_cast<volatile LONGLONG *>(value), LONGLONG(newValue) );
+	}
+#else
+	__atomic_store_n( value, newValue, order );
+#endif
+}
+
+/**
+	@brief adds to a value that may be changed by other threads
+	@param [in] value the address of the value with 4 or 8 bytes
+	@param [in] add the value to add
+	@param [in] order the memory ordering
+	@return the previous value
+*/
+template <typename T>
+inline T atomicFetchAdd( volatile T *value, T add, MemoryOrder order=moSeqCst )
+{
+#if defined( _Windows )
+	if( sizeof(T) == sizeof(LONG) )
+	{
+		return T(InterlockedExchangeAdd( reinterpret_cast<volatile LONG *>(value), LONG(add) ));
+	}
+	return T(InterlockedExchangeAdd64( reinterpret_cast<volatile LONGLONG *>(value), LONGLONG(add) ));
+#else
+	return __atomic_fetch_add( value, add, order );
+#endif
+}
+
+/**
+	@brief an integral value that can be accessed by multiple threads without lock
+
+	By default load has acquire semantic, store has release semantic and all
+	read-modify-write operations are sequentially consistent.
+
+	@tparam T an integral type with 4 or 8 bytes
+*/
+template <typename T>
+class Atomic
+{
+	volatile T	m_value;
+
+	// no copy
+	Atomic( const Atomic & );
+	const Atomic & operator = ( const Atomic & );
+
+	public:
+	/// creates a new value
+	Atomic( T value=T() ) : m_value( value ) {}
+
+	/// returns the current value
+	T load( MemoryOrder order=moAcquire ) const
+	{
+		return atomicLoad( &m_value, order );
+	}
+	/// changes the value
+	void store( T value, MemoryOrder order=moRelease )
+	{
+		atomicStore( &m_value, value, order );
+	}
+	/// changes the value and returns the previous one
+	T exchange( T value )
+	{
+#if defined( _Windows )
+		if( sizeof(T) == sizeof(LONG) )
+		{
+			return T(InterlockedExchange( reinterpret_cast<volatile LONG *>(&m_value), LONG(value) ));
+		}
+		return T(InterlockedExchange64( reinterpret_cast<volatile LONGLONG *>(&m_value), LONGLONG(value) ));
+#else
+		return __atomic_exchange_n( &m_value, value, __ATOMIC_SEQ_CST );
+#endif
+	}
+	/// adds a value and returns the previous one
+	T fetchAdd( T value, MemoryOrder order=moSeqCst )
+	{
+		return atomicFetchAdd( &m_value, value, order );
+	}
+	/// subtracts a value and returns the previous one
+	T fetchSub( T value, MemoryOrder order=moSeqCst )
+	{
+		return fetchAdd( T(0) - value, order );
+	}
+	/// increments the value and returns the new one
+	T operator ++ ()
+	{
+		return fetchAdd( T(1) ) + T(1);
+	}
+	/// decrements the value and returns the new one
+	T operator -- ()
+	{
+		return fetchSub( T(1) ) - T(1);
+	}
+	/**
+		@brief changes the value, if it is equal to an expected value
+		@param [in,out] expected the expected value, on failure it receives the current value
+		@param [in] desired the new value
+		@return true if the value was changed
+	*/
+	bool compareExchange( T &expected, T desired )
+	{
+#if defined( _Windows )
+		T	current = compareExchangeValue( &m_value, desired, expected );
+		if( current == expected )
+		{
+			return true;
+		}
+		expected = current;
+		return false;
+#else
+		return __atomic_compare_exchange_n( &m_value, &expected, desired, false, __ATOMIC_SEQ_CST, __ATOMIC_ACQUIRE );
+#endif
+	}
+
+	/// returns the current value
+	operator T () const
+	{
+		return load();
+	}
+
+	/// a full memory barrier
+	static void fence()
+	{
+#if defined( _Windows )
+		MemoryBarrier();
+#else
+		__atomic_thread_fence( __ATOMIC_SEQ_CST );
+#endif
+	}
+
+#if defined( _Windows )
+	private:
+	static T compareExchangeValue( volatile T *value, T desired, T expected )
+	{
+		if( sizeof(T) == sizeof(LONG) )
+		{
+			return T(InterlockedCompareExchange( reinterpret_cast<volatile LONG *>(value), LONG(desired), LONG(expected) ));
+		}
+		return T(InterlockedCompareExchange64( reinterpret_cast<volatile LONGLONG *>(value), LONGLONG(desired), LONGLONG(expected) ));
+	}
+#endif
+};
+
+/**
+	@brief parks threads waiting for a condition that is changed by lock free code
+
+	A waiting thread calls @ref prepareWait, checks its condition once more and 
+	calls either @ref cancelWait or @ref wait. A thread changing the condition
+	calls @ref notify, which does not enter the OS if there is no waiting thread.
+	On Linux the waiting threads are parked with a futex.
+
+	@code
+		while( !tryPop( &item ) )
+		{
+			uint32 key = eventCount.prepareWait();
+			if( tryPop( &item ) )
+			{
+				eventCount.cancelWait();
+				break;
+			}
+			eventCount.wait( key );
+		}
+	@endcode
+*/
+class EventCount
+{
+	Atomic<uint32>		m_epoch;
+	Atomic<uint32>		m_waiters;
+#if GAK_USE_FUTEX
+#elif defined( _Windows )
+	CRITICAL_SECTION	m_cs;
+	CONDITION_VARIABLE	m_conditional;
+#else
+	pthread_mutex_t		m_mutex;
+	pthread_cond_t		m_conditional;
+#endif
+
+	// no copy
+	EventCount( const EventCount & );
+	const EventCount & operator = ( const EventCount & );
+
+	bool park( uint32 key, unsigned long timeOut );
+	void wake( bool all );
+
+	public:
+	/// constant value to specify to wait forever
+	static const unsigned long WAIT_FOREVER = static_cast<unsigned long>(-1);
+
+	EventCount();
+	~EventCount();
+
+	/// registers the current thread as a waiting thread, returns the key for @ref wait
+	uint32 prepareWait()
+	{
+		++m_waiters;
+		return m_epoch.load();
+	}
+	/// unregisters the current thread
+	void cancelWait()
+	{
+		--m_waiters;
+	}
+	/**
+		@brief waits for a notification and unregisters the current thread
+		@param [in] key the value returned by @ref prepareWait
+		@param [in] timeOut the max time in ms to wait
+		@return false on timeout
+	*/
+	bool wait( uint32 key, unsigned long timeOut=WAIT_FOREVER )
+	{
+		bool result = park( key, timeOut );
+		--m_waiters;
+		return result;
+	}
+	/**
+		@brief wakes up waiting threads
+		@param [in] all wake up all threads or one thread, only
+	*/
+	void notify( bool all=false )
+	{
+		Atomic<uint32>::fence();
+		if( m_waiters.load() )
+		{
+			wake( all );
+		}
+	}
+	/// returns the number of registered threads
+	uint32 getWaiters() const
+	{
+		return m_waiters.load();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// tells the processor that the current thread is spinning
+inline void cpuRelax()
+{
+#if defined( _Windows )
+	YieldProcessor();
+#elif defined( __GNUC__ ) && ( defined( __i386__ ) || defined( __x86_64__ ) )
+	__builtin_ia32_pause();
+#elif defined( __GNUC__ ) && defined( __aarch64__ )
+	__asm__ __volatile__( "yield" );
+#endif
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+#if GAK_USE_FUTEX
+inline EventCount::EventCount()
+{
+}
+
+inline EventCount::~EventCount()
+{
+}
+#elif defined( _Windows )
+inline EventCount::EventCount()
+{
+	InitializeCriticalSection( &m_cs );
+	InitializeConditionVariable( &m_conditional );
+}
+
+inline EventCount::~EventCount()
+{
+	DeleteCriticalSection( &m_cs );
+}
+#else
+inline EventCount::EventCount()
+{
+	pthread_mutex_init( &m_mutex, NULL );
+	pthread_cond_init( &m_conditional, NULL );
+}
+
+inline EventCount::~EventCount()
+{
+	pthread_cond_destroy( &m_conditional );
+	pthread_mutex_destroy( &m_mutex );
+}
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#if GAK_USE_FUTEX
+inline bool EventCount::park( uint32 key, unsigned long timeOut )
+{
+	struct timespec	timeout, *timeoutPtr = NULL;
+
+	if( timeOut != WAIT_FOREVER )
+	{
+		timeout.tv_sec = timeOut / 1000;
+		timeout.tv_nsec = (timeOut % 1000) * 1000000L;
+		timeoutPtr = &timeout;
+	}
+	while( m_epoch.load() == key )
+	{
+		if( syscall(
+			SYS_futex, reinterpret_cast<volatile uint32 *>(&m_epoch), FUTEX_WAIT_PRIVATE, key, timeoutPtr, NULL, 0
+		) && errno == ETIMEDOUT )
+		{
+			return m_epoch.load() != key;
+		}
+	}
+	return true;
+}
+
+inline void EventCount::wake( bool all )
+{
+	++m_epoch;
+	syscall(
+		SYS_futex, reinterpret_cast<volatile uint32 *>(&m_epoch), FUTEX_WAKE_PRIVATE, all ? INT_MAX : 1, NULL, NULL, 0
+	);
+}
+#elif defined( _Windows )
+inline bool EventCount::park( uint32 key, unsigned long timeOut )
+{
+	bool	result = true;
+
+	EnterCriticalSection( &m_cs );
+	while( m_epoch.load() == key )
+	{
+		if( !SleepConditionVariableCS( &m_conditional, &m_cs, timeOut ) )
+		{
+			result = m_epoch.load() != key;
+			break;
+		}
+	}
+	LeaveCriticalSection( &m_cs );
+
+	return result;
+}
+
+inline void EventCount::wake( bool all )
+{
+	EnterCriticalSection( &m_cs );
+	++m_epoch;
+	LeaveCriticalSection( &m_cs );
+	if( all )
+	{
+		WakeAllConditionVariable( &m_conditional );
+	}
+	else
+	{
+		WakeConditionVariable( &m_conditional );
+	}
+}
+#else
+inline bool EventCount::park( uint32 key, unsigned long timeOut )
+{
+	bool	result = true;
+
+	pthread_mutex_lock( &m_mutex );
+	if( timeOut == WAIT_FOREVER )
+	{
+		while( m_epoch.load() == key )
+		{
+			pthread_cond_wait( &m_conditional, &m_mutex );
+		}
+	}
+	else
+	{
+		struct timespec	absTime;
+		struct timeval	now;
+
+		gettimeofday( &now, NULL );
+		absTime.tv_sec = now.tv_sec + timeOut / 1000;
+		absTime.tv_nsec = (now.tv_usec + 1000UL*(timeOut % 1000UL)) * 1000UL;
+		if( absTime.tv_nsec >= 1000000000L )
+		{
+			absTime.tv_sec++;
+			absTime.tv_nsec -= 1000000000L;
+		}
+		while( m_epoch.load() == key )
+		{
+			if( pthread_cond_timedwait( &m_conditional, &m_mutex, &absTime ) == ETIMEDOUT )
+			{
+				result = m_epoch.load() != key;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock( &m_mutex );
+
+	return result;
+}
+
+inline void EventCount::wake( bool all )
+{
+	pthread_mutex_lock( &m_mutex );
+	++m_epoch;
+	if( all )
+	{
+		pthread_cond_broadcast( &m_conditional );
+	}
+	else
+	{
+		pthread_cond_signal( &m_conditional );
+	}
+	pthread_mutex_unlock( &m_mutex );
+}
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_ATOMIC_H
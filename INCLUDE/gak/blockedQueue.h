@@ -85,14 +85,44 @@ namespace gak
 	this Queue is waiting for an item, if you try to @ref pop the next item
 	and the Queue is empty
 
+	If the container needs no lock (see QueueLocking), e.g. a MpmcQueue,
+	push and pop are forwarded to the container and neither the Locker nor
+	the Conditional of this Queue are used. Such a container is bounded,
+	thus push waits while it is full.
+
 	@tparam OBJ the item types that is stored in this Queue
+	@tparam QueueT the container type that behaves as a queue
+	@see MpmcQueue
 */
-template <typename OBJ>
-class BlockedQueue : private LockQueue<OBJ>
+template <typename OBJ, typename QueueT=Queue<OBJ> >
+class BlockedQueue : private LockQueue<OBJ, QueueT>
 {
+	typedef LockQueue<OBJ, QueueT>	Super;
+
+	/// selects the implementation for containers with or without a lock
+	template <bool NEEDS_LOCK>
+	struct Locking
+	{
+	};
+	typedef Locking<QueueLocking<QueueT>::needsLock>	QueueLockingT;
+
 	Conditional	m_conditional;
 	Locker		m_lock;
 
+	void notify( Locking<true> )
+	{
+		m_conditional.notify();
+	}
+	void notify( Locking<false> )
+	{
+		// the container wakes up its consumers
+	}
+	OBJ waitPop( unsigned long timeout, Locking<true> );
+	OBJ waitPop( unsigned long timeout, Locking<false> )
+	{
+		return this->getQueue().waitPop( timeout );
+	}
+
 	public:
 	/**
 		@brief adds a new item to the Queue
@@ -100,8 +130,19 @@ class BlockedQueue : private LockQueue<OBJ>
 	*/
 	void push( const OBJ &item )
 	{
-		LockQueue<OBJ>::push( item );
-		m_conditional.notify();
+		Super::push( item );
+		notify( QueueLockingT() );
+	}
+	/**
+		@brief adds a number of items to the Queue locking it only once
+		@param [in] first iterator to the first item to add
+		@param [in] last iterator behind the last item to add
+	*/
+	template <typename IteratorT>
+	void pushBatch( IteratorT first, IteratorT last )
+	{
+		Super::pushBatch( first, last );
+		notify( QueueLockingT() );
 	}
 	/**
 		@brief fetches the oldest item from the Queue waiting if it is empty
@@ -109,7 +150,10 @@ class BlockedQueue : private LockQueue<OBJ>
 		@return the next item in the Queue
 		@throws TimeoutException if exclusive access was not granted withing timeout milliseconds
 	*/
-	OBJ pop( unsigned long timeout=Locker::WAIT_FOREVER );
+	OBJ pop( unsigned long timeout=Locker::WAIT_FOREVER )
+	{
+		return waitPop( timeout, QueueLockingT() );
+	}
 	/**
 		@brief deletes all items in this Queue
 		@param [in] timeout max. time in milliseconds to wait for an exclusive access
@@ -117,10 +161,16 @@ class BlockedQueue : private LockQueue<OBJ>
 	*/
 	void clear( unsigned long timeout=Locker::WAIT_FOREVER )
 	{
+		if( !QueueLocking<QueueT>::needsLock )
+		{
+			Super::clear();
+			return;
+		}
+
 		LockGuard	lock( m_lock, timeout );
 		if( lock )
 		{
-			LockQueue<OBJ>::clear();
+			Super::clear();
 		}
 		else
 		{
@@ -131,12 +181,12 @@ class BlockedQueue : private LockQueue<OBJ>
 	/// returns the number of elements in this Queue
 	std::size_t size( void ) const
 	{
-		return LockQueue<OBJ>::size();
+		return Super::size();
 	}
 	/// @return the number of elements ever pushed in this Queue
 	std::size_t total( void ) const
 	{
-		return LockQueue<OBJ>::total();
+		return Super::total();
 	}
 };
 
@@ -188,21 +238,23 @@ class BlockedQueue : private LockQueue<OBJ>
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
-template <typename OBJ>
-OBJ BlockedQueue<OBJ>::pop( unsigned long timeout )
+template <typename OBJ, typename QueueT>
+OBJ BlockedQueue<OBJ, QueueT>::waitPop( unsigned long timeout, Locking<true> )
 {
-	StopWatch	sw(	true );
-
 	LockGuard	lock( m_lock, timeout );
 	if( lock )
 	{
-		while( !size() && static_cast<unsigned long>(sw.getMillis()) < timeout  )
+		if( !size() )
 		{
-			m_conditional.wait( timeout );
+			StopWatch	sw(	true );
+			do
+			{
+				m_conditional.wait( timeout );
+			} while( !size() && static_cast<unsigned long>(sw.getMillis()) < timeout );
 		}
 		if( size() )
 		{
-			return LockQueue<OBJ>::pop();
+			return Super::pop();
 		}
 	}
 
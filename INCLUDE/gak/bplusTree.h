@@ -0,0 +1,1556 @@
+/*
+		Project:		GAKLIB
+		Module:			bplusTree.h
+		Description:	B+-tree, a cache friendly ordered set with order statistics
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_BPLUS_TREE_H
+#define GAK_BPLUS_TREE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <assert.h>
+#include <iterator>
+#include <limits>
+
+#include <gak/container.h>
+#include <gak/compare.h>
+#include <gak/array.h>
+#include <gak/exception.h>
+#include <gak/iostream.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a high fanout B+-tree for fast inserting and searching
+
+	Unlike Btree, that allocates one node per item, this tree stores up to
+	ORDER items in one contiguous leaf. Inner nodes store up to ORDER child
+	pointers together with the separating keys and the number of items in
+	each subtree. Thus a lookup touches only a few cache lines per level and
+	the tree can also find the n-th item in O(log n).
+
+	The leafs are linked in both directions, iterating over the tree does not
+	need the inner nodes at all.
+
+	The public interface is compatible with Btree. In contrast to Btree
+	the address of an item may change if other items are added or removed.
+
+	@tparam OBJ the type of items to store in this Container, must be default constructible
+	@tparam Comparator the type that can compare two items
+	@tparam ORDER the max. number of items in a leaf or childs of an inner node
+	@see Btree, FixedComparator, DynamicComparator
+*/
+template <class OBJ, class Comparator=FixedComparator<OBJ>, int ORDER=32>
+class BplusTree : public Container
+{
+	public:
+	typedef BplusTree<OBJ, Comparator, ORDER> SelfT;
+
+	private:
+	static const size_t MIN_ITEMS = ORDER/2;
+
+	struct Node
+	{
+		bool	m_isLeaf;
+		size_t	m_numItems;
+
+		Node( bool isLeaf ) : m_isLeaf( isLeaf ), m_numItems( 0 ) {}
+	};
+	struct Leaf : public Node
+	{
+		Leaf	*m_prev, *m_next;
+		OBJ		m_data[ORDER];
+
+		Leaf() : Node( true ), m_prev( nullptr ), m_next( nullptr ) {}
+
+		void insertAt( size_t pos, const OBJ &data )
+		{
+			assert( this->m_numItems < ORDER );
+			for( size_t i=this->m_numItems; i>pos; --i )
+			{
+				moveAssign( m_data[i], m_data[i-1] );
+			}
+			m_data[pos] = data;
+			++this->m_numItems;
+		}
+		void removeAt( size_t pos )
+		{
+			assert( pos < this->m_numItems );
+			--this->m_numItems;
+			for( size_t i=pos; i<this->m_numItems; ++i )
+			{
+				moveAssign( m_data[i], m_data[i+1] );
+			}
+			m_data[this->m_numItems] = OBJ();
+		}
+	};
+	struct Inner : public Node
+	{
+		/// m_keys[i] is <= all items in m_childs[i] and > all items in m_childs[i-1], m_keys[0] is not used
+		OBJ		m_keys[ORDER];
+		Node	*m_childs[ORDER];
+		size_t	m_counts[ORDER];
+
+		Inner() : Node( false ) {}
+
+		void insertAt( size_t pos, const OBJ &key, Node *child, size_t count )
+		{
+			assert( this->m_numItems < ORDER );
+			for( size_t i=this->m_numItems; i>pos; --i )
+			{
+				moveAssign( m_keys[i], m_keys[i-1] );
+				m_childs[i] = m_childs[i-1];
+				m_counts[i] = m_counts[i-1];
+			}
+			m_keys[pos] = key;
+			m_childs[pos] = child;
+			m_counts[pos] = count;
+			++this->m_numItems;
+		}
+		void removeAt( size_t pos )
+		{
+			assert( pos < this->m_numItems );
+			--this->m_numItems;
+			for( size_t i=pos; i<this->m_numItems; ++i )
+			{
+				moveAssign( m_keys[i], m_keys[i+1] );
+				m_childs[i] = m_childs[i+1];
+				m_counts[i] = m_counts[i+1];
+			}
+			m_keys[this->m_numItems] = OBJ();
+		}
+		size_t getCount() const
+		{
+			size_t count = 0;
+			for( size_t i=0; i<this->m_numItems; ++i )
+			{
+				count += m_counts[i];
+			}
+			return count;
+		}
+	};
+
+	Node		*m_root;
+	Leaf		*m_first, *m_last;
+	Comparator	m_comparator;
+
+	public:
+	/// creates an empty tree
+	BplusTree( const Comparator &comparator = Comparator() ) : m_comparator( comparator )
+	{
+		forget();
+	}
+	/// copy constructor
+	BplusTree( const BplusTree &src ) : Container(), m_comparator( src.m_comparator )
+	{
+		forget();
+		copyData( src );
+	}
+	/// copy assignment
+	const BplusTree &operator = ( const BplusTree &src )
+	{
+		if( this != &src )
+		{
+			clear();
+			m_comparator = src.m_comparator;
+			copyData( src );
+		}
+		return *this;
+	}
+	/// destroys the Container and all its items
+	~BplusTree()
+	{
+		deleteNode( m_root );
+	}
+
+	private:
+	static void deleteNode( Node *node );
+	static size_t getCount( const Node *node )
+	{
+		return node->m_isLeaf ? node->m_numItems : static_cast<const Inner *>(node)->getCount();
+	}
+	void copyData( const BplusTree &src );
+
+	/*
+	-------------------------------------------------------------------------
+		Memory
+	-------------------------------------------------------------------------
+	*/
+	/// @name Memory
+	///@{
+	private:
+	void forget( void )
+	{
+		m_root = nullptr;
+		m_first = m_last = nullptr;
+		Container::clear();
+	}
+	public:
+	/// deletes all items in this container
+	void clear( void )
+	{
+		deleteNode( m_root );
+		forget();
+	}
+	/**
+		@brief moves all items from the source tree
+		the source will be empty after return
+		@param [in,out] source the source tree
+	*/
+	void moveFrom( SelfT &source )
+	{
+		if( this != &source )
+		{
+			this->clear();
+			m_root = source.m_root;
+			m_first = source.m_first;
+			m_last = source.m_last;
+			Container::moveFrom( source );
+			source.forget();
+		}
+	}
+	/// returns the size of an item
+	size_t getElementSize( void ) const
+	{
+		return sizeof( OBJ );
+	}
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		Adding existing data
+	-------------------------------------------------------------------------
+	*/
+	/// @name Adding existing data
+	///@{
+	private:
+	Node *addElement( Node *node, const OBJ &data, OBJ **oResult, bool *oAdded, OBJ *oSplitKey );
+	Leaf *splitLeaf( Leaf *leaf );
+
+	public:
+	/**
+		@brief adds a new element to the tree
+		@param [in] data the new item
+		@return the new copied item or the item already stored in the tree
+	*/
+	OBJ &addElement( const OBJ &data );
+
+	/**
+		@brief adds a new element to the tree
+		@param [in] data the new item
+		@return the tree itself
+	*/
+	const SelfT &operator += ( const OBJ &data )
+	{
+		addElement( data );
+		return *this;
+	}
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		Get Data
+	-------------------------------------------------------------------------
+	*/
+	/// @name Get Data
+	///@{
+	public:
+	/// returns the first element in the tree
+	const OBJ *getFirst( void ) const
+	{
+		return m_first ? &m_first->m_data[0] : nullptr;
+	}
+	/// returns the last element in the tree
+	const OBJ *getLast( void ) const
+	{
+		return m_last ? &m_last->m_data[m_last->m_numItems-1] : nullptr;
+	}
+	/**
+		@brief retrieves the element at a given position
+		@param [in] pos the index position of the element
+		@return a reference of the element
+		@throws IndexError if index is out of bounds
+	*/
+	const OBJ &getElementAt( size_t pos ) const;
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		Modify Data
+	-------------------------------------------------------------------------
+	*/
+	/// @name Modify Data
+	///@{
+	private:
+	bool removeElement( Node *node, const OBJ &data );
+	void fixUnderflow( Inner *parent, size_t childIdx );
+
+	public:
+	/// searches for an item and removes the item if found
+	void removeElement( const OBJ &data );
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		Searching
+	-------------------------------------------------------------------------
+	*/
+	/// @name Searching
+	///@{
+	private:
+	size_t findChild( const Inner *inner, const OBJ &data ) const;
+	size_t findMinPos( const Leaf *leaf, const OBJ &data ) const;
+	Leaf *findLeaf( const OBJ &data ) const
+	{
+		Node *node = m_root;
+		while( node && !node->m_isLeaf )
+		{
+			const Inner *inner = static_cast<const Inner *>(node);
+			node = inner->m_childs[findChild( inner, data )];
+		}
+		return static_cast<Leaf *>(node);
+	}
+	class iterator_base;
+	iterator_base findMin( const OBJ &data ) const;
+
+	public:
+	/// return true if a given value is available
+	bool hasElement( const OBJ &data ) const
+	{
+		return findElement( data ) != nullptr;
+	}
+	/**
+		@brief searches for a value
+		@param [in] data the value to search for
+		@return the address of the element found nullptr if not found
+	*/
+	const OBJ *findElement( const OBJ &data ) const
+	{
+		const Leaf *leaf = findLeaf( data );
+		if( leaf )
+		{
+			size_t pos = findMinPos( leaf, data );
+			if( pos < leaf->m_numItems && !m_comparator( leaf->m_data[pos], data ) )
+			{
+				return &leaf->m_data[pos];
+			}
+		}
+		return nullptr;
+	}
+	/**
+		@brief searches for the position of a value
+		@param [in] data the value to search for
+		@return the index of the element found or no_index if not found
+		@see getElementAt
+	*/
+	size_t findIndex( const OBJ &data ) const;
+
+	class const_iterator;
+
+	ConstIterable<const_iterator> getRange( const OBJ &min, const OBJ &max ) const
+	{
+		assert( min <= max );
+		return ConstIterable<const_iterator>(
+			const_iterator( findMin( min ) ), const_iterator( findMin( max ) )
+		);
+	}
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		compare
+	-------------------------------------------------------------------------
+	*/
+	public:
+	/**
+		@brief compares this tree with another
+		@param [in] other the other container
+		@return the compare result
+		@see Btree, gak::compareContainer
+	*/
+	int compare( const SelfT &other ) const
+	{
+		return compareContainer( *this, other );
+	}
+
+	/*
+	-------------------------------------------------------------------------
+		File I/O
+	-------------------------------------------------------------------------
+	*/
+	/// @name File I/O
+	///@{
+	public:
+	/**
+		@brief writes binary data to a stream
+		@param [in] stream the stream to write to
+		@exception WriteError in case of an I/O error
+	*/
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		gak::containerToBinaryStream( stream, *this );
+	}
+	/**
+		@brief reads binary data from a stream
+		@param [in] stream the stream to read from
+		@exception ReadError in case of an I/O error
+	*/
+	void fromBinaryStream( std::istream &stream );
+	///@}
+
+	/*
+	-------------------------------------------------------------------------
+		standard support
+	-------------------------------------------------------------------------
+	*/
+	public:
+	/// @name Some standard typedefs:
+	///@{
+	typedef OBJ			value_type;
+	typedef const OBJ	&reference;
+	typedef const OBJ	&const_reference;
+	typedef const OBJ	*pointer;
+	typedef const OBJ	*const_pointer;
+	///@}
+
+	private:
+	class iterator_base : public std::iterator<std::bidirectional_iterator_tag, value_type>
+	{
+		protected:
+		Leaf	*m_leaf;
+		size_t	m_pos;
+
+		void forward()
+		{
+			if( !m_leaf )
+				throw IndexError();
+			if( ++m_pos >= m_leaf->m_numItems )
+			{
+				m_leaf = m_leaf->m_next;
+				m_pos = 0;
+			}
+		}
+		void backward()
+		{
+			if( !m_leaf )
+				throw IndexError();
+			if( m_pos )
+			{
+				--m_pos;
+			}
+			else
+			{
+				m_leaf = m_leaf->m_prev;
+				m_pos = m_leaf ? m_leaf->m_numItems-1 : 0;
+			}
+		}
+		OBJ *getPointer() const
+		{
+			return m_leaf ? &m_leaf->m_data[m_pos] : nullptr;
+		}
+		OBJ &getData() const
+		{
+			if( !m_leaf )
+				throw IndexError();
+			return m_leaf->m_data[m_pos];
+		}
+
+		public:
+		iterator_base( Leaf *leaf=nullptr, size_t pos=0 ) : m_leaf( leaf ), m_pos( pos )
+		{
+		}
+
+		int compare( const iterator_base &oper ) const
+		{
+			if( m_leaf != oper.m_leaf )
+				return m_leaf < oper.m_leaf ? -1 : 1;
+			return gak::compare( m_pos, oper.m_pos );
+		}
+	};
+
+	public:
+	/// @name Some standard classes:
+	///@{
+	class iterator : public iterator_base
+	{
+		public:
+		iterator( const iterator_base &start ) : iterator_base( start )
+		{
+		}
+
+		// can change data, but must not change the sort order
+		operator OBJ * () const
+		{
+			return this->getPointer();
+		}
+		OBJ *operator -> () const
+		{
+			return &this->getData();
+		}
+		OBJ & operator * () const
+		{
+			return this->getData();
+		}
+
+		const iterator &operator ++()				// pre inkrement
+		{
+			this->forward();
+			return *this;
+		}
+		iterator operator ++( int )					// post inkrement
+		{
+			iterator	temp( *this );
+			this->forward();
+			return temp;
+		}
+		const iterator &operator --()				// pre dekrement
+		{
+			this->backward();
+			return *this;
+		}
+		iterator operator --( int )					// post dekrement
+		{
+			iterator	temp( *this );
+			this->backward();
+			return temp;
+		}
+	};
+	class reverse_iterator : public iterator_base
+	{
+		public:
+		reverse_iterator( const iterator_base &start ) : iterator_base( start )
+		{
+		}
+
+		// can change data, but must not change the sort order
+		operator OBJ * () const
+		{
+			return this->getPointer();
+		}
+		OBJ *operator -> () const
+		{
+			return &this->getData();
+		}
+		OBJ & operator * () const
+		{
+			return this->getData();
+		}
+
+		const reverse_iterator &operator ++()				// pre inkrement
+		{
+			this->backward();
+			return *this;
+		}
+		reverse_iterator operator ++( int )					// post inkrement
+		{
+			reverse_iterator	temp( *this );
+			this->backward();
+			return temp;
+		}
+		const reverse_iterator &operator --()				// pre dekrement
+		{
+			this->forward();
+			return *this;
+		}
+		reverse_iterator operator --( int )					// post dekrement
+		{
+			reverse_iterator	temp( *this );
+			this->forward();
+			return temp;
+		}
+	};
+	class const_iterator : public iterator_base
+	{
+		public:
+		const_iterator( const iterator_base &start ) : iterator_base( start )
+		{
+		}
+
+		// cannot change data
+		operator const OBJ * () const
+		{
+			return this->getPointer();
+		}
+		const OBJ *operator -> () const
+		{
+			return &this->getData();
+		}
+		const OBJ & operator * () const
+		{
+			return this->getData();
+		}
+
+		const const_iterator &operator ++()				// pre inkrement
+		{
+			this->forward();
+			return *this;
+		}
+		const_iterator operator ++( int )					// post inkrement
+		{
+			const_iterator	temp( *this );
+			this->forward();
+			return temp;
+		}
+		const const_iterator &operator --()				// pre dekrement
+		{
+			this->backward();
+			return *this;
+		}
+		const_iterator operator --( int )					// post dekrement
+		{
+			const_iterator	temp( *this );
+			this->backward();
+			return temp;
+		}
+	};
+	class const_reverse_iterator : public iterator_base
+	{
+		public:
+		const_reverse_iterator( const iterator_base &start ) : iterator_base( start )
+		{
+		}
+
+		// cannot change data
+		operator const OBJ * () const
+		{
+			return this->getPointer();
+		}
+		const OBJ *operator -> () const
+		{
+			return &this->getData();
+		}
+		const OBJ & operator * () const
+		{
+			return this->getData();
+		}
+
+		const const_reverse_iterator &operator ++()				// pre inkrement
+		{
+			this->backward();
+			return *this;
+		}
+		const_reverse_iterator operator ++( int )					// post inkrement
+		{
+			const_reverse_iterator	temp( *this );
+			this->backward();
+			return temp;
+		}
+		const const_reverse_iterator &operator --()				// pre dekrement
+		{
+			this->forward();
+			return *this;
+		}
+		const_reverse_iterator operator --( int )					// post dekrement
+		{
+			const_reverse_iterator	temp( *this );
+			this->forward();
+			return temp;
+		}
+	};
+	///@}
+
+	private:
+	iterator_base first() const
+	{
+		return iterator_base( m_first, 0 );
+	}
+	iterator_base last() const
+	{
+		return iterator_base( m_last, m_last ? m_last->m_numItems-1 : 0 );
+	}
+
+	public:
+	/// @name Some standard member functions:
+	///@{
+	iterator begin()
+	{
+		return first();
+	}
+	iterator end()
+	{
+		return iterator_base();
+	}
+	const_iterator cbegin() const
+	{
+		return first();
+	}
+	const_iterator cend() const
+	{
+		return iterator_base();
+	}
+	reverse_iterator rbegin()
+	{
+		return last();
+	}
+	reverse_iterator rend()
+	{
+		return iterator_base();
+	}
+	const_reverse_iterator crbegin() const
+	{
+		return last();
+	}
+	const_reverse_iterator crend() const
+	{
+		return iterator_base();
+	}
+
+	void push_back( const OBJ &newData )
+	{
+		addElement( newData );
+	}
+	void push_front( const OBJ &newData )
+	{
+		addElement( newData );
+	}
+	iterator erase( const iterator &it );
+	///@}
+
+	/// used for internal testing
+	private:
+	bool testNode( const Node *node, size_t level, size_t *ioDepth, const Leaf **ioLeaf, size_t *oCount ) const;
+
+	public:
+	/**
+		@brief checks the structure of the tree
+		@param [out] oDepth the depth of the tree
+		@return true if the tree is consistent
+	*/
+	bool test( size_t *oDepth ) const;
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class Comparator, int ORDER>
+void BplusTree<OBJ, Comparator, ORDER>::deleteNode( Node *node )
+{
+	if( !node )
+	{
+		return;
+	}
+	if( node->m_isLeaf )
+	{
+		delete static_cast<Leaf *>(node);
+	}
+	else
+	{
+		Inner *inner = static_cast<Inner *>(node);
+		for( size_t i=0; i<inner->m_numItems; ++i )
+		{
+			deleteNode( inner->m_childs[i] );
+		}
+		delete inner;
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class Comparator, int ORDER>
+void BplusTree<OBJ, Comparator, ORDER>::copyData( const BplusTree &src )
+{
+	// the items of src are sorted: just append them to the last leaf
+	Leaf		*leaf = nullptr;
+	PODarray<Leaf*>	leafs;
+
+	for( const Leaf *srcLeaf = src.m_first; srcLeaf; srcLeaf = srcLeaf->m_next )
+	{
+		for( size_t i=0; i<srcLeaf->m_numItems; ++i )
+		{
+			if( !leaf || leaf->m_numItems == ORDER )
+			{
+				Leaf *newLeaf = new Leaf();
+				newLeaf->m_prev = leaf;
+				if( leaf )
+				{
+					leaf->m_next = newLeaf;
+				}
+				leaf = newLeaf;
+				leafs.addElement( leaf );
+			}
+			leaf->m_data[leaf->m_numItems++] = srcLeaf->m_data[i];
+		}
+	}
+	if( !leaf )
+	{
+		return;
+	}
+	m_first = leafs[0];
+	m_last = leaf;
+	setNumElements( src.size() );
+
+	// the last leaf may have too few items
+	if( leafs.size() > 1 && leaf->m_numItems < MIN_ITEMS )
+	{
+		Leaf	*prev = leaf->m_prev;
+		size_t	total = prev->m_numItems + leaf->m_numItems;
+		size_t	shift = total/2 - leaf->m_numItems;
+		for( size_t i=leaf->m_numItems; i>0; --i )
+		{
+			moveAssign( leaf->m_data[i-1+shift], leaf->m_data[i-1] );
+		}
+		for( size_t i=0; i<shift; ++i )
+		{
+			moveAssign( leaf->m_data[i], prev->m_data[prev->m_numItems-shift+i] );
+			prev->m_data[prev->m_numItems-shift+i] = OBJ();
+		}
+		prev->m_numItems -= shift;
+		leaf->m_numItems += shift;
+	}
+
+	// build the inner levels bottom up
+	PODarray<Node*>	level;
+	for( size_t i=0; i<leafs.size(); ++i )
+	{
+		level.addElement( leafs[i] );
+	}
+	while( level.size() > 1 )
+	{
+		PODarray<Node*>	nextLevel;
+		size_t			numNodes = (level.size() + ORDER - 1) / ORDER;
+		size_t			perNode = level.size() / numNodes;
+		size_t			extra = level.size() % numNodes;
+		size_t			idx = 0;
+
+		for( size_t n=0; n<numNodes; ++n )
+		{
+			Inner	*inner = new Inner();
+			size_t	numChilds = perNode + (n < extra ? 1 : 0);
+			for( size_t i=0; i<numChilds; ++i, ++idx )
+			{
+				Node	*child = level[idx];
+				Node	*minNode = child;
+				while( !minNode->m_isLeaf )
+				{
+					minNode = static_cast<Inner *>(minNode)->m_childs[0];
+				}
+				inner->m_keys[i] = static_cast<Leaf *>(minNode)->m_data[0];
+				inner->m_childs[i] = child;
+				inner->m_counts[i] = getCount( child );
+			}
+			inner->m_numItems = numChilds;
+			nextLevel.addElement( inner );
+		}
+		moveAssign( level, nextLevel );
+	}
+	m_root = level[0];
+}
+
+template <class OBJ, class Comparator, int ORDER>
+typename BplusTree<OBJ, Comparator, ORDER>::Leaf *BplusTree<OBJ, Comparator, ORDER>::splitLeaf( Leaf *leaf )
+{
+	Leaf	*newLeaf = new Leaf();
+	size_t	half = leaf->m_numItems / 2;
+
+	for( size_t i=half; i<leaf->m_numItems; ++i )
+	{
+		moveAssign( newLeaf->m_data[i-half], leaf->m_data[i] );
+		leaf->m_data[i] = OBJ();
+	}
+	newLeaf->m_numItems = leaf->m_numItems - half;
+	leaf->m_numItems = half;
+
+	newLeaf->m_prev = leaf;
+	newLeaf->m_next = leaf->m_next;
+	if( leaf->m_next )
+	{
+		leaf->m_next->m_prev = newLeaf;
+	}
+	else
+	{
+		m_last = newLeaf;
+	}
+	leaf->m_next = newLeaf;
+
+	return newLeaf;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+typename BplusTree<OBJ, Comparator, ORDER>::Node *BplusTree<OBJ, Comparator, ORDER>::addElement(
+	Node *node, const OBJ &data, OBJ **oResult, bool *oAdded, OBJ *oSplitKey
+)
+{
+	if( node->m_isLeaf )
+	{
+		Leaf	*leaf = static_cast<Leaf *>(node);
+		size_t	pos = findMinPos( leaf, data );
+
+		if( pos < leaf->m_numItems && !m_comparator( leaf->m_data[pos], data ) )
+		{
+			*oResult = &leaf->m_data[pos];
+			*oAdded = false;
+			return nullptr;
+		}
+
+		*oAdded = true;
+		if( leaf->m_numItems < ORDER )
+		{
+			leaf->insertAt( pos, data );
+			*oResult = &leaf->m_data[pos];
+			return nullptr;
+		}
+
+		Leaf	*newLeaf = splitLeaf( leaf );
+		if( pos <= leaf->m_numItems )
+		{
+			leaf->insertAt( pos, data );
+			*oResult = &leaf->m_data[pos];
+		}
+		else
+		{
+			pos -= leaf->m_numItems;
+			newLeaf->insertAt( pos, data );
+			*oResult = &newLeaf->m_data[pos];
+		}
+		*oSplitKey = newLeaf->m_data[0];
+		return newLeaf;
+	}
+
+	Inner	*inner = static_cast<Inner *>(node);
+	size_t	idx = findChild( inner, data );
+	OBJ		splitKey;
+	Node	*newChild = addElement( inner->m_childs[idx], data, oResult, oAdded, &splitKey );
+
+	if( !newChild )
+	{
+		if( *oAdded )
+		{
+			++inner->m_counts[idx];
+		}
+		return nullptr;
+	}
+
+	inner->m_counts[idx] = getCount( inner->m_childs[idx] );
+	size_t	newCount = getCount( newChild );
+	if( inner->m_numItems < ORDER )
+	{
+		inner->insertAt( idx+1, splitKey, newChild, newCount );
+		return nullptr;
+	}
+
+	Inner	*newInner = new Inner();
+	size_t	half = inner->m_numItems / 2;
+	for( size_t i=half; i<inner->m_numItems; ++i )
+	{
+		moveAssign( newInner->m_keys[i-half], inner->m_keys[i] );
+		inner->m_keys[i] = OBJ();
+		newInner->m_childs[i-half] = inner->m_childs[i];
+		newInner->m_counts[i-half] = inner->m_counts[i];
+	}
+	newInner->m_numItems = inner->m_numItems - half;
+	inner->m_numItems = half;
+
+	if( idx+1 <= half )
+	{
+		inner->insertAt( idx+1, splitKey, newChild, newCount );
+	}
+	else
+	{
+		newInner->insertAt( idx+1-half, splitKey, newChild, newCount );
+	}
+	moveAssign( *oSplitKey, newInner->m_keys[0] );
+	newInner->m_keys[0] = OBJ();
+
+	return newInner;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+bool BplusTree<OBJ, Comparator, ORDER>::removeElement( Node *node, const OBJ &data )
+{
+	if( node->m_isLeaf )
+	{
+		Leaf	*leaf = static_cast<Leaf *>(node);
+		size_t	pos = findMinPos( leaf, data );
+
+		if( pos < leaf->m_numItems && !m_comparator( leaf->m_data[pos], data ) )
+		{
+			leaf->removeAt( pos );
+			return true;
+		}
+		return false;
+	}
+
+	Inner	*inner = static_cast<Inner *>(node);
+	size_t	idx = findChild( inner, data );
+	if( !removeElement( inner->m_childs[idx], data ) )
+	{
+		return false;
+	}
+	--inner->m_counts[idx];
+	if( inner->m_childs[idx]->m_numItems < MIN_ITEMS )
+	{
+		fixUnderflow( inner, idx );
+	}
+	return true;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+void BplusTree<OBJ, Comparator, ORDER>::fixUnderflow( Inner *parent, size_t childIdx )
+{
+	assert( parent->m_numItems > 1 );
+
+	size_t	rightIdx = childIdx ? childIdx : 1;
+	size_t	leftIdx = rightIdx-1;
+	Node	*leftNode = parent->m_childs[leftIdx];
+	Node	*rightNode = parent->m_childs[rightIdx];
+
+	if( leftNode->m_numItems + rightNode->m_numItems <= ORDER )
+	{
+		// merge right into left
+		if( leftNode->m_isLeaf )
+		{
+			Leaf	*left = static_cast<Leaf *>(leftNode);
+			Leaf	*right = static_cast<Leaf *>(rightNode);
+			for( size_t i=0; i<right->m_numItems; ++i )
+			{
+				moveAssign( left->m_data[left->m_numItems++], right->m_data[i] );
+			}
+			left->m_next = right->m_next;
+			if( right->m_next )
+			{
+				right->m_next->m_prev = left;
+			}
+			else
+			{
+				m_last = left;
+			}
+			delete right;
+		}
+		else
+		{
+			Inner	*left = static_cast<Inner *>(leftNode);
+			Inner	*right = static_cast<Inner *>(rightNode);
+			for( size_t i=0; i<right->m_numItems; ++i )
+			{
+				if( i )
+				{
+					moveAssign( left->m_keys[left->m_numItems], right->m_keys[i] );
+				}
+				else
+				{
+					left->m_keys[left->m_numItems] = parent->m_keys[rightIdx];
+				}
+				left->m_childs[left->m_numItems] = right->m_childs[i];
+				left->m_counts[left->m_numItems] = right->m_counts[i];
+				++left->m_numItems;
+			}
+			right->m_numItems = 0;
+			delete right;
+		}
+		parent->m_counts[leftIdx] += parent->m_counts[rightIdx];
+		parent->removeAt( rightIdx );
+	}
+	else if( leftNode->m_numItems < rightNode->m_numItems )
+	{
+		// move the first item of right to left
+		if( leftNode->m_isLeaf )
+		{
+			Leaf	*left = static_cast<Leaf *>(leftNode);
+			Leaf	*right = static_cast<Leaf *>(rightNode);
+			moveAssign( left->m_data[left->m_numItems++], right->m_data[0] );
+			right->removeAt( 0 );
+			parent->m_keys[rightIdx] = right->m_data[0];
+			++parent->m_counts[leftIdx];
+			--parent->m_counts[rightIdx];
+		}
+		else
+		{
+			Inner	*left = static_cast<Inner *>(leftNode);
+			Inner	*right = static_cast<Inner *>(rightNode);
+			size_t	count = right->m_counts[0];
+			left->insertAt( left->m_numItems, parent->m_keys[rightIdx], right->m_childs[0], count );
+			moveAssign( parent->m_keys[rightIdx], right->m_keys[1] );
+			right->removeAt( 0 );
+			parent->m_counts[leftIdx] += count;
+			parent->m_counts[rightIdx] -= count;
+		}
+	}
+	else
+	{
+		// move the last item of left to right
+		if( leftNode->m_isLeaf )
+		{
+			Leaf	*left = static_cast<Leaf *>(leftNode);
+			Leaf	*right = static_cast<Leaf *>(rightNode);
+			right->insertAt( 0, left->m_data[left->m_numItems-1] );
+			left->removeAt( left->m_numItems-1 );
+			parent->m_keys[rightIdx] = right->m_data[0];
+			--parent->m_counts[leftIdx];
+			++parent->m_counts[rightIdx];
+		}
+		else
+		{
+			Inner	*left = static_cast<Inner *>(leftNode);
+			Inner	*right = static_cast<Inner *>(rightNode);
+			size_t	last = left->m_numItems-1;
+			size_t	count = left->m_counts[last];
+			right->m_keys[0] = parent->m_keys[rightIdx];
+			right->insertAt( 0, OBJ(), left->m_childs[last], count );
+			moveAssign( parent->m_keys[rightIdx], left->m_keys[last] );
+			left->removeAt( last );
+			parent->m_counts[leftIdx] -= count;
+			parent->m_counts[rightIdx] += count;
+		}
+	}
+}
+
+template <class OBJ, class Comparator, int ORDER>
+size_t BplusTree<OBJ, Comparator, ORDER>::findChild( const Inner *inner, const OBJ &data ) const
+{
+	// find the last child whose key is <= data
+	size_t	low = 1;
+	size_t	high = inner->m_numItems;
+	while( low < high )
+	{
+		size_t mid = (low + high) / 2;
+		if( m_comparator( inner->m_keys[mid], data ) <= 0 )
+		{
+			low = mid+1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low-1;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+size_t BplusTree<OBJ, Comparator, ORDER>::findMinPos( const Leaf *leaf, const OBJ &data ) const
+{
+	// find the first item that is >= data
+	size_t	low = 0;
+	size_t	high = leaf->m_numItems;
+	while( low < high )
+	{
+		size_t mid = (low + high) / 2;
+		if( m_comparator( leaf->m_data[mid], data ) < 0 )
+		{
+			low = mid+1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+typename BplusTree<OBJ, Comparator, ORDER>::iterator_base BplusTree<OBJ, Comparator, ORDER>::findMin( const OBJ &data ) const
+{
+	Leaf *leaf = findLeaf( data );
+	if( !leaf )
+	{
+		return iterator_base();
+	}
+	size_t pos = findMinPos( leaf, data );
+	if( pos < leaf->m_numItems )
+	{
+		return iterator_base( leaf, pos );
+	}
+	return iterator_base( leaf->m_next, 0 );
+}
+
+template <class OBJ, class Comparator, int ORDER>
+bool BplusTree<OBJ, Comparator, ORDER>::testNode(
+	const Node *node, size_t level, size_t *ioDepth, const Leaf **ioLeaf, size_t *oCount
+) const
+{
+	bool result = node->m_numItems <= ORDER;
+	assert( result );
+	if( node != m_root )
+	{
+		result = result && node->m_numItems >= MIN_ITEMS;
+		assert( result );
+	}
+
+	if( node->m_isLeaf )
+	{
+		const Leaf *leaf = static_cast<const Leaf *>(node);
+
+		if( *ioDepth )
+		{
+			result = result && *ioDepth == level;
+			assert( result );
+		}
+		*ioDepth = level;
+
+		// the leafs must be linked in the order of the tree
+		result = result && leaf->m_prev == *ioLeaf;
+		assert( result );
+		result = result && (*ioLeaf ? (*ioLeaf)->m_next == leaf : m_first == leaf);
+		assert( result );
+		*ioLeaf = leaf;
+
+		for( size_t i=1; i<leaf->m_numItems; ++i )
+		{
+			result = result && m_comparator( leaf->m_data[i-1], leaf->m_data[i] ) < 0;
+			assert( result );
+		}
+		*oCount = leaf->m_numItems;
+		return result;
+	}
+
+	const Inner	*inner = static_cast<const Inner *>(node);
+	size_t		count = 0;
+
+	result = result && inner->m_numItems > 1;
+	assert( result );
+	for( size_t i=0; result && i<inner->m_numItems; ++i )
+	{
+		size_t		childCount;
+		const Leaf	*prevLeaf = *ioLeaf;
+
+		result = testNode( inner->m_childs[i], level+1, ioDepth, ioLeaf, &childCount );
+		result = result && childCount == inner->m_counts[i];
+		assert( result );
+		count += childCount;
+
+		if( result && i && childCount )
+		{
+			// all items in child i must be >= m_keys[i] and all items in child i-1 must be < m_keys[i]
+			const Leaf	*firstLeaf = prevLeaf ? prevLeaf->m_next : m_first;
+			result = m_comparator( firstLeaf->m_data[0], inner->m_keys[i] ) >= 0;
+			assert( result );
+			result = result && m_comparator( prevLeaf->m_data[prevLeaf->m_numItems-1], inner->m_keys[i] ) < 0;
+			assert( result );
+		}
+	}
+	*oCount = count;
+	return result;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class Comparator, int ORDER>
+OBJ &BplusTree<OBJ, Comparator, ORDER>::addElement( const OBJ &data )
+{
+	if( !m_root )
+	{
+		Leaf *leaf = new Leaf();
+		leaf->insertAt( 0, data );
+		m_root = m_first = m_last = leaf;
+		incNumElements();
+		return leaf->m_data[0];
+	}
+
+	OBJ		*result;
+	bool	added;
+	OBJ		splitKey;
+	Node	*newNode = addElement( m_root, data, &result, &added, &splitKey );
+
+	if( newNode )
+	{
+		Inner	*newRoot = new Inner();
+		newRoot->insertAt( 0, OBJ(), m_root, getCount( m_root ) );
+		newRoot->insertAt( 1, splitKey, newNode, getCount( newNode ) );
+		m_root = newRoot;
+	}
+	if( added )
+	{
+		incNumElements();
+	}
+	return *result;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+const OBJ &BplusTree<OBJ, Comparator, ORDER>::getElementAt( size_t pos ) const
+{
+	if( pos >= size() )
+	{
+		throw IndexError();
+	}
+
+	const Node *node = m_root;
+	while( !node->m_isLeaf )
+	{
+		const Inner	*inner = static_cast<const Inner *>(node);
+		size_t		i = 0;
+		while( pos >= inner->m_counts[i] )
+		{
+			pos -= inner->m_counts[i];
+			++i;
+		}
+		node = inner->m_childs[i];
+	}
+	return static_cast<const Leaf *>(node)->m_data[pos];
+}
+
+template <class OBJ, class Comparator, int ORDER>
+void BplusTree<OBJ, Comparator, ORDER>::removeElement( const OBJ &data )
+{
+	if( !m_root || !removeElement( m_root, data ) )
+	{
+		return;
+	}
+	decNumElements();
+
+	if( m_root->m_isLeaf )
+	{
+		if( !m_root->m_numItems )
+		{
+			clear();
+		}
+	}
+	else if( m_root->m_numItems == 1 )
+	{
+		Inner *oldRoot = static_cast<Inner *>(m_root);
+		m_root = oldRoot->m_childs[0];
+		oldRoot->m_numItems = 0;
+		delete oldRoot;
+	}
+}
+
+template <class OBJ, class Comparator, int ORDER>
+size_t BplusTree<OBJ, Comparator, ORDER>::findIndex( const OBJ &data ) const
+{
+	const Node	*node = m_root;
+	size_t		pos = 0;
+
+	if( !node )
+	{
+		return no_index;
+	}
+	while( !node->m_isLeaf )
+	{
+		const Inner	*inner = static_cast<const Inner *>(node);
+		size_t		idx = findChild( inner, data );
+		for( size_t i=0; i<idx; ++i )
+		{
+			pos += inner->m_counts[i];
+		}
+		node = inner->m_childs[idx];
+	}
+
+	const Leaf	*leaf = static_cast<const Leaf *>(node);
+	size_t		leafPos = findMinPos( leaf, data );
+	if( leafPos < leaf->m_numItems && !m_comparator( leaf->m_data[leafPos], data ) )
+	{
+		return pos + leafPos;
+	}
+	return no_index;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+typename BplusTree<OBJ, Comparator, ORDER>::iterator BplusTree<OBJ, Comparator, ORDER>::erase( const iterator &it )
+{
+	if( it == end() )
+	{
+		return it;
+	}
+
+	OBJ	data = *it;
+	removeElement( data );
+	return findMin( data );
+}
+
+#undef max
+
+template <class OBJ, class Comparator, int ORDER>
+void BplusTree<OBJ, Comparator, ORDER>::fromBinaryStream( std::istream &stream )
+{
+	uint64		numElements;
+
+	clear();
+	gak::fromBinaryStream( stream, &numElements );
+	if( numElements )
+	{
+		if( numElements > std::numeric_limits<std::size_t>::max() )
+		{
+			throw AllocError();
+		}
+		for( size_t i=0; i<numElements; ++i )
+		{
+			OBJ	newData;
+			gak::fromBinaryStream( stream, &newData );
+			addElement( newData );
+		}
+	}
+}
+
+template <class OBJ, class Comparator, int ORDER>
+bool BplusTree<OBJ, Comparator, ORDER>::test( size_t *oDepth ) const
+{
+	size_t		depth = 0;
+	const Leaf	*lastLeaf = nullptr;
+	size_t		count = 0;
+	bool		result = true;
+
+	if( m_root )
+	{
+		result = testNode( m_root, 1, &depth, &lastLeaf, &count );
+		result = result && lastLeaf == m_last;
+		assert( result );
+	}
+	else
+	{
+		result = !m_first && !m_last;
+		assert( result );
+	}
+	result = result && count == size();
+	assert( result );
+
+	*oDepth = depth;
+	return result;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class Comparator, int ORDER>
+inline BplusTree<OBJ, Comparator, ORDER> intersect(
+	const BplusTree<OBJ, Comparator, ORDER> &first,
+	const BplusTree<OBJ, Comparator, ORDER> &second
+)
+{
+	BplusTree<OBJ, Comparator, ORDER>	result;
+
+	intersectSorted( first, second, std::back_inserter( result ) );
+
+	return result;
+}
+
+template <class OBJ, class Comparator, int ORDER>
+inline BplusTree<OBJ, Comparator, ORDER> substract(
+	const BplusTree<OBJ, Comparator, ORDER> &first,
+	const BplusTree<OBJ, Comparator, ORDER> &second
+)
+{
+	return substractSorted( first, second );
+}
+
+template <class OBJ, class Comparator, int ORDER>
+inline void moveAssign(
+	BplusTree<OBJ, Comparator, ORDER> &target,
+	BplusTree<OBJ, Comparator, ORDER> &source )
+{
+	target.moveFrom( source );
+}
+
+/// operator to print a BplusTree to a text stream
+template <class OBJ, class Comparator, int ORDER>
+inline
+std::ostream &operator << (std::ostream &stream, const BplusTree<OBJ, Comparator, ORDER> &tree )
+{
+	printContainer( stream, tree );
+
+	return stream;
+}
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_BPLUS_TREE_H
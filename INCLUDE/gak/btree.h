@@ -509,6 +509,38 @@ class Btree : public Container
 	{
 		return m_root ? &m_root->getLast()->m_data : nullptr;
 	}
+	/**
+		@brief retrieves the element at a given position
+		@param [in] pos the index position of the element
+		@return a reference of the element
+		@throws IndexError if index is out of bounds
+	*/
+	const OBJ &getElementAt( size_t pos ) const
+	{
+		if( pos >= size() )
+		{
+			throw IndexError();
+		}
+
+		const Node *node = m_root;
+		while( true )
+		{
+			size_t	prevCount = node->m_prev ? node->m_prev->m_count : 0;
+			if( pos < prevCount )
+			{
+				node = node->m_prev;
+			}
+			else if( pos == prevCount )
+			{
+				return node->m_data;
+			}
+			else
+			{
+				pos -= prevCount + 1;
+				node = node->m_next;
+			}
+		}
+	}
 	///@}
 
 	/*
@@ -0,0 +1,870 @@
+/*
+		Project:		GAKLIB
+		Module:			compactGraph.h
+		Description:	an immutable graph in compressed sparse row format
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_COMPACT_GRAPH_H
+#define GAK_COMPACT_GRAPH_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstring>
+#include <fstream>
+
+#include <gak/graph.h>
+#include <gak/memoryMappedFile.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the magic number of a compact graph file
+const uint32 COMPACT_GRAPH_MAGIC = 0x47434B47;		// GKCG
+/// the current version of a compact graph file
+const uint16 COMPACT_GRAPH_VERSION = 1;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the header at the beginning of a compact graph file or buffer
+struct CompactGraphHeader
+{
+	uint32	m_magic;
+	uint16	m_version;
+	uint16	m_headerSize;
+	uint32	m_nodeKeySize, m_nodeSize;
+	uint32	m_linkKeySize, m_linkSize;
+	uint64	m_numNodes, m_numLinks;
+	uint64	m_fileSize;
+};
+
+/// the offsets of the arrays of a compact graph in bytes
+struct CompactGraphLayout
+{
+	std::size_t	m_nodeKeys, m_nodes, m_offsets;
+	std::size_t	m_linkKeys, m_linkOrder, m_linkStarts, m_linkEnds, m_links;
+	std::size_t	m_size;
+};
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief an immutable graph in compressed sparse row format
+
+	The nodes and links of a Graph are stored in flat arrays: The nodes get
+	dense indices in the key order of the source graph. The outgoing links
+	of a node are stored one after another, m_offsets[i] is the index of the
+	first link of node i and m_offsets[i+1] the index behind the last one.
+	Start node, end node, link data and source key of a link are stored in
+	parallel arrays. Thus a routing algorithm reads the links of a node
+	sequentially without any tree lookup.
+
+	The node and link indices are the keys of this graph, i.e. it can be used
+	as GraphT of AstarRouting and RecursiveRouting. The routes found contain
+	link indices, use getLinkKey to get the keys of the source graph.
+
+	The memory layout of a built graph is the same as the layout of the file
+	written by writeToFile. Thus open maps the file with MemoryMappedFile and
+	uses its data without reading or converting anything. As a consequence
+	NodeT, LinkT and the key types must be plain old data without pointers
+	into the heap.
+
+	@tparam NodeT the type of the node data
+	@tparam LinkT the type of the link data
+	@tparam NodeKeyT the type of the node keys of the source graph
+	@tparam LinkKeyT the type of the link keys of the source graph
+*/
+template <
+	typename NodeT, typename LinkT,
+	typename NodeKeyT=typename NodeT::key_type, typename LinkKeyT=typename LinkT::key_type
+>
+class CompactGraph
+{
+	public:
+	typedef NodeT					node_type;
+	typedef LinkT					link_type;
+	typedef uint32					node_key_type;
+	typedef Array<node_key_type>	node_key_types;
+	typedef uint32					link_key_type;
+	typedef Array<link_key_type>	link_key_types;
+	typedef NodeKeyT				source_node_key_type;
+	typedef LinkKeyT				source_link_key_type;
+	typedef CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>	SelfT;
+
+	struct LinkInfo
+	{
+		node_key_type	m_startNodeID,
+						m_endNodeID;
+		link_type		m_link;
+	};
+
+	/// the outgoing links of a node, i.e. a range of link indices
+	class OutgoingLinks
+	{
+		link_key_type	m_first, m_last;
+
+		public:
+		class const_iterator
+		{
+			link_key_type	m_linkID;
+
+			public:
+			const_iterator( link_key_type linkID ) : m_linkID( linkID )
+			{
+			}
+			link_key_type operator * () const
+			{
+				return m_linkID;
+			}
+			const_iterator &operator ++ ()
+			{
+				++m_linkID;
+				return *this;
+			}
+			bool operator == ( const const_iterator &other ) const
+			{
+				return m_linkID == other.m_linkID;
+			}
+			bool operator != ( const const_iterator &other ) const
+			{
+				return m_linkID != other.m_linkID;
+			}
+		};
+
+		OutgoingLinks( link_key_type first, link_key_type last ) : m_first( first ), m_last( last )
+		{
+		}
+		const_iterator cbegin() const
+		{
+			return const_iterator( m_first );
+		}
+		const_iterator cend() const
+		{
+			return const_iterator( m_last );
+		}
+		std::size_t size() const
+		{
+			return m_last - m_first;
+		}
+	};
+	typedef OutgoingLinks	outgoing_links;
+
+	/// gives access to the links like the link container of Graph
+	class LinkContainer
+	{
+		const SelfT	&m_graph;
+
+		public:
+		LinkContainer( const SelfT &graph ) : m_graph( graph )
+		{
+		}
+		LinkInfo operator [] ( link_key_type linkID ) const
+		{
+			return m_graph.getLinkInfo( linkID );
+		}
+		std::size_t size() const
+		{
+			return m_graph.getNumLinks();
+		}
+	};
+	typedef LinkContainer	link_container_type;
+
+	private:
+	/*
+		compares link indices by the key of the source graph
+	*/
+	class LinkKeyComparator
+	{
+		const LinkKeyT	*m_linkKeys;
+
+		public:
+		LinkKeyComparator( const LinkKeyT *linkKeys ) : m_linkKeys( linkKeys )
+		{
+		}
+		int operator () ( const uint32 &index1, const uint32 &index2 ) const
+		{
+			return gak::compare( m_linkKeys[index1], m_linkKeys[index2] );
+		}
+	};
+
+	MemoryMappedFile			m_file;
+	ArrayOfData					m_buffer;
+
+	const CompactGraphHeader	*m_header;
+	const NodeKeyT				*m_nodeKeys;
+	const NodeT					*m_nodes;
+	const uint32				*m_offsets;
+	const LinkKeyT				*m_linkKeys;
+	const uint32				*m_linkOrder;
+	const uint32				*m_linkStarts;
+	const uint32				*m_linkEnds;
+	const LinkT					*m_links;
+	std::size_t					m_numNodes, m_numLinks;
+
+	// no copy
+	CompactGraph( const CompactGraph & );
+	const CompactGraph &operator = ( const CompactGraph & );
+
+	static std::size_t align( std::size_t size )
+	{
+		return (size + 7) & ~std::size_t(7);
+	}
+	static CompactGraphLayout getLayout( std::size_t numNodes, std::size_t numLinks );
+	template <typename KeyT>
+	static std::size_t findKey( const KeyT *keys, std::size_t numKeys, const KeyT &key );
+	std::size_t findLink( const LinkKeyT &key ) const;
+
+	char *createBuffer( std::size_t numNodes, std::size_t numLinks );
+	void setPointers( const char *data );
+	bool checkIndices() const;
+
+	public:
+	/// creates an empty graph
+	CompactGraph()
+	{
+		clear();
+	}
+
+	/**
+		@brief compacts a graph, a previously built or opened graph is released
+		@param [in] graph the source graph, e.g. a Graph or a GeoGraph
+
+		Links with an end node not found in the graph are skipped.
+	*/
+	template <typename GraphT>
+	void build( const GraphT &graph );
+	/**
+		@brief maps a file written by writeToFile into memory
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be mapped
+		@exception BadHeaderError if the file is not a compact graph of this type or it is corrupted
+	*/
+	void open( const STRING &fileName );
+	/**
+		@brief writes the graph to a file
+		@param [in] fileName the name of the file
+		@exception OpenWriteError if the file could not be created
+		@exception WriteError if the file could not be written
+	*/
+	void writeToFile( const STRING &fileName ) const;
+	/// releases the memory or the file mapping
+	void clear()
+	{
+		m_file.close();
+		setPointers( createBuffer( 0, 0 ) );
+	}
+
+	/// returns true if the graph was loaded with open
+	bool isMapped() const
+	{
+		return m_file.isOpen();
+	}
+	/// returns the address of the data, i.e. the header followed by the arrays
+	const char *getData() const
+	{
+		return reinterpret_cast<const char *>( m_header );
+	}
+	/// returns the size of the data in bytes
+	std::size_t getDataSize() const
+	{
+		return std::size_t( m_header->m_fileSize );
+	}
+
+	std::size_t getNumNodes() const
+	{
+		return m_numNodes;
+	}
+	bool hasNode( const node_key_type &nodeID ) const
+	{
+		return nodeID < m_numNodes;
+	}
+	const node_type &getNode( const node_key_type &nodeID ) const
+	{
+		if( nodeID >= m_numNodes )
+		{
+			throw NodeNotFoundError();
+		}
+		return m_nodes[nodeID];
+	}
+	outgoing_links getOutgoing( const node_key_type &from ) const
+	{
+		if( from >= m_numNodes )
+		{
+			throw NodeNotFoundError();
+		}
+		return outgoing_links( m_offsets[from], m_offsets[from+1] );
+	}
+	/// returns the key of a node in the source graph
+	const NodeKeyT &getNodeKey( const node_key_type &nodeID ) const
+	{
+		if( nodeID >= m_numNodes )
+		{
+			throw NodeNotFoundError();
+		}
+		return m_nodeKeys[nodeID];
+	}
+	/**
+		@brief returns the index of a node of the source graph
+		@param [in] key the key in the source graph
+		@exception NodeNotFoundError if there is no such node
+	*/
+	node_key_type getNodeIndex( const NodeKeyT &key ) const
+	{
+		std::size_t	index = findKey( m_nodeKeys, m_numNodes, key );
+		if( index == Container::no_index )
+		{
+			throw NodeNotFoundError();
+		}
+		return node_key_type( index );
+	}
+
+	std::size_t getNumLinks() const
+	{
+		return m_numLinks;
+	}
+	bool hasLink( const link_key_type &linkID ) const
+	{
+		return linkID < m_numLinks;
+	}
+	const link_type &getLink( const link_key_type &linkID ) const
+	{
+		if( linkID >= m_numLinks )
+		{
+			throw LinkNotFoundError();
+		}
+		return m_links[linkID];
+	}
+	LinkInfo getLinkInfo( const link_key_type &linkID ) const
+	{
+		if( linkID >= m_numLinks )
+		{
+			throw LinkNotFoundError();
+		}
+		LinkInfo	linkInfo = { m_linkStarts[linkID], m_linkEnds[linkID], m_links[linkID] };
+		return linkInfo;
+	}
+	node_key_type getLinkStart( const link_key_type &linkID ) const
+	{
+		if( linkID >= m_numLinks )
+		{
+			throw LinkNotFoundError();
+		}
+		return m_linkStarts[linkID];
+	}
+	node_key_type getLinkEnd( const link_key_type &linkID ) const
+	{
+		if( linkID >= m_numLinks )
+		{
+			throw LinkNotFoundError();
+		}
+		return m_linkEnds[linkID];
+	}
+	link_container_type getLinks() const
+	{
+		return link_container_type( *this );
+	}
+	/// returns the key of a link in the source graph
+	const LinkKeyT &getLinkKey( const link_key_type &linkID ) const
+	{
+		if( linkID >= m_numLinks )
+		{
+			throw LinkNotFoundError();
+		}
+		return m_linkKeys[linkID];
+	}
+	/**
+		@brief returns the index of a link of the source graph
+		@param [in] key the key in the source graph
+		@exception LinkNotFoundError if there is no such link
+	*/
+	link_key_type getLinkIndex( const LinkKeyT &key ) const
+	{
+		std::size_t	index = findLink( key );
+		if( index == Container::no_index )
+		{
+			throw LinkNotFoundError();
+		}
+		return link_key_type( index );
+	}
+
+	node_key_types getNodes( const link_key_types &route ) const;
+	/// converts a route to the link keys of the source graph
+	Array<LinkKeyT> getLinkKeys( const link_key_types &route ) const;
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+CompactGraphLayout CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::getLayout(
+	std::size_t numNodes, std::size_t numLinks
+)
+{
+	CompactGraphLayout	layout;
+
+	layout.m_nodeKeys = align( sizeof( CompactGraphHeader ) );
+	layout.m_nodes = layout.m_nodeKeys + align( numNodes * sizeof( NodeKeyT ) );
+	layout.m_offsets = layout.m_nodes + align( numNodes * sizeof( NodeT ) );
+	layout.m_linkKeys = layout.m_offsets + align( (numNodes+1) * sizeof( uint32 ) );
+	layout.m_linkOrder = layout.m_linkKeys + align( numLinks * sizeof( LinkKeyT ) );
+	layout.m_linkStarts = layout.m_linkOrder + align( numLinks * sizeof( uint32 ) );
+	layout.m_linkEnds = layout.m_linkStarts + align( numLinks * sizeof( uint32 ) );
+	layout.m_links = layout.m_linkEnds + align( numLinks * sizeof( uint32 ) );
+	layout.m_size = layout.m_links + align( numLinks * sizeof( LinkT ) );
+
+	return layout;
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+	template <typename KeyT>
+std::size_t CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::findKey(
+	const KeyT *keys, std::size_t numKeys, const KeyT &key
+)
+{
+	std::size_t	first = 0;
+	std::size_t	last = numKeys;
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		int			compareResult = gak::compare( keys[middle], key );
+
+		if( !compareResult )
+		{
+/*@*/		return middle;
+		}
+		if( compareResult < 0 )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return Container::no_index;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+std::size_t CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::findLink( const LinkKeyT &key ) const
+{
+	// m_linkOrder contains the link indices sorted by their keys
+	std::size_t	first = 0;
+	std::size_t	last = m_numLinks;
+
+	while( first < last )
+	{
+		std::size_t	middle = first + (last-first)/2;
+		uint32		linkID = m_linkOrder[middle];
+		int			compareResult = gak::compare( m_linkKeys[linkID], key );
+
+		if( !compareResult )
+		{
+/*@*/		return linkID;
+		}
+		if( compareResult < 0 )
+		{
+			first = middle+1;
+		}
+		else
+		{
+			last = middle;
+		}
+	}
+	return Container::no_index;
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+char *CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::createBuffer(
+	std::size_t numNodes, std::size_t numLinks
+)
+{
+	CompactGraphLayout	layout = getLayout( numNodes, numLinks );
+
+	m_buffer.setSize( layout.m_size );
+	char	*data = m_buffer.getDataBuffer();
+	std::memset( data, 0, layout.m_size );
+
+	CompactGraphHeader	*header = reinterpret_cast<CompactGraphHeader *>( data );
+	header->m_magic = COMPACT_GRAPH_MAGIC;
+	header->m_version = COMPACT_GRAPH_VERSION;
+	header->m_headerSize = uint16( sizeof( CompactGraphHeader ) );
+	header->m_nodeKeySize = uint32( sizeof( NodeKeyT ) );
+	header->m_nodeSize = uint32( sizeof( NodeT ) );
+	header->m_linkKeySize = uint32( sizeof( LinkKeyT ) );
+	header->m_linkSize = uint32( sizeof( LinkT ) );
+	header->m_numNodes = numNodes;
+	header->m_numLinks = numLinks;
+	header->m_fileSize = layout.m_size;
+
+	return data;
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+void CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::setPointers( const char *data )
+{
+	m_header = reinterpret_cast<const CompactGraphHeader *>( data );
+	m_numNodes = std::size_t( m_header->m_numNodes );
+	m_numLinks = std::size_t( m_header->m_numLinks );
+
+	CompactGraphLayout	layout = getLayout( m_numNodes, m_numLinks );
+
+	m_nodeKeys = reinterpret_cast<const NodeKeyT *>( data + layout.m_nodeKeys );
+	m_nodes = reinterpret_cast<const NodeT *>( data + layout.m_nodes );
+	m_offsets = reinterpret_cast<const uint32 *>( data + layout.m_offsets );
+	m_linkKeys = reinterpret_cast<const LinkKeyT *>( data + layout.m_linkKeys );
+	m_linkOrder = reinterpret_cast<const uint32 *>( data + layout.m_linkOrder );
+	m_linkStarts = reinterpret_cast<const uint32 *>( data + layout.m_linkStarts );
+	m_linkEnds = reinterpret_cast<const uint32 *>( data + layout.m_linkEnds );
+	m_links = reinterpret_cast<const LinkT *>( data + layout.m_links );
+}
+
+/*
+	the indices of a mapped file are used without any further check: the
+	offsets must not decrease and must end with the number of links, the
+	start and end of each link must be a node and the link order must sort
+	the link keys, thus it is a permutation of the link indices.
+*/
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+bool CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::checkIndices() const
+{
+	if( m_offsets[0] != 0 || m_offsets[m_numNodes] != m_numLinks )
+	{
+/*@*/	return false;
+	}
+	for( std::size_t i=0; i<m_numNodes; ++i )
+	{
+		if( m_offsets[i] > m_offsets[i+1] )
+		{
+/*@*/		return false;
+		}
+	}
+	for( std::size_t i=0; i<m_numLinks; ++i )
+	{
+		if( m_linkStarts[i] >= m_numNodes || m_linkEnds[i] >= m_numNodes || m_linkOrder[i] >= m_numLinks )
+		{
+/*@*/		return false;
+		}
+		if( i && gak::compare( m_linkKeys[m_linkOrder[i-1]], m_linkKeys[m_linkOrder[i]] ) >= 0 )
+		{
+/*@*/		return false;
+		}
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+	template <typename GraphT>
+void CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::build( const GraphT &graph )
+{
+	doEnterFunction("CompactGraph::build");
+
+	typedef typename GraphT::node_container_type	node_container_type;
+	typedef typename GraphT::link_key_types			source_link_keys;
+
+	const node_container_type	&nodes = graph.getNodes();
+	const std::size_t			numNodes = nodes.size();
+
+	// the node keys are needed to count the links with a known end node
+	PODarray<NodeKeyT>	nodeKeys;
+	for(
+		typename node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+		it != endIT;
+		++it
+	)
+	{
+		assert( !nodeKeys.size() || gak::compare( nodeKeys[nodeKeys.size()-1], it->getKey() ) < 0 );
+		nodeKeys.addElement( it->getKey() );
+	}
+
+	std::size_t	numLinks = 0;
+	for(
+		typename node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const source_link_keys	&outgoing = it->getValue().m_outgoing;
+		for( std::size_t i=0; i<outgoing.size(); ++i )
+		{
+			const NodeKeyT	&endNodeID = graph.getLinkEnd( outgoing[i] );
+			if( findKey( nodeKeys.getDataBuffer(), numNodes, endNodeID ) != Container::no_index )
+			{
+				++numLinks;
+			}
+		}
+	}
+
+	m_file.close();
+	char				*data = createBuffer( numNodes, numLinks );
+	CompactGraphLayout	layout = getLayout( numNodes, numLinks );
+
+	NodeKeyT	*nodeKeysOut = reinterpret_cast<NodeKeyT *>( data + layout.m_nodeKeys );
+	NodeT		*nodesOut = reinterpret_cast<NodeT *>( data + layout.m_nodes );
+	uint32		*offsetsOut = reinterpret_cast<uint32 *>( data + layout.m_offsets );
+	LinkKeyT	*linkKeysOut = reinterpret_cast<LinkKeyT *>( data + layout.m_linkKeys );
+	uint32		*linkStartsOut = reinterpret_cast<uint32 *>( data + layout.m_linkStarts );
+	uint32		*linkEndsOut = reinterpret_cast<uint32 *>( data + layout.m_linkEnds );
+	LinkT		*linksOut = reinterpret_cast<LinkT *>( data + layout.m_links );
+
+	uint32		nodeID = 0;
+	uint32		linkID = 0;
+	for(
+		typename node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+		it != endIT;
+		++it, ++nodeID
+	)
+	{
+		nodeKeysOut[nodeID] = it->getKey();
+		nodesOut[nodeID] = it->getValue().m_node;
+		offsetsOut[nodeID] = linkID;
+
+		const source_link_keys	&outgoing = it->getValue().m_outgoing;
+		for( std::size_t i=0; i<outgoing.size(); ++i )
+		{
+			const typename GraphT::LinkInfo	&linkInfo = graph.getLinkInfo( outgoing[i] );
+			std::size_t	endNodeID = findKey( nodeKeys.getDataBuffer(), numNodes, linkInfo.m_endNodeID );
+			if( endNodeID != Container::no_index )
+			{
+				linkKeysOut[linkID] = outgoing[i];
+				linkStartsOut[linkID] = nodeID;
+				linkEndsOut[linkID] = uint32( endNodeID );
+				linksOut[linkID] = linkInfo.m_link;
+				++linkID;
+			}
+		}
+	}
+	offsetsOut[numNodes] = linkID;
+	assert( linkID == numLinks );
+
+	// the link order is used by getLinkIndex to find the links by their keys
+	PODarray<uint32>	linkOrder;
+	linkOrder.setSize( numLinks );
+	for( std::size_t i=0; i<numLinks; ++i )
+	{
+		linkOrder[i] = uint32( i );
+	}
+	if( numLinks )
+	{
+		linkOrder.sort( LinkKeyComparator( linkKeysOut ) );
+		std::memcpy( data + layout.m_linkOrder, linkOrder.getDataBuffer(), numLinks * sizeof( uint32 ) );
+	}
+
+	setPointers( data );
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+void CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::open( const STRING &fileName )
+{
+	doEnterFunction("CompactGraph::open");
+
+	clear();
+	m_file.open( fileName );
+
+	const char					*data = m_file.getData();
+	std::size_t					fileSize = m_file.size();
+	const CompactGraphHeader	*header = reinterpret_cast<const CompactGraphHeader *>( data );
+
+	if( fileSize < sizeof( CompactGraphHeader )
+	|| header->m_magic != COMPACT_GRAPH_MAGIC
+	|| header->m_version != COMPACT_GRAPH_VERSION
+	|| header->m_headerSize != sizeof( CompactGraphHeader )
+	|| header->m_nodeKeySize != sizeof( NodeKeyT )
+	|| header->m_nodeSize != sizeof( NodeT )
+	|| header->m_linkKeySize != sizeof( LinkKeyT )
+	|| header->m_linkSize != sizeof( LinkT )
+	|| header->m_fileSize != fileSize
+	|| getLayout( std::size_t( header->m_numNodes ), std::size_t( header->m_numLinks ) ).m_size != fileSize )
+	{
+		m_file.close();
+/*@*/	throw BadHeaderError( fileName );
+	}
+
+	setPointers( data );
+	if( !checkIndices() )
+	{
+		clear();
+/*@*/	throw BadHeaderError( fileName );
+	}
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+void CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::writeToFile( const STRING &fileName ) const
+{
+	std::ofstream	stream( fileName, std::ios_base::binary );
+
+	if( !stream )
+	{
+/*@*/	throw OpenWriteError( fileName );
+	}
+
+	stream.write( getData(), std::streamsize( getDataSize() ) );
+	if( !stream )
+	{
+/*@*/	throw WriteError( fileName );
+	}
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+typename CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::node_key_types
+CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::getNodes( const link_key_types &route ) const
+{
+	node_key_types	result;
+	node_key_type	start, end = node_key_type();
+	bool			hasEnd = false;
+
+	for(
+		typename link_key_types::const_iterator it = route.cbegin(), endIT = route.cend();
+		it != endIT;
+		++it
+	)
+	{
+		link_key_type	linkID = *it;
+
+		start = getLinkStart( linkID );
+		if( hasEnd && start != end )
+		{
+			throw IndexError();
+		}
+		result.addElement( start );
+		end = getLinkEnd( linkID );
+		hasEnd = true;
+	}
+	if( hasEnd )
+	{
+		result.addElement( end );
+	}
+
+	return result;
+}
+
+template <typename NodeT, typename LinkT, typename NodeKeyT, typename LinkKeyT>
+Array<LinkKeyT> CompactGraph<NodeT, LinkT, NodeKeyT, LinkKeyT>::getLinkKeys( const link_key_types &route ) const
+{
+	Array<LinkKeyT>	linkKeys;
+
+	for( std::size_t i=0; i<route.size(); ++i )
+	{
+		linkKeys.addElement( getLinkKey( route[i] ) );
+	}
+
+	return linkKeys;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_COMPACT_GRAPH_H
@@ -0,0 +1,984 @@
+/*
+		Project:		GAKLIB
+		Module:			contractionHierarchy.h
+		Description:	Contraction hierarchy for fast shortest path queries
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_CONTRACTION_HIERARCHY_H
+#define GAK_CONTRACTION_HIERARCHY_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <limits>
+
+#include <gak/graph.h>
+#include <gak/hashMap.h>
+#include <gak/iostream.h>
+#include <gak/priorityQueue.h>
+#include <gak/stack.h>
+#include <gak/routing.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the magic number of a contraction hierarchy file
+const uint32 CONTRACTION_HIERARCHY_MAGIC = 0x48434B47;		// GKCH
+/// the current version of the contraction hierarchy file format
+const uint16 CONTRACTION_HIERARCHY_VERSION = 1;
+/// the max. number of nodes settled by one witness search while contracting a node
+const size_t CONTRACTION_WITNESS_LIMIT = 500;
+/// marks an edge that is not a shortcut or a node that was reached without an edge
+const uint32 CONTRACTION_NO_EDGE = uint32(-1);
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a link or a shortcut of a ContractionHierarchy
+
+	Nodes are identified by their dense index in the hierarchy. A shortcut
+	replaces the two edges m_first and m_second, it is unpacked recursively
+	to get the links of a route.
+*/
+struct ContractionEdge
+{
+	uint32	m_from, m_to;
+	uint32	m_first, m_second;
+	double	m_cost;
+
+	bool isShortcut() const
+	{
+		return m_first != CONTRACTION_NO_EDGE;
+	}
+};
+
+template <>
+struct is_binary<ContractionEdge> : public internal::integral_constant<true>
+{
+};
+
+template <>
+inline void toBinaryStream( std::ostream &stream, const ContractionEdge &value )
+{
+	binaryToBinaryStream( stream, value );
+}
+
+template <>
+inline void fromBinaryStream( std::istream &stream, ContractionEdge *value )
+{
+	binaryFromBinaryStream( stream, value );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a preprocessed graph for fast shortest path queries
+
+	@ref build contracts the nodes of a Graph (or GeoGraph) one after another
+	in the order of their importance. When a node is contracted, a shortcut
+	is added between each pair of its neighbours, unless a witness search
+	finds a path between them that does not need the node and is not more
+	expensive. Thus each shortest path of the graph is also found by a search
+	that uses edges leading to more important nodes, only.
+
+	@ref route runs a forward search from the start and a backward search
+	from the destination in these upward graphs. Both searches visit a few
+	hundred nodes, even on graphs with millions of nodes. The shortcuts of the
+	best route are unpacked to the links of the original graph, thus the
+	result is the same RouteResult returned by AstarRouting.
+
+	The hierarchy is built for one cost type. It does not need the graph for
+	queries and can be written to a binary file with @ref writeToFile.
+
+	@tparam GraphT the graph type, e.g. Graph, GeoGraph or BasicOpenStreetMap
+	@see AstarRouting
+*/
+template <typename GraphT>
+class ContractionHierarchy
+{
+	public:
+	typedef GraphT									graph_t;
+	typedef typename graph_t::node_key_type			node_key_type;
+	typedef typename graph_t::link_key_type			link_key_type;
+	typedef typename graph_t::link_key_types		link_key_types;
+	typedef typename Routing<GraphT>::RouteResult	RouteResult;
+
+	private:
+	typedef HeapQueue<uint32, double, PriorityExtractor<uint32, double> >	NodeQueue;
+	typedef PODarray<uint32>												Indices;
+	typedef PODarray<ContractionEdge>										Edges;
+
+	struct SearchLabel
+	{
+		double	m_cost;
+		uint32	m_edge;			// the edge used to reach the node
+		size_t	m_handle;		// the handle in the queue while the node is open
+	};
+	typedef HashMap<uint32, SearchLabel>	SearchLabels;
+
+	struct SearchDirection
+	{
+		NodeQueue		m_queue;
+		SearchLabels	m_labels;
+		const Indices	&m_offsets;
+		const Indices	&m_edges;
+		bool			m_forward;
+
+		SearchDirection( const Indices &offsets, const Indices &edges, bool forward )
+		: m_offsets( offsets ), m_edges( edges ), m_forward( forward )
+		{
+		}
+		double getTopCost() const
+		{
+			return m_labels[m_queue.top()].m_cost;
+		}
+	};
+
+	struct BuildState
+	{
+		Array<Indices>		m_outgoing, m_incoming;
+		PODarray<bool>		m_contracted;
+		PODarray<uint32>	m_contractedNeighbours;
+	};
+
+	Array<node_key_type>			m_nodeKeys;
+	Array<link_key_type>			m_linkKeys;		// the keys of the original edges
+	Edges							m_edges;		// the original edges first, then the shortcuts
+	Indices							m_upOffsets, m_upEdges;			// edges to more important nodes by start
+	Indices							m_downOffsets, m_downEdges;		// edges from more important nodes by end
+	HashMap<node_key_type, uint32>	m_nodeIndices;
+
+	static void addLabel( SearchLabels *labels, NodeQueue *queue, uint32 node, double cost, uint32 edge );
+	static bool updateLabel( SearchLabels *labels, NodeQueue *queue, uint32 node, double cost, uint32 edge );
+
+	uint32 addEdge( BuildState &state, uint32 from, uint32 to, double cost, uint32 first, uint32 second );
+	bool isCheapest( const BuildState &state, const Indices &edges, uint32 edge, bool incoming ) const;
+	void witnessSearch( const BuildState &state, uint32 source, uint32 via, double maxCost, SearchLabels *labels ) const;
+	size_t contractNode( BuildState &state, uint32 node, bool simulate );
+	double getImportance( BuildState &state, uint32 node );
+	void buildSearchGraph( const Indices &ranks );
+	void buildNodeIndices();
+	static void checkAdjacency( const Indices &offsets, const Indices &edges, size_t numNodes, size_t numEdges );
+	void checkIntegrity() const;
+
+	void settleNode( SearchDirection &direction, const SearchDirection &other, double *bestCost, uint32 *meetingNode ) const;
+	void unpackEdge( uint32 edge, link_key_types *links, double *cost ) const;
+
+	uint32 getNodeIndex( const node_key_type &nodeID ) const
+	{
+		size_t	index = m_nodeIndices.getElementIndex( nodeID );
+		if( index == m_nodeIndices.no_index )
+		{
+			throw NodeNotFoundError();
+		}
+		return m_nodeIndices.getValueAt( index );
+	}
+
+	public:
+	/**
+		@brief contracts all nodes of a graph
+		@param [in] graph the graph to preprocess
+		@param [in] costType the cost type passed to getLinkCost
+	*/
+	template <typename CostT>
+	void build( const graph_t &graph, CostT costType );
+
+	/**
+		@brief searches the cheapest route
+		@param [in] from the start node
+		@param [in] to the destination node
+		@return the links and the cost of the route, if there is one
+		@exception NodeNotFoundError if from or to are not part of the hierarchy
+	*/
+	Optional<RouteResult> route( const node_key_type &from, const node_key_type &to ) const;
+
+	/// @return the number of nodes
+	size_t getNumNodes() const
+	{
+		return m_nodeKeys.size();
+	}
+	/// @return the number of links of the original graph
+	size_t getNumLinks() const
+	{
+		return m_linkKeys.size();
+	}
+	/// @return the number of shortcuts added by build
+	size_t getNumShortcuts() const
+	{
+		return m_edges.size() - m_linkKeys.size();
+	}
+
+	void clear()
+	{
+		m_nodeKeys.clear();
+		m_linkKeys.clear();
+		m_edges.clear();
+		m_upOffsets.clear();
+		m_upEdges.clear();
+		m_downOffsets.clear();
+		m_downEdges.clear();
+		m_nodeIndices.clear();
+	}
+
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		m_nodeKeys.toBinaryStream( stream );
+		m_linkKeys.toBinaryStream( stream );
+		m_edges.toBinaryStream( stream );
+		m_upOffsets.toBinaryStream( stream );
+		m_upEdges.toBinaryStream( stream );
+		m_downOffsets.toBinaryStream( stream );
+		m_downEdges.toBinaryStream( stream );
+	}
+	void fromBinaryStream( std::istream &stream )
+	{
+		doEnterFunction("ContractionHierarchy::fromBinaryStream");
+		m_nodeKeys.fromBinaryStream( stream );
+		m_linkKeys.fromBinaryStream( stream );
+		m_edges.fromBinaryStream( stream );
+		m_upOffsets.fromBinaryStream( stream );
+		m_upEdges.fromBinaryStream( stream );
+		m_downOffsets.fromBinaryStream( stream );
+		m_downEdges.fromBinaryStream( stream );
+		checkIntegrity();
+		buildNodeIndices();
+	}
+
+	/**
+		@brief writes the hierarchy to a binary file
+		@param [in] fileName the name of the new file
+		@exception OpenWriteError if the file could not be created
+	*/
+	void writeToFile( const STRING &fileName ) const
+	{
+		writeToBinaryFile(
+			fileName, *this,
+			CONTRACTION_HIERARCHY_MAGIC, CONTRACTION_HIERARCHY_VERSION, owmOverwrite
+		);
+	}
+	/**
+		@brief reads a hierarchy written by writeToFile
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be opened
+		@exception BadHeaderError if the file is not a contraction hierarchy
+		@exception ReadError if the file is corrupted
+	*/
+	void readFromFile( const STRING &fileName )
+	{
+		readFromBinaryFile(
+			fileName, this,
+			CONTRACTION_HIERARCHY_MAGIC, CONTRACTION_HIERARCHY_VERSION, true
+		);
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::addLabel(
+	SearchLabels *labels, NodeQueue *queue, uint32 node, double cost, uint32 edge
+)
+{
+	SearchLabel	&label = (*labels)[node];
+
+	label.m_cost = cost;
+	label.m_edge = edge;
+	label.m_handle = queue->push( node, -cost );
+}
+
+template <typename GraphT>
+bool ContractionHierarchy<GraphT>::updateLabel(
+	SearchLabels *labels, NodeQueue *queue, uint32 node, double cost, uint32 edge
+)
+{
+	size_t	index = labels->getElementIndex( node );
+	if( index == labels->no_index )
+	{
+		addLabel( labels, queue, node, cost, edge );
+/*@*/	return true;
+	}
+
+	SearchLabel	&label = labels->getValueAt( index );
+	if( label.m_handle != Container::no_index && cost < label.m_cost )
+	{
+		label.m_cost = cost;
+		label.m_edge = edge;
+		queue->changePriority( label.m_handle, -cost );
+/*@*/	return true;
+	}
+
+	return false;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <typename GraphT>
+uint32 ContractionHierarchy<GraphT>::addEdge(
+	BuildState &state, uint32 from, uint32 to, double cost, uint32 first, uint32 second
+)
+{
+	uint32			edgeIndex = uint32(m_edges.size());
+	ContractionEdge	&edge = m_edges.createElement();
+
+	edge.m_from = from;
+	edge.m_to = to;
+	edge.m_first = first;
+	edge.m_second = second;
+	edge.m_cost = cost;
+
+	state.m_outgoing[from].addElement( edgeIndex );
+	state.m_incoming[to].addElement( edgeIndex );
+
+	return edgeIndex;
+}
+
+/*
+	parallel edges between the same nodes need one shortcut, only
+*/
+template <typename GraphT>
+bool ContractionHierarchy<GraphT>::isCheapest(
+	const BuildState &state, const Indices &edges, uint32 edge, bool incoming
+) const
+{
+	const ContractionEdge	&candidate = m_edges[edge];
+	uint32					neighbour = incoming ? candidate.m_from : candidate.m_to;
+
+	for(
+		typename Indices::const_iterator it = edges.cbegin(), endIT = edges.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const ContractionEdge	&other = m_edges[*it];
+		if( *it != edge && (incoming ? other.m_from : other.m_to) == neighbour && !state.m_contracted[neighbour] )
+		{
+			if( other.m_cost < candidate.m_cost || (other.m_cost == candidate.m_cost && *it < edge) )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::witnessSearch(
+	const BuildState &state, uint32 source, uint32 via, double maxCost, SearchLabels *labels
+) const
+{
+	NodeQueue	queue;
+	size_t		numSettled = 0;
+
+	labels->clear();
+	addLabel( labels, &queue, source, 0, CONTRACTION_NO_EDGE );
+
+	while( queue.size() && numSettled < CONTRACTION_WITNESS_LIMIT )
+	{
+		uint32		current = queue.pop();
+		SearchLabel	&label = (*labels)[current];
+		double		cost = label.m_cost;
+
+		label.m_handle = Container::no_index;
+		if( cost > maxCost )
+		{
+			break;
+		}
+		++numSettled;
+
+		const Indices &outgoing = state.m_outgoing[current];
+		for(
+			typename Indices::const_iterator it = outgoing.cbegin(), endIT = outgoing.cend();
+			it != endIT;
+			++it
+		)
+		{
+			const ContractionEdge	&edge = m_edges[*it];
+			double					newCost = cost + edge.m_cost;
+
+			if( edge.m_to != via && !state.m_contracted[edge.m_to] && newCost <= maxCost )
+			{
+				updateLabel( labels, &queue, edge.m_to, newCost, *it );
+			}
+		}
+	}
+}
+
+template <typename GraphT>
+size_t ContractionHierarchy<GraphT>::contractNode( BuildState &state, uint32 node, bool simulate )
+{
+	const Indices	&incoming = state.m_incoming[node];
+	const Indices	&outgoing = state.m_outgoing[node];
+	size_t			numShortcuts = 0;
+	double			maxOutCost = 0;
+	SearchLabels	witnesses;
+
+	for(
+		typename Indices::const_iterator it = outgoing.cbegin(), endIT = outgoing.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const ContractionEdge &edge = m_edges[*it];
+		if( !state.m_contracted[edge.m_to] && edge.m_cost > maxOutCost )
+		{
+			maxOutCost = edge.m_cost;
+		}
+	}
+
+	// the adjacency of node does not change, but m_edges grows
+	for( size_t i=0; i<incoming.size(); ++i )
+	{
+		uint32	inEdge = incoming[i];
+		uint32	source = m_edges[inEdge].m_from;
+		double	inCost = m_edges[inEdge].m_cost;
+
+		if( state.m_contracted[source] || !isCheapest( state, incoming, inEdge, true ) )
+		{
+/*^*/		continue;
+		}
+
+		witnessSearch( state, source, node, inCost + maxOutCost, &witnesses );
+		for( size_t j=0; j<outgoing.size(); ++j )
+		{
+			uint32	outEdge = outgoing[j];
+			uint32	target = m_edges[outEdge].m_to;
+			double	viaCost = inCost + m_edges[outEdge].m_cost;
+
+			if(
+				target == source || state.m_contracted[target]
+				|| !isCheapest( state, outgoing, outEdge, false )
+			)
+			{
+/*^*/			continue;
+			}
+
+			size_t	witness = witnesses.getElementIndex( target );
+			if( witness != witnesses.no_index && witnesses.getValueAt( witness ).m_cost <= viaCost )
+			{
+/*^*/			continue;
+			}
+
+			++numShortcuts;
+			if( !simulate )
+			{
+				addEdge( state, source, target, viaCost, inEdge, outEdge );
+			}
+		}
+	}
+
+	return numShortcuts;
+}
+
+/*
+	the edge difference of the contraction plus the number of neighbours
+	contracted already, this spreads the contraction over the whole graph
+*/
+template <typename GraphT>
+double ContractionHierarchy<GraphT>::getImportance( BuildState &state, uint32 node )
+{
+	size_t	numRemoved = 0;
+
+	for( size_t i=0; i<state.m_incoming[node].size(); ++i )
+	{
+		numRemoved += !state.m_contracted[m_edges[state.m_incoming[node][i]].m_from];
+	}
+	for( size_t i=0; i<state.m_outgoing[node].size(); ++i )
+	{
+		numRemoved += !state.m_contracted[m_edges[state.m_outgoing[node][i]].m_to];
+	}
+
+	return double(contractNode( state, node, true ))
+		- double(numRemoved)
+		+ double(state.m_contractedNeighbours[node]);
+}
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::buildSearchGraph( const Indices &ranks )
+{
+	const size_t	numNodes = m_nodeKeys.size();
+
+	m_upOffsets.clear();
+	m_downOffsets.clear();
+	m_upOffsets.setSize( numNodes+1 );
+	m_downOffsets.setSize( numNodes+1 );
+	for( size_t i=0; i<=numNodes; ++i )
+	{
+		m_upOffsets[i] = m_downOffsets[i] = 0;
+	}
+
+	// count the edges of each node, then make the counts to offsets
+	for( size_t i=0; i<m_edges.size(); ++i )
+	{
+		const ContractionEdge &edge = m_edges[i];
+		if( ranks[edge.m_to] > ranks[edge.m_from] )
+		{
+			++m_upOffsets[edge.m_from+1];
+		}
+		else
+		{
+			++m_downOffsets[edge.m_to+1];
+		}
+	}
+	for( size_t i=0; i<numNodes; ++i )
+	{
+		m_upOffsets[i+1] += m_upOffsets[i];
+		m_downOffsets[i+1] += m_downOffsets[i];
+	}
+
+	Indices	upPos = m_upOffsets;
+	Indices	downPos = m_downOffsets;
+
+	m_upEdges.clear();
+	m_downEdges.clear();
+	m_upEdges.setSize( m_upOffsets[numNodes] );
+	m_downEdges.setSize( m_downOffsets[numNodes] );
+	for( size_t i=0; i<m_edges.size(); ++i )
+	{
+		const ContractionEdge &edge = m_edges[i];
+		if( ranks[edge.m_to] > ranks[edge.m_from] )
+		{
+			m_upEdges[upPos[edge.m_from]++] = uint32(i);
+		}
+		else
+		{
+			m_downEdges[downPos[edge.m_to]++] = uint32(i);
+		}
+	}
+}
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::buildNodeIndices()
+{
+	m_nodeIndices.clear();
+	for( size_t i=0; i<m_nodeKeys.size(); ++i )
+	{
+		m_nodeIndices[m_nodeKeys[i]] = uint32(i);
+	}
+}
+
+/*
+	the offsets must start at 0, must not decrease and the last one must
+	be the number of edges. All edges must be valid. A hierarchy that was
+	never built has no offsets at all.
+*/
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::checkAdjacency(
+	const Indices &offsets, const Indices &edges, size_t numNodes, size_t numEdges
+)
+{
+	if( !numNodes && !offsets.size() && !edges.size() )
+	{
+/*@*/	return;
+	}
+	if( offsets.size() != numNodes+1 || offsets[0] != 0 || offsets[numNodes] != edges.size() )
+	{
+		throw ReadError();
+	}
+	for( size_t i=0; i<numNodes; ++i )
+	{
+		if( offsets[i] > offsets[i+1] )
+		{
+			throw ReadError();
+		}
+	}
+	for( size_t i=0; i<edges.size(); ++i )
+	{
+		if( edges[i] >= numEdges )
+		{
+			throw ReadError();
+		}
+	}
+}
+
+/*
+	a stream read from a file must not crash the queries: all indices must
+	be in range and a shortcut may only replace edges that are older than
+	itself, thus unpacking a shortcut terminates.
+*/
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::checkIntegrity() const
+{
+	const size_t	numNodes = m_nodeKeys.size();
+	const size_t	numLinks = m_linkKeys.size();
+	const size_t	numEdges = m_edges.size();
+
+	if( numLinks > numEdges || numEdges >= CONTRACTION_NO_EDGE )
+	{
+		throw ReadError();
+	}
+	for( size_t i=0; i<numEdges; ++i )
+	{
+		const ContractionEdge	&edge = m_edges[i];
+		if( edge.m_from >= numNodes || edge.m_to >= numNodes )
+		{
+			throw ReadError();
+		}
+		if( i < numLinks )
+		{
+			if( edge.isShortcut() )
+			{
+				throw ReadError();
+			}
+		}
+		else if( edge.m_first >= i || edge.m_second >= i )
+		{
+			throw ReadError();
+		}
+	}
+	checkAdjacency( m_upOffsets, m_upEdges, numNodes, numEdges );
+	checkAdjacency( m_downOffsets, m_downEdges, numNodes, numEdges );
+}
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::settleNode(
+	SearchDirection &direction, const SearchDirection &other, double *bestCost, uint32 *meetingNode
+) const
+{
+	uint32		current = direction.m_queue.pop();
+	SearchLabel	&label = direction.m_labels[current];
+	double		cost = label.m_cost;
+
+	label.m_handle = Container::no_index;
+
+	size_t	otherIndex = other.m_labels.getElementIndex( current );
+	if( otherIndex != other.m_labels.no_index )
+	{
+		double	totalCost = cost + other.m_labels.getValueAt( otherIndex ).m_cost;
+		if( totalCost < *bestCost )
+		{
+			*bestCost = totalCost;
+			*meetingNode = current;
+		}
+	}
+
+	for(
+		uint32 i = direction.m_offsets[current], endI = direction.m_offsets[current+1];
+		i < endI;
+		++i
+	)
+	{
+		uint32					edgeIndex = direction.m_edges[i];
+		const ContractionEdge	&edge = m_edges[edgeIndex];
+
+		updateLabel(
+			&direction.m_labels, &direction.m_queue,
+			direction.m_forward ? edge.m_to : edge.m_from,
+			cost + edge.m_cost, edgeIndex
+		);
+	}
+}
+
+template <typename GraphT>
+void ContractionHierarchy<GraphT>::unpackEdge( uint32 edge, link_key_types *links, double *cost ) const
+{
+	Stack<uint32>	edges;
+
+	edges.push( edge );
+	while( edges.size() )
+	{
+		uint32					index = edges.pop();
+		const ContractionEdge	&current = m_edges[index];
+		if( current.isShortcut() )
+		{
+			edges.push( current.m_second );
+			edges.push( current.m_first );
+		}
+		else
+		{
+			links->addElement( m_linkKeys[index] );
+			*cost += current.m_cost;
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename GraphT>
+	template <typename CostT>
+void ContractionHierarchy<GraphT>::build( const graph_t &graph, CostT costType )
+{
+	doEnterFunctionEx( gakLogging::llInfo, "ContractionHierarchy::build" );
+
+	typedef typename graph_t::node_container_type	node_container_type;
+	typedef typename graph_t::link_container_type	link_container_type;
+
+	BuildState	state;
+
+	clear();
+
+	const node_container_type &nodes = graph.getNodes();
+	for(
+		typename node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+		it != endIT;
+		++it
+	)
+	{
+		m_nodeKeys.addElement( it->getKey() );
+	}
+	buildNodeIndices();
+
+	const size_t	numNodes = m_nodeKeys.size();
+	state.m_outgoing.setSize( numNodes );
+	state.m_incoming.setSize( numNodes );
+	state.m_contracted.setSize( numNodes );
+	state.m_contractedNeighbours.setSize( numNodes );
+	for( size_t i=0; i<numNodes; ++i )
+	{
+		state.m_contracted[i] = false;
+		state.m_contractedNeighbours[i] = 0;
+	}
+
+	// the original links, links to unknown nodes and loops are never part of a route
+	const link_container_type &links = graph.getLinks();
+	for(
+		typename link_container_type::const_iterator it = links.cbegin(), endIT = links.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const typename graph_t::LinkInfo	&linkInfo = it->getValue();
+		size_t								from = m_nodeIndices.getElementIndex( linkInfo.m_startNodeID );
+		size_t								to = m_nodeIndices.getElementIndex( linkInfo.m_endNodeID );
+
+		if( from != m_nodeIndices.no_index && to != m_nodeIndices.no_index && from != to )
+		{
+			addEdge(
+				state,
+				m_nodeIndices.getValueAt( from ), m_nodeIndices.getValueAt( to ),
+				getLinkCost( linkInfo.m_link, costType ),
+				CONTRACTION_NO_EDGE, CONTRACTION_NO_EDGE
+			);
+			m_linkKeys.addElement( it->getKey() );
+		}
+	}
+
+	// contract the nodes, the importance of a node is updated lazy
+	NodeQueue			queue;
+	PODarray<size_t>	handles;
+	Indices				ranks;
+	Indices				neighbours;
+	uint32				rank = 0;
+
+	handles.setSize( numNodes );
+	ranks.setSize( numNodes );
+	for( uint32 node=0; node<numNodes; ++node )
+	{
+		handles[node] = queue.push( node, -getImportance( state, node ) );
+	}
+	while( queue.size() )
+	{
+		uint32	node = queue.pop();
+		double	importance = getImportance( state, node );
+
+		if( queue.size() && -importance < queue.getPriority( handles[queue.top()] ) )
+		{
+			handles[node] = queue.push( node, -importance );
+/*^*/		continue;
+		}
+
+		contractNode( state, node, false );
+		state.m_contracted[node] = true;
+		ranks[node] = rank++;
+
+		neighbours.clear();
+		for( size_t i=0; i<state.m_incoming[node].size(); ++i )
+		{
+			neighbours.addElement( m_edges[state.m_incoming[node][i]].m_from );
+		}
+		for( size_t i=0; i<state.m_outgoing[node].size(); ++i )
+		{
+			neighbours.addElement( m_edges[state.m_outgoing[node][i]].m_to );
+		}
+		neighbours.sort( FixedComparator<uint32>() );
+		for( size_t i=0; i<neighbours.size(); ++i )
+		{
+			uint32	neighbour = neighbours[i];
+			if( (!i || neighbours[i-1] != neighbour) && !state.m_contracted[neighbour] )
+			{
+				++state.m_contractedNeighbours[neighbour];
+				queue.changePriority( handles[neighbour], -getImportance( state, neighbour ) );
+			}
+		}
+	}
+
+	buildSearchGraph( ranks );
+}
+
+template <typename GraphT>
+Optional<typename ContractionHierarchy<GraphT>::RouteResult>
+ContractionHierarchy<GraphT>::route( const node_key_type &from, const node_key_type &to ) const
+{
+	doEnterFunction( "ContractionHierarchy::route" );
+
+	Optional<RouteResult>	result;
+	uint32					source = getNodeIndex( from );
+	uint32					target = getNodeIndex( to );
+	SearchDirection			forward( m_upOffsets, m_upEdges, true );
+	SearchDirection			backward( m_downOffsets, m_downEdges, false );
+	double					bestCost = std::numeric_limits<double>::max();
+	uint32					meetingNode = CONTRACTION_NO_EDGE;
+
+	addLabel( &forward.m_labels, &forward.m_queue, source, 0, CONTRACTION_NO_EDGE );
+	addLabel( &backward.m_labels, &backward.m_queue, target, 0, CONTRACTION_NO_EDGE );
+
+	// always continue with the direction that has the cheaper node
+	while( forward.m_queue.size() || backward.m_queue.size() )
+	{
+		bool	useForward = !backward.m_queue.size() || (
+			forward.m_queue.size() && forward.getTopCost() <= backward.getTopCost()
+		);
+		SearchDirection	&direction = useForward ? forward : backward;
+
+		if( direction.getTopCost() >= bestCost )
+		{
+			break;
+		}
+		settleNode( direction, useForward ? backward : forward, &bestCost, &meetingNode );
+	}
+
+	if( meetingNode != CONTRACTION_NO_EDGE )
+	{
+		Indices	upEdges, downEdges;
+
+		for( uint32 node = meetingNode; node != source; )
+		{
+			uint32	edge = forward.m_labels[node].m_edge;
+			upEdges.addElement( edge );
+			node = m_edges[edge].m_from;
+		}
+		for( uint32 node = meetingNode; node != target; )
+		{
+			uint32	edge = backward.m_labels[node].m_edge;
+			downEdges.addElement( edge );
+			node = m_edges[edge].m_to;
+		}
+
+		// sum the costs of the links like AstarRouting does
+		RouteResult	&foundRoute = result.setDefault().get();
+		foundRoute.cost = 0;
+		for( size_t i=upEdges.size(); i>0; --i )
+		{
+			unpackEdge( upEdges[i-1], &foundRoute.links, &foundRoute.cost );
+		}
+		for( size_t i=0; i<downEdges.size(); ++i )
+		{
+			unpackEdge( downEdges[i], &foundRoute.links, &foundRoute.cost );
+		}
+	}
+
+	return result;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_CONTRACTION_HIERARCHY_H
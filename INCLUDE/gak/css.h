@@ -591,6 +591,19 @@ class SelectorPart
 		this->pseudoClass = pseudoClass;
 	}
 
+	const STRING &getTag( void ) const
+	{
+		return tag;
+	}
+	const STRING &getId( void ) const
+	{
+		return id;
+	}
+	const ArrayOfStrings &getCssClasses( void ) const
+	{
+		return cssClasses;
+	}
+
 	bool match( xml::Element *theElement ) const;
 
 	unsigned long getSpecification( void ) const
@@ -134,6 +134,12 @@ class FieldSet : public UnorderedMap<Named_Field>
 {
 	public:
 	void updateField( const char *name, const DynamicVar &value );
+	/// the same as above but a new field shares the buffer of name
+	void updateField( const STRING &name, const DynamicVar &value )
+	{
+		Named_Field	&theField = getElementByKey( name );
+		theField.setValue( value );
+	}
 	void addField( const char *name, const DynamicVar &value )
 	{
 		Named_Field		&elem = createElement();
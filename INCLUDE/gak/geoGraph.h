@@ -45,6 +45,7 @@
 #include <gak/geometry.h>
 #include <gak/gps.h>
 #include <gak/optional.h>
+#include <gak/spatialIndex.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -115,51 +116,15 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 
 	typedef LayerKeyT							layer_key_type;
 
-#if defined( _MSC_VER ) || defined( __GNUC__ )
-#	pragma pack(push, 2)	// disable alignment bytes
-#endif
-	struct PositionValue
-	{
-		float		circleDegree;
-		NodeKeyT	nodeID;
-
-		PositionValue( float circleDegree = 0, NodeKeyT nodeID = NodeKeyT() )
-		: circleDegree(circleDegree), nodeID(nodeID)
-		{
-			/*
-				check we can write each entry alone and read an array with one function call, only
-			*/
-			assert( sizeof(*this) == sizeof(float) + sizeof(NodeKeyT));
-		}
-		int compare( const PositionValue &other ) const
-		{
-			int compareResult = gak::compare( circleDegree, other.circleDegree );
-			if( !compareResult )
-			{
-				compareResult = gak::compare( nodeID, other.nodeID );
-			}
-			return compareResult;
-		}
-		void toBinaryStream( std::ostream &stream ) const
-		{
-			gak::toBinaryStream( stream, circleDegree );
-			gak::toBinaryStream( stream, nodeID );
-		}
-		void fromBinaryStream( std::istream &stream )
-		{
-			gak::fromBinaryStream( stream, &circleDegree );
-			gak::fromBinaryStream( stream, &nodeID );
-		}
-	};
-#if defined( _MSC_VER ) || defined( __GNUC__ )
-#	pragma pack( pop )
-#endif
-	typedef IndexT<PositionValue>		Layer;
+	/*
+		each layer has its own packed R-tree of the node positions, IndexT is
+		no longer used and kept for source compatibility, only
+	*/
+	typedef SpatialIndex<NodeKeyT>		Layer;
 	typedef PairMap<LayerKeyT, Layer>	Layers;
 
 	private:
-	Layers				m_lonIndex;
-	Layers				m_latIndex;
+	Layers				m_nodeIndex;
 	BoundingBox			m_boundingBox;
 	math::TileIDsSet	m_tileIDs;
 
@@ -204,15 +169,8 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 		double	 latitude = node.getPosition().latitude;
 
 		addNode(key, node);
-		m_lonIndex[layerKey].addElement(
-			PositionValue( float(longitude), key )
-		);
-		m_latIndex[layerKey].addElement(
-			PositionValue( float(latitude), key )
-		);
+		m_nodeIndex[layerKey].addElement( float(longitude), float(latitude), key );
 		m_tileIDs.addElement(node.getTileID());
-
-		assert( m_lonIndex[layerKey].size() == m_latIndex[layerKey].size() );
 	}
 	void moveNode( 
 		const LayerKeyT &oldLayerKey, const LayerKeyT &newLayerKey, 
@@ -222,43 +180,21 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 		const NodeT	&node = this->getNode( nodeID );
 		float	 longitude = float(node.getPosition().longitude);
 		float	 latitude = float(node.getPosition().latitude);
-		PositionValue	lonPosition ( longitude, nodeID );
-		PositionValue	latPosition ( latitude, nodeID );
-
-		m_lonIndex[oldLayerKey].removeElement( lonPosition );
-		m_lonIndex[newLayerKey].addElement( lonPosition );
-
-		m_latIndex[oldLayerKey].removeElement( latPosition );
-		m_latIndex[newLayerKey].addElement( latPosition );
 
-		assert( m_lonIndex[oldLayerKey].size() == m_latIndex[oldLayerKey].size() );
-		assert( m_lonIndex[newLayerKey].size() == m_latIndex[newLayerKey].size() );
+		m_nodeIndex[oldLayerKey].removeElement( longitude, latitude, nodeID );
+		m_nodeIndex[newLayerKey].addElement( longitude, latitude, nodeID );
 	}
 
-	const Layers &getLonIndex() const
+	const Layers &getSpatialIndex() const
 	{
-		return m_lonIndex;
-	}
-	const Layers &getLatIndex() const
-	{
-		return m_latIndex;
+		return m_nodeIndex;
 	}
 
-	template <class SrcLayerT>
-	void mergeIndexLayer( Layer &target, const SrcLayerT src )
-	{
-		for(
-			typename SrcLayerT::const_iterator it = src.cbegin(), endIT = src.cend();
-			it != endIT;
-			++it
-		)
-		{
-			target.addElement( PositionValue(it->circleDegree, it->nodeID) );
-		}
-	}
-
-	template <class SrcLayersT>
-	void mergeIndex( Layers &target, const SrcLayersT &src )
+	/*
+		merges all layers of src into target, each target layer is packed once
+	*/
+	template <class TargetLayersT, class SrcLayersT>
+	void mergeIndex( TargetLayersT &target, const SrcLayersT &src )
 	{
 		for(
 			typename SrcLayersT::const_iterator it = src.cbegin(), endIT = src.cend();
@@ -266,8 +202,7 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 			++it
 		)
 		{
-			Layer &targetLayer = target[it->getKey()];
-			mergeIndexLayer( targetLayer, it->getValue() );
+			target[it->getKey()].merge( it->getValue() );
 		}
 	}
 	template <class TileT>
@@ -294,8 +229,7 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 			this->addLink(it->getKey(), link.m_link, link.m_startNodeID, link.m_endNodeID );
 		}
 
-		mergeIndex(m_lonIndex, tileMap.getLonIndex());
-		mergeIndex(m_latIndex, tileMap.getLatIndex());
+		mergeIndex(m_nodeIndex, tileMap.getSpatialIndex());
 	}
 
 
@@ -308,7 +242,7 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 			++itN
 		)
 		{
-			node_key_type nodeID = itN->nodeID;
+			node_key_type nodeID = itN->key;
 			const typename TileT::NodeInfo &nInfo = srcMap.getNodeInfo( nodeID );
 			addNode(layerKey, nodeID, nInfo.m_node);
 			const link_key_types &outgoing = nInfo.m_outgoing;
@@ -346,8 +280,7 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 	template <class TileT>
 	void mergeLayer( layer_key_type minLayerKey, layer_key_type maxLayerKey, const TileT &srcMap )
 	{
-		mergeLayerIndex(minLayerKey, maxLayerKey, srcMap.getLonIndex(), srcMap);
-		//mergeTileIndex(layerKey, srcMap.m_latIndex, srcMap);
+		mergeLayerIndex(minLayerKey, maxLayerKey, srcMap.getSpatialIndex(), srcMap);
 	}
 
 	Optional<NodeKeyT> findNextNode( 
@@ -359,8 +292,6 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 
 	const BoundingBox &getBoundingBox() const
 	{
-		assert( m_lonIndex.size() == m_latIndex.size() );
-
 		return m_boundingBox;
 	}
 	BoundingBox getFrameBox(double frame)
@@ -388,16 +319,14 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 	void clear()
 	{
 		Super::clear();
-		m_lonIndex.clear();
-		m_latIndex.clear();
+		m_nodeIndex.clear();
 		m_tileIDs.clear();
 	}
 
 	void toBinaryStream( std::ostream &stream ) const
 	{
 		Super::toBinaryStream( stream );
-		m_lonIndex.toBinaryStream( stream );
-		m_latIndex.toBinaryStream( stream );
+		m_nodeIndex.toBinaryStream( stream );
 		m_tileIDs.toBinaryStream( stream );
 		binaryToBinaryStream( stream, m_boundingBox );
 	}
@@ -406,12 +335,8 @@ class GeoGraph : public Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>
 		doEnterFunction("GeoGraph::fromBinaryStream");
 		Super::fromBinaryStream( stream );
 		{
-			doEnterFunction("m_lonIndex.fromBinaryStream");
-			m_lonIndex.fromBinaryStream( stream );
-		}
-		{
-			doEnterFunction("m_latIndex.fromBinaryStream");
-			m_latIndex.fromBinaryStream( stream );
+			doEnterFunction("m_nodeIndex.fromBinaryStream");
+			m_nodeIndex.fromBinaryStream( stream );
 		}
 		{
 			doEnterFunction("m_tileIDs.fromBinaryStream");
@@ -486,64 +411,10 @@ void GeoGraph<NodeT, LinkT, MapT, IndexT, LayerKeyT, NodeKeyT, LinkKeyT>::getReg
 {
 	doEnterFunction("GeoGraph<NodeT, LinkT, MapT, IndexT, LayerIdxT, NodeKeyT, LinkKeyT>::getRegion");
 
-	Array<NodeKeyT>	lonNodes, latNodes;
-
-	assert( m_lonIndex.size() == m_latIndex.size() );
-	assert( m_lonIndex.hasElement(layerKey) == m_latIndex.hasElement(layerKey) );
-
-	if( m_lonIndex.hasElement(layerKey) )
+	if( m_nodeIndex.hasElement(layerKey) )
 	{
-		const Layer &lonLayerIndex = m_lonIndex[layerKey];
-
-		assert( lonLayerIndex.size() == m_latIndex[layerKey].size() );
-
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		lonLayerIndex.getRange(
-			PositionValue(
-				float(region.topLeft.longitude)
-			),
-			PositionValue(
-				float(region.bottomRight.longitude)
-			)
-		);
-
-		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
-			it != endIT;
-			++it
-		)
-		{
-			lonNodes.addElement( it->nodeID );
-		}
+		m_nodeIndex[layerKey].getRegion( toSpatialBox( region ), result );
 	}
-
-	if( m_latIndex.hasElement(layerKey) )
-	{
-		const Layer &latLayerIndex = m_latIndex[layerKey];
-
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		latLayerIndex.getRange(
-			PositionValue(
-				float(region.bottomRight.latitude)
-			),
-			PositionValue(
-				float(region.topLeft.latitude)
-			)
-		);
-		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
-			it != endIT;
-			++it
-		)
-		{
-			latNodes.addElement( it->nodeID );
-		}
-	}
-	lonNodes.sort( FixedComparator<NodeKeyT>() );
-	latNodes.sort( FixedComparator<NodeKeyT>() );
-	intersectSorted( lonNodes, latNodes, std::back_inserter( *result ) );
 }
 
 template <
@@ -557,35 +428,14 @@ Optional<NodeKeyT> GeoGraph<NodeT, LinkT, MapT, IndexT, LayerKeyT, NodeKeyT, Lin
 	const math::GeoPosition<double> &point, double searchRange, LayerKeyT layer
 ) const
 {
-	typedef math::Rectangle< math::GeoPosition<double> >	BoundingBox;
-
-	Optional<NodeKeyT>	result;
-	BoundingBox			bBox(
-		point.longitude-searchRange, point.latitude+searchRange,
-		point.longitude+searchRange, point.latitude-searchRange
-	);
-
-	Array<NodeKeyT>		candidates;
-	getRegion( layer, bBox, &candidates );
-
-	double minDistance = std::numeric_limits<double>::max();
-	for(
-		typename Array<NodeKeyT>::const_iterator it = candidates.cbegin(),
-			endIT = candidates.cend();
-		it != endIT;
-		++it
-	)
+	if( !m_nodeIndex.hasElement(layer) )
 	{
-		NodeKeyT	nodeID = *it;
-		const NodeT	&node = getNode( nodeID );
-		double		distance = getDistance( point, node.getPosition() );
-		if( minDistance > distance )
-		{
-			minDistance = distance;
-			result = nodeID;
-		}
+/*@*/	return Optional<NodeKeyT>();
 	}
-	return result;
+
+	return m_nodeIndex[layer].findNearest(
+		float(point.longitude), float(point.latitude), searchRange
+	);
 }
 
 template <
@@ -602,7 +452,7 @@ Optional<NodeKeyT> GeoGraph<NodeT, LinkT, MapT, IndexT, LayerKeyT, NodeKeyT, Lin
 	Optional<NodeKeyT>	result;
 	double				minDistance = std::numeric_limits<double>::max();
 	for(
-		typename Layers::const_iterator it = m_lonIndex.cbegin(), endIT = m_lonIndex.cend();
+		typename Layers::const_iterator it = m_nodeIndex.cbegin(), endIT = m_nodeIndex.cend();
 		it != endIT;
 		++it
 	)
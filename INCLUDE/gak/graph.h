@@ -107,6 +107,7 @@ class Graph
 	typedef Array<node_key_type>	node_key_types;
 	typedef LinkKeyT				link_key_type;
 	typedef Array<link_key_type>	link_key_types;
+	typedef link_key_types			outgoing_links;
 	typedef Graph<NodeT, LinkT, MapT, NodeKeyT, LinkKeyT>		SelfT;
 
 	struct NodeInfo
@@ -336,6 +337,16 @@ class Graph
 		m_links.merge( src.m_links );
 		return *this;
 	};
+
+	/**
+		@brief creates an immutable copy of the graph
+		@param [out] target the new graph, e.g. a CompactGraph
+	*/
+	template <typename CompactGraphT>
+	void freeze( CompactGraphT *target ) const
+	{
+		target->build( *this );
+	}
 };
 
 // --------------------------------------------------------------------- //
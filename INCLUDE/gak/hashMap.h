@@ -0,0 +1,1202 @@
+/*
+		Project:		GAKLIB
+		Module:			hashMap.h
+		Description:	hash maps and sets using open addressing
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_HASH_MAP_H
+#define GAK_HASH_MAP_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#ifndef GAK_HASH_SSE2
+#	if defined( __SSE2__ ) || defined( _M_X64 ) || (defined( _M_IX86_FP ) && _M_IX86_FP >= 2)
+#		define GAK_HASH_SSE2	1		// use SSE2 to scan a group of control bytes
+#	else
+#		define GAK_HASH_SSE2	0
+#	endif
+#endif
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstring>
+
+#if GAK_HASH_SSE2
+#	include <emmintrin.h>
+#endif
+
+#include <gak/array.h>
+#include <gak/string.h>
+#include <gak/ci_string.h>
+#include <gak/keyValuePair.h>
+#include <gak/map.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// offset basis of the FNV-1a hash function
+const uint32 FNV_OFFSET_BASIS = 2166136261U;
+/// prime of the FNV-1a hash function
+const uint32 FNV_PRIME = 16777619U;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a class that calculates the hash value of a key for HashTable
+
+	The hash value is retrieved by an overloaded function gak::hashValue.
+	In order to use your own types as key, define your own hashValue
+	function for this type or define your own hash function class.
+
+	Two keys that are equal must have the same hash value.
+
+	@tparam KEY the type of the keys
+	@see HashTable, HashMap, HashSet
+*/
+template <class KEY>
+class HashFunction
+{
+	public:
+	/// returns the hash value of a key
+	size_t operator() ( const KEY &key ) const;
+};
+
+/**
+	@brief key policy for HashTable for items that provide their own key
+
+	The items must define key_type and provide getKey and setKey.
+
+	@tparam OBJ the type of the items
+	@see ObjectHashMap
+*/
+template <class OBJ>
+struct ObjectKey
+{
+	/// the type of the key values
+	typedef typename OBJ::key_type	key_type;
+
+	/// returns the key of an item
+	static key_type getKey( const OBJ &item )
+	{
+		return key_type( item.getKey() );
+	}
+	/// changes the key of a new item
+	static void setKey( OBJ &item, const key_type &key )
+	{
+		item.setKey( key );
+	}
+	/// returns true, if the item has the given key
+	static bool isKey( const OBJ &item, const key_type &key )
+	{
+		return key == item.getKey();
+	}
+};
+
+/**
+	@brief key policy for HashTable for items that are their own key
+	@tparam KEY the type of the items
+	@see HashSet
+*/
+template <class KEY>
+struct SelfKey
+{
+	/// the type of the key values
+	typedef KEY		key_type;
+
+	/// returns the key of an item
+	static const key_type &getKey( const KEY &item )
+	{
+		return item;
+	}
+	/// changes the key of a new item
+	static void setKey( KEY &item, const key_type &key )
+	{
+		item = key;
+	}
+	/// returns true, if the item has the given key
+	static bool isKey( const KEY &item, const key_type &key )
+	{
+		return key == item;
+	}
+};
+
+/**
+	@brief base class of hash containers using open addressing
+
+	The items are stored in a dense array. Thus they can be accessed by an
+	index and iterating is as fast as with an Array. The hash table itself
+	stores for each slot a control byte and the index of the item.
+
+	A control byte is either empty, deleted or contains 7 bits of the hash
+	value of the item. The slots are organized in groups of 16. When
+	searching a key, all control bytes of a group are compared at once (with
+	SSE2 if available) and only those items are compared with the key whose
+	control byte matches.
+
+	Removing an item moves the last item to its position. Thus the order of
+	the items is not stable.
+
+	@tparam OBJ the type of the items
+	@tparam KeyPolicyT the class that defines the key of the items
+	@tparam HashT the class that calculates the hash value of a key
+	@see HashMap, HashSet, ObjectHashMap, HashFunction
+*/
+template <class OBJ, class KeyPolicyT, class HashT>
+class HashTable : public Container
+{
+	public:
+	/// the type of the key values
+	typedef typename KeyPolicyT::key_type	key_type;
+	/// the type of the items stored in this Container
+	typedef OBJ								value_type;
+
+	private:
+	static const size_t			GROUP_SIZE = 16;
+	static const unsigned char	CTRL_EMPTY = 0x80;
+	static const unsigned char	CTRL_DELETED = 0xFE;
+
+	Array<OBJ>			m_items;
+	PODarray<size_t>	m_hashes;
+
+	size_t				m_numSlots, m_numDeleted;
+	unsigned char		*m_ctrl;
+	size_t				*m_slots;
+
+	HashT				m_hashFunction;
+
+	static size_t mixHash( size_t hash )
+	{
+		uint64	value = uint64( hash ) * ((uint64(0x9E3779B9) << 32) | 0x7F4A7C15);
+		return size_t( value ^ (value >> 32) );
+	}
+	static size_t getGroup( size_t hash )
+	{
+		return hash >> 7;
+	}
+	static unsigned char getCtrl( size_t hash )
+	{
+		return (unsigned char)(hash & 0x7F);
+	}
+	static size_t getMaxLoad( size_t numSlots )
+	{
+		return numSlots - numSlots/8;
+	}
+	static unsigned matchByte( const unsigned char *group, unsigned char value )
+	{
+#if GAK_HASH_SSE2
+		__m128i	ctrl = _mm_loadu_si128( reinterpret_cast<const __m128i *>( group ) );
+		return unsigned( _mm_movemask_epi8( _mm_cmpeq_epi8( ctrl, _mm_set1_epi8( char(value) ) ) ) );
+#else
+		unsigned	mask = 0;
+		for( size_t i=0; i<GROUP_SIZE; ++i )
+		{
+			if( group[i] == value )
+			{
+				mask |= 1U << i;
+			}
+		}
+		return mask;
+#endif
+	}
+	/// returns the slots that are empty or deleted
+	static unsigned matchFree( const unsigned char *group )
+	{
+#if GAK_HASH_SSE2
+		return unsigned( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( group ) ) ) );
+#else
+		unsigned	mask = 0;
+		for( size_t i=0; i<GROUP_SIZE; ++i )
+		{
+			if( group[i] & 0x80 )
+			{
+				mask |= 1U << i;
+			}
+		}
+		return mask;
+#endif
+	}
+	static size_t firstBit( unsigned mask )
+	{
+#if defined( __GNUC__ )
+		return size_t( __builtin_ctz( mask ) );
+#else
+		size_t	bit = 0;
+		while( !(mask & 1) )
+		{
+			mask >>= 1;
+			++bit;
+		}
+		return bit;
+#endif
+	}
+
+	size_t findSlot( size_t hash, const key_type &key ) const;
+	size_t findSlotOfItem( size_t index ) const;
+	size_t findFreeSlot( size_t hash ) const;
+	void rehash( size_t numSlots );
+	void rebuild();
+	void releaseTable()
+	{
+		delete [] m_ctrl;
+		delete [] m_slots;
+		m_ctrl = nullptr;
+		m_slots = nullptr;
+		m_numSlots = m_numDeleted = 0;
+	}
+	void forget()
+	{
+		m_ctrl = nullptr;
+		m_slots = nullptr;
+		m_numSlots = m_numDeleted = 0;
+		Container::clear();
+	}
+	void copyData( const HashTable &src );
+
+	protected:
+	size_t calcHash( const key_type &key ) const
+	{
+		return mixHash( m_hashFunction( key ) );
+	}
+	/// returns the index of the item with a given key or no_index
+	size_t findIndex( const key_type &key ) const
+	{
+		size_t	slot = findSlot( calcHash( key ), key );
+		return slot == no_index ? no_index : m_slots[slot];
+	}
+	/**
+		@brief appends a new item that has a given hash value
+		the key must not exist in the table
+		@param [in] hash the mixed hash value of the key
+		@return the new item
+	*/
+	OBJ &createItem( size_t hash );
+	/// returns the item with a given key, creates a new one, if it does not exist
+	OBJ &findOrCreateItem( const key_type &key, bool *oCreated=nullptr );
+
+	public:
+	/// creates an empty table
+	HashTable( const HashT &hashFunction = HashT() ) : m_hashFunction( hashFunction )
+	{
+		forget();
+	}
+	/// copy constructor
+	HashTable( const HashTable &src ) : Container(), m_hashFunction( src.m_hashFunction )
+	{
+		forget();
+		copyData( src );
+	}
+	/// copy assignment
+	const HashTable &operator = ( const HashTable &src )
+	{
+		if( this != &src )
+		{
+			clear();
+			m_hashFunction = src.m_hashFunction;
+			copyData( src );
+		}
+		return *this;
+	}
+	~HashTable()
+	{
+		releaseTable();
+	}
+
+	/// deletes all items in this container
+	void clear()
+	{
+		m_items.clear();
+		m_hashes.clear();
+		releaseTable();
+		Container::clear();
+	}
+	/**
+		@brief moves all items from the source table
+		the source will be empty after return
+		@param [in,out] source the source table
+	*/
+	void moveFrom( HashTable &source )
+	{
+		if( this != &source )
+		{
+			clear();
+			m_items.moveFrom( source.m_items );
+			m_hashes.moveFrom( source.m_hashes );
+			m_numSlots = source.m_numSlots;
+			m_numDeleted = source.m_numDeleted;
+			m_ctrl = source.m_ctrl;
+			m_slots = source.m_slots;
+			Container::moveFrom( source );
+			source.forget();
+		}
+	}
+	/**
+		@brief reserves memory for a given number of items
+		@param [in] numItems the number of items expected
+	*/
+	void setChunkSize( size_t numItems );
+
+	/// returns the item at a given position
+	const OBJ &getElementAt( size_t pos ) const
+	{
+		return m_items[pos];
+	}
+	/// returns the item at a given position, you must not change its key
+	OBJ &getElementAt( size_t pos )
+	{
+		return m_items[pos];
+	}
+	/// returns the index of the item with a given key or no_index if it was not found
+	size_t getElementIndex( const key_type &key ) const
+	{
+		return findIndex( key );
+	}
+	/// returns true if an element with a given key exists
+	bool hasElement( const key_type &key ) const
+	{
+		return findIndex( key ) != no_index;
+	}
+	/**
+		@brief removes the item at a given position
+		the last item is moved to this position
+		@param [in] pos the position of the item
+	*/
+	void removeElementAt( size_t pos );
+	/// removes the item with a given key, if present
+	void removeElementByKey( const key_type &key )
+	{
+		size_t	index = findIndex( key );
+		if( index != no_index )
+		{
+			removeElementAt( index );
+		}
+	}
+
+	/**
+		@brief writes binary data to a stream
+		the format is the same as of an Array, a HashTable can read the data
+		of a PairMap or UnorderedMap. The items are not sorted, though.
+		@param [in] stream the stream to write to
+		@exception WriteError in case of an I/O error
+	*/
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		m_items.toBinaryStream( stream );
+	}
+	/**
+		@brief reads binary data from a stream
+		@param [in] stream the stream to read from
+		@exception ReadError in case of an I/O error
+	*/
+	void fromBinaryStream( std::istream &stream )
+	{
+		clear();
+		m_items.fromBinaryStream( stream );
+		rebuild();
+	}
+
+	/*
+	-------------------------------------------------------------------------
+		standard support
+	-------------------------------------------------------------------------
+	*/
+	public:
+	/// @name Some standard typedefs:
+	///@{
+	typedef typename Array<OBJ>::const_iterator			const_iterator;
+	typedef typename Array<OBJ>::const_reverse_iterator	const_reverse_iterator;
+	typedef const_iterator									iterator;
+	typedef const_reverse_iterator							reverse_iterator;
+	///@}
+
+	/// @name Some standard member functions:
+	///@{
+	const_iterator cbegin() const
+	{
+		return m_items.cbegin();
+	}
+	const_iterator cend() const
+	{
+		return m_items.cend();
+	}
+	const_reverse_iterator crbegin() const
+	{
+		return m_items.crbegin();
+	}
+	const_reverse_iterator crend() const
+	{
+		return m_items.crend();
+	}
+	iterator begin() const
+	{
+		return m_items.cbegin();
+	}
+	iterator end() const
+	{
+		return m_items.cend();
+	}
+	reverse_iterator rbegin() const
+	{
+		return m_items.crbegin();
+	}
+	reverse_iterator rend() const
+	{
+		return m_items.crend();
+	}
+	///@}
+
+	/// checks the consistency of the table, used for testing
+	bool test() const;
+};
+
+/**
+	@brief a hash map for items that provide their own key
+
+	This map has the same interface like UnorderedMap, but searching an item
+	is done in O(1).
+
+	@tparam OBJ the type of the items must define key_type, getKey and setKey
+	@tparam HashT the class that calculates the hash value of a key
+	@see HashTable, UnorderedMap, HashMap
+*/
+template <class OBJ, class HashT=HashFunction<typename OBJ::key_type> >
+class ObjectHashMap : public HashTable<OBJ, ObjectKey<OBJ>, HashT>
+{
+	typedef HashTable<OBJ, ObjectKey<OBJ>, HashT>	Super;
+
+	public:
+	/// the type of the key values
+	typedef typename Super::key_type	key_type;
+	/// the type of the items
+	typedef OBJ							value_type;
+	/// the type of user data
+	typedef OBJ							mapped_type;
+
+	/**
+		@brief returns the element with a given key
+
+		creates a new one if it does not exist
+
+		@param [in] key the key value to search for
+		@return the (new) element found
+	*/
+	OBJ &getElementByKey( const key_type &key )
+	{
+		return this->findOrCreateItem( key );
+	}
+	/**
+		@brief returns the element with a given key
+		@param [in] key the key value to search for
+		@return the element found
+		@exception IndexError if key was not found
+	*/
+	const OBJ &getElementByKey( const key_type &key ) const
+	{
+		size_t	index = this->findIndex( key );
+		if( index == this->no_index )
+		{
+			throw IndexError();
+		}
+		return this->getElementAt( index );
+	}
+	/// @copydoc getElementByKey( const key_type &key )
+	OBJ &operator [] ( const key_type &key )
+	{
+		return getElementByKey( key );
+	}
+	/// @copydoc getElementByKey( const key_type &key ) const
+	const OBJ &operator [] ( const key_type &key ) const
+	{
+		return getElementByKey( key );
+	}
+	/// returns true if an element with a given key exists
+	bool hasElement( const key_type &key ) const
+	{
+		return Super::hasElement( key );
+	}
+	/// returns true if an element with the key of a given item exists
+	bool hasElement( const value_type &value ) const
+	{
+		return Super::hasElement( value.getKey() );
+	}
+	/**
+		@brief adds an item to the map
+		if an item with the same key exists, this item is replaced
+		@param [in] value the new item
+		@return the item stored in the map
+	*/
+	OBJ &addElement( const OBJ &value )
+	{
+		OBJ	&item = getElementByKey( value.getKey() );
+		item = value;
+		return item;
+	}
+	/// adds or replaces all items of another map
+	void addElements( const ObjectHashMap &source )
+	{
+		for(
+			typename Super::const_iterator it = source.cbegin(), endIT = source.cend();
+			it != endIT;
+			++it
+		)
+		{
+			addElement( *it );
+		}
+	}
+	/// Returns an array with all keys available in this map
+	Array<key_type> getKeys() const
+	{
+		return gak::getKeys< Array<key_type> >( *this );
+	}
+};
+
+/**
+	@brief a hash map that stores a pair of a key and the user data
+
+	This map has the same interface like PairMap, but searching and adding
+	an item is done in O(1). The items are not sorted.
+
+	@tparam KEY the type of the key values
+	@tparam VALUE the type of the user data
+	@tparam HashT the class that calculates the hash value of a key
+	@see HashTable, PairMap, KeyValuePair
+*/
+template <class KEY, class VALUE, class HashT=HashFunction<KEY> >
+class HashMap : public ObjectHashMap<KeyValuePair<KEY, VALUE>, HashT>
+{
+	public:
+	/// the type of the key values
+	typedef KEY		key_type;
+	/// the type of the user data
+	typedef VALUE	mapped_type;
+
+	/// @copydoc UnorderedPairMap::setValue
+	void setValue( const key_type &key, const mapped_type &value )
+	{
+		this->getElementByKey( key ).setValue( value );
+	}
+	/// @copydoc UnorderedPairMap::getValueAt
+	mapped_type &getValueAt( size_t pos )
+	{
+		return this->getElementAt( pos ).getValue();
+	}
+	/// @copydoc UnorderedPairMap::getValueAt
+	const mapped_type &getValueAt( size_t pos ) const
+	{
+		return this->getElementAt( pos ).getValue();
+	}
+	/// @copydoc UnorderedPairMap::getKeyAt
+	const key_type &getKeyAt( size_t pos ) const
+	{
+		return this->getElementAt( pos ).getKey();
+	}
+	/// @copydoc UnorderedPairMap::operator[]( const key_type & )
+	mapped_type &operator [] ( const key_type &key )
+	{
+		return this->getElementByKey( key ).getValue();
+	}
+	/// @copydoc UnorderedPairMap::operator[]( const key_type & ) const
+	const mapped_type &operator [] ( const key_type &key ) const
+	{
+		return this->getElementByKey( key ).getValue();
+	}
+	/// @copydoc UnorderedPairMap::findValue
+	key_type findValue( const mapped_type &value ) const
+	{
+		return gak::findValue( *this, value );
+	}
+};
+
+/**
+	@brief a hash set that stores unique values
+
+	@tparam KEY the type of the values
+	@tparam HashT the class that calculates the hash value of a value
+	@see HashTable, Set
+*/
+template <class KEY, class HashT=HashFunction<KEY> >
+class HashSet : public HashTable<KEY, SelfKey<KEY>, HashT>
+{
+	typedef HashTable<KEY, SelfKey<KEY>, HashT>	Super;
+
+	public:
+	/**
+		@brief adds a new value to the set
+		@param [in] value the new value
+		@return the value stored in the set
+	*/
+	const KEY &addElement( const KEY &value )
+	{
+		return this->findOrCreateItem( value );
+	}
+	/// adds a new value to the set
+	const HashSet &operator += ( const KEY &value )
+	{
+		addElement( value );
+		return *this;
+	}
+	/// adds all values of another set
+	void addElements( const HashSet &source )
+	{
+		for(
+			typename Super::const_iterator it = source.cbegin(), endIT = source.cend();
+			it != endIT;
+			++it
+		)
+		{
+			addElement( *it );
+		}
+	}
+	/// returns the index of a value or no_index if it was not found
+	size_t findElement( const KEY &value ) const
+	{
+		return this->findIndex( value );
+	}
+	/// removes a value from the set
+	void removeElement( const KEY &value )
+	{
+		this->removeElementByKey( value );
+	}
+	/// @copydoc HashTable::getElementAt( size_t pos ) const
+	const KEY &getElementAt( size_t pos ) const
+	{
+		return Super::getElementAt( pos );
+	}
+	/// @copydoc HashTable::getElementAt( size_t pos ) const
+	const KEY &operator [] ( size_t pos ) const
+	{
+		return Super::getElementAt( pos );
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// returns the hash value of an integer
+inline size_t hashValue( unsigned long long value )
+{
+	return size_t( value ^ (value >> 32) );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( long long value )
+{
+	return hashValue( (unsigned long long)value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( unsigned long value )
+{
+	return hashValue( (unsigned long long)value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( long value )
+{
+	return hashValue( (unsigned long long)value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( unsigned int value )
+{
+	return size_t( value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( int value )
+{
+	return size_t( value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( unsigned short value )
+{
+	return size_t( value );
+}
+/// returns the hash value of an integer
+inline size_t hashValue( short value )
+{
+	return size_t( value );
+}
+/// returns the hash value of a character
+inline size_t hashValue( unsigned char value )
+{
+	return size_t( value );
+}
+/// returns the hash value of a character
+inline size_t hashValue( char value )
+{
+	return size_t( (unsigned char)value );
+}
+/// returns the hash value of a pointer
+template <typename OBJ>
+inline size_t hashValue( const OBJ *value )
+{
+	return size_t( value );
+}
+
+/**
+	@brief returns the FNV-1a hash value of a string
+
+	STRING compares strings with different character sets by converting them
+	to UTF-8. Therefore only the ASCII characters are used for the hash
+	value, they are the same in all supported character sets.
+
+	@param [in] value the string
+	@return the hash value
+*/
+inline size_t hashValue( const STRING &value )
+{
+	uint32		hash = FNV_OFFSET_BASIS;
+	const char	*cp = value;
+
+	if( cp )
+	{
+		for( ; *cp; ++cp )
+		{
+			unsigned char	c = (unsigned char)*cp;
+			if( c < 0x80 )
+			{
+				hash = (hash ^ c) * FNV_PRIME;
+			}
+		}
+	}
+	return size_t( hash );
+}
+
+/**
+	@brief returns the case insensitive FNV-1a hash value of a string
+
+	CI_STRING ignores the case of the characters, only. Thus only the ASCII
+	letters are converted to lower case and non ASCII characters are ignored.
+
+	@param [in] value the string
+	@return the hash value
+	@see hashValue( const STRING &value )
+*/
+inline size_t hashValue( const CI_STRING &value )
+{
+	uint32		hash = FNV_OFFSET_BASIS;
+	const char	*cp = value;
+
+	if( cp )
+	{
+		for( ; *cp; ++cp )
+		{
+			unsigned char	c = (unsigned char)*cp;
+			if( c < 0x80 )
+			{
+				if( c >= 'A' && c <= 'Z' )
+				{
+					c += 'a' - 'A';
+				}
+				hash = (hash ^ c) * FNV_PRIME;
+			}
+		}
+	}
+	return size_t( hash );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class KEY>
+inline size_t HashFunction<KEY>::operator() ( const KEY &key ) const
+{
+	return hashValue( key );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class KeyPolicyT, class HashT>
+size_t HashTable<OBJ, KeyPolicyT, HashT>::findSlot( size_t hash, const key_type &key ) const
+{
+	if( !m_numSlots )
+	{
+		return no_index;
+	}
+
+	const OBJ			*items = m_items.getDataBuffer();
+	const size_t		*hashes = m_hashes.getDataBuffer();
+	const unsigned char	ctrl = getCtrl( hash );
+	const size_t		mask = m_numSlots/GROUP_SIZE - 1;
+	size_t				group = getGroup( hash ) & mask;
+
+	for( size_t step=1; ; ++step )
+	{
+		const unsigned char	*groupCtrl = m_ctrl + group*GROUP_SIZE;
+		for( unsigned match = matchByte( groupCtrl, ctrl ); match; match &= match-1 )
+		{
+			size_t	slot = group*GROUP_SIZE + firstBit( match );
+			size_t	index = m_slots[slot];
+			if( hashes[index] == hash && KeyPolicyT::isKey( items[index], key ) )
+			{
+				return slot;
+			}
+		}
+		if( matchByte( groupCtrl, CTRL_EMPTY ) )
+		{
+			return no_index;
+		}
+		group = (group + step) & mask;
+	}
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+size_t HashTable<OBJ, KeyPolicyT, HashT>::findSlotOfItem( size_t index ) const
+{
+	const size_t		hash = m_hashes[index];
+	const unsigned char	ctrl = getCtrl( hash );
+	const size_t		mask = m_numSlots/GROUP_SIZE - 1;
+	size_t				group = getGroup( hash ) & mask;
+
+	for( size_t step=1; ; ++step )
+	{
+		const unsigned char	*groupCtrl = m_ctrl + group*GROUP_SIZE;
+		for( unsigned match = matchByte( groupCtrl, ctrl ); match; match &= match-1 )
+		{
+			size_t	slot = group*GROUP_SIZE + firstBit( match );
+			if( m_slots[slot] == index )
+			{
+				return slot;
+			}
+		}
+		assert( !matchByte( groupCtrl, CTRL_EMPTY ) );
+		group = (group + step) & mask;
+	}
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+size_t HashTable<OBJ, KeyPolicyT, HashT>::findFreeSlot( size_t hash ) const
+{
+	const size_t	mask = m_numSlots/GROUP_SIZE - 1;
+	size_t			group = getGroup( hash ) & mask;
+
+	for( size_t step=1; ; ++step )
+	{
+		unsigned	match = matchFree( m_ctrl + group*GROUP_SIZE );
+		if( match )
+		{
+			return group*GROUP_SIZE + firstBit( match );
+		}
+		group = (group + step) & mask;
+	}
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+void HashTable<OBJ, KeyPolicyT, HashT>::rehash( size_t numSlots )
+{
+	assert( numSlots >= GROUP_SIZE && getMaxLoad( numSlots ) >= m_items.size() );
+
+	releaseTable();
+	m_ctrl = new unsigned char[numSlots];
+	m_slots = new size_t[numSlots];
+	m_numSlots = numSlots;
+	memset( m_ctrl, CTRL_EMPTY, numSlots );
+
+	const size_t	*hashes = m_hashes.getDataBuffer();
+	for( size_t i=0; i<m_items.size(); ++i )
+	{
+		size_t	slot = findFreeSlot( hashes[i] );
+		m_ctrl[slot] = getCtrl( hashes[i] );
+		m_slots[slot] = i;
+	}
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+void HashTable<OBJ, KeyPolicyT, HashT>::rebuild()
+{
+	size_t	numItems = m_items.size();
+
+	m_hashes.clear();
+	m_hashes.setMinSize( numItems );
+	for( size_t i=0; i<numItems; ++i )
+	{
+		m_hashes.addElement( calcHash( KeyPolicyT::getKey( m_items[i] ) ) );
+	}
+	releaseTable();
+	setNumElements( numItems );
+	if( numItems )
+	{
+		setChunkSize( numItems );
+	}
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+void HashTable<OBJ, KeyPolicyT, HashT>::copyData( const HashTable &src )
+{
+	m_items = src.m_items;
+	m_hashes = src.m_hashes;
+	if( src.m_numSlots )
+	{
+		m_ctrl = new unsigned char[src.m_numSlots];
+		m_slots = new size_t[src.m_numSlots];
+		m_numSlots = src.m_numSlots;
+		m_numDeleted = src.m_numDeleted;
+		memcpy( m_ctrl, src.m_ctrl, m_numSlots );
+		memcpy( m_slots, src.m_slots, m_numSlots * sizeof( size_t ) );
+	}
+	setNumElements( src.size() );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class KeyPolicyT, class HashT>
+OBJ &HashTable<OBJ, KeyPolicyT, HashT>::createItem( size_t hash )
+{
+	size_t	numItems = m_items.size();
+
+	if( numItems + m_numDeleted >= getMaxLoad( m_numSlots ) )
+	{
+		if( numItems < getMaxLoad( m_numSlots )/2 )
+		{
+			// there are many deleted slots: just cleanup
+			rehash( m_numSlots );
+		}
+		else
+		{
+			rehash( m_numSlots ? m_numSlots*2 : GROUP_SIZE );
+		}
+	}
+
+	size_t	slot = findFreeSlot( hash );
+	if( m_ctrl[slot] == CTRL_DELETED )
+	{
+		--m_numDeleted;
+	}
+	m_ctrl[slot] = getCtrl( hash );
+	m_slots[slot] = numItems;
+
+	m_hashes.addElement( hash );
+	OBJ	&newItem = m_items.createElement();
+	setNumElements( m_items.size() );
+
+	return newItem;
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+OBJ &HashTable<OBJ, KeyPolicyT, HashT>::findOrCreateItem( const key_type &key, bool *oCreated )
+{
+	size_t	hash = calcHash( key );
+	size_t	slot = findSlot( hash, key );
+
+	if( oCreated )
+	{
+		*oCreated = slot == no_index;
+	}
+	if( slot != no_index )
+	{
+		return m_items[m_slots[slot]];
+	}
+
+	OBJ	&newItem = createItem( hash );
+	KeyPolicyT::setKey( newItem, key );
+
+	return newItem;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class KeyPolicyT, class HashT>
+void HashTable<OBJ, KeyPolicyT, HashT>::setChunkSize( size_t numItems )
+{
+	if( getMaxLoad( m_numSlots ) < numItems )
+	{
+		size_t	numSlots = m_numSlots ? m_numSlots : GROUP_SIZE;
+		while( getMaxLoad( numSlots ) < numItems )
+		{
+			numSlots *= 2;
+		}
+		rehash( numSlots );
+	}
+	m_items.setMinSize( numItems );
+	m_hashes.setMinSize( numItems );
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+void HashTable<OBJ, KeyPolicyT, HashT>::removeElementAt( size_t pos )
+{
+	size_t	numItems = m_items.size();
+	if( pos >= numItems )
+	{
+		return;
+	}
+
+	size_t			slot = findSlotOfItem( pos );
+	unsigned char	*groupCtrl = m_ctrl + (slot / GROUP_SIZE) * GROUP_SIZE;
+
+	// if the group has an empty slot, no search did ever pass this group
+	if( matchByte( groupCtrl, CTRL_EMPTY ) )
+	{
+		m_ctrl[slot] = CTRL_EMPTY;
+	}
+	else
+	{
+		m_ctrl[slot] = CTRL_DELETED;
+		++m_numDeleted;
+	}
+
+	size_t	last = numItems-1;
+	if( pos != last )
+	{
+		m_slots[findSlotOfItem( last )] = pos;
+		moveAssign( m_items[pos], m_items[last] );
+		m_hashes[pos] = m_hashes[last];
+	}
+	m_items.removeElementAt( last );
+	m_hashes.removeElementAt( last );
+	setNumElements( last );
+}
+
+template <class OBJ, class KeyPolicyT, class HashT>
+bool HashTable<OBJ, KeyPolicyT, HashT>::test() const
+{
+	size_t	numFull = 0, numDeleted = 0;
+
+	for( size_t slot=0; slot<m_numSlots; ++slot )
+	{
+		unsigned char	ctrl = m_ctrl[slot];
+		if( ctrl == CTRL_DELETED )
+		{
+			++numDeleted;
+		}
+		else if( ctrl != CTRL_EMPTY )
+		{
+			size_t	index = m_slots[slot];
+			if( index >= m_items.size() || getCtrl( m_hashes[index] ) != ctrl )
+			{
+				return false;
+			}
+			if( findSlot( m_hashes[index], KeyPolicyT::getKey( m_items[index] ) ) != slot )
+			{
+				return false;
+			}
+			++numFull;
+		}
+	}
+	return numFull == m_items.size()
+		&& numDeleted == m_numDeleted
+		&& m_hashes.size() == m_items.size()
+		&& size() == m_items.size()
+		&& numFull + numDeleted <= getMaxLoad( m_numSlots );
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <class OBJ, class HashT>
+inline void moveAssign( ObjectHashMap<OBJ, HashT> &target, ObjectHashMap<OBJ, HashT> &source )
+{
+	target.moveFrom( source );
+}
+
+template <class KEY, class VALUE, class HashT>
+inline void moveAssign( HashMap<KEY, VALUE, HashT> &target, HashMap<KEY, VALUE, HashT> &source )
+{
+	target.moveFrom( source );
+}
+
+template <class KEY, class HashT>
+inline void moveAssign( HashSet<KEY, HashT> &target, HashSet<KEY, HashT> &source )
+{
+	target.moveFrom( source );
+}
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_HASH_MAP_H
@@ -46,6 +46,7 @@
 #include <gak/html.h>
 #include <gak/httpResponse.h>
 #include <gak/exception.h>
+#include <gak/hashMap.h>
 
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
@@ -130,7 +131,7 @@ class HTTPrequest
 
 	// response
 	STRING								m_lastUrl;
-	UnorderedMap<HTTPclientResponse>	m_responseCache;
+	ObjectHashMap<HTTPclientResponse>	m_responseCache;
 
 	private:
 	size_t MakeRequest(
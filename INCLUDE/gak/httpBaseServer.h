@@ -41,6 +41,7 @@
 // --------------------------------------------------------------------- //
 
 #include <gak/socketServer.h>
+#include <gak/httpFileCache.h>
 #include <gak/httpResponse.h>
 #include <gak/fieldSet.h>
 
@@ -99,14 +100,41 @@ namespace net
 		myServer.startServer( 6666, 100 );
 	@endcode
 
+	With a SocketReactor a worker gets a connection when the header and the
+	body of the request are received:
+
+	@code
+		myServer.startServer( 6666, 8, 2 );
+	@endcode
+
+	HTTP/1.1 clients keep their connection open unless they send
+	Connection: close, HTTP/1.0 clients must ask for Connection: keep-alive.
+	The idle timeout and the max. number of requests per connection are
+	configured with SocketServer::setKeepAlive. Without a SocketReactor
+	persistent connections are disabled unless setKeepAlive was called.
+	Pipelined requests are answered in the order they were received.
+
+	Static files are sent with sendStaticFile. File names with a parent
+	directory segment (..) are rejected with the status 403, so the URL
+	cannot leave the document root:
+
+	@code
+		int MyServer::handleGetRequest( const STRING &url )
+		{
+			return sendStaticFile( m_documentRoot + url );
+		}
+	@endcode
+
 	@see SocketServer
 */
 class HTTPserverBase : public ServerProcessorBase
 {
 	private:
-	bool	headerReading;
+	bool	headerReading, hasContentLength;
 	size_t	bytesStreamed, requestSize;
 
+	static HTTPfileCache	s_fileCache;
+
 	protected:
 	/// the client request sent to the server
 	struct HTTPserverRequest
@@ -115,6 +143,8 @@ class HTTPserverBase : public ServerProcessorBase
 		CI_STRING		method;
 		/// the request URL
 		STRING			url;
+		/// the protocol version e.g. HTTP/1.1
+		STRING			version;
 		/// the length of the post data
 		size_t			contentLength;
 
@@ -133,9 +163,24 @@ class HTTPserverBase : public ServerProcessorBase
 	/// creates a new HTTP Server used for the listener thread
 	HTTPserverBase() : ServerProcessorBase()
 	{
-		headerReading = false;
+		headerReading = hasContentLength = false;
 		bytesStreamed = requestSize = 0;
 	}
+	public:
+	/**
+		@brief tells the SocketReactor whether the request is received
+		@param [in] data the data received so far
+		@param [in] size the number of bytes received
+		@return true if the header and the body of the first request are complete
+	*/
+	static bool isRequestComplete( const char *data, size_t size );
+
+	/// returns the cache used by sendStaticFile
+	static HTTPfileCache &getFileCache( void )
+	{
+		return s_fileCache;
+	}
+
 	/// creates a new HTTP Server used for the worker thread
 	private:
 	virtual int underflow( void );
@@ -155,6 +200,26 @@ class HTTPserverBase : public ServerProcessorBase
 		@param [in] body the post data that will be send to the client
 	*/
 	void sendResponse( const ArrayOfData &body );
+	/**
+		@brief sends a regular file to the client
+
+		The response gets an ETag and a Last-Modified date of the file. If
+		the client already has the current version (If-None-Match or
+		If-Modified-Since) the status 304 is sent without the file. A
+		Range request with one byte range is answered with the status 206.
+
+		Small files are taken from the HTTPfileCache, larger files are sent
+		with SocketStreambuf::sendFile without copying them into user space.
+
+		The status 403 is returned for directories and for file names
+		containing a parent directory segment (..).
+
+		@param [in] fileName the file to send
+		@param [in] contentType the content type of the file or an empty string
+		@return 0 if the response was sent, otherwise the status code the handler should return
+		@see getFileCache
+	*/
+	int sendStaticFile( const STRING &fileName, const STRING &contentType=NULL_STRING );
 
 	/// @copydoc HTTPserverResponse::setStatusCode
 	void setStatusCode( int statusCode )
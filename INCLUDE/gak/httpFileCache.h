@@ -0,0 +1,250 @@
+/*
+		Project:		GAKLIB
+		Module:			httpFileCache.h
+		Description:	In-memory cache for static files of an HTTP server
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_HTTP_FILE_CACHE_H
+#define GAK_HTTP_FILE_CACHE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <ctime>
+
+#include <gak/directoryEntry.h>
+#include <gak/map.h>
+#include <gak/shared.h>
+#include <gak/locker.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace net
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// default max. size of all files in a HTTPfileCache
+const size_t HTTP_CACHE_SIZE = 16*1024*1024;
+/// default max. size of one file in a HTTPfileCache
+const size_t HTTP_CACHE_FILE_SIZE = 256*1024;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief keeps small static files of an HTTP server in memory
+
+	HTTPserverBase::sendStaticFile sends files found in the cache with one
+	call of sendData, all other files are sent with SocketStreambuf::sendFile.
+	An entry is valid as long as the size and the modification date of the
+	file are unchanged. If the cache is full, the least recently used files
+	are removed.
+
+	All functions are thread safe.
+
+	@see HTTPserverBase::sendStaticFile
+*/
+class HTTPfileCache
+{
+	public:
+	/// a file in the cache
+	class CachedFile : public SharedObject
+	{
+		friend class HTTPfileCache;
+
+		ArrayOfData		m_data;
+		uint64			m_fileSize;
+		std::time_t		m_modified;
+		size_t			m_lastUse;
+
+		public:
+		/// returns the content of the file
+		const ArrayOfData &getData() const
+		{
+			return m_data;
+		}
+	};
+	/// the files are shared by the cache and the workers sending them
+	typedef SharedObjectPointer<CachedFile>	CachedFilePtr;
+
+	private:
+	PairMap<STRING, CachedFilePtr>	m_files;
+	size_t							m_maxSize, m_maxFileSize, m_size;
+	size_t							m_useCounter, m_numHits, m_numMisses;
+	Critical						m_lock;
+
+	// no copy
+	HTTPfileCache( const HTTPfileCache & );
+	const HTTPfileCache & operator = ( const HTTPfileCache & );
+
+	void removeLeastRecentlyUsed( size_t maxSize );
+
+	public:
+	/**
+		@brief creates an empty cache
+		@param [in] maxSize the max. size of all files in bytes
+		@param [in] maxFileSize the max. size of one file in bytes
+	*/
+	HTTPfileCache( size_t maxSize=HTTP_CACHE_SIZE, size_t maxFileSize=HTTP_CACHE_FILE_SIZE )
+	: m_maxSize( maxSize ), m_maxFileSize( maxFileSize ), m_size( 0 ),
+	  m_useCounter( 0 ), m_numHits( 0 ), m_numMisses( 0 )
+	{
+	}
+
+	/**
+		@brief changes the limits of the cache, files exceeding the new limits are removed
+		@param [in] maxSize the max. size of all files in bytes
+		@param [in] maxFileSize the max. size of one file in bytes, 0 disables the cache
+	*/
+	void setLimits( size_t maxSize, size_t maxFileSize );
+	/**
+		@brief returns the content of a file
+		@param [in] entry the file, the DirectoryEntry must be up to date
+		@return the cached file or an empty pointer if the file is too large or cannot be read
+	*/
+	CachedFilePtr getFile( const DirectoryEntry &entry );
+	/// removes all files
+	void clear();
+
+	/// returns the size of all cached files in bytes
+	size_t getSize() const
+	{
+		return m_size;
+	}
+	/// returns the number of cached files
+	size_t getNumFiles() const
+	{
+		return m_files.size();
+	}
+	/// returns the number of requests served from the cache
+	size_t getNumHits() const
+	{
+		return m_numHits;
+	}
+	/// returns the number of requests that had to read the file
+	size_t getNumMisses() const
+	{
+		return m_numMisses;
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace net
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_HTTP_FILE_CACHE_H
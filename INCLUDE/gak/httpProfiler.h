@@ -69,6 +69,31 @@ namespace net
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/**
+	@brief the result of HTTPprofiler::loadTest
+
+	all times are in milliseconds
+*/
+struct HTTPloadStatistic
+{
+	/// the number of requests performed
+	size_t	numRequests;
+	/// the number of requests that failed
+	size_t	numErrors;
+	/// the time for all requests
+	double	totalTime;
+	/// the throughput of the server
+	double	requestsPerSecond;
+	/// the median of the latencies
+	double	latency50;
+	/// 90% of the requests were faster
+	double	latency90;
+	/// 99% of the requests were faster
+	double	latency99;
+	/// the slowest request
+	double	maxLatency;
+};
+
 /// this class is a special HTTP client that can be used to perform a server profiling
 class HTTPprofiler : public HTTPrequest
 {
@@ -156,6 +181,23 @@ class HTTPprofiler : public HTTPrequest
 	{
 		script.writeToFile( fileName );
 	}
+
+	/**
+		@brief measures the throughput and the latencies of a server
+
+		Each client uses one persistent HTTP/1.1 connection and sends its
+		requests in groups of pipelineDepth requests without waiting for the
+		responses. If the server closes the connection, the client reconnects.
+
+		@param [in] url the http URL to request
+		@param [in] numClients the number of concurrent clients (threads)
+		@param [in] numRequests the number of requests of each client
+		@param [in] pipelineDepth the number of requests sent without waiting for a response
+		@return the statistic of all requests
+	*/
+	static HTTPloadStatistic loadTest(
+		const STRING &url, size_t numClients, size_t numRequests, size_t pipelineDepth=1
+	);
 };
 
 // --------------------------------------------------------------------- //
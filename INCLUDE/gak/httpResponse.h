@@ -388,15 +388,79 @@ class HTTPresponse
 class HTTPserverResponse : public HTTPresponse
 {
 	private:
+	bool	m_keepAlive, m_acceptRanges;
+	STRING	m_contentRange;
+
 	virtual void sendStatusCode( std::ostream &out ) const;
 
 	public:
+	HTTPserverResponse() : m_keepAlive( false ), m_acceptRanges( false )
+	{
+	}
+	/// clears all data of the previous response of a persistent connection
+	void reset( void )
+	{
+		init();
+		m_cookies.clear();
+		m_error = "";
+		m_statusText = "";
+		m_contentRange = "";
+		m_keepAlive = m_acceptRanges = false;
+	}
+	/**
+		@brief sets the value of the Content-Range header field
+		@param [in] contentRange the range e.g. bytes 0-99/1000
+	*/
+	void setContentRange( const STRING &contentRange )
+	{
+		m_contentRange = contentRange;
+	}
+	/// returns the value of the Content-Range header field
+	const STRING &getContentRange( void ) const
+	{
+		return m_contentRange;
+	}
+	/**
+		@brief tells the client whether it may request parts of the document
+		@param [in] acceptRanges true to send Accept-Ranges: bytes
+	*/
+	void setAcceptRanges( bool acceptRanges )
+	{
+		m_acceptRanges = acceptRanges;
+	}
+	/**
+		@brief sets the value of the Connection header field
+		@param [in] keepAlive true if the connection remains open for the next request
+	*/
+	void setKeepAlive( bool keepAlive )
+	{
+		m_keepAlive = keepAlive;
+	}
+	/// returns true if the connection remains open for the next request
+	bool getKeepAlive( void ) const
+	{
+		return m_keepAlive;
+	}
+	/**
+		@brief sends all header fields to the client
+		@param [in] out the stream where to send the data
+		@param [in] contentLength the size of the body the caller sends after the header, not sent for status 304
+		@return false if the response already contains its own body (error or redirect)
+	*/
+	bool flushHeader( std::ostream &out, uint64 contentLength );
 	/**
 		@brief sends all header fields and the body to the client
 		@param [in] out the stream where to send the data
 		@param [in] body the response body
 	*/
-	void flushData( std::ostream &out, const ArrayOfData &body );
+	void flushData( std::ostream &out, const ArrayOfData &body )
+	{
+		if( flushHeader( out, body.size() ) && body.size() )
+		{
+			out.write( body.getDataBuffer(), body.size() );
+		}
+		out.flush();
+	}
 	/**
 		@brief sends all header fields and the body to the client
 		@param [in] out the stream where to send the data
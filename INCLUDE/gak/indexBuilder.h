@@ -0,0 +1,456 @@
+/*
+		Project:		GAKLIB
+		Module:			indexBuilder.h
+		Description:	parallel building of inverted indices
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_INDEX_BUILDER_H
+#define GAK_INDEX_BUILDER_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/indexer.h>
+#include <gak/threadPool.h>
+#include <gak/shared.h>
+#include <gak/locker.h>
+#include <gak/exception.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace ai
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// @brief exception thrown if one of the documents could not be indexed
+class IndexBuildError : public LibraryException
+{
+	public:
+	IndexBuildError() : LibraryException( "IndexBuildError" ) {}
+};
+
+/**
+	@brief builds an Index with a ThreadPool
+
+	The documents are collected in batches. Each batch is tokenized by a
+	worker thread of the pool and stored in one of the partial indices. There
+	is one partial index for each worker, so the workers never share any data
+	except the free list of the partial indices.
+
+	@ref build waits for all batches and merges the partial indices into the
+	final Index with @ref mergeIndexes. Since each document is indexed by one
+	worker, only, the result is the same as if the documents were indexed
+	sequentially.
+
+	@code
+		ParallelIndexBuilder<STRING>	builder( stopWords, IS_ANY, 4 );
+
+		for( ... )
+		{
+			builder.addDocument( fileName, text );
+		}
+		builder.build( &index );
+	@endcode
+
+	@tparam SourceT the type of the document identifiers
+	@tparam StringsT the type of the stop word list
+	@see Index, indexString, mergeIndexes
+*/
+template <typename SourceT, typename StringsT=SortedArray<CI_STRING> >
+class ParallelIndexBuilder
+{
+	public:
+	/// the default number of documents that are indexed by one job
+	static const std::size_t DEFAULT_BATCH_SIZE = 64;
+
+	private:
+	struct Document
+	{
+		SourceT	m_source;
+		STRING	m_text;
+	};
+	typedef SharedPointer< Array<Document> >	Batch;
+
+	class IndexJob
+	{
+		ParallelIndexBuilder	*m_builder;
+		Batch					m_batch;
+
+		public:
+		IndexJob() : m_builder( nullptr ) {}
+		IndexJob( ParallelIndexBuilder *builder, const Batch &batch ) : m_builder( builder ), m_batch( batch ) {}
+
+		void operator () () const
+		{
+			m_builder->indexBatch( *m_batch );
+		}
+	};
+
+	const StringsT			m_stopWords;
+	const int				m_includeTypes;
+	const std::size_t		m_batchSize;
+
+	Critical				m_critical;
+	Array< Index<SourceT> >	m_partials;
+	PODarray<std::size_t>	m_freePartials;
+	STRING					m_errorText;
+
+	ThreadPool<IndexJob>	m_pool;
+	PoolFuture				m_future;
+	Batch					m_batch;
+
+	// no copy
+	ParallelIndexBuilder( const ParallelIndexBuilder & );
+	const ParallelIndexBuilder & operator = ( const ParallelIndexBuilder & );
+
+	std::size_t aquirePartial();
+	void releasePartial( std::size_t partial );
+	void indexBatch( const Array<Document> &batch );
+	void dispatchBatch();
+
+	public:
+	/**
+		@brief creates a new builder and starts the worker threads
+		@param [in] stopWords the words that must not be indexed
+		@param [in] includeTypes the types of words to index (IS_WORD, IS_TEXT, IS_IDENT)
+		@param [in] numThreads the number of worker threads, 0 indexes the documents in the calling thread
+		@param [in] batchSize the number of documents indexed by one job
+	*/
+	ParallelIndexBuilder( const StringsT &stopWords, int includeTypes, std::size_t numThreads, std::size_t batchSize=DEFAULT_BATCH_SIZE );
+	~ParallelIndexBuilder()
+	{
+		m_pool.shutdown();
+	}
+
+	/**
+		@brief adds a document to the index
+		@param [in] source the identifier of the document
+		@param [in] text the text of the document
+	*/
+	void addDocument( const SourceT &source, const STRING &text );
+	/**
+		@brief waits for all documents and merges the result into an index
+		@param [in,out] target the index receiving the words of all documents added so far
+		@throws IndexBuildError if a document could not be indexed
+	*/
+	void build( Index<SourceT> *target );
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename SourceT>
+void mergeIndexes( Array< Index<SourceT> > &partials, Index<SourceT> *target );
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief merges a number of indices into one index
+
+	The words of all indices are merged in their sorted order, thus the hits of
+	each word are moved only once for each index they are found in.
+
+	@param [in,out] partials the indices to merge, will be empty after return
+	@param [in,out] target the index receiving all words
+	@tparam SourceT the type of the document identifiers
+*/
+template <typename SourceT>
+void mergeIndexes( Array< Index<SourceT> > &partials, Index<SourceT> *target )
+{
+	doEnterFunctionEx(gakLogging::llInfo,"mergeIndexes");
+
+	typedef typename Index<SourceT>::SearchIndex	SearchIndex;
+	typedef typename Index<SourceT>::SearchResult	SearchResult;
+
+	const std::size_t					numPartials = partials.size();
+	Array< PODarray<std::size_t> >		wordOrders;
+	PODarray<std::size_t>				cursors;
+
+	wordOrders.setChunkSize( numPartials );
+	for( std::size_t i=0; i<numPartials; ++i )
+	{
+		wordOrders.addElement( partials[i].getSortedWords() );
+		cursors.addElement( 0 );
+	}
+
+	for(;;)
+	{
+		// find the smallest word
+		const char	*minWord = nullptr;
+		for( std::size_t i=0; i<numPartials; ++i )
+		{
+			if( cursors[i] < wordOrders[i].size() )
+			{
+				const char *word = partials[i].getSearchIndex().getKeyAt( wordOrders[i][cursors[i]] ).c_str();
+				if( !minWord || compareTerms( word, minWord ) < 0 )
+				{
+					minWord = word;
+				}
+			}
+		}
+		if( !minWord )
+		{
+			break;
+		}
+
+		// move the hits of all indices with this word
+		const STRING	word = minWord;
+		for( std::size_t i=0; i<numPartials; ++i )
+		{
+			if( cursors[i] < wordOrders[i].size() )
+			{
+				const SearchIndex	&searchIndex = partials[i].getSearchIndex();
+				const std::size_t	wordIdx = wordOrders[i][cursors[i]];
+				if( !compareTerms( searchIndex.getKeyAt( wordIdx ).c_str(), word.c_str() ) )
+				{
+					target->moveWordHits(
+						word, &const_cast<SearchResult&>( searchIndex.getValueAt( wordIdx ) )
+					);
+					++cursors[i];
+				}
+			}
+		}
+	}
+
+	for( std::size_t i=0; i<numPartials; ++i )
+	{
+		partials[i].clear();
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename SourceT, typename StringsT>
+ParallelIndexBuilder<SourceT, StringsT>::ParallelIndexBuilder(
+	const StringsT &stopWords, int includeTypes, std::size_t numThreads, std::size_t batchSize
+)
+: m_stopWords( stopWords ), m_includeTypes( includeTypes ), m_batchSize( batchSize ? batchSize : 1 ),
+  m_pool( numThreads, "IndexBuilder", nullptr, pmWorkStealing ),
+  m_future( PoolFuture::create() )
+{
+	// in single thread mode the jobs are processed by the calling thread
+	const std::size_t	numPartials = numThreads ? numThreads : 1;
+
+	m_partials.setChunkSize( numPartials );
+	for( std::size_t i=0; i<numPartials; ++i )
+	{
+		m_partials.createElement();
+		m_freePartials.addElement( i );
+	}
+	m_pool.start();
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <typename SourceT, typename StringsT>
+std::size_t ParallelIndexBuilder<SourceT, StringsT>::aquirePartial()
+{
+	CriticalScope	scope( m_critical );
+
+	// each worker processes one job at a time, thus there is always a free partial
+	assert( m_freePartials.size() );
+	const std::size_t	last = m_freePartials.size()-1;
+	const std::size_t	partial = m_freePartials[last];
+	m_freePartials.removeElementAt( last );
+	return partial;
+}
+
+template <typename SourceT, typename StringsT>
+void ParallelIndexBuilder<SourceT, StringsT>::releasePartial( std::size_t partial )
+{
+	CriticalScope	scope( m_critical );
+	m_freePartials.addElement( partial );
+}
+
+template <typename SourceT, typename StringsT>
+void ParallelIndexBuilder<SourceT, StringsT>::indexBatch( const Array<Document> &batch )
+{
+	doEnterFunctionEx(gakLogging::llDetail,"ParallelIndexBuilder::indexBatch");
+
+	const std::size_t	partial = aquirePartial();
+	Index<SourceT>		&index = m_partials[partial];
+
+	try
+	{
+		for(
+			typename Array<Document>::const_iterator it = batch.cbegin(), endIT = batch.cend();
+			it != endIT;
+			++it
+		)
+		{
+			StringIndex	positions;
+			indexString( it->m_text, m_stopWords, m_includeTypes, &positions );
+			index.moveIndexPositions( it->m_source, &positions );
+		}
+	}
+	catch( std::exception &e )
+	{
+		CriticalScope	scope( m_critical );
+		m_errorText = e.what();
+	}
+	releasePartial( partial );
+}
+
+template <typename SourceT, typename StringsT>
+void ParallelIndexBuilder<SourceT, StringsT>::dispatchBatch()
+{
+	if( m_batch )
+	{
+		m_pool.process( IndexJob( this, m_batch ), m_future );
+		m_batch = Batch();
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename SourceT, typename StringsT>
+void ParallelIndexBuilder<SourceT, StringsT>::addDocument( const SourceT &source, const STRING &text )
+{
+	if( !m_batch )
+	{
+		m_batch = Batch::makeShared();
+		m_batch->setChunkSize( m_batchSize );
+	}
+
+	Document	&doc = m_batch->createElement();
+	doc.m_source = source;
+	doc.m_text = text;
+
+	if( m_batch->size() >= m_batchSize )
+	{
+		dispatchBatch();
+	}
+}
+
+template <typename SourceT, typename StringsT>
+void ParallelIndexBuilder<SourceT, StringsT>::build( Index<SourceT> *target )
+{
+	doEnterFunctionEx(gakLogging::llInfo,"ParallelIndexBuilder::build");
+
+	dispatchBatch();
+	m_future.wait();
+	m_future = PoolFuture::create();
+
+	mergeIndexes( m_partials, target );
+
+	if( !m_errorText.isEmpty() )
+	{
+		IndexBuildError	error;
+		error.addErrorText( m_errorText );
+		m_errorText = NULL_STRING;
+		throw error;
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace ai
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_INDEX_BUILDER_H
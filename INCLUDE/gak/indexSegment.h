@@ -0,0 +1,1177 @@
+/*
+		Project:		GAKLIB
+		Module:			indexSegment.h
+		Description:	immutable, compressed segments of an inverted index
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_INDEX_SEGMENT_H
+#define GAK_INDEX_SEGMENT_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstring>
+#include <fstream>
+#include <streambuf>
+
+#include <gak/indexer.h>
+#include <gak/memoryMappedFile.h>
+#include <gak/shared.h>
+#include <gak/locker.h>
+#include <gak/thread.h>
+#include <gak/strFiles.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace ai
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the magic number of an index segment file
+const uint32 INDEX_SEGMENT_MAGIC = 0x53494B47;		// GKIS
+/// the current version of the index segment file format
+const uint16 INDEX_SEGMENT_VERSION = 1;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief the header at the start of an index segment file
+
+	The file has the following sections:
+	- the header
+	- the posting lists of all terms, in the order of the term dictionary
+	- the table of the sources (documents), sorted, stored with toBinaryStream
+	- the term dictionary, an array of IndexSegmentTerm sorted by the terms
+	- the text of all terms, each terminated by a 0 byte
+
+	A posting list contains for each source that contains the term the
+	difference of the source id to the previous one, the number of positions
+	and the positions. A position is stored as difference of the start to the
+	previous start, the length and the flags. All numbers are stored as
+	variable length integers with 7 bits per byte.
+*/
+struct IndexSegmentHeader
+{
+	uint32	m_magic;
+	uint16	m_version;
+	uint16	m_reserved;
+	uint64	m_numTerms,
+			m_numSources,
+			m_sourcesOffset,
+			m_dictOffset,
+			m_termsOffset,
+			m_fileSize;
+};
+
+/// an entry of the term dictionary of an index segment file
+struct IndexSegmentTerm
+{
+	uint64	m_termOffset;
+	uint64	m_postingOffset;
+	uint32	m_termLen;
+	uint32	m_numSources;
+};
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// a read only stream buffer for a memory block
+class IndexSegmentBuffer : public std::streambuf
+{
+	public:
+	IndexSegmentBuffer( const char *data, std::size_t size )
+	{
+		char	*start = const_cast<char *>( data );
+		setg( start, start, start + size );
+	}
+};
+
+/**
+	@brief creates a new index segment file
+
+	The terms must be added in ascending order of their bytes (strcmp)
+	and for each term the sources in ascending order of their id. The id of a
+	source is its position in the sorted table of all sources.
+
+	@tparam SourceT the type that identifies a document
+	@see IndexSegment, writeIndexSegment, mergeIndexSegments
+*/
+template<typename SourceT>
+class IndexSegmentWriter
+{
+	STRING						m_fileName;
+	std::ofstream				m_stream;
+	SortedArray<SourceT>		m_sources;
+	PODarray<IndexSegmentTerm>	m_terms;
+	PODarray<char>				m_termText;
+	std::size_t					m_lastSource;
+	bool						m_finished;
+
+	void writeVarint( uint64 value )
+	{
+		char	buffer[10];
+		size_t	len = 0;
+
+		while( value >= 0x80 )
+		{
+			buffer[len++] = char( (value & 0x7F) | 0x80 );
+			value >>= 7;
+		}
+		buffer[len++] = char( value );
+		m_stream.write( buffer, len );
+	}
+	uint64 getOffset()
+	{
+		std::streamoff	offset = m_stream.tellp();
+		if( offset < 0 )
+		{
+			throw WriteError( m_fileName );
+		}
+		return uint64( offset );
+	}
+	void checkStream()
+	{
+		if( !m_stream )
+		{
+			throw WriteError( m_fileName );
+		}
+	}
+
+	// no copy
+	IndexSegmentWriter( const IndexSegmentWriter & );
+	const IndexSegmentWriter &operator = ( const IndexSegmentWriter & );
+
+	public:
+	/**
+		@brief creates the file
+		@param [in] fileName the name of the new file
+		@param [in] sources all sources (documents) of the new segment
+		@exception OpenWriteError if the file could not be created
+	*/
+	IndexSegmentWriter( const STRING &fileName, const SortedArray<SourceT> &sources );
+	~IndexSegmentWriter()
+	{
+		if( !m_finished )
+		{
+			m_stream.close();
+			strRemove( m_fileName );
+		}
+	}
+
+	/**
+		@brief starts the posting list of a new term
+		@param [in] term the term, must be greater than the previous one
+	*/
+	void beginTerm( const char *term );
+	/**
+		@brief adds the positions of the current term within a source
+		@param [in] sourceID the id of the source, must be greater than the previous one
+		@param [in] positions the positions of the term
+	*/
+	void addPositions( std::size_t sourceID, const Positions &positions );
+	/**
+		@brief writes the term dictionary and the header
+
+		If finish is not called, the file is removed.
+
+		@exception WriteError in case of an I/O error
+	*/
+	void finish();
+};
+
+/**
+	@brief an immutable index segment mapped into memory
+
+	The term dictionary is sorted. Thus a word is found by a binary search and
+	only the posting lists of the words searched are decoded. The operating
+	system loads the pages of the file on demand, only.
+
+	@tparam SourceT the type that identifies a document
+	@see IndexSegmentWriter, SegmentedIndex, Index
+*/
+template<typename SourceT>
+class IndexSegment : public IndexSearcher<SourceT, IndexSegment<SourceT> >
+{
+	public:
+	typedef typename IndexSearcher<SourceT, IndexSegment<SourceT> >::SearchResult	SearchResult;
+	typedef SharedPointer<IndexSegment>												Pointer;
+
+	/// decodes the posting list of a term
+	class PostingReader
+	{
+		const IndexSegment		&m_segment;
+		const unsigned char		*m_ptr, *m_end;
+		std::size_t				m_remaining, m_sourceID;
+
+		uint64 readVarint();
+
+		public:
+		/**
+			@brief prepares reading a posting list
+			@param [in] segment the segment
+			@param [in] termIdx the index of the term in the dictionary
+		*/
+		PostingReader( const IndexSegment &segment, std::size_t termIdx );
+		/**
+			@brief decodes the next source of the posting list
+			@param [out] oSourceID the id of the source
+			@param [out] oPositions the positions of the term within the source
+			@return false if there are no more sources
+			@exception ReadError if the file is corrupted
+		*/
+		bool next( std::size_t *oSourceID, Positions *oPositions );
+	};
+
+	private:
+	MemoryMappedFile			m_file;
+	const IndexSegmentHeader	*m_header;
+	const IndexSegmentTerm		*m_dictionary;
+	const char					*m_termText;
+	std::size_t					m_termTextSize;
+	SortedArray<SourceT>		m_sources;
+
+	// no copy
+	IndexSegment( const IndexSegment & );
+	const IndexSegment &operator = ( const IndexSegment & );
+
+	public:
+	/**
+		@brief opens an index segment file
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be opened
+		@exception BadHeaderError if the file is not a valid index segment
+	*/
+	explicit IndexSegment( const STRING &fileName );
+
+	/// returns the name of the file
+	const STRING &getFileName() const
+	{
+		return m_file.getFileName();
+	}
+	/// returns the number of terms
+	std::size_t size() const
+	{
+		return std::size_t( m_header->m_numTerms );
+	}
+	/// returns the term at a given position of the dictionary
+	const char *getTerm( std::size_t termIdx ) const
+	{
+		return m_termText + m_dictionary[termIdx].m_termOffset;
+	}
+	/// returns the number of sources that contain a term
+	std::size_t getNumSources( std::size_t termIdx ) const
+	{
+		return m_dictionary[termIdx].m_numSources;
+	}
+	/// returns the index of a term in the dictionary or no_index if it was not found
+	std::size_t findTerm( const char *term ) const;
+	/// returns the table of all sources sorted, the id of a source is its position
+	const SortedArray<SourceT> &getSources() const
+	{
+		return m_sources;
+	}
+
+	/// returns the documents and positions of a single word
+	SearchResult getWordHits( const STRING &word ) const
+	{
+		SearchResult	result;
+		std::size_t		termIdx = findTerm( word.isEmpty() ? "" : word.c_str() );
+		if( termIdx != Container::no_index )
+		{
+			getTermHits( termIdx, &result );
+		}
+		return result;
+	}
+	/**
+		@brief decodes the posting list of a term
+		@param [in] termIdx the index of the term in the dictionary
+		@param [in,out] oResult receives the sources and positions
+	*/
+	void getTermHits( std::size_t termIdx, SearchResult *oResult ) const;
+	/// returns all words of this segment
+	Array<STRING> getKeys() const;
+};
+
+/**
+	@brief an index that consists of several immutable segments
+
+	New documents are indexed in memory with an Index that is written as
+	a new segment with writeIndexSegment. From time to time the segments can
+	be merged to a single segment, e.g. with an IndexMergeThread in
+	background, while the index is still used for searching.
+
+	If the same source is stored in different segments, the positions are
+	combined.
+
+	@tparam SourceT the type that identifies a document
+	@see IndexSegment, IndexMergeThread
+*/
+template<typename SourceT>
+class SegmentedIndex : public IndexSearcher<SourceT, SegmentedIndex<SourceT> >
+{
+	public:
+	typedef typename IndexSearcher<SourceT, SegmentedIndex<SourceT> >::SearchResult	SearchResult;
+	typedef typename IndexSegment<SourceT>::Pointer									SegmentPointer;
+	typedef Array<SegmentPointer>													Segments;
+
+	private:
+	Segments		m_segments;
+	mutable Locker	m_locker;
+	/// serializes mergeSegments, only addSegment may change m_segments while merging
+	Locker			m_mergeLocker;
+
+	public:
+	/**
+		@brief adds a segment file to this index
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be opened
+		@exception BadHeaderError if the file is not a valid index segment
+	*/
+	void addSegment( const STRING &fileName )
+	{
+		SegmentPointer	segment = SegmentPointer::makeShared( fileName );
+		LockGuard		lock( m_locker );
+
+		m_segments.addElement( segment );
+	}
+	/// returns a snapshot of the current segments
+	Segments getSegments() const
+	{
+		LockGuard		lock( m_locker );
+		return m_segments;
+	}
+	/// returns the number of segments
+	std::size_t getNumSegments() const
+	{
+		LockGuard		lock( m_locker );
+		return m_segments.size();
+	}
+
+	/// returns the documents and positions of a single word
+	SearchResult getWordHits( const STRING &word ) const;
+	/// returns all words of this index
+	Array<STRING> getKeys() const;
+
+	/**
+		@brief merges all current segments to a new segment file
+
+		Searching is possible while the segments are merged. After the new
+		segment is ready, it replaces the old segments. Segments that were added
+		while merging are kept. The old files are not deleted. Concurrent calls
+		are executed one after the other.
+
+		@param [in] fileName the name of the new file
+		@return the names of the files that were merged
+		@exception WriteError in case of an I/O error
+	*/
+	Array<STRING> mergeSegments( const STRING &fileName );
+};
+
+/**
+	@brief a thread that merges the segments of a SegmentedIndex in background
+	@tparam SourceT the type that identifies a document
+	@see SegmentedIndex::mergeSegments
+*/
+template<typename SourceT>
+class IndexMergeThread : public Thread
+{
+	SegmentedIndex<SourceT>	&m_index;
+	STRING					m_fileName;
+	Array<STRING>			m_mergedFiles;
+	bool					m_success;
+
+	virtual void ExecuteThread()
+	{
+		try
+		{
+			m_mergedFiles = m_index.mergeSegments( m_fileName );
+			m_success = true;
+		}
+		catch( std::exception &e )
+		{
+			doLogMessageEx( gakLogging::llError, e.what() );
+		}
+	}
+
+	public:
+	/**
+		@brief creates the thread, call StartThread to start merging
+		@param [in] index the index to merge
+		@param [in] fileName the name of the new segment file
+	*/
+	IndexMergeThread( SegmentedIndex<SourceT> &index, const STRING &fileName )
+	: Thread( false ), m_index( index ), m_fileName( fileName ), m_success( false )
+	{
+	}
+	/// returns true if the merge was successful
+	bool isSuccess() const
+	{
+		return m_success;
+	}
+	/// returns the names of the files merged, these files are no longer used by the index
+	const Array<STRING> &getMergedFiles() const
+	{
+		return m_mergedFiles;
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template<typename SourceT>
+void mergeIndexSegments(
+	const typename SegmentedIndex<SourceT>::Segments &segments, const STRING &fileName
+);
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+template<typename SourceT>
+IndexSegmentWriter<SourceT>::IndexSegmentWriter(
+	const STRING &fileName, const SortedArray<SourceT> &sources
+) : m_fileName( fileName ), m_stream( fileName, std::ios_base::binary ), m_sources( sources ),
+	m_lastSource( 0 ), m_finished( false )
+{
+	if( !m_stream )
+	{
+/*@*/	throw OpenWriteError( fileName );
+	}
+
+	// the header is written by finish
+	IndexSegmentHeader	header;
+	memset( &header, 0, sizeof( header ) );
+	m_stream.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+	checkStream();
+}
+
+template<typename SourceT>
+IndexSegment<SourceT>::IndexSegment( const STRING &fileName ) : m_file( fileName )
+{
+	const char	*data = m_file.getData();
+	std::size_t	fileSize = m_file.size();
+
+	m_header = reinterpret_cast<const IndexSegmentHeader *>( data );
+	if( fileSize < sizeof( IndexSegmentHeader )
+	|| m_header->m_magic != INDEX_SEGMENT_MAGIC
+	|| m_header->m_version != INDEX_SEGMENT_VERSION
+	|| m_header->m_fileSize != fileSize
+	|| m_header->m_sourcesOffset > m_header->m_dictOffset
+	|| m_header->m_dictOffset > m_header->m_termsOffset
+	|| m_header->m_termsOffset > fileSize
+	|| m_header->m_dictOffset % sizeof( uint64 )
+	|| (m_header->m_termsOffset - m_header->m_dictOffset) / sizeof( IndexSegmentTerm ) != m_header->m_numTerms )
+	{
+/*@*/	throw BadHeaderError( fileName );
+	}
+
+	m_dictionary = reinterpret_cast<const IndexSegmentTerm *>( data + m_header->m_dictOffset );
+	m_termText = data + m_header->m_termsOffset;
+	m_termTextSize = std::size_t( fileSize - m_header->m_termsOffset );
+
+	// the terms and the posting lists are used without further checks
+	for( std::size_t i=0; i<m_header->m_numTerms; ++i )
+	{
+		const IndexSegmentTerm	&term = m_dictionary[i];
+		if( term.m_termOffset >= m_termTextSize
+		|| term.m_termLen >= m_termTextSize - term.m_termOffset
+		|| m_termText[term.m_termOffset + term.m_termLen]
+		|| term.m_postingOffset < sizeof( IndexSegmentHeader )
+		|| term.m_postingOffset > m_header->m_sourcesOffset )
+		{
+/*@*/		throw BadHeaderError( fileName );
+		}
+	}
+
+	IndexSegmentBuffer	buffer(
+		data + m_header->m_sourcesOffset,
+		std::size_t( m_header->m_dictOffset - m_header->m_sourcesOffset )
+	);
+	std::istream		stream( &buffer );
+	try
+	{
+		m_sources.fromBinaryStream( stream );
+	}
+	catch( LibraryException &e )
+	{
+		e.addErrorText( fileName );
+		throw;
+	}
+	if( m_sources.size() != m_header->m_numSources )
+	{
+/*@*/	throw BadHeaderError( fileName );
+	}
+}
+
+template<typename SourceT>
+IndexSegment<SourceT>::PostingReader::PostingReader(
+	const IndexSegment &segment, std::size_t termIdx
+) : m_segment( segment ), m_sourceID( 0 )
+{
+	const IndexSegmentTerm	&term = segment.m_dictionary[termIdx];
+	const char				*data = segment.m_file.getData();
+
+	m_ptr = reinterpret_cast<const unsigned char *>( data + term.m_postingOffset );
+	m_end = reinterpret_cast<const unsigned char *>( data + segment.m_header->m_sourcesOffset );
+	m_remaining = term.m_numSources;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template<typename SourceT>
+uint64 IndexSegment<SourceT>::PostingReader::readVarint()
+{
+	uint64	value = 0;
+	for( unsigned shift = 0; ; shift += 7 )
+	{
+		if( m_ptr >= m_end || shift > 63 )
+		{
+/*@*/		throw ReadError( m_segment.getFileName() );
+		}
+		unsigned char	c = *m_ptr++;
+		value |= uint64( c & 0x7F ) << shift;
+		if( !(c & 0x80) )
+		{
+/*v*/		break;
+		}
+	}
+	return value;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template<typename SourceT>
+void IndexSegmentWriter<SourceT>::beginTerm( const char *term )
+{
+	assert( !m_terms.size()
+		|| compareTerms( m_termText.getDataBuffer() + m_terms[m_terms.size()-1].m_termOffset, term ) < 0 );
+
+	IndexSegmentTerm	&entry = m_terms.createElement();
+	std::size_t			len = strlen( term );
+
+	entry.m_termOffset = m_termText.size();
+	entry.m_postingOffset = getOffset();
+	entry.m_termLen = uint32( len );
+	entry.m_numSources = 0;
+
+	m_termText.addElements( term, len+1 );
+	m_lastSource = 0;
+}
+
+template<typename SourceT>
+void IndexSegmentWriter<SourceT>::addPositions( std::size_t sourceID, const Positions &positions )
+{
+	IndexSegmentTerm	&entry = m_terms[m_terms.size()-1];
+
+	assert( sourceID < m_sources.size() );
+	assert( !entry.m_numSources || sourceID > m_lastSource );
+
+	writeVarint( sourceID - m_lastSource );
+	writeVarint( positions.size() );
+
+	std::size_t	lastStart = 0;
+	for(
+		Positions::const_iterator it = positions.cbegin(), endIT = positions.cend();
+		it != endIT;
+		++it
+	)
+	{
+		writeVarint( it->m_start - lastStart );
+		writeVarint( it->m_len );
+		writeVarint( it->m_flags );
+		lastStart = it->m_start;
+	}
+	checkStream();
+
+	m_lastSource = sourceID;
+	++entry.m_numSources;
+}
+
+template<typename SourceT>
+void IndexSegmentWriter<SourceT>::finish()
+{
+	IndexSegmentHeader	header;
+	memset( &header, 0, sizeof( header ) );
+
+	header.m_magic = INDEX_SEGMENT_MAGIC;
+	header.m_version = INDEX_SEGMENT_VERSION;
+	header.m_numTerms = m_terms.size();
+	header.m_numSources = m_sources.size();
+
+	try
+	{
+		header.m_sourcesOffset = getOffset();
+		m_sources.toBinaryStream( m_stream );
+
+		// align the dictionary
+		static const char	padding[sizeof(uint64)] = { 0 };
+		header.m_dictOffset = getOffset();
+		std::size_t	padSize = std::size_t( (sizeof(uint64) - header.m_dictOffset % sizeof(uint64)) % sizeof(uint64) );
+		m_stream.write( padding, padSize );
+		header.m_dictOffset += padSize;
+
+		m_stream.write(
+			reinterpret_cast<const char *>( m_terms.getDataBuffer() ),
+			m_terms.size() * sizeof( IndexSegmentTerm )
+		);
+		header.m_termsOffset = getOffset();
+		m_stream.write( m_termText.getDataBuffer(), m_termText.size() );
+		header.m_fileSize = getOffset();
+
+		m_stream.seekp( 0 );
+		m_stream.write( reinterpret_cast<const char *>( &header ), sizeof( header ) );
+		m_stream.close();
+		checkStream();
+	}
+	catch( LibraryException &e )
+	{
+		e.addErrorText( m_fileName );
+		throw;
+	}
+	m_finished = true;
+}
+
+template<typename SourceT>
+bool IndexSegment<SourceT>::PostingReader::next( std::size_t *oSourceID, Positions *oPositions )
+{
+	if( !m_remaining )
+	{
+		return false;
+	}
+	--m_remaining;
+
+	m_sourceID += std::size_t( readVarint() );
+	if( m_sourceID >= m_segment.m_sources.size() )
+	{
+/*@*/	throw ReadError( m_segment.getFileName() );
+	}
+
+	std::size_t	numPositions = std::size_t( readVarint() );
+	std::size_t	start = 0;
+
+	oPositions->clear();
+	oPositions->setChunkSize( numPositions );
+	for( std::size_t i=0; i<numPositions; ++i )
+	{
+		start += std::size_t( readVarint() );
+		std::size_t	len = std::size_t( readVarint() );
+		uint16		flags = uint16( readVarint() );
+		oPositions->addElement( Position( start, len, flags ) );
+	}
+
+	*oSourceID = m_sourceID;
+	return true;
+}
+
+template<typename SourceT>
+std::size_t IndexSegment<SourceT>::findTerm( const char *term ) const
+{
+	std::size_t	min = 0, max = size();
+
+	while( min < max )
+	{
+		std::size_t	mid = min + (max - min)/2;
+		int			compareResult = compareTerms( getTerm( mid ), term );
+		if( !compareResult )
+		{
+			return mid;
+		}
+		else if( compareResult < 0 )
+		{
+			min = mid+1;
+		}
+		else
+		{
+			max = mid;
+		}
+	}
+	return Container::no_index;
+}
+
+template<typename SourceT>
+void IndexSegment<SourceT>::getTermHits( std::size_t termIdx, SearchResult *oResult ) const
+{
+	PostingReader	reader( *this, termIdx );
+	std::size_t		sourceID;
+	Positions		positions;
+
+	oResult->setChunkSize( oResult->size() + getNumSources( termIdx ) );
+	while( reader.next( &sourceID, &positions ) )
+	{
+		Positions	&target = (*oResult)[m_sources[sourceID]];
+		if( target.size() )
+		{
+			target.moveFrom( ref( unionSet( target, positions ) ) );
+		}
+		else
+		{
+			target.moveFrom( positions );
+		}
+	}
+}
+
+template<typename SourceT>
+Array<STRING> IndexSegment<SourceT>::getKeys() const
+{
+	Array<STRING>	result;
+
+	result.setChunkSize( size() );
+	for( std::size_t i=0; i<size(); ++i )
+	{
+		result.addElement( getTerm( i ) );
+	}
+	return result;
+}
+
+template<typename SourceT>
+typename SegmentedIndex<SourceT>::SearchResult SegmentedIndex<SourceT>::getWordHits( const STRING &word ) const
+{
+	Segments		segments = getSegments();
+	SearchResult	result;
+	const char		*term = word.isEmpty() ? "" : word.c_str();
+
+	for(
+		typename Segments::const_iterator it = segments.cbegin(), endIT = segments.cend();
+		it != endIT;
+		++it
+	)
+	{
+		std::size_t	termIdx = (*it)->findTerm( term );
+		if( termIdx != Container::no_index )
+		{
+			(*it)->getTermHits( termIdx, &result );
+		}
+	}
+	return result;
+}
+
+template<typename SourceT>
+Array<STRING> SegmentedIndex<SourceT>::getKeys() const
+{
+	Segments	segments = getSegments();
+
+	if( segments.size() == 1 )
+	{
+		return segments[0]->getKeys();
+	}
+
+	HashSet<STRING>	keys;
+	for(
+		typename Segments::const_iterator it = segments.cbegin(), endIT = segments.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const IndexSegment<SourceT>	&segment = **it;
+		for( std::size_t i=0; i<segment.size(); ++i )
+		{
+			keys.addElement( segment.getTerm( i ) );
+		}
+	}
+
+	Array<STRING>	result;
+	result.setChunkSize( keys.size() );
+	for(
+		HashSet<STRING>::const_iterator it = keys.cbegin(), endIT = keys.cend();
+		it != endIT;
+		++it
+	)
+	{
+		result.addElement( *it );
+	}
+	return result;
+}
+
+template<typename SourceT>
+Array<STRING> SegmentedIndex<SourceT>::mergeSegments( const STRING &fileName )
+{
+	LockGuard		mergeLock( m_mergeLocker );
+	Segments		segments = getSegments();
+	Array<STRING>	mergedFiles;
+
+	if( !segments.size() )
+	{
+		return mergedFiles;
+	}
+
+	mergeIndexSegments<SourceT>( segments, fileName );
+	SegmentPointer	merged = SegmentPointer::makeShared( fileName );
+
+	LockGuard		lock( m_locker );
+
+	// segments added meanwhile are kept, they follow the segments merged
+	Segments	newSegments;
+	newSegments.addElement( merged );
+	for( std::size_t i=segments.size(); i<m_segments.size(); ++i )
+	{
+		newSegments.addElement( m_segments[i] );
+	}
+	m_segments.moveFrom( newSegments );
+
+	for( std::size_t i=0; i<segments.size(); ++i )
+	{
+		mergedFiles.addElement( segments[i]->getFileName() );
+	}
+	return mergedFiles;
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief writes an index to a new segment file
+	@param [in] index the index to write
+	@param [in] fileName the name of the new file
+	@exception OpenWriteError if the file could not be created
+	@exception WriteError in case of an I/O error
+	@see IndexSegment, SegmentedIndex
+*/
+template<typename SourceT>
+void writeIndexSegment( const Index<SourceT> &index, const STRING &fileName )
+{
+	doEnterFunctionEx( gakLogging::llInfo, "writeIndexSegment" );
+
+	typedef typename Index<SourceT>::SearchIndex	SearchIndex;
+	typedef typename Index<SourceT>::SearchResult	SearchResult;
+
+	const SearchIndex	&searchIndex = index.getSearchIndex();
+
+	// collect all sources
+	Set<SourceT>	sources;
+	for(
+		typename SearchIndex::const_iterator it = searchIndex.cbegin(), endIT = searchIndex.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const SearchResult	&hits = it->getValue();
+		for(
+			typename SearchResult::const_iterator it = hits.cbegin(), endIT = hits.cend();
+			it != endIT;
+			++it
+		)
+		{
+			sources.addElement( it->getKey() );
+		}
+	}
+
+	PODarray<std::size_t>	termOrder = index.getSortedWords();
+
+	// write the posting lists
+	IndexSegmentWriter<SourceT>		writer( fileName, sources );
+	PODarray<std::size_t>			sourceIDs;
+	// only the entries of the sources of the current term are valid
+	PODarray<const Positions*>		sourcePositions;
+	sourcePositions.setSize( sources.size() );
+	for(
+		PODarray<std::size_t>::const_iterator it = termOrder.cbegin(), endIT = termOrder.cend();
+		it != endIT;
+		++it
+	)
+	{
+		const SearchResult	&hits = searchIndex.getValueAt( *it );
+		if( !hits.size() )
+		{
+			continue;
+		}
+
+		// sort the sources by their ids
+		sourceIDs.clear();
+		for(
+			typename SearchResult::const_iterator it = hits.cbegin(), endIT = hits.cend();
+			it != endIT;
+			++it
+		)
+		{
+			std::size_t	sourceID = sources.findElement( it->getKey() );
+			sourceIDs.addElement( sourceID );
+			sourcePositions[sourceID] = &it->getValue();
+		}
+		if( sourceIDs.size() > 1 )
+		{
+			sourceIDs.sort( FixedComparator<std::size_t>() );
+		}
+
+		writer.beginTerm( searchIndex.getKeyAt( *it ).c_str() );
+		for( std::size_t i=0; i<sourceIDs.size(); ++i )
+		{
+			writer.addPositions( sourceIDs[i], *sourcePositions[sourceIDs[i]] );
+		}
+	}
+	writer.finish();
+}
+
+/**
+	@brief merges several index segments to a new segment file
+	@param [in] segments the segments to merge
+	@param [in] fileName the name of the new file
+	@exception OpenWriteError if the file could not be created
+	@exception WriteError in case of an I/O error
+	@see SegmentedIndex::mergeSegments
+*/
+template<typename SourceT>
+void mergeIndexSegments(
+	const typename SegmentedIndex<SourceT>::Segments &segments, const STRING &fileName
+)
+{
+	doEnterFunctionEx( gakLogging::llInfo, "mergeIndexSegments" );
+
+	typedef typename IndexSegment<SourceT>::PostingReader	PostingReader;
+
+	const std::size_t	numSegments = segments.size();
+
+	// combine the source tables, the order of the ids does not change
+	Set<SourceT>	sources;
+	for( std::size_t i=0; i<numSegments; ++i )
+	{
+		sources.addElements( segments[i]->getSources() );
+	}
+	Array< PODarray<std::size_t> >	idMaps;
+	idMaps.setSize( numSegments );
+	for( std::size_t i=0; i<numSegments; ++i )
+	{
+		const SortedArray<SourceT>	&segmentSources = segments[i]->getSources();
+		PODarray<std::size_t>		&idMap = idMaps[i];
+
+		idMap.setChunkSize( segmentSources.size() );
+		for( std::size_t j=0; j<segmentSources.size(); ++j )
+		{
+			idMap.addElement( sources.findElement( segmentSources[j] ) );
+		}
+	}
+
+	IndexSegmentWriter<SourceT>	writer( fileName, sources );
+
+	// k-way merge of the term dictionaries
+	PODarray<std::size_t>	termPos;
+	PODarray<std::size_t>	current;
+	termPos.setSize( numSegments );
+	for( std::size_t i=0; i<numSegments; ++i )
+	{
+		termPos[i] = 0;
+	}
+
+	Array<PostingReader*>	readers;
+	PODarray<std::size_t>	readerIDs;
+	Array<Positions>		readerPositions;
+	readerIDs.setSize( numSegments );
+	readerPositions.setSize( numSegments );
+
+	for(;;)
+	{
+		const char	*term = nullptr;
+		current.clear();
+		for( std::size_t i=0; i<numSegments; ++i )
+		{
+			if( termPos[i] < segments[i]->size() )
+			{
+				const char	*segmentTerm = segments[i]->getTerm( termPos[i] );
+				int			compareResult = term ? compareTerms( segmentTerm, term ) : -1;
+				if( compareResult < 0 )
+				{
+					term = segmentTerm;
+					current.clear();
+				}
+				if( compareResult <= 0 )
+				{
+					current.addElement( i );
+				}
+			}
+		}
+		if( !term )
+		{
+/*v*/		break;
+		}
+
+		// k-way merge of the posting lists
+		readers.clear();
+		for( std::size_t i=0; i<current.size(); ++i )
+		{
+			std::size_t	segIdx = current[i];
+			readers.addElement( new PostingReader( *segments[segIdx], termPos[segIdx] ) );
+		}
+		try
+		{
+			std::size_t	numActive = 0;
+			for( std::size_t i=0; i<readers.size(); ++i )
+			{
+				std::size_t	sourceID;
+				if( readers[i]->next( &sourceID, &readerPositions[i] ) )
+				{
+					readerIDs[i] = idMaps[current[i]][sourceID];
+					++numActive;
+				}
+				else
+				{
+					readerIDs[i] = Container::no_index;
+				}
+			}
+
+			writer.beginTerm( term );
+			Positions	positions;
+			while( numActive )
+			{
+				std::size_t	minID = Container::no_index;
+				for( std::size_t i=0; i<readers.size(); ++i )
+				{
+					if( readerIDs[i] < minID )
+					{
+						minID = readerIDs[i];
+					}
+				}
+
+				positions.clear();
+				for( std::size_t i=0; i<readers.size(); ++i )
+				{
+					if( readerIDs[i] == minID )
+					{
+						if( positions.size() )
+						{
+							positions.moveFrom( ref( unionSet( positions, readerPositions[i] ) ) );
+						}
+						else
+						{
+							positions.moveFrom( readerPositions[i] );
+						}
+
+						std::size_t	sourceID;
+						if( readers[i]->next( &sourceID, &readerPositions[i] ) )
+						{
+							readerIDs[i] = idMaps[current[i]][sourceID];
+						}
+						else
+						{
+							readerIDs[i] = Container::no_index;
+							--numActive;
+						}
+					}
+				}
+				writer.addPositions( minID, positions );
+			}
+		}
+		catch( ... )
+		{
+			for( std::size_t i=0; i<readers.size(); ++i )
+			{
+				delete readers[i];
+			}
+			throw;
+		}
+		for( std::size_t i=0; i<readers.size(); ++i )
+		{
+			delete readers[i];
+		}
+
+		for( std::size_t i=0; i<current.size(); ++i )
+		{
+			++termPos[current[i]];
+		}
+	}
+
+	writer.finish();
+}
+
+}	// namespace ai
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_INDEX_SEGMENT_H
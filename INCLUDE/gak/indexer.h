@@ -36,6 +36,10 @@
 // ----- switches ------------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+#ifndef USE_HASH_MAP
+#define USE_HASH_MAP	1		// hash map is best for both, indexing and searching
+#endif
+
 #ifndef USE_PAIR_MAP
 #define USE_PAIR_MAP	1		// for searching pair map is better than TreeMap that is better for indexing
 #endif
@@ -45,12 +49,14 @@
 // --------------------------------------------------------------------- //
 
 #include <cstddef>
+#include <cstring>
 
 #include <gak/utils.h>
 #include <gak/array.h>
 #include <gak/string.h>
 #include <gak/map.h>
 #include <gak/set.h>
+#include <gak/hashMap.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -107,8 +113,10 @@ inline bool isSpecialIndex( const STRING &index )
 #	pragma warn +inl
 #endif
 
-/// TODO PairMap has performance problems with large database. Analyse whether we should remove the option to use a pairmap
-#if USE_PAIR_MAP
+/// PairMap has performance problems with large database, HashMap finds and adds words in O(1)
+#if USE_HASH_MAP
+#define IndexerMap HashMap
+#elif USE_PAIR_MAP
 #define IndexerMap PairMap
 #else
 #define IndexerMap TreeMap
@@ -195,8 +203,19 @@ struct StatistikEntry
 
 typedef Btree<StatistikEntry>	StatistikData;
 
-template<typename SourceT>
-class Index
+/**
+	@brief the search functions of an inverted index
+
+	IndexT must provide the hits of a single word and the list of all words:
+	- SearchResult getWordHits( const STRING &word ) const
+	- Array<STRING> getKeys() const
+
+	@tparam SourceT the type that identifies a document
+	@tparam IndexT the class of the index
+	@see Index, IndexSegment, SegmentedIndex
+*/
+template<typename SourceT, typename IndexT>
+class IndexSearcher
 {
 	public:
 	struct HitRelevance
@@ -221,31 +240,17 @@ class Index
 	typedef IndexerMap<SourceT, Positions>		SearchResult;
 
 	private:
-	typedef IndexerMap<STRING, SearchResult>	SearchIndex;
-
-	private:
-	SearchIndex	m_searchIndex;
+	static void mergeWordHits( SearchResult *target, const SearchResult &source );
+	static void intersect(SearchResult *target, const SearchResult &source);
+	static void substract(SearchResult *target, const SearchResult &source);
 
-
-	private:
-	void mergeWordHits( SearchResult *target, const SearchResult &source );
-	void intersect(SearchResult *target, const SearchResult &source);
-	void substract(SearchResult *target, const SearchResult &source);
-
-	SearchResult findWord( const STRING &word )
+	SearchResult findWord( const STRING &word ) const
 	{
-		SearchResult	result;
-
-		std::size_t		index;
-		if( (index = m_searchIndex.getElementIndex( word )) != m_searchIndex.no_index )
-		{
-			result = m_searchIndex.getElementAt(index).getValue();
-		}
-		return result;
+		return static_cast<const IndexT*>(this)->getWordHits( word );
 	}
-	SearchResult findPattern( const Array<STRING> &keys, const STRING &pattern );
+	SearchResult findPattern( const Array<STRING> &keys, const STRING &pattern ) const;
 
-	SearchResult findFuzzyWord( const STRING &word )
+	SearchResult findFuzzyWord( const STRING &word ) const
 	{
 		STRING			fuzyWord = word.simplify();
 		SearchResult	result = findWord( fuzyWord );
@@ -257,7 +262,7 @@ class Index
 
 		return result;
 	}
-	SearchResult findFuzzyPattern( const Array<STRING> &keys, const STRING &pattern )
+	SearchResult findFuzzyPattern( const Array<STRING> &keys, const STRING &pattern ) const
 	{
 		STRING			fuzyPattern = pattern.simplify();
 		SearchResult	result = findPattern( keys, fuzyPattern );
@@ -269,7 +274,7 @@ class Index
 
 		return result;
 	}
-	SearchResult findLowerWord( const STRING &word )
+	SearchResult findLowerWord( const STRING &word ) const
 	{
 		STRING			lowerWord = word.lowerCaseCopy();
 		SearchResult	result = findWord( lowerWord );
@@ -283,7 +288,7 @@ class Index
 	}
 	SearchResult findLowerPattern(
 		const Array<STRING> &keys, const STRING &pattern
-	)
+	) const
 	{
 		STRING			lowerPattern = pattern.lowerCaseCopy();
 		SearchResult	result = findPattern( keys, lowerPattern );
@@ -297,7 +302,7 @@ class Index
 	}
 	SearchResult findWord(
 		const STRING &word, bool withFuzzy, bool caseInsensitive
-	)
+	) const
 	{
 		SearchResult result = findWord( word );
 		if( withFuzzy )
@@ -313,7 +318,7 @@ class Index
 	SearchResult findPattern(
 		const Array<STRING> &keys, const STRING &pattern,
 		bool withFuzzy, bool caseInsensitive
-	)
+	) const
 	{
 		SearchResult  result = findPattern( keys, pattern );
 		if( withFuzzy )
@@ -330,10 +335,31 @@ class Index
 
 	SearchResult findWords(
 		const ArrayOfStrings &wordList, bool withFuzzy, bool caseInsensitive
-	);
+	) const;
 	SearchResult findPatterns(
 		const ArrayOfStrings &patternList, bool withFuzzy, bool caseInsensitive
-	);
+	) const;
+
+	public:
+	SearchResult findWords(
+		const STRING &words,
+		bool withFuzzy, bool caseInsensitive, bool withWildcards
+	) const;
+	RelevantHits getRelevantHits( 
+		const STRING &words,
+		bool withFuzzy, bool caseInsensitive, bool withWildcards
+	) const;
+};
+
+template<typename SourceT>
+class Index : public IndexSearcher<SourceT, Index<SourceT> >
+{
+	public:
+	typedef typename IndexSearcher<SourceT, Index<SourceT> >::SearchResult	SearchResult;
+	typedef IndexerMap<STRING, SearchResult>								SearchIndex;
+
+	private:
+	SearchIndex	m_searchIndex;
 
 	public:
 	size_t size() const
@@ -360,16 +386,39 @@ class Index
 	{
 		return m_searchIndex.hasElement(text);
 	}
+	/// returns the documents and positions of a single word
+	SearchResult getWordHits( const STRING &word ) const
+	{
+		SearchResult	result;
+
+		std::size_t		index;
+		if( (index = m_searchIndex.getElementIndex( word )) != m_searchIndex.no_index )
+		{
+			result = m_searchIndex.getElementAt(index).getValue();
+		}
+		return result;
+	}
+	/// returns all words of this index
+	Array<STRING> getKeys() const
+	{
+		return m_searchIndex.getKeys();
+	}
+	/// returns the words with their documents and positions
+	const SearchIndex &getSearchIndex() const
+	{
+		return m_searchIndex;
+	}
+
+	/**
+		@brief moves the hits of a word into this index
+		@param [in] word the word
+		@param [in,out] hits the documents and positions of the word, will be empty after return
+	*/
+	void moveWordHits( const STRING &word, SearchResult *hits );
+	/// returns the positions of all words in the order of compareTerms
+	PODarray<std::size_t> getSortedWords() const;
 
 	void getStatistik(StatistikData *result) const;
-	SearchResult findWords(
-		const STRING &words,
-		bool withFuzzy, bool caseInsensitive, bool withWildcards
-	);
-	RelevantHits getRelevantHits( 
-		const STRING &words,
-		bool withFuzzy, bool caseInsensitive, bool withWildcards
-	);
 
 	void clear()
 	{
@@ -401,6 +450,12 @@ class Index
 // ----- module functions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// compares two words of an index by their bytes
+inline int compareTerms( const char *term1, const char *term2 )
+{
+	return strcmp( term1, term2 );
+}
+
 // --------------------------------------------------------------------- //
 // ----- class inlines ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -417,8 +472,8 @@ class Index
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
-template<typename SourceT>
-void Index<SourceT>::mergeWordHits( SearchResult *target, const SearchResult &source )
+template<typename SourceT, typename IndexT>
+void IndexSearcher<SourceT, IndexT>::mergeWordHits( SearchResult *target, const SearchResult &source )
 {
 	for(
 		typename SearchResult::const_iterator it = source.cbegin(), endIT = source.cend();
@@ -437,8 +492,8 @@ void Index<SourceT>::mergeWordHits( SearchResult *target, const SearchResult &so
 	}
 }
 
-template<typename SourceT>
-void Index<SourceT>::intersect(SearchResult *target, const SearchResult &source)
+template<typename SourceT, typename IndexT>
+void IndexSearcher<SourceT, IndexT>::intersect(SearchResult *target, const SearchResult &source)
 {
 	for( std::size_t i = 0; i<target->size(); ++i )
 	{
@@ -462,8 +517,8 @@ void Index<SourceT>::intersect(SearchResult *target, const SearchResult &source)
 	}
 }
 
-template<typename SourceT>
-void Index<SourceT>::substract(SearchResult *target, const SearchResult &source)
+template<typename SourceT, typename IndexT>
+void IndexSearcher<SourceT, IndexT>::substract(SearchResult *target, const SearchResult &source)
 {
 	for( std::size_t i = 0; i<target->size(); ++i )
 	{
@@ -476,10 +531,10 @@ void Index<SourceT>::substract(SearchResult *target, const SearchResult &source)
 	}
 }
 
-template<typename SourceT>
-typename Index<SourceT>::SearchResult Index<SourceT>::findPattern(
+template<typename SourceT, typename IndexT>
+typename IndexSearcher<SourceT, IndexT>::SearchResult IndexSearcher<SourceT, IndexT>::findPattern(
 	const Array<STRING> &keys, const STRING &pattern
-)
+) const
 {
 	SearchResult	result;
 
@@ -498,11 +553,11 @@ typename Index<SourceT>::SearchResult Index<SourceT>::findPattern(
 	return result;
 }
 
-template<typename SourceT>
-typename Index<SourceT>::SearchResult Index<SourceT>::findWords(
+template<typename SourceT, typename IndexT>
+typename IndexSearcher<SourceT, IndexT>::SearchResult IndexSearcher<SourceT, IndexT>::findWords(
 	const ArrayOfStrings &wordList,
 	bool withFuzzy, bool caseInsensitive
-)
+) const
 {
 	SearchResult	result;
 
@@ -539,14 +594,14 @@ typename Index<SourceT>::SearchResult Index<SourceT>::findWords(
 	return result;
 }
 
-template<typename SourceT>
-typename Index<SourceT>::SearchResult Index<SourceT>::findPatterns(
+template<typename SourceT, typename IndexT>
+typename IndexSearcher<SourceT, IndexT>::SearchResult IndexSearcher<SourceT, IndexT>::findPatterns(
 	const ArrayOfStrings &patternList,
 	bool withFuzzy, bool caseInsensitive
-)
+) const
 {
 	SearchResult	result;
-	Array<STRING>	keys = m_searchIndex.getKeys();
+	Array<STRING>	keys = static_cast<const IndexT*>(this)->getKeys();
 
 	for(
 		ArrayOfStrings::const_iterator it = patternList.cbegin(),
@@ -597,6 +652,71 @@ typename Index<SourceT>::SearchResult Index<SourceT>::findPatterns(
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+template<typename SourceT>
+void Index<SourceT>::moveWordHits( const STRING &word, SearchResult *hits )
+{
+	SearchResult	&target = m_searchIndex[word];
+	if( !target.size() )
+	{
+		target.moveFrom( *hits );
+	}
+	else
+	{
+		for(
+			typename SearchResult::iterator it = hits->begin(), endIT = hits->end();
+			it != endIT;
+			++it
+		)
+		{
+			Positions	&positions = target[it->getKey()];
+			if( positions.size() )
+			{
+				positions.moveFrom(
+					ref(
+						unionSet(
+							positions, it->getValue()
+						)
+					)
+				);
+			}
+			else
+			{
+				positions.moveFrom( const_cast<Positions&>(it->getValue()) );
+			}
+		}
+		hits->clear();
+	}
+}
+
+template<typename SourceT>
+PODarray<std::size_t> Index<SourceT>::getSortedWords() const
+{
+	struct WordComparator
+	{
+		const SearchIndex	&m_searchIndex;
+
+		WordComparator( const SearchIndex &searchIndex ) : m_searchIndex( searchIndex ) {}
+		int operator () ( std::size_t idx1, std::size_t idx2 ) const
+		{
+			return compareTerms(
+				m_searchIndex.getKeyAt( idx1 ).c_str(), m_searchIndex.getKeyAt( idx2 ).c_str()
+			);
+		}
+	};
+
+	PODarray<std::size_t>	result;
+	result.setChunkSize( m_searchIndex.size() );
+	for( std::size_t i=0; i<m_searchIndex.size(); ++i )
+	{
+		result.addElement( i );
+	}
+	if( result.size() > 1 )
+	{
+		result.sort( WordComparator( m_searchIndex ) );
+	}
+	return result;
+}
+
 template<typename SourceT>
 void Index<SourceT>::getStatistik(StatistikData *oResult) const
 {
@@ -630,7 +750,7 @@ template<typename SourceT>
 void Index<SourceT>::copyIndexPositions( const SourceT &source, const StringIndex &index )
 {
 	doEnterFunctionEx(gakLogging::llDetail,"SourcePosition::copyIndexPositions");
-#if USE_PAIR_MAP
+#if USE_PAIR_MAP || USE_HASH_MAP
 	m_searchIndex.setChunkSize( index.size() );
 #endif
 	for(
@@ -640,7 +760,7 @@ void Index<SourceT>::copyIndexPositions( const SourceT &source, const StringInde
 	)
 	{
 		SearchResult &sourceIndexPos = m_searchIndex[it->getKey()];
-#if USE_PAIR_MAP
+#if USE_PAIR_MAP && !USE_HASH_MAP
 		sourceIndexPos.setChunkSize(sourceIndexPos.size()/2);
 #endif
 		sourceIndexPos[source] = it->getValue();
@@ -651,7 +771,7 @@ template<typename SourceT>
 void Index<SourceT>::moveIndexPositions( const SourceT &source, StringIndex *index )
 {
 	doEnterFunctionEx(gakLogging::llDetail,"SourcePosition::moveIndexPositions");
-#if USE_PAIR_MAP
+#if USE_PAIR_MAP || USE_HASH_MAP
 	m_searchIndex.setChunkSize( index->size() );
 #endif
 	for(
@@ -661,7 +781,7 @@ void Index<SourceT>::moveIndexPositions( const SourceT &source, StringIndex *ind
 	)
 	{
 		SearchResult &sourceIndexPos = m_searchIndex[it->getKey()];
-#if USE_PAIR_MAP
+#if USE_PAIR_MAP && !USE_HASH_MAP
 		sourceIndexPos.setChunkSize(sourceIndexPos.size()/2);
 #endif
 		sourceIndexPos[source].moveFrom( const_cast<Positions&>(it->getValue()) );
@@ -670,11 +790,11 @@ void Index<SourceT>::moveIndexPositions( const SourceT &source, StringIndex *ind
 //	index->forget();
 }
 
-template<typename SourceT>
-typename Index<SourceT>::SearchResult Index<SourceT>::findWords(
+template<typename SourceT, typename IndexT>
+typename IndexSearcher<SourceT, IndexT>::SearchResult IndexSearcher<SourceT, IndexT>::findWords(
 	const STRING &words,
 	bool withFuzzy, bool caseInsensitive, bool withWildcards
-)
+) const
 {
 	ArrayOfStrings wordList;
 	wordList.createElements( words );
@@ -689,11 +809,11 @@ typename Index<SourceT>::SearchResult Index<SourceT>::findWords(
 	}
 }
 
-template<typename SourceT>
-typename Index<SourceT>::RelevantHits Index<SourceT>::getRelevantHits(
+template<typename SourceT, typename IndexT>
+typename IndexSearcher<SourceT, IndexT>::RelevantHits IndexSearcher<SourceT, IndexT>::getRelevantHits(
 	const STRING &words,
 	bool withFuzzy, bool caseInsensitive, bool withWildcards
-)
+) const
 {
 	SearchResult	seachResult = findWords( words, withFuzzy,caseInsensitive, withWildcards );
 	double			totalCount = 0;
@@ -79,6 +79,27 @@ namespace gak
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/**
+	@brief tells LockQueue, how to access a queue container
+
+	queue containers that are thread safe by them self may specialize this
+	template to avoid locking
+
+	@tparam QueueT the container type that behaves as a queue
+*/
+template <typename QueueT>
+struct QueueLocking
+{
+	/// true if the container must be locked for push and pop
+	static const bool needsLock = true;
+
+	/// @return the number of elements ever pushed in the queue
+	static std::size_t total( const QueueT &, std::size_t counter )
+	{
+		return counter;
+	}
+};
+
 /**
 	@brief a LockQueue is a thread safe Queue
 
@@ -96,6 +117,13 @@ class LockQueue
 	QueueT	m_queue;
 	size_t	m_total;
 
+	protected:
+	/// @return the container, for queues that need no lock
+	QueueT &getQueue()
+	{
+		return m_queue;
+	}
+
 	public:
 	LockQueue() : m_total(0) {}
 
@@ -105,6 +133,12 @@ class LockQueue
 	*/
 	void push( const OBJ &item )
 	{
+		if( !QueueLocking<QueueT>::needsLock )
+		{
+			m_queue.push( item );
+			return;
+		}
+
 		LockGuard	lock( m_lock );
 		if( lock )
 		{
@@ -112,6 +146,33 @@ class LockQueue
 			m_queue.push( item );
 		}
 	}
+	/**
+		@brief adds a number of items to the Queue locking it only once
+		@param [in] first iterator to the first item to add
+		@param [in] last iterator behind the last item to add
+	*/
+	template <typename IteratorT>
+	void pushBatch( IteratorT first, IteratorT last )
+	{
+		if( !QueueLocking<QueueT>::needsLock )
+		{
+			for( ; first != last; ++first )
+			{
+				m_queue.push( *first );
+			}
+			return;
+		}
+
+		LockGuard	lock( m_lock );
+		if( lock )
+		{
+			for( ; first != last; ++first )
+			{
+				++m_total;
+				m_queue.push( *first );
+			}
+		}
+	}
 	/**
 		@brief fetches the oldest item from the Queue
 
@@ -121,6 +182,11 @@ class LockQueue
 	*/
 	OBJ pop()
 	{
+		if( !QueueLocking<QueueT>::needsLock )
+		{
+			return m_queue.pop();
+		}
+
 		LockGuard	lock( m_lock );
 		if( lock )
 		{
@@ -132,6 +198,12 @@ class LockQueue
 	/// deletes all items in this Queue
 	void clear()
 	{
+		if( !QueueLocking<QueueT>::needsLock )
+		{
+			m_queue.clear();
+			return;
+		}
+
 		LockGuard	lock( m_lock );
 		if( lock )
 		{
@@ -151,7 +223,7 @@ class LockQueue
 	/// @return the number of elements ever pushed in this Queue
 	size_t total() const
 	{
-		return m_total;
+		return QueueLocking<QueueT>::total( m_queue, m_total );
 	}
 	/// @return the number of elements in this Queue
 	size_t size() const
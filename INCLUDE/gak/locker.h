@@ -66,6 +66,7 @@ inline void Sleep( unsigned long to )
 
 #include <gak/stopWatch.h>
 #include <gak/conditional.h>
+#include <gak/atomic.h>
 
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
@@ -112,13 +113,18 @@ class Critical
 #endif
 	size_t				m_useCount;
 	ThreadID			m_thread;
+	size_t				m_contentions;
 public:
+	/// the number of spins before a Windows critical section is blocked
+	static const unsigned long SPIN_COUNT = 4000;
+
 	Critical()
 	{
 		m_useCount = 0;
+		m_contentions = 0;
 		m_thread = ThreadID();
 #if defined( _Windows )
-		InitializeCriticalSection(&m_cs);
+		InitializeCriticalSectionAndSpinCount(&m_cs, SPIN_COUNT);
 #else
 		pthread_mutexattr_init(&m_attr);
 		pthread_mutexattr_settype(&m_attr, PTHREAD_MUTEX_RECURSIVE);
@@ -137,9 +143,17 @@ public:
 	void EnterCriticalSection()
 	{
 #if defined( _Windows )
-		::EnterCriticalSection(&m_cs);
+		if( !::TryEnterCriticalSection(&m_cs) )
+		{
+			::EnterCriticalSection(&m_cs);
+			++m_contentions;
+		}
 #else
-		pthread_mutex_lock(&m_mutex);
+		if( pthread_mutex_trylock(&m_mutex) )
+		{
+			pthread_mutex_lock(&m_mutex);
+			++m_contentions;
+		}
 #endif
 		++m_useCount;
 		if( m_useCount == 1 )
@@ -157,6 +171,11 @@ public:
 		pthread_mutex_unlock(&m_mutex);
 #endif
 	}
+	/// returns the number of times a thread had to wait for this critical section
+	size_t getContentionCount() const
+	{
+		return m_contentions;
+	}
 
 	/// return the OS specific handle of the current Thread
 	static ThreadID GetCurrentThreadID()
@@ -185,19 +204,51 @@ public:
 	}
 };
 
-/// this class can be used as an mutex for multiple threads in the application.
+/**
+	@brief this class can be used as an mutex for multiple threads in the application.
+
+	An uncontended lock needs one atomic compare and exchange, only. If the
+	mutex is locked by another thread, the calling thread spins for a while.
+	The number of spins adapts to the success of previous spinning. If
+	spinning does not help, the thread is blocked by the OS until the owner
+	unlocks the mutex.
+*/
 class Locker
 {
 	private:
-	Conditional	m_conditional;
-	Critical	m_cs;
-	ThreadID	m_lockedBy;
-	int			m_lockCount;
+	static const uint32	MIN_SPIN = 4;
+	static const uint32	MAX_SPIN = 1024;
+
+	Atomic<uint32>		m_state;
+	Atomic<ThreadID>	m_lockedBy;
+	int					m_lockCount;
+	EventCount			m_released;
+	Atomic<uint32>		m_spinLimit;
+
+	// statistics: changed by the owner, only
+	size_t				m_contentions;
+	size_t				m_waits;
+	Atomic<uint32>		m_timeouts;
 
-	bool lock( const StopWatch &startTime, unsigned long timeOut );
+	// no copy
+	Locker( const Locker & );
+	const Locker & operator = ( const Locker & );
+
+	bool tryAcquire()
+	{
+		uint32	expected = 0;
+		return !m_state.load() && m_state.compareExchange( expected, 1 );
+	}
+	void acquired( ThreadID threadId )
+	{
+		m_lockedBy.store( threadId );
+		m_lockCount = 1;
+	}
+	bool lockContended( ThreadID threadId, unsigned long timeOut );
 	bool isAvail( ThreadID threadId ) const
 	{
-		return m_lockedBy == UndefinedThread || m_lockedBy == threadId;
+		ThreadID	lockedBy = m_lockedBy.load();
+		return lockedBy == UndefinedThread || lockedBy == threadId;
 	}
 	public:
 	#ifndef __MACH__
@@ -206,10 +257,10 @@ class Locker
 	#endif
 
 	/// creates a new unlocked mutex
-	Locker()
+	Locker() : m_state( 0 ), m_lockedBy( UndefinedThread ), m_spinLimit( MIN_SPIN*4 ), m_timeouts( 0 )
 	{
-		m_lockedBy = UndefinedThread;
 		m_lockCount = 0;
+		m_contentions = m_waits = 0;
 	}
 	/// return the OS specific handle of the current Thread
 	static ThreadID GetCurrentThreadID()
@@ -237,14 +288,15 @@ class Locker
 	*/
 	void unlock()
 	{
-		if( m_lockedBy == GetCurrentThreadID() )
+		if( m_lockedBy.load() == GetCurrentThreadID() )
 		{
 			m_lockCount--;
 			assert( m_lockCount >= 0 );
 			if( !m_lockCount )
 			{
-				m_lockedBy = UndefinedThread;
-				m_conditional.notify();
+				m_lockedBy.store( UndefinedThread );
+				m_state.store( 0 );
+				m_released.notify();
 			}
 		}
 	}
@@ -259,17 +311,51 @@ class Locker
 		@param timeOut the max time in ms to wait for the lock beeing available
 		@return true on success
 	*/
-	bool lock( unsigned long timeOut = WAIT_FOREVER );
+	bool lock( unsigned long timeOut = WAIT_FOREVER )
+	{
+		ThreadID	threadId = GetCurrentThreadID();
+
+		if( m_lockedBy.load() == threadId )
+		{
+			m_lockCount++;
+/***/		return true;
+		}
+		if( tryAcquire() )
+		{
+			acquired( threadId );
+/***/		return true;
+		}
+
+		return lockContended( threadId, timeOut );
+	}
 	/// return the OS specific handle of the Thread that locked this mutex
 	ThreadID getLockedBy() const
 	{
-		return m_lockedBy;
+		return m_lockedBy.load();
 	}
 	/// returns the lock count
 	int getLockCount() const
 	{
 		return m_lockCount;
 	}
+
+	/// returns the number of successful locks that found this mutex locked by another thread
+	size_t getContentionCount() const
+	{
+		return m_contentions;
+	}
+	/// returns the number of times a thread was blocked by the OS until it got this mutex
+	size_t getWaitCount() const
+	{
+		return m_waits;
+	}
+	/// returns the number of locks that failed due to a timeout
+	size_t getTimeoutCount() const
+	{
+		return m_timeouts.load();
+	}
+	/// resets the contention counters
+	void resetStatistics();
 };
 
 /**
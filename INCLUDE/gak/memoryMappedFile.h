@@ -0,0 +1,222 @@
+/*
+		Project:		GAKLIB
+		Module:			memoryMappedFile.h
+		Description:	read only memory mapped files
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_MEMORY_MAPPED_FILE_H
+#define GAK_MEMORY_MAPPED_FILE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstddef>
+
+#if defined( _Windows )
+#	ifndef STRICT
+#		define STRICT	1
+#	endif
+#	include <windows.h>
+#endif
+
+#include <gak/string.h>
+#include <gak/exception.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief maps a file read only into the address space of the process
+
+	The data of the file is loaded by the operating system on demand when it
+	is accessed. Thus huge files can be used without reading them into memory.
+
+	@see IndexSegment
+*/
+class MemoryMappedFile
+{
+	STRING			m_fileName;
+	const char		*m_data;
+	std::size_t		m_size;
+#if defined( _Windows )
+	HANDLE			m_fileHandle, m_mappingHandle;
+#endif
+
+	// no copy
+	MemoryMappedFile( const MemoryMappedFile & );
+	const MemoryMappedFile &operator = ( const MemoryMappedFile & );
+
+	public:
+	/// creates an unmapped object
+	MemoryMappedFile();
+	/**
+		@brief maps a file into memory
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be mapped
+	*/
+	explicit MemoryMappedFile( const STRING &fileName );
+	~MemoryMappedFile()
+	{
+		close();
+	}
+
+	/**
+		@brief maps a file into memory, a previously mapped file is closed
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be mapped
+	*/
+	void open( const STRING &fileName );
+	/// releases the mapping
+	void close();
+
+	/// returns true if a file is mapped
+	bool isOpen() const
+	{
+		return m_data != nullptr;
+	}
+	/// returns the name of the file mapped
+	const STRING &getFileName() const
+	{
+		return m_fileName;
+	}
+	/// returns the address of the file data
+	const char *getData() const
+	{
+		return m_data;
+	}
+	/// returns the size of the file in bytes
+	std::size_t size() const
+	{
+		return m_size;
+	}
+	/**
+		@brief tells the operating system that a part of the file will be needed soon
+		@param [in] offset the offset of the data
+		@param [in] length the number of bytes
+	*/
+	void prefetch( std::size_t offset, std::size_t length ) const;
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_MEMORY_MAPPED_FILE_H
@@ -0,0 +1,448 @@
+/*
+		Project:		GAKLIB
+		Module:			mpmcQueue.h
+		Description:	a lock free bounded queue for multiple producers and consumers
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_MPMC_QUEUE_H
+#define GAK_MPMC_QUEUE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstddef>
+
+#include <gak/atomic.h>
+#include <gak/exception.h>
+#include <gak/lockQueue.h>
+#include <gak/stopWatch.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// assumed size of a cache line used to separate the producer and consumer data
+const std::size_t MPMC_CACHE_LINE = 64;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a lock free bounded queue for multiple producers and consumers
+
+	Like a RingBuffer this queue has a fixed capacity. Each cell of the ring has
+	a sequence number that tells producers and consumers, whether the cell is
+	free or filled. Thus producers and consumers only synchronize via one
+	compare and exchange on their own position.
+
+	Threads are blocked by @ref push and @ref waitPop, only, if the queue is
+	full or empty. In this case they are parked with an EventCount.
+
+	The queue can be used as the QueueT of LockQueue and CondQueue. Since it
+	does not need any lock, LockQueue does not lock it for push and pop.
+
+	@tparam OBJ the item type that is stored in this Queue
+	@tparam CAPACITY the max. number of items, must be a power of two
+	@see LockQueue, CondQueue, RingBuffer
+*/
+template <typename OBJ, std::size_t CAPACITY=1024>
+class MpmcQueue
+{
+	public:
+	typedef OBJ	value_type;
+
+	/// constant value to specify to wait forever
+	static const unsigned long WAIT_FOREVER = EventCount::WAIT_FOREVER;
+
+	private:
+	typedef char CapacityMustBeAPowerOfTwo[
+		(CAPACITY >= 2 && (CAPACITY & (CAPACITY-1)) == 0) ? 1 : -1
+	];
+
+	static const std::size_t	MASK = CAPACITY-1;
+	static const int			SPIN_COUNT = 64;
+
+	struct Cell
+	{
+		Atomic<std::size_t>	m_sequence;
+		OBJ					m_data;
+	};
+
+	Cell * const		m_cells;
+	char				m_pad0[MPMC_CACHE_LINE];
+	Atomic<std::size_t>	m_enqueuePos;
+	char				m_pad1[MPMC_CACHE_LINE];
+	Atomic<std::size_t>	m_dequeuePos;
+	char				m_pad2[MPMC_CACHE_LINE];
+	EventCount			m_notEmpty;
+	EventCount			m_notFull;
+
+	// no copy
+	MpmcQueue( const MpmcQueue & );
+	const MpmcQueue & operator = ( const MpmcQueue & );
+
+	static unsigned long remaining( const StopWatch &sw, unsigned long timeOut );
+
+	public:
+	MpmcQueue();
+	~MpmcQueue()
+	{
+		delete [] m_cells;
+	}
+
+	/**
+		@brief adds a new item to the Queue without waiting
+		@param [in] item the new item
+		@return false if the Queue is full
+	*/
+	bool tryPush( const OBJ &item );
+	/**
+		@brief fetches the oldest item from the Queue without waiting
+		@param [out] result receives the next item in the Queue
+		@return false if the Queue is empty
+	*/
+	bool tryPop( OBJ *result );
+
+	/**
+		@brief adds a new item to the Queue, waits while the Queue is full
+		@param [in] item the new item
+	*/
+	void push( const OBJ &item );
+	/**
+		@brief fetches the oldest item from the Queue
+
+		if the Queue is empty a QueueEmptyError exception is thrown
+
+		@return the next item in the Queue
+	*/
+	OBJ pop()
+	{
+		OBJ	result;
+		if( !tryPop( &result ) )
+		{
+			throw QueueEmptyError();
+		}
+		return result;
+	}
+	/**
+		@brief fetches the oldest item from the Queue waiting if it is empty
+		@param [in] timeOut max. time in milliseconds to wait for an item
+		@return the next item in the Queue
+		@throws TimeoutException if there was no item within timeOut milliseconds
+	*/
+	OBJ waitPop( unsigned long timeOut=WAIT_FOREVER );
+
+	/// deletes all items in this Queue
+	void clear()
+	{
+		OBJ	dummy;
+		while( tryPop( &dummy ) )
+			;
+	}
+	/// @return the number of elements in this Queue, is just a snapshot if other threads access the queue
+	std::size_t size() const
+	{
+		std::size_t	dequeuePos = m_dequeuePos.load();
+		std::size_t	enqueuePos = m_enqueuePos.load();
+		return enqueuePos > dequeuePos ? enqueuePos - dequeuePos : 0;
+	}
+	/// @return true if this Queue is empty
+	bool isEmpty() const
+	{
+		return !size();
+	}
+	/// @return the number of elements ever pushed in this Queue
+	std::size_t total() const
+	{
+		return m_enqueuePos.load();
+	}
+	/// @return the max. number of elements in this Queue
+	static std::size_t capacity()
+	{
+		return CAPACITY;
+	}
+};
+
+/**
+	@brief LockQueue does not need to lock a MpmcQueue
+*/
+template <typename OBJ, std::size_t CAPACITY>
+struct QueueLocking< MpmcQueue<OBJ, CAPACITY> >
+{
+	static const bool needsLock = false;
+
+	static std::size_t total( const MpmcQueue<OBJ, CAPACITY> &queue, std::size_t )
+	{
+		return queue.total();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename OBJ, std::size_t CAPACITY>
+MpmcQueue<OBJ, CAPACITY>::MpmcQueue() : m_cells( new Cell[CAPACITY] ), m_enqueuePos( 0 ), m_dequeuePos( 0 )
+{
+	for( std::size_t i=0; i<CAPACITY; ++i )
+	{
+		m_cells[i].m_sequence.store( i );
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename OBJ, std::size_t CAPACITY>
+unsigned long MpmcQueue<OBJ, CAPACITY>::remaining( const StopWatch &sw, unsigned long timeOut )
+{
+	if( timeOut == WAIT_FOREVER )
+	{
+		return WAIT_FOREVER;
+	}
+	unsigned long ellapsed = static_cast<unsigned long>( sw.getMillis() );
+	return ellapsed < timeOut ? timeOut - ellapsed : 0;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename OBJ, std::size_t CAPACITY>
+bool MpmcQueue<OBJ, CAPACITY>::tryPush( const OBJ &item )
+{
+	Cell		*cell;
+	std::size_t	pos = m_enqueuePos.load();
+
+	for(;;)
+	{
+		cell = m_cells + (pos & MASK);
+		std::ptrdiff_t diff = std::ptrdiff_t(cell->m_sequence.load()) - std::ptrdiff_t(pos);
+		if( !diff )
+		{
+			if( m_enqueuePos.compareExchange( pos, pos+1 ) )
+			{
+				break;
+			}
+		}
+		else if( diff < 0 )
+		{
+			return false;
+		}
+		else
+		{
+			pos = m_enqueuePos.load();
+		}
+	}
+
+	cell->m_data = item;
+	cell->m_sequence.store( pos+1 );
+	m_notEmpty.notify();
+
+	return true;
+}
+
+template <typename OBJ, std::size_t CAPACITY>
+bool MpmcQueue<OBJ, CAPACITY>::tryPop( OBJ *result )
+{
+	Cell		*cell;
+	std::size_t	pos = m_dequeuePos.load();
+
+	for(;;)
+	{
+		cell = m_cells + (pos & MASK);
+		std::ptrdiff_t diff = std::ptrdiff_t(cell->m_sequence.load()) - std::ptrdiff_t(pos+1);
+		if( !diff )
+		{
+			if( m_dequeuePos.compareExchange( pos, pos+1 ) )
+			{
+				break;
+			}
+		}
+		else if( diff < 0 )
+		{
+			return false;
+		}
+		else
+		{
+			pos = m_dequeuePos.load();
+		}
+	}
+
+	*result = cell->m_data;
+	cell->m_data = OBJ();
+	cell->m_sequence.store( pos+CAPACITY );
+	m_notFull.notify();
+
+	return true;
+}
+
+template <typename OBJ, std::size_t CAPACITY>
+void MpmcQueue<OBJ, CAPACITY>::push( const OBJ &item )
+{
+	for( int i=0; i<SPIN_COUNT; ++i )
+	{
+		if( tryPush( item ) )
+		{
+			return;
+		}
+	}
+	for(;;)
+	{
+		uint32 key = m_notFull.prepareWait();
+		if( tryPush( item ) )
+		{
+			m_notFull.cancelWait();
+			return;
+		}
+		m_notFull.wait( key );
+		if( tryPush( item ) )
+		{
+			return;
+		}
+	}
+}
+
+template <typename OBJ, std::size_t CAPACITY>
+OBJ MpmcQueue<OBJ, CAPACITY>::waitPop( unsigned long timeOut )
+{
+	OBJ	result;
+
+	for( int i=0; i<SPIN_COUNT; ++i )
+	{
+		if( tryPop( &result ) )
+		{
+			return result;
+		}
+	}
+
+	StopWatch	sw( timeOut != WAIT_FOREVER );
+	for(;;)
+	{
+		uint32 key = m_notEmpty.prepareWait();
+		if( tryPop( &result ) )
+		{
+			m_notEmpty.cancelWait();
+			return result;
+		}
+		if( !m_notEmpty.wait( key, remaining( sw, timeOut ) ) )
+		{
+			break;
+		}
+		if( tryPop( &result ) )
+		{
+			return result;
+		}
+	}
+
+	throw TimeoutException();
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_MPMC_QUEUE_H
@@ -66,7 +66,7 @@ namespace gak
 // --------------------------------------------------------------------- //
 
 const uint32 OSM_MAGIC2 = 0x12873666;
-const uint16 VERSION_MAGIC = 2;
+const uint16 VERSION_MAGIC = 4;
 
 #define BINMAP_EXTENSION ".bin"
 
@@ -264,7 +264,9 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 	typedef typename Super::layer_key_type			layer_key_type;
 	typedef typename Super::Layer					Layer;
 	typedef typename Super::Layers					Layers;
-	typedef typename Super::PositionValue			PositionValue;
+	typedef PairMap<OsmLayerKeyT, SpatialIndex<OsmPlaceKeyT> >	PlaceLayers;
+	typedef SpatialIndex<OsmAreaKeyT, SpatialBoxEntry<OsmAreaKeyT> >	AreaIndex;
+	typedef PairMap<OsmLayerKeyT, AreaIndex>					AreaLayers;
 
 	/*
 		------------------------------------------------------------------------------------------
@@ -275,8 +277,7 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 	typedef MapT<OsmPlaceKeyT, OsmPlace>			place_container_type;
 
 	private:
-	Layers					m_lonPlaceIndex;
-	Layers					m_latPlaceIndex;
+	PlaceLayers				m_placeIndex;
 	place_container_type	m_places;
 
 	void addPlace( OsmPlaceKeyT key, const OsmPlace &newPlace )
@@ -292,12 +293,7 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 		float	 longitude = newPlace.getPosition().longitude;
 		float	 latitude = newPlace.getPosition().latitude;
 
-		m_lonPlaceIndex[layerKey].addElement(
-			PositionValue( longitude, key )
-		);
-		m_latPlaceIndex[layerKey].addElement(
-			PositionValue( latitude, key )
-		);
+		m_placeIndex[layerKey].addElement( longitude, latitude, key );
 	}
 	std::size_t getNumPlaces() const
 	{
@@ -308,13 +304,9 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 		return m_places[id];
 	}
 
-	const Layers &getLonPlaceIndex() const
-	{
-		return m_lonPlaceIndex;
-	}
-	const Layers &getLatPlaceIndex() const
+	const PlaceLayers &getPlaceIndex() const
 	{
-		return m_latPlaceIndex;
+		return m_placeIndex;
 	}
 
 	const place_container_type &getAllPlaces() const
@@ -338,8 +330,10 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 	typedef MapT<OsmAreaKeyT, Area>					area_container_type;
 
 	private:
-	Layers					m_lonAreaIndex;
-	Layers					m_latAreaIndex;
+	/*
+		the bounding box of each area is an entry of the index
+	*/
+	AreaLayers				m_areaIndex;
 	area_container_type		m_areas;
 
 	void addArea( OsmAreaKeyT key, const Area &newArea );
@@ -360,13 +354,9 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 		return m_areas.hasElement( id );
 	}
 
-	const Layers &getLonAreaIndex() const
-	{
-		return m_lonAreaIndex;
-	}
-	const Layers &getLatAreaIndex() const
+	const AreaLayers &getAreaIndex() const
 	{
-		return m_latAreaIndex;
+		return m_areaIndex;
 	}
 
 	const area_container_type &getAllAreas() const
@@ -388,11 +378,9 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 	void clear()
 	{
 		Super::clear();
-		m_lonPlaceIndex.clear();
-		m_latPlaceIndex.clear();
+		m_placeIndex.clear();
 		m_places.clear();
-		m_lonAreaIndex.clear();
-		m_latAreaIndex.clear();
+		m_areaIndex.clear();
 		m_areas.clear();
 	}
 
@@ -400,12 +388,10 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 	{
 		Super::toBinaryStream( stream );
 
-		gak::toBinaryStream( stream, m_lonPlaceIndex );
-		gak::toBinaryStream( stream, m_latPlaceIndex );
+		gak::toBinaryStream( stream, m_placeIndex );
 		gak::toBinaryStream( stream, m_places );
 
-		gak::toBinaryStream( stream, m_lonAreaIndex );
-		gak::toBinaryStream( stream, m_latAreaIndex );
+		gak::toBinaryStream( stream, m_areaIndex );
 		gak::toBinaryStream( stream, m_areas );
 	}
 	void fromBinaryStream( std::istream &stream )
@@ -414,24 +400,16 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 		Super::fromBinaryStream( stream );
 
 		{
-			doEnterFunction("m_lonPlaceIndex::fromBinaryStream");
-			gak::fromBinaryStream( stream, &m_lonPlaceIndex );
-		}
-		{
-			doEnterFunction("m_latPlaceIndex::fromBinaryStream");
-			gak::fromBinaryStream( stream, &m_latPlaceIndex );
+			doEnterFunction("m_placeIndex::fromBinaryStream");
+			gak::fromBinaryStream( stream, &m_placeIndex );
 		}
 		{
 			doEnterFunction("m_places::fromBinaryStream");
 			gak::fromBinaryStream( stream, &m_places );
 		}
 		{
-			doEnterFunction("m_lonAreaIndex::fromBinaryStream");
-			gak::fromBinaryStream( stream, &m_lonAreaIndex );
-		}
-		{
-			doEnterFunction("m_latAreaIndex::fromBinaryStream");
-			gak::fromBinaryStream( stream, &m_latAreaIndex );
+			doEnterFunction("m_areaIndex::fromBinaryStream");
+			gak::fromBinaryStream( stream, &m_areaIndex );
 		}
 		{
 			doEnterFunction("m_areas::fromBinaryStream");
@@ -465,10 +443,8 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 		{
 			addArea(it->getKey(), it->getValue() );
 		}
-		this->mergeIndex(m_lonPlaceIndex, tileMap->getLonPlaceIndex());
-		this->mergeIndex(m_latPlaceIndex, tileMap->getLatPlaceIndex());
-		this->mergeIndex(m_lonAreaIndex, tileMap->getLonAreaIndex());
-		this->mergeIndex(m_latAreaIndex, tileMap->getLatAreaIndex());
+		this->mergeIndex(m_placeIndex, tileMap->getPlaceIndex());
+		this->mergeIndex(m_areaIndex, tileMap->getAreaIndex());
 	}
 	template <class TileT>
 	void mergeOsmTile( math::tileid_t tileID, const STRING &path, TileT *tileMap )
@@ -507,23 +483,6 @@ class BasicOpenStreetMap : public GeoGraph<OsmNode, OsmLink, MapT, IndexT, OsmLa
 typedef BasicOpenStreetMap<GraphTree, GeoBTree>	OSMbuilder;
 typedef BasicOpenStreetMap<GraphMap, GeoArray>	OSMviewer;
 
-template <>
-struct is_binary<OSMviewer::PositionValue> : public internal::integral_constant<true>
-{
-};
-
-template <>
-inline void toBinaryStream( std::ostream &stream, const OSMviewer::PositionValue &value )
-{
-	binaryToBinaryStream( stream, value );
-}
-
-template <>
-inline void fromBinaryStream( std::istream &stream, OSMviewer::PositionValue *value )
-{
-	binaryFromBinaryStream( stream, value );
-}
-
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -592,60 +551,10 @@ void BasicOpenStreetMap<MapT, IndexT>::getPlaces(
 {
 	doEnterFunction("BasicOpenStreetMap<MapT, IndexT>::getPlaces");
 
-	Array<OsmNodeKeyT>	lonNodes, latNodes;
-
-	assert( m_lonPlaceIndex.size() == m_latPlaceIndex.size() );
-	assert( m_lonPlaceIndex.hasElement(layerKey) == m_latPlaceIndex.hasElement(layerKey) );
-
-	if( m_lonPlaceIndex.hasElement(layerKey) )
-	{
-		assert( m_lonPlaceIndex[layerKey].size() == m_latPlaceIndex[layerKey].size() );
-
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		m_lonPlaceIndex[layerKey].getRange(
-			PositionValue(
-				float(region.topLeft.longitude)
-			),
-			PositionValue(
-				float(region.bottomRight.longitude)
-			)
-		);
-
-		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
-			it != endIT;
-			++it
-		)
-		{
-			lonNodes.addElement( it->nodeID );
-		}
-	}
-
-	if( m_latPlaceIndex.hasElement(layerKey) )
+	if( m_placeIndex.hasElement(layerKey) )
 	{
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		m_latPlaceIndex[layerKey].getRange(
-			PositionValue(
-				float(region.bottomRight.latitude)
-			),
-			PositionValue(
-				float(region.topLeft.latitude)
-			)
-		);
-		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
-			it != endIT;
-			++it
-		)
-		{
-			latNodes.addElement( it->nodeID );
-		}
+		m_placeIndex[layerKey].getRegion( toSpatialBox( region ), result );
 	}
-	lonNodes.sort( FixedComparator<OsmNodeKeyT>() );
-	latNodes.sort( FixedComparator<OsmNodeKeyT>() );
-	intersectSorted( lonNodes, latNodes, std::back_inserter( *result ) );
 }
 
 template<template<typename, typename>class MapT, template<typename>class IndexT>
@@ -658,60 +567,22 @@ void BasicOpenStreetMap<MapT, IndexT>::getAreas(
 {
 	doEnterFunction("BasicOpenStreetMap<MapT, IndexT>::getAreas");
 
-	Set<OsmAreaKeyT>	lonAreas, latAreas;
-
-	assert( m_lonAreaIndex.size() == m_latAreaIndex.size() );
-	assert( m_lonAreaIndex.hasElement(layerKey) == m_latAreaIndex.hasElement(layerKey) );
-
-	if( m_lonAreaIndex.hasElement(layerKey) )
+	if( m_areaIndex.hasElement(layerKey) )
 	{
-		assert( m_lonAreaIndex[layerKey].size() == m_latAreaIndex[layerKey].size() );
-
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		m_lonAreaIndex[layerKey].getRange(
-			PositionValue(
-				float(region.topLeft.longitude)
-			),
-			PositionValue(
-				float(region.bottomRight.longitude)
-			)
-		);
+		// an area covering the region has no vertex within the region
+		Array<OsmAreaKeyT>	areas;
 
+		m_areaIndex[layerKey].getRegion( toSpatialBox( region ), &areas );
 		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
+			typename Array<OsmAreaKeyT>::const_iterator it = areas.cbegin(),
+				endIT = areas.cend();
 			it != endIT;
 			++it
 		)
 		{
-			lonAreas.addElement( it->nodeID );
+			result->addElement( *it );
 		}
 	}
-
-	if( m_latAreaIndex.hasElement(layerKey) )
-	{
-		ConstIterable<typename Layer::const_iterator>	rangeValues =
-		m_latAreaIndex[layerKey].getRange(
-			PositionValue(
-				float(region.bottomRight.latitude)
-			),
-			PositionValue(
-				float(region.topLeft.latitude)
-			)
-		);
-		for(
-			typename Layer::const_iterator	it = rangeValues.cbegin(),
-				endIT = rangeValues.cend();
-			it != endIT;
-			++it
-		)
-		{
-			latAreas.addElement( it->nodeID );
-		}
-	}
-	lonAreas.sort( FixedComparator<OsmAreaKeyT>() );
-	latAreas.sort( FixedComparator<OsmAreaKeyT>() );
-	intersectSorted( lonAreas, latAreas, std::back_inserter( *result ) );
 }
 
 template<template<typename, typename>class MapT, template<typename>class IndexT>
@@ -719,6 +590,7 @@ void BasicOpenStreetMap<MapT, IndexT>::addArea( OsmAreaKeyT key, OsmLayerKeyT la
 {
 	addArea(key, newArea);
 
+	SpatialBox	box;
 	for(
 		Area::const_iterator it = newArea.cbegin(), endIT = newArea.cend();
 		it != endIT;
@@ -730,12 +602,18 @@ void BasicOpenStreetMap<MapT, IndexT>::addArea( OsmAreaKeyT key, OsmLayerKeyT la
 
 		this->expandBoundingBox(longitude,latitude);
 
-		m_lonAreaIndex[layerKey].addElement(
-			PositionValue( longitude, key )
-		);
-		m_latAreaIndex[layerKey].addElement(
-			PositionValue( latitude, key )
-		);
+		if( it == newArea.cbegin() )
+		{
+			box = SpatialBox( longitude, latitude, longitude, latitude );
+		}
+		else
+		{
+			box.expand( longitude, latitude );
+		}
+	}
+	if( newArea.points.size() )
+	{
+		m_areaIndex[layerKey].addElement( box, key );
 	}
 }
 
@@ -0,0 +1,1003 @@
+/*
+		Project:		GAKLIB
+		Module:			osmTileStore.h
+		Description:	memory mapped tiles of an OpenStreetMap
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_OSM_TILE_STORE_H
+#define GAK_OSM_TILE_STORE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/osm.h>
+#include <gak/memoryMappedFile.h>
+#include <gak/shared.h>
+#include <gak/locker.h>
+#include <gak/threadPool.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the magic number of a mapped OSM tile file
+const uint32 OSM_TILE_MAGIC = 0x544F4B47;		// GKOT
+/// the current version of a mapped OSM tile file
+const uint16 OSM_TILE_VERSION = 2;
+
+/// default max. size of all tiles in an OsmTileStore
+const std::size_t OSM_TILE_CACHE_SIZE = 256*1024*1024;
+
+#define OSM_TILE_EXTENSION ".tile"
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the header at the beginning of a mapped OSM tile file
+struct OsmTileHeader
+{
+	uint32	m_magic;
+	uint16	m_version;
+	uint16	m_headerSize;
+	uint32	m_tileID;
+	uint32	m_numNodes, m_numOutgoing, m_numLinks;
+	uint32	m_numNodeLayers, m_numNodeEntries, m_numNodeBoxes;
+	uint32	m_numPlaces, m_numPlaceLayers, m_numPlaceBoxes;
+	uint32	m_numAreas, m_numAreaLayers, m_numAreaBoxes;
+	uint32	m_numVertices, m_namesSize;
+	uint64	m_fileSize;
+};
+
+/// the offsets of the arrays of a mapped OSM tile in bytes
+struct OsmTileLayout
+{
+	std::size_t	m_nodes, m_outgoing, m_links;
+	std::size_t	m_nodeLayers, m_nodeEntries, m_nodeBoxes;
+	std::size_t	m_places, m_placeLayers, m_placeEntries, m_placeBoxes, m_placeOrder;
+	std::size_t	m_areas, m_areaLayers, m_areaEntries, m_areaBoxes, m_areaOrder;
+	std::size_t	m_vertices, m_names;
+	std::size_t	m_size;
+};
+
+/// a node of a mapped OSM tile
+struct OsmTileNode
+{
+	OsmNodeKeyT	m_key;
+	OsmPosition	m_pos;
+	/// the range of the outgoing links in the outgoing array of the tile
+	uint32		m_firstLink, m_lastLink;
+
+	std::size_t getNumLinks() const
+	{
+		return m_lastLink - m_firstLink;
+	}
+};
+
+/// a link of a mapped OSM tile, the end node can be part of another tile
+struct OsmTileLink
+{
+	OsmLinkKeyT	m_key;
+	OsmNodeKeyT	m_startNodeID, m_endNodeID;
+	OsmLink		m_link;
+};
+
+/// an entry of the spatial index of the nodes of a mapped OSM tile
+typedef SpatialEntry<OsmNodeKeyT>		OsmTileNodeEntry;
+/// an entry of the spatial index of the places of a mapped OSM tile
+typedef SpatialEntry<OsmPlaceKeyT>		OsmTilePlaceEntry;
+/// an entry of the spatial index of the areas of a mapped OSM tile
+typedef SpatialBoxEntry<OsmAreaKeyT>	OsmTileAreaEntry;
+
+/// a place of a mapped OSM tile, the name is stored in the name pool of the tile
+struct OsmTilePlace
+{
+	OsmPlaceKeyT	m_key;
+	OsmPosition		m_pos;
+	uint32			m_nameOffset, m_nameLength;
+};
+
+/// an area of a mapped OSM tile, the vertices are stored in the vertex pool of the tile
+struct OsmTileArea
+{
+	OsmAreaKeyT	m_key;
+	uint32		m_firstVertex, m_numVertices;
+};
+
+/// the range of the entries and of the boxes of the spatial index of one layer
+struct OsmTileLayer
+{
+	OsmLayerKeyT	m_layerKey;
+	int16			m_reserved;
+	uint32			m_first, m_count;
+	uint32			m_firstBox;
+};
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief the data of one OSM tile in a fixed layout that can be memory mapped
+
+	A tile stores the nodes, links, places and areas of a tile of a
+	BasicOpenStreetMap in flat arrays: The nodes and the links are sorted by
+	their keys, the outgoing links of a node are a range of link indices.
+	Each layer of nodes, places and areas has a packed R-tree with the layout
+	of SpatialIndex, i.e. a range of entries and a range of boxes. A region
+	query uses this range as a SpatialTree and visits the nodes of the tree
+	intersecting the region, only. The places and areas of a layer are stored
+	in the order of the entries of their tree.
+
+	The memory layout of a built tile is the same as the layout of the file
+	written by writeToFile. Thus open maps the file with MemoryMappedFile and
+	uses its data without reading or converting anything, the operating
+	system reads the pages when they are accessed.
+
+	@see OsmTileStore
+*/
+class OsmTile : public SharedObject
+{
+	MemoryMappedFile		m_file;
+	ArrayOfData				m_buffer;
+
+	const OsmTileHeader		*m_header;
+	const OsmTileNode		*m_nodes;
+	const uint32			*m_outgoing;
+	const OsmTileLink		*m_links;
+	const OsmTileLayer		*m_nodeLayers;
+	const OsmTileNodeEntry	*m_nodeEntries;
+	const SpatialBox		*m_nodeBoxes;
+	const OsmTilePlace		*m_places;
+	const OsmTileLayer		*m_placeLayers;
+	const OsmTilePlaceEntry	*m_placeEntries;
+	const SpatialBox		*m_placeBoxes;
+	const uint32			*m_placeOrder;
+	const OsmTileArea		*m_areas;
+	const OsmTileLayer		*m_areaLayers;
+	const OsmTileAreaEntry	*m_areaEntries;
+	const SpatialBox		*m_areaBoxes;
+	const uint32			*m_areaOrder;
+	const OsmPosition		*m_vertices;
+	const char				*m_names;
+
+	/*
+		compares entry indices by the keys of the entries
+	*/
+	template <typename EntryT>
+	class KeyComparator
+	{
+		const PODarray<EntryT>	&m_entries;
+
+		public:
+		KeyComparator( const PODarray<EntryT> &entries ) : m_entries( entries )
+		{
+		}
+		int operator () ( const uint32 &index1, const uint32 &index2 ) const
+		{
+			return gak::compare( m_entries[index1].m_key, m_entries[index2].m_key );
+		}
+	};
+
+	// no copy
+	OsmTile( const OsmTile & );
+	const OsmTile &operator = ( const OsmTile & );
+
+	static std::size_t align( std::size_t size )
+	{
+		return (size + 7) & ~std::size_t(7);
+	}
+	static OsmTileLayout getLayout( const OsmTileHeader &header );
+	template <typename EntryT>
+	static PODarray<uint32> getKeyOrder( const PODarray<EntryT> &entries );
+	template <typename EntryT>
+	static void copyArray( char *data, std::size_t offset, const PODarray<EntryT> &source );
+	template <typename KeyT, typename EntryT>
+	static void addLayer(
+		OsmLayerKeyT layerKey, SpatialIndex<KeyT, EntryT> &index,
+		PODarray<OsmTileLayer> *layers, PODarray<EntryT> *entries, PODarray<SpatialBox> *boxes
+	);
+	template <typename EntryT>
+	static SpatialTree<EntryT> getLayerTree(
+		const OsmTileLayer &layer, const EntryT *entries, const SpatialBox *boxes
+	)
+	{
+		return SpatialTree<EntryT>( entries + layer.m_first, layer.m_count, boxes + layer.m_firstBox );
+	}
+	static bool checkLayers(
+		const OsmTileLayer *layers, std::size_t numLayers, std::size_t numEntries, std::size_t numBoxes
+	);
+	static std::size_t findNodeIndex( const PODarray<OsmTileNode> &nodes, OsmNodeKeyT key );
+	static std::size_t findLayer( const OsmTileLayer *layers, std::size_t numLayers, OsmLayerKeyT layerKey );
+
+	std::size_t findNode( OsmNodeKeyT key ) const;
+	std::size_t findLink( OsmLinkKeyT key ) const;
+	std::size_t findPlace( OsmPlaceKeyT key ) const;
+	std::size_t findArea( OsmAreaKeyT key ) const;
+
+	void setPointers( const char *data );
+	bool checkIndices() const;
+
+	public:
+	/// creates an empty tile
+	OsmTile()
+	{
+		clear();
+	}
+
+	/**
+		@brief builds the tile from a map, a previously built or opened tile is released
+		@param [in] tileID the ID of the tile
+		@param [in] tileMap the map with the data of the tile, e.g. an OSMbuilder
+	*/
+	template <typename OsmMapT>
+	void build( math::tileid_t tileID, const OsmMapT &tileMap );
+	/**
+		@brief maps a file written by writeToFile into memory
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be mapped
+		@exception BadHeaderError if the file is not a tile of this version or it is corrupted
+	*/
+	void open( const STRING &fileName );
+	/**
+		@brief writes the tile to a file
+		@param [in] fileName the name of the file
+		@exception OpenWriteError if the file could not be created
+		@exception WriteError if the file could not be written
+	*/
+	void writeToFile( const STRING &fileName ) const;
+	/// releases the memory or the file mapping
+	void clear();
+	/// tells the operating system to read the whole mapped file in advance
+	void prefetch() const
+	{
+		if( m_file.isOpen() )
+		{
+			m_file.prefetch( 0, m_file.size() );
+		}
+	}
+
+	/// returns true if the tile was loaded with open
+	bool isMapped() const
+	{
+		return m_file.isOpen();
+	}
+	/// returns the address of the data, i.e. the header followed by the arrays
+	const char *getData() const
+	{
+		return reinterpret_cast<const char *>( m_header );
+	}
+	/// returns the size of the data in bytes
+	std::size_t getDataSize() const
+	{
+		return std::size_t( m_header->m_fileSize );
+	}
+	math::tileid_t getTileID() const
+	{
+		return m_header->m_tileID;
+	}
+
+	/*
+		------------------------------------------------------------------------------------------
+			Nodes and links
+		------------------------------------------------------------------------------------------
+	*/
+	std::size_t getNumNodes() const
+	{
+		return m_header->m_numNodes;
+	}
+	/// returns the node with the given index, the nodes are sorted by their keys
+	const OsmTileNode &getNodeAt( std::size_t index ) const
+	{
+		assert( index < getNumNodes() );
+		return m_nodes[index];
+	}
+	bool hasNode( OsmNodeKeyT key ) const
+	{
+		return findNode( key ) != Container::no_index;
+	}
+	/**
+		@brief returns a node
+		@param [in] key the key of the node
+		@exception NodeNotFoundError if the node is not part of this tile
+	*/
+	const OsmTileNode &getNode( OsmNodeKeyT key ) const;
+
+	std::size_t getNumLinks() const
+	{
+		return m_header->m_numLinks;
+	}
+	bool hasLink( OsmLinkKeyT key ) const
+	{
+		return findLink( key ) != Container::no_index;
+	}
+	/**
+		@brief returns a link
+		@param [in] key the key of the link
+		@exception LinkNotFoundError if the link is not part of this tile
+	*/
+	const OsmTileLink &getLink( OsmLinkKeyT key ) const;
+	/**
+		@brief returns an outgoing link of a node
+		@param [in] node a node of this tile
+		@param [in] i the number of the link, less than node.getNumLinks()
+	*/
+	const OsmTileLink &getOutgoingLink( const OsmTileNode &node, std::size_t i ) const
+	{
+		assert( i < node.getNumLinks() );
+		return m_links[m_outgoing[node.m_firstLink + i]];
+	}
+
+	/**
+		@brief finds the nodes of a layer within a region
+		@param [in] layerKey the layer
+		@param [in] region the region
+		@param [out] result the keys of the nodes found are appended to this array
+	*/
+	void getRegion( OsmLayerKeyT layerKey, const SpatialBox &region, Array<OsmNodeKeyT> *result ) const;
+	template <typename ScalarT>
+	void getRegion(
+		OsmLayerKeyT										layerKey,
+		const math::Rectangle< math::GeoPosition<ScalarT> >	&region,
+		Array<OsmNodeKeyT>									*result
+	) const
+	{
+		getRegion( layerKey, toSpatialBox( region ), result );
+	}
+
+	/*
+		------------------------------------------------------------------------------------------
+			Places
+		------------------------------------------------------------------------------------------
+	*/
+	std::size_t getNumPlaces() const
+	{
+		return m_header->m_numPlaces;
+	}
+	bool hasPlace( OsmPlaceKeyT key ) const
+	{
+		return findPlace( key ) != Container::no_index;
+	}
+	/**
+		@brief returns a place
+		@param [in] key the key of the place
+		@exception IndexError if the place is not part of this tile
+	*/
+	OsmPlace getPlace( OsmPlaceKeyT key ) const;
+	/**
+		@brief finds the places of a layer within a region
+		@param [in] layerKey the layer
+		@param [in] region the region
+		@param [out] result the keys of the places found are appended to this array
+	*/
+	void getPlaces( OsmLayerKeyT layerKey, const SpatialBox &region, Array<OsmPlaceKeyT> *result ) const;
+	template <typename ScalarT>
+	void getPlaces(
+		OsmLayerKeyT										layerKey,
+		const math::Rectangle< math::GeoPosition<ScalarT> >	&region,
+		Array<OsmPlaceKeyT>									*result
+	) const
+	{
+		getPlaces( layerKey, toSpatialBox( region ), result );
+	}
+
+	/*
+		------------------------------------------------------------------------------------------
+			Areas
+		------------------------------------------------------------------------------------------
+	*/
+	std::size_t getNumAreas() const
+	{
+		return m_header->m_numAreas;
+	}
+	bool hasArea( OsmAreaKeyT key ) const
+	{
+		return findArea( key ) != Container::no_index;
+	}
+	/**
+		@brief returns an area
+		@param [in] key the key of the area
+		@exception IndexError if the area is not part of this tile
+	*/
+	Area getArea( OsmAreaKeyT key ) const;
+	/**
+		@brief finds the areas of a layer whose bounding box intersects a region
+		@param [in] layerKey the layer
+		@param [in] region the region
+		@param [out] result the keys of the areas found are added to this set
+	*/
+	void getAreas( OsmLayerKeyT layerKey, const SpatialBox &region, Set<OsmAreaKeyT> *result ) const;
+	template <typename ScalarT>
+	void getAreas(
+		OsmLayerKeyT										layerKey,
+		const math::Rectangle< math::GeoPosition<ScalarT> >	&region,
+		Set<OsmAreaKeyT>									*result
+	) const
+	{
+		getAreas( layerKey, toSpatialBox( region ), result );
+	}
+};
+
+/// the tiles are shared by the store and the threads reading them
+typedef SharedObjectPointer<OsmTile>	OsmTilePtr;
+
+/**
+	@brief loads mapped OSM tiles on demand and keeps them within a memory budget
+
+	A tile is opened when it is accessed the first time and stays in the
+	store until the size of all tiles exceeds the budget, then the least
+	recently used tiles are released. A tile that is still referenced by an
+	OsmTilePtr stays mapped until the last reference is released, it is no
+	longer counted by the store, though.
+
+	getTiles loads the tiles of a region and queues the neighbouring tiles
+	that are not yet loaded. A background thread opens and prefetches them,
+	thus they are available when the viewer pans into that direction. A
+	prefetched tile counts as least recently used until it is requested and
+	it only replaces other prefetched tiles, thus prefetching never releases
+	a tile the viewer requested.
+
+	Unlike BasicOpenStreetMap::mergeOsmTile nothing is copied, thus the memory
+	used by a viewer is limited by the budget and not by the area visited.
+	The tile files can be created from the files of mergeOsmTile with
+	writeOsmTile.
+
+	All functions are thread safe.
+
+	@see OsmTile, writeOsmTile
+*/
+class OsmTileStore
+{
+	struct CachedTile
+	{
+		OsmTilePtr	m_tile;
+		std::size_t	m_lastUse;
+	};
+
+	class PrefetchJob
+	{
+		OsmTileStore	*m_store;
+		math::tileid_t	m_tileID;
+
+		public:
+		PrefetchJob() : m_store( nullptr ), m_tileID( 0 ) {}
+		PrefetchJob( OsmTileStore *store, math::tileid_t tileID ) : m_store( store ), m_tileID( tileID ) {}
+		void operator () () const
+		{
+			m_store->prefetchTile( m_tileID );
+		}
+	};
+
+	const STRING						m_path;
+	PairMap<math::tileid_t, CachedTile>	m_tiles;
+	math::TileIDsSet					m_missingTiles, m_pendingTiles;
+	std::size_t							m_maxSize, m_size;
+	std::size_t							m_useCounter, m_numHits, m_numMisses, m_numPrefetched;
+	Critical							m_lock;
+	const bool							m_prefetch;
+	ThreadPool<PrefetchJob>				m_pool;
+	PoolFuture							m_future;
+
+	// no copy
+	OsmTileStore( const OsmTileStore & );
+	const OsmTileStore & operator = ( const OsmTileStore & );
+
+	void removeLeastRecentlyUsed( std::size_t maxSize, bool prefetchedOnly=false );
+	OsmTilePtr findTile( math::tileid_t tileID, bool *missing );
+	OsmTilePtr loadTile( math::tileid_t tileID );
+	OsmTilePtr addTile( math::tileid_t tileID, const OsmTilePtr &tile, bool prefetched );
+	void prefetchTile( math::tileid_t tileID );
+
+	public:
+	/**
+		@brief creates an empty store
+		@param [in] path the directory with the tile files
+		@param [in] maxSize the max. size of all tiles in bytes
+		@param [in] prefetch true, if the neighbours of the tiles used are loaded by a background thread
+	*/
+	OsmTileStore( const STRING &path, std::size_t maxSize=OSM_TILE_CACHE_SIZE, bool prefetch=true );
+	~OsmTileStore()
+	{
+		m_pool.shutdown();
+	}
+
+	/**
+		@brief changes the budget of the store, the least recently used tiles exceeding the new budget are released
+		@param [in] maxSize the max. size of all tiles in bytes
+	*/
+	void setMaxSize( std::size_t maxSize );
+	/**
+		@brief returns a tile, the file is opened if the tile is not yet loaded
+		@param [in] tileID the ID of the tile
+		@return the tile or an empty pointer if there is no file for this tile
+		@exception BadHeaderError if the file is not a tile of this version
+	*/
+	OsmTilePtr getTile( math::tileid_t tileID );
+	/**
+		@brief returns the tiles of a region and queues their neighbours for prefetching
+		@param [in] region the region
+		@param [out] result the tiles found are appended to this array
+		@exception BadHeaderError if a file is not a tile of this version
+	*/
+	void getTiles( const BoundingBox &region, Array<OsmTilePtr> *result );
+	/**
+		@brief queues the neighbours of a tile that are not yet loaded for prefetching
+		@param [in] tileID the ID of the tile
+	*/
+	void prefetchNeighbours( math::tileid_t tileID );
+	/// waits until all tiles queued for prefetching are loaded
+	void flush()
+	{
+		m_future.wait();
+	}
+	/// releases all tiles
+	void clear();
+
+	/// returns the directory with the tile files
+	const STRING &getPath() const
+	{
+		return m_path;
+	}
+	/// returns the size of all loaded tiles in bytes
+	std::size_t getSize() const
+	{
+		return m_size;
+	}
+	/// returns the max. size of all tiles in bytes
+	std::size_t getMaxSize() const
+	{
+		return m_maxSize;
+	}
+	/// returns the number of loaded tiles
+	std::size_t getNumTiles() const
+	{
+		return m_tiles.size();
+	}
+	/// returns true if a tile is loaded
+	bool hasTile( math::tileid_t tileID )
+	{
+		CriticalScope	scope( m_lock );
+		return m_tiles.hasElement( tileID );
+	}
+	/// returns the number of requests served without opening a file
+	std::size_t getNumHits() const
+	{
+		return m_numHits;
+	}
+	/// returns the number of requests that had to open the file
+	std::size_t getNumMisses() const
+	{
+		return m_numMisses;
+	}
+	/// returns the number of tiles loaded by the background thread
+	std::size_t getNumPrefetched() const
+	{
+		return m_numPrefetched;
+	}
+
+	/**
+		@brief returns the IDs of all tiles of a region
+		@param [in] region the region
+		@param [out] result the IDs are added to this set
+	*/
+	static void getTileIDs( const BoundingBox &region, math::TileIDsSet *result );
+	/**
+		@brief returns the IDs of the eight neighbours of a tile
+		@param [in] tileID the ID of the tile
+		@param [out] result the IDs are added to this set
+	*/
+	static void getNeighbours( math::tileid_t tileID, math::TileIDsSet *result );
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// returns the name of the mapped file of a tile
+inline STRING getOsmTileFileName( const STRING &tilesPath, math::tileid_t tileID )
+{
+	return tilesPath + DIRECTORY_DELIMITER + formatNumber(tileID) + OSM_TILE_EXTENSION;
+}
+
+/**
+	@brief writes the mapped file of a tile that can be opened by an OsmTileStore
+	@param [in] tilesPath the directory with the tile files
+	@param [in] tileID the ID of the tile
+	@param [in] tileMap the map with the data of the tile, e.g. a map read by readFromBinaryFile
+	@exception OpenWriteError if the file could not be created
+	@exception WriteError if the file could not be written
+*/
+template <typename OsmMapT>
+void writeOsmTile( const STRING &tilesPath, math::tileid_t tileID, const OsmMapT &tileMap )
+{
+	OsmTile	tile;
+
+	tile.build( tileID, tileMap );
+	tile.writeToFile( getOsmTileFileName( tilesPath, tileID ) );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename EntryT>
+PODarray<uint32> OsmTile::getKeyOrder( const PODarray<EntryT> &entries )
+{
+	PODarray<uint32>	order;
+
+	order.setSize( entries.size() );
+	for( std::size_t i=0; i<entries.size(); ++i )
+	{
+		order[i] = uint32( i );
+	}
+	if( order.size() )
+	{
+		order.sort( KeyComparator<EntryT>( entries ) );
+	}
+	return order;
+}
+
+/*
+	packs the index of a layer and appends its tree to the entries and boxes of the tile
+*/
+template <typename KeyT, typename EntryT>
+void OsmTile::addLayer(
+	OsmLayerKeyT layerKey, SpatialIndex<KeyT, EntryT> &index,
+	PODarray<OsmTileLayer> *layers, PODarray<EntryT> *entries, PODarray<SpatialBox> *boxes
+)
+{
+	index.pack();
+
+	SpatialTree<EntryT>	tree = index.getPackedTree();
+	if( !tree.size() )
+	{
+/*@*/	return;
+	}
+
+	OsmTileLayer	&layer = layers->createElement();
+	layer.m_layerKey = layerKey;
+	layer.m_reserved = 0;
+	layer.m_first = uint32( entries->size() );
+	layer.m_count = uint32( tree.size() );
+	layer.m_firstBox = uint32( boxes->size() );
+	for( std::size_t i=0; i<tree.size(); ++i )
+	{
+		entries->addElement( tree.getEntries()[i] );
+	}
+	for( std::size_t i=0; i<tree.getNumBoxes(); ++i )
+	{
+		boxes->addElement( tree.getBoxes()[i] );
+	}
+}
+
+template <typename EntryT>
+void OsmTile::copyArray( char *data, std::size_t offset, const PODarray<EntryT> &source )
+{
+	if( source.size() )
+	{
+		std::memcpy( data + offset, source.getDataBuffer(), source.size() * sizeof( EntryT ) );
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename OsmMapT>
+void OsmTile::build( math::tileid_t tileID, const OsmMapT &tileMap )
+{
+	doEnterFunctionEx( gakLogging::llDetail, "OsmTile::build" );
+
+	typedef typename OsmMapT::node_container_type	node_container_type;
+	typedef typename OsmMapT::link_container_type	link_container_type;
+	typedef typename OsmMapT::link_key_types		link_key_types;
+
+	// nodes and links, the containers of the map are sorted by their keys
+	PODarray<OsmTileNode>	nodes;
+	PODarray<OsmTileLink>	links;
+	PODarray<uint32>		outgoing;
+
+	const link_container_type	&linkContainer = tileMap.getLinks();
+	for(
+		typename link_container_type::const_iterator it = linkContainer.cbegin(), endIT = linkContainer.cend();
+		it != endIT;
+		++it
+	)
+	{
+		OsmTileLink	&link = links.createElement();
+
+		link.m_key = it->getKey();
+		link.m_startNodeID = it->getValue().m_startNodeID;
+		link.m_endNodeID = it->getValue().m_endNodeID;
+		link.m_link = it->getValue().m_link;
+	}
+
+	const node_container_type	&nodeContainer = tileMap.getNodes();
+	for(
+		typename node_container_type::const_iterator it = nodeContainer.cbegin(), endIT = nodeContainer.cend();
+		it != endIT;
+		++it
+	)
+	{
+		OsmTileNode	&node = nodes.createElement();
+
+		node.m_key = it->getKey();
+		node.m_pos = it->getValue().m_node.pos;
+		node.m_firstLink = uint32( outgoing.size() );
+
+		const link_key_types	&linkKeys = it->getValue().m_outgoing;
+		for( std::size_t i=0; i<linkKeys.size(); ++i )
+		{
+			std::size_t	first = 0, last = links.size();
+			while( first < last )
+			{
+				std::size_t	middle = first + (last-first)/2;
+				if( links[middle].m_key < linkKeys[i] )
+				{
+					first = middle+1;
+				}
+				else
+				{
+					last = middle;
+				}
+			}
+			if( first < links.size() && links[first].m_key == linkKeys[i] )
+			{
+				outgoing.addElement( uint32( first ) );
+			}
+		}
+		node.m_lastLink = uint32( outgoing.size() );
+	}
+
+	// the spatial index of the nodes of each layer
+	PODarray<OsmTileLayer>		nodeLayers;
+	PODarray<OsmTileNodeEntry>	nodeEntries;
+	PODarray<SpatialBox>		nodeBoxes;
+	for(
+		typename OsmMapT::Layers::const_iterator it = tileMap.getSpatialIndex().cbegin(),
+			endIT = tileMap.getSpatialIndex().cend();
+		it != endIT;
+		++it
+	)
+	{
+		SpatialIndex<OsmNodeKeyT>		layer;
+		const typename OsmMapT::Layer	&index = it->getValue();
+		for(
+			typename OsmMapT::Layer::const_iterator itE = index.cbegin(), endE = index.cend();
+			itE != endE;
+			++itE
+		)
+		{
+			if( findNodeIndex( nodes, itE->key ) != Container::no_index )
+			{
+				layer.addElement( *itE );
+			}
+		}
+		addLayer( it->getKey(), layer, &nodeLayers, &nodeEntries, &nodeBoxes );
+	}
+
+	// the places of each layer in the order of their index with their names
+	PODarray<OsmTilePlace>		places;
+	PODarray<OsmTileLayer>		placeLayers;
+	PODarray<OsmTilePlaceEntry>	placeEntries;
+	PODarray<SpatialBox>		placeBoxes;
+	STRING						names;
+	for(
+		typename OsmMapT::PlaceLayers::const_iterator it = tileMap.getPlaceIndex().cbegin(),
+			endIT = tileMap.getPlaceIndex().cend();
+		it != endIT;
+		++it
+	)
+	{
+		SpatialIndex<OsmPlaceKeyT>	layer = it->getValue();
+		addLayer( it->getKey(), layer, &placeLayers, &placeEntries, &placeBoxes );
+
+		for( std::size_t i=places.size(); i<placeEntries.size(); ++i )
+		{
+			const OsmPlace	&source = tileMap.getPlace( placeEntries[i].key );
+			OsmTilePlace	&place = places.createElement();
+
+			place.m_key = placeEntries[i].key;
+			place.m_pos = source.pos;
+			place.m_nameOffset = uint32( names.strlen() );
+			place.m_nameLength = uint32( source.name.strlen() );
+			names += source.name;
+		}
+	}
+
+	// the areas of each layer in the order of their index with their vertices
+	PODarray<OsmTileArea>		areas;
+	PODarray<OsmTileLayer>		areaLayers;
+	PODarray<OsmTileAreaEntry>	areaEntries;
+	PODarray<SpatialBox>		areaBoxes;
+	PODarray<OsmPosition>		vertices;
+	for(
+		typename OsmMapT::AreaLayers::const_iterator it = tileMap.getAreaIndex().cbegin(),
+			endIT = tileMap.getAreaIndex().cend();
+		it != endIT;
+		++it
+	)
+	{
+		typename OsmMapT::AreaIndex	layer = it->getValue();
+		addLayer( it->getKey(), layer, &areaLayers, &areaEntries, &areaBoxes );
+
+		for( std::size_t i=areas.size(); i<areaEntries.size(); ++i )
+		{
+			const Area		&source = tileMap.getArea( areaEntries[i].key );
+			OsmTileArea		&area = areas.createElement();
+
+			area.m_key = areaEntries[i].key;
+			area.m_firstVertex = uint32( vertices.size() );
+			area.m_numVertices = uint32( source.points.size() );
+			for(
+				Area::const_iterator itV = source.cbegin(), endV = source.cend();
+				itV != endV;
+				++itV
+			)
+			{
+				vertices.addElement( *itV );
+			}
+		}
+	}
+
+	// the key orders are used to find places and areas by their keys
+	PODarray<uint32>	placeOrder = getKeyOrder( places );
+	PODarray<uint32>	areaOrder = getKeyOrder( areas );
+
+	OsmTileHeader	header;
+	std::memset( &header, 0, sizeof( header ) );
+	header.m_magic = OSM_TILE_MAGIC;
+	header.m_version = OSM_TILE_VERSION;
+	header.m_headerSize = uint16( sizeof( OsmTileHeader ) );
+	header.m_tileID = tileID;
+	header.m_numNodes = uint32( nodes.size() );
+	header.m_numOutgoing = uint32( outgoing.size() );
+	header.m_numLinks = uint32( links.size() );
+	header.m_numNodeLayers = uint32( nodeLayers.size() );
+	header.m_numNodeEntries = uint32( nodeEntries.size() );
+	header.m_numNodeBoxes = uint32( nodeBoxes.size() );
+	header.m_numPlaces = uint32( places.size() );
+	header.m_numPlaceLayers = uint32( placeLayers.size() );
+	header.m_numPlaceBoxes = uint32( placeBoxes.size() );
+	header.m_numAreas = uint32( areas.size() );
+	header.m_numAreaLayers = uint32( areaLayers.size() );
+	header.m_numAreaBoxes = uint32( areaBoxes.size() );
+	header.m_numVertices = uint32( vertices.size() );
+	header.m_namesSize = uint32( names.strlen() );
+
+	OsmTileLayout	layout = getLayout( header );
+	header.m_fileSize = layout.m_size;
+
+	m_file.close();
+	m_buffer.setSize( layout.m_size );
+	char	*data = m_buffer.getDataBuffer();
+	std::memset( data, 0, layout.m_size );
+	std::memcpy( data, &header, sizeof( header ) );
+
+	copyArray( data, layout.m_nodes, nodes );
+	copyArray( data, layout.m_outgoing, outgoing );
+	copyArray( data, layout.m_links, links );
+	copyArray( data, layout.m_nodeLayers, nodeLayers );
+	copyArray( data, layout.m_nodeEntries, nodeEntries );
+	copyArray( data, layout.m_nodeBoxes, nodeBoxes );
+	copyArray( data, layout.m_places, places );
+	copyArray( data, layout.m_placeLayers, placeLayers );
+	copyArray( data, layout.m_placeEntries, placeEntries );
+	copyArray( data, layout.m_placeBoxes, placeBoxes );
+	copyArray( data, layout.m_placeOrder, placeOrder );
+	copyArray( data, layout.m_areas, areas );
+	copyArray( data, layout.m_areaLayers, areaLayers );
+	copyArray( data, layout.m_areaEntries, areaEntries );
+	copyArray( data, layout.m_areaBoxes, areaBoxes );
+	copyArray( data, layout.m_areaOrder, areaOrder );
+	copyArray( data, layout.m_vertices, vertices );
+	if( names.strlen() )
+	{
+		std::memcpy( data + layout.m_names, static_cast<const char *>( names ), names.strlen() );
+	}
+
+	setPointers( data );
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_OSM_TILE_STORE_H
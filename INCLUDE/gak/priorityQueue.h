@@ -41,6 +41,8 @@
 // --------------------------------------------------------------------- //
 
 #include <gak/compare.h>
+#include <gak/array.h>
+#include <gak/math.h>
 #include <gak/list.h>
 #include <gak/queue.h>
 #include <gak/map.h>
@@ -176,6 +178,262 @@ class PriorityQueue2 : public Container
 	}
 };
 
+/**
+	@brief a priority queue stored in a contiguous d-ary heap
+
+	In contrast to PriorityQueue and PriorityQueue2 the items are stored in
+	one Array. push and pop move O(log n) items and do not allocate any
+	memory once the Array has grown. Like the other queues the item with the
+	highest priority is fetched first and items with the same priority are
+	fetched in the order they were pushed.
+
+	push returns a handle that is valid until the item is fetched or removed.
+	With @ref changePriority the priority of a waiting item can be changed,
+	thus graph searches like AstarRouting can update an open node instead of
+	pushing it again. Since the highest priority comes first, the decrease
+	key of a min heap is a changePriority to a higher priority here.
+
+	@tparam OBJ the item type, must be default constructible
+	@tparam ARITY the number of children of each heap node. With 4 children
+	the heap has half the depth of a binary heap and the children of small
+	items share one cache line.
+*/
+template<
+	typename OBJ, typename PriorityT = typename OBJ::priority_type,
+	typename PriorityExtractorT = PriorityExtractor<OBJ, PriorityT>,
+	size_t ARITY = 4
+>
+class HeapQueue
+{
+	public:
+	typedef PriorityT	priority_type;
+	/// identifies an item in the queue, is never Container::no_index
+	typedef size_t		handle_type;
+
+	private:
+	struct HeapEntry
+	{
+		priority_type	m_priority;
+		size_t			m_sequence;
+		handle_type		m_handle;
+		OBJ				m_item;
+	};
+
+	Array<HeapEntry>		m_heap;
+	PODarray<size_t>		m_positions;		// the heap index of each handle
+	PODarray<handle_type>	m_freeHandles;
+	size_t					m_sequence;
+
+	static bool isBefore( const HeapEntry &entry, const HeapEntry &other )
+	{
+		int	cmp = gak::compare( entry.m_priority, other.m_priority );
+		return cmp > 0 || (!cmp && entry.m_sequence < other.m_sequence);
+	}
+	void moveEntry( size_t pos, const HeapEntry &entry )
+	{
+		m_heap[pos] = entry;
+		m_positions[entry.m_handle] = pos;
+	}
+	void siftUp( size_t pos );
+	void siftDown( size_t pos );
+	void removeAt( size_t pos );
+
+	public:
+	HeapQueue() : m_sequence( 0 )
+	{
+	}
+
+	/**
+		@brief adds a new item to the Queue
+		@param [in] item the new item
+		@return the handle of the new item
+	*/
+	handle_type push( const OBJ &item )
+	{
+		return push( item, PriorityExtractorT::getPriority( item ) );
+	}
+	/**
+		@brief adds a new item to the Queue
+		@param [in] item the new item
+		@param [in] priority the priority of the item
+		@return the handle of the new item
+	*/
+	handle_type push( const OBJ &item, priority_type priority );
+
+	/**
+		@brief fetches the item with the highest priority from the Queue
+
+		if the Queue is empty a QueueEmptyError exception is thrown
+
+		@return the next item in the Queue
+	*/
+	OBJ pop( void );
+	/**
+		@brief returns the item with the highest priority without removing it
+
+		if the Queue is empty a QueueEmptyError exception is thrown
+	*/
+	const OBJ &top( void ) const
+	{
+		if( !m_heap.size() )
+		{
+			throw QueueEmptyError();
+		}
+		return m_heap[0].m_item;
+	}
+
+	/**
+		@brief changes the priority of an item waiting in the Queue
+		@param [in] handle the handle returned by push
+		@param [in] priority the new priority
+	*/
+	void changePriority( handle_type handle, priority_type priority );
+	/// removes the item with the handle from the Queue
+	void remove( handle_type handle )
+	{
+		assert( contains( handle ) );
+		removeAt( m_positions[handle] );
+	}
+	/// @return true if the item of handle is still waiting in the Queue
+	bool contains( handle_type handle ) const
+	{
+		return handle < m_positions.size() && m_positions[handle] != Container::no_index;
+	}
+	/// @return the priority of a waiting item
+	priority_type getPriority( handle_type handle ) const
+	{
+		assert( contains( handle ) );
+		return m_heap[m_positions[handle]].m_priority;
+	}
+
+	/// deletes all items in this Queue
+	void clear( void )
+	{
+		m_heap.clear();
+		m_positions.clear();
+		m_freeHandles.clear();
+		m_sequence = 0;
+	}
+	/// @return the number of elements in this Queue
+	size_t size( void ) const
+	{
+		return m_heap.size();
+	}
+};
+
+/**
+	@brief a monotone priority queue for integer costs (radix heap)
+
+	In contrast to the other queues RadixQueue fetches the item with the
+	lowest key first, since it is made for costs like the route cost of
+	Dijkstra's algorithm. The key of a new item must not be less than the key
+	of the last item fetched.
+
+	The items are stored in buckets by the highest bit in which their key
+	differs from the last key fetched. push is O(1) and each item moves to a
+	lower bucket at most once per bit of the key, thus pop is amortized
+	O(log C) for costs up to C. Items with the same key are fetched in no
+	specific order.
+
+	There is no decrease key. Push the item again with its lower key and
+	skip the outdated copy when it is fetched.
+
+	@tparam OBJ the item type, must be default constructible
+	@tparam KeyT an unsigned integer type
+*/
+template<
+	typename OBJ, typename KeyT = uint64,
+	typename KeyExtractorT = PriorityExtractor<OBJ, KeyT>
+>
+class RadixQueue
+{
+	public:
+	typedef KeyT	key_type;
+
+	private:
+	static const size_t NUM_BUCKETS = sizeof(key_type)*8 + 1;
+
+	struct BucketEntry
+	{
+		key_type	m_key;
+		OBJ			m_item;
+	};
+	typedef Array<BucketEntry>	Bucket;
+
+	Bucket		m_buckets[NUM_BUCKETS];
+	key_type	m_lastKey;
+	size_t		m_numItems;
+
+	/// bucket 0 holds the last key, bucket i the keys differing in bit i-1
+	static size_t getBucket( key_type key, key_type lastKey )
+	{
+		size_t	bucket = 0;
+		for( key_type diff = key ^ lastKey; diff; diff >>= 1 )
+		{
+			++bucket;
+		}
+		return bucket;
+	}
+	void redistribute( void );
+
+	public:
+	RadixQueue() : m_lastKey( 0 ), m_numItems( 0 )
+	{
+	}
+
+	/**
+		@brief adds a new item to the Queue
+		@param [in] item the new item
+	*/
+	void push( const OBJ &item )
+	{
+		push( item, KeyExtractorT::getPriority( item ) );
+	}
+	/**
+		@brief adds a new item to the Queue
+		@param [in] item the new item
+		@param [in] key the key of the item, not less than @ref getLastKey
+	*/
+	void push( const OBJ &item, key_type key )
+	{
+		assert( key >= m_lastKey );
+
+		BucketEntry	&entry = m_buckets[getBucket( key, m_lastKey )].createElement();
+		entry.m_key = key;
+		entry.m_item = item;
+		++m_numItems;
+	}
+	/**
+		@brief fetches the item with the lowest key from the Queue
+
+		if the Queue is empty a QueueEmptyError exception is thrown
+
+		@return the next item in the Queue
+	*/
+	OBJ pop( void );
+
+	/// @return the key of the last item fetched
+	key_type getLastKey( void ) const
+	{
+		return m_lastKey;
+	}
+	/// deletes all items in this Queue
+	void clear( void )
+	{
+		for( size_t i=0; i<NUM_BUCKETS; ++i )
+		{
+			m_buckets[i].clear();
+		}
+		m_lastKey = 0;
+		m_numItems = 0;
+	}
+	/// @return the number of elements in this Queue
+	size_t size( void ) const
+	{
+		return m_numItems;
+	}
+};
+
 // --------------------------------------------------------------------- //
 // ----- exported datas ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -212,6 +470,119 @@ class PriorityQueue2 : public Container
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+void HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::siftUp( size_t pos )
+{
+	HeapEntry	entry = m_heap[pos];
+
+	while( pos > 0 )
+	{
+		size_t	parent = (pos-1) / ARITY;
+		if( !isBefore( entry, m_heap[parent] ) )
+		{
+			break;
+		}
+		moveEntry( pos, m_heap[parent] );
+		pos = parent;
+	}
+	moveEntry( pos, entry );
+}
+
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+void HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::siftDown( size_t pos )
+{
+	HeapEntry	entry = m_heap[pos];
+	size_t		numEntries = m_heap.size();
+
+	for(;;)
+	{
+		size_t	first = pos*ARITY + 1;
+		if( first >= numEntries )
+		{
+			break;
+		}
+
+		size_t	best = first;
+		size_t	last = math::min( first+ARITY, numEntries );
+		for( size_t child = first+1; child < last; ++child )
+		{
+			if( isBefore( m_heap[child], m_heap[best] ) )
+			{
+				best = child;
+			}
+		}
+		if( !isBefore( m_heap[best], entry ) )
+		{
+			break;
+		}
+		moveEntry( pos, m_heap[best] );
+		pos = best;
+	}
+	moveEntry( pos, entry );
+}
+
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+void HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::removeAt( size_t pos )
+{
+	handle_type	handle = m_heap[pos].m_handle;
+	size_t		last = m_heap.size()-1;
+
+	m_positions[handle] = Container::no_index;
+	m_freeHandles.addElement( handle );
+
+	if( pos < last )
+	{
+		moveEntry( pos, m_heap[last] );
+		m_heap.removeElementAt( last );
+		if( pos > 0 && isBefore( m_heap[pos], m_heap[(pos-1) / ARITY] ) )
+		{
+			siftUp( pos );
+		}
+		else
+		{
+			siftDown( pos );
+		}
+	}
+	else
+	{
+		m_heap.removeElementAt( last );
+	}
+}
+
+template<typename OBJ, typename KeyT, typename KeyExtractorT>
+void RadixQueue<OBJ, KeyT, KeyExtractorT>::redistribute( void )
+{
+	size_t	i = 1;
+	while( !m_buckets[i].size() )
+	{
+		++i;
+	}
+
+	Bucket	&bucket = m_buckets[i];
+	for(
+		typename Bucket::const_iterator it = bucket.cbegin(), endIT = bucket.cend();
+		it != endIT;
+		++it
+	)
+	{
+		if( it == bucket.cbegin() || it->m_key < m_lastKey )
+		{
+			m_lastKey = it->m_key;
+		}
+	}
+
+	// all keys of this bucket go to a lower bucket
+	for(
+		typename Bucket::const_iterator it = bucket.cbegin(), endIT = bucket.cend();
+		it != endIT;
+		++it
+	)
+	{
+		m_buckets[getBucket( it->m_key, m_lastKey )].addElement( *it );
+	}
+	bucket.clear();
+}
+
 // --------------------------------------------------------------------- //
 // ----- class protected ----------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -284,6 +655,87 @@ OBJ PriorityQueue2<OBJ, PriorityT, PriorityExtractorT>::pop( void )
 	throw QueueEmptyError();
 }
 
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+typename HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::handle_type
+HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::push( const OBJ &item, priority_type priority )
+{
+	handle_type	handle;
+	if( m_freeHandles.size() )
+	{
+		handle = m_freeHandles[m_freeHandles.size()-1];
+		m_freeHandles.removeElementAt( m_freeHandles.size()-1 );
+	}
+	else
+	{
+		handle = m_positions.size();
+		m_positions.addElement( Container::no_index );
+	}
+
+	HeapEntry	&entry = m_heap.createElement();
+	entry.m_priority = priority;
+	entry.m_sequence = m_sequence++;
+	entry.m_handle = handle;
+	entry.m_item = item;
+
+	m_positions[handle] = m_heap.size()-1;
+	siftUp( m_heap.size()-1 );
+
+	return handle;
+}
+
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+OBJ HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::pop( void )
+{
+	if( m_heap.size() )
+	{
+		OBJ	item = m_heap[0].m_item;
+		removeAt( 0 );
+		return item;
+	}
+
+	throw QueueEmptyError();
+}
+
+template<typename OBJ, typename PriorityT, typename PriorityExtractorT, size_t ARITY>
+void HeapQueue<OBJ, PriorityT, PriorityExtractorT, ARITY>::changePriority( handle_type handle, priority_type priority )
+{
+	assert( contains( handle ) );
+
+	size_t		pos = m_positions[handle];
+	HeapEntry	&entry = m_heap[pos];
+	int			cmp = gak::compare( priority, entry.m_priority );
+
+	entry.m_priority = priority;
+	if( cmp > 0 )
+	{
+		siftUp( pos );
+	}
+	else if( cmp < 0 )
+	{
+		siftDown( pos );
+	}
+}
+
+template<typename OBJ, typename KeyT, typename KeyExtractorT>
+OBJ RadixQueue<OBJ, KeyT, KeyExtractorT>::pop( void )
+{
+	if( m_numItems )
+	{
+		if( !m_buckets[0].size() )
+		{
+			redistribute();
+		}
+
+		Bucket	&bucket = m_buckets[0];
+		OBJ		item = bucket[bucket.size()-1].m_item;
+		bucket.removeElementAt( bucket.size()-1 );
+		--m_numItems;
+		return item;
+	}
+
+	throw QueueEmptyError();
+}
+
 // --------------------------------------------------------------------- //
 // ----- entry points -------------------------------------------------- //
 // --------------------------------------------------------------------- //
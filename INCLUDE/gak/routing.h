@@ -97,6 +97,7 @@ class Routing
 	typedef typename graph_t::link_key_type			link_key_type;
 	typedef typename graph_t::link_key_types		link_key_types;
 	typedef typename graph_t::link_container_type	link_container_type;
+	typedef typename graph_t::outgoing_links		outgoing_links;
 
 	typedef typename graph_t::node_type				node_type;
 	typedef typename graph_t::node_key_type			node_key_type;
@@ -132,6 +133,7 @@ class AstarRouting : public Routing<GraphT>
 	typedef typename Super::link_key_type		link_key_type;
 	typedef typename Super::link_key_types		link_key_types;
 	typedef typename Super::link_container_type	link_container_type;
+	typedef typename Super::outgoing_links		outgoing_links;
 
 	typedef typename Super::node_type			node_type;
 	typedef typename Super::node_key_type		node_key_type;
@@ -150,6 +152,7 @@ class AstarRouting : public Routing<GraphT>
 		node_key_type	m_nodeID;
 		link_key_type	m_linkID;
 		NodeRouteInfo	*m_previous;
+		size_t			m_handle;		// the handle in OpenNodes while the node is open
 
 		void calcPrio()
 		{
@@ -160,6 +163,7 @@ class AstarRouting : public Routing<GraphT>
 		{
 			m_nodeID = nodeID;
 			m_estimatedRemainigCost = remainingCost;
+			m_handle = Container::no_index;
 			setRouteCost( link_key_type(),  0, NULL );
 		}
 		NodeRouteInfo(
@@ -169,6 +173,7 @@ class AstarRouting : public Routing<GraphT>
 		{
 			m_nodeID = nodeID;
 			m_estimatedRemainigCost = remainingCost;
+			m_handle = Container::no_index;
 			setRouteCost( linkID,  routeCost, previous );
 		}
 		void setRouteCost( 
@@ -200,9 +205,21 @@ class AstarRouting : public Routing<GraphT>
 		{
 			return m_linkID;
 		}
+		size_t getHandle() const
+		{
+			return m_handle;
+		}
+		void setHandle( size_t handle )
+		{
+			m_handle = handle;
+		}
+		bool isOpen() const
+		{
+			return m_handle != Container::no_index;
+		}
 	};
 
-	typedef PriorityQueue2<NodeRouteInfo*, double, PointerPriorityExtractor<NodeRouteInfo, double> >	OpenNodes;
+	typedef HeapQueue<NodeRouteInfo*, double, PointerPriorityExtractor<NodeRouteInfo, double> >		OpenNodes;
 	typedef List<NodeRouteInfo>														NodeRouteInfos;
 	typedef TreeMap<node_key_type, NodeRouteInfo*>									VisitedNodes;
 
@@ -230,6 +247,7 @@ class RecursiveRouting : public Routing<GraphT>
 	typedef typename Super::link_key_type		link_key_type;
 	typedef typename Super::link_key_types		link_key_types;
 	typedef typename Super::link_container_type	link_container_type;
+	typedef typename Super::outgoing_links		outgoing_links;
 
 	typedef typename Super::node_type			node_type;
 	typedef typename Super::node_key_type		node_key_type;
@@ -338,10 +356,10 @@ class RecursiveRouting : public Routing<GraphT>
 	SortedArray<OutgoingInfo> getOutgoing( const node_key_type &from, const node_key_type &to, CostT costType ) const
 	{
 		SortedArray<OutgoingInfo>	sortedOutgoing;
-		const link_key_types		&outgoing = Super::m_graph.getOutgoing( from );
+		const outgoing_links		&outgoing = Super::m_graph.getOutgoing( from );
 
 		for(
-			typename link_key_types::const_iterator it = outgoing.cbegin(), endIT = outgoing.cend();
+			typename outgoing_links::const_iterator it = outgoing.cbegin(), endIT = outgoing.cend();
 			it != endIT;
 			++it
 		)
@@ -538,11 +556,12 @@ AstarRouting<GraphT>::route(
 		)
 	);
 	visited.setValue( from, currentNodeInfo );
-	openNodes.push( currentNodeInfo );
+	currentNodeInfo->setHandle( openNodes.push( currentNodeInfo ) );
 
 	while( openNodes.size() )
 	{
 		currentNodeInfo = openNodes.pop();
+		currentNodeInfo->setHandle( Container::no_index );
 		currentNodeID = currentNodeInfo->getNodeID();
 		double currentRouteCost = currentNodeInfo->getRouteCost();
 
@@ -552,9 +571,9 @@ AstarRouting<GraphT>::route(
 			break;
 		}
 
-		const link_key_types &out = Super::m_graph.getOutgoing( currentNodeID );
+		const outgoing_links &out = Super::m_graph.getOutgoing( currentNodeID );
 		for(
-			typename link_key_types::const_iterator it = out.cbegin(), endIT = out.cend();
+			typename outgoing_links::const_iterator it = out.cbegin(), endIT = out.cend();
 			it != endIT;
 			++it
 		)
@@ -575,7 +594,14 @@ AstarRouting<GraphT>::route(
 				if( newRouteCost < nextNodeInfo->getRouteCost() )
 				{
 					nextNodeInfo->setRouteCost( linkID, newRouteCost, currentNodeInfo );
-					openNodes.push( nextNodeInfo );
+					if( nextNodeInfo->isOpen() )
+					{
+						openNodes.changePriority( nextNodeInfo->getHandle(), nextNodeInfo->getPriority() );
+					}
+					else
+					{
+						nextNodeInfo->setHandle( openNodes.push( nextNodeInfo ) );
+					}
 				}
 			}
 			else
@@ -587,7 +613,7 @@ AstarRouting<GraphT>::route(
 					)
 				);
 				visited.setValue( endNodeID, nextNodeInfo );
-				openNodes.push( nextNodeInfo );
+				nextNodeInfo->setHandle( openNodes.push( nextNodeInfo ) );
 			}
 		}
 	}
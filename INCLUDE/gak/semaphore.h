@@ -0,0 +1,288 @@
+/*
+		Project:		GAKLIB
+		Module:			semaphore.h
+		Description:	counting semaphore used to park and wake threads
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_SEMAPHORE_H
+#define GAK_SEMAPHORE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#if defined( _Windows )
+#	include <gak/win_tools.h>
+#elif defined( __MACH__ ) || defined( __unix__ )
+#	include <pthread.h>
+#	include <sys/time.h>
+#else
+#	error "Unknown operating system"
+#endif
+
+#include <cstddef>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a counting semaphore
+
+	Unlike a Conditional, notifications are never lost: each call to notify
+	increments the counter and each successful wait decrements it. A thread
+	calling wait blocks only, if the counter is 0.
+*/
+class Semaphore
+{
+#if defined( _Windows )
+	windows::WinHandle	m_semaphore;
+#elif defined( __MACH__ ) || defined( __unix__ )
+	pthread_cond_t		m_conditional;
+	pthread_mutex_t		m_mutex;
+	std::size_t			m_count,
+						m_waiting;
+#endif
+
+	// no copy
+	Semaphore( const Semaphore & );
+	const Semaphore & operator = ( const Semaphore & );
+
+	public:
+	/// constant value to specify to wait forever
+	static const unsigned long WAIT_FOREVER = static_cast<unsigned long>(-1);
+
+#if defined( _Windows )
+	/**
+		@brief creates a new semaphore
+		@param [in] initialCount the initial value of the counter
+	*/
+	Semaphore( std::size_t initialCount=0 )
+	: m_semaphore( CreateSemaphore( NULL, LONG(initialCount), LONG_MAX, NULL ) )
+	{
+	}
+#elif defined( __MACH__ ) || defined( __unix__ )
+	Semaphore( std::size_t initialCount=0 ) : m_count( initialCount ), m_waiting( 0 )
+	{
+		pthread_cond_init( &m_conditional, NULL );
+		pthread_mutex_init( &m_mutex, NULL );
+	}
+	~Semaphore()
+	{
+		pthread_cond_destroy( &m_conditional );
+		pthread_mutex_destroy( &m_mutex );
+	}
+#endif
+
+	/**
+		@brief waits until the counter is greater than 0 and decrements it
+		@param [in] timeOut the max time in ms to wait
+		@return true if the counter was decremented, false on timeout
+	*/
+	bool wait( unsigned long timeOut = WAIT_FOREVER )
+	{
+#if defined( _Windows )
+		return WaitForSingleObject( m_semaphore.get(), timeOut ) == WAIT_OBJECT_0;
+#elif defined( __MACH__ ) || defined( __unix__ )
+		bool	result = true;
+
+		pthread_mutex_lock( &m_mutex );
+		++m_waiting;
+		if( timeOut == WAIT_FOREVER )
+		{
+			while( !m_count )
+			{
+				pthread_cond_wait( &m_conditional, &m_mutex );
+			}
+		}
+		else if( !m_count )
+		{
+			struct timespec	absTime;
+			struct timeval	now;
+
+			gettimeofday( &now, NULL );
+			absTime.tv_sec = now.tv_sec + timeOut / 1000;
+			absTime.tv_nsec = (now.tv_usec + 1000UL*(timeOut % 1000UL)) * 1000UL;
+			if( absTime.tv_nsec >= 1000000000L )
+			{
+				absTime.tv_sec++;
+				absTime.tv_nsec -= 1000000000L;
+			}
+			while( !m_count )
+			{
+				if( pthread_cond_timedwait( &m_conditional, &m_mutex, &absTime ) != 0 )
+				{
+					break;
+				}
+			}
+		}
+		--m_waiting;
+		if( m_count )
+		{
+			--m_count;
+		}
+		else
+		{
+			result = false;
+		}
+		pthread_mutex_unlock( &m_mutex );
+
+		return result;
+#endif
+	}
+
+	/**
+		@brief increments the counter and wakes up waiting threads
+
+		no more than count threads are woken up.
+
+		@param [in] count the value to add to the counter
+	*/
+	void notify( std::size_t count=1 )
+	{
+		if( !count )
+		{
+			return;
+		}
+#if defined( _Windows )
+		ReleaseSemaphore( m_semaphore.get(), LONG(count), NULL );
+#elif defined( __MACH__ ) || defined( __unix__ )
+		pthread_mutex_lock( &m_mutex );
+		m_count += count;
+		if( count >= m_waiting )
+		{
+			pthread_cond_broadcast( &m_conditional );
+		}
+		else
+		{
+			while( count-- )
+			{
+				pthread_cond_signal( &m_conditional );
+			}
+		}
+		pthread_mutex_unlock( &m_mutex );
+#endif
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_SEMAPHORE_H
@@ -43,7 +43,7 @@
 
 #include <assert.h>
 
-#include <gak/locker.h>
+#include <gak/atomic.h>
 #include <gak/memory>
 
 // --------------------------------------------------------------------- //
@@ -85,8 +85,7 @@ namespace gak
 */
 class SharedObject
 {
-	Critical	m_critical;
-	int			m_usageCount;
+	Atomic<int>	m_usageCount;
 	bool		m_autoDelete;
 
 	protected:
@@ -94,29 +93,37 @@ class SharedObject
 		@brief creates a new object
 		@param [in] autoDelete if true, the item will be automaticaly deleted if there is no SharedObjectPointer pointing to this item
 	*/
-	SharedObject( bool autoDelete=true )
+	SharedObject( bool autoDelete=true ) : m_usageCount( 0 )
 	{
-		m_usageCount = 0;
 		m_autoDelete = autoDelete;
 	}
+	/// a copy is a new object without any SharedObjectPointer pointing to it
+	SharedObject( const SharedObject &src ) : m_usageCount( 0 )
+	{
+		m_autoDelete = src.m_autoDelete;
+	}
+	/// the usage counter is not copied
+	const SharedObject & operator = ( const SharedObject & )
+	{
+		return *this;
+	}
 	~SharedObject()
 	{
-		assert( !m_usageCount );
+		assert( !m_usageCount.load( moRelaxed ) );
 	}
 
 	public:
 	/// Increments the usage counter
 	void incUC()
 	{
-		m_usageCount++;
+		m_usageCount.fetchAdd( 1, moRelaxed );
 	}
-	/// Decrements the usage counter
+	/// Decrements the usage counter and returns the new value
 	int decUC()
 	{
-		assert( m_usageCount > 0 );
-		--m_usageCount;
-		assert( m_usageCount >= 0 );
-		return m_usageCount;
+		int	usageCount = m_usageCount.fetchSub( 1, moAcqRel ) - 1;
+		assert( usageCount >= 0 );
+		return usageCount;
 	}
 	/// Disables the automatoc deletion
 	void disableAutoDelete()
@@ -136,12 +143,7 @@ class SharedObject
 	/// Returns the number of SharedObjectPointer objects pointing to this item
 	int getUsageCount() const
 	{
-		return m_usageCount;
-	}
-
-	Critical &getCritical()
-	{
-		return m_critical;
+		return m_usageCount.load();
 	}
 };
 
@@ -169,24 +171,16 @@ class SharedObjectPointer
 	private:
 	void clrPointer()
 	{
-		bool	doDelete = false;
-		if( m_addr )
+		if( m_addr && !m_addr->decUC() && m_addr->SharedObject::canDelete() )
 		{
-			CriticalScope	scope( m_addr->getCritical() );
-			if( !m_addr->decUC() && m_addr->SharedObject::canDelete() )
-			{
-				doDelete = true;
-			}
-		}
-		if( doDelete )
 			delete m_addr;
+		}
 	}
 	void setPointer( ShObj *addr )
 	{
 		m_addr = addr;
 		if( addr )
 		{
-			CriticalScope	scope( m_addr->getCritical() );
 			addr->incUC();
 		}
 	}
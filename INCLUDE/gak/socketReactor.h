@@ -0,0 +1,286 @@
+/*
+		Project:		GAKLIB
+		Module:			socketReactor.h
+		Description:	multiplexes the connections of a server with epoll
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_SOCKET_REACTOR_H
+#define GAK_SOCKET_REACTOR_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <ctime>
+
+#include <gak/socketbuf.h>
+#include <gak/thread.h>
+#include <gak/locker.h>
+#include <gak/array.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace net
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the default time in seconds a SocketReactor keeps a connection open without any request
+const unsigned REACTOR_IDLE_TIMEOUT = 60;
+
+/// a connection is passed to a worker, if this number of bytes is received without a complete request
+const std::size_t REACTOR_MAX_PENDING = 65536;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief multiplexes the listener and all idle connections of a server on a few threads
+
+	A SocketServer without reactor blocks one worker thread for each open
+	connection, even if the client does not send anything. The reactor waits
+	with epoll for all sockets of a server at once: new connections are
+	accepted and the data of the clients is collected by a few event threads.
+	A connection is passed to @ref dispatch, only if @ref isRequestComplete
+	tells that the data received so far contains a complete request. The data
+	is passed with ClientConnection::m_received to the worker.
+
+	If the worker wants to keep the connection open for the next request it
+	gives the connection back with @ref resume. Connections without any data
+	for more than the idle timeout are closed.
+
+	The reactor needs epoll, thus it is available on Linux, only.
+
+	@see SocketServer, ServerProcessorBase::setKeepAlive
+*/
+class SocketReactor
+{
+	/// a connection waiting for a request
+	struct Connection
+	{
+		ClientConnection	m_connection;
+		std::time_t			m_lastActivity;
+		Connection			*m_prev, *m_next;
+		bool				m_closing;
+	};
+
+	class EventThread : public Thread
+	{
+		SocketReactor	&m_reactor;
+
+		virtual void ExecuteThread();
+
+		public:
+		EventThread( SocketReactor &reactor ) : m_reactor( reactor )
+		{
+		}
+	};
+
+	int				m_epoll;
+	SOCKET			m_listenSocket;
+	unsigned short	m_port;
+	unsigned		m_idleTimeout;
+	Connection		m_listener;
+	Array<Thread::Ptr>	m_threads;
+
+	/// protects the list of idle connections
+	Critical		m_lock;
+	Connection		*m_idleConnections;
+	std::size_t		m_numConnections;
+	std::time_t		m_nextCheck;
+	bool			m_running;
+
+	// no copy
+	SocketReactor( const SocketReactor & );
+	const SocketReactor & operator = ( const SocketReactor & );
+
+	void link( Connection *connection );
+	void unlink( Connection *connection );
+	bool arm( Connection *connection, int operation );
+	bool waitForRequest( Connection *connection, int operation );
+	void closeConnection( Connection *connection );
+
+	void acceptConnections();
+	void handleInput( Connection *connection );
+	void checkIdleConnections();
+	void runEventLoop( const Thread &thread );
+
+	/**
+		@brief tells whether a connection can be passed to a worker
+		@param [in] data the data received so far
+		@param [in] size the number of bytes received
+		@return true if data contains a complete request
+	*/
+	virtual bool isRequestComplete( const char *data, std::size_t size ) const = 0;
+	/**
+		@brief passes a connection with a complete request to a worker
+
+		If the workers are already stopped a LibraryException is thrown,
+		e.g. a ThreadPoolError, and the reactor closes the connection.
+
+		@param [in] connection the connection including the data already received
+	*/
+	virtual void dispatch( const ClientConnection &connection ) = 0;
+
+	public:
+	/**
+		@brief creates a new reactor
+		@param [in] idleTimeout the time in seconds a connection without any data is kept open
+	*/
+	SocketReactor( unsigned idleTimeout=REACTOR_IDLE_TIMEOUT );
+	virtual ~SocketReactor();
+
+	/// returns true, if the reactor is supported by the operating system
+	static bool isAvailable();
+
+	/**
+		@brief starts the event threads
+		@param [in] listenSocket a socket already listening for new connections
+		@param [in] port the IP port number of the listener passed to the workers
+		@param [in] numThreads the number of event threads to start
+		@return 0 on success otherwise an error code
+	*/
+	int start( SOCKET listenSocket, unsigned short port, std::size_t numThreads );
+	/**
+		@brief stops the event threads and closes all idle connections
+
+		The listen socket is not closed. A class overloading @ref dispatch
+		must call this function in its destructor.
+	*/
+	void stop();
+
+	/**
+		@brief gives a connection back after a worker has processed a request
+
+		If the reactor is stopped, or it is stopping while the next request
+		is dispatched, the connection is closed.
+
+		@param [in] connection the connection that waits for the next request including the data not yet processed
+	*/
+	void resume( const ClientConnection &connection );
+
+	/// returns the number of connections waiting for a request
+	std::size_t getNumConnections() const
+	{
+		return m_numConnections;
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace net
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_SOCKET_REACTOR_H
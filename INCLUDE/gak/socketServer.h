@@ -42,6 +42,7 @@
 
 #include <gak/socketbuf.h>
 #include <gak/threadPool.h>
+#include <gak/socketReactor.h>
 
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
@@ -62,6 +63,11 @@ namespace net
 // ----- constants ----------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// default time in seconds a persistent connection may be idle
+const unsigned KEEP_ALIVE_TIMEOUT = 5;
+/// default max. number of requests processed with one connection
+const size_t KEEP_ALIVE_MAX_REQUESTS = 100;
+
 // --------------------------------------------------------------------- //
 // ----- macros -------------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -70,6 +76,32 @@ namespace net
 // ----- type definitions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/**
+	@brief the settings of a SocketServer passed to its workers
+	@see SocketServer::setKeepAlive
+*/
+struct ServerSettings
+{
+	/// the reactor waiting for the requests or nullptr if each connection blocks a worker
+	SocketReactor	*m_reactor;
+	/// the time in seconds a persistent connection may be idle, 0 disables persistent connections
+	unsigned		m_idleTimeout;
+	/// the max. number of requests processed with one connection, 0 for no limit
+	size_t			m_maxRequests;
+	/**
+		true if persistent connections are enabled without a reactor, too. An idle
+		connection blocks its worker up to the idle timeout, thus they must be enabled
+		with SocketServer::setKeepAlive.
+	*/
+	bool			m_blockingKeepAlive;
+
+	ServerSettings()
+	: m_reactor( nullptr ), m_idleTimeout( KEEP_ALIVE_TIMEOUT ), m_maxRequests( KEEP_ALIVE_MAX_REQUESTS ),
+	  m_blockingKeepAlive( false )
+	{
+	}
+};
+
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -82,26 +114,70 @@ namespace net
 	base and implement the virtual function runServerThread. See 
 	HTTPserverBase for an example.
 
+	If the server runs with a SocketReactor the static function
+	isRequestComplete decides when a connection is passed to a worker.
+	The default passes a connection as soon as any data is received.
+
+	A processor that calls setKeepAlive from runServerThread keeps the
+	connection open. Without a SocketReactor the worker waits for the next
+	request up to the idle timeout of the ServerSettings, with a reactor the
+	connection is passed back to the reactor. Without a reactor persistent
+	connections are disabled unless SocketServer::setKeepAlive was called. Requests the client sent
+	without waiting for the response (pipelining) remain in the buffer and
+	are processed by the next call of runServerThread.
+
 	@see SocketServer, HTTPserverBase
 */
 class ServerProcessorBase : public SocketStreambuf
 {
-	SOCKADDR_IN			m_client;
-	unsigned short		m_port;
+	SOCKADDR_IN				m_client;
+	unsigned short			m_port;
+	bool					m_keepAlive;
+	size_t					m_numRequests;
+	const ServerSettings	*m_settings;
 
 	virtual void runServerThread() = 0;
+
+	bool waitForRequest();
+
+	protected:
+	/**
+		@brief keeps the connection open after runServerThread
+
+		@param [in] keepAlive true if the client may send another request
+		@see mayKeepAlive
+	*/
+	void setKeepAlive( bool keepAlive )
+	{
+		m_keepAlive = keepAlive;
+	}
+	/// returns true if the settings allow another request with this connection
+	bool mayKeepAlive() const
+	{
+		return m_settings && m_settings->m_idleTimeout
+			&& (!m_settings->m_maxRequests || m_numRequests < m_settings->m_maxRequests);
+	}
+
 	public:
 	/// this type is used by PoolThread
 	typedef ClientConnection object_type;
 
-	/// this type is called by PoolThread
-	void process( const ClientConnection &connection, void *, void * )
+	ServerProcessorBase() : m_keepAlive( false ), m_numRequests( 0 ), m_settings( nullptr )
 	{
-		accept( connection.m_socket, 10240 );
-		m_client = connection.m_client;
-		m_port = connection.m_port;
-		runServerThread();
-		disconnect();
+	}
+
+	/// this type is called by PoolThread, settings are the ServerSettings of the SocketServer or nullptr
+	void process( const ClientConnection &connection, void *, void *settings );
+
+	/// returns the number of requests processed with the current connection including the current one
+	size_t getNumRequests() const
+	{
+		return m_numRequests;
+	}
+	/// returns true if data contains a complete request (called by the SocketReactor)
+	static bool isRequestComplete( const char *, size_t size )
+	{
+		return size > 0;
 	}
 	/// returns the client with this worker is connected to
 	const SOCKADDR_IN &getClient() const
@@ -133,16 +209,59 @@ class ServerProcessorBase : public SocketStreambuf
 template <typename ServerProcessorT>
 class SocketServer
 {
+	typedef ThreadPool<ClientConnection, PoolThread<ServerProcessorT> >	ServerPool;
+
+	class ServerReactor : public SocketReactor
+	{
+		ServerSettings	m_settings;
+		ServerPool		m_threadPool;
+
+		virtual bool isRequestComplete( const char *data, size_t size ) const
+		{
+			return ServerProcessorT::isRequestComplete( data, size );
+		}
+		virtual void dispatch( const ClientConnection &connection )
+		{
+			m_threadPool.process( connection );
+		}
+
+		public:
+		ServerReactor( size_t numWorker, const ServerSettings &settings )
+		: SocketReactor( settings.m_idleTimeout ? settings.m_idleTimeout : REACTOR_IDLE_TIMEOUT ),
+		  m_settings( settings ),
+		  m_threadPool( numWorker, "ServerPool", &m_settings )
+		{
+			m_settings.m_reactor = this;
+		}
+		~ServerReactor()
+		{
+			stop();
+		}
+
+		int start( SOCKET listenSocket, unsigned short port, size_t numEventThreads )
+		{
+			m_threadPool.start();
+			return SocketReactor::start( listenSocket, port, numEventThreads );
+		}
+		void stop()
+		{
+			SocketReactor::stop();
+			m_threadPool.shutdown();
+		}
+	};
+
 	class ListenerThread : public Thread
 	{
 		unsigned short		m_port;
-		size_t				m_numWorker;
+		size_t				m_numWorker, m_numEventThreads;
+		ServerSettings		m_settings;
 		SocketStreambuf		m_socket;
 
+		bool runReactor();
 		virtual void ExecuteThread();
 		public:
-		ListenerThread( unsigned short port, size_t numWorker ) 
-		: Thread(), m_port(port), m_numWorker(numWorker)
+		ListenerThread( unsigned short port, size_t numWorker, size_t numEventThreads, const ServerSettings &settings ) 
+		: Thread(), m_port(port), m_numWorker(numWorker), m_numEventThreads(numEventThreads), m_settings(settings)
 		{
 			StartThread();
 		}
@@ -153,6 +272,7 @@ class SocketServer
 	};
 
 	unsigned short						m_port;
+	ServerSettings						m_settings;
 	SharedObjectPointer<ListenerThread>	m_listener;
 
 	public:
@@ -165,14 +285,37 @@ class SocketServer
 		@brief starts the server
 		@param [in] port the tcp/ip port this server should listen to
 		@param [in] numWorker the number of worker threads, the listener should start
+		@param [in] numEventThreads the number of event threads of a SocketReactor, 0 if each connection blocks a worker
 	*/
-	void startServer( unsigned short port, size_t numWorker )
+	void startServer( unsigned short port, size_t numWorker, size_t numEventThreads=0 )
 	{
 		if( m_listener )
 		{
 			stopServer( false );
 		} 
-		m_listener = new ListenerThread( port, numWorker );
+		m_listener = new ListenerThread( port, numWorker, numEventThreads, m_settings );
+	}
+
+	/**
+		@brief configures persistent connections, must be called before startServer
+
+		A server with a SocketReactor keeps connections open by default. Without
+		a reactor an idle connection blocks a worker, thus the server closes each
+		connection after the first request unless this function is called.
+
+		@param [in] idleTimeout the time in seconds a connection may be idle, 0 closes each connection after the first request
+		@param [in] maxRequests the max. number of requests processed with one connection, 0 for no limit
+	*/
+	void setKeepAlive( unsigned idleTimeout, size_t maxRequests=KEEP_ALIVE_MAX_REQUESTS )
+	{
+		m_settings.m_idleTimeout = idleTimeout;
+		m_settings.m_maxRequests = maxRequests;
+		m_settings.m_blockingKeepAlive = true;
+	}
+	/// returns the settings passed to the workers
+	const ServerSettings &getSettings() const
+	{
+		return m_settings;
 	}
 
 	/// stops this server
@@ -246,6 +389,46 @@ class SocketServer
 // ----- class privates ------------------------------------------------ //
 // --------------------------------------------------------------------- //
 
+/*
+	waits for the next request of a persistent connection, pipelined requests
+	are already in the buffer
+*/
+inline bool ServerProcessorBase::waitForRequest()
+{
+	if( gptr() < egptr() )
+	{
+/*@*/	return true;
+	}
+
+	long	timeout = getTimeout();
+
+	setTimeout( long(m_settings->m_idleTimeout) );
+	bool	received = SocketStreambuf::underflow() != EOF;
+	setTimeout( timeout );
+
+	return received;
+}
+
+template <typename ServerProcessorT>   
+bool SocketServer<ServerProcessorT>::ListenerThread::runReactor()
+{
+	doEnterFunction("SocketServer<ServerProcessorT>::ListenerThread::runReactor");
+
+	ServerReactor	reactor( m_numWorker, m_settings );
+
+	if( reactor.start( m_socket.getSocket(), m_port, m_numEventThreads ) )
+	{
+/*@*/	return false;
+	}
+
+	// the event threads of the reactor accept the connections
+	while( !Sleep( 1000 ) )
+		;
+
+	reactor.stop();
+	return true;
+}
+
 // --------------------------------------------------------------------- //
 // ----- class protected ----------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -259,10 +442,21 @@ void SocketServer<ServerProcessorT>::ListenerThread::ExecuteThread()
 {
 	doEnterFunction("SocketServer<ServerProcessorT>::ListenerThread::ExecuteThread");
 
-	ThreadPool<ClientConnection, PoolThread<ServerProcessorT> >	threadPool( m_numWorker, "ServerPool", nullptr );
-
 	if( !m_socket.listen( m_port ) )
 	{
+		if( m_numEventThreads && SocketReactor::isAvailable() && runReactor() )
+		{
+/*@*/		return;
+		}
+
+		// an idle connection would block a worker
+		if( !m_settings.m_blockingKeepAlive )
+		{
+			m_settings.m_idleTimeout = 0;
+		}
+
+		ServerPool	threadPool( m_numWorker, "ServerPool", &m_settings );
+
 		threadPool.start();
 		terminated = false;
 		while( !terminated )
@@ -283,6 +477,48 @@ void SocketServer<ServerProcessorT>::ListenerThread::ExecuteThread()
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+inline void ServerProcessorBase::process( const ClientConnection &connection, void *, void *settings )
+{
+	accept( connection, 10240 );
+	m_client = connection.m_client;
+	m_port = connection.m_port;
+	m_numRequests = connection.m_numRequests;
+	m_settings = static_cast<const ServerSettings *>(settings);
+
+	for(;;)
+	{
+		++m_numRequests;
+		m_keepAlive = false;
+		runServerThread();
+		if( !m_keepAlive || !mayKeepAlive() || !isConnected() || m_socketError )
+		{
+/*v*/		break;
+		}
+
+		if( m_settings->m_reactor )
+		{
+			// the reactor waits for the next request without blocking this worker
+			ClientConnection	next;
+
+			next.m_client = m_client;
+			next.m_port = m_port;
+			next.m_numRequests = m_numRequests;
+			if( gptr() < egptr() )
+			{
+				next.m_received.addElements( gptr(), size_t(egptr() - gptr()) );
+			}
+			next.m_socket = detach();
+			m_settings->m_reactor->resume( next );
+/*@*/		return;
+		}
+		if( !waitForRequest() )
+		{
+/*v*/		break;
+		}
+	}
+	disconnect();
+}
+
 // --------------------------------------------------------------------- //
 // ----- entry points -------------------------------------------------- //
 // --------------------------------------------------------------------- //
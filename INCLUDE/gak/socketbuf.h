@@ -56,6 +56,7 @@
 #endif
 
 #include <gak/string.h>
+#include <gak/array.h>
 
 // --------------------------------------------------------------------- //
 // ----- module switches ----------------------------------------------- //
@@ -106,6 +107,14 @@ struct ClientConnection
 	SOCKET 			m_socket;
 	/// the port number the server is listening to
 	unsigned short	m_port;
+	/// the data already received from the client by a SocketReactor @see SocketStreambuf::accept( const ClientConnection &connection, int bufferSize )
+	ArrayOfData		m_received;
+	/// the number of requests already processed with this connection
+	size_t			m_numRequests;
+
+	ClientConnection() : m_client(), m_socket( INVALID_SOCKET ), m_port( 0 ), m_numRequests( 0 )
+	{
+	}
 };
 
 /// streambuf used to read from an ip socket
@@ -119,6 +128,7 @@ class SocketStreambuf : public std::streambuf
 	SOCKET			m_socket;
 	bool			m_connected;
 	int				m_bufferSize;
+	long			m_timeout;
 	Buffer<char>	m_dataBuffer;
 
 	protected:
@@ -159,12 +169,6 @@ class SocketStreambuf : public std::streambuf
 	/// clears all data from the I/O buffer
 	void flush( void );
 
-	/// returns the OS id of the socket
-	int getSocket( void ) const
-	{
-		return int(m_socket);
-	}
-
 	/// returns the size of the currently used I/O buffer
 	int getBufferSize( void ) const
 	{
@@ -172,12 +176,20 @@ class SocketStreambuf : public std::streambuf
 	}
 
 	public:
+	/// returns the OS id of the socket
+	int getSocket( void ) const
+	{
+		return int(m_socket);
+	}
+
+
 	/// creates a new socket buffer
 	SocketStreambuf()
 	{
 		m_totalTime = m_connectTime = m_sendTime = m_receiveTime = 0;
 
 		m_bytesRead = m_bufferSize = 0;
+		m_timeout = 10;
 		m_socket = 0;
 		m_connected = false;
 
@@ -231,6 +243,24 @@ class SocketStreambuf : public std::streambuf
 		m_socket = socket;
 		m_connected = socket != 0L;
 	}
+	/**
+		@brief retrieves an opened ClientConnection for a worker provided by a SocketReactor
+
+		The data already received by the reactor is read first.
+
+		@see SocketReactor
+	*/
+	void accept( const ClientConnection &connection, int bufferSize );
+	/**
+		@brief detaches the socket from this buffer without closing the connection
+		@return the socket number
+	*/
+	SOCKET detach( void )
+	{
+		m_connected = false;
+		flush();
+		return m_socket;
+	}
 
 	/**
 		@brief send data to the connection
@@ -239,6 +269,46 @@ class SocketStreambuf : public std::streambuf
 		@return 0 on success otherwise an error code
 	*/
 	virtual int sendData( const char *data, size_t numData );
+	/**
+		@brief sends a header followed by a part of a file to the connection
+
+		On Linux the file is sent with sendfile, thus the data is not copied
+		into the user space. Other platforms and derived classes that must
+		encode the data read the file in blocks and call sendData.
+
+		@param [in] header the data to send before the file e.g. an HTTP header
+		@param [in] headerSize the number of bytes of the header
+		@param [in] fileName the file to send
+		@param [in] offset the position of the first byte to send
+		@param [in] count the number of bytes to send
+		@return 0 on success otherwise an error code
+	*/
+	virtual int sendFile(
+		const char *header, size_t headerSize,
+		const STRING &fileName, uint64 offset, uint64 count
+	);
+
+	protected:
+	/// sends the file with sendData, @copydetails sendFile
+	int copyFile(
+		const char *header, size_t headerSize,
+		const STRING &fileName, uint64 offset, uint64 count
+	);
+
+	public:
+	/**
+		@brief sets the max. time to wait for data
+		@param [in] timeout the time in seconds
+	*/
+	void setTimeout( long timeout )
+	{
+		m_timeout = timeout;
+	}
+	/// returns the max. time in seconds to wait for data
+	long getTimeout( void ) const
+	{
+		return m_timeout;
+	}
 
 	/// returns the next byte from the connection
 	int getNextByte( void )
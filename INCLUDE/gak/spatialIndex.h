@@ -0,0 +1,1130 @@
+/*
+		Project:		GAKLIB
+		Module:			spatialIndex.h
+		Description:	a packed R-tree of points or boxes
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_SPATIAL_INDEX_H
+#define GAK_SPATIAL_INDEX_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cmath>
+#include <limits>
+
+#include <gak/array.h>
+#include <gak/geometry.h>
+#include <gak/gps.h>
+#include <gak/math.h>
+#include <gak/optional.h>
+#include <gak/priorityQueue.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the number of children of a node of a SpatialIndex
+const std::size_t SPATIAL_INDEX_NODE_SIZE = 16;
+/// the minimum number of unpacked entries before SpatialIndex::addElement packs the index
+const std::size_t SPATIAL_INDEX_MAX_UNPACKED = 256;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the bounding box of a node of a SpatialIndex
+struct SpatialBox
+{
+	float	minLongitude, minLatitude;
+	float	maxLongitude, maxLatitude;
+
+	SpatialBox()
+	: minLongitude( 0 ), minLatitude( 0 ), maxLongitude( 0 ), maxLatitude( 0 )
+	{
+	}
+	SpatialBox( float minLongitude, float minLatitude, float maxLongitude, float maxLatitude )
+	: minLongitude( minLongitude ), minLatitude( minLatitude ),
+	  maxLongitude( maxLongitude ), maxLatitude( maxLatitude )
+	{
+	}
+
+	bool contains( float longitude, float latitude ) const
+	{
+		return minLongitude <= longitude && longitude <= maxLongitude
+			&& minLatitude <= latitude && latitude <= maxLatitude;
+	}
+	bool contains( const SpatialBox &other ) const
+	{
+		return minLongitude <= other.minLongitude && other.maxLongitude <= maxLongitude
+			&& minLatitude <= other.minLatitude && other.maxLatitude <= maxLatitude;
+	}
+	bool intersects( const SpatialBox &other ) const
+	{
+		return minLongitude <= other.maxLongitude && other.minLongitude <= maxLongitude
+			&& minLatitude <= other.maxLatitude && other.minLatitude <= maxLatitude;
+	}
+	void expand( float longitude, float latitude )
+	{
+		if( minLongitude > longitude )
+		{
+			minLongitude = longitude;
+		}
+		if( maxLongitude < longitude )
+		{
+			maxLongitude = longitude;
+		}
+		if( minLatitude > latitude )
+		{
+			minLatitude = latitude;
+		}
+		if( maxLatitude < latitude )
+		{
+			maxLatitude = latitude;
+		}
+	}
+	void expand( const SpatialBox &other )
+	{
+		expand( other.minLongitude, other.minLatitude );
+		expand( other.maxLongitude, other.maxLatitude );
+	}
+};
+
+template <>
+struct is_binary<SpatialBox> : public internal::integral_constant<true>
+{
+};
+
+template <>
+inline void toBinaryStream( std::ostream &stream, const SpatialBox &value )
+{
+	binaryToBinaryStream( stream, value );
+}
+
+template <>
+inline void fromBinaryStream( std::istream &stream, SpatialBox *value )
+{
+	binaryFromBinaryStream( stream, value );
+}
+
+/// a point stored in a SpatialIndex
+template <typename KeyT>
+struct SpatialEntry
+{
+	float	longitude, latitude;
+	KeyT	key;
+
+	/// a removed entry of the packed part has no position
+	bool isRemoved() const
+	{
+		return longitude != longitude;
+	}
+	void remove()
+	{
+		longitude = latitude = std::numeric_limits<float>::quiet_NaN();
+	}
+	SpatialBox getBox() const
+	{
+		return SpatialBox( longitude, latitude, longitude, latitude );
+	}
+	bool intersects( const SpatialBox &region ) const
+	{
+		return region.contains( longitude, latitude );
+	}
+	bool operator == ( const SpatialEntry<KeyT> &other ) const
+	{
+		return key == other.key && longitude == other.longitude && latitude == other.latitude;
+	}
+
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		gak::toBinaryStream( stream, longitude );
+		gak::toBinaryStream( stream, latitude );
+		gak::toBinaryStream( stream, key );
+	}
+	void fromBinaryStream( std::istream &stream )
+	{
+		gak::fromBinaryStream( stream, &longitude );
+		gak::fromBinaryStream( stream, &latitude );
+		gak::fromBinaryStream( stream, &key );
+	}
+};
+
+/// entries with alignment bytes are written element by element
+template <typename KeyT>
+struct is_binary< SpatialEntry<KeyT> > : public internal::integral_constant<
+	is_binary<KeyT>::value && sizeof(SpatialEntry<KeyT>) == 2*sizeof(float) + sizeof(KeyT)
+>
+{
+};
+
+/// a bounding box stored in a SpatialIndex, e.g. of an area
+template <typename KeyT>
+struct SpatialBoxEntry
+{
+	SpatialBox	box;
+	KeyT		key;
+
+	/// a removed entry of the packed part has no position
+	bool isRemoved() const
+	{
+		return box.minLongitude != box.minLongitude;
+	}
+	void remove()
+	{
+		box.minLongitude = box.minLatitude = box.maxLongitude = box.maxLatitude =
+			std::numeric_limits<float>::quiet_NaN();
+	}
+	const SpatialBox &getBox() const
+	{
+		return box;
+	}
+	bool intersects( const SpatialBox &region ) const
+	{
+		return region.intersects( box );
+	}
+	bool operator == ( const SpatialBoxEntry<KeyT> &other ) const
+	{
+		return key == other.key
+			&& box.minLongitude == other.box.minLongitude && box.minLatitude == other.box.minLatitude
+			&& box.maxLongitude == other.box.maxLongitude && box.maxLatitude == other.box.maxLatitude;
+	}
+
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		gak::toBinaryStream( stream, box );
+		gak::toBinaryStream( stream, key );
+	}
+	void fromBinaryStream( std::istream &stream )
+	{
+		gak::fromBinaryStream( stream, &box );
+		gak::fromBinaryStream( stream, &key );
+	}
+};
+
+/// entries with alignment bytes are written element by element
+template <typename KeyT>
+struct is_binary< SpatialBoxEntry<KeyT> > : public internal::integral_constant<
+	is_binary<KeyT>::value && sizeof(SpatialBoxEntry<KeyT>) == sizeof(SpatialBox) + sizeof(KeyT)
+>
+{
+};
+
+/**
+	@brief a packed R-tree in memory owned by somebody else, e.g. a mapped file
+
+	The entries and the boxes have the flat layout created by
+	SpatialIndex::pack. The start of each level is computed from the number
+	of entries, thus a tree copied into a file with SpatialIndex::getPackedTree
+	is queried in place without reading or converting anything.
+
+	@tparam EntryT the type of the entries, SpatialEntry for points or SpatialBoxEntry for boxes
+	@see SpatialIndex
+*/
+template <typename EntryT>
+class SpatialTree
+{
+	public:
+	typedef EntryT	Entry;
+
+	private:
+	// each level has 1/16 of the nodes, level 0 are the entries and the last one is the end
+	static const std::size_t	MAX_LEVELS = 2*sizeof(std::size_t) + 2;
+
+	const Entry			*m_entries;
+	const SpatialBox	*m_boxes;
+	std::size_t			m_numEntries, m_rootLevel;
+	// the start of each level in m_boxes, level 0 are the entries
+	std::size_t			m_levelStarts[MAX_LEVELS];
+
+	std::size_t getLevelSize( std::size_t level ) const
+	{
+		return level ? m_levelStarts[level+1] - m_levelStarts[level] : m_numEntries;
+	}
+	template <typename ResultT>
+	void searchNode(
+		std::size_t level, std::size_t index, const SpatialBox &region, ResultT *result
+	) const;
+
+	public:
+	/// creates an empty tree
+	SpatialTree() : m_entries( nullptr ), m_boxes( nullptr ), m_numEntries( 0 ), m_rootLevel( 1 )
+	{
+		m_levelStarts[0] = m_levelStarts[1] = m_levelStarts[2] = 0;
+	}
+	/**
+		@param [in] entries the entries sorted by SpatialIndex::pack
+		@param [in] numEntries the number of entries
+		@param [in] boxes the boxes of all levels, getNumBoxes( numEntries ) boxes
+	*/
+	SpatialTree( const Entry *entries, std::size_t numEntries, const SpatialBox *boxes )
+	: m_entries( entries ), m_boxes( boxes ), m_numEntries( numEntries )
+	{
+		std::size_t	levelSize = numEntries;
+		std::size_t	level = 1;
+
+		m_levelStarts[0] = m_levelStarts[1] = 0;
+		do
+		{
+			levelSize = (levelSize + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+			m_levelStarts[level+1] = m_levelStarts[level] + levelSize;
+			++level;
+		} while( levelSize > 1 );
+		m_rootLevel = level-1;
+	}
+
+	/// returns the number of boxes of a tree with numEntries entries
+	static std::size_t getNumBoxes( std::size_t numEntries )
+	{
+		std::size_t	levelSize = numEntries;
+		std::size_t	numBoxes = 0;
+
+		do
+		{
+			levelSize = (levelSize + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+			numBoxes += levelSize;
+		} while( levelSize > 1 );
+
+		return numBoxes;
+	}
+
+	/// returns the number of entries
+	std::size_t size() const
+	{
+		return m_numEntries;
+	}
+	/// returns the number of boxes of all levels
+	std::size_t getNumBoxes() const
+	{
+		return m_levelStarts[m_rootLevel+1];
+	}
+	/// returns the entries in the order of the tree
+	const Entry *getEntries() const
+	{
+		return m_entries;
+	}
+	/// returns the boxes of all levels, the leaf level first and the root last
+	const SpatialBox *getBoxes() const
+	{
+		return m_boxes;
+	}
+
+	/**
+		@brief finds all points within a region or all boxes intersecting the region
+		@param [in] region the region to search
+		@param [out] result the keys found are added with addElement, e.g. to an Array or a Set
+	*/
+	template <typename ResultT>
+	void getRegion( const SpatialBox &region, ResultT *result ) const
+	{
+		if( m_numEntries && region.intersects( m_boxes[m_levelStarts[m_rootLevel]] ) )
+		{
+			searchNode( m_rootLevel, 0, region, result );
+		}
+	}
+};
+
+/**
+	@brief a packed R-tree of points or boxes
+
+	The entries are sorted along a Hilbert curve by the centers of their
+	boxes by @ref pack. Each group of
+	SPATIAL_INDEX_NODE_SIZE neighbouring entries gets a bounding box, each
+	group of SPATIAL_INDEX_NODE_SIZE boxes gets a box of the next level and so
+	on until one box, the root, covers the whole index. The boxes of all
+	levels are stored in one flat array, the leaf level first and the root
+	last. The children of a node are found by its position, thus the tree
+	needs no pointers and is written to a stream with two block writes.
+	@ref getPackedTree returns this layout as a SpatialTree.
+
+	A region query visits the nodes whose boxes intersect the region, i.e.
+	O(log n + k) nodes for k results. A box entry is found if it intersects
+	the region, thus an area covering the whole region is found, too. A
+	nearest neighbour query visits the nodes in the order of their distance
+	to the point.
+
+	New entries are appended behind the packed entries and are checked one by
+	one by the queries. Removed entries of the packed part keep their place
+	but lose their position. @ref addElement and @ref removeElement pack the
+	index again when there are too many of them. Call @ref pack after a bulk
+	load to get the best query performance.
+
+	@tparam KeyT the type of the keys, e.g. the node IDs of a GeoGraph
+	@tparam EntryT the type of the entries, SpatialEntry for points or SpatialBoxEntry for boxes
+*/
+template <typename KeyT, typename EntryT=SpatialEntry<KeyT> >
+class SpatialIndex
+{
+	public:
+	typedef KeyT				key_type;
+	typedef EntryT				Entry;
+
+	/// iterates all entries that are not removed
+	class const_iterator
+	{
+		const Entry	*m_cur, *m_end;
+
+		void skipRemoved()
+		{
+			while( m_cur < m_end && m_cur->isRemoved() )
+			{
+				++m_cur;
+			}
+		}
+
+		public:
+		const_iterator( const Entry *cur, const Entry *end ) : m_cur( cur ), m_end( end )
+		{
+			skipRemoved();
+		}
+		const Entry &operator * () const
+		{
+			return *m_cur;
+		}
+		const Entry *operator -> () const
+		{
+			return m_cur;
+		}
+		const_iterator &operator ++ ()
+		{
+			++m_cur;
+			skipRemoved();
+			return *this;
+		}
+		bool operator == ( const const_iterator &other ) const
+		{
+			return m_cur == other.m_cur;
+		}
+		bool operator != ( const const_iterator &other ) const
+		{
+			return m_cur != other.m_cur;
+		}
+	};
+
+	private:
+	/*
+		an entry (level 0) or a node of the tree waiting in the nearest neighbour search,
+		the queue returns the highest priority first, thus the priority is the negative
+		distance
+	*/
+	struct SearchItem
+	{
+		std::size_t	m_level;
+		std::size_t	m_index;
+	};
+	typedef HeapQueue<SearchItem, double, PriorityExtractor<SearchItem, double> >	SearchQueue;
+
+	struct HilbertKey
+	{
+		uint32		m_hilbert;
+		std::size_t	m_index;
+	};
+	struct HilbertComparator
+	{
+		int operator () ( const HilbertKey &key1, const HilbertKey &key2 ) const
+		{
+			return gak::compare( key1.m_hilbert, key2.m_hilbert );
+		}
+	};
+
+	PODarray<Entry>			m_entries;
+	PODarray<SpatialBox>	m_boxes;
+	std::size_t				m_numPacked, m_numRemoved;
+	// the start of each level in m_boxes, level 0 are the entries
+	PODarray<std::size_t>	m_levelStarts;
+
+	static uint32 getHilbertIndex( uint32 x, uint32 y );
+	static double getDistance(
+		const SpatialBox &box, float longitude, float latitude, double lonFactor
+	);
+
+	void setupLevels();
+	std::size_t getLevelSize( std::size_t level ) const
+	{
+		return level ? m_levelStarts[level+1] - m_levelStarts[level] : m_numPacked;
+	}
+	std::size_t findEntry( const Entry &entry ) const;
+	std::size_t findEntry( std::size_t level, std::size_t index, const Entry &entry ) const;
+	void pushChildren(
+		std::size_t level, std::size_t index, float longitude, float latitude,
+		double lonFactor, double maxDistance, SearchQueue *queue
+	) const;
+
+	public:
+	SpatialIndex() : m_numPacked( 0 ), m_numRemoved( 0 )
+	{
+	}
+
+	/// returns the number of entries
+	std::size_t size() const
+	{
+		return m_entries.size() - m_numRemoved;
+	}
+	/// returns the number of entries not yet packed into the tree
+	std::size_t getNumUnpacked() const
+	{
+		return m_entries.size() - m_numPacked;
+	}
+	const_iterator cbegin() const
+	{
+		return const_iterator( m_entries.getDataBuffer(), m_entries.getDataBuffer() + m_entries.size() );
+	}
+	const_iterator cend() const
+	{
+		const Entry	*end = m_entries.getDataBuffer() + m_entries.size();
+		return const_iterator( end, end );
+	}
+
+	/// adds an entry, the same key may be used for several entries
+	void addElement( const Entry &entry )
+	{
+		m_entries.addElement( entry );
+
+		std::size_t	numUnpacked = getNumUnpacked();
+		if( numUnpacked > SPATIAL_INDEX_MAX_UNPACKED && numUnpacked > m_numPacked/8 )
+		{
+			pack();
+		}
+	}
+	/// adds a point to an index of SpatialEntry
+	void addElement( float longitude, float latitude, const KeyT &key )
+	{
+		Entry	entry;
+		entry.longitude = longitude;
+		entry.latitude = latitude;
+		entry.key = key;
+		addElement( entry );
+	}
+	/// adds a box to an index of SpatialBoxEntry
+	void addElement( const SpatialBox &box, const KeyT &key )
+	{
+		Entry	entry;
+		entry.box = box;
+		entry.key = key;
+		addElement( entry );
+	}
+	/**
+		@brief removes an entry
+		@return false if the entry was not found
+	*/
+	bool removeElement( const Entry &entry );
+	/// removes a point of an index of SpatialEntry
+	bool removeElement( float longitude, float latitude, const KeyT &key )
+	{
+		Entry	entry;
+		entry.longitude = longitude;
+		entry.latitude = latitude;
+		entry.key = key;
+		return removeElement( entry );
+	}
+	/// removes a box of an index of SpatialBoxEntry
+	bool removeElement( const SpatialBox &box, const KeyT &key )
+	{
+		Entry	entry;
+		entry.box = box;
+		entry.key = key;
+		return removeElement( entry );
+	}
+	/// adds all entries of another index
+	void merge( const SpatialIndex<KeyT, EntryT> &src );
+	/// builds the tree of all entries
+	void pack();
+	/// returns the tree of the packed entries, call pack before to get all entries
+	SpatialTree<EntryT> getPackedTree() const
+	{
+		return SpatialTree<EntryT>( m_entries.getDataBuffer(), m_numPacked, m_boxes.getDataBuffer() );
+	}
+	void clear()
+	{
+		m_entries.clear();
+		m_boxes.clear();
+		m_levelStarts.clear();
+		m_numPacked = m_numRemoved = 0;
+	}
+
+	/**
+		@brief finds all points within a region or all boxes intersecting the region
+		@param [in] region the region to search
+		@param [out] result the keys found are appended in no particular order
+	*/
+	void getRegion( const SpatialBox &region, Array<KeyT> *result ) const;
+	/**
+		@brief finds the entries nearest to a position
+
+		The distance of a box is the distance of its nearest point. The distance is measured in degrees of latitude, i.e. the difference
+		of the longitudes is scaled with the cosine of the latitude.
+
+		@param [in] longitude,latitude the position
+		@param [in] maxDistance the maximum distance in degrees of latitude
+		@param [in] count the maximum number of points
+		@param [out] result the keys found are appended, the nearest first
+	*/
+	void findNearest(
+		float longitude, float latitude, double maxDistance, std::size_t count,
+		Array<KeyT> *result
+	) const;
+	/// returns the key of the entry nearest to a position or nothing if there is no entry within maxDistance
+	Optional<KeyT> findNearest( float longitude, float latitude, double maxDistance ) const
+	{
+		Optional<KeyT>	result;
+		Array<KeyT>		nearest;
+
+		findNearest( longitude, latitude, maxDistance, 1, &nearest );
+		if( nearest.size() )
+		{
+			result = nearest[0];
+		}
+		return result;
+	}
+
+	void toBinaryStream( std::ostream &stream ) const
+	{
+		gak::toBinaryStream( stream, uint64( m_numPacked ) );
+		gak::toBinaryStream( stream, uint64( m_numRemoved ) );
+		m_entries.toBinaryStream( stream );
+		m_boxes.toBinaryStream( stream );
+	}
+	void fromBinaryStream( std::istream &stream )
+	{
+		uint64	numPacked, numRemoved;
+
+		gak::fromBinaryStream( stream, &numPacked );
+		gak::fromBinaryStream( stream, &numRemoved );
+		m_entries.fromBinaryStream( stream );
+		m_boxes.fromBinaryStream( stream );
+
+		m_numPacked = std::size_t( numPacked );
+		m_numRemoved = std::size_t( numRemoved );
+		if( m_numPacked > m_entries.size() || m_numRemoved > m_entries.size() )
+		{
+			throw ReadError();
+		}
+		setupLevels();
+		if( m_levelStarts[m_levelStarts.size()-1] != m_boxes.size() )
+		{
+			throw ReadError();
+		}
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// converts a rectangle of a GeoGraph to the box of a SpatialIndex
+template <typename ScalarT>
+inline SpatialBox toSpatialBox( const math::Rectangle< math::GeoPosition<ScalarT> > &region )
+{
+	return SpatialBox(
+		float( region.topLeft.longitude ), float( region.bottomRight.latitude ),
+		float( region.bottomRight.longitude ), float( region.topLeft.latitude )
+	);
+}
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	converts a position of a 2^16 x 2^16 grid to its distance along the Hilbert curve
+*/
+template <typename KeyT, typename EntryT>
+uint32 SpatialIndex<KeyT, EntryT>::getHilbertIndex( uint32 x, uint32 y )
+{
+	const uint32	n = uint32(1) << 16;
+	uint32			index = 0;
+
+	for( uint32 s = n/2; s; s /= 2 )
+	{
+		uint32	rx = (x & s) ? 1 : 0;
+		uint32	ry = (y & s) ? 1 : 0;
+
+		index += s * s * ((3 * rx) ^ ry);
+
+		// rotate the quadrant
+		if( !ry )
+		{
+			if( rx )
+			{
+				x = n-1 - x;
+				y = n-1 - y;
+			}
+			uint32	tmp = x;
+			x = y;
+			y = tmp;
+		}
+	}
+
+	return index;
+}
+
+template <typename KeyT, typename EntryT>
+double SpatialIndex<KeyT, EntryT>::getDistance(
+	const SpatialBox &box, float longitude, float latitude, double lonFactor
+)
+{
+	double	dx = 0, dy = 0;
+
+	if( longitude < box.minLongitude )
+	{
+		dx = (double(box.minLongitude) - longitude) * lonFactor;
+	}
+	else if( longitude > box.maxLongitude )
+	{
+		dx = (double(longitude) - box.maxLongitude) * lonFactor;
+	}
+	if( latitude < box.minLatitude )
+	{
+		dy = double(box.minLatitude) - latitude;
+	}
+	else if( latitude > box.maxLatitude )
+	{
+		dy = double(latitude) - box.maxLatitude;
+	}
+
+	return std::sqrt( dx*dx + dy*dy );
+}
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <typename EntryT>
+	template <typename ResultT>
+void SpatialTree<EntryT>::searchNode(
+	std::size_t level, std::size_t index, const SpatialBox &region, ResultT *result
+) const
+{
+	const std::size_t	first = index * SPATIAL_INDEX_NODE_SIZE;
+	const std::size_t	last = math::min( first + SPATIAL_INDEX_NODE_SIZE, getLevelSize( level-1 ) );
+
+	if( level == 1 )
+	{
+		for( std::size_t i=first; i<last; ++i )
+		{
+			const Entry	&entry = m_entries[i];
+			if( entry.intersects( region ) )
+			{
+				result->addElement( entry.key );
+			}
+		}
+	}
+	else
+	{
+		const std::size_t	childStart = m_levelStarts[level-1];
+		for( std::size_t i=first; i<last; ++i )
+		{
+			if( region.intersects( m_boxes[childStart + i] ) )
+			{
+				searchNode( level-1, i, region, result );
+			}
+		}
+	}
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::setupLevels()
+{
+	m_levelStarts.clear();
+	m_levelStarts.addElement( 0 );		// level 0 are the entries
+	m_levelStarts.addElement( 0 );		// the leaf boxes start at 0
+
+	std::size_t	levelSize = m_numPacked;
+	do
+	{
+		levelSize = (levelSize + SPATIAL_INDEX_NODE_SIZE - 1) / SPATIAL_INDEX_NODE_SIZE;
+		m_levelStarts.addElement( m_levelStarts[m_levelStarts.size()-1] + levelSize );
+	} while( levelSize > 1 );
+}
+
+template <typename KeyT, typename EntryT>
+std::size_t SpatialIndex<KeyT, EntryT>::findEntry( const Entry &entry ) const
+{
+	// the newest entries are removed more often
+	for( std::size_t i=m_entries.size(); i>m_numPacked; )
+	{
+		if( m_entries[--i] == entry )
+		{
+/*@*/		return i;
+		}
+	}
+
+	if( m_numPacked )
+	{
+		const std::size_t	rootLevel = m_levelStarts.size()-2;
+		if( m_boxes[m_levelStarts[rootLevel]].contains( entry.getBox() ) )
+		{
+/*@*/		return findEntry( rootLevel, 0, entry );
+		}
+	}
+
+	return Container::no_index;
+}
+
+template <typename KeyT, typename EntryT>
+std::size_t SpatialIndex<KeyT, EntryT>::findEntry(
+	std::size_t level, std::size_t index, const Entry &entry
+) const
+{
+	const std::size_t	first = index * SPATIAL_INDEX_NODE_SIZE;
+	const std::size_t	last = math::min( first + SPATIAL_INDEX_NODE_SIZE, getLevelSize( level-1 ) );
+
+	for( std::size_t i=first; i<last; ++i )
+	{
+		if( level == 1 )
+		{
+			if( m_entries[i] == entry )
+			{
+/*@*/			return i;
+			}
+		}
+		else if( m_boxes[m_levelStarts[level-1] + i].contains( entry.getBox() ) )
+		{
+			std::size_t	pos = findEntry( level-1, i, entry );
+			if( pos != Container::no_index )
+			{
+/*@*/			return pos;
+			}
+		}
+	}
+
+	return Container::no_index;
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::pushChildren(
+	std::size_t level, std::size_t index, float longitude, float latitude,
+	double lonFactor, double maxDistance, SearchQueue *queue
+) const
+{
+	const std::size_t	first = index * SPATIAL_INDEX_NODE_SIZE;
+	const std::size_t	last = math::min( first + SPATIAL_INDEX_NODE_SIZE, getLevelSize( level-1 ) );
+
+	for( std::size_t i=first; i<last; ++i )
+	{
+		SearchItem	child = { level-1, i };
+		double		distance;
+
+		if( level == 1 )
+		{
+			const Entry	&entry = m_entries[i];
+			if( entry.isRemoved() )
+			{
+/*^*/			continue;
+			}
+			distance = getDistance( entry.getBox(), longitude, latitude, lonFactor );
+		}
+		else
+		{
+			distance = getDistance( m_boxes[m_levelStarts[level-1] + i], longitude, latitude, lonFactor );
+		}
+		if( distance <= maxDistance )
+		{
+			queue->push( child, -distance );
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename KeyT, typename EntryT>
+bool SpatialIndex<KeyT, EntryT>::removeElement( const Entry &entry )
+{
+	std::size_t	pos = findEntry( entry );
+
+	if( pos == Container::no_index )
+	{
+/*@*/	return false;
+	}
+
+	if( pos >= m_numPacked )
+	{
+		m_entries[pos] = m_entries[m_entries.size()-1];
+		m_entries.removeElementAt( m_entries.size()-1 );
+	}
+	else
+	{
+		// the boxes of the tree are still valid
+		m_entries[pos].remove();
+		if( ++m_numRemoved > SPATIAL_INDEX_MAX_UNPACKED && m_numRemoved > m_numPacked/8 )
+		{
+			pack();
+		}
+	}
+
+	return true;
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::merge( const SpatialIndex<KeyT, EntryT> &src )
+{
+	for( const_iterator it = src.cbegin(), endIT = src.cend(); it != endIT; ++it )
+	{
+		m_entries.addElement( *it );
+	}
+	pack();
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::pack()
+{
+	doEnterFunctionEx( gakLogging::llDetail, "SpatialIndex::pack" );
+
+	// remove the removed entries and find the bounding box of all entries
+	PODarray<Entry>	entries;
+	SpatialBox		bounds;
+	for( const_iterator it = cbegin(), endIT = cend(); it != endIT; ++it )
+	{
+		if( !entries.size() )
+		{
+			bounds = it->getBox();
+		}
+		else
+		{
+			bounds.expand( it->getBox() );
+		}
+		entries.addElement( *it );
+	}
+
+	m_numPacked = entries.size();
+	m_numRemoved = 0;
+	m_boxes.clear();
+	setupLevels();
+
+	if( !m_numPacked )
+	{
+		m_entries.clear();
+/*@*/	return;
+	}
+
+	// sort the entries along the Hilbert curve, thus neighbours get the same leaf
+	const double	width = double(bounds.maxLongitude) - bounds.minLongitude;
+	const double	height = double(bounds.maxLatitude) - bounds.minLatitude;
+	const double	gridSize = 65535.0;
+
+	PODarray<HilbertKey>	hilbertKeys;
+	hilbertKeys.setSize( m_numPacked );
+	for( std::size_t i=0; i<m_numPacked; ++i )
+	{
+		const SpatialBox	&box = entries[i].getBox();
+		const double		longitude = (double(box.minLongitude) + box.maxLongitude) / 2;
+		const double		latitude = (double(box.minLatitude) + box.maxLatitude) / 2;
+		uint32	x = width > 0 ? uint32( (longitude - bounds.minLongitude) / width * gridSize ) : 0;
+		uint32	y = height > 0 ? uint32( (latitude - bounds.minLatitude) / height * gridSize ) : 0;
+
+		hilbertKeys[i].m_hilbert = getHilbertIndex( x, y );
+		hilbertKeys[i].m_index = i;
+	}
+	hilbertKeys.sort( HilbertComparator() );
+
+	m_entries.setSize( m_numPacked );
+	for( std::size_t i=0; i<m_numPacked; ++i )
+	{
+		m_entries[i] = entries[hilbertKeys[i].m_index];
+	}
+
+	// create the boxes level by level
+	m_boxes.setSize( m_levelStarts[m_levelStarts.size()-1] );
+	for( std::size_t i=0; i<m_numPacked; ++i )
+	{
+		SpatialBox	&box = m_boxes[i / SPATIAL_INDEX_NODE_SIZE];
+		if( !(i % SPATIAL_INDEX_NODE_SIZE) )
+		{
+			box = m_entries[i].getBox();
+		}
+		else
+		{
+			box.expand( m_entries[i].getBox() );
+		}
+	}
+	for( std::size_t level=2; level<m_levelStarts.size()-1; ++level )
+	{
+		const std::size_t	childStart = m_levelStarts[level-1];
+		const std::size_t	numChildren = getLevelSize( level-1 );
+		for( std::size_t i=0; i<numChildren; ++i )
+		{
+			const SpatialBox	&child = m_boxes[childStart + i];
+			SpatialBox			&box = m_boxes[m_levelStarts[level] + i / SPATIAL_INDEX_NODE_SIZE];
+			if( !(i % SPATIAL_INDEX_NODE_SIZE) )
+			{
+				box = child;
+			}
+			else
+			{
+				box.expand( child );
+			}
+		}
+	}
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::getRegion( const SpatialBox &region, Array<KeyT> *result ) const
+{
+	doEnterFunctionEx( gakLogging::llDetail, "SpatialIndex::getRegion" );
+
+	getPackedTree().getRegion( region, result );
+
+	for( std::size_t i=m_numPacked; i<m_entries.size(); ++i )
+	{
+		const Entry	&entry = m_entries[i];
+		if( entry.intersects( region ) )
+		{
+			result->addElement( entry.key );
+		}
+	}
+}
+
+template <typename KeyT, typename EntryT>
+void SpatialIndex<KeyT, EntryT>::findNearest(
+	float longitude, float latitude, double maxDistance, std::size_t count,
+	Array<KeyT> *result
+) const
+{
+	doEnterFunctionEx( gakLogging::llDetail, "SpatialIndex::findNearest" );
+
+	const double	lonFactor = std::cos( math::degree2radians( double(latitude) ) );
+	SearchQueue		queue;
+
+	if( m_numPacked )
+	{
+		const std::size_t	rootLevel = m_levelStarts.size()-2;
+		const double		distance = getDistance(
+			m_boxes[m_levelStarts[rootLevel]], longitude, latitude, lonFactor
+		);
+		if( distance <= maxDistance )
+		{
+			SearchItem	root = { rootLevel, 0 };
+			queue.push( root, -distance );
+		}
+	}
+	// the unpacked entries are not in the tree, level 0 is an entry
+	for( std::size_t i=m_numPacked; i<m_entries.size(); ++i )
+	{
+		double	distance = getDistance( m_entries[i].getBox(), longitude, latitude, lonFactor );
+		if( distance <= maxDistance )
+		{
+			SearchItem	entry = { 0, i };
+			queue.push( entry, -distance );
+		}
+	}
+
+	std::size_t	found = 0;
+	while( found < count && queue.size() )
+	{
+		SearchItem	item = queue.pop();
+		if( !item.m_level )
+		{
+			result->addElement( m_entries[item.m_index].key );
+			++found;
+		}
+		else
+		{
+			pushChildren( item.m_level, item.m_index, longitude, latitude, lonFactor, maxDistance, &queue );
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_SPATIAL_INDEX_H
@@ -122,6 +122,16 @@ class SSLsocketStreambuf : public SocketStreambuf
 	}
 	virtual int connect( const char *server, int port, int buffersize=10240 );
 	virtual int sendData( const char *data, size_t numData);
+	/// the encrypted data cannot be sent with sendfile
+	virtual int sendFile(
+		const char *header, size_t headerSize,
+		const STRING &fileName, uint64 offset, uint64 count
+	)
+	{
+		return m_ssl
+			? copyFile( header, headerSize, fileName, offset, count )
+			: SocketStreambuf::sendFile( header, headerSize, fileName, offset, count );
+	}
 	virtual void disconnect( void );
 	virtual STRING	getSocketError( void ) const;
 };
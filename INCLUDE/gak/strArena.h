@@ -0,0 +1,216 @@
+/*
+		Project:		GAKLIB
+		Module:			strArena.h
+		Description:	arena for the buffers of STRING objects
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_STR_ARENA_H
+#define GAK_STR_ARENA_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstddef>
+
+#include <gak/string.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+struct StrArenaData;
+
+/**
+	@brief an arena for the buffers of STRING objects
+
+	While a StrArenaScope for an arena is active, all new buffers of STRING
+	objects created by the current thread are taken from large chunks of the
+	arena. Allocating a buffer just moves a pointer, releasing a buffer
+	just decrements a counter. The chunks are released in bulk, when the
+	arena is destroyed and no STRING uses any of its buffers.
+
+	STRING objects may outlive the arena and may be passed to other threads.
+	But only one thread at a time may create buffers with an arena.
+
+	@code
+		StrArena	arena;
+		{
+			StrArenaScope	scope( arena );
+			...	// parse a document
+		}
+	@endcode
+	@see StrArenaScope
+*/
+class StrArena
+{
+	StrArenaData	*m_data;
+
+	// no copy
+	StrArena( const StrArena & );
+	const StrArena & operator = ( const StrArena & );
+
+	public:
+	/// the size of a chunk, must be a power of two
+	static const std::size_t CHUNK_SIZE = 64*1024;
+	/// buffers larger than this are allocated from the heap
+	static const std::size_t MAX_BLOCK_SIZE = CHUNK_SIZE/4;
+
+	StrArena();
+	~StrArena();
+
+	/// @return the number of chunks allocated by this arena
+	std::size_t getChunkCount() const;
+	/// @return the number of buffers in use
+	std::size_t getBlockCount() const;
+	/// @return the number of bytes taken from the chunks
+	std::size_t getUsedBytes() const;
+
+	/// @return the internal data, used by the allocator
+	StrArenaData *getData() const
+	{
+		return m_data;
+	}
+};
+
+/**
+	@brief activates a StrArena for the current thread
+
+	The previous arena (if any) is reactivated, when the scope is left.
+*/
+class StrArenaScope
+{
+	StrArenaData	*m_previous;
+
+	// no copy
+	StrArenaScope( const StrArenaScope & );
+	const StrArenaScope & operator = ( const StrArenaScope & );
+
+	public:
+	/// activates an arena
+	StrArenaScope( StrArena &arena );
+	/// reactivates the previous arena
+	~StrArenaScope();
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_STR_ARENA_H
@@ -43,8 +43,13 @@
 #include <fstream>
 #include <memory>
 
+#include <gak/array.h>
+#include <gak/atomic.h>
 #include <gak/blockedQueue.h>
 #include <gak/thread.h>
+#include <gak/threadPool.h>
+#include <gak/semaphore.h>
+#include <gak/locker.h>
 #include <gak/shared.h>
 
 // --------------------------------------------------------------------- //
@@ -71,6 +76,11 @@ namespace streams
 // ----- constants ----------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// the max. number of items the stream threads pass to the next stage at once
+const std::size_t STREAM_CHUNK_SIZE = 256;
+/// the max. time in ms a stream thread waits for new items before it checks the end of the stream
+const unsigned long STREAM_POLL_TIME = 10;
+
 // --------------------------------------------------------------------- //
 // ----- macros -------------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -79,6 +89,15 @@ namespace streams
 // ----- type definitions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// the order of the items created by a parallel stage
+enum ParallelOrder
+{
+	/// the items are passed in the order of the source stream
+	poOrdered,
+	/// the items are passed as soon as they are ready
+	poUnordered
+};
+
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -115,21 +134,77 @@ template <typename OBJ>
 class Stream;
 template <typename OBJ>
 class StreamBuffer;
+template <typename SourceT, typename TargetT, typename StagesT>
+class FusedStream;
+struct IdentityStage;
 
+/**
+	@brief the buffer between two stages of a stream
+
+	The items are passed in chunks. A chunk that was pushed to a buffer must
+	not be changed anymore, thus a dispatcher can push the same chunk to all
+	its destinations without copying the items.
+
+	A buffer is not limited unless a capacity was set. Then pushChunk waits
+	while the number of items waiting exceeds the capacity.
+*/
 template <typename OBJ>
 class StreamBufferImpl : public SharedObject
 {
 	public:
-	typedef Stream<OBJ>			MyStream;
-	typedef StreamBuffer<OBJ>	MyStreamBuffer;
+	typedef Stream<OBJ>				MyStream;
+	typedef StreamBuffer<OBJ>		MyStreamBuffer;
+	typedef Array<OBJ>				Items;
+	typedef SharedPointer<Items>	Chunk;
 
 	private:
 	std::size_t							m_numItems;
-	BlockedQueue<OBJ>					m_ioQueue;
+	Atomic<std::size_t>					m_numWaiting;
+	Atomic<std::size_t>					m_capacity;
+	Semaphore							m_chunkPopped;
+	BlockedQueue<Chunk>					m_ioQueue;
+	Chunk								m_current;
+	std::size_t							m_currentPos;
 	SharedObjectPointer<StreamThread>	m_originatingThread;
 
+	bool popNextChunk()
+	{
+		while( !eof() )
+		{
+			try
+			{
+				m_current = m_ioQueue.pop( STREAM_POLL_TIME );
+				m_currentPos = 0;
+				return true;
+			}
+			catch( TimeoutException & )
+			{
+				doLogPosition();
+			}
+		}
+		return false;
+	}
+	void waitForCapacity()
+	{
+		for(
+			std::size_t capacity = m_capacity.load();
+			capacity && m_numWaiting.load() >= capacity;
+			capacity = m_capacity.load()
+		)
+		{
+			m_chunkPopped.wait( STREAM_POLL_TIME );
+		}
+	}
+	void notifyChunkPopped()
+	{
+		if( m_capacity.load() )
+		{
+			m_chunkPopped.notify();
+		}
+	}
+
 	public:
-	StreamBufferImpl() : m_numItems(0)
+	StreamBufferImpl() : m_numItems(0), m_numWaiting(0), m_capacity(0), m_currentPos(0)
 	{
 		doEnterFunction("StreamBufferImpl");
 		doLogValue( this );
@@ -139,29 +214,98 @@ class StreamBufferImpl : public SharedObject
 		doEnterFunction("~StreamBufferImpl");
 		doLogValue( this );
 	}
+	/// creates an empty chunk that can hold STREAM_CHUNK_SIZE items
+	static Chunk createChunk()
+	{
+		Chunk	chunk = Chunk::makeShared();
+		chunk->setChunkSize( STREAM_CHUNK_SIZE );
+		return chunk;
+	}
 	void setOriginatingThread( const SharedObjectPointer<StreamThread> &thread )
 	{
 		m_originatingThread = thread;
 	}
+	/**
+		@brief limits the number of items waiting in this buffer
+		@param [in] capacity the max. number of items, 0 for no limit, releases all threads waiting in pushChunk
+	*/
+	void setCapacity( std::size_t capacity )
+	{
+		m_capacity.store( capacity );
+		m_chunkPopped.notify();
+	}
+	std::size_t getCapacity() const
+	{
+		return m_capacity.load();
+	}
 	virtual void push( const OBJ &item )
 	{
-		m_ioQueue.push( item );
+		Chunk	chunk = Chunk::makeShared();
+		chunk->addElement( item );
+		pushChunk( chunk );
+	}
+	/**
+		@brief adds a number of items to this buffer, waits while the capacity is exceeded
+		@param [in] chunk the items, must not be changed after this call
+	*/
+	virtual void pushChunk( const Chunk &chunk )
+	{
+		if( chunk && chunk->size() )
+		{
+			waitForCapacity();
+			m_numWaiting.fetchAdd( chunk->size() );
+			m_ioQueue.push( chunk );
+		}
 	}
 	virtual OBJ pop()
 	{
-		while( !eof() )
+		if( (m_current && m_currentPos < m_current->size()) || popNextChunk() )
 		{
-			try
+			OBJ	item = (*m_current)[m_currentPos++];
+			++m_numItems;
+			m_numWaiting.fetchSub( 1 );
+			if( m_currentPos >= m_current->size() )
 			{
-				++m_numItems;
-				return m_ioQueue.pop( 1000 );
+				m_current = Chunk();
+				notifyChunkPopped();
 			}
-			catch( TimeoutException & )
+			return item;
+		}
+		throw TimeoutException();
+	}
+	/**
+		@brief fetches the remaining items of the next chunk
+		@param [out] chunk receives the items, must not be changed
+		@return false if there are no more items
+	*/
+	virtual bool popChunk( Chunk *chunk )
+	{
+		if( !m_current || m_currentPos >= m_current->size() )
+		{
+			if( !popNextChunk() )
 			{
-				--m_numItems;
+				return false;
 			}
 		}
-		throw TimeoutException();
+		if( m_currentPos )
+		{
+			*chunk = createChunk();
+			for( std::size_t i=m_currentPos; i<m_current->size(); ++i )
+			{
+				(*chunk)->addElement( (*m_current)[i] );
+			}
+		}
+		else
+		{
+			*chunk = m_current;
+		}
+		m_current = Chunk();
+
+		const std::size_t	numItems = (*chunk)->size();
+		m_numItems += numItems;
+		m_numWaiting.fetchSub( numItems );
+		notifyChunkPopped();
+		return true;
 	}
 
 	virtual bool eof()
@@ -175,7 +319,7 @@ class StreamBufferImpl : public SharedObject
 		}
 
 #ifndef NDEBUG
-		size_t	numElements = m_ioQueue.size();
+		size_t	numElements = m_numWaiting.load();
 		bool	result = !threadRunning && numElements == 0;
 
 		doLogValue( threadRunning );
@@ -184,7 +328,7 @@ class StreamBufferImpl : public SharedObject
 
 		return result;
 #else
-		return !threadRunning && m_ioQueue.size() == 0;
+		return !threadRunning && m_numWaiting.load() == 0;
 #endif
 	}
 	virtual void setName( const char *name )
@@ -218,7 +362,7 @@ class StreamBufferImpl : public SharedObject
 	}
 	size_t getNumItemsWaiting() const
 	{
-		return m_ioQueue.size();
+		return m_numWaiting.load();
 	}
 	size_t getNumItems() const
 	{
@@ -237,6 +381,67 @@ class  StreamBuffer : public SharedObjectPointer< StreamBufferImpl<OBJ> >
 	}
 };
 
+/**
+	@brief a buffer that collects the items pushed by a flat map function
+
+	the items are not passed to another thread, they are fetched by the stage
+	that called the flat map function
+*/
+template <typename OBJ>
+class ChunkCollectorImpl : public StreamBufferImpl<OBJ>
+{
+	typedef StreamBufferImpl<OBJ>	Super;
+
+	public:
+	typedef typename Super::Items	Items;
+	typedef typename Super::Chunk	Chunk;
+
+	private:
+	Chunk	m_chunk;
+
+	public:
+	virtual void push( const OBJ &item )
+	{
+		getItems().addElement( item );
+	}
+	virtual void pushChunk( const Chunk &chunk )
+	{
+		if( chunk )
+		{
+			Items	&items = getItems();
+			for(
+				typename Items::const_iterator it = chunk->cbegin(), endIT = chunk->cend();
+				it != endIT;
+				++it
+			)
+			{
+				items.addElement( *it );
+			}
+		}
+	}
+	/// returns the items collected so far
+	Items &getItems()
+	{
+		if( !m_chunk )
+		{
+			m_chunk = Super::createChunk();
+		}
+		return *m_chunk;
+	}
+	/// returns the number of items collected so far
+	std::size_t size() const
+	{
+		return m_chunk ? m_chunk->size() : 0;
+	}
+	/// returns the items collected so far and starts a new chunk
+	Chunk flush()
+	{
+		Chunk	result = m_chunk;
+		m_chunk = Chunk();
+		return result;
+	}
+};
+
 template <typename SourceT, typename TargetT>
 class DoubleBufferImpl : public StreamBufferImpl<TargetT>
 {
@@ -244,6 +449,10 @@ class DoubleBufferImpl : public StreamBufferImpl<TargetT>
 	typedef StreamBuffer<TargetT>	TargetBuffer;
 	typedef StreamBuffer<SourceT>	SourceBuffer;
 
+	typedef typename StreamBufferImpl<SourceT>::Items	SourceItems;
+	typedef typename StreamBufferImpl<SourceT>::Chunk	SourceChunk;
+	typedef typename StreamBufferImpl<TargetT>::Chunk	TargetChunk;
+
 	typedef Stream<TargetT>			TargetStream;
 	typedef Stream<SourceT>			SourceStream;
 
@@ -346,6 +555,10 @@ class DoubleBufferImpl : public StreamBufferImpl<TargetT>
 	}
 	virtual void stop()
 	{
+		// release the threads waiting for the capacity of our buffers
+		m_inputBuffer->setCapacity( 0 );
+		this->setCapacity( 0 );
+
 		m_source->stop();
 		m_conversionThread->StopThread();
 		m_conversionThread->join();
@@ -522,6 +735,7 @@ class FunctionSourceImpl : public SourceBaseImpl<OBJ>
 	private:
 	typedef SourceBaseImpl<OBJ>				Super;
 	typedef typename Super::SourceThread	SourceThread;
+	typedef typename Super::Chunk			Chunk;
 
 	class FunctionThread : public SourceThread
 	{
@@ -530,19 +744,31 @@ class FunctionSourceImpl : public SourceBaseImpl<OBJ>
 		virtual void fillBuffer()
 		{
 			doEnterFunction("FunctionThread::fillBuffer");
+
+			Chunk	chunk;
 			while( !m_sourceFunction.eof() && !this->terminated )
 			{
 				try
 				{
 					OBJ	item = m_sourceFunction.getNext();
 					doLogValue( item );
-					this->m_buffer->push( item );
+					if( !chunk )
+					{
+						chunk = StreamBufferImpl<OBJ>::createChunk();
+					}
+					chunk->addElement( item );
+					if( chunk->size() >= STREAM_CHUNK_SIZE )
+					{
+						this->m_buffer->pushChunk( chunk );
+						chunk = Chunk();
+					}
 				}
 				catch( ... )
 				{
 					// ignore
 				}
 			}
+			this->m_buffer->pushChunk( chunk );
 		}
 		public:
 		FunctionThread( const FunctionT &sourceFunction ) : m_sourceFunction( sourceFunction )
@@ -612,6 +838,9 @@ class MapSourceImpl : public DoubleBufferImpl<SourceT, TargetT>
 	typedef DoubleBufferImpl<SourceT, TargetT>	Super;
 	typedef typename Super::ConversionThread	ConversionThread;
 	typedef typename Super::SourceStream		SourceStream;
+	typedef typename Super::SourceItems			SourceItems;
+	typedef typename Super::SourceChunk			SourceChunk;
+	typedef typename Super::TargetChunk			TargetChunk;
 
 	class MapThread : public ConversionThread
 	{
@@ -622,19 +851,22 @@ class MapSourceImpl : public DoubleBufferImpl<SourceT, TargetT>
 			doEnterFunction("MapThread::doConversion");
 			assert( this->m_source );
 
+			SourceChunk	input;
 			while( !this->eof() && !this->terminated )
 			{
-				try
-				{
-					SourceT	item1 = this->m_inputBuffer->pop();
-					doLogValue( item1 );
-					TargetT	item2 = m_mapFunction( item1 );
-					doLogValue( item2 );
-					this->m_outputBuffer->push( item2 );
-				}
-				catch( TimeoutException & )
+				if( this->m_inputBuffer->popChunk( &input ) )
 				{
-					doLogPosition();
+					TargetChunk	output = Super::createChunk();
+					for(
+						typename SourceItems::const_iterator it = input->cbegin(), endIT = input->cend();
+						it != endIT;
+						++it
+					)
+					{
+						doLogValue( *it );
+						output->addElement( m_mapFunction( *it ) );
+					}
+					this->m_outputBuffer->pushChunk( output );
 				}
 			}
 		}
@@ -665,31 +897,46 @@ class FlatMapSourceImpl : public DoubleBufferImpl<SourceT, TargetT>
 	typedef DoubleBufferImpl<SourceT, TargetT>	Super;
 	typedef typename Super::ConversionThread	ConversionThread;
 	typedef typename Super::SourceStream		SourceStream;
+	typedef typename Super::SourceItems			SourceItems;
+	typedef typename Super::SourceChunk			SourceChunk;
+	typedef typename Super::TargetChunk			TargetChunk;
 
 	class FlatMapThread : public ConversionThread
 	{
-		FlatMapFunctionT	m_flatMapFunction;
+		FlatMapFunctionT				m_flatMapFunction;
+		ChunkCollectorImpl<TargetT>		*m_collector;
+		StreamBuffer<TargetT>			m_collectorBuffer;
 
 		virtual void doConversion()
 		{
 			assert( this->m_source );
 			doEnterFunction("FlatMapThread::doConversion");
+
+			SourceChunk	input;
 			while( !this->eof() && !this->terminated )
 			{
-				try
+				if( this->m_inputBuffer->popChunk( &input ) )
 				{
-					SourceT	item = this->m_inputBuffer->pop();
-					doLogValue( item );
-					m_flatMapFunction( item, this->m_outputBuffer );
-				}
-				catch( TimeoutException & )
-				{
-					doLogPosition();
+					for(
+						typename SourceItems::const_iterator it = input->cbegin(), endIT = input->cend();
+						it != endIT;
+						++it
+					)
+					{
+						doLogValue( *it );
+						m_flatMapFunction( *it, m_collectorBuffer );
+						if( m_collector->size() >= STREAM_CHUNK_SIZE )
+						{
+							this->m_outputBuffer->pushChunk( m_collector->flush() );
+						}
+					}
+					this->m_outputBuffer->pushChunk( m_collector->flush() );
 				}
 			}
 		}
 		public:
-		FlatMapThread( const FlatMapFunctionT &flatMapFunction ) : m_flatMapFunction( flatMapFunction )
+		FlatMapThread( const FlatMapFunctionT &flatMapFunction ) 
+		: m_flatMapFunction( flatMapFunction ), m_collector( new ChunkCollectorImpl<TargetT>() ), m_collectorBuffer( m_collector )
 		{
 		}
 	};
@@ -715,6 +962,9 @@ class FilterSourceImpl : public DoubleBufferImpl<OBJ, OBJ>
 	typedef DoubleBufferImpl<OBJ, OBJ>			Super;
 	typedef typename Super::ConversionThread	ConversionThread;
 	typedef typename Super::SourceStream		SourceStream;
+	typedef typename Super::SourceItems			SourceItems;
+	typedef typename Super::SourceChunk			SourceChunk;
+	typedef typename Super::TargetChunk			TargetChunk;
 
 	class FilterThread : public ConversionThread
 	{
@@ -723,21 +973,25 @@ class FilterSourceImpl : public DoubleBufferImpl<OBJ, OBJ>
 		virtual void doConversion()
 		{
 			doEnterFunction("FilterThread::doConversion");
+			SourceChunk	input;
 			while( !this->eof() && !this->terminated )
 			{
-				try
+				if( this->m_inputBuffer->popChunk( &input ) )
 				{
-					OBJ	item = this->m_inputBuffer->pop();
-					doLogValue( item );
-					if( m_filterFunction( item ) )
+					TargetChunk	output = Super::createChunk();
+					for(
+						typename SourceItems::const_iterator it = input->cbegin(), endIT = input->cend();
+						it != endIT;
+						++it
+					)
 					{
-						doLogValue( item );
-						this->m_outputBuffer->push( item );
+						doLogValue( *it );
+						if( m_filterFunction( *it ) )
+						{
+							output->addElement( *it );
+						}
 					}
-				}
-				catch( TimeoutException & )
-				{
-					doLogPosition();
+					this->m_outputBuffer->pushChunk( output );
 				}
 			}
 		}
@@ -761,6 +1015,462 @@ class FilterSourceImpl : public DoubleBufferImpl<OBJ, OBJ>
 	}
 };
 
+/**
+	@brief the first stage of a fused pipeline, passes the items unchanged
+	@see FusedStream
+*/
+struct IdentityStage
+{
+	template <typename OBJ, typename ConsumerT>
+	void operator () ( const OBJ &item, ConsumerT &consumer )
+	{
+		consumer( item );
+	}
+};
+
+/**
+	@brief a map stage of a fused pipeline
+	@tparam PrevStageT the stages before this stage
+	@tparam TargetT the type of the items created by this stage
+	@tparam MapFunctionT the function that converts the items
+	@see FusedStream::map
+*/
+template <typename PrevStageT, typename TargetT, typename MapFunctionT>
+class MapStage
+{
+	PrevStageT		m_prevStage;
+	MapFunctionT	m_mapFunction;
+
+	template <typename ConsumerT>
+	struct Consumer
+	{
+		MapFunctionT	&m_mapFunction;
+		ConsumerT		&m_next;
+
+		Consumer( MapFunctionT &mapFunction, ConsumerT &next ) : m_mapFunction( mapFunction ), m_next( next ) {}
+
+		template <typename OBJ>
+		void operator () ( const OBJ &item )
+		{
+			m_next( TargetT( m_mapFunction( item ) ) );
+		}
+	};
+
+	public:
+	MapStage( const PrevStageT &prevStage, const MapFunctionT &mapFunction )
+	: m_prevStage( prevStage ), m_mapFunction( mapFunction )
+	{
+	}
+
+	template <typename OBJ, typename ConsumerT>
+	void operator () ( const OBJ &item, ConsumerT &consumer )
+	{
+		Consumer<ConsumerT>	next( m_mapFunction, consumer );
+		m_prevStage( item, next );
+	}
+};
+
+/**
+	@brief a filter stage of a fused pipeline
+	@tparam PrevStageT the stages before this stage
+	@tparam FilterFunctionT the function that selects the items
+	@see FusedStream::filter
+*/
+template <typename PrevStageT, typename FilterFunctionT>
+class FilterStage
+{
+	PrevStageT		m_prevStage;
+	FilterFunctionT	m_filterFunction;
+
+	template <typename ConsumerT>
+	struct Consumer
+	{
+		FilterFunctionT	&m_filterFunction;
+		ConsumerT		&m_next;
+
+		Consumer( FilterFunctionT &filterFunction, ConsumerT &next ) : m_filterFunction( filterFunction ), m_next( next ) {}
+
+		template <typename OBJ>
+		void operator () ( const OBJ &item )
+		{
+			if( m_filterFunction( item ) )
+			{
+				m_next( item );
+			}
+		}
+	};
+
+	public:
+	FilterStage( const PrevStageT &prevStage, const FilterFunctionT &filterFunction )
+	: m_prevStage( prevStage ), m_filterFunction( filterFunction )
+	{
+	}
+
+	template <typename OBJ, typename ConsumerT>
+	void operator () ( const OBJ &item, ConsumerT &consumer )
+	{
+		Consumer<ConsumerT>	next( m_filterFunction, consumer );
+		m_prevStage( item, next );
+	}
+};
+
+/**
+	@brief a flat map stage of a fused pipeline
+
+	the flat map function pushes its items into a ChunkCollectorImpl, they
+	are passed to the next stage after the function returns.
+
+	@tparam PrevStageT the stages before this stage
+	@tparam TargetT the type of the items created by this stage
+	@tparam FlatMapFunctionT the function that creates the items
+	@see FusedStream::flatMap
+*/
+template <typename PrevStageT, typename TargetT, typename FlatMapFunctionT>
+class FlatMapStage
+{
+	typedef typename ChunkCollectorImpl<TargetT>::Items	Items;
+
+	PrevStageT					m_prevStage;
+	FlatMapFunctionT			m_flatMapFunction;
+	ChunkCollectorImpl<TargetT>	*m_collector;
+	StreamBuffer<TargetT>		m_collectorBuffer;
+
+	template <typename ConsumerT>
+	struct Consumer
+	{
+		FlatMapStage	&m_stage;
+		ConsumerT		&m_next;
+
+		Consumer( FlatMapStage &stage, ConsumerT &next ) : m_stage( stage ), m_next( next ) {}
+
+		template <typename OBJ>
+		void operator () ( const OBJ &item )
+		{
+			m_stage.m_flatMapFunction( item, m_stage.m_collectorBuffer );
+
+			Items	&items = m_stage.m_collector->getItems();
+			for(
+				typename Items::const_iterator it = items.cbegin(), endIT = items.cend();
+				it != endIT;
+				++it
+			)
+			{
+				m_next( *it );
+			}
+			items.clear();
+		}
+	};
+
+	public:
+	FlatMapStage( const PrevStageT &prevStage, const FlatMapFunctionT &flatMapFunction )
+	: m_prevStage( prevStage ), m_flatMapFunction( flatMapFunction ),
+	  m_collector( new ChunkCollectorImpl<TargetT>() ), m_collectorBuffer( m_collector )
+	{
+	}
+	/// each copy gets its own collector, since it may be used by another thread
+	FlatMapStage( const FlatMapStage &src )
+	: m_prevStage( src.m_prevStage ), m_flatMapFunction( src.m_flatMapFunction ),
+	  m_collector( new ChunkCollectorImpl<TargetT>() ), m_collectorBuffer( m_collector )
+	{
+	}
+
+	template <typename OBJ, typename ConsumerT>
+	void operator () ( const OBJ &item, ConsumerT &consumer )
+	{
+		Consumer<ConsumerT>	next( *this, consumer );
+		m_prevStage( item, next );
+	}
+};
+
+/**
+	@brief the last stage of a parallel pipeline, appends the items to a chunk
+*/
+template <typename OBJ>
+class ChunkAppender
+{
+	Array<OBJ>	&m_items;
+
+	public:
+	ChunkAppender( Array<OBJ> &items ) : m_items( items ) {}
+
+	void operator () ( const OBJ &item )
+	{
+		m_items.addElement( item );
+	}
+};
+
+/**
+	@brief runs the stages of a pipeline with a ThreadPool
+
+	Each chunk of the source stream is processed by one worker of the pool.
+	The number of chunks that are processed or wait for their predecessors is
+	limited by maxInFlight. The buffer of the source stream, the input buffer,
+	the output buffer and the buffers of the destinations of the result get a
+	capacity of maxInFlight chunks, thus a slow chunk or a slow consumer
+	blocks the source stream instead of filling the buffers. Stages further
+	upstream are not limited, fuse them with the parallel stages. In mode
+	poOrdered the worker that finished the oldest chunk passes all chunks
+	that are ready in the order of the source stream.
+
+	The stages must not share any state without a synchronisation. Items the
+	stages throw an exception for are ignored.
+
+	@see StreamImpl::parallelMap, StreamImpl::parallelFilter, FusedStream::toParallelStream
+*/
+template <typename SourceT, typename TargetT, typename StagesT>
+class ParallelSourceImpl : public DoubleBufferImpl<SourceT, TargetT>
+{
+	private:
+	typedef DoubleBufferImpl<SourceT, TargetT>	Super;
+	typedef typename Super::ConversionThread	ConversionThread;
+	typedef typename Super::SourceStream		SourceStream;
+	typedef typename Super::SourceItems			SourceItems;
+	typedef typename Super::SourceChunk			SourceChunk;
+	typedef typename Super::TargetChunk			TargetChunk;
+
+	class ParallelThread;
+
+	class ChunkJob
+	{
+		ParallelThread	*m_thread;
+		std::size_t		m_sequence;
+		SourceChunk		m_input;
+
+		public:
+		ChunkJob() : m_thread( nullptr ), m_sequence( 0 ) {}
+		ChunkJob( ParallelThread *thread, std::size_t sequence, const SourceChunk &input )
+		: m_thread( thread ), m_sequence( sequence ), m_input( input )
+		{
+		}
+
+		void operator () () const
+		{
+			m_thread->processChunk( m_sequence, m_input );
+		}
+	};
+
+	class ParallelThread : public ConversionThread
+	{
+		const StagesT		m_stages;
+		const std::size_t	m_degree, m_maxInFlight;
+		const ParallelOrder	m_order;
+
+		Critical			m_critical;
+		Semaphore			m_chunkDone;
+		Array<TargetChunk>	m_results;
+		std::size_t			m_numDone;
+
+		std::size_t getNumDone()
+		{
+			CriticalScope	scope( m_critical );
+			return m_numDone;
+		}
+		void waitForChunks( std::size_t numSubmitted, std::size_t maxInFlight )
+		{
+			while( numSubmitted - getNumDone() > maxInFlight )
+			{
+				m_chunkDone.wait();
+			}
+		}
+		virtual void doConversion()
+		{
+			doEnterFunction("ParallelThread::doConversion");
+
+			ThreadPool<ChunkJob>	pool( m_degree, "ParallelStream", nullptr, pmWorkStealing );
+			SourceChunk				input;
+			std::size_t				numSubmitted = 0;
+
+			m_numDone = 0;
+			m_results.clear();
+			m_results.setSize( m_maxInFlight );
+
+			pool.start();
+			while( !this->eof() && !this->terminated )
+			{
+				if( this->m_inputBuffer->popChunk( &input ) )
+				{
+					waitForChunks( numSubmitted, m_maxInFlight-1 );
+					pool.process( ChunkJob( this, numSubmitted++, input ) );
+				}
+			}
+			waitForChunks( numSubmitted, 0 );
+			pool.shutdown();
+		}
+
+		public:
+		ParallelThread( const StagesT &stages, std::size_t degree, ParallelOrder order, std::size_t maxInFlight )
+		: m_stages( stages ), m_degree( degree ), m_maxInFlight( getMaxInFlight( degree, maxInFlight ) ), m_order( order ), m_numDone( 0 )
+		{
+		}
+
+		void processChunk( std::size_t sequence, const SourceChunk &input )
+		{
+			doEnterFunction("ParallelThread::processChunk");
+
+			StagesT						stages( m_stages );
+			TargetChunk					output = Super::createChunk();
+			ChunkAppender<TargetT>		appender( *output );
+			for(
+				typename SourceItems::const_iterator it = input->cbegin(), endIT = input->cend();
+				it != endIT;
+				++it
+			)
+			{
+				try
+				{
+					stages( *it, appender );
+				}
+				catch( ... )
+				{
+					// ignore
+				}
+			}
+
+			{
+				CriticalScope	scope( m_critical );
+				if( m_order == poUnordered )
+				{
+					this->m_outputBuffer->pushChunk( output );
+					++m_numDone;
+				}
+				else
+				{
+					m_results[sequence % m_maxInFlight] = output;
+					for(
+						TargetChunk *next = &m_results[m_numDone % m_maxInFlight];
+						*next;
+						next = &m_results[m_numDone % m_maxInFlight]
+					)
+					{
+						this->m_outputBuffer->pushChunk( *next );
+						*next = TargetChunk();
+						++m_numDone;
+					}
+				}
+			}
+			m_chunkDone.notify();
+		}
+	};
+
+	static std::size_t getMaxInFlight( std::size_t degree, std::size_t maxInFlight )
+	{
+		return maxInFlight ? maxInFlight : 2*degree+1;
+	}
+	static ParallelThread *createParallelThread( const StagesT &stages, std::size_t degree, ParallelOrder order, std::size_t maxInFlight )
+	{
+		doEnterFunction("createParallelThread");
+		return new ParallelThread( stages, degree, order, maxInFlight );
+	}
+	public:
+	/**
+		@param [in] source the source stream
+		@param [in] stages the stages to execute
+		@param [in] degree the number of worker threads, 0 processes the chunks in the thread reading the source
+		@param [in] order the order of the items created
+		@param [in] maxInFlight the max. number of chunks processed or waiting for their predecessors and the capacity of the buffers in chunks, 0 for 2*degree+1
+	*/
+	ParallelSourceImpl( const SourceStream &source, const StagesT &stages, std::size_t degree, ParallelOrder order, std::size_t maxInFlight ) 
+	: Super( createParallelThread( stages, degree, order, maxInFlight ), source )
+	{
+		doEnterFunction("ParallelSourceImpl");
+		doLogValue( this );
+
+		const std::size_t	capacity = getMaxInFlight( degree, maxInFlight ) * STREAM_CHUNK_SIZE;
+		source->setCapacity( capacity );
+		this->setCapacity( capacity );
+	}
+};
+
+/**
+	@brief runs all stages of a fused pipeline in one thread
+	@see FusedStream
+*/
+template <typename SourceT, typename TargetT, typename StagesT>
+class FusedSourceImpl : public DoubleBufferImpl<SourceT, TargetT>
+{
+	private:
+	typedef DoubleBufferImpl<SourceT, TargetT>	Super;
+	typedef typename Super::ConversionThread	ConversionThread;
+	typedef typename Super::SourceStream		SourceStream;
+	typedef typename Super::SourceItems			SourceItems;
+	typedef typename Super::SourceChunk			SourceChunk;
+	typedef typename Super::TargetChunk			TargetChunk;
+	typedef typename Super::TargetBuffer		TargetBuffer;
+
+	class Output
+	{
+		TargetBuffer	&m_buffer;
+		TargetChunk		m_chunk;
+
+		public:
+		Output( TargetBuffer &buffer ) : m_buffer( buffer ) {}
+
+		void operator () ( const TargetT &item )
+		{
+			if( !m_chunk )
+			{
+				m_chunk = Super::createChunk();
+			}
+			m_chunk->addElement( item );
+			if( m_chunk->size() >= STREAM_CHUNK_SIZE )
+			{
+				flush();
+			}
+		}
+		void flush()
+		{
+			m_buffer->pushChunk( m_chunk );
+			m_chunk = TargetChunk();
+		}
+	};
+
+	class FusedThread : public ConversionThread
+	{
+		StagesT	m_stages;
+
+		virtual void doConversion()
+		{
+			doEnterFunction("FusedThread::doConversion");
+
+			Output		output( this->m_outputBuffer );
+			SourceChunk	input;
+			while( !this->eof() && !this->terminated )
+			{
+				if( this->m_inputBuffer->popChunk( &input ) )
+				{
+					for(
+						typename SourceItems::const_iterator it = input->cbegin(), endIT = input->cend();
+						it != endIT;
+						++it
+					)
+					{
+						doLogValue( *it );
+						m_stages( *it, output );
+					}
+					output.flush();
+				}
+			}
+		}
+		public:
+		FusedThread( const StagesT &stages ) : m_stages( stages )
+		{
+		}
+	};
+
+	static FusedThread *createFusedThread( const StagesT &stages )
+	{
+		doEnterFunction("createFusedThread");
+		return new FusedThread( stages );
+	}
+	public:
+	FusedSourceImpl( const SourceStream &source, const StagesT &stages ) 
+	: Super( createFusedThread( stages ), source )
+	{
+		doEnterFunction("FusedSourceImpl");
+		doLogValue( this );
+	}
+};
+
 template <typename BackInserterIteratorT, typename OBJ>
 class ContainerSinkFunction
 {
@@ -799,6 +1509,8 @@ class StreamSinkImpl : public SharedObject
 	public:
 	typedef StreamBuffer<OBJ>		MyStreamBuffer;
 	typedef Stream<OBJ>				MyStream;
+	typedef typename StreamBufferImpl<OBJ>::Items	Items;
+	typedef typename StreamBufferImpl<OBJ>::Chunk	Chunk;
 
 	class SinkThread : public StreamThread
 	{
@@ -820,12 +1532,22 @@ class StreamSinkImpl : public SharedObject
 				doLogValue( getName() );
 			}
 
+			Chunk	chunk;
 			while( !m_buffer->eof() && !terminated )
 			{
 				doLogPosition();
-				OBJ	item = m_buffer->pop();
-				doLogValue( item );
-				m_sinkFunction( item );
+				if( m_buffer->popChunk( &chunk ) )
+				{
+					for(
+						typename Items::const_iterator it = chunk->cbegin(), endIT = chunk->cend();
+						it != endIT;
+						++it
+					)
+					{
+						doLogValue( *it );
+						m_sinkFunction( *it );
+					}
+				}
 			}
 			m_buffer = NULL;
 		}
@@ -862,6 +1584,9 @@ class StreamSinkImpl : public SharedObject
 	}
 	virtual void stop()
 	{
+		// release the dispatcher waiting for the capacity of our buffer
+		m_streamBuffer->setCapacity( 0 );
+
 		m_sourceStream->stop();
 		m_sinkThread->StopThread();
 		m_sinkThread->join();
@@ -916,7 +1641,8 @@ class StreamImpl : public SharedObject
 	typedef Sink<OBJ, SinkFunction>	SimpleSink;
  
 	private:
-	typedef Array<MyStreamBuffer>	Destinations;
+	typedef Array<MyStreamBuffer>					Destinations;
+	typedef typename StreamBufferImpl<OBJ>::Chunk	Chunk;
 
 	class DispatcherThread : public StreamThread
 	{
@@ -944,28 +1670,24 @@ class StreamImpl : public SharedObject
 
 			if( startIT != endIT && m_buffer )
 			{
+				Chunk	chunk;
 				while( !m_buffer->eof() && !terminated )
 				{
 					doLogPosition();
-					try
+					if( m_buffer->popChunk( &chunk ) )
 					{
-						OBJ	item = m_buffer->pop();
-						doLogValue( item );
-						++m_numItems;
+						m_numItems += chunk->size();
+
+						// all destinations share the same chunk
 						for(
 							typename Destinations::iterator it = startIT; it != endIT; ++it
 						)
 						{
-							MyStreamBuffer &dest = *it;
 							doLogPosition();
-							(*it)->push( item );
+							(*it)->pushChunk( chunk );
 							doLogPosition();
 						}
 					}
-					catch( TimeoutException & )
-					{
-						doLogPosition();
-					}
 				}
 				m_destinations.clear();
 				m_buffer = NULL;
@@ -1000,10 +1722,31 @@ class StreamImpl : public SharedObject
 		assert( !m_dispatcherThread->isRunning );
 	}
 
+	/// adds a buffer the items are dispatched to, it gets the capacity of our buffer
 	void registerDestination( MyStreamBuffer &destination )
 	{
 		m_destinations.addElement( destination );
 		destination->setOriginatingThread( static_cast<StreamThread*>(m_dispatcherThread) );
+		if( std::size_t capacity = m_streamBuffer->getCapacity() )
+		{
+			destination->setCapacity( capacity );
+		}
+	}
+	/**
+		@brief limits the items waiting in the buffer of this stream and in the buffers of its destinations
+		@param [in] capacity the max. number of items per buffer, 0 for no limit
+	*/
+	void setCapacity( std::size_t capacity )
+	{
+		m_streamBuffer->setCapacity( capacity );
+		for(
+			typename Destinations::iterator it = m_destinations.begin(), endIT = m_destinations.end();
+			it != endIT;
+			++it
+		)
+		{
+			(*it)->setCapacity( capacity );
+		}
 	}
 
 	void setName( const char *name )
@@ -1081,6 +1824,41 @@ class StreamImpl : public SharedObject
 	template <typename FilterFunctionT>
 	MyStream filter( const FilterFunctionT &filterFunction );
 
+	/**
+		@brief starts a fused pipeline
+
+		the map, filter and flatMap stages added to the result are executed
+		by one thread without any buffer between them.
+
+		@return the pipeline without any stage
+		@see FusedStream
+	*/
+	FusedStream<OBJ, OBJ, IdentityStage> fuse();
+
+	/**
+		@brief converts the items with a ThreadPool
+		@param [in] mapFunction the conversion function, called by several threads concurrently
+		@param [in] degree the number of worker threads
+		@param [in] order the order of the items created
+		@param [in] maxInFlight the max. number of chunks processed at once and waiting in each buffer, 0 for 2*degree+1
+		@return the stream with the converted items
+		@see ParallelSourceImpl
+	*/
+	template <typename TargetT, typename MapFunctionT>
+	Stream<TargetT> parallelMap( const MapFunctionT &mapFunction, std::size_t degree, ParallelOrder order=poOrdered, std::size_t maxInFlight=0 );
+
+	/**
+		@brief selects the items with a ThreadPool
+		@param [in] filterFunction the selection function, called by several threads concurrently
+		@param [in] degree the number of worker threads
+		@param [in] order the order of the items passed
+		@param [in] maxInFlight the max. number of chunks processed at once and waiting in each buffer, 0 for 2*degree+1
+		@return the stream with the selected items
+		@see ParallelSourceImpl
+	*/
+	template <typename FilterFunctionT>
+	MyStream parallelFilter( const FilterFunctionT &filterFunction, std::size_t degree, ParallelOrder order=poOrdered, std::size_t maxInFlight=0 );
+
 	template <typename SinkFunctionT>
 	Sink<OBJ, SinkFunctionT> addSink( const SinkFunctionT &sinkFunction );
 
@@ -1104,6 +1882,74 @@ class Stream : public SharedObjectPointer< StreamImpl<OBJ> >
 	}
 };
 
+/**
+	@brief a chain of stages that are executed by one thread
+
+	Unlike the stages created by StreamImpl::map, StreamImpl::filter and
+	StreamImpl::flatMap, each with its own thread and buffer, the stages of a
+	FusedStream are compiled into one loop. Use it for chains of functions
+	without any state shared with other threads.
+
+	@code
+		streams::Stream<STRING>	result = source->fuse()
+			.map<char>( firstLetter )
+			.filter( isVowel )
+			.flatMap<STRING>( expand )
+			.toStream();
+	@endcode
+
+	@tparam SourceT the type of the items of the source stream
+	@tparam TargetT the type of the items created by the last stage
+	@tparam StagesT the stages
+*/
+template <typename SourceT, typename TargetT, typename StagesT>
+class FusedStream
+{
+	Stream<SourceT>	m_source;
+	StagesT			m_stages;
+
+	public:
+	FusedStream( const Stream<SourceT> &source, const StagesT &stages ) : m_source( source ), m_stages( stages )
+	{
+	}
+
+	/// adds a stage that converts each item with mapFunction
+	template <typename NewTargetT, typename MapFunctionT>
+	FusedStream<SourceT, NewTargetT, MapStage<StagesT, NewTargetT, MapFunctionT> > map( const MapFunctionT &mapFunction ) const
+	{
+		return FusedStream<SourceT, NewTargetT, MapStage<StagesT, NewTargetT, MapFunctionT> >(
+			m_source, MapStage<StagesT, NewTargetT, MapFunctionT>( m_stages, mapFunction )
+		);
+	}
+	/// adds a stage that passes the items, filterFunction returns true for
+	template <typename FilterFunctionT>
+	FusedStream<SourceT, TargetT, FilterStage<StagesT, FilterFunctionT> > filter( const FilterFunctionT &filterFunction ) const
+	{
+		return FusedStream<SourceT, TargetT, FilterStage<StagesT, FilterFunctionT> >(
+			m_source, FilterStage<StagesT, FilterFunctionT>( m_stages, filterFunction )
+		);
+	}
+	/// adds a stage that passes all items pushed by flatMapFunction
+	template <typename NewTargetT, typename FlatMapFunctionT>
+	FusedStream<SourceT, NewTargetT, FlatMapStage<StagesT, NewTargetT, FlatMapFunctionT> > flatMap( const FlatMapFunctionT &flatMapFunction ) const
+	{
+		return FusedStream<SourceT, NewTargetT, FlatMapStage<StagesT, NewTargetT, FlatMapFunctionT> >(
+			m_source, FlatMapStage<StagesT, NewTargetT, FlatMapFunctionT>( m_stages, flatMapFunction )
+		);
+	}
+
+	/// creates the stream with the items created by the last stage
+	Stream<TargetT> toStream() const;
+	/**
+		@brief creates the stream with the items created by the last stage, the stages are executed by a ThreadPool
+		@param [in] degree the number of worker threads
+		@param [in] order the order of the items created
+		@param [in] maxInFlight the max. number of chunks processed at once and waiting in each buffer, 0 for 2*degree+1
+		@see ParallelSourceImpl
+	*/
+	Stream<TargetT> toParallelStream( std::size_t degree, ParallelOrder order=poOrdered, std::size_t maxInFlight=0 ) const;
+};
+
 // --------------------------------------------------------------------- //
 // ----- exported datas ------------------------------------------------ //
 // --------------------------------------------------------------------- //
@@ -1211,6 +2057,60 @@ inline Stream<OBJ> StreamImpl<OBJ>::filter( const FilterFunctionT &filterFunctio
 	);
 }
 
+template <typename OBJ>
+inline FusedStream<OBJ, OBJ, IdentityStage> StreamImpl<OBJ>::fuse()
+{
+	return FusedStream<OBJ, OBJ, IdentityStage>( MyStream(this), IdentityStage() );
+}
+
+template <typename SourceT, typename TargetT, typename StagesT>
+inline Stream<TargetT> FusedStream<SourceT, TargetT, StagesT>::toStream() const
+{
+	return Stream<TargetT>(
+		new StreamImpl<TargetT>(
+			StreamBuffer<TargetT>(
+				new FusedSourceImpl<SourceT, TargetT, StagesT>( 
+					m_source, m_stages 
+				)
+			)
+		)
+	);
+}
+
+template <typename SourceT, typename TargetT, typename StagesT>
+inline Stream<TargetT> FusedStream<SourceT, TargetT, StagesT>::toParallelStream( 
+	std::size_t degree, ParallelOrder order, std::size_t maxInFlight 
+) const
+{
+	return Stream<TargetT>(
+		new StreamImpl<TargetT>(
+			StreamBuffer<TargetT>(
+				new ParallelSourceImpl<SourceT, TargetT, StagesT>( 
+					m_source, m_stages, degree, order, maxInFlight
+				)
+			)
+		)
+	);
+}
+
+template <typename OBJ>
+template <typename TargetT, typename MapFunctionT>
+inline Stream<TargetT> StreamImpl<OBJ>::parallelMap( 
+	const MapFunctionT &mapFunction, std::size_t degree, ParallelOrder order, std::size_t maxInFlight 
+)
+{
+	return fuse().template map<TargetT>( mapFunction ).toParallelStream( degree, order, maxInFlight );
+}
+
+template <typename OBJ>
+template <typename FilterFunctionT>
+inline Stream<OBJ> StreamImpl<OBJ>::parallelFilter( 
+	const FilterFunctionT &filterFunction, std::size_t degree, ParallelOrder order, std::size_t maxInFlight 
+)
+{
+	return fuse().filter( filterFunction ).toParallelStream( degree, order, maxInFlight );
+}
+
 template <typename OBJ>
 template <typename SinkFunctionT>
 inline Sink<OBJ, SinkFunctionT> StreamImpl<OBJ>::addSink( const SinkFunctionT &sinkFunction )
@@ -1220,7 +2120,7 @@ inline Sink<OBJ, SinkFunctionT> StreamImpl<OBJ>::addSink( const SinkFunctionT &s
 
 	return Sink<OBJ, SinkFunctionT>(
 		new StreamSinkImpl<OBJ, SinkFunctionT>(
-			buffer, sinkFunction
+			MyStream(this), buffer, sinkFunction
 		)
 	);
 }
@@ -70,6 +70,10 @@
 
 #include <gak/gaklib.h>
 
+#ifdef __cplusplus
+#	include <gak/atomic.h>
+#endif
+
 #undef strlen
 
 
@@ -97,6 +101,11 @@
 
 #define STR_NOT_FOUND ((size_t)-1)
 
+/* the storage of a STR buffer */
+#define STR_HEAP		0	/* allocated with malloc */
+#define STR_SMALL		1	/* a small buffer cached by the thread */
+#define STR_ARENA		2	/* taken from a StrArena */
+
 #define NULL_STRING		STRING( (const char *)0 )
 #define EMPTY_STRING	STRING( "" )
 
@@ -127,6 +136,7 @@ typedef struct STR_s
 				actSize,
 				minSize;
 	STR_CHARSET	charset;
+	unsigned char	storage;
 	char 		string[1];
 } STR;
 
@@ -139,6 +149,10 @@ extern "C"
 {
 #endif
 
+STR *reallocStr( STR *str, size_t size );
+void freeStr( STR *str );
+void flushStrCache( void );
+
 STR *newStr( void );
 STR *setMinSizeStr( STR *str, size_t newSize );
 STR *resizeStr( STR *str, size_t newSize, cBool exact );
@@ -213,16 +227,37 @@ class STRING
 	void setText( const DynamicVar &source );
 	void setText( char first, std::size_t count );
 
+	/*
+		the buffer may be shared by STRINGs of different threads, thus the
+		usage counter is changed atomically
+	*/
+	static void incUC( STR *str )
+	{
+		atomicFetchAdd( &str->usageCount, 1L, moRelaxed );
+	}
+	static long decUC( STR *str )
+	{
+		return atomicFetchAdd( &str->usageCount, -1L, moAcqRel ) - 1;
+	}
+	static void releaseStr( STR *str )
+	{
+		if( !decUC( str ) )
+		{
+			freeStr( str );
+		}
+	}
+
 	void makePrivate()
 	{
-		if( text && text->usageCount > 1 )
+		if( text && atomicLoad( &text->usageCount ) > 1 )
 		{
-			text->usageCount--;
-			text = copyStr( NULL, text );
+			STR	*shared = text;
+			text = copyStr( NULL, shared );
 			if( text )
 			{
 				text->usageCount = 1;
 			}
+			releaseStr( shared );
 		}
 	}
 
@@ -607,7 +642,7 @@ class STRING
 
 	size_t getUsageCount() const
 	{
-		return text ? text->usageCount : 0UL;
+		return text ? atomicLoad( &text->usageCount ) : 0UL;
 	}
 
 	STRING uperCaseCopy() const
@@ -818,10 +853,7 @@ class STRING
 	{
 		if( text )
 		{
-			if( !--(text->usageCount) )
-			{
-				free( text );
-			}
+			releaseStr( text );
 			text  = nullptr;
 		}
 	}
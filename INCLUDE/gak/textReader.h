@@ -132,18 +132,68 @@ struct TextPosition
 	}
 };
 
+/**
+	@brief reads characters from a stream for the parsers
+
+	The stream is read in blocks into a buffer of the TextReader, thus the
+	characters can be fetched without any virtual function call of the
+	stream. The bulk functions @ref readString, @ref readUntil,
+	@ref skipUntil, @ref skipBlanks and @ref readToken scan the buffer
+	directly.
+
+	Line and column are not counted while reading, they are computed from
+	the buffer when @ref getPosition is called.
+
+	Since the stream is read ahead, it must not be used by the caller while
+	the TextReader is reading.
+*/
 class TextReader
 {
 	private:
+	/// number of characters kept in the buffer for putback
+	static const std::size_t PUTBACK_SIZE = 16;
+	/// size of the first block read, small strings need small buffers
+	static const std::size_t MIN_BLOCK_SIZE = 256;
+	/// max size of a block read from the stream
+	static const std::size_t MAX_BLOCK_SIZE = 65536;
+
 	CI_STRING			m_encoding;
-	bool				m_iStreamCreated, m_utf8failure;
+	bool				m_iStreamCreated, m_utf8failure, m_utf8, m_eof;
 	std::istream		*m_inputStream;
 	ArrayOfStrings		m_errors;
-	TextPosition		m_position;
+
+	char				*m_buffer;
+	std::size_t			m_blockSize;
+	const char			*m_begin, *m_cur, *m_end;
+
+	mutable TextPosition	m_position;
+	mutable const char		*m_counted;
+
+	// no copy
+	TextReader( const TextReader & );
+	const TextReader &operator = ( const TextReader & );
+
+	class DelimiterTable;
+
+	void init( bool eof )
+	{
+		m_iStreamCreated = false;
+		m_utf8failure = false;
+		m_utf8 = false;
+		m_eof = eof;
+		m_buffer = NULL;
+		m_blockSize = MIN_BLOCK_SIZE;
+		m_begin = m_cur = m_end = m_counted = NULL;
+	}
+	bool fillBuffer();
+	void countPosition() const;
+	char readNextChar();
+	bool appendUntil( const DelimiterTable &delimiters, STRING *result );
 
 	public:
 	TextReader( const STRING &theFileName ) : m_position( theFileName )
 	{
+		init( false );
 		m_inputStream = new std::ifstream(m_position.m_fileName);
 		if( !*m_inputStream )
 		{
@@ -152,42 +202,51 @@ class TextReader
 			throw OpenReadError( theFileName );
 		}
 		m_iStreamCreated = true;
-		m_utf8failure = false;
 	}
 	TextReader( std::istream *theInput, const STRING &theFileName=NULL_STRING )
 	: m_position( theFileName )
 	{
+		init( theInput->eof() || theInput->fail() );
 		m_inputStream = theInput;
-		m_iStreamCreated = false;
-		m_utf8failure = false;
 	}
 	~TextReader()
 	{
 		closeStream();
+		delete [] m_buffer;
 	}
 
 	public:
+	/// reads the next character until stringDelimiter, the delimiter is skipped
 	STRING readString( char stringDelimiter );
-	char getNextWithBlank( void );
-	char getNextNonBlank( void );
-	bool eof( void ) const
-	{
-		return m_inputStream->eof() || m_inputStream->fail();
-	}
-	void putback( char c )
+	/// reads all characters until one of delimiters, the delimiter is not read
+	STRING readUntil( const char *delimiters );
+	/**
+		@brief skips all characters until one of delimiters or a null character
+		@return the delimiter found, 0 at the end of the stream
+	*/
+	char skipUntil( const char *delimiters );
+	/// skips all white space
+	void skipBlanks();
+	/// skips white space and reads until white space, one of delimiters or a null character
+	STRING readToken( const char *delimiters );
+
+	char getNextWithBlank( void )
 	{
-		if( c == '\n' )
+		if( m_cur < m_end && (!m_utf8 || !(*m_cur & 0x80)) )
 		{
-			m_position.m_lineNo--;
+			return *m_cur++;
 		}
-		else
-		{
-			m_position.m_column--;
-		}
-		m_inputStream->putback( c );
+		return readNextChar();
+	}
+	char getNextNonBlank( void );
+	bool eof( void ) const
+	{
+		return m_eof;
 	}
+	void putback( char c );
 	void addError( const STRING &theError )
 	{
+		countPosition();
 		addError( theError, m_position.m_lineNo, m_position.m_column );
 	}
 	void addError( const STRING &theError, size_t lineNo, size_t column )
@@ -204,7 +263,10 @@ class TextReader
 	STRING getErrors( void );
 	void setEncoding( const STRING &encoding )
 	{
+		// the characters read so far are counted with the old encoding
+		countPosition();
 		m_encoding = encoding;
+		m_utf8 = m_encoding == UTF_8;
 	}
 	const CI_STRING &getEncoding() const
 	{
@@ -212,6 +274,7 @@ class TextReader
 	}
 	const TextPosition &getPosition( void ) const
 	{
+		countPosition();
 		return m_position;
 	}
 
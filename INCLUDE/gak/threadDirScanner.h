@@ -87,7 +87,7 @@ class ParalelDirScanner
 		ScannerFileProcessor(ParalelDirScanner *scanner) : FileProcessor(scanner->m_cmdLine), m_scanner(scanner) {}
 		void process( const DirectoryEntry &entry, const STRING &file )
 		{
-			m_scanner->m_threadPool.process(file);
+			m_scanner->m_threadPool.process(file, m_scanner->m_future);
 		}
 	};
 
@@ -96,15 +96,17 @@ class ParalelDirScanner
 	const CommandLine &							m_cmdLine;
 	DirectoryScanner<ScannerFileProcessor>		m_scanner;
 	ThreadPool<STRING>							m_threadPool;
+	PoolFuture									m_future;
 
 	public:
 	ParalelDirScanner( const STRING &threadName, const CommandLine &cmdLine, void *mainData=nullptr, size_t count=8 ) : m_cmdLine(cmdLine), m_scanner(this), m_threadPool(count, threadName, mainData ) {}
 	void operator () ( const STRING &path, const STRING &filePattern = NULL_STRING )
 	{
 		m_threadPool.start();
+		m_future = PoolFuture::create();
 		m_scanner(path, filePattern);
 		doLogMessageEx(gakLogging::llInfo, "Dirscanner completed. Waiting for processors");
-		m_threadPool.flush();
+		m_future.wait();
 	}
 	void shutdown()
 	{
@@ -42,7 +42,10 @@
 
 #include <gak/thread.h>
 #include <gak/blockedQueue.h>
+#include <gak/workStealingQueue.h>
 #include <gak/fixedHeapArray.h>
+#include <gak/semaphore.h>
+#include <gak/stopWatch.h>
 #include <gak/exception.h>
 
 // --------------------------------------------------------------------- //
@@ -83,6 +86,15 @@ enum PoolState
 	psStopping
 };
 
+/// the strategy a ThreadPool uses to pass the items to its workers
+enum PoolMode
+{
+	/// one dispatcher thread passes each item to an idle worker
+	pmDispatcher,
+	/// each worker has its own queue and steals from the others if that one is empty
+	pmWorkStealing
+};
+
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -93,6 +105,145 @@ class ThreadPoolError : public LibraryException
 	ThreadPoolError() : LibraryException("ThreadPoolError") {}
 };
 
+/**
+	@brief the shared state of a PoolFuture
+
+	counts the items that are not yet processed and wakes up the threads
+	waiting for the completion.
+
+	@see PoolFuture
+*/
+class PoolCompletion : public SharedObject
+{
+	Critical	m_cs;
+	size_t		m_pending,
+				m_waiters;
+	Semaphore	m_signal;
+
+	public:
+	PoolCompletion() : m_pending(0), m_waiters(0) {}
+
+	/// adds new items to be processed
+	void add( size_t count=1 )
+	{
+		CriticalScope	scope( m_cs );
+		m_pending += count;
+	}
+	/// called by a worker thread after one item was processed
+	void finished()
+	{
+		size_t	waiters = 0;
+		{
+			CriticalScope	scope( m_cs );
+
+			assert( m_pending );
+			if( !--m_pending )
+			{
+				waiters = m_waiters;
+				m_waiters = 0;
+			}
+		}
+		m_signal.notify( waiters );
+	}
+	/// returns the number of items not yet processed
+	size_t pending() const
+	{
+		return m_pending;
+	}
+	bool wait( unsigned long timeOut );
+};
+
+/**
+	@brief a handle to wait for a number of items processed by a ThreadPool
+
+	A PoolFuture is completed, if all items that have been added so far are 
+	processed. The result of the processing must be stored by the item itself
+	e.g. in a buffer the item points to.
+
+	@code
+		PoolFuture	future = PoolFuture::create();
+
+		for( ... )
+		{
+			pool.process( item, future );
+		}
+		future.wait();
+	@endcode
+	@see ThreadPool::process, ThreadPool::processAsync, ThreadPool::processBatchAsync
+*/
+class PoolFuture
+{
+	SharedObjectPointer<PoolCompletion>	m_completion;
+
+	explicit PoolFuture( PoolCompletion *completion ) : m_completion( completion ) {}
+
+	public:
+	/// creates an empty handle that does not track anything
+	PoolFuture() {}
+
+	/// creates a new handle that can be passed to ThreadPool::process
+	static PoolFuture create()
+	{
+		return PoolFuture( new PoolCompletion() );
+	}
+
+	/// returns true, if this handle tracks items
+	bool isValid() const
+	{
+		return !!m_completion;
+	}
+	/// returns true, if all items are processed
+	bool isDone() const
+	{
+		return !m_completion || !m_completion->pending();
+	}
+	/// returns the number of items not yet processed
+	size_t pending() const
+	{
+		return m_completion ? m_completion->pending() : 0;
+	}
+	/**
+		@brief waits until all items are processed
+		@param [in] timeOut the max time in ms to wait
+		@return true if all items are processed, false on timeout
+	*/
+	bool wait( unsigned long timeOut=Semaphore::WAIT_FOREVER ) const
+	{
+		return !m_completion || m_completion->wait( timeOut );
+	}
+
+	/// @cond
+	void add( size_t count=1 ) const
+	{
+		if( m_completion )
+		{
+			m_completion->add( count );
+		}
+	}
+	void finished() const
+	{
+		if( m_completion )
+		{
+			m_completion->finished();
+		}
+	}
+	/// @endcond
+};
+
+/**
+	@brief an item waiting in the queue of a ThreadPool
+	@tparam ObjectT the type of objects that can be processed
+*/
+template <typename ObjectT>
+struct PoolItem
+{
+	ObjectT		object;
+	PoolFuture	future;
+
+	PoolItem() : object() {}
+	PoolItem( const ObjectT &iObject, const PoolFuture &iFuture=PoolFuture() ) : object(iObject), future(iFuture) {}
+};
+
 /**
 	@brief helper class that processes an item by calling its operator ()
 	@tparam ObjectT the type of the items that can be processed
@@ -133,28 +284,51 @@ class PoolThread : public Thread
 	enum ThreadMode { tmIdle, tmAquired, tmProcessing } m_mode;
 	Thread			*m_dispatcher;
 
+	PoolFuture		m_future;
+
+	WorkStealingQueue< PoolItem<object_type> >	*m_workQueue;
+	size_t										m_workerIndex;
+
 	void			*m_threadPool,
 					*m_mainData;
 
+	void executeWorkStealing();
 	virtual void ExecuteThread();
 
 	public:
 	PoolThread() : Thread(false)
 	{
 		m_dispatcher = nullptr;
-		m_threadPool = m_mainData = nullptr; 
+		m_workQueue = nullptr;
+		m_workerIndex = 0;
+		m_threadPool = m_mainData = nullptr;
 		m_mode = tmIdle;
 	}
 
+	/**
+		@brief lets the thread fetch its items from a WorkStealingQueue instead of waiting for a dispatcher (called by the pool before the thread is started).
+		@param [in] workQueue the queue to fetch the items from, nullptr to use a dispatcher
+		@param [in] workerIndex the index of the local queue of this thread
+	*/
+	void setWorkQueue( WorkStealingQueue< PoolItem<object_type> > *workQueue, size_t workerIndex, void *threadPool, void *mainData )
+	{
+		m_workQueue = workQueue;
+		m_workerIndex = workerIndex;
+		m_threadPool = threadPool;
+		m_mainData = mainData;
+	}
+
 	/**
 		@brief notifies the thread to process the next item (called by the dispatcher thread).
 		@param [in] objectToProcess the item to process
 		@param [in] dispatcher the dispatcher thread which is notified, after the item was processed
+		@param [in] future the handle which is notified, after the item was processed
 	*/
-	void process( const object_type &objectToProcess, Thread *dispatcher, void *threadPool, void *mainData  )
+	void process( const object_type &objectToProcess, Thread *dispatcher, void *threadPool, void *mainData, const PoolFuture &future=PoolFuture() )
 	{
 		assert(m_mode == tmAquired);
 		m_objectToProcess = objectToProcess;
+		m_future = future;
 		m_dispatcher = dispatcher;
 		m_threadPool = threadPool;
 		m_mainData = mainData;
@@ -191,6 +365,10 @@ class PoolThread : public Thread
 
 	this object creates a number of threads processing the items, a queue with items waiting for processing
 	and a dispatcher thread passing these items to a free thread.
+
+	In mode pmWorkStealing there is no dispatcher. Each thread owns a local queue and new items
+	are distributed round robin. A thread without work steals the items from the other queues
+	and waits without polling if there is nothing to do.
 	 
 	@tparam ObjectT the type of objects that can be processed
 	@tparam ThreadT the type of thread that process the objects, default PoolThread<ProcessorType<ObjectT>>
@@ -202,6 +380,7 @@ class ThreadPool
 {
 	typedef FixedHeapArray<ThreadT>			PoolArray;
 	typedef ThreadPool<ObjectT,ThreadT>		SelfT;
+	typedef PoolItem<ObjectT>				item_type;
 
 	class PoolDispatcher : public Thread
 	{
@@ -223,7 +402,7 @@ class ThreadPool
 		void StopThread()
 		{
 			terminated = true;
-			m_pool.m_queue.push( ObjectT() );	// this is a dummy to notify the dispatcher loop, to have a chance to terminate
+			m_pool.m_queue.push( item_type() );	// this is a dummy to notify the dispatcher loop, to have a chance to terminate
 												// otherwise the dispatcher could wait for a new object and never terminates
 												// since terminate is true, the dispatcher loop will not forward that dummy to
 												// an object processor
@@ -233,23 +412,26 @@ class ThreadPool
 
 	private:
 	bool					m_singleThreadMode;
+	PoolMode				m_mode;
 	PoolDispatcher			m_dispatcher;
 	STRING					m_threadNames;
 	bool					m_stopping, m_stopped;
 	void					*m_mainData;
 
 	public:
-	PoolArray				m_pool;
-	BlockedQueue<ObjectT>	m_queue;
+	PoolArray						m_pool;
+	BlockedQueue<item_type>			m_queue;
+	WorkStealingQueue<item_type>	m_workQueue;
 
 	public:
 	/**
 		@brief creates a new thread pool
 		@param count the numnber of worker threads to create
+		@param mode the strategy to pass the items to the worker threads
 	*/
-	ThreadPool( size_t count, const STRING &threadNames, void *mainData=nullptr )
-		: m_singleThreadMode(count==0), m_dispatcher(*this, mainData), m_threadNames(threadNames),
-		  m_stopping(false), m_stopped(true), m_mainData(mainData), m_pool(count==0?1:count)
+	ThreadPool( size_t count, const STRING &threadNames, void *mainData=nullptr, PoolMode mode=pmDispatcher )
+		: m_singleThreadMode(count==0), m_mode(mode), m_dispatcher(*this, mainData), m_threadNames(threadNames),
+		  m_stopping(false), m_stopped(true), m_mainData(mainData), m_pool(count==0?1:count), m_workQueue(count==0?1:count)
 	{}
 	~ThreadPool()
 	{
@@ -262,18 +444,57 @@ class ThreadPool
 	*/
 	void process( const ObjectT &objectToProcess )
 	{
-		if( m_stopped )
-		{
-			throw ThreadPoolError();
-		}
-		if(m_singleThreadMode)
-		{
-			m_pool[0].process(objectToProcess, this, m_mainData );
-		}
-		else
-		{
-			m_queue.push( objectToProcess );
-		}
+		process( objectToProcess, PoolFuture() );
+	}
+	/**
+		@brief add a new item to the processing queue
+		@param objectToProcess the object to be processed
+		@param future the handle that is notified after the item was processed
+	*/
+	void process( const ObjectT &objectToProcess, const PoolFuture &future );
+	/**
+		@brief add a new item to the processing queue
+		@param objectToProcess the object to be processed
+		@return a handle to wait for the item
+	*/
+	PoolFuture processAsync( const ObjectT &objectToProcess )
+	{
+		PoolFuture	future = PoolFuture::create();
+		process( objectToProcess, future );
+		return future;
+	}
+	/**
+		@brief add a number of items to the processing queue
+
+		the queue is locked only once and as many workers are woken up as there are items.
+
+		@param first iterator to the first object to be processed
+		@param last iterator behind the last object to be processed
+		@param future the handle that is notified after the items were processed
+	*/
+	template <typename IteratorT>
+	void processBatch( IteratorT first, IteratorT last, const PoolFuture &future=PoolFuture() );
+	/**
+		@brief add all items of a container to the processing queue
+		@param items the container with the objects to be processed
+	*/
+	template <typename ContainerT>
+	void processBatch( const ContainerT &items )
+	{
+		processBatch( items.cbegin(), items.cend() );
+	}
+	/**
+		@brief add a number of items to the processing queue
+		@param first iterator to the first object to be processed
+		@param last iterator behind the last object to be processed
+		@return a handle to wait for all these items
+	*/
+	template <typename IteratorT>
+	PoolFuture processBatchAsync( IteratorT first, IteratorT last )
+	{
+		PoolFuture	future = PoolFuture::create();
+		processBatch( first, last, future );
+		return future;
 	}
 	/// waits for all objects in the queue to be processed returns after the last object is processed
 	void flush();
@@ -284,7 +505,7 @@ class ThreadPool
 	/// returns thr total number of items pushed in this queue
 	size_t total() const
 	{
-		return m_queue.total();
+		return m_mode == pmWorkStealing ? m_workQueue.total() : m_queue.total();
 	}
 	/// returns thr number of items in process
 	size_t inProgress() const;
@@ -292,6 +513,10 @@ class ThreadPool
 	/// returns thr number of items still waiting in this queue
 	size_t size() const
 	{
+		if( m_mode == pmWorkStealing )
+		{
+			return m_workQueue.pending();
+		}
 		return m_queue.size() + inProgress() + (m_dispatcher.dispatching() ? 1 : 0);
 	}
 
@@ -299,6 +524,17 @@ class ThreadPool
 	void setObjectProcessor( const ProcessorT &objectProcessor );
 
 	PoolState getCurrentState() const;
+
+	/// returns the strategy used to pass the items to the worker threads
+	PoolMode getMode() const
+	{
+		return m_mode;
+	}
+	/// returns the number of items a worker has taken from the local queue of another worker
+	size_t stolen() const
+	{
+		return m_workQueue.stolen();
+	}
 };
 
 // --------------------------------------------------------------------- //
@@ -355,6 +591,12 @@ void PoolThread<ProcessorT>::ExecuteThread()
 	ThreadID t_id2 = thread->getThreadID();
 #endif
 
+	if( m_workQueue )
+	{
+		executeWorkStealing();
+		return;
+	}
+
 	while( !terminated )
 	{
 		assert(t_id1 == t_id2);
@@ -371,19 +613,44 @@ void PoolThread<ProcessorT>::ExecuteThread()
 			{
 				// ignore all errors
 			}
+			m_future.finished();
+			m_future = PoolFuture();
 			m_mode = tmIdle;
 			m_dispatcher->notify();
 		}
 	}
 }
 
+template <typename ProcessorT>
+void PoolThread<ProcessorT>::executeWorkStealing()
+{
+	PoolItem<object_type>	item;
+
+	while( m_workQueue->pop( m_workerIndex, &item ) )
+	{
+		m_mode = tmProcessing;
+		try
+		{
+			m_objectProcessor.process( item.object, m_threadPool, m_mainData );
+		}
+		catch( ... )
+		{
+			// ignore all errors
+		}
+		item.future.finished();
+		item = PoolItem<object_type>();
+		m_mode = tmIdle;
+		m_workQueue->done();
+	}
+}
+
 template <typename ObjectT, typename ThreadT>
 void ThreadPool<ObjectT, ThreadT>::PoolDispatcher::ExecuteThread()
 {
 	m_dispatching = false;
 	while( !terminated )
 	{
-		ObjectT objectToProcess = m_pool.m_queue.pop();
+		item_type itemToProcess = m_pool.m_queue.pop();
 
 		bool	processing = false;
 		m_dispatching = true;
@@ -399,7 +666,7 @@ void ThreadPool<ObjectT, ThreadT>::PoolDispatcher::ExecuteThread()
 				if( it->aquire() )
 				{
 					m_dispatching = false;
-					it->process( objectToProcess, this, &m_pool, m_mainData );
+					it->process( itemToProcess.object, this, &m_pool, m_mainData, itemToProcess.future );
 					processing = true;
 					break;
 				}
@@ -422,10 +689,84 @@ void ThreadPool<ObjectT, ThreadT>::PoolDispatcher::ExecuteThread()
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+template <typename ObjectT, typename ThreadT>
+void ThreadPool<ObjectT, ThreadT>::process( const ObjectT &objectToProcess, const PoolFuture &future )
+{
+	if( m_stopped )
+	{
+		throw ThreadPoolError();
+	}
+	future.add();
+	if(m_singleThreadMode)
+	{
+		m_pool[0].process(objectToProcess, this, m_mainData );
+		future.finished();
+	}
+	else if( m_mode == pmWorkStealing )
+	{
+		m_workQueue.push( item_type( objectToProcess, future ) );
+	}
+	else
+	{
+		m_queue.push( item_type( objectToProcess, future ) );
+	}
+}
+
+template <typename ObjectT, typename ThreadT>
+template <typename IteratorT>
+void ThreadPool<ObjectT, ThreadT>::processBatch( IteratorT first, IteratorT last, const PoolFuture &future )
+{
+	if( m_stopped )
+	{
+		throw ThreadPoolError();
+	}
+	if(m_singleThreadMode)
+	{
+		for( ; first != last; ++first )
+		{
+			m_pool[0].process(*first, this, m_mainData );
+		}
+		return;
+	}
+
+	Array<item_type>	items;
+	for( ; first != last; ++first )
+	{
+		items.addElement( item_type( *first, future ) );
+	}
+	future.add( items.size() );
+	if( m_mode == pmWorkStealing )
+	{
+		m_workQueue.pushBatch( items.cbegin(), items.cend() );
+	}
+	else
+	{
+		m_queue.pushBatch( items.cbegin(), items.cend() );
+	}
+}
+
 template <typename ObjectT, typename ThreadT>
 void ThreadPool<ObjectT, ThreadT>::start()
 {
-	if( !m_singleThreadMode && !m_dispatcher.isRunning )
+	if( !m_singleThreadMode && m_mode == pmWorkStealing )
+	{
+		if( m_stopped )
+		{
+			m_workQueue.clear();
+			m_workQueue.start();
+			size_t	workerIndex = 0;
+			for( 
+				typename PoolArray::iterator it = m_pool.begin(), endIT = m_pool.end();
+				it != endIT;
+				++it, ++workerIndex
+			)
+			{
+				it->setWorkQueue( &m_workQueue, workerIndex, this, m_mainData );
+				it->StartThread(m_threadNames);
+			}
+		}
+	}
+	else if( !m_singleThreadMode && !m_dispatcher.isRunning )
 	{
 		m_queue.clear();
 		for( 
@@ -444,6 +785,14 @@ void ThreadPool<ObjectT, ThreadT>::start()
 template <typename ObjectT, typename ThreadT>
 void ThreadPool<ObjectT, ThreadT>::flush()
 {
+	if( m_mode == pmWorkStealing )
+	{
+		if( !m_singleThreadMode )
+		{
+			m_workQueue.waitIdle();
+		}
+		return;
+	}
 	while( m_queue.size() )
 	{
 		Sleep( 10 );
@@ -487,6 +836,10 @@ void ThreadPool<ObjectT, ThreadT>::shutdown()
 	m_stopped = true;
 	m_stopping = true;
 	flush();
+	if( m_mode == pmWorkStealing )
+	{
+		m_workQueue.stop();
+	}
 	for(
 		typename PoolArray::iterator it = m_pool.begin(), endIT = m_pool.end();
 		it != endIT;
@@ -496,8 +849,15 @@ void ThreadPool<ObjectT, ThreadT>::shutdown()
 		it->StopThread();
 		it->join();
 	}
-	m_dispatcher.StopThread();
-	m_dispatcher.join();
+	if( m_mode == pmWorkStealing )
+	{
+		m_workQueue.clear();
+	}
+	else
+	{
+		m_dispatcher.StopThread();
+		m_dispatcher.join();
+	}
 	m_queue.clear();
 	m_stopping = false;
 }
@@ -523,7 +883,7 @@ PoolState ThreadPool<ObjectT, ThreadT>::getCurrentState() const
 	{
 		return psStopping;
 	}
-	if( m_queue.size() > 0 || inProgress() > 0 )
+	if( m_queue.size() > 0 || m_workQueue.pending() > 0 || inProgress() > 0 )
 	{
 		return psProssesing;
 	}
@@ -542,6 +902,44 @@ PoolState ThreadPool<ObjectT, ThreadT>::getCurrentState() const
 	return psIdle;
 }
 
+inline bool PoolCompletion::wait( unsigned long timeOut )
+{
+	StopWatch	sw( true );
+
+	while( true )
+	{
+		{
+			CriticalScope	scope( m_cs );
+			if( !m_pending )
+			{
+				return true;
+			}
+			++m_waiters;
+		}
+
+		unsigned long	remaining = Semaphore::WAIT_FOREVER;
+		if( timeOut != Semaphore::WAIT_FOREVER )
+		{
+			unsigned long	elapsed = static_cast<unsigned long>( sw.getMillis() );
+			remaining = elapsed < timeOut ? timeOut - elapsed : 0;
+		}
+		if( !m_signal.wait( remaining ) )
+		{
+			CriticalScope	scope( m_cs );
+			if( !m_pending )
+			{
+				return true;
+			}
+			if( m_waiters )
+			{
+				--m_waiters;
+			}
+			return false;
+		}
+		// the signal may come from an earlier completion, so check again
+	}
+}
+
 template <typename ProcessorT>
 void PoolThread<ProcessorT>::process(
 	const object_type &objectToProces, void *threadPool, void *mainData
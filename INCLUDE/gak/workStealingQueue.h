@@ -0,0 +1,524 @@
+/*
+		Project:		GAKLIB
+		Module:			workStealingQueue.h
+		Description:	queues for work stealing worker threads
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_WORK_STEALING_QUEUE_H
+#define GAK_WORK_STEALING_QUEUE_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/locker.h>
+#include <gak/semaphore.h>
+#include <gak/fixedHeapArray.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a double ended queue used as the local work queue of one worker
+
+	the owner fetches items from the front, other workers steal from the back.
+	All members must be called with the Critical returned by @ref getCritical
+	entered.
+
+	@tparam OBJ the item types that is stored in this queue
+*/
+template <typename OBJ>
+class WorkDeque
+{
+	Critical	m_cs;
+	OBJ			*m_data;
+	size_t		m_capacity,
+				m_head,
+				m_count;
+
+	// no copy
+	WorkDeque( const WorkDeque & );
+	const WorkDeque & operator = ( const WorkDeque & );
+
+	void grow();
+
+	public:
+	WorkDeque() : m_data(nullptr), m_capacity(0), m_head(0), m_count(0) {}
+	~WorkDeque()
+	{
+		delete [] m_data;
+	}
+
+	Critical &getCritical()
+	{
+		return m_cs;
+	}
+
+	/// adds a new item at the back of the queue
+	void push( const OBJ &item )
+	{
+		if( m_count == m_capacity )
+		{
+			grow();
+		}
+		m_data[(m_head + m_count) % m_capacity] = item;
+		++m_count;
+	}
+	/// removes the oldest item (called by the owner)
+	bool popFront( OBJ *result )
+	{
+		if( !m_count )
+		{
+			return false;
+		}
+		*result = m_data[m_head];
+		m_data[m_head] = OBJ();
+		m_head = (m_head + 1) % m_capacity;
+		--m_count;
+		return true;
+	}
+	/// removes the newest item (called by a thief)
+	bool popBack( OBJ *result )
+	{
+		if( !m_count )
+		{
+			return false;
+		}
+		--m_count;
+		size_t	idx = (m_head + m_count) % m_capacity;
+		*result = m_data[idx];
+		m_data[idx] = OBJ();
+		return true;
+	}
+	void clear()
+	{
+		while( m_count )
+		{
+			m_data[m_head] = OBJ();
+			m_head = (m_head + 1) % m_capacity;
+			--m_count;
+		}
+		m_head = 0;
+	}
+	size_t size() const
+	{
+		return m_count;
+	}
+};
+
+/**
+	@brief a set of WorkDeque used to distribute items to a number of worker threads
+
+	Each worker owns one WorkDeque. New items are distributed round robin. A
+	worker first looks at its own WorkDeque and if that one is empty, it 
+	steals from the others. Workers without work are parked on a Semaphore
+	that is incremented for each queued item, so no thread is polling.
+
+	@tparam OBJ the item types that is stored in this queue
+	@see ThreadPool
+*/
+template <typename OBJ>
+class WorkStealingQueue
+{
+	typedef FixedHeapArray< WorkDeque<OBJ> >	DequeArray;
+
+	DequeArray	m_deques;
+	Semaphore	m_available,
+				m_idleSignal;
+	Critical	m_cs;
+	size_t		m_pending,
+				m_total,
+				m_stolen,
+				m_nextDeque,
+				m_idleWaiters;
+	bool		m_stopped;
+
+	// no copy
+	WorkStealingQueue( const WorkStealingQueue & );
+	const WorkStealingQueue & operator = ( const WorkStealingQueue & );
+
+	size_t nextDeque()
+	{
+		CriticalScope	scope( m_cs );
+
+		++m_pending;
+		++m_total;
+		size_t result = m_nextDeque++;
+		if( m_nextDeque >= m_deques.size() )
+		{
+			m_nextDeque = 0;
+		}
+		return result;
+	}
+
+	public:
+	/**
+		@brief creates the queues
+		@param [in] numWorker the number of worker threads, i.e. the number of local queues
+	*/
+	WorkStealingQueue( size_t numWorker )
+	: m_deques( numWorker ? numWorker : 1 ), m_pending(0), m_total(0), m_stolen(0), m_nextDeque(0), m_idleWaiters(0), m_stopped(false)
+	{
+	}
+
+	/**
+		@brief adds a new item to the local queue of the next worker and wakes up one parked worker
+		@param [in] item the new item
+	*/
+	void push( const OBJ &item )
+	{
+		WorkDeque<OBJ>	&deque = m_deques[nextDeque()];
+		{
+			CriticalScope	scope( deque.getCritical() );
+			deque.push( item );
+		}
+		m_available.notify();
+	}
+	/**
+		@brief adds a number of items to the local queues
+
+		the items are split into one chunk per worker, each local queue is locked only once
+		and as many parked workers are woken up as there are new items.
+
+		@param [in] first iterator to the first item to add
+		@param [in] last iterator behind the last item to add
+	*/
+	template <typename IteratorT>
+	void pushBatch( IteratorT first, IteratorT last );
+	/**
+		@brief fetches the next item for a worker
+
+		the worker waits until an item is available or the queue is stopped.
+
+		@param [in] worker the index of the calling worker
+		@param [out] result the item to process
+		@return false if the queue was stopped and there is no more item
+	*/
+	bool pop( size_t worker, OBJ *result );
+	/**
+		@brief must be called by a worker when an item fetched by @ref pop was processed
+	*/
+	void done()
+	{
+		size_t	waiters = 0;
+		{
+			CriticalScope	scope( m_cs );
+
+			assert( m_pending );
+			if( !--m_pending )
+			{
+				waiters = m_idleWaiters;
+				m_idleWaiters = 0;
+			}
+		}
+		m_idleSignal.notify( waiters );
+	}
+	/// waits until all items pushed were processed
+	void waitIdle()
+	{
+		{
+			CriticalScope	scope( m_cs );
+			if( !m_pending )
+			{
+				return;
+			}
+			++m_idleWaiters;
+		}
+		m_idleSignal.wait();
+	}
+	/// prepares the queues for new workers
+	void start()
+	{
+		CriticalScope	scope( m_cs );
+		m_stopped = false;
+	}
+	/// stops all parked workers
+	void stop()
+	{
+		{
+			CriticalScope	scope( m_cs );
+			m_stopped = true;
+		}
+		m_available.notify( m_deques.size() );
+	}
+	/**
+		@brief removes all items that are not yet processed
+		@attention call this only while no worker is running
+	*/
+	void clear()
+	{
+		for(
+			typename DequeArray::iterator it = m_deques.begin(), endIT = m_deques.end();
+			it != endIT;
+			++it
+		)
+		{
+			CriticalScope	scope( it->getCritical() );
+			it->clear();
+		}
+		// remove the tokens of the removed items and those of stop()
+		while( m_available.wait(0) )
+			;
+
+		size_t	waiters;
+		{
+			CriticalScope	scope( m_cs );
+			m_pending = 0;
+			waiters = m_idleWaiters;
+			m_idleWaiters = 0;
+		}
+		m_idleSignal.notify( waiters );
+	}
+
+	/// @return the number of items waiting for a worker
+	size_t size() const
+	{
+		size_t	count = 0;
+		for(
+			typename DequeArray::const_iterator it = m_deques.cbegin(), endIT = m_deques.cend();
+			it != endIT;
+			++it
+		)
+		{
+			count += it->size();
+		}
+		return count;
+	}
+	/// @return the number of items waiting or being processed
+	size_t pending() const
+	{
+		return m_pending;
+	}
+	/// @return the number of items ever pushed in this queue
+	size_t total() const
+	{
+		return m_total;
+	}
+	/// @return the number of items a worker has taken from a foreign queue
+	size_t stolen() const
+	{
+		return m_stolen;
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+template <typename OBJ>
+void WorkDeque<OBJ>::grow()
+{
+	size_t	newCapacity = m_capacity ? m_capacity * 2 : 16;
+	OBJ		*newData = new OBJ[newCapacity];
+
+	for( size_t i=0; i<m_count; ++i )
+	{
+		newData[i] = m_data[(m_head + i) % m_capacity];
+	}
+	delete [] m_data;
+	m_data = newData;
+	m_capacity = newCapacity;
+	m_head = 0;
+}
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename OBJ>
+template <typename IteratorT>
+void WorkStealingQueue<OBJ>::pushBatch( IteratorT first, IteratorT last )
+{
+	size_t	count = 0;
+	for( IteratorT it = first; it != last; ++it )
+	{
+		++count;
+	}
+	if( !count )
+	{
+		return;
+	}
+
+	const size_t	numDeques = m_deques.size();
+	size_t			dequeIdx;
+	{
+		CriticalScope	scope( m_cs );
+
+		m_pending += count;
+		m_total += count;
+		dequeIdx = m_nextDeque;
+		m_nextDeque = (m_nextDeque + count) % numDeques;
+	}
+
+	const size_t	chunkSize = (count + numDeques - 1) / numDeques;
+	while( first != last )
+	{
+		WorkDeque<OBJ>	&deque = m_deques[dequeIdx];
+		CriticalScope	scope( deque.getCritical() );
+
+		for( size_t i=0; i<chunkSize && first != last; ++i, ++first )
+		{
+			deque.push( *first );
+		}
+		if( ++dequeIdx >= numDeques )
+		{
+			dequeIdx = 0;
+		}
+	}
+	m_available.notify( count );
+}
+
+template <typename OBJ>
+bool WorkStealingQueue<OBJ>::pop( size_t worker, OBJ *result )
+{
+	const size_t	numDeques = m_deques.size();
+
+	// each token of m_available belongs to one item, so we'll find it
+	// unless we've been woken up by stop(). Another worker may have taken 
+	// our item while we were looking at other queues, but in that case
+	// there is another item, its owner has not found, yet.
+	m_available.wait();
+	while( true )
+	{
+		{
+			WorkDeque<OBJ>	&own = m_deques[worker % numDeques];
+			CriticalScope	scope( own.getCritical() );
+			if( own.popFront( result ) )
+			{
+				return true;
+			}
+		}
+		for( size_t i=1; i<numDeques; ++i )
+		{
+			WorkDeque<OBJ>	&victim = m_deques[(worker + i) % numDeques];
+			CriticalScope	scope( victim.getCritical() );
+			if( victim.popBack( result ) )
+			{
+				CriticalScope	statScope( m_cs );
+				++m_stolen;
+				return true;
+			}
+		}
+
+		CriticalScope	scope( m_cs );
+		if( m_stopped )
+		{
+			return false;
+		}
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_WORK_STEALING_QUEUE_H
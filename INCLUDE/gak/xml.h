@@ -43,6 +43,7 @@
 #include <gak/fmtNumber.h>
 #include <gak/logfile.h>
 #include <gak/textReader.h>
+#include <gak/xmlAtom.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -118,6 +119,7 @@ enum GeneratorMode
 class XmlContainer;
 class Validator;
 class Element;
+class ElementIndex;
 
 typedef Element					*ElementPtr;
 
@@ -196,6 +198,8 @@ class Element
 	virtual ~Element();
 
 	virtual STRING getTag() const = 0;
+	/// returns the interned tag, the default implementation interns getTag()
+	virtual Atom getTagAtom() const;
 	virtual void setTag( const STRING &tag );
 	STRING getPath( bool includeIndex=true );
 
@@ -418,6 +422,11 @@ class Element
 	{
 		return getLocalName( getTag() );
 	}
+	/// returns the interned local name, e.g. for fast compares with constant atoms
+	Atom getLocalNameAtom() const
+	{
+		return getTagAtom().getLocalName();
+	}
 	static STRING getPrefix( const STRING &text );
 	static STRING getLocalName( const STRING &text );
 	bool testNamespaceAndTag( const STRING &nameSpace, const STRING &tag )
@@ -463,6 +472,25 @@ class Element
 	css::Styles *getCssStyle();
 	void clearCss();
 	int getTextDecorations();
+
+	/*
+		element index
+	*/
+	protected:
+	void treeChanged()
+	{
+		findRoot()->clearIndex();
+	}
+	ElementIndex *getTreeIndex() const
+	{
+		return findRoot()->getEnabledIndex();
+	}
+
+	public:
+	/// returns the index of the tree, if this is the root, and the index is enabled
+	virtual ElementIndex *getEnabledIndex();
+	/// deletes the index of the tree, if this is the root
+	virtual void clearIndex();
 };
 
 /*
@@ -613,6 +641,7 @@ class XmlContainer : public XmlWithAttributes
 		SortType		sortType
 	)
 	{
+		treeChanged();
 		objects.sort( fcmp, sortType );
 	}
 
@@ -621,7 +650,10 @@ class XmlContainer : public XmlWithAttributes
 	{
 		long oldIndex = getIndex( oldObject );
 		if( oldIndex >= 0 )
+		{
+			treeChanged();
 			objects.moveElement( (size_t)oldIndex, index );
+		}
 	}
 
 	Element *getPrevious( Element *oldObject )
@@ -640,19 +672,20 @@ class XmlContainer : public XmlWithAttributes
 class Any : public XmlContainer
 {
 	private:
-	STRING	tag;
+	Atom	tag;
 
 	public:
 	Any( const char *theTag ) : tag( theTag ) {}
 	Any( const STRING &theTag ) : tag( theTag ) {}
+	explicit Any( const Atom &theTag ) : tag( theTag ) {}
 
-	Any( const STRING &theTag, const STRING &cData )
+	Any( const STRING &theTag, const STRING &cData ) : tag( theTag )
 	{
-		tag = theTag;
 		addObject( new CData( cData ) );
 	}
 
 	virtual STRING getTag() const;
+	virtual Atom getTagAtom() const;
 	virtual void setTag( const STRING &tag );
 	virtual bool isInline();
 	virtual bool isBlock();
@@ -763,8 +796,18 @@ class StyleSheet : public Special
 */
 class Document : public XmlContainer
 {
-	css::Rules	cssRules;
-	F_STRING	m_fileName;
+	css::Rules		cssRules;
+	F_STRING		m_fileName;
+	ElementIndex	*m_index;
+	bool			m_indexEnabled;
+
+	bool matchSelector( const css::SelectorPart &part, Element *element );
+	bool matchSelector( const css::Selector &selector, Element *element )
+	{
+		return selector.size()
+			? matchSelector( selector.getElement( selector.size()-1 ), element )
+			: false;
+	}
 
 	css::Value findCssValue(
 		Element *element, const CI_STRING &media, size_t offset
@@ -778,7 +821,9 @@ class Document : public XmlContainer
 	void applyCssRules( Element *theRoot, const CI_STRING &media );
 
 	public:
-	Document( const STRING &theFile ) : m_fileName( theFile ) {}
+	Document( const STRING &theFile )
+	: m_fileName( theFile ), m_index( NULL ), m_indexEnabled( false ) {}
+	~Document();
 
 	virtual STRING getTag() const;
 	virtual bool isInline();
@@ -795,11 +840,7 @@ class Document : public XmlContainer
 		m_fileName = fileName;
 	}
 
-	void clearCssRules()
-	{
-		cssRules.clear();
-		clearCss();
-	}
+	void clearCssRules();
 	void setCssRules( const css::Rules &source )
 	{
 		clearCssRules();
@@ -807,20 +848,8 @@ class Document : public XmlContainer
 	}
 	void readCssRules( bool toLowerCase );
 	void readCssRules( const STRING &styles, bool toLowerCase );
-	void readCssRules( std::istream *theInputStream, bool toLowerCase )
-	{
-		doEnterFunction("Document::readCssRules( std::istream *theInputStream, bool toLowerCase )");
-		cssRules.readCssFile( theInputStream, toLowerCase );
-	}
-	void applyCssRules( const CI_STRING &media="screen" )
-	{
-		Element *theRoot = getRoot();
-
-		if( theRoot && cssRules.size() )
-		{
-			applyCssRules( theRoot, media );
-		}
-	}
+	void readCssRules( std::istream *theInputStream, bool toLowerCase );
+	void applyCssRules( const CI_STRING &media="screen" );
 
 	STRING getBackgroundImage( Element *element, const CI_STRING &media );
 
@@ -829,6 +858,30 @@ class Document : public XmlContainer
 	Element *getRoot();
 	Element *getRoot( const STRING &tag, const STRING &nameSpace );
 
+	/*
+		element index
+	*/
+	/**
+		@brief enables the index for getElement and findElement
+
+		Without an enabled index, only the CSS functions and getElementById
+		use the index.
+	*/
+	void enableIndex( bool enable=true )
+	{
+		m_indexEnabled = enable;
+	}
+	bool isIndexEnabled() const
+	{
+		return m_indexEnabled;
+	}
+	/// returns the index of all elements, builds it if necessary
+	ElementIndex &getIndex();
+	virtual ElementIndex *getEnabledIndex();
+	virtual void clearIndex();
+	/// returns the first element with the given id
+	Element *getElementById( const STRING &id );
+
 	virtual Element *setStringAttribute( size_t i, const STRING &value );
 	virtual Element *setStringAttribute( const STRING &name, const STRING &value );
 	void setAttributeName( size_t i, const STRING &name );
@@ -0,0 +1,252 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlAtom.h
+		Description:	interned names of XML tags and attributes
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_XML_ATOM_H
+#define GAK_XML_ATOM_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstddef>
+
+#include <gak/string.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// the default max. number of bytes used by the names of the atom table
+const std::size_t XML_ATOM_TABLE_SIZE = 1024*1024;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief an interned name of a tag or an attribute
+
+	All Atom objects with the same name share one entry of a global, thread
+	safe table. Thus atoms are compared by pointer and the STRING returned by
+	@ref getName shares its buffer with all other names created from the
+	atom. STRING::compare recognizes shared buffers, so comparing two
+	interned names is cheap, too, even if they are compared as STRINGs.
+
+	The table is never cleared, it is intended for the few distinct names of
+	XML documents, not for values. Since the names of untrusted documents
+	could fill the table, its size is limited by @ref setMaxTableSize. If the
+	table is full, a new name is not interned, the atom keeps its own copy of
+	the name and is compared by its name.
+
+	Two names are the same atom, if they have the same characters and
+	character set. Names with ASCII characters, only, are stored with the
+	character set STR_ASCII.
+*/
+class Atom
+{
+	public:
+	/// the entry of the atom table
+	struct Data
+	{
+		STRING		m_name;
+		const Data	*m_localName;
+		std::size_t	m_id;
+	};
+
+	private:
+	static const STRING	s_noName;
+
+	const Data	*m_data;
+	STRING		m_name;		// the name, if the table was full
+
+	explicit Atom( const Data *data ) : m_data( data )
+	{
+	}
+	void intern( const char *name, std::size_t length, STR_CHARSET charset );
+
+	public:
+	/// creates the null atom with an empty name
+	Atom() : m_data( NULL )
+	{
+	}
+	/// interns a name, an empty name creates the null atom
+	explicit Atom( const STRING &name );
+	/// interns a null terminated name
+	explicit Atom( const char *name );
+	/**
+		@brief interns a name that is not null terminated
+
+		The name is copied to a STRING only, if it is not yet in the table.
+
+		@param [in] name the characters of the name
+		@param [in] length the number of characters
+		@param [in] utf8 true, if non ASCII characters are UTF-8 encoded
+	*/
+	Atom( const char *name, std::size_t length, bool utf8 );
+
+	/// returns the interned name
+	const STRING &getName() const
+	{
+		return m_data ? m_data->m_name : m_name;
+	}
+	/// returns the name without the namespace prefix
+	Atom getLocalName() const;
+	/// returns a unique number > 0 or 0 for the null atom and names that are not interned
+	std::size_t getId() const
+	{
+		return m_data ? m_data->m_id : 0;
+	}
+	/// returns true for the null atom
+	bool isNull() const
+	{
+		return !m_data && m_name.isEmpty();
+	}
+	/// returns true if the name is in the table
+	bool isInterned() const
+	{
+		return m_data != NULL;
+	}
+
+	bool operator == ( const Atom &other ) const
+	{
+		return m_data == other.m_data && (m_data || m_name == other.m_name);
+	}
+	bool operator != ( const Atom &other ) const
+	{
+		return !(*this == other);
+	}
+
+	/// returns the number of names in the table
+	static std::size_t getNumAtoms();
+	/// returns the number of bytes used by the names of the table
+	static std::size_t getTableSize();
+	/// sets the max. number of bytes used by the names of the table, the table is not shrinked
+	static void setMaxTableSize( std::size_t maxSize );
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// returns the hash value of an Atom for HashMap and HashSet
+std::size_t hashValue( const Atom &atom );
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_XML_ATOM_H
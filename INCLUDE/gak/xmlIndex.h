@@ -0,0 +1,268 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlIndex.h
+		Description:	hashed lookup of XML elements by tag, id and class
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_XML_INDEX_H
+#define GAK_XML_INDEX_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/xml.h>
+#include <gak/hashMap.h>
+#include <gak/ci_string.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/// containers with less children are searched without the ElementIndex
+const std::size_t MIN_INDEXED_CHILDREN = 16;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief an index of all elements of a Document
+
+	The index maps the local names of the tags, the ids and the classes of
+	all elements to the elements. The keys are case insensitive, thus the
+	lists found may contain elements that do not match exactly. The lists
+	are in document order.
+
+	A Document builds its index when it is needed and deletes it when an
+	element is added, removed or renamed or an id or class attribute is
+	changed. Thus the index is useful for documents that are searched more
+	often than they are changed, e.g. while applying CSS rules.
+
+	@see Document::enableIndex, Document::getIndex
+*/
+class ElementIndex
+{
+	/*
+		the positions of an element and of the element behind its last
+		descendant in document order
+	*/
+	struct Extent
+	{
+		std::size_t	m_first, m_end;
+	};
+
+	typedef HashMap<CI_STRING, XmlArray>					ElementMap;
+	typedef HashMap<const Element *, Extent>				ExtentMap;
+	typedef HashSet<const Element *>						ElementSet;
+	typedef HashMap<const css::SelectorPart *, ElementSet>	SelectorMap;
+
+	XmlArray		m_all;
+	ExtentMap		m_extents;
+	ElementMap		m_tags, m_ids, m_classes;
+	SelectorMap		m_selectors;
+
+	// no copy
+	ElementIndex( const ElementIndex & );
+	const ElementIndex & operator = ( const ElementIndex & );
+
+	void addElement( Element *theElement );
+	static const XmlArray *findList( const ElementMap &map, const STRING &key )
+	{
+		std::size_t	index = map.getElementIndex( key );
+		return index != map.no_index ? &map.getValueAt( index ) : NULL;
+	}
+	static bool isMatch(
+		Element *theElement, const STRING &tag, const STRING &nameSpace
+	)
+	{
+		return theElement->getLocalName() == tag
+			&& (nameSpace.isEmpty() || theElement->getNamespace() == nameSpace);
+	}
+	std::size_t lowerBound( const XmlArray &elements, std::size_t position ) const;
+	Element *findFirst(
+		const Element *context, const XmlArray &candidates,
+		const STRING &tag, const STRING &nameSpace
+	) const;
+
+	const ElementSet &getSelectorMatches( const css::SelectorPart &part );
+
+	public:
+	/// indexes root and all its descendants
+	explicit ElementIndex( Element *root );
+
+	/// returns true if an element is part of the indexed tree
+	bool hasElement( const Element *theElement ) const
+	{
+		return m_extents.hasElement( theElement );
+	}
+	/// returns all elements in document order
+	const XmlArray &getElements() const
+	{
+		return m_all;
+	}
+	/// returns the elements with a local name ignoring the case or NULL
+	const XmlArray *getElementsByTag( const STRING &localName ) const
+	{
+		return findList( m_tags, localName );
+	}
+	/// returns the elements with an id ignoring the case or NULL
+	const XmlArray *getElementsById( const STRING &id ) const
+	{
+		return findList( m_ids, id );
+	}
+	/// returns the elements with a class ignoring the case or NULL
+	const XmlArray *getElementsByClass( const STRING &className ) const
+	{
+		return findList( m_classes, className );
+	}
+
+	/// returns the first element with the given id
+	Element *getElementById( const STRING &id ) const;
+	/// the same as XmlContainer::getElement( tag, nameSpace )
+	Element *getChild(
+		const Element *parent, const STRING &tag, const STRING &nameSpace
+	) const;
+	/// the same as Element::findElement( tag, nameSpace )
+	Element *findElement(
+		const Element *context, const STRING &tag, const STRING &nameSpace
+	) const;
+
+	/**
+		@brief the same as css::SelectorPart::match
+
+		The elements matching a selector part are searched only once, then
+		they are kept in a hash set until the index is deleted or
+		@ref clearSelectors is called.
+	*/
+	bool match( const css::SelectorPart &part, Element *theElement )
+	{
+		return getSelectorMatches( part ).hasElement( theElement );
+	}
+	/// forgets the matches of all selector parts, must be called if the css rules change
+	void clearSelectors()
+	{
+		m_selectors.clear();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_XML_INDEX_H
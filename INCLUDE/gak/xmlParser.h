@@ -76,7 +76,6 @@ class Factory
 class Parser : public TextReader
 {
 	Factory		*m_factory;
-	Set<STRING>	m_identifiers;
 	bool		m_utf8;
 
 	private:
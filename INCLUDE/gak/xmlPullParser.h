@@ -0,0 +1,493 @@
+/*
+		Project:		GAKLIB
+		Module:			xmlPullParser.h
+		Description:	a pull parser for XML with zero copy tokens
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+#ifndef GAK_XML_PULL_PARSER_H
+#define GAK_XML_PULL_PARSER_H
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+
+#include <gak/xml.h>
+#include <gak/xmlParser.h>
+#include <gak/textReader.h>
+#include <gak/memoryMappedFile.h>
+#include <gak/map.h>
+#include <gak/logfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+namespace xml
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/**
+	@brief a part of a text buffer that is not copied
+
+	The view does not own its characters. Thus it is only valid as long as
+	the buffer of the PullParser exists.
+*/
+class StringView
+{
+	const char		*m_text;
+	std::size_t		m_length;
+
+	public:
+	/// creates an empty view
+	StringView() : m_text( "" ), m_length( 0 )
+	{
+	}
+	/// creates a view of length characters starting at text
+	StringView( const char *text, std::size_t length ) : m_text( text ), m_length( length )
+	{
+	}
+
+	/// returns the first character
+	const char *begin() const
+	{
+		return m_text;
+	}
+	/// returns the character behind the view
+	const char *end() const
+	{
+		return m_text + m_length;
+	}
+	/// returns the number of characters
+	std::size_t size() const
+	{
+		return m_length;
+	}
+	/// returns true if there is no character
+	bool isEmpty() const
+	{
+		return !m_length;
+	}
+	/// returns the character at pos, there is no range check
+	char operator [] ( std::size_t pos ) const
+	{
+		return m_text[pos];
+	}
+	/// returns true if there is a character that must be decoded
+	bool hasEntities() const
+	{
+		return m_length && std::memchr( m_text, '&', m_length );
+	}
+	/// returns true if the view contains white space, only
+	bool isBlank() const;
+	/// returns the view without leading and trailing white space
+	StringView stripBlanks() const;
+
+	/// compares the view with a null terminated string
+	bool operator == ( const char *text ) const
+	{
+		return !std::strncmp( m_text, text, m_length ) && !text[m_length];
+	}
+	/// compares the view with a null terminated string
+	bool operator != ( const char *text ) const
+	{
+		return !(*this == text);
+	}
+
+	/// returns a copy of the characters
+	STRING toString() const;
+};
+
+/**
+	@brief reads XML step by step
+
+	In contrast to Parser the PullParser does not build any Element and does
+	not copy any text. The file is mapped into memory with MemoryMappedFile
+	and each call of @ref next returns the next event found. Names and values
+	of the event are StringView objects pointing into the file data, the
+	entities of text and attribute values are decoded only if the caller asks
+	for the value with @ref decodeValue.
+
+	The events of a start tag are etSTART_TAG followed by one etATTRIBUTE for
+	each attribute. Elements terminated with their start tag (\<tag/\>) get an
+	etEND_TAG event for which @ref isEmptyElement returns true.
+
+	@ref parseXML calls the same ProcessorT methods as Parser::parseXML, thus
+	existing processors can be used with both parsers.
+*/
+class PullParser
+{
+	public:
+	/// the kind of item found by @ref next
+	enum EventType
+	{
+		etEND_DOCUMENT,
+		etSTART_TAG,				///< name is the tag
+		etATTRIBUTE,				///< name and value of the attribute
+		etEND_TAG,					///< name is the tag
+		etTEXT,						///< value is the text (PCDATA)
+		etCOMMENT,					///< value is the comment
+		etCDATA,					///< value is the CDATA content
+		etDOCTYPE,					///< value is the document type definition
+		etPROCESSING_INSTRUCTION	///< name is the target, value the instruction
+	};
+
+	private:
+	MemoryMappedFile	m_mappedFile;
+	ArrayOfData			m_buffer;
+	TextPosition		m_position;
+	ArrayOfStrings		m_errors;
+
+	const char			*m_start, *m_cur, *m_end;
+
+	EventType			m_event;
+	StringView			m_name, m_value;
+	bool				m_inTag, m_emptyElement, m_utf8;
+
+	// no copy
+	PullParser( const PullParser & );
+	const PullParser & operator = ( const PullParser & );
+
+	void setBuffer( const char *data, std::size_t size );
+	void skipBlanks()
+	{
+		while( m_cur < m_end && isSpace( *m_cur ) )
+		{
+			++m_cur;
+		}
+	}
+	const char *find( char c ) const
+	{
+		const char *found = static_cast<const char *>(
+			std::memchr( m_cur, c, std::size_t(m_end - m_cur) )
+		);
+		return found ? found : m_end;
+	}
+	const char *find( const char *text, std::size_t len ) const;
+	StringView readName();
+
+	EventType readAttribute();
+	EventType readStartTag();
+	EventType readEndTag();
+	EventType readSpecialTag();
+	EventType readProcessingInstruction();
+	void processXMLdeclaration();
+
+	STRING fixCharset( const STRING &text ) const
+	{
+		if( m_utf8 && text.getCharSet() == STR_ANSI )
+		{
+			STRING result = text;
+			result.setCharSet( STR_UTF8 );
+			return result;
+		}
+		return text;
+	}
+	void addError( const STRING &theError );
+	/*
+		the end tag is interned with its '/', if there is no blank between
+	*/
+	STRING endTagToString() const
+	{
+		const char	*tag = m_name.begin()-1;
+		return tag >= m_start && *tag == '/'
+			? Atom( tag, m_name.size()+1, m_utf8 ).getName()
+			: STRING( '/' ) + nameToString();
+	}
+
+	public:
+	/**
+		@brief maps an XML file into memory
+		@param [in] fileName the name of the file
+		@exception OpenReadError if the file could not be mapped
+	*/
+	explicit PullParser( const STRING &fileName );
+	/**
+		@brief reads the entire stream into memory
+		@param [in] theInput the stream to read
+		@param [in] fileName the name used for error messages
+	*/
+	PullParser( std::istream *theInput, const STRING &fileName=NULL_STRING );
+	/**
+		@brief parses a buffer of the caller
+		@param [in] text the XML code, must exist while the PullParser exists
+		@param [in] length the number of characters
+		@param [in] fileName the name used for error messages
+	*/
+	PullParser( const char *text, std::size_t length, const STRING &fileName=NULL_STRING );
+
+	/**
+		@brief searches the next event
+		@return the kind of the event, etEND_DOCUMENT if there is no more data
+	*/
+	EventType next();
+
+	/// returns the current event
+	EventType getEvent() const
+	{
+		return m_event;
+	}
+	/// returns the name of a tag, an attribute or a processing instruction
+	const StringView &getName() const
+	{
+		return m_name;
+	}
+	/// returns the undecoded value of the current event
+	const StringView &getValue() const
+	{
+		return m_value;
+	}
+	/// returns true if the current etEND_TAG was created by \<tag/\>
+	bool isEmptyElement() const
+	{
+		return m_emptyElement;
+	}
+	/// returns true if the encoding of the xml declaration is UTF-8
+	bool isUTF8() const
+	{
+		return m_utf8;
+	}
+
+	/// returns the interned name
+	Atom getNameAtom() const
+	{
+		return Atom( m_name.begin(), m_name.size(), m_utf8 );
+	}
+	/**
+		@brief returns the name
+
+		The name is interned, thus it is copied only the first time it is
+		found and it can be compared fast with other interned names.
+	*/
+	STRING nameToString() const
+	{
+		return getNameAtom().getName();
+	}
+	/**
+		@brief returns a copy of the value
+
+		The entities of text and attribute values are replaced by their
+		characters.
+	*/
+	STRING decodeValue() const;
+	/// replaces all entities of text
+	STRING decode( const StringView &text ) const;
+
+	/// returns the offset of the current position in bytes
+	std::size_t getOffset() const
+	{
+		return std::size_t(m_cur - m_start);
+	}
+	/**
+		@brief returns line and column of the current position
+
+		The position is not tracked while parsing, it is computed from the
+		offset when it is needed, e.g. for error messages.
+	*/
+	TextPosition getPosition() const;
+	/// returns all errors found so far
+	STRING getErrors() const;
+
+	template <typename ProcessorT>
+	void parseXML( ProcessorT &processor );
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+template <typename ProcessorT>
+void PullParser::parseXML( ProcessorT &processor )
+{
+	doEnterFunction( "PullParser::parseXML" );
+
+	EventType	event = next();
+	while( event != etEND_DOCUMENT )
+	{
+		switch( event )
+		{
+			case etSTART_TAG:
+			{
+				STRING					theTag = nameToString();
+				PairMap<STRING,STRING>	attributes;
+
+				processor.processTag( theTag );
+				while( (event = next()) == etATTRIBUTE )
+				{
+					STRING	attribute = nameToString();
+					STRING	value = decodeValue();
+
+					attributes[attribute] = value;
+					processor.processAttribute( theTag, attribute, value );
+				}
+				processor.processAttributes( theTag, attributes );
+
+				if( event == etEND_TAG && isEmptyElement() )
+				{
+					processor.processEndTag( theTag );
+					event = next();
+				}
+/*^*/			continue;
+			}
+			case etEND_TAG:
+				processor.processEndTag( endTagToString() );
+				break;
+			case etTEXT:
+				if( !m_value.isBlank() )
+				{
+					STRING	pcData = decodeValue().stripBlanks();
+					if( !pcData.isEmpty() )
+					{
+						processor.processPcData( pcData );
+					}
+				}
+				break;
+			case etCOMMENT:
+			{
+				Comment	comment( decodeValue() );
+				processor.processSpecial( &comment );
+				break;
+			}
+			case etCDATA:
+			{
+				CData	cData( decodeValue() );
+				processor.processSpecial( &cData );
+				break;
+			}
+			case etDOCTYPE:
+			{
+				DocType	docType( decodeValue() );
+				processor.processSpecial( &docType );
+				break;
+			}
+			case etPROCESSING_INSTRUCTION:
+				processor.processProcessorInstructions(
+					STRING( '?' ) + nameToString(), decodeValue()
+				);
+				break;
+			default:
+				break;
+		}
+		event = next();
+	}
+}
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace xml
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
+
+#endif	// GAK_XML_PULL_PARSER_H
@@ -0,0 +1,341 @@
+/*
+		Project:		GAKLIB
+		Module:			BplusTreeTest.h
+		Description:	tests the B+-tree
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <sstream>
+#include <limits>
+
+#include <gak/unitTest.h>
+#include <gak/btree.h>
+#include <gak/bplusTree.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class BplusTreeTest : public UnitTest
+{
+	virtual const char *GetClassName() const
+	{
+		return "BplusTreeTest";
+	}
+
+	template <typename ContainerT, typename ReferenceT>
+	void compareTrees( const ContainerT &container, const ReferenceT &reference )
+	{
+		size_t	depth;
+		UT_ASSERT_TRUE( container.test( &depth ) );
+		UT_ASSERT_EQUAL( container.size(), reference.size() );
+
+		size_t	i=0;
+		for(
+			typename ReferenceT::const_iterator it = reference.cbegin(), endIT = reference.cend();
+			it != endIT;
+			++it, ++i
+		)
+		{
+			UT_ASSERT_EQUAL( container.getElementAt( i ), *it );
+			UT_ASSERT_EQUAL( reference.getElementAt( i ), *it );
+			UT_ASSERT_EQUAL( container.findIndex( *it ), i );
+		}
+		UT_ASSERT_EXCEPTION( container.getElementAt( i ), IndexError );
+		UT_ASSERT_EXCEPTION( reference.getElementAt( i ), IndexError );
+	}
+
+	template <int ORDER>
+	void randomTest( size_t numItems )
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "BplusTreeTest::randomTest" );
+
+		typedef BplusTree<int, FixedComparator<int>, ORDER>	MyTree;
+		MyTree		container;
+		Btree<int>	reference;
+
+		const int maxValue = int(numItems * 2);
+		for( size_t i=0; i<numItems; ++i )
+		{
+			int		value = randomNumber( maxValue );
+			bool	found = reference.hasElement( value );
+
+			UT_ASSERT_EQUAL( container.hasElement( value ), found );
+			int	&added = container.addElement( value );
+			UT_ASSERT_EQUAL( added, value );
+			reference.addElement( value );
+		}
+		compareTrees( container, reference );
+
+		size_t	depth;
+		MyTree	copy = container;
+		UT_ASSERT_TRUE( copy.test( &depth ) );
+		UT_ASSERT_EQUAL( copy, container );
+
+		for( size_t i=0; i<numItems; ++i )
+		{
+			int value = randomNumber( maxValue );
+			container.removeElement( value );
+			reference.removeElement( value );
+			UT_ASSERT_FALSE( container.hasElement( value ) );
+			UT_ASSERT_TRUE( container.test( &depth ) );
+		}
+		compareTrees( container, reference );
+
+		while( container.size() )
+		{
+			container.erase( container.begin() );
+		}
+		UT_ASSERT_TRUE( container.test( &depth ) );
+		UT_ASSERT_EQUAL( depth, size_t(0) );
+		UT_ASSERT_TRUE( container.getFirst() == nullptr );
+
+		// the copy must not be affected
+		compareTrees( copy, copy );
+	}
+
+	void orderedTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "BplusTreeTest::orderedTest" );
+		TestScope scope( "orderedTest" );
+
+		typedef BplusTree<int, FixedComparator<int>, 4>	MyTree;
+		const int	numItems = 1000;
+		MyTree		ascending, descending;
+
+		for( int i=0; i<numItems; ++i )
+		{
+			ascending.addElement( i );
+			descending.addElement( numItems-i-1 );
+		}
+		size_t	depth;
+		UT_ASSERT_TRUE( ascending.test( &depth ) );
+		UT_ASSERT_TRUE( descending.test( &depth ) );
+		UT_ASSERT_EQUAL( ascending, descending );
+		UT_ASSERT_EQUAL( *ascending.getFirst(), 0 );
+		UT_ASSERT_EQUAL( *ascending.getLast(), numItems-1 );
+
+		int	expected = numItems-1;
+		for(
+			MyTree::const_reverse_iterator it = ascending.crbegin(), endIT = ascending.crend();
+			it != endIT;
+			++it, --expected
+		)
+		{
+			UT_ASSERT_EQUAL( *it, expected );
+		}
+		UT_ASSERT_EQUAL( expected, -1 );
+
+		MyTree::const_iterator	it = ascending.cbegin();
+		++it;
+		++it;
+		--it;
+		UT_ASSERT_EQUAL( *it, 1 );
+
+		for( int i=0; i<numItems; i+=2 )
+		{
+			descending.removeElement( i );
+		}
+		UT_ASSERT_TRUE( descending.test( &depth ) );
+		UT_ASSERT_EQUAL( descending.size(), size_t(numItems/2) );
+		UT_ASSERT_EQUAL( descending.getElementAt( 10 ), 21 );
+		UT_ASSERT_EQUAL( descending.findIndex( 21 ), size_t(10) );
+		UT_ASSERT_EQUAL( descending.findIndex( 20 ), Container::no_index );
+
+		std::stringstream	stream;
+		descending.toBinaryStream( stream );
+		MyTree	restored;
+		restored.fromBinaryStream( stream );
+		UT_ASSERT_TRUE( restored.test( &depth ) );
+		UT_ASSERT_EQUAL( restored, descending );
+
+		MyTree	moved;
+		moveAssign( moved, restored );
+		UT_ASSERT_EQUAL( restored.size(), size_t(0) );
+		UT_ASSERT_EQUAL( moved, descending );
+	}
+
+	void stringTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "BplusTreeTest::stringTest" );
+		TestScope scope( "stringTest" );
+
+		BplusTree<STRING>	container;
+		container.addElement( "Martin" );
+		container.addElement( "Gckler" );
+		container.addElement( "Linz" );
+		STRING	&found = container.addElement( "Linz" );
+
+		UT_ASSERT_EQUAL( found, STRING("Linz") );
+		UT_ASSERT_EQUAL( container.size(), size_t(3) );
+		UT_ASSERT_EQUAL( container.getElementAt( 0 ), STRING("Gckler") );
+		UT_ASSERT_EQUAL( container.getElementAt( 2 ), STRING("Martin") );
+		UT_ASSERT_TRUE( container.findElement( "Hofmannsthalweg" ) == nullptr );
+		UT_ASSERT_EQUAL( *container.findElement( "Martin" ), STRING("Martin") );
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "BplusTreeTest::PerformTest" );
+		TestScope scope( "PerformTest" );
+
+		orderedTest();
+		stringTest();
+		{
+			TestScope scope( "<4>" );
+			randomTest<4>( 2000 );
+		}
+		{
+			TestScope scope( "<5>" );
+			randomTest<5>( 2000 );
+		}
+		{
+			TestScope scope( "<32>" );
+			randomTest<32>( 10000 );
+		}
+	}
+	virtual bool canStressTest()
+	{
+		return true;
+	}
+	virtual void StressTest( size_t factor )
+	{
+		TestScope scope( "<32>" );
+		randomTest<32>( factor*10240 );
+	}
+	virtual bool canThreadTest()
+	{
+		return true;
+	}
+	virtual UnitTest *duplicate()
+	{
+		return new BplusTreeTest( false );
+	}
+	public:
+	BplusTreeTest( bool isStatic=true ) : UnitTest( isStatic ) {}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static BplusTreeTest myBplusTreeTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
@@ -0,0 +1,376 @@
+/*
+		Project:		GAKLIB
+		Module:			CompactGraphTest.h
+		Description:	Tests the compact graph
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <cstring>
+#include <gak/unitTest.h>
+
+#include <gak/arrayFile.h>
+#include <gak/compactGraph.h>
+#include <gak/routing.h>
+#include <gak/tmpfile.h>
+
+#include "mvv.h"
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	getLinkCost and getEstimatedCost for the test graphs are specialized in
+	RoutingTest.h, createGrid uses link keys with gaps
+*/
+class CompactGraphTest : public UnitTest
+{
+	typedef CompactGraph<double, double, size_t, size_t>		CompactGrid;
+	typedef CompactGraph<Station, Connection>					CompactMvv;
+
+	virtual const char *GetClassName() const
+	{
+		return "CompactGraphTest";
+	}
+
+	/*
+		the compact graph must contain the same nodes and links as the source
+	*/
+	template <typename GraphT, typename CompactT>
+	void checkGraph( const GraphT &graph, const CompactT &compact )
+	{
+		typedef typename GraphT::node_container_type	node_container_type;
+		typedef typename GraphT::link_key_types			link_key_types;
+
+		const node_container_type	&nodes = graph.getNodes();
+		size_t						numLinks = 0;
+
+		UT_ASSERT_EQUAL( compact.getNumNodes(), graph.getNumNodes() );
+		for(
+			typename node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+			it != endIT;
+			++it
+		)
+		{
+			uint32	nodeID = compact.getNodeIndex( it->getKey() );
+			UT_ASSERT_EQUAL( compact.getNodeKey( nodeID ), it->getKey() );
+
+			// the order of the outgoing links is kept
+			typename CompactT::outgoing_links					outgoing = compact.getOutgoing( nodeID );
+			typename CompactT::outgoing_links::const_iterator	linkIT = outgoing.cbegin();
+			const link_key_types	&sourceLinks = it->getValue().m_outgoing;
+			for( size_t i=0; i<sourceLinks.size(); ++i )
+			{
+				const typename GraphT::LinkInfo	&linkInfo = graph.getLinkInfo( sourceLinks[i] );
+				if( !graph.hasNode( linkInfo.m_endNodeID ) )
+				{
+/*^*/				continue;
+				}
+				UT_ASSERT_TRUE( linkIT != outgoing.cend() );
+				uint32	linkID = *linkIT;
+				UT_ASSERT_EQUAL( compact.getLinkIndex( sourceLinks[i] ), linkID );
+				UT_ASSERT_EQUAL( compact.getLinkKey( linkID ), sourceLinks[i] );
+				UT_ASSERT_EQUAL( compact.getLinkStart( linkID ), nodeID );
+				UT_ASSERT_EQUAL( compact.getNodeKey( compact.getLinkEnd( linkID ) ), linkInfo.m_endNodeID );
+				++linkIT;
+				++numLinks;
+			}
+			UT_ASSERT_TRUE( linkIT == outgoing.cend() );
+		}
+		UT_ASSERT_EQUAL( compact.getNumLinks(), numLinks );
+	}
+
+	/*
+		the routes must be the same as the routes in the source graph
+	*/
+	template <typename GraphT, typename CompactT, typename CostT>
+	void checkRoute(
+		const GraphT &graph, const CompactT &compact,
+		typename GraphT::node_key_type from, typename GraphT::node_key_type to, CostT costType
+	)
+	{
+		AstarRouting<GraphT>		aStar( graph );
+		AstarRouting<CompactT>		compactStar( compact );
+
+		Optional<typename Routing<GraphT>::RouteResult>	expected = aStar.route( from, to, costType );
+		Optional<typename Routing<CompactT>::RouteResult>	found = compactStar.route(
+			compact.getNodeIndex( from ), compact.getNodeIndex( to ), costType
+		);
+
+		UT_ASSERT_EQUAL( expected.isPresent(), found.isPresent() );
+		if( expected.isPresent() && found.isPresent() )
+		{
+			const typename GraphT::link_key_types	&expectedLinks = expected.get().links;
+			Array<typename GraphT::link_key_type>	links = compact.getLinkKeys( found.get().links );
+
+			UT_ASSERT_EQUAL_FLT( expected.get().cost, found.get().cost, 1e-9 );
+			UT_ASSERT_EQUAL( expectedLinks.size(), links.size() );
+			for( size_t i=0; i<links.size() && i<expectedLinks.size(); ++i )
+			{
+				UT_ASSERT_EQUAL( expectedLinks[i], links[i] );
+			}
+		}
+	}
+
+	void testMvv()
+	{
+		TestScope scope( "testMvv" );
+
+		MvvGraph	theMVV;
+		CompactMvv	compact;
+
+		theMVV.freeze( &compact );
+		UT_ASSERT_FALSE( compact.isMapped() );
+		checkGraph( theMVV, compact );
+
+		for( int from = BergAmLaim; from <= IngolstadtNord; ++from )
+		{
+			for( int to = BergAmLaim; to <= IngolstadtNord; ++to )
+			{
+				if( theMVV.hasNode( Bahnhoefe(from) ) && theMVV.hasNode( Bahnhoefe(to) ) )
+				{
+					checkRoute( theMVV, compact, Bahnhoefe(from), Bahnhoefe(to), ctBY_DISTANCE );
+					checkRoute( theMVV, compact, Bahnhoefe(from), Bahnhoefe(to), ctBY_SPEED );
+				}
+			}
+		}
+	}
+
+	void testGrid()
+	{
+		TestScope scope( "testGrid" );
+
+		const size_t	width = 30;
+		const size_t	height = 20;
+
+		GridGraph	grid;
+		CompactGrid	compact;
+
+		createGrid( &grid, width, height, 3 );
+		grid.freeze( &compact );
+		checkGraph( grid, compact );
+		UT_ASSERT_EQUAL( compact.getNumLinks(), grid.getNumLinks() );
+
+		UT_ASSERT_EXCEPTION( compact.getNodeIndex( width*height ), NodeNotFoundError );
+		UT_ASSERT_EXCEPTION( compact.getLinkIndex( 1 ), LinkNotFoundError );
+		UT_ASSERT_EXCEPTION( compact.getNode( uint32(width*height) ), NodeNotFoundError );
+		UT_ASSERT_EXCEPTION( compact.getLink( uint32(compact.getNumLinks()) ), LinkNotFoundError );
+
+		for( size_t from = 0; from < width*height; from += 7 )
+		{
+			for( size_t to = 0; to < width*height; to += 11 )
+			{
+				checkRoute( grid, compact, from, to, true );
+			}
+		}
+
+		// the mapped file must contain the same graph
+		TempFileName	fileName( false );
+		CompactGrid		mapped;
+
+		compact.writeToFile( fileName );
+		mapped.open( fileName );
+		UT_ASSERT_TRUE( mapped.isMapped() );
+		UT_ASSERT_EQUAL( mapped.getDataSize(), compact.getDataSize() );
+		UT_ASSERT_EQUAL( 0, std::memcmp( mapped.getData(), compact.getData(), compact.getDataSize() ) );
+		checkGraph( grid, mapped );
+		for( size_t from = 3; from < width*height; from += 13 )
+		{
+			checkRoute( grid, mapped, from, width*height - 1 - from, true );
+		}
+
+		// a file of another graph type must be rejected
+		CompactGraph<float, double, size_t, size_t>	wrongType;
+		UT_ASSERT_EXCEPTION( wrongType.open( fileName ), BadHeaderError );
+
+		// a file with a corrupted end node must be rejected, the end nodes are followed by the links
+		const size_t	numLinks = compact.getNumLinks();
+		const size_t	endsSize = (numLinks*sizeof(uint32) + 7) & ~size_t(7);
+		ArrayOfData		corrupted;
+		TempFileName	corruptedName( false );
+
+		readFromFile( &corrupted, fileName );
+		uint32	*linkEnds = reinterpret_cast<uint32 *>(
+			corrupted.getDataBuffer() + corrupted.size() - numLinks*sizeof(double) - endsSize
+		);
+		UT_ASSERT_EQUAL( linkEnds[numLinks-1], compact.getLinkEnd( uint32(numLinks-1) ) );
+		linkEnds[numLinks-1] = uint32(compact.getNumNodes());
+		writeToFile( corrupted, corruptedName );
+		UT_ASSERT_EXCEPTION( mapped.open( corruptedName ), BadHeaderError );
+
+		mapped.clear();
+		UT_ASSERT_FALSE( mapped.isMapped() );
+		UT_ASSERT_EQUAL( mapped.getNumNodes(), size_t(0) );
+		UT_ASSERT_EQUAL( mapped.getNumLinks(), size_t(0) );
+
+		// a link to a node that does not exist is skipped
+		grid.addLink( 1, 1, 0, width*height );
+		grid.freeze( &compact );
+		checkGraph( grid, compact );
+		UT_ASSERT_EQUAL( compact.getNumLinks(), grid.getNumLinks()-1 );
+	}
+
+	/*
+		RecursiveRouting uses the link container of the graph
+	*/
+	void testRecursive()
+	{
+		TestScope scope( "testRecursive" );
+
+		GridGraph	grid;
+		CompactGrid	compact;
+
+		createGrid( &grid, 4, 3, 3 );
+		grid.freeze( &compact );
+
+		RecursiveRouting<GridGraph>		routing( grid );
+		RecursiveRouting<CompactGrid>	compactRouting( compact );
+		for( size_t from = 0; from < 12; ++from )
+		{
+			size_t	to = 11 - from;
+			Routing<GridGraph>::RouteResult	expected = routing.route( from, to, true ).get();
+			Routing<CompactGrid>::RouteResult	found = compactRouting.route(
+				compact.getNodeIndex( from ), compact.getNodeIndex( to ), true
+			).get();
+
+			UT_ASSERT_EQUAL_FLT( expected.cost, found.cost, 1e-9 );
+			UT_ASSERT_EQUAL( compact.getNodes( found.links ).size(), grid.getNodes( expected.links ).size() );
+		}
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "CompactGraphTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		testMvv();
+		testGrid();
+		testRecursive();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static CompactGraphTest myCompactGraphTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
@@ -44,6 +44,7 @@
 #include <gak/sortedArray.h>
 #include <gak/set.h>
 #include <gak/list.h>
+#include <gak/bplusTree.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -166,6 +167,7 @@ class ContainerTest : public gak::UnitTest
 		Array<STRING>									arrayString;
 		Btree<STRING>									sBtreeString;
 		Btree<btreeItem, DynamicComparator<btreeItem> >	btreeString;
+		BplusTree<STRING>								bplusTreeString;
 		SortedArray<STRING>								sortedString;
 		gak::Set<STRING>								setString;
 		UnorderedSet<STRING>							setXString;
@@ -183,6 +185,10 @@ class ContainerTest : public gak::UnitTest
 			TestScope scope("Btree<btreeItem, DynamicComparator<btreeItem> >");
 			testContainer( btreeString, makeString, true );
 		}
+		{
+			TestScope scope("BplusTree<STRING>");
+			testContainer( bplusTreeString, makeString, true );
+		}
 		{
 			TestScope scope("SortedArray<STRING>");
 			testContainer( sortedString, makeString, false );
@@ -278,6 +284,10 @@ class ContainerTest : public gak::UnitTest
 			TestScope scope("Btree<int>");
 			testSetOperations< Btree<int> >();
 		}
+		{
+			TestScope scope("BplusTree<int>");
+			testSetOperations< BplusTree<int> >();
+		}
 		{
 			TestScope scope("Map< KeyValuePair<int,int> >");
 			testSetOperations< Map< KeyValuePair<int,int> > >();
@@ -299,6 +309,7 @@ class ContainerTest : public gak::UnitTest
 			testIntSetOperations< SortedArray<int> >();
 			testIntSetOperations< gak::Set<int> >();
 			testIntSetOperations< Btree<int> >();
+			testIntSetOperations< BplusTree<int> >();
 
 			testFindElement< Array<int> >();
 			testFindElement< SortedArray<int> >();
@@ -312,6 +323,10 @@ class ContainerTest : public gak::UnitTest
 			TestScope scope("Btree<int>");
 			testGetRange< Btree<int> >(true);
 		}
+		{
+			TestScope scope("BplusTree<int>");
+			testGetRange< BplusTree<int> >(true);
+		}
 		{
 			Array<STRING> arrayString2;
 			arrayString.addElement("Hello");
@@ -0,0 +1,315 @@
+/*
+		Project:		GAKLIB
+		Module:			ContractionHierarchyTest.h
+		Description:	Tests the contraction hierarchy
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <gak/unitTest.h>
+
+#include <gak/contractionHierarchy.h>
+#include <gak/stopWatch.h>
+#include <gak/tmpfile.h>
+
+#include "mvv.h"
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+/*
+	getLinkCost and getEstimatedCost for the test graphs are specialized in
+	RoutingTest.h. The estimation for ctBY_SPEED overestimates some routes,
+	thus the results are checked with AstarRouting without estimation, i.e.
+	Dijkstra's algorithm.
+*/
+struct DijkstraCost
+{
+	CostType	costType;
+
+	DijkstraCost( CostType costType ) : costType( costType )
+	{
+	}
+};
+
+template <>
+double getLinkCost( const Connection &link, DijkstraCost cost )
+{
+	return getLinkCost( link, cost.costType );
+}
+
+class ContractionHierarchyTest : public UnitTest
+{
+
+	virtual const char *GetClassName() const
+	{
+		return "ContractionHierarchyTest";
+	}
+
+	template <typename GraphT, typename CostT>
+	void checkRoute(
+		const GraphT &graph, const ContractionHierarchy<GraphT> &hierarchy,
+		typename GraphT::node_key_type from, typename GraphT::node_key_type to, CostT costType
+	)
+	{
+		typedef typename GraphT::link_key_types	link_key_types;
+
+		AstarRouting<GraphT>	aStar( graph );
+		Optional<typename Routing<GraphT>::RouteResult>	expected = aStar.route( from, to, costType );
+		Optional<typename Routing<GraphT>::RouteResult>	found = hierarchy.route( from, to );
+
+		UT_ASSERT_EQUAL( expected.isPresent(), found.isPresent() );
+		if( expected.isPresent() && found.isPresent() )
+		{
+			const link_key_types	&links = found.get().links;
+
+			UT_ASSERT_EQUAL_FLT( expected.get().cost, found.get().cost, 1e-9 );
+
+			// the links must be a path from the start to the destination
+			double	cost = 0;
+			for( size_t i=0; i<links.size(); ++i )
+			{
+				cost += getLinkCost( graph.getLink( links[i] ), costType );
+			}
+			UT_ASSERT_EQUAL_FLT( found.get().cost, cost, 1e-9 );
+			if( links.size() )
+			{
+				Array<typename GraphT::node_key_type> nodes = graph.getNodes( links );
+				UT_ASSERT_EQUAL( nodes[0], from );
+				UT_ASSERT_EQUAL( nodes[nodes.size()-1], to );
+			}
+			else
+			{
+				UT_ASSERT_EQUAL( from, to );
+			}
+		}
+	}
+
+	void testMvv( const MvvGraph &theMVV, CostType costType )
+	{
+		ContractionHierarchy<MvvGraph>	hierarchy;
+
+		hierarchy.build( theMVV, costType );
+		UT_ASSERT_EQUAL( hierarchy.getNumNodes(), theMVV.getNumNodes() );
+		UT_ASSERT_LESSEQ( hierarchy.getNumLinks(), theMVV.getNumLinks() );
+
+		for( int from = BergAmLaim; from <= IngolstadtNord; ++from )
+		{
+			for( int to = BergAmLaim; to <= IngolstadtNord; ++to )
+			{
+				if( theMVV.hasNode( Bahnhoefe(from) ) && theMVV.hasNode( Bahnhoefe(to) ) )
+				{
+					checkRoute( theMVV, hierarchy, Bahnhoefe(from), Bahnhoefe(to), DijkstraCost( costType ) );
+				}
+			}
+		}
+	}
+
+	void testGrid()
+	{
+		TestScope scope( "testGrid" );
+
+		const size_t	width = 30;
+		const size_t	height = 20;
+
+		GridGraph						grid;
+		ContractionHierarchy<GridGraph>	hierarchy;
+
+		createGrid( &grid, width, height );
+
+		StopWatch	buildTime( true );
+		hierarchy.build( grid, true );
+		buildTime.stop();
+		std::cout << "Contraction: " << buildTime.get< Seconds<clock_t> >().toString()
+			<< ' ' << hierarchy.getNumShortcuts() << " shortcuts" << std::endl;
+
+		UT_ASSERT_EQUAL( hierarchy.getNumNodes(), width*height );
+		UT_ASSERT_EQUAL( hierarchy.getNumLinks(), grid.getNumLinks() );
+
+		for( size_t from = 0; from < width*height; from += 7 )
+		{
+			for( size_t to = 0; to < width*height; to += 11 )
+			{
+				checkRoute( grid, hierarchy, from, to, true );
+			}
+		}
+		UT_ASSERT_EXCEPTION( hierarchy.route( 0, width*height ), NodeNotFoundError );
+
+		// the hierarchy read from the file must find the same routes
+		TempFileName					fileName( false );
+		ContractionHierarchy<GridGraph>	loaded;
+
+		hierarchy.writeToFile( fileName );
+		loaded.readFromFile( fileName );
+		UT_ASSERT_EQUAL( loaded.getNumNodes(), hierarchy.getNumNodes() );
+		UT_ASSERT_EQUAL( loaded.getNumShortcuts(), hierarchy.getNumShortcuts() );
+		for( size_t from = 3; from < width*height; from += 13 )
+		{
+			size_t	to = width*height - 1 - from;
+			checkRoute( grid, loaded, from, to, true );
+
+			GridGraph::link_key_types	links = loaded.route( from, to ).get().links;
+			GridGraph::link_key_types	expected = hierarchy.route( from, to ).get().links;
+			UT_ASSERT_EQUAL( links.size(), expected.size() );
+			for( size_t i=0; i<links.size() && i<expected.size(); ++i )
+			{
+				UT_ASSERT_EQUAL( links[i], expected[i] );
+			}
+		}
+
+		// a corrupted edge index is detected when reading
+		ArrayOfData		buffer;
+		oBinaryStream	ostream( buffer );
+		hierarchy.toBinaryStream( ostream );
+		ostream.flush();
+		UT_ASSERT_GREATER( buffer.size(), sizeof(uint32) );
+		memset( buffer.getDataBuffer() + buffer.size() - sizeof(uint32), 0xFF, sizeof(uint32) );
+
+		ContractionHierarchy<GridGraph>	corrupted;
+		iBinaryStream					istream( buffer );
+		UT_ASSERT_EXCEPTION( corrupted.fromBinaryStream( istream ), ReadError );
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "ContractionHierarchyTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		MvvGraph	theMVV;
+		{
+			TestScope scope( "ctBY_DISTANCE" );
+			testMvv( theMVV, ctBY_DISTANCE );
+		}
+		{
+			TestScope scope( "ctBY_SPEED" );
+			testMvv( theMVV, ctBY_SPEED );
+		}
+		testGrid();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static ContractionHierarchyTest myContractionHierarchyTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
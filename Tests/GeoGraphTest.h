@@ -136,6 +136,12 @@ class GeoGraphTest : public UnitTest
 			&theSmallMVV 
 		);
 		UT_ASSERT_TRUE( theSmallMVV.hasElement( Marienplatz_S ) );
+
+		const math::GeoPosition<double> &ostbahnhof = theMVV.getNode( Ostbahnhof_U ).getPosition();
+		Optional<Bahnhoefe>	next = theMVV.findNextNode( ostbahnhof, 0.01, UBAHN_LAYER );
+		UT_ASSERT_TRUE( next.isPresent() );
+		UT_ASSERT_EQUAL( next.get(), Ostbahnhof_U );
+		UT_ASSERT_FALSE( theMVV.findNextNode( ostbahnhof, 0.01, short(100) ).isPresent() );
 	}
 };
 
@@ -0,0 +1,368 @@
+/*
+		Project:		GAKLIB
+		Module:			HashMapTest.h
+		Description:	test of the hash maps and sets
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <sstream>
+
+#include <gak/unitTest.h>
+#include <gak/btree.h>
+#include <gak/map.h>
+#include <gak/hashMap.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class HashMapTest : public UnitTest
+{
+	virtual const char *GetClassName() const
+	{
+		return "HashMapTest";
+	}
+
+	template <typename ContainerT>
+	void compareSets( const ContainerT &container, const Btree<int> &reference )
+	{
+		UT_ASSERT_TRUE( container.test() );
+		UT_ASSERT_EQUAL( container.size(), reference.size() );
+
+		for(
+			Btree<int>::const_iterator it = reference.cbegin(), endIT = reference.cend();
+			it != endIT;
+			++it
+		)
+		{
+			size_t	index = container.findElement( *it );
+			UT_ASSERT_LESS( index, container.size() );
+			UT_ASSERT_EQUAL( container.getElementAt( index ), *it );
+		}
+		for(
+			typename ContainerT::const_iterator it = container.cbegin(), endIT = container.cend();
+			it != endIT;
+			++it
+		)
+		{
+			UT_ASSERT_TRUE( reference.hasElement( *it ) );
+		}
+	}
+
+	void randomTest( size_t numItems )
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "HashMapTest::randomTest" );
+
+		HashSet<int>	container;
+		Btree<int>		reference;
+
+		const int maxValue = int(numItems * 2);
+		for( size_t i=0; i<numItems; ++i )
+		{
+			int		value = randomNumber( maxValue );
+			bool	found = reference.hasElement( value );
+
+			UT_ASSERT_EQUAL( container.hasElement( value ), found );
+			const int &added = container.addElement( value );
+			UT_ASSERT_EQUAL( added, value );
+			reference.addElement( value );
+		}
+		compareSets( container, reference );
+
+		HashSet<int>	copy = container;
+		compareSets( copy, reference );
+
+		for( size_t i=0; i<numItems; ++i )
+		{
+			int value = randomNumber( maxValue );
+			container.removeElement( value );
+			reference.removeElement( value );
+			UT_ASSERT_FALSE( container.hasElement( value ) );
+			UT_ASSERT_EQUAL( container.findElement( value ), container.no_index );
+		}
+		compareSets( container, reference );
+
+		// insert again after removal: deleted slots must be reused
+		for( size_t i=0; i<numItems; ++i )
+		{
+			int value = randomNumber( maxValue );
+			container.addElement( value );
+			reference.addElement( value );
+		}
+		compareSets( container, reference );
+
+		HashSet<int>	moved;
+		moveAssign( moved, container );
+		UT_ASSERT_EQUAL( container.size(), size_t(0) );
+		UT_ASSERT_FALSE( container.hasElement( reference.getElementAt( 0 ) ) );
+		compareSets( moved, reference );
+
+		while( moved.size() )
+		{
+			moved.removeElementAt( 0 );
+			UT_ASSERT_TRUE( moved.test() );
+		}
+		UT_ASSERT_FALSE( moved.hasElement( reference.getElementAt( 0 ) ) );
+
+		// the copy must not be affected
+		UT_ASSERT_TRUE( copy.test() );
+		UT_ASSERT_GREATER( copy.size(), size_t(0) );
+	}
+
+	void mapTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "HashMapTest::mapTest" );
+		TestScope scope( "mapTest" );
+
+		HashMap<STRING, int>	container;
+		PairMap<STRING, int>	reference;
+
+		for( int i=0; i<1000; ++i )
+		{
+			STRING	key = formatNumber( randomNumber( 500 ) );
+			container[key] += i;
+			reference[key] += i;
+		}
+		UT_ASSERT_TRUE( container.test() );
+		UT_ASSERT_EQUAL( container.size(), reference.size() );
+		for( size_t i=0; i<container.size(); ++i )
+		{
+			const STRING &key = container.getKeyAt( i );
+			UT_ASSERT_EQUAL( container.getElementIndex( key ), i );
+			UT_ASSERT_EQUAL( container.getValueAt( i ), reference[key] );
+		}
+
+		// remove all odd values the same way the indexer does
+		for( size_t i=0; i<container.size(); ++i )
+		{
+			if( container.getValueAt( i ) & 1 )
+			{
+				reference.removeElementByKey( container.getKeyAt( i ) );
+				container.removeElementAt( i );
+				--i;
+			}
+		}
+		UT_ASSERT_TRUE( container.test() );
+		UT_ASSERT_EQUAL( container.size(), reference.size() );
+
+		// HashMap can read the files of a PairMap
+		std::stringstream	stream;
+		reference.toBinaryStream( stream );
+		HashMap<STRING, int>	loaded;
+		loaded.fromBinaryStream( stream );
+		UT_ASSERT_TRUE( loaded.test() );
+		UT_ASSERT_EQUAL( loaded.size(), reference.size() );
+		for( size_t i=0; i<reference.size(); ++i )
+		{
+			const STRING &key = reference.getKeyAt( i );
+			UT_ASSERT_EQUAL( loaded[key], reference.getValueAt( i ) );
+		}
+
+		stream.str( "" );
+		stream.clear();
+		container.toBinaryStream( stream );
+		stream.seekg( 0 );
+		HashMap<STRING, int>	reloaded;
+		reloaded.fromBinaryStream( stream );
+		UT_ASSERT_TRUE( reloaded.test() );
+		UT_ASSERT_EQUAL( reloaded.size(), reference.size() );
+		for( size_t i=0; i<reference.size(); ++i )
+		{
+			const STRING &key = reference.getKeyAt( i );
+			UT_ASSERT_TRUE( reloaded.hasElement( key ) );
+			UT_ASSERT_EQUAL( reloaded[key], reference.getValueAt( i ) );
+		}
+
+		const HashMap<STRING, int>	&constMap = reloaded;
+		UT_ASSERT_EXCEPTION( constMap["not found"], IndexError );
+	}
+
+	void stringTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "HashMapTest::stringTest" );
+		TestScope scope( "stringTest" );
+
+		HashMap<CI_STRING, int>	ciMap;
+		ciMap["Hello World"] = 1;
+		ciMap["HELLO WORLD"] += 1;
+		ciMap["hello world"] += 1;
+		UT_ASSERT_EQUAL( ciMap.size(), size_t(1) );
+		UT_ASSERT_EQUAL( ciMap["hELLO wORLD"], 3 );
+
+		HashMap<STRING, int>	map;
+		map["Hello World"] = 1;
+		map["HELLO WORLD"] = 2;
+		UT_ASSERT_EQUAL( map.size(), size_t(2) );
+
+		// equal strings with different character sets must have the same hash
+		STRING	latin1( "M\xFC" "nchen" );
+		latin1.setCharSet( STR_ANSI );
+		STRING	utf8 = latin1.convertToCharset( STR_UTF8 );
+		UT_ASSERT_EQUAL( latin1, utf8 );
+		UT_ASSERT_EQUAL( hashValue( latin1 ), hashValue( utf8 ) );
+
+		map[latin1] = 3;
+		UT_ASSERT_TRUE( map.hasElement( utf8 ) );
+		UT_ASSERT_EQUAL( map.findValue( 3 ), latin1 );
+
+		HashSet<STRING>	set;
+		set += "a";
+		set += "b";
+		set += "a";
+		UT_ASSERT_EQUAL( set.size(), size_t(2) );
+		UT_ASSERT_TRUE( set.hasElement( "b" ) );
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "HashMapTest::PerformTest" );
+		TestScope scope( "PerformTest" );
+
+		randomTest( 10000 );
+		mapTest();
+		stringTest();
+	}
+	virtual bool canStressTest()
+	{
+		return true;
+	}
+	virtual void StressTest( size_t factor )
+	{
+		randomTest( factor*10240 );
+	}
+	virtual bool canThreadTest()
+	{
+		return true;
+	}
+	virtual UnitTest *duplicate()
+	{
+		return new HashMapTest( false );
+	}
+	public:
+	HashMapTest( bool isStatic=true ) : UnitTest( isStatic ) {}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static HashMapTest myHashMapTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
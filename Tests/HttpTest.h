@@ -43,6 +43,8 @@
 
 #include <gak/http.h>
 #include <gak/httpBaseServer.h>
+#include <gak/httpProfiler.h>
+#include <gak/t_string.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -89,6 +91,24 @@ class TestWebServer : public HTTPserverBase
 	virtual int handleGetRequest( const STRING &url );
 };
 
+class TestFileServer : public HTTPserverBase
+{
+	private:
+	virtual int handleGetRequest( const STRING &url );
+};
+
+class TestEchoServer : public ServerProcessorBase
+{
+	private:
+	virtual void runServerThread();
+
+	public:
+	static bool isRequestComplete( const char *data, size_t size )
+	{
+		return memchr( data, '\n', size ) != nullptr;
+	}
+};
+
 class HttpTest : public UnitTest
 {
 	virtual const char *GetClassName() const
@@ -174,10 +194,314 @@ class HttpTest : public UnitTest
 			}
 		}
 	}
+	void ReactorTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::ReactorTest");
+		TestScope scope( "ReactorTest" );
+
+		if( !SocketReactor::isAvailable() )
+		{
+/*@*/		return;
+		}
+
+		const size_t			NUM_CLIENTS = 20;
+		SocketServer<TestEchoServer>	echoServer;
+		SocketServer<TestWebServer>		webServer;
+
+		// one worker, only: the idle connections must not block it
+		echoServer.startServer( 6667, 1, 2 );
+		webServer.startServer( 6668, 1, 1 );
+		Sleep( 1000 );
+		STRING	socketError = echoServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+		socketError = webServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+
+		{
+			SocketStreambuf	clients[NUM_CLIENTS];
+
+			for( size_t i=0; i<NUM_CLIENTS; ++i )
+			{
+				UT_ASSERT_EQUAL( 0, clients[i].connect( "localhost", 6667 ) );
+			}
+
+			// each connection sends two requests, the last client first
+			for( size_t request=0; request<2; ++request )
+			{
+				for( size_t i=NUM_CLIENTS; i--; )
+				{
+					STRING	line = "request " + formatNumber( request ) + " of " + formatNumber( i );
+					STRING	message = line + '\n';
+
+					UT_ASSERT_EQUAL( 0, clients[i].sendData( message, message.strlen() ) );
+					UT_ASSERT_EQUAL( line, clients[i].getNextLine() );
+				}
+			}
+		}
+
+		HTTPrequest	myClient;
+		STRING	   	url = "http://localhost:6668/" __FILE__;
+
+		myClient.Get( url );
+		int status = myClient.getHttpResponse().getStatusCode();
+		UT_ASSERT_EQUAL( status, 200 );
+		size_t size = myClient.getHttpResponse().getContentLength();
+		UT_ASSERT_EQUAL( size, s_serverResult.size() );
+
+		echoServer.stopServer( false );
+		webServer.stopServer( false );
+	}
+	static int readResponse( SocketStreambuf &client, FieldSet *header, ArrayOfData *body )
+	{
+		T_STRING	line = client.getNextLine();
+		if( line.isEmpty() )
+		{
+/*@*/		return 0;
+		}
+
+		line.getFirstToken( " " );
+		int status = getValue<int>( line.getNextToken() );
+
+		header->clear();
+		while( !(line = client.getNextLine()).isEmpty() )
+		{
+			size_t colonPos = line.searchChar( ':' );
+			(*header)[line.leftString( colonPos )] = line.subString( colonPos+1 ).stripBlanks();
+		}
+
+		size_t contentLength = getValue<size_t>( STRING((*header)["Content-Length"]) );
+		body->clear();
+		for( size_t i=0; i<contentLength; ++i )
+		{
+			int c = client.getNextByte();
+			if( c < 0 )
+			{
+/*@*/			return 0;
+			}
+			*body += char(c);
+		}
+		return status;
+	}
+	void KeepAliveTest( unsigned short port, size_t numEventThreads )
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::KeepAliveTest");
+		TestScope scope( "KeepAliveTest" );
+
+		SocketServer<TestWebServer>	webServer;
+
+		// the third request closes the connection
+		webServer.setKeepAlive( 5, 3 );
+		webServer.startServer( port, 1, numEventThreads );
+		Sleep( 1000 );
+		STRING	socketError = webServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+
+		SocketStreambuf	client;
+		UT_ASSERT_EQUAL( 0, client.connect( "localhost", port ) );
+
+		const size_t	fileSize = size_t(DirectoryEntry( __FILE__ ).fileSize);
+		STRING			request = "GET /" __FILE__ " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+		STRING			pipeline = request + request;
+		FieldSet		header;
+		ArrayOfData		body;
+
+		// two pipelined requests
+		UT_ASSERT_EQUAL( 0, client.sendData( pipeline, pipeline.strlen() ) );
+		for( size_t i=0; i<2; ++i )
+		{
+			UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+			UT_ASSERT_EQUAL( fileSize, body.size() );
+			UT_ASSERT_EQUAL( STRING("keep-alive"), STRING(header["Connection"]) );
+		}
+
+		// the same connection after the idle time of the client
+		Sleep( 100 );
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( fileSize, body.size() );
+		UT_ASSERT_EQUAL( STRING("close"), STRING(header["Connection"]) );
+		UT_ASSERT_EQUAL( EMPTY_STRING, client.getNextLine() );
+		client.disconnect();
+
+		// a HTTP/1.0 client
+		UT_ASSERT_EQUAL( 0, client.connect( "localhost", port ) );
+		request = "GET /ping HTTP/1.0\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( STRING("close"), STRING(header["Connection"]) );
+		client.disconnect();
+
+		webServer.stopServer( false );
+	}
+	/*
+		without a reactor an idle connection would block the only worker
+	*/
+	void DefaultKeepAliveTest( unsigned short port, size_t numEventThreads )
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::DefaultKeepAliveTest");
+		TestScope scope( "DefaultKeepAliveTest" );
+
+		SocketServer<TestWebServer>	webServer;
+
+		webServer.startServer( port, 1, numEventThreads );
+		Sleep( 1000 );
+		STRING	socketError = webServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+
+		SocketStreambuf	client;
+		STRING			request = "GET /ping HTTP/1.1\r\nHost: localhost\r\n\r\n";
+		FieldSet		header;
+		ArrayOfData		body;
+
+		UT_ASSERT_EQUAL( 0, client.connect( "localhost", port ) );
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL(
+			STRING(numEventThreads && SocketReactor::isAvailable() ? "keep-alive" : "close"),
+			STRING(header["Connection"])
+		);
+		client.disconnect();
+
+		webServer.stopServer( false );
+	}
+	void StaticFileTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::StaticFileTest");
+		TestScope scope( "StaticFileTest" );
+
+		SocketServer<TestFileServer>	fileServer;
+
+		// all requests use the same connection
+		fileServer.setKeepAlive( KEEP_ALIVE_TIMEOUT );
+		fileServer.startServer( 6673, 1 );
+		Sleep( 1000 );
+		STRING	socketError = fileServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+
+		ArrayOfData	file;
+		readFromFile( &file, __FILE__ );
+
+		const STRING	fileSize = formatNumber( file.size() );
+		const STRING	get = "GET /" __FILE__ " HTTP/1.1\r\nHost: localhost\r\n";
+		HTTPfileCache	&cache = HTTPserverBase::getFileCache();
+		SocketStreambuf	client;
+		FieldSet		header;
+		ArrayOfData		body;
+		STRING			request;
+
+		UT_ASSERT_EQUAL( 0, client.connect( "localhost", 6673 ) );
+
+		// the first request with sendfile, the second one from the cache
+		for( size_t maxFileSize = 0; maxFileSize <= HTTP_CACHE_FILE_SIZE; maxFileSize += HTTP_CACHE_FILE_SIZE )
+		{
+			cache.setLimits( HTTP_CACHE_SIZE, maxFileSize );
+			request = get + "\r\n";
+			UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+			UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+			UT_ASSERT_EQUAL( file.size(), body.size() );
+			UT_ASSERT_EQUAL( 0, memcmp( file.getDataBuffer(), body.getDataBuffer(), file.size() ) );
+			UT_ASSERT_EQUAL( STRING("bytes"), STRING(header["Accept-Ranges"]) );
+		}
+		UT_ASSERT_EQUAL( size_t(1), cache.getNumFiles() );
+		UT_ASSERT_EQUAL( file.size(), cache.getSize() );
+
+		const STRING	eTag = header["ETag"];
+		const STRING	lastModified = header["Last-Modified"];
+
+		// byte ranges
+		request = get + "Range: bytes=10-19\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 206, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( "bytes 10-19/" + fileSize, STRING(header["Content-Range"]) );
+		UT_ASSERT_EQUAL( size_t(10), body.size() );
+		UT_ASSERT_EQUAL( 0, memcmp( file.getDataBuffer()+10, body.getDataBuffer(), 10 ) );
+
+		cache.clear();
+		request = get + "Range: bytes=-5\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 206, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( size_t(5), body.size() );
+		UT_ASSERT_EQUAL( 0, memcmp( file.getDataBuffer()+file.size()-5, body.getDataBuffer(), 5 ) );
+
+		request = get + "Range: bytes=" + fileSize + "-\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 416, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( "bytes */" + fileSize, STRING(header["Content-Range"]) );
+
+		// the client has the current version
+		request = get + "If-None-Match: " + eTag + "\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 304, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( size_t(0), body.size() );
+		UT_ASSERT_TRUE( STRING(header["Content-Length"]).isEmpty() );
+		UT_ASSERT_EQUAL( eTag, STRING(header["ETag"]) );
+
+		request = get + "If-Modified-Since: " + lastModified + "\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 304, readResponse( client, &header, &body ) );
+		UT_ASSERT_TRUE( STRING(header["Content-Length"]).isEmpty() );
+
+		request = get + "If-None-Match: \"0-0\"\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 200, readResponse( client, &header, &body ) );
+		UT_ASSERT_EQUAL( file.size(), body.size() );
+
+		// the parent directory is not accessible
+		request = "GET /Tests/../" __FILE__ " HTTP/1.1\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 403, readResponse( client, &header, &body ) );
+
+		request = "GET /nothing.here HTTP/1.1\r\n\r\n";
+		UT_ASSERT_EQUAL( 0, client.sendData( request, request.strlen() ) );
+		UT_ASSERT_EQUAL( 404, readResponse( client, &header, &body ) );
+
+		client.disconnect();
+		cache.setLimits( HTTP_CACHE_SIZE, HTTP_CACHE_FILE_SIZE );
+		cache.clear();
+		fileServer.stopServer( false );
+	}
+	void LoadTest( unsigned short port, size_t numEventThreads )
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::LoadTest");
+		TestScope scope( "LoadTest" );
+
+		const size_t				NUM_CLIENTS = 4;
+		const size_t				NUM_REQUESTS = 50;
+		SocketServer<TestWebServer>	webServer;
+
+		// the clients must reconnect after 20 requests
+		webServer.setKeepAlive( 5, 20 );
+		webServer.startServer( port, NUM_CLIENTS, numEventThreads );
+		Sleep( 1000 );
+		STRING	socketError = webServer.getSocketError();
+		UT_ASSERT_EQUAL( socketError, EMPTY_STRING );
+
+		HTTPloadStatistic	statistic = HTTPprofiler::loadTest(
+			"http://localhost:" + formatNumber( port ) + "/ping", NUM_CLIENTS, NUM_REQUESTS, 4
+		);
+		UT_ASSERT_EQUAL( NUM_CLIENTS*NUM_REQUESTS, statistic.numRequests );
+		UT_ASSERT_EQUAL( size_t(0), statistic.numErrors );
+		UT_ASSERT_TRUE( statistic.requestsPerSecond > 0 );
+		UT_ASSERT_TRUE( statistic.latency50 <= statistic.latency90 );
+		UT_ASSERT_TRUE( statistic.latency99 <= statistic.maxLatency );
+
+		webServer.stopServer( false );
+	}
 	virtual void PerformTest()
 	{
 		doEnterFunctionEx(gakLogging::llInfo, "HttpTest::PerformTest");
 		TestScope scope( "PerformTest" );
+		ReactorTest();
+		KeepAliveTest( 6669, 0 );
+		DefaultKeepAliveTest( 6674, 0 );
+		LoadTest( 6670, 0 );
+		if( SocketReactor::isAvailable() )
+		{
+			KeepAliveTest( 6671, 2 );
+			DefaultKeepAliveTest( 6675, 2 );
+			LoadTest( 6672, 2 );
+		}
+		StaticFileTest();
 		ClientTest();
 //		ServerTest();
 	}
@@ -234,6 +558,17 @@ int TestWebServer::handleGetRequest( const STRING &url )
 {
 	doEnterFunctionEx(gakLogging::llInfo, "TestWebServer::handleGetRequest");
 
+	if( url == "/ping" )
+	{
+		ArrayOfData	pong;
+
+		pong += "pong";
+		response.setStatusCode( 200 );
+		sendResponse( pong );
+
+/*@*/	return 0;
+	}
+
 	try
 	{
 		STRING			file = url+size_t(1);		// ignore directory delimiter
@@ -252,6 +587,25 @@ int TestWebServer::handleGetRequest( const STRING &url )
 	}
 }
 
+int TestFileServer::handleGetRequest( const STRING &url )
+{
+	doEnterFunctionEx(gakLogging::llInfo, "TestFileServer::handleGetRequest");
+
+	return sendStaticFile( url+size_t(1), "text/plain" );		// ignore directory delimiter
+}
+
+void TestEchoServer::runServerThread()
+{
+	STRING	line = getNextLine();
+
+	if( !line.isEmpty() )
+	{
+		STRING	answer = line + '\n';
+		sendData( answer, answer.strlen() );
+		setKeepAlive( true );
+	}
+}
+
 // --------------------------------------------------------------------- //
 // ----- class publics ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -0,0 +1,379 @@
+/*
+		Project:		GAKLIB
+		Module:			IndexSegmentTest.h
+		Description:	test of the index segments
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <gak/unitTest.h>
+#include <gak/indexSegment.h>
+#include <gak/tmpfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+using ai::StringIndex;
+using ai::indexString;
+using ai::Index;
+using ai::IndexSegment;
+using ai::SegmentedIndex;
+using ai::IndexMergeThread;
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class IndexSegmentTest : public UnitTest
+{
+	typedef Index<STRING>::SearchResult	SearchResult;
+
+	virtual const char *GetClassName() const
+	{
+		return "IndexSegmentTest";
+	}
+
+	static void addText( Index<STRING> *index, const char *source, const char *text )
+	{
+		SortedArray<CI_STRING>	stopWords;
+		StringIndex				positions;
+
+		indexString( STRING(text), stopWords, ai::IS_ANY, &positions );
+		index->moveIndexPositions( source, &positions );
+	}
+
+	void compareResults( const SearchResult &result, const SearchResult &expected )
+	{
+		UT_ASSERT_EQUAL( result.size(), expected.size() );
+		for(
+			SearchResult::const_iterator it = expected.cbegin(), endIT = expected.cend();
+			it != endIT;
+			++it
+		)
+		{
+			UT_ASSERT_TRUE( result.hasElement( it->getKey() ) );
+			if( result.hasElement( it->getKey() ) )
+			{
+				const ai::Positions	&positions = result[it->getKey()];
+				const ai::Positions	&expectedPositions = it->getValue();
+				UT_ASSERT_EQUAL( positions.size(), expectedPositions.size() );
+				for( size_t i=0; i<positions.size() && i<expectedPositions.size(); ++i )
+				{
+					UT_ASSERT_EQUAL( positions[i].m_start, expectedPositions[i].m_start );
+					UT_ASSERT_EQUAL( positions[i].m_len, expectedPositions[i].m_len );
+					UT_ASSERT_EQUAL( positions[i].m_flags, expectedPositions[i].m_flags );
+				}
+			}
+		}
+	}
+
+	template <typename IndexT>
+	void compareIndex( const IndexT &index, const Index<STRING> &expected )
+	{
+		static const char *queries[] =
+		{
+			"the", "of", "brown", "namespace", "class_name", "gakler",
+			"the -quick", "the +quick", "fox all", "unknown", "+unknown the"
+		};
+		for( size_t i=0; i<arraySize( queries ); ++i )
+		{
+			TestScope scope( queries[i] );
+			compareResults(
+				index.findWords( queries[i], true, true, false ),
+				expected.findWords( queries[i], true, true, false )
+			);
+		}
+
+		static const char *patterns[] = { "gakle?", "kakle?", "*ox", "th*" };
+		for( size_t i=0; i<arraySize( patterns ); ++i )
+		{
+			TestScope scope( patterns[i] );
+			compareResults(
+				index.findWords( patterns[i], true, true, true ),
+				expected.findWords( patterns[i], true, true, true )
+			);
+			compareResults(
+				index.findWords( patterns[i], false, false, true ),
+				expected.findWords( patterns[i], false, false, true )
+			);
+		}
+
+		UT_ASSERT_EQUAL(
+			index.getRelevantHits( "the", false, false, false ).size(),
+			expected.getRelevantHits( "the", false, false, false ).size()
+		);
+	}
+
+	void segmentTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "IndexSegmentTest::segmentTest" );
+		TestScope scope( "segmentTest" );
+
+		static const char *texts[][2] =
+		{
+			{ "testText1", "the quick brown fox jumps over the lazy dog" },
+			{ "testText2", "the best of the world of all brown universes namespace::class_name" },
+			{ "Gaeckler", "G\xE4" "ckler" },
+			{ "testText3", "the fox and the dog are friends of the world" },
+		};
+
+		Index<STRING>	expected, first, second;
+		for( size_t i=0; i<arraySize( texts ); ++i )
+		{
+			addText( &expected, texts[i][0], texts[i][1] );
+			addText( i < 2 ? &first : &second, texts[i][0], texts[i][1] );
+		}
+		// a source that is stored in two segments
+		addText( &expected, "testText1", "another purple elephant" );
+		addText( &second, "testText1", "another purple elephant" );
+
+		TempFileName	fullFile( true ), firstFile( true ), secondFile( true ), thirdFile( true ),
+						mergedFile( true ), merged2File( true );
+
+		ai::writeIndexSegment( expected, fullFile );
+		{
+			IndexSegment<STRING>	segment( fullFile );
+			UT_ASSERT_EQUAL( segment.size(), expected.size() );
+			UT_ASSERT_EQUAL( segment.getSources().size(), size_t(4) );
+			for( size_t i=1; i<segment.size(); ++i )
+			{
+				UT_ASSERT_LESS( strcmp( segment.getTerm( i-1 ), segment.getTerm( i ) ), 0 );
+			}
+			compareIndex( segment, expected );
+		}
+
+		ai::writeIndexSegment( first, firstFile );
+		ai::writeIndexSegment( second, secondFile );
+
+		SegmentedIndex<STRING>	segmented;
+		segmented.addSegment( firstFile );
+		segmented.addSegment( secondFile );
+		UT_ASSERT_EQUAL( segmented.getNumSegments(), size_t(2) );
+		compareIndex( segmented, expected );
+
+		IndexMergeThread<STRING>	merger( segmented, mergedFile );
+		merger.StartThread();
+		compareIndex( segmented, expected );
+		merger.join();
+
+		UT_ASSERT_TRUE( merger.isSuccess() );
+		UT_ASSERT_EQUAL( merger.getMergedFiles().size(), size_t(2) );
+		UT_ASSERT_EQUAL( segmented.getNumSegments(), size_t(1) );
+		compareIndex( segmented, expected );
+		UT_ASSERT_EQUAL( segmented.getKeys().size(), expected.size() );
+
+		// the merged segment is the same as the segment of the full index
+		IndexSegment<STRING>	full( fullFile ), merged( mergedFile );
+		UT_ASSERT_EQUAL( merged.size(), full.size() );
+		for( size_t i=0; i<merged.size() && i<full.size(); ++i )
+		{
+			UT_ASSERT_EQUAL( STRING( merged.getTerm( i ) ), STRING( full.getTerm( i ) ) );
+			UT_ASSERT_EQUAL( merged.getNumSources( i ), full.getNumSources( i ) );
+		}
+
+		// the positions of a source in different segments are combined
+		Index<STRING>	third;
+		addText( &third, "testText1", "a brown bear" );
+		ai::writeIndexSegment( third, thirdFile );
+		segmented.addSegment( thirdFile );
+		UT_ASSERT_EQUAL( segmented.getWordHits( "brown" )["testText1"].size(), size_t(2) );
+		UT_ASSERT_EQUAL( segmented.getWordHits( "bear" ).size(), size_t(1) );
+		segmented.mergeSegments( merged2File );
+		UT_ASSERT_EQUAL( segmented.getNumSegments(), size_t(1) );
+		UT_ASSERT_EQUAL( segmented.getWordHits( "brown" )["testText1"].size(), size_t(2) );
+		UT_ASSERT_EQUAL( segmented.getWordHits( "brown" ).size(), size_t(2) );
+
+		// concurrent merges keep a segment added meanwhile
+		{
+			TempFileName	fourthFile( true ), merged3File( true ), merged4File( true );
+			Index<STRING>	fourth;
+			addText( &fourth, "testText4", "a yellow submarine" );
+			ai::writeIndexSegment( fourth, fourthFile );
+
+			segmented.addSegment( thirdFile );
+			IndexMergeThread<STRING>	merger3( segmented, merged3File ), merger4( segmented, merged4File );
+			merger3.StartThread();
+			merger4.StartThread();
+			merger3.join();
+			segmented.addSegment( fourthFile );
+			merger4.join();
+
+			UT_ASSERT_TRUE( merger3.isSuccess() );
+			UT_ASSERT_TRUE( merger4.isSuccess() );
+			UT_ASSERT_LESSEQ( segmented.getNumSegments(), size_t(2) );
+			UT_ASSERT_EQUAL( segmented.getWordHits( "yellow" ).size(), size_t(1) );
+			UT_ASSERT_EQUAL( segmented.getWordHits( "bear" ).size(), size_t(1) );
+			UT_ASSERT_EQUAL( segmented.getWordHits( "brown" ).size(), size_t(2) );
+		}
+
+		// the index data is compressed
+		DirectoryEntry	entry( fullFile );
+		std::stringstream	stream;
+		expected.toBinaryStream( stream );
+		UT_ASSERT_LESS( entry.fileSize, uint64( stream.str().size() ) );
+
+		UT_ASSERT_EXCEPTION( IndexSegment<STRING>( STRING( "notExisting.idx" ) ), OpenReadError );
+		{
+			std::ofstream	badFile( firstFile.get(), std::ios_base::binary );
+			badFile << "this is not an index segment";
+		}
+		UT_ASSERT_EXCEPTION( IndexSegment<STRING>( firstFile.get() ), BadHeaderError );
+
+		// a dictionary entry pointing behind the term text is rejected, too
+		{
+			std::ifstream		goodFile( fullFile.get(), std::ios_base::binary );
+			std::stringstream	content;
+			content << goodFile.rdbuf();
+
+			std::string					data = content.str();
+			const ai::IndexSegmentHeader	*header = reinterpret_cast<const ai::IndexSegmentHeader *>( data.data() );
+			ai::IndexSegmentTerm			*term = reinterpret_cast<ai::IndexSegmentTerm *>(
+				&data[std::size_t( header->m_dictOffset )]
+			);
+			term->m_termOffset = header->m_fileSize;
+
+			std::ofstream	badFile( firstFile.get(), std::ios_base::binary );
+			badFile.write( data.data(), data.size() );
+		}
+		UT_ASSERT_EXCEPTION( IndexSegment<STRING>( firstFile.get() ), BadHeaderError );
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx( gakLogging::llInfo, "IndexSegmentTest::PerformTest" );
+		TestScope scope( "PerformTest" );
+
+		segmentTest();
+	}
+	virtual bool canThreadTest()
+	{
+		return true;
+	}
+	virtual UnitTest *duplicate()
+	{
+		return new IndexSegmentTest( false );
+	}
+	public:
+	IndexSegmentTest( bool isStatic=true ) : UnitTest( isStatic ) {}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static IndexSegmentTest myIndexSegmentTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
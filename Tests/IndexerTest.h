@@ -41,6 +41,8 @@
 #include <gak/unitTest.h>
 
 #include <gak/indexer.h>
+#include <gak/indexBuilder.h>
+#include <gak/fmtNumber.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -77,6 +79,7 @@ using ai::indexString;
 using ai::Index;
 using ai::StatistikData;
 using ai::Position;
+using ai::ParallelIndexBuilder;
 
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
@@ -88,6 +91,66 @@ class IndexerTest : public UnitTest
 	{
 		return "IndexerTest";
 	}
+	void parallelTest( const SortedArray<CI_STRING> &stopWords )
+	{
+		typedef Index<STRING>::SearchIndex	SearchIndex;
+		typedef Index<STRING>::SearchResult	SearchResult;
+
+		static const char *const sentences[] =
+		{
+			"the quick brown fox jumps over the lazy dog",
+			"the best of the world of all brown universes namespace::class_name",
+			"G\xE4" "ckler writes the index, the parser and the server",
+			"a lazy dog sleeps, a quick fox jumps"
+		};
+		const std::size_t	numSentences = arraySize( sentences );
+		const std::size_t	numDocs = 100;
+
+		Index<STRING>					sequential, parallel;
+		ParallelIndexBuilder<STRING>	builder( stopWords, ai::IS_ANY, 3, 7 );
+		for( std::size_t i=0; i<numDocs; ++i )
+		{
+			STRING	source = formatNumber( i );
+			STRING	text = sentences[i%numSentences];
+			text += ' ';
+			text += sentences[(i/numSentences)%numSentences];
+			text += " word";
+			text += formatNumber( i%13 );
+
+			StringIndex	positions;
+			indexString( text, stopWords, ai::IS_ANY, &positions );
+			sequential.moveIndexPositions( source, &positions );
+
+			builder.addDocument( source, text );
+		}
+		builder.build( &parallel );
+
+		const SearchIndex	&seqIndex = sequential.getSearchIndex();
+		UT_ASSERT_EQUAL( seqIndex.size(), parallel.size() );
+		for( std::size_t i=0; i<seqIndex.size(); ++i )
+		{
+			const SearchResult	&seqHits = seqIndex.getValueAt( i );
+			const SearchResult	&parHits = parallel[seqIndex.getKeyAt( i )];
+			UT_ASSERT_EQUAL( seqHits.size(), parHits.size() );
+			for(
+				SearchResult::const_iterator it = seqHits.cbegin(), endIT = seqHits.cend();
+				it != endIT;
+				++it
+			)
+			{
+				UT_ASSERT_TRUE( parHits.hasElement( it->getKey() ) );
+				UT_ASSERT_EQUAL( it->getValue().size(), parHits[it->getKey()].size() );
+			}
+		}
+
+		// the builder can be reused
+		const std::size_t	numQuick = sequential["quick"].size();
+		builder.addDocument( "extra", "quick foxes" );
+		builder.build( &parallel );
+		UT_ASSERT_EQUAL( numQuick+1, parallel["quick"].size() );
+		UT_ASSERT_EQUAL( std::size_t(1), parallel["foxes"].size() );
+	}
+
 	virtual void PerformTest()
 	{
 		doEnterFunctionEx(gakLogging::llInfo, "IndexerTest::PerformTest");
@@ -211,6 +274,8 @@ class IndexerTest : public UnitTest
 			writeToBinaryFile(tmpFile, globalIndex, 123, 1, owmOverwrite );
 			readFromBinaryFile(tmpFile, &globalIndex, 123, 1, false );
 		}
+
+		parallelTest( stopWords );
 	}
 
 	virtual bool canThreadTest()
@@ -113,6 +113,7 @@ class LockerTest : public UnitTest
 		Locker	locker;
 		
 		UT_ASSERT_EQUAL( locker.getLockCount(), 0 );
+		UT_ASSERT_EQUAL( locker.getContentionCount(), size_t(0) );
 
 		locker.lock();
 		UT_ASSERT_EQUAL( locker.getLockCount(), 1 );
@@ -125,6 +126,7 @@ class LockerTest : public UnitTest
 
 		locker.unlock();
 		UT_ASSERT_EQUAL( locker.getLockCount(), 0 );
+		UT_ASSERT_EQUAL( locker.getContentionCount(), size_t(0) );
 
 		{
 			TestScope scope( "concurrent test with unlock" );
@@ -139,6 +141,9 @@ class LockerTest : public UnitTest
 			UT_ASSERT_GREATEREQ( thread.m_sw.getMillis(), clock_t(TIMEOUT)/2 );
 			UT_ASSERT_LESS( thread.m_sw.getMillis(), clock_t(TIMEOUT) );
 			UT_ASSERT_EQUAL( locker.getLockCount(), 0 );
+			UT_ASSERT_EQUAL( locker.getContentionCount(), size_t(1) );
+			UT_ASSERT_GREATEREQ( locker.getWaitCount(), size_t(1) );
+			UT_ASSERT_EQUAL( locker.getTimeoutCount(), size_t(0) );
 		}
 
 		{
@@ -153,8 +158,12 @@ class LockerTest : public UnitTest
 			thread.join();
 			UT_ASSERT_FALSE( thread.m_ok );
 			UT_ASSERT_GREATEREQ( sw.getMillis(), clock_t(TIMEOUT) );
+			UT_ASSERT_EQUAL( locker.getTimeoutCount(), size_t(1) );
 		}
 		UT_ASSERT_EQUAL( locker.getLockCount(), 0 );
+		locker.resetStatistics();
+		UT_ASSERT_EQUAL( locker.getContentionCount(), size_t(0) );
+		UT_ASSERT_EQUAL( locker.getTimeoutCount(), size_t(0) );
 		{
 			TestScope scope( "concurrent test with already free" );
 
@@ -0,0 +1,364 @@
+/*
+		Project:		GAKLIB
+		Module:			MpmcQueueTest.h
+		Description:	tests for the lock free MPMC queue
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <gak/unitTest.h>
+#include <gak/thread.h>
+#include <gak/stopWatch.h>
+#include <gak/blockedQueue.h>
+#include <gak/condQueue.h>
+#include <gak/mpmcQueue.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static const int MPMC_ITEMS = 20000;
+static const int MPMC_THREADS = 4;
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+typedef MpmcQueue<int, 64>	SmallMpmcQueue;
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class MpmcProducer : public Thread
+{
+	SmallMpmcQueue	&m_queue;
+	int				m_first;
+
+	virtual void ExecuteThread()
+	{
+		for( int i=0; i<MPMC_ITEMS; ++i )
+		{
+			m_queue.push( m_first + i );
+		}
+	}
+	public:
+	MpmcProducer( SmallMpmcQueue &queue, int first ) : m_queue(queue), m_first(first)
+	{
+	}
+};
+
+class MpmcConsumer : public Thread
+{
+	SmallMpmcQueue	&m_queue;
+
+	virtual void ExecuteThread()
+	{
+		for( int i=0; i<MPMC_ITEMS; ++i )
+		{
+			int value = m_queue.waitPop();
+			m_sum += value;
+			++m_count;
+		}
+	}
+	public:
+	long long	m_sum;
+	int			m_count;
+
+	MpmcConsumer( SmallMpmcQueue &queue ) : m_queue(queue), m_sum(0), m_count(0)
+	{
+	}
+};
+
+class MpmcPusher : public Thread
+{
+	CondQueue<int, SmallMpmcQueue> &m_queue;
+
+	virtual void ExecuteThread()
+	{
+		Sleep(200);
+		m_queue.push(666);
+	}
+	public:
+	MpmcPusher( CondQueue<int, SmallMpmcQueue> &queue ) : m_queue(queue)
+	{
+	}
+};
+
+class MpmcBlockedPusher : public Thread
+{
+	BlockedQueue<int, SmallMpmcQueue> &m_queue;
+
+	virtual void ExecuteThread()
+	{
+		Sleep(200);
+		m_queue.push(666);
+	}
+	public:
+	MpmcBlockedPusher( BlockedQueue<int, SmallMpmcQueue> &queue ) : m_queue(queue)
+	{
+	}
+};
+
+class MpmcQueueTest : public UnitTest
+{
+	virtual const char *GetClassName() const
+	{
+		return "MpmcQueueTest";
+	}
+	void testSingleThread()
+	{
+		TestScope scope( "testSingleThread" );
+
+		MpmcQueue<int, 8>	myQueue;
+		int					value;
+
+		UT_ASSERT_EQUAL( myQueue.capacity(), std::size_t(8) );
+		UT_ASSERT_TRUE( myQueue.isEmpty() );
+		UT_ASSERT_FALSE( myQueue.tryPop( &value ) );
+		UT_ASSERT_EXCEPTION( myQueue.pop(), QueueEmptyError );
+		UT_ASSERT_EXCEPTION( myQueue.waitPop( 10 ), TimeoutException );
+
+		for( int i=0; i<8; ++i )
+		{
+			UT_ASSERT_TRUE( myQueue.tryPush( i ) );
+		}
+		UT_ASSERT_FALSE( myQueue.tryPush( 8 ) );
+		UT_ASSERT_EQUAL( myQueue.size(), std::size_t(8) );
+
+		for( int i=0; i<4; ++i )
+		{
+			UT_ASSERT_EQUAL( myQueue.pop(), i );
+		}
+		for( int i=8; i<12; ++i )
+		{
+			myQueue.push( i );
+		}
+		for( int i=4; i<12; ++i )
+		{
+			UT_ASSERT_EQUAL( myQueue.waitPop(), i );
+		}
+		UT_ASSERT_TRUE( myQueue.isEmpty() );
+		UT_ASSERT_EQUAL( myQueue.total(), std::size_t(12) );
+
+		myQueue.push( 1 );
+		myQueue.push( 2 );
+		myQueue.clear();
+		UT_ASSERT_EQUAL( myQueue.size(), std::size_t(0) );
+	}
+	void testLockQueue()
+	{
+		TestScope scope( "testLockQueue" );
+
+		LockQueue<int, SmallMpmcQueue>	myQueue;
+		int								values[] = { 1, 2, 3 };
+
+		myQueue.push( 0 );
+		myQueue.pushBatch( values, values+3 );
+		UT_ASSERT_EQUAL( myQueue.size(), std::size_t(4) );
+		UT_ASSERT_EQUAL( myQueue.total(), std::size_t(4) );
+		for( int i=0; i<4; ++i )
+		{
+			UT_ASSERT_EQUAL( myQueue.pop(), i );
+		}
+		UT_ASSERT_EXCEPTION( myQueue.pop(), QueueEmptyError );
+
+		CondQueue<int, SmallMpmcQueue>	condQueue;
+		SharedObjectPointer<MpmcPusher>	pusher( new MpmcPusher( condQueue ) );
+		pusher->StartThread();
+		UT_ASSERT_TRUE( condQueue.wait( 10000 ) );
+		UT_ASSERT_EQUAL( condQueue.pop(), 666 );
+		condQueue.unlock();
+		pusher->join();
+	}
+	void testBlockedQueue()
+	{
+		TestScope scope( "testBlockedQueue" );
+
+		BlockedQueue<int, SmallMpmcQueue>	myQueue;
+		int									values[] = { 1, 2, 3 };
+
+		UT_ASSERT_EXCEPTION( myQueue.pop( 10 ), TimeoutException );
+
+		myQueue.push( 0 );
+		myQueue.pushBatch( values, values+3 );
+		UT_ASSERT_EQUAL( myQueue.size(), std::size_t(4) );
+		UT_ASSERT_EQUAL( myQueue.total(), std::size_t(4) );
+		for( int i=0; i<4; ++i )
+		{
+			UT_ASSERT_EQUAL( myQueue.pop(), i );
+		}
+
+		myQueue.push( 4 );
+		myQueue.clear();
+		UT_ASSERT_EQUAL( myQueue.size(), std::size_t(0) );
+
+		// pop waits in the MpmcQueue until the item arrives
+		SharedObjectPointer<MpmcBlockedPusher>	pusher( new MpmcBlockedPusher( myQueue ) );
+		pusher->StartThread();
+		UT_ASSERT_EQUAL( myQueue.pop( 10000 ), 666 );
+		pusher->join();
+	}
+	void testContention()
+	{
+		TestScope scope( "testContention" );
+
+		SmallMpmcQueue								myQueue;
+		Array< SharedObjectPointer<MpmcProducer> >	producers;
+		Array< SharedObjectPointer<MpmcConsumer> >	consumers;
+
+		for( int i=0; i<MPMC_THREADS; ++i )
+		{
+			consumers.addElement( SharedObjectPointer<MpmcConsumer>( new MpmcConsumer( myQueue ) ) );
+			producers.addElement( SharedObjectPointer<MpmcProducer>( new MpmcProducer( myQueue, i*MPMC_ITEMS ) ) );
+		}
+		for( int i=0; i<MPMC_THREADS; ++i )
+		{
+			consumers[i]->StartThread();
+			producers[i]->StartThread();
+		}
+
+		long long	sum = 0;
+		int			count = 0;
+		for( int i=0; i<MPMC_THREADS; ++i )
+		{
+			producers[i]->join();
+			consumers[i]->join();
+			sum += consumers[i]->m_sum;
+			count += consumers[i]->m_count;
+		}
+
+		const long long	n = MPMC_THREADS*MPMC_ITEMS;
+		UT_ASSERT_EQUAL( count, int(n) );
+		UT_ASSERT_EQUAL( sum, n*(n-1)/2 );
+		UT_ASSERT_TRUE( myQueue.isEmpty() );
+		UT_ASSERT_EQUAL( myQueue.total(), std::size_t(n) );
+	}
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "MpmcQueueTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		testSingleThread();
+		testLockQueue();
+		testBlockedQueue();
+		testContention();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static MpmcQueueTest myMpmcQueueTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
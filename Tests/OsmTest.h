@@ -219,6 +219,11 @@ class OsmTest : public UnitTest
 				UT_ASSERT_EQUAL( areas.size(), 1 );
 				builder.getPlaces( layer2, builder.getFrameBox(0.01), &places );
 				UT_ASSERT_EQUAL( places.size(), 1 );
+
+				// the area covers the whole region but has no vertex within it
+				areas.clear();
+				builder.getAreas( layer2, BoundingBox( 45.04, 15.06, 45.06, 15.04 ), &areas );
+				UT_ASSERT_EQUAL( areas.size(), 1 );
 			}
 
 			writeToBinaryFile(
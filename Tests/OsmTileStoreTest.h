@@ -0,0 +1,596 @@
+/*
+		Project:		GAKLIB
+		Module:			OsmTileStoreTest.h
+		Description:	
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <cstdlib>
+#include <gak/unitTest.h>
+
+#include <gak/osmTileStore.h>
+#include <gak/arrayFile.h>
+#include <gak/directory.h>
+#include <gak/tmpfile.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class OsmTileStoreTest : public UnitTest
+{
+	enum
+	{
+		layer1 = 1, layer2 = 2,
+		numNodes = 40, numPlaces = 5, numAreas = 3,
+		tilesPerLine = 3
+	};
+
+	STRING				m_path;
+	math::tileid_t		m_firstTile;
+	math::TileIDsSet	m_tileIDs;
+	OSMbuilder			m_world;
+
+	virtual const char *GetClassName() const
+	{
+		return "OsmTileStoreTest";
+	}
+
+	static float randomCoord( float min )
+	{
+		return min + float( std::rand() % 10000 ) / 10000.0f * float( math::degreePerTile );
+	}
+
+	/*
+		creates the data of a tile, the last node of each tile has a link to the first node
+		of the next tile, i.e. a node of another tile
+	*/
+	void createTile( math::tileid_t tileID, OSMbuilder *tileMap )
+	{
+		math::GeoPosition<double>	lowerLeft, upperRight;
+		math::GeoPosition<double>::getTile( tileID, lowerLeft, upperRight );
+
+		const OsmNodeKeyT	firstNode = OsmNodeKeyT( tileID ) * 1000;
+		for( int i=0; i<numNodes; ++i )
+		{
+			OsmNode	node;
+			node.pos.longitude = randomCoord( float( lowerLeft.longitude ) );
+			node.pos.latitude = randomCoord( float( lowerLeft.latitude ) );
+
+			OsmLayerKeyT	layer = OsmLayerKeyT( i % 3 ? layer1 : layer2 );
+			tileMap->addNode( layer, firstNode + i, node );
+			m_world.addNode( layer, firstNode + i, node );
+		}
+		for( int i=0; i<numNodes; ++i )
+		{
+			OsmLink	link;
+			link.length = float( i );
+			link.type = i % 2 ? OsmLink::primary : OsmLink::footway;
+
+			OsmNodeKeyT	endNode = i+1 < numNodes ? firstNode + i + 1 : (OsmNodeKeyT( tileID ) + 1) * 1000;
+			tileMap->addLink( firstNode + i, link, firstNode + i, endNode );
+			if( i % 4 == 0 )
+			{
+				tileMap->addLink( firstNode + numNodes + i, link, firstNode + i, firstNode );
+			}
+		}
+		for( int i=0; i<numPlaces; ++i )
+		{
+			OsmPlace	place;
+			place.pos.longitude = randomCoord( float( lowerLeft.longitude ) );
+			place.pos.latitude = randomCoord( float( lowerLeft.latitude ) );
+			if( i )
+			{
+				place.name = "Place " + formatNumber( i );
+			}
+
+			OsmPlaceKeyT	key = OsmPlaceKeyT( tileID ) * 10 + i;
+			OsmLayerKeyT	layer = OsmLayerKeyT( i % 2 ? layer1 : layer2 );
+			tileMap->addPlace( key, layer, place );
+			m_world.addPlace( key, layer, place );
+		}
+		for( int i=0; i<numAreas; ++i )
+		{
+			Area	area;
+			for( int j=0; j<3+i; ++j )
+			{
+				area.points.addElement(
+					OsmPosition( randomCoord( float( lowerLeft.longitude ) ), randomCoord( float( lowerLeft.latitude ) ) )
+				);
+			}
+
+			OsmAreaKeyT	key = OsmAreaKeyT( tileID ) * 100 + i;
+			tileMap->addArea( key, layer1, area );
+			m_world.addArea( key, layer1, area );
+		}
+	}
+
+	/*
+		the tile must contain the same data as the map it was built from
+	*/
+	void checkTile( const OsmTile &tile, const OSMbuilder &tileMap )
+	{
+		UT_ASSERT_EQUAL( tile.getNumNodes(), tileMap.getNumNodes() );
+		UT_ASSERT_EQUAL( tile.getNumLinks(), tileMap.getNumLinks() );
+		UT_ASSERT_EQUAL( tile.getNumPlaces(), tileMap.getNumPlaces() );
+		UT_ASSERT_EQUAL( tile.getNumAreas(), tileMap.getNumAreas() );
+
+		const OSMbuilder::node_container_type	&nodes = tileMap.getNodes();
+		for(
+			OSMbuilder::node_container_type::const_iterator it = nodes.cbegin(), endIT = nodes.cend();
+			it != endIT;
+			++it
+		)
+		{
+			const OsmTileNode	&node = tile.getNode( it->getKey() );
+			UT_ASSERT_EQUAL( node.m_pos.longitude, it->getValue().m_node.pos.longitude );
+			UT_ASSERT_EQUAL( node.m_pos.latitude, it->getValue().m_node.pos.latitude );
+
+			const OSMbuilder::link_key_types	&outgoing = it->getValue().m_outgoing;
+			UT_ASSERT_EQUAL( node.getNumLinks(), outgoing.size() );
+			for( std::size_t i=0; i<outgoing.size() && i<node.getNumLinks(); ++i )
+			{
+				const OsmTileLink				&link = tile.getOutgoingLink( node, i );
+				const OSMbuilder::LinkInfo		&linkInfo = tileMap.getLinkInfo( outgoing[i] );
+
+				UT_ASSERT_EQUAL( link.m_key, outgoing[i] );
+				UT_ASSERT_EQUAL( link.m_startNodeID, it->getKey() );
+				UT_ASSERT_EQUAL( link.m_endNodeID, linkInfo.m_endNodeID );
+				UT_ASSERT_EQUAL( link.m_link.length, linkInfo.m_link.length );
+				UT_ASSERT_EQUAL( link.m_link.type, linkInfo.m_link.type );
+				UT_ASSERT_EQUAL( tile.getLink( outgoing[i] ).m_key, outgoing[i] );
+			}
+		}
+
+		const OSMbuilder::place_container_type	&places = tileMap.getAllPlaces();
+		for(
+			OSMbuilder::place_container_type::const_iterator it = places.cbegin(), endIT = places.cend();
+			it != endIT;
+			++it
+		)
+		{
+			OsmPlace	place = tile.getPlace( it->getKey() );
+			UT_ASSERT_EQUAL( place.name, it->getValue().name );
+			UT_ASSERT_EQUAL( place.pos.longitude, it->getValue().pos.longitude );
+		}
+
+		const OSMbuilder::area_container_type	&areas = tileMap.getAllAreas();
+		for(
+			OSMbuilder::area_container_type::const_iterator it = areas.cbegin(), endIT = areas.cend();
+			it != endIT;
+			++it
+		)
+		{
+			Area	area = tile.getArea( it->getKey() );
+			UT_ASSERT_EQUAL( area.points.size(), it->getValue().points.size() );
+			for( std::size_t i=0; i<area.points.size() && i<it->getValue().points.size(); ++i )
+			{
+				UT_ASSERT_EQUAL( area.points[i].longitude, it->getValue().points[i].longitude );
+				UT_ASSERT_EQUAL( area.points[i].latitude, it->getValue().points[i].latitude );
+			}
+		}
+
+		UT_ASSERT_FALSE( tile.hasNode( -1 ) );
+		UT_ASSERT_EXCEPTION( tile.getNode( -1 ), NodeNotFoundError );
+		UT_ASSERT_EXCEPTION( tile.getLink( -1 ), LinkNotFoundError );
+		UT_ASSERT_EXCEPTION( tile.getPlace( -1 ), IndexError );
+		UT_ASSERT_EXCEPTION( tile.getArea( -1 ), IndexError );
+	}
+
+	void createTiles()
+	{
+		TestScope scope( "createTiles" );
+
+		m_path = getTempPath();
+		m_firstTile = math::GeoPosition<double>::getTileID( 11.2, 47.7 );
+		for( int y=0; y<tilesPerLine; ++y )
+		{
+			for( int x=0; x<tilesPerLine; ++x )
+			{
+				math::tileid_t	tileID = m_firstTile + y*math::maxTileIdPerLine + x;
+				OSMbuilder		tileMap;
+				OsmTile			tile;
+
+				createTile( tileID, &tileMap );
+				writeOsmTile( m_path, tileID, tileMap );
+				m_tileIDs.addElement( tileID );
+
+				tile.open( getOsmTileFileName( m_path, tileID ) );
+				UT_ASSERT_TRUE( tile.isMapped() );
+				UT_ASSERT_EQUAL( tile.getTileID(), tileID );
+				checkTile( tile, tileMap );
+			}
+		}
+	}
+
+	/*
+		the tiles of a region must return the same nodes, places and areas as the whole map
+	*/
+	void testRegions()
+	{
+		TestScope scope( "testRegions" );
+
+		OsmTileStore	store( m_path );
+		math::GeoPosition<double>	lowerLeft, upperRight;
+		math::GeoPosition<double>::getTile( m_firstTile, lowerLeft, upperRight );
+
+		for( int i=0; i<20; ++i )
+		{
+			double	left = lowerLeft.longitude + double( std::rand() % 1000 ) / 1000.0;
+			double	bottom = lowerLeft.latitude + double( std::rand() % 1000 ) / 1000.0;
+			BoundingBox	region( left, bottom + 0.4, left + 0.4, bottom );
+
+			Array<OsmTilePtr>	tiles;
+			store.getTiles( region, &tiles );
+
+			Array<OsmNodeKeyT>	nodes, expectedNodes;
+			Array<OsmPlaceKeyT>	places, expectedPlaces;
+			Set<OsmAreaKeyT>	areas, expectedAreas;
+			for( std::size_t t=0; t<tiles.size(); ++t )
+			{
+				tiles[t]->getRegion( layer1, region, &nodes );
+				tiles[t]->getRegion( layer2, region, &nodes );
+				tiles[t]->getPlaces( layer1, region, &places );
+				tiles[t]->getPlaces( layer2, region, &places );
+				tiles[t]->getAreas( layer1, region, &areas );
+			}
+			m_world.getRegion( layer1, region, &expectedNodes );
+			m_world.getRegion( layer2, region, &expectedNodes );
+			m_world.getPlaces( layer1, region, &expectedPlaces );
+			m_world.getPlaces( layer2, region, &expectedPlaces );
+			m_world.getAreas( layer1, region, &expectedAreas );
+
+			UT_ASSERT_EQUAL( nodes.size(), expectedNodes.size() );
+			for( std::size_t j=0; j<expectedNodes.size(); ++j )
+			{
+				UT_ASSERT_TRUE( nodes.hasElement( expectedNodes[j] ) );
+			}
+			UT_ASSERT_EQUAL( places.size(), expectedPlaces.size() );
+			for( std::size_t j=0; j<expectedPlaces.size(); ++j )
+			{
+				UT_ASSERT_TRUE( places.hasElement( expectedPlaces[j] ) );
+			}
+			UT_ASSERT_EQUAL( areas.size(), expectedAreas.size() );
+			for( std::size_t j=0; j<expectedAreas.size(); ++j )
+			{
+				UT_ASSERT_TRUE( areas.hasElement( expectedAreas[j] ) );
+			}
+		}
+		store.flush();
+	}
+
+	/*
+		a tile with a range outside of its arrays must be rejected
+	*/
+	void testCorrupted()
+	{
+		TestScope scope( "testCorrupted" );
+
+		OsmTile		tile;
+		ArrayOfData	data;
+
+		tile.open( getOsmTileFileName( m_path, m_firstTile ) );
+		data.addElements( tile.getData(), tile.getDataSize() );
+
+		// the nodes follow the header
+		const OsmTileHeader	*header = reinterpret_cast<const OsmTileHeader *>( data.getDataBuffer() );
+		OsmTileNode			*nodes = reinterpret_cast<OsmTileNode *>(
+			data.getDataBuffer() + ((sizeof( OsmTileHeader ) + 7) & ~std::size_t(7))
+		);
+		UT_ASSERT_EQUAL( nodes[0].m_key, tile.getNodeAt( 0 ).m_key );
+		nodes[0].m_lastLink = header->m_numOutgoing + 1;
+
+		TempFileName	fileName( false );
+		writeToFile( data, fileName );
+		UT_ASSERT_EXCEPTION( tile.open( fileName ), BadHeaderError );
+		UT_ASSERT_FALSE( tile.isMapped() );
+		UT_ASSERT_EQUAL( tile.getNumNodes(), std::size_t(0) );
+	}
+
+	/*
+		the store must not keep more tiles than its budget allows
+	*/
+	void testBudget()
+	{
+		TestScope scope( "testBudget" );
+
+		OsmTilePtr	first;
+		{
+			OsmTileStore	store( m_path, 0, false );
+			first = store.getTile( m_firstTile );
+			UT_ASSERT_TRUE( first );
+			UT_ASSERT_EQUAL( store.getNumTiles(), std::size_t(0) );
+		}
+		// the tile is still mapped after the store was destroyed
+		UT_ASSERT_TRUE( first->hasNode( OsmNodeKeyT( m_firstTile ) * 1000 ) );
+
+		const std::size_t	maxSize = first->getDataSize() * 5 / 2;
+		OsmTileStore		store( m_path, maxSize, false );
+
+		for( int round=0; round<2; ++round )
+		{
+			for(
+				math::TileIDsSet::const_iterator it = m_tileIDs.cbegin(), endIT = m_tileIDs.cend();
+				it != endIT;
+				++it
+			)
+			{
+				OsmTilePtr	tile = store.getTile( *it );
+				UT_ASSERT_TRUE( tile );
+				UT_ASSERT_EQUAL( tile->getTileID(), *it );
+				UT_ASSERT_LESSEQ( store.getSize(), maxSize );
+				UT_ASSERT_LESSEQ( store.getNumTiles(), std::size_t(2) );
+				UT_ASSERT_TRUE( store.hasTile( *it ) );
+			}
+		}
+		UT_ASSERT_EQUAL( store.getNumMisses(), 2*m_tileIDs.size() );
+		UT_ASSERT_EQUAL( store.getNumHits(), std::size_t(0) );
+
+		// the most recently used tile is still loaded
+		math::tileid_t	last = m_tileIDs[m_tileIDs.size()-1];
+		store.getTile( last );
+		UT_ASSERT_EQUAL( store.getNumHits(), std::size_t(1) );
+
+		// there is no file for a tile outside the area
+		math::tileid_t	missing = m_firstTile + tilesPerLine;
+		UT_ASSERT_FALSE( store.getTile( missing ) );
+		UT_ASSERT_FALSE( store.getTile( missing ) );
+		UT_ASSERT_EQUAL( store.getNumHits(), std::size_t(2) );
+
+		store.setMaxSize( 0 );
+		UT_ASSERT_EQUAL( store.getNumTiles(), std::size_t(0) );
+		UT_ASSERT_EQUAL( store.getSize(), std::size_t(0) );
+
+		// a file of mergeOsmTile is not a mapped tile
+		OSMbuilder	tileMap;
+		createTile( missing, &tileMap );
+		writeToBinaryFile( getOsmTileFileName( m_path, missing ), tileMap, OSM_MAGIC2, VERSION_MAGIC, owmOverwrite );
+		store.clear();
+		UT_ASSERT_EXCEPTION( store.getTile( missing ), BadHeaderError );
+		strRemove( getOsmTileFileName( m_path, missing ) );
+	}
+
+	/*
+		the neighbours of the tiles used are loaded in the background
+	*/
+	void testPrefetch()
+	{
+		TestScope scope( "testPrefetch" );
+
+		OsmTileStore		store( m_path );
+		math::tileid_t		center = m_firstTile + math::maxTileIdPerLine + 1;
+		math::GeoPosition<double>	lowerLeft, upperRight;
+		math::GeoPosition<double>::getTile( center, lowerLeft, upperRight );
+
+		BoundingBox			region(
+			lowerLeft.longitude + 0.1, upperRight.latitude - 0.1,
+			upperRight.longitude - 0.1, lowerLeft.latitude + 0.1
+		);
+		Array<OsmTilePtr>	tiles;
+
+		store.getTiles( region, &tiles );
+		UT_ASSERT_EQUAL( tiles.size(), std::size_t(1) );
+		UT_ASSERT_EQUAL( tiles[0]->getTileID(), center );
+
+		store.flush();
+		UT_ASSERT_EQUAL( store.getNumPrefetched(), m_tileIDs.size()-1 );
+		UT_ASSERT_EQUAL( store.getNumTiles(), m_tileIDs.size() );
+
+		math::TileIDsSet	neighbours;
+		OsmTileStore::getNeighbours( center, &neighbours );
+		UT_ASSERT_EQUAL( neighbours.size(), std::size_t(8) );
+		for(
+			math::TileIDsSet::const_iterator it = neighbours.cbegin(), endIT = neighbours.cend();
+			it != endIT;
+			++it
+		)
+		{
+			UT_ASSERT_TRUE( m_tileIDs.hasElement( *it ) );
+			UT_ASSERT_TRUE( store.getTile( *it ) );
+		}
+		UT_ASSERT_EQUAL( store.getNumMisses(), std::size_t(1) );
+		UT_ASSERT_EQUAL( store.getNumHits(), neighbours.size() );
+	}
+
+	/*
+		with a small budget the prefetched tiles must not release the tiles requested
+	*/
+	void testPrefetchBudget()
+	{
+		TestScope scope( "testPrefetchBudget" );
+
+		std::size_t	maxTileSize = 0;
+		for(
+			math::TileIDsSet::const_iterator it = m_tileIDs.cbegin(), endIT = m_tileIDs.cend();
+			it != endIT;
+			++it
+		)
+		{
+			OsmTile	tile;
+			tile.open( getOsmTileFileName( m_path, *it ) );
+			maxTileSize = math::max( maxTileSize, tile.getDataSize() );
+		}
+
+		// the center tile and its right neighbour
+		const std::size_t	maxSize = 3*maxTileSize;
+		OsmTileStore		store( m_path, maxSize );
+		math::tileid_t		center = m_firstTile + math::maxTileIdPerLine + 1;
+		math::GeoPosition<double>	lowerLeft, upperRight;
+		math::GeoPosition<double>::getTile( center, lowerLeft, upperRight );
+
+		BoundingBox			region(
+			lowerLeft.longitude + 0.1, upperRight.latitude - 0.1,
+			upperRight.longitude + 0.1, lowerLeft.latitude + 0.1
+		);
+		Array<OsmTilePtr>	tiles;
+
+		store.getTiles( region, &tiles );
+		UT_ASSERT_EQUAL( tiles.size(), std::size_t(2) );
+		tiles.clear();
+
+		store.flush();
+		UT_ASSERT_LESSEQ( store.getSize(), maxSize );
+		UT_ASSERT_GREATEREQ( store.getNumPrefetched(), std::size_t(1) );
+		UT_ASSERT_TRUE( store.hasTile( center ) );
+		UT_ASSERT_TRUE( store.hasTile( center+1 ) );
+
+		store.getTiles( region, &tiles );
+		UT_ASSERT_EQUAL( tiles.size(), std::size_t(2) );
+		UT_ASSERT_EQUAL( store.getNumMisses(), std::size_t(2) );
+		UT_ASSERT_EQUAL( store.getNumHits(), std::size_t(2) );
+		store.flush();
+	}
+
+	void removeTiles()
+	{
+		for(
+			math::TileIDsSet::const_iterator it = m_tileIDs.cbegin(), endIT = m_tileIDs.cend();
+			it != endIT;
+			++it
+		)
+		{
+			strRemove( getOsmTileFileName( m_path, *it ) );
+		}
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "OsmTileStoreTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		std::srand( 4711 );
+		createTiles();
+		testRegions();
+		testCorrupted();
+		testBudget();
+		testPrefetch();
+		testPrefetchBudget();
+		removeTiles();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static OsmTileStoreTest myOsmTileStoreTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
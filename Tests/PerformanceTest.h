@@ -44,7 +44,20 @@
 #include <string>
 
 #include <gak/btree.h>
+#include <gak/bplusTree.h>
 #include <gak/sortedArray.h>
+#include <gak/threadPool.h>
+#include <gak/blockedQueue.h>
+#include <gak/mpmcQueue.h>
+#include <gak/strArena.h>
+#include <gak/map.h>
+#include <gak/hashMap.h>
+#include <gak/indexBuilder.h>
+#include <gak/streams.h>
+#include <gak/xmlParser.h>
+#include <gak/xmlPullParser.h>
+#include <gak/XPath.h>
+#include <gak/stringStream.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -80,12 +93,566 @@ namespace gak
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+class PoolCounter
+{
+	Critical	*m_cs;
+	size_t		*m_counter;
+
+	public:
+	PoolCounter( Critical *cs=nullptr, size_t *counter=nullptr ) : m_cs(cs), m_counter(counter)
+	{}
+
+	void operator () () const
+	{
+		CriticalScope	scope( *m_cs );
+		++(*m_counter);
+	}
+};
+
+template <typename QueueT>
+inline int benchPop( BlockedQueue<int, QueueT> &queue )
+{
+	return queue.pop();
+}
+
+inline int benchPop( MpmcQueue<int> &queue )
+{
+	return queue.waitPop();
+}
+
+template <typename QueueT>
+class QueueBenchProducer : public Thread
+{
+	QueueT	&m_queue;
+	int		m_numItems;
+
+	virtual void ExecuteThread()
+	{
+		for( int i=0; i<m_numItems; ++i )
+		{
+			m_queue.push( i );
+		}
+	}
+	public:
+	QueueBenchProducer( QueueT &queue, int numItems ) : m_queue(queue), m_numItems(numItems)
+	{}
+};
+
+template <typename QueueT>
+class QueueBenchConsumer : public Thread
+{
+	QueueT	&m_queue;
+	int		m_numItems;
+
+	virtual void ExecuteThread()
+	{
+		for( int i=0; i<m_numItems; ++i )
+		{
+			m_sum += benchPop( m_queue );
+		}
+	}
+	public:
+	long long	m_sum;
+
+	QueueBenchConsumer( QueueT &queue, int numItems ) : m_queue(queue), m_numItems(numItems), m_sum(0)
+	{}
+};
+
 class PerformanceTest : public UnitTest
 {
 	virtual const char *GetClassName() const
 	{
 		return "PerformanceTest";
 	}
+	void doPoolTest( PoolMode mode, const char *name )
+	{
+		const size_t	numItems = 20000;
+		Critical		cs;
+		size_t			counter = 0;
+
+		ThreadPool<PoolCounter>	pool( 4, name, nullptr, mode );
+		pool.start();
+
+		StopWatch	sw( true );
+		for( size_t i=0; i<numItems; i++ )
+		{
+			pool.process( PoolCounter( &cs, &counter ) );
+		}
+		pool.flush();
+		sw.stop();
+		pool.shutdown();
+
+		UT_ASSERT_EQUAL( counter, numItems );
+		std::cout << name << ' ' << numItems << ',' << sw.getMillis() << "ms" << std::endl;
+	}
+	template <typename QueueT>
+	void doQueueTest( const char *name )
+	{
+		const int	numThreads = 4;
+		const int	numItems = 50000;
+		QueueT		queue;
+
+		Array< SharedObjectPointer< QueueBenchProducer<QueueT> > >	producers;
+		Array< SharedObjectPointer< QueueBenchConsumer<QueueT> > >	consumers;
+		for( int i=0; i<numThreads; ++i )
+		{
+			producers.addElement( SharedObjectPointer< QueueBenchProducer<QueueT> >( new QueueBenchProducer<QueueT>( queue, numItems ) ) );
+			consumers.addElement( SharedObjectPointer< QueueBenchConsumer<QueueT> >( new QueueBenchConsumer<QueueT>( queue, numItems ) ) );
+		}
+
+		StopWatch	sw( true );
+		for( int i=0; i<numThreads; ++i )
+		{
+			consumers[i]->StartThread();
+			producers[i]->StartThread();
+		}
+		long long	sum = 0;
+		for( int i=0; i<numThreads; ++i )
+		{
+			producers[i]->join();
+			consumers[i]->join();
+			sum += consumers[i]->m_sum;
+		}
+		sw.stop();
+
+		UT_ASSERT_EQUAL( sum, (long long)numThreads * numItems * (numItems-1) / 2 );
+		std::cout << name << ' ' << numThreads << 'x' << numItems << ',' << sw.getMillis() << "ms" << std::endl;
+	}
+	clock_t doStringTest( size_t numItems, StrArena *arena )
+	{
+		static const char * const words[] =
+		{
+			"a", "the", "XML", "index", "of", "words", "parser", "attribute"
+		};
+
+		clock_t	startTime = clock();
+		{
+			Array<STRING>	myStrings;
+			myStrings.setChunkSize( numItems );
+			for( size_t i=0; i<numItems; i++ )
+			{
+				STRING	&word = myStrings.createElement();
+				word = words[i % 8];
+				word += 'x';
+			}
+			if( myStrings.size() != numItems )
+			{
+				return 0;
+			}
+		}
+		clock_t endTime = clock() - startTime;
+		std::cout << (arena ? "STRING with arena " : "STRING ") << numItems << ',' << endTime << std::endl;
+		return endTime;
+	}
+	void doStringTests()
+	{
+		const size_t numItems = 1000000;
+
+		clock_t	startTime = clock();
+		size_t	len = 0;
+		for( size_t i=0; i<numItems; i++ )
+		{
+			STRING	word = i & 1 ? "index" : "of";
+			word += 'x';
+			STRING	copy = word;
+			copy += 'y';
+			len += copy.strlen();
+		}
+		std::cout << "STRING temporaries " << numItems << ',' << clock() - startTime << std::endl;
+		UT_ASSERT_EQUAL( len, numItems/2*11 );
+
+		doStringTest( numItems, NULL );
+
+		StrArena	arena;
+		clock_t		arenaTime;
+		{
+			StrArenaScope	scope( arena );
+			arenaTime = doStringTest( numItems, &arena );
+		}
+		size_t	blockCount = arena.getBlockCount();
+		UT_ASSERT_EQUAL( blockCount, size_t(0) );
+		UT_ASSERT_GREATER( arenaTime, clock_t(0) );
+	}
+	template <typename TreeT>
+	size_t doTreeTest( const char *name, const Array<STRING> &keys )
+	{
+		TreeT	myTree;
+
+		clock_t		startTime = clock();
+		for( size_t i=0; i<keys.size(); i++ )
+		{
+			myTree += keys[i];
+		}
+		clock_t addTime = clock() - startTime;
+
+		startTime = clock();
+		size_t	found = 0;
+		for( size_t i=0; i<keys.size(); i++ )
+		{
+			if( myTree.findElement( keys[i] ) )
+			{
+				++found;
+			}
+		}
+		clock_t findTime = clock() - startTime;
+		UT_ASSERT_EQUAL( found, keys.size() );
+
+		startTime = clock();
+		size_t	len = 0;
+		for( size_t i=0; i<myTree.size(); i += 7 )
+		{
+			len += myTree.getElementAt( i ).strlen();
+		}
+		clock_t indexTime = clock() - startTime;
+		UT_ASSERT_GREATER( len, size_t(0) );
+
+		startTime = clock();
+		size_t	count = 0;
+		for(
+			typename TreeT::const_iterator it = myTree.cbegin(), endIT = myTree.cend();
+			it != endIT;
+			++it
+		)
+		{
+			++count;
+		}
+		clock_t iterTime = clock() - startTime;
+		UT_ASSERT_EQUAL( count, myTree.size() );
+
+		std::cout << name << ' ' << keys.size() << " add:" << addTime << " find:" << findTime
+			<< " index:" << indexTime << " iterate:" << iterTime << std::endl;
+
+		return myTree.size();
+	}
+	void doTreeTests()
+	{
+		const size_t numItems = 200000;
+
+		Array<STRING>	keys;
+		keys.setChunkSize( numItems );
+		for( size_t i=0; i<numItems; i++ )
+		{
+			keys.addElement( formatNumber( randomNumber( int(numItems*4) ) ) );
+		}
+
+		size_t btreeSize = doTreeTest< Btree<STRING> >( "Btree", keys );
+		size_t bplusSize = doTreeTest< BplusTree<STRING> >( "BplusTree", keys );
+		UT_ASSERT_EQUAL( btreeSize, bplusSize );
+	}
+	template <typename MapT>
+	size_t doMapTest( const char *name, const Array<STRING> &keys )
+	{
+		MapT	myMap;
+
+		clock_t		startTime = clock();
+		for( size_t i=0; i<keys.size(); i++ )
+		{
+			myMap[keys[i]] += 1;
+		}
+		clock_t addTime = clock() - startTime;
+
+		startTime = clock();
+		size_t	found = 0;
+		for( size_t i=0; i<keys.size(); i++ )
+		{
+			if( myMap.hasElement( keys[i] ) )
+			{
+				++found;
+			}
+		}
+		clock_t findTime = clock() - startTime;
+		UT_ASSERT_EQUAL( found, keys.size() );
+
+		std::cout << name << ' ' << keys.size() << " add:" << addTime << " find:" << findTime << std::endl;
+
+		return myMap.size();
+	}
+	void doMapTests()
+	{
+		const size_t numItems = 20000;
+
+		Array<STRING>	keys;
+		keys.setChunkSize( numItems );
+		for( size_t i=0; i<numItems; i++ )
+		{
+			keys.addElement( formatNumber( randomNumber( int(numItems*4) ) ) );
+		}
+
+		size_t unorderedSize = doMapTest< UnorderedPairMap<STRING, int> >( "UnorderedPairMap", keys );
+		size_t pairSize = doMapTest< PairMap<STRING, int> >( "PairMap", keys );
+		size_t hashSize = doMapTest< HashMap<STRING, int> >( "HashMap", keys );
+		UT_ASSERT_EQUAL( unorderedSize, pairSize );
+		UT_ASSERT_EQUAL( hashSize, pairSize );
+	}
+	void doIndexTests()
+	{
+		static const char *const words[] =
+		{
+			"the", "quick", "brown", "fox", "jumps", "over", "lazy", "dog",
+			"best", "of", "world", "all", "universes", "namespace::class_name"
+		};
+		const size_t	numDocs = 2000;
+		const size_t	numWords = 200;
+
+		Array<STRING>	texts;
+		texts.setChunkSize( numDocs );
+		for( size_t i=0; i<numDocs; i++ )
+		{
+			STRING	&text = texts.createElement();
+			for( size_t j=0; j<numWords; j++ )
+			{
+				if( j&1 )
+				{
+					text += words[randomNumber( int(arraySize( words )) )];
+				}
+				else
+				{
+					text += "word";
+					text += formatNumber( randomNumber( 20000 ) );
+				}
+				text += ' ';
+			}
+		}
+
+		SortedArray<CI_STRING>	stopWords;
+		ai::Index<STRING>		sequential, parallel;
+
+		StopWatch	sw( true );
+		for( size_t i=0; i<numDocs; i++ )
+		{
+			ai::StringIndex	positions;
+			ai::indexString( texts[i], stopWords, ai::IS_ANY, &positions );
+			sequential.moveIndexPositions( formatNumber( i ), &positions );
+		}
+		sw.stop();
+		std::cout << "Index sequential " << numDocs << ',' << sw.getMillis() << "ms" << std::endl;
+
+		sw.start();
+		{
+			ai::ParallelIndexBuilder<STRING>	builder( stopWords, ai::IS_ANY, 4 );
+			for( size_t i=0; i<numDocs; i++ )
+			{
+				builder.addDocument( formatNumber( i ), texts[i] );
+			}
+			builder.build( &parallel );
+		}
+		sw.stop();
+		std::cout << "Index parallel " << numDocs << ',' << sw.getMillis() << "ms" << std::endl;
+
+		UT_ASSERT_EQUAL( sequential.size(), parallel.size() );
+	}
+	static int incStream( int i )
+	{
+		return i+1;
+	}
+	static bool notDivisibleBy7( int i )
+	{
+		return i % 7 != 0;
+	}
+	template <typename StreamT>
+	size_t doStreamTest( const char *name, StreamT &stream, size_t numItems )
+	{
+		Array<int>	result;
+		result.setChunkSize( numItems );
+
+		StopWatch	sw( true );
+		streams::Sink<
+			int, 
+			streams::ContainerSinkFunction< std::back_insert_iterator< Array<int> >, int > 
+		>	sink = stream->addContainerSink( std::back_inserter( result ) );
+		sink->start();
+		sink->wait();
+		sw.stop();
+
+		std::cout << name << ' ' << numItems << ',' << sw.getMillis() << "ms" << std::endl;
+		return result.size();
+	}
+	void doStreamTests()
+	{
+		const size_t	numItems = 200000;
+
+		Array<int>	numbers;
+		numbers.setChunkSize( numItems );
+		for( size_t i=0; i<numItems; i++ )
+		{
+			numbers.addElement( int(i) );
+		}
+
+		int (*mapFunc)( int ) = incStream;
+		bool (*filterFunc)( int ) = notDivisibleBy7;
+
+		streams::Stream<int>	stream = streams::makeContainerStream( numbers )
+			->map<int>( mapFunc )
+			->filter( filterFunc )
+			->map<int>( mapFunc )
+			->filter( filterFunc )
+			->map<int>( mapFunc );
+		size_t	threadedSize = doStreamTest( "Stream 5 stages", stream, numItems );
+
+		stream = streams::makeContainerStream( numbers )->fuse()
+			.map<int>( mapFunc )
+			.filter( filterFunc )
+			.map<int>( mapFunc )
+			.filter( filterFunc )
+			.map<int>( mapFunc )
+			.toStream();
+		size_t	fusedSize = doStreamTest( "Fused 5 stages", stream, numItems );
+
+		stream = streams::makeContainerStream( numbers )->fuse()
+			.map<int>( mapFunc )
+			.filter( filterFunc )
+			.map<int>( mapFunc )
+			.filter( filterFunc )
+			.map<int>( mapFunc )
+			.toParallelStream( 4 );
+		size_t	parallelSize = doStreamTest( "Parallel 5 stages", stream, numItems );
+
+		UT_ASSERT_EQUAL( threadedSize, fusedSize );
+		UT_ASSERT_EQUAL( threadedSize, parallelSize );
+	}
+	struct XmlCounter : public xml::XmlNullProcessor
+	{
+		size_t	m_numAttributes;
+
+		XmlCounter() : m_numAttributes( 0 ) {}
+		void processAttribute( const STRING &, const STRING &, const STRING & )
+		{
+			++m_numAttributes;
+		}
+	};
+	void doXmlTests()
+	{
+		const size_t	numNodes = 20000;
+
+		STRING	xmlCode = "<osm version=\"0.6\">\n";
+		for( size_t i=0; i<numNodes; i++ )
+		{
+			xmlCode += " <node id=\"" + formatNumber( i ) + "\" lat=\"48.3\" lon=\"14.3\">\n"
+				"  <tag k=\"name\" v=\"Tom &amp; Jerry\"/>\n"
+				" </node>\n";
+		}
+		xmlCode += "</osm>\n";
+
+		StopWatch		sw( true );
+		XmlCounter		parserCounter;
+		iSTRINGstream	str( xmlCode );
+		xml::Parser		theParser( &str, "internal" );
+		theParser.parseXML( parserCounter );
+		sw.stop();
+		std::cout << "xml::Parser " << numNodes << ',' << sw.getMillis() << "ms" << std::endl;
+
+		sw.start();
+		XmlCounter		pullCounter;
+		xml::PullParser	thePullParser( xmlCode, xmlCode.strlen() );
+		thePullParser.parseXML( pullCounter );
+		sw.stop();
+		std::cout << "xml::PullParser " << numNodes << ',' << sw.getMillis() << "ms" << std::endl;
+
+		sw.start();
+		size_t			numAttributes = 0;
+		xml::PullParser	theEventParser( xmlCode, xmlCode.strlen() );
+		for(
+			xml::PullParser::EventType event = theEventParser.next();
+			event != xml::PullParser::etEND_DOCUMENT;
+			event = theEventParser.next()
+		)
+		{
+			if( event == xml::PullParser::etATTRIBUTE )
+			{
+				++numAttributes;
+			}
+		}
+		sw.stop();
+		std::cout << "xml::PullParser events " << numNodes << ',' << sw.getMillis() << "ms" << std::endl;
+
+		UT_ASSERT_EQUAL( parserCounter.m_numAttributes, pullCounter.m_numAttributes );
+		UT_ASSERT_EQUAL( parserCounter.m_numAttributes, numAttributes );
+	}
+	void doXPathTests()
+	{
+		const size_t	numNodes = 5000;
+		const char		expression[] = "@id mod 2 = 0 and tag/@k = 'name'";
+
+		xml::Any	theRoot( "osm" );
+		for( size_t i=0; i<numNodes; i++ )
+		{
+			xml::Any *theNode = new xml::Any( "node" );
+			theNode->setIntegerAttribute( "id", int(i) );
+			xml::Any *theTag = new xml::Any( "tag" );
+			theTag->setStringAttribute( "k", "name" );
+			theNode->addObject( theTag );
+			theRoot.addObject( theNode );
+		}
+
+		xml::XmlArray	nodes;
+		theRoot.getChildren( &nodes, false );
+
+		StopWatch	sw( true );
+		size_t		numParsed = 0;
+		for( nodes.first(); nodes.current(); nodes.next() )
+		{
+			xml::XPathExpression	theExpression;
+			theExpression.parseExpression( expression );
+			if( theExpression.evaluate( &nodes ) == "1" )
+				++numParsed;
+		}
+		sw.stop();
+		std::cout << "XPath parsed " << numNodes << ',' << sw.getMillis() << "ms" << std::endl;
+
+		sw.start();
+		size_t		numCached = 0;
+		for( nodes.first(); nodes.current(); nodes.next() )
+		{
+			if( xml::evaluate( expression, &nodes ) == "1" )
+				++numCached;
+		}
+		sw.stop();
+		std::cout << "XPath cached " << numNodes << ',' << sw.getMillis() << "ms" << std::endl;
+
+		UT_ASSERT_EQUAL( numNodes/2, numParsed );
+		UT_ASSERT_EQUAL( numParsed, numCached );
+	}
+	void doElementIndexTests()
+	{
+		const size_t	numNodes = 5000;
+		const size_t	numLookups = 500;
+
+		xml::Document	theDoc( "index" );
+		xml::Any		*theRoot = new xml::Any( "osm" );
+		theDoc.addObject( theRoot );
+		for( size_t i=0; i<numNodes; i++ )
+		{
+			xml::Any *theNode = new xml::Any( "node" );
+			theNode->setIntegerAttribute( "id", int(i) );
+			theNode->addObject( new xml::Any( i % 2 ? "tag" : "nd" ) );
+			theRoot->addObject( theNode );
+		}
+		theRoot->addObject( new xml::Any( "way" ) );
+
+		StopWatch	sw( true );
+		size_t		numScanned = 0;
+		for( size_t i=0; i<numLookups; i++ )
+		{
+			if( theRoot->getElement( "way" ) && theDoc.findElement( "tag" ) )
+				++numScanned;
+		}
+		sw.stop();
+		std::cout << "Element scanned " << numLookups << ',' << sw.getMillis() << "ms" << std::endl;
+
+		theDoc.enableIndex();
+		sw.start();
+		size_t		numIndexed = 0;
+		for( size_t i=0; i<numLookups; i++ )
+		{
+			if( theRoot->getElement( "way" ) && theDoc.findElement( "tag" ) )
+				++numIndexed;
+		}
+		sw.stop();
+		std::cout << "Element indexed " << numLookups << ',' << sw.getMillis() << "ms" << std::endl;
+
+		UT_ASSERT_EQUAL( numLookups, numScanned );
+		UT_ASSERT_EQUAL( numScanned, numIndexed );
+	}
 	void doTest( size_t numData )
 	{
 		Btree<STRING>			myBtree;
@@ -175,6 +742,23 @@ class PerformanceTest : public UnitTest
 
 		std::cout << "GAKLIB: " << endTimeGak << " vs STDLIB: " << endTimeStd << '\n';
 		std::cout << "std:string in gak::Array: " << endTimeStdGak << " vs " << "gak::STRING in std::vector: " << endTimeGakStd << '\n';
+
+		doPoolTest( pmDispatcher, "Dispatcher" );
+		doPoolTest( pmWorkStealing, "WorkStealing" );
+
+		doQueueTest< BlockedQueue<int> >( "BlockedQueue" );
+		doQueueTest< MpmcQueue<int> >( "MpmcQueue" );
+		doQueueTest< BlockedQueue<int, MpmcQueue<int> > >( "BlockedQueue<MpmcQueue>" );
+
+		doStringTests();
+
+		doTreeTests();
+		doMapTests();
+		doIndexTests();
+		doStreamTests();
+		doXmlTests();
+		doXPathTests();
+		doElementIndexTests();
 	}
 };
 
@@ -39,6 +39,7 @@
 // --------------------------------------------------------------------- //
 
 #include <iostream>
+#include <limits>
 #include <gak/unitTest.h>
 
 #include <gak/priorityQueue.h>
@@ -96,14 +97,104 @@ class PriorityQueueTest : public UnitTest
 			TestScope scope("PriorityQueue2");
 			simpleTest<PriorityQueue2<Priority> >();
 		}
+		{
+			TestScope scope("HeapQueue");
+			simpleTest<HeapQueue<Priority> >();
+			handleTest();
+		}
+		{
+			TestScope scope("RadixQueue");
+			radixTest();
+		}
 #ifdef NDEBUG
 		Hours<>	speed = speedTest<PriorityQueue<Priority> >();
 		Hours<>	speed2 = speedTest<PriorityQueue2<Priority> >();
+		Hours<>	speed3 = speedTest<HeapQueue<Priority> >();
 
-		std::cout << speed.toString() << " vs. " << speed2.toString() << std::endl;
+		std::cout << speed.toString() << " vs. " << speed2.toString() << " vs. " << speed3.toString() << std::endl;
 #endif
 	}
 
+	void handleTest()
+	{
+		HeapQueue<Priority>	myQueue;
+		const int			numItems = 1000;
+		size_t				handles[numItems];
+		double				priorities[numItems];
+
+		// the same pseudo random priorities in every run
+		for( int i=0; i<numItems; ++i )
+		{
+			priorities[i] = double((i*7919) % numItems);
+			handles[i] = myQueue.push( Priority( priorities[i], i ) );
+		}
+		UT_ASSERT_EQUAL( myQueue.size(), size_t(numItems) );
+		UT_ASSERT_EQUAL( myQueue.top().m_priority, double(numItems-1) );
+
+		// move every third item to the front or the back
+		for( int i=0; i<numItems; i+=3 )
+		{
+			UT_ASSERT_TRUE( myQueue.contains( handles[i] ) );
+			priorities[i] = i % 2 ? double(numItems+i) : double(-i);
+			myQueue.changePriority( handles[i], priorities[i] );
+		}
+		myQueue.remove( handles[1] );
+		UT_ASSERT_FALSE( myQueue.contains( handles[1] ) );
+		UT_ASSERT_EQUAL( myQueue.size(), size_t(numItems-1) );
+		UT_ASSERT_EQUAL( myQueue.getPriority( handles[3] ), double(numItems+3) );
+
+		double	lastPriority = std::numeric_limits<double>::max();
+		size_t	count = 0;
+		while( myQueue.size() )
+		{
+			Priority	val = myQueue.pop();
+			double		priority = priorities[val.m_value];
+			UT_ASSERT_LESSEQ( priority, lastPriority );
+			UT_ASSERT_NOT_EQUAL( val.m_value, 1 );
+			UT_ASSERT_FALSE( myQueue.contains( handles[val.m_value] ) );
+			lastPriority = priority;
+			++count;
+		}
+		UT_ASSERT_EQUAL( count, size_t(numItems-1) );
+		UT_ASSERT_EXCEPTION( myQueue.top(), QueueEmptyError );
+
+		// handles of fetched items are reused
+		size_t handle = myQueue.push( Priority( 1.0, 0 ) );
+		UT_ASSERT_LESS( handle, size_t(numItems) );
+		UT_ASSERT_TRUE( myQueue.contains( handle ) );
+	}
+
+	void radixTest()
+	{
+		RadixQueue<RadixItem>	myQueue;
+		const int				numItems = 1000;
+
+		for( int i=0; i<numItems; ++i )
+		{
+			myQueue.push( RadixItem( uint64((i*7919) % numItems) * 1000, i ) );
+		}
+		UT_ASSERT_EQUAL( myQueue.size(), size_t(numItems) );
+
+		uint64	lastKey = 0;
+		for( int i=0; i<numItems; ++i )
+		{
+			RadixItem	val = myQueue.pop();
+			UT_ASSERT_EQUAL( val.m_key, uint64(i) * 1000 );
+			UT_ASSERT_EQUAL( myQueue.getLastKey(), val.m_key );
+			UT_ASSERT_LESSEQ( lastKey, val.m_key );
+			lastKey = val.m_key;
+
+			// monotone pushes like Dijkstra's algorithm does
+			if( i % 10 == 0 )
+			{
+				myQueue.push( RadixItem( lastKey + 1, -1 ) );
+				UT_ASSERT_EQUAL( myQueue.pop().m_value, -1 );
+			}
+		}
+		UT_ASSERT_EQUAL( myQueue.size(), size_t(0) );
+		UT_ASSERT_EXCEPTION( myQueue.pop(), QueueEmptyError );
+	}
+
 	template <typename PriorityQueueT>
 	void simpleTest()
 	{
@@ -184,6 +275,9 @@ class PriorityQueueTest : public UnitTest
 		double	m_priority;
 		int		m_value;
 
+		Priority() : m_priority(0), m_value(0)
+		{
+		}
 		Priority( double priority, int value ) : m_priority(priority), m_value(value)
 		{
 		}
@@ -193,6 +287,23 @@ class PriorityQueueTest : public UnitTest
 			return m_priority;
 		}
 	};
+	struct RadixItem
+	{
+		uint64	m_key;
+		int		m_value;
+
+		RadixItem() : m_key(0), m_value(0)
+		{
+		}
+		RadixItem( uint64 key, int value ) : m_key(key), m_value(value)
+		{
+		}
+
+		uint64 getPriority( ) const
+		{
+			return m_key;
+		}
+	};
 };
 
 // --------------------------------------------------------------------- //
@@ -100,6 +100,9 @@ double getLinkCost( const double &link, bool costType )
 // ----- type definitions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/// a graph with the costs of the links, used with getLinkCost( double, bool )
+typedef Graph<double, double, GraphTree, size_t, size_t>	GridGraph;
+
 // --------------------------------------------------------------------- //
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -274,6 +277,42 @@ static RoutingTest	myRoutingTest;
 // ----- module functions ---------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	a grid with pseudo random costs, some links are one way. The link keys
+	are linkStep, 2*linkStep, ...
+*/
+static void createGrid( GridGraph *graph, size_t width, size_t height, size_t linkStep=1 )
+{
+	size_t	linkID = 0;
+
+	for( size_t i=0; i<width*height; ++i )
+	{
+		graph->addNode( i, double(i) );
+	}
+	for( size_t y=0; y<height; ++y )
+	{
+		for( size_t x=0; x<width; ++x )
+		{
+			size_t	node = y*width + x;
+			double	cost = double((node*7919) % 97 + 1);
+
+			if( x+1 < width )
+			{
+				graph->addLink( linkID += linkStep, cost, node, node+1 );
+				if( node % 7 )
+				{
+					graph->addLink( linkID += linkStep, cost+3, node+1, node );
+				}
+			}
+			if( y+1 < height )
+			{
+				graph->addLink( linkID += linkStep, cost+1, node, node+width );
+				graph->addLink( linkID += linkStep, cost+2, node+width, node );
+			}
+		}
+	}
+}
+
 // --------------------------------------------------------------------- //
 // ----- class inlines ------------------------------------------------- //
 // --------------------------------------------------------------------- //
@@ -43,6 +43,7 @@
 #include <gak/unitTest.h>
 
 #include <gak/shared.h>
+#include <gak/thread.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -92,6 +93,40 @@ class SharedTest : public UnitTest
 		SharedObjectPointerTest();
 		SharedPointerTest();
 		XSharedPointerTest();
+		ConcurrentSharingTest();
+	}
+	void ConcurrentSharingTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "SharedTest::ConcurrentSharingTest");
+
+		const int		numThreads = 4;
+		Array< SharedObjectPointer<SharingThread> >	threads;
+		{
+			SharedObjectPointer<MySharedObject>	object = new MySharedObject( 666 );
+			STRING								text = "Hello shared world";
+
+			for( int i=0; i<numThreads; ++i )
+			{
+				threads.addElement( SharedObjectPointer<SharingThread>( new SharingThread( object, text ) ) );
+			}
+			for( int i=0; i<numThreads; ++i )
+			{
+				threads[i]->StartThread();
+			}
+			for( int i=0; i<numThreads; ++i )
+			{
+				threads[i]->join();
+				UT_ASSERT_TRUE( threads[i]->m_ok );
+			}
+			UT_ASSERT_EQUAL( object->getUsageCount(), numThreads+1 );
+			UT_ASSERT_EQUAL( text.getUsageCount(), size_t(numThreads+1) );
+			UT_ASSERT_EQUAL( 1, MySharedObject::s_objectCount );
+			threads.clear();
+			UT_ASSERT_EQUAL( object->getUsageCount(), 1 );
+			UT_ASSERT_EQUAL( text.getUsageCount(), size_t(1) );
+		}
+		UT_ASSERT_EQUAL( 0, MySharedObject::s_objectCount );
+		UT_ASSERT_LESSEQ( sizeof( MySharedObject ), 3*sizeof( int ) );
 	}
 	void SharedObjectPointerTest()
 	{
@@ -233,6 +268,38 @@ class SharedTest : public UnitTest
 			assert( s_objectCount >= 0 );
 		}
 	};
+	struct SharingThread : public Thread
+	{
+		SharedObjectPointer<MySharedObject>	m_object;
+		STRING								m_text;
+		bool								m_ok;
+
+		SharingThread( const SharedObjectPointer<MySharedObject> &object, const STRING &text )
+		: m_object( object ), m_text( text ), m_ok( false )
+		{
+		}
+		virtual void ExecuteThread()
+		{
+			m_ok = true;
+			for( int i=0; i<100000; ++i )
+			{
+				SharedObjectPointer<MySharedObject>	object = m_object;
+				STRING								text = m_text;
+				if( object->m_value != 666 )
+				{
+					m_ok = false;
+				}
+				if( i % 1000 == 0 )
+				{
+					text += "!";
+					if( text.strlen() != m_text.strlen()+1 )
+					{
+						m_ok = false;
+					}
+				}
+			}
+		}
+	};
 	struct MyObject
 	{
 		static int	s_objectCount;
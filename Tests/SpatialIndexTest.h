@@ -0,0 +1,422 @@
+/*
+		Project:		GAKLIB
+		Module:			SpatialIndexTest.h
+		Description:	
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <gak/unitTest.h>
+
+#include <gak/spatialIndex.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class SpatialIndexTest : public UnitTest
+{
+	struct Point
+	{
+		float	longitude, latitude;
+		int		key;
+		bool	removed;
+	};
+	typedef SpatialIndex<int>							Index;
+	typedef SpatialIndex<int, SpatialBoxEntry<int> >	BoxIndex;
+
+	virtual const char *GetClassName() const
+	{
+		return "SpatialIndexTest";
+	}
+
+	static float randomCoord( float min, float range )
+	{
+		return min + float( std::rand() % 100000 ) / 100000.0f * range;
+	}
+
+	static double getDistance( const Point &point, float longitude, float latitude )
+	{
+		double	lonFactor = std::cos( math::degree2radians( double(latitude) ) );
+		double	dx = (double(point.longitude) - longitude) * lonFactor;
+		double	dy = double(point.latitude) - latitude;
+
+		return std::sqrt( dx*dx + dy*dy );
+	}
+
+	/*
+		compares the region and nearest neighbour queries with a brute force search
+	*/
+	void checkQueries( const Index &index, const Array<Point> &points )
+	{
+		std::size_t	numPoints = 0;
+		for( std::size_t i=0; i<points.size(); ++i )
+		{
+			if( !points[i].removed )
+			{
+				++numPoints;
+			}
+		}
+		UT_ASSERT_EQUAL( index.size(), numPoints );
+
+		for( int query=0; query<50; ++query )
+		{
+			float		longitude = randomCoord( 11, 1 );
+			float		latitude = randomCoord( 48, 1 );
+			SpatialBox	region(
+				longitude, latitude,
+				longitude + randomCoord( 0, 0.3f ), latitude + randomCoord( 0, 0.3f )
+			);
+
+			Array<int>	found;
+			index.getRegion( region, &found );
+
+			std::size_t	numExpected = 0;
+			for( std::size_t i=0; i<points.size(); ++i )
+			{
+				const Point	&point = points[i];
+				if( !point.removed && region.contains( point.longitude, point.latitude ) )
+				{
+					++numExpected;
+					UT_ASSERT_TRUE( found.hasElement( point.key ) );
+				}
+			}
+			UT_ASSERT_EQUAL( found.size(), numExpected );
+
+			const double		maxDistance = 0.2;
+			const std::size_t	count = 5;
+			Array<double>		distances;
+			for( std::size_t i=0; i<points.size(); ++i )
+			{
+				double	distance = getDistance( points[i], longitude, latitude );
+				if( !points[i].removed && distance <= maxDistance )
+				{
+					distances.addElement( distance );
+				}
+			}
+			if( distances.size() )
+			{
+				distances.sort( FixedComparator<double>() );
+			}
+
+			Array<int>	nearest;
+			index.findNearest( longitude, latitude, maxDistance, count, &nearest );
+			UT_ASSERT_EQUAL( nearest.size(), math::min( count, distances.size() ) );
+			for( std::size_t i=0; i<nearest.size() && i<distances.size(); ++i )
+			{
+				const Point	&point = points[nearest[i]];
+				UT_ASSERT_FALSE( point.removed );
+				UT_ASSERT_EQUAL_FLT( getDistance( point, longitude, latitude ), distances[i], 1e-9 );
+			}
+
+			Optional<int>	next = index.findNearest( longitude, latitude, maxDistance );
+			UT_ASSERT_EQUAL( next.isPresent(), distances.size() > 0 );
+			if( next.isPresent() && distances.size() )
+			{
+				UT_ASSERT_EQUAL_FLT( getDistance( points[next.get()], longitude, latitude ), distances[0], 1e-9 );
+			}
+		}
+	}
+
+	void addPoints( Index *index, Array<Point> *points, std::size_t count )
+	{
+		for( std::size_t i=0; i<count; ++i )
+		{
+			Point	point = { randomCoord( 11, 1 ), randomCoord( 48, 1 ), int(points->size()), false };
+
+			points->addElement( point );
+			index->addElement( point.longitude, point.latitude, point.key );
+		}
+	}
+
+	void removePoints( Index *index, Array<Point> *points, std::size_t step )
+	{
+		for( std::size_t i=0; i<points->size(); i += step )
+		{
+			Point	&point = (*points)[i];
+			UT_ASSERT_EQUAL( index->removeElement( point.longitude, point.latitude, point.key ), !point.removed );
+			point.removed = true;
+		}
+	}
+
+	void testSmall()
+	{
+		TestScope scope( "testSmall" );
+
+		Index			index;
+		Array<Point>	points;
+
+		UT_ASSERT_EQUAL( index.size(), std::size_t(0) );
+		UT_ASSERT_FALSE( index.findNearest( 11, 48, 180 ).isPresent() );
+		checkQueries( index, points );
+
+		// a small index is not packed, the queries scan all entries
+		addPoints( &index, &points, 17 );
+		UT_ASSERT_EQUAL( index.getNumUnpacked(), std::size_t(17) );
+		checkQueries( index, points );
+
+		removePoints( &index, &points, 3 );
+		UT_ASSERT_FALSE( index.removeElement( 0, 0, 4711 ) );
+		checkQueries( index, points );
+
+		index.pack();
+		UT_ASSERT_EQUAL( index.getNumUnpacked(), std::size_t(0) );
+		checkQueries( index, points );
+
+		index.clear();
+		UT_ASSERT_EQUAL( index.size(), std::size_t(0) );
+	}
+
+	void testLarge()
+	{
+		TestScope scope( "testLarge" );
+
+		Index			index;
+		Array<Point>	points;
+
+		addPoints( &index, &points, 10000 );
+		UT_ASSERT_LESSEQ( index.getNumUnpacked(), std::size_t(10000/8) );
+		checkQueries( index, points );
+
+		// removed entries of the packed part are kept until the next pack
+		removePoints( &index, &points, 7 );
+		checkQueries( index, points );
+		addPoints( &index, &points, 100 );
+		checkQueries( index, points );
+
+		index.pack();
+		UT_ASSERT_EQUAL( index.getNumUnpacked(), std::size_t(0) );
+		checkQueries( index, points );
+
+		// the packed tree contains all entries
+		SpatialTree<Index::Entry>	tree = index.getPackedTree();
+		UT_ASSERT_EQUAL( tree.size(), index.size() );
+		UT_ASSERT_EQUAL( tree.getNumBoxes(), SpatialTree<Index::Entry>::getNumBoxes( index.size() ) );
+
+		// the flat layout can be written and read as it is
+		std::stringstream	stream;
+		index.toBinaryStream( stream );
+		Index	loaded;
+		loaded.fromBinaryStream( stream );
+		checkQueries( loaded, points );
+
+		Index	merged;
+		merged.merge( index );
+		UT_ASSERT_EQUAL( merged.size(), index.size() );
+		checkQueries( merged, points );
+	}
+
+	/*
+		compares the region query of boxes with a brute force search
+	*/
+	void checkBoxes( const BoxIndex &index, const Array<SpatialBox> &boxes, const Array<bool> &removed )
+	{
+		for( int i=0; i<50; ++i )
+		{
+			float		longitude = randomCoord( 11, 1 );
+			float		latitude = randomCoord( 48, 1 );
+			SpatialBox	region( longitude, latitude, longitude + randomCoord( 0, 0.05f ), latitude + randomCoord( 0, 0.05f ) );
+
+			Array<int>	found;
+			index.getRegion( region, &found );
+
+			std::size_t	expected = 0;
+			for( std::size_t j=0; j<boxes.size(); ++j )
+			{
+				if( !removed[j] && boxes[j].intersects( region ) )
+				{
+					++expected;
+					UT_ASSERT_TRUE( found.hasElement( int(j) ) );
+				}
+			}
+			UT_ASSERT_EQUAL( found.size(), expected );
+		}
+	}
+
+	void testBoxes()
+	{
+		TestScope scope( "testBoxes" );
+
+		BoxIndex			index;
+		Array<SpatialBox>	boxes;
+		Array<bool>			removed;
+
+		for( int i=0; i<3000; ++i )
+		{
+			float		longitude = randomCoord( 11, 1 );
+			float		latitude = randomCoord( 48, 1 );
+			SpatialBox	box( longitude, latitude, longitude + randomCoord( 0, 0.1f ), latitude + randomCoord( 0, 0.1f ) );
+
+			boxes.addElement( box );
+			removed.addElement( false );
+			index.addElement( box, i );
+		}
+		checkBoxes( index, boxes, removed );
+
+		// a box covering the whole region is found, too
+		Array<int>	found;
+		index.addElement( SpatialBox( 10, 47, 13, 50 ), int(boxes.size()) );
+		index.getRegion( SpatialBox( 11.5f, 48.5f, 11.5001f, 48.5001f ), &found );
+		UT_ASSERT_TRUE( found.hasElement( int(boxes.size()) ) );
+		UT_ASSERT_TRUE( index.removeElement( SpatialBox( 10, 47, 13, 50 ), int(boxes.size()) ) );
+
+		for( std::size_t i=0; i<boxes.size(); i += 5 )
+		{
+			UT_ASSERT_TRUE( index.removeElement( boxes[i], int(i) ) );
+			removed[i] = true;
+		}
+		UT_ASSERT_FALSE( index.removeElement( boxes[0], 0 ) );
+		checkBoxes( index, boxes, removed );
+
+		index.pack();
+		UT_ASSERT_EQUAL( index.size(), boxes.size() - (boxes.size()+4)/5 );
+		checkBoxes( index, boxes, removed );
+
+		// the nearest box contains the position
+		Optional<int>	next = index.findNearest( boxes[1].minLongitude, boxes[1].minLatitude, 1 );
+		UT_ASSERT_TRUE( next.isPresent() );
+		if( next.isPresent() )
+		{
+			UT_ASSERT_TRUE( boxes[next.get()].contains( boxes[1].minLongitude, boxes[1].minLatitude ) );
+		}
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "SpatialIndexTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		std::srand( 4711 );
+		testSmall();
+		testLarge();
+		testBoxes();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static SpatialIndexTest mySpatialIndexTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
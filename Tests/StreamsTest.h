@@ -100,6 +100,34 @@ struct RandomChar
 
 const size_t	RandomChar::NUM_ITEMS;
 
+/*
+	a sink slower than the stages of its stream, records the max. number of
+	items the source created but the sink did not consume yet
+*/
+struct SlowConsumer
+{
+	streams::Stream<int>	m_source;
+	std::size_t				*m_maxWaiting;
+	std::size_t				m_numItems;
+
+	SlowConsumer( const streams::Stream<int> &source, std::size_t *maxWaiting )
+	: m_source( source ), m_maxWaiting( maxWaiting ), m_numItems( 0 )
+	{
+	}
+	void operator () ( const int & )
+	{
+		std::size_t	numWaiting = m_source->getNumItems() - m_numItems;
+		if( numWaiting > *m_maxWaiting )
+		{
+			*m_maxWaiting = numWaiting;
+		}
+		if( ++m_numItems % 64 == 0 )
+		{
+			Sleep( 1 );
+		}
+	}
+};
+
 static std::size_t numOddCalls = 0;
 static std::size_t numOddSucces = 0;
 static std::size_t numEvenCalls = 0;
@@ -134,6 +162,10 @@ class StreamsTest : public UnitTest
 		FunctionSourceTest();
 		FlatmapSourceTest();
 		AllTests();
+		FusedTest();
+		ChunkTest();
+		ParallelTest();
+		BackpressureTest();
 	}
 	void FileTest()
 	{
@@ -579,6 +611,227 @@ class StreamsTest : public UnitTest
 		UT_ASSERT_EQUAL( resultArray.size(), evenFlatmapSize+oddFlatmapSize+RandomChar::NUM_ITEMS );
 	}
 
+	void FusedTest()
+	{
+		resetCounters();
+
+		doLogValue( "Creating ContainerStream1" );
+		streams::Stream<STRING>	strStream1 = streams::makeContainerStream( myStrings2 );
+		strStream1->setName("strStream1");
+
+		doLogValue( "Creating fusedStream" );
+		streams::Stream<STRING>	fusedStream = strStream1->fuse()
+			.map<char>( static_cast<char (*)(const STRING &)>(firstLetter) )
+			.filter( static_cast<bool (*)( char )>(filterEven) )
+			.flatMap<STRING>( static_cast<void (*)( char, streams::StreamBuffer<STRING> &)>(flatmap3) )
+			.toStream();
+		fusedStream->setName("fusedStream");
+
+		doLogValue( "Creating strSink2" );
+		Array<STRING>	resultArray;
+		streams::Sink<
+			STRING, 
+			streams::ContainerSinkFunction< 
+				std::back_insert_iterator< 
+					Array<STRING> 
+				>, 
+				STRING 
+			> 
+		>	strSink2 = fusedStream->addContainerSink(
+			std::back_inserter( resultArray ) 
+		);
+		strSink2->setName("strSink2");
+
+		strSink2->start();
+		strSink2->wait();
+
+		UT_ASSERT_EQUAL( strStream1->getNumItemsDispatched(), array2Size );
+		UT_ASSERT_EQUAL( array2Size, numEvenCalls );
+
+		UT_ASSERT_EQUAL( fusedStream->getNumItems(), numEvenSucces*3 );
+		UT_ASSERT_EQUAL( fusedStream->getNumItemsProcessed(), numEvenSucces*3 );
+		UT_ASSERT_EQUAL( fusedStream->getNumItemsDispatched(), numEvenSucces*3 );
+		UT_ASSERT_EQUAL( fusedStream->getNumItemsWaiting(), size_t(0) );
+
+		UT_ASSERT_EQUAL( resultArray.size(), numEvenSucces*3 );
+		for( size_t i=0, j=0; i<array2Size; ++i )
+		{
+			char	c = myStrings2[i][0U];
+			if( c % 2 == 0 )
+			{
+				UT_ASSERT_EQUAL( resultArray[j], STRING(c) );
+				j += 3;
+			}
+		}
+
+		resetCounters();
+	}
+	void ChunkTest()
+	{
+		const size_t	numItems = streams::STREAM_CHUNK_SIZE*3+17;
+		Array<int>		numbers;
+		for( size_t i=0; i<numItems; ++i )
+		{
+			numbers.addElement( int(i) );
+		}
+
+		streams::Stream<int>	numStream = streams::makeContainerStream( numbers );
+		numStream->setName("numStream");
+		streams::Stream<int>	squareStream = numStream->map<int>( static_cast<int (*)( int )>(square) );
+		squareStream->setName("squareStream");
+
+		Array<int>	resultArray1, resultArray2;
+		streams::Sink<
+			int, 
+			streams::ContainerSinkFunction< 
+				std::back_insert_iterator< 
+					Array<int> 
+				>, 
+				int
+			> 
+		>	sink1 = squareStream->addContainerSink(
+			std::back_inserter( resultArray1 ) 
+		);
+		sink1->setName("sink1");
+		streams::Sink<
+			int, 
+			streams::ContainerSinkFunction< 
+				std::back_insert_iterator< 
+					Array<int> 
+				>, 
+				int
+			> 
+		>	sink2 = squareStream->addContainerSink(
+			std::back_inserter( resultArray2 ) 
+		);
+		sink2->setName("sink2");
+
+		sink1->start();
+		sink2->start();
+		sink1->wait();
+		sink2->wait();
+
+		UT_ASSERT_EQUAL( numStream->getNumItemsDispatched(), numItems );
+		UT_ASSERT_EQUAL( squareStream->getNumItemsDispatched(), numItems );
+		UT_ASSERT_EQUAL( squareStream->getNumItemsWaiting(), size_t(0) );
+
+		UT_ASSERT_EQUAL( resultArray1.size(), numItems );
+		UT_ASSERT_EQUAL( resultArray1, resultArray2 );
+		for( size_t i=0; i<numItems; ++i )
+		{
+			UT_ASSERT_EQUAL( resultArray1[i], int(i*i) );
+		}
+	}
+
+	static Array<int> collectInts( streams::Stream<int> &stream )
+	{
+		Array<int>	resultArray;
+		streams::Sink<
+			int, 
+			streams::ContainerSinkFunction< 
+				std::back_insert_iterator< 
+					Array<int> 
+				>, 
+				int
+			> 
+		>	sink = stream->addContainerSink(
+			std::back_inserter( resultArray ) 
+		);
+		sink->setName("sink");
+		sink->start();
+		sink->wait();
+
+		return resultArray;
+	}
+	void ParallelTest()
+	{
+		const size_t	numItems = streams::STREAM_CHUNK_SIZE*10+5;
+		Array<int>		numbers;
+		for( size_t i=0; i<numItems; ++i )
+		{
+			numbers.addElement( int(i) );
+		}
+
+		{
+			streams::Stream<int>	squareStream = streams::makeContainerStream( numbers )
+				->parallelMap<int>( static_cast<int (*)( int )>(square), 3 );
+			Array<int>	resultArray = collectInts( squareStream );
+
+			UT_ASSERT_EQUAL( resultArray.size(), numItems );
+			for( size_t i=0; i<numItems; ++i )
+			{
+				UT_ASSERT_EQUAL( resultArray[i], int(i*i) );
+			}
+		}
+		{
+			streams::Stream<int>	squareStream = streams::makeContainerStream( numbers )
+				->parallelMap<int>( static_cast<int (*)( int )>(square), 4, streams::poUnordered, 2 );
+			Array<int>	resultArray = collectInts( squareStream );
+
+			UT_ASSERT_EQUAL( resultArray.size(), numItems );
+			resultArray.sort( FixedComparator<int>() );
+			for( size_t i=0; i<numItems; ++i )
+			{
+				UT_ASSERT_EQUAL( resultArray[i], int(i*i) );
+			}
+		}
+		{
+			streams::Stream<int>	evenStream = streams::makeContainerStream( numbers )
+				->parallelFilter( static_cast<bool (*)( int )>(isEven), 2, streams::poOrdered, 1 );
+			Array<int>	resultArray = collectInts( evenStream );
+
+			UT_ASSERT_EQUAL( resultArray.size(), (numItems+1)/2 );
+			for( size_t i=0; i<resultArray.size(); ++i )
+			{
+				UT_ASSERT_EQUAL( resultArray[i], int(i*2) );
+			}
+		}
+		{
+			streams::Stream<int>	fusedStream = streams::makeContainerStream( numbers )->fuse()
+				.filter( static_cast<bool (*)( int )>(isEven) )
+				.map<int>( static_cast<int (*)( int )>(square) )
+				.toParallelStream( 0 );
+			Array<int>	resultArray = collectInts( fusedStream );
+
+			UT_ASSERT_EQUAL( resultArray.size(), (numItems+1)/2 );
+			for( size_t i=0; i<resultArray.size(); ++i )
+			{
+				UT_ASSERT_EQUAL( resultArray[i], int(i*i*4) );
+			}
+		}
+	}
+
+	void BackpressureTest()
+	{
+		const size_t	numItems = streams::STREAM_CHUNK_SIZE*200;
+		const size_t	maxInFlight = 2;
+		Array<int>		numbers;
+		for( size_t i=0; i<numItems; ++i )
+		{
+			numbers.addElement( int(i) );
+		}
+
+		streams::Stream<int>	numStream = streams::makeContainerStream( numbers );
+		streams::Stream<int>	squareStream = numStream
+			->parallelMap<int>( static_cast<int (*)( int )>(square), 2, streams::poOrdered, maxInFlight );
+
+		std::size_t						maxWaiting = 0;
+		streams::Sink<int, SlowConsumer>	sink = squareStream->addSink(
+			SlowConsumer( numStream, &maxWaiting )
+		);
+		sink->start();
+		sink->wait();
+
+		/*
+			the buffer of the source, the input buffer, the output buffer and
+			the buffer of the sink may exceed their capacity by one chunk, the
+			pool and the sink hold the other chunks
+		*/
+		UT_ASSERT_EQUAL( squareStream->getNumItemsProcessed(), numItems );
+		UT_ASSERT_LESSEQ( maxWaiting, (4*(maxInFlight+1) + maxInFlight+1)*streams::STREAM_CHUNK_SIZE );
+		UT_ASSERT_GREATER( maxWaiting, size_t(0) );
+	}
+
 	Array<STRING>	myStrings1;
 	Array<STRING>	myStrings2;
 
@@ -614,6 +867,14 @@ class StreamsTest : public UnitTest
 		doLogValue( val[0U] );
 		return val[0U];
 	}
+	static int square( int i )
+	{
+		return i*i;
+	}
+	static bool isEven( int i )
+	{
+		return i % 2 == 0;
+	}
 	static bool filterEven( char c )
 	{
 		doEnterFunction("filterEven");
@@ -42,6 +42,7 @@
 
 #include <gak/ci_string.h>
 #include <gak/t_string.h>
+#include <gak/strArena.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -99,6 +100,50 @@ class StringTest : public UnitTest
 		OtherTests();
 
 		FileTests();
+		ArenaTests();
+	}
+	void ArenaTests()
+	{
+		STRING	survivor;
+		STRING	large;
+		size_t	blockCount, chunkCount, usedBytes;
+		{
+			StrArena	arena;
+			{
+				StrArenaScope	scope( arena );
+
+				STRING	word = "arena";
+				STRING	copy = word;
+				copy += " word";
+				survivor = copy;
+
+				STRING	longWord( 'x', StrArena::MAX_BLOCK_SIZE );
+				large = longWord;
+
+				word += STRING( 'y', 100 );
+			}
+			blockCount = arena.getBlockCount();
+			chunkCount = arena.getChunkCount();
+			usedBytes = arena.getUsedBytes();
+		}
+		UT_ASSERT_EQUAL( blockCount, size_t(1) );
+		UT_ASSERT_EQUAL( chunkCount, size_t(1) );
+		UT_ASSERT_GREATER( usedBytes, size_t(0) );
+
+		// the buffer outlives the arena
+		UT_ASSERT_EQUAL( survivor, STRING("arena word") );
+		survivor += '!';
+		UT_ASSERT_EQUAL( survivor, STRING("arena word!") );
+		UT_ASSERT_EQUAL( large.strlen(), size_t(StrArena::MAX_BLOCK_SIZE) );
+
+		// small strings grow out of the small buffers
+		STRING	growing;
+		for( size_t i=0; i<100; ++i )
+		{
+			growing += char( 'a' + i % 26 );
+		}
+		UT_ASSERT_EQUAL( growing.strlen(), size_t(100) );
+		UT_ASSERT_EQUAL( growing.leftString( 3 ), STRING("abc") );
 	}
 	void ComparingTests()
 	{
@@ -0,0 +1,253 @@
+/*
+		Project:		GAKLIB
+		Module:			TextReaderTest.h
+		Description:	testing the TextReader
+		Author:			Martin Gckler
+		Address:		Hofmannsthalweg 14, A-4030 Linz
+		Web:			https://www.gaeckler.at/
+
+		Copyright:		(c) 1988-2026 Martin Gckler
+
+		This program is free software: you can redistribute it and/or modify  
+		it under the terms of the GNU General Public License as published by  
+		the Free Software Foundation, version 3.
+
+		You should have received a copy of the GNU General Public License 
+		along with this program. If not, see <http://www.gnu.org/licenses/>.
+
+		THIS SOFTWARE IS PROVIDED BY Martin Gckler, Linz, Austria ``AS IS''
+		AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED
+		TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+		PARTICULAR PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE AUTHOR OR
+		CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+		SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT
+		LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF
+		USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+		ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+		OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT
+		OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF
+		SUCH DAMAGE.
+*/
+
+// --------------------------------------------------------------------- //
+// ----- switches ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- includes ------------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+#include <iostream>
+#include <gak/unitTest.h>
+#include <gak/textReader.h>
+#include <gak/stringStream.h>
+
+// --------------------------------------------------------------------- //
+// ----- imported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module switches ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+#ifdef __BORLANDC__
+#	pragma option -RT-
+#	pragma option -b
+#	pragma option -a4
+#	pragma option -pc
+#endif
+
+namespace gak
+{
+
+// --------------------------------------------------------------------- //
+// ----- constants ----------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- macros -------------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- type definitions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class definitions --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+class TextReaderTest : public UnitTest
+{
+	virtual const char *GetClassName() const
+	{
+		return "TextReaderTest";
+	}
+
+	void testCharacters()
+	{
+		TestScope scope( "testCharacters" );
+
+		// more than one block to test the refill of the buffer
+		STRING	text;
+		for( int i=0; i<2000; ++i )
+		{
+			text += "line ";
+			text += formatNumber( i );
+			text += '\n';
+		}
+
+		iSTRINGstream	input( text );
+		TextReader		reader( &input );
+		STRING			result;
+		size_t			count = 0;
+
+		while( !reader.eof() )
+		{
+			char c = reader.getNextWithBlank();
+			if( c )
+			{
+				// every character is read twice
+				if( ++count % 2 )
+				{
+					reader.putback( c );
+				}
+				else
+				{
+					result += c;
+				}
+			}
+		}
+		UT_ASSERT_EQUAL( text, result );
+		UT_ASSERT_EQUAL( size_t(2001), reader.getPosition().m_lineNo );
+		UT_ASSERT_EQUAL( char(0), reader.getNextWithBlank() );
+	}
+
+	void testBulk()
+	{
+		TestScope scope( "testBulk" );
+
+		STRING			text = "  ident=\"value\" <tag attr>\n  pc data\n<next";
+		iSTRINGstream	input( text );
+		TextReader		reader( &input, "internal" );
+
+		UT_ASSERT_EQUAL( STRING("ident"), reader.readToken( "=<>" ) );
+		UT_ASSERT_EQUAL( '=', reader.getNextWithBlank() );
+		UT_ASSERT_EQUAL( '"', reader.skipUntil( "\"'" ) );
+		UT_ASSERT_EQUAL( STRING("value"), reader.readString( '"' ) );
+		UT_ASSERT_EQUAL( STRING(" "), reader.readUntil( "<" ) );
+		UT_ASSERT_EQUAL( '<', reader.getNextWithBlank() );
+		UT_ASSERT_EQUAL( STRING("tag"), reader.readToken( "=<>" ) );
+		UT_ASSERT_EQUAL( STRING("attr"), reader.readToken( "=<>" ) );
+		UT_ASSERT_EQUAL( '>', reader.skipUntil( ">" ) );
+		UT_ASSERT_EQUAL( size_t(1), reader.getPosition().m_lineNo );
+		UT_ASSERT_EQUAL( size_t(26), reader.getPosition().m_column );
+
+		UT_ASSERT_EQUAL( STRING("\n  pc data\n"), reader.readUntil( "<" ) );
+		UT_ASSERT_EQUAL( size_t(3), reader.getPosition().m_lineNo );
+		UT_ASSERT_EQUAL( size_t(0), reader.getPosition().m_column );
+
+		reader.skipBlanks();
+		UT_ASSERT_EQUAL( '<', reader.getNextWithBlank() );
+		UT_ASSERT_FALSE( reader.eof() );
+		UT_ASSERT_EQUAL( STRING("next"), reader.readUntil( ">" ) );
+		UT_ASSERT_TRUE( reader.eof() );
+		UT_ASSERT_EQUAL( char(0), reader.skipUntil( ">" ) );
+	}
+
+	void testUTF8()
+	{
+		TestScope scope( "testUTF8" );
+
+		STRING			text = STRING("=\n").encodeUTF8();
+		iSTRINGstream	input( text );
+		TextReader		reader( &input );
+
+		reader.setEncoding( UTF_8 );
+		UT_ASSERT_EQUAL( STRING(""), reader.readToken( "=" ) );
+		UT_ASSERT_EQUAL( size_t(2), reader.getPosition().m_column );
+		UT_ASSERT_EQUAL( '=', reader.getNextWithBlank() );
+
+		char c = reader.getNextWithBlank();
+		UT_ASSERT_EQUAL( '', c );
+		reader.putback( c );
+		UT_ASSERT_EQUAL( '', reader.getNextWithBlank() );
+		UT_ASSERT_EQUAL( '\n', reader.getNextWithBlank() );
+		UT_ASSERT_EQUAL( STRING(""), reader.readString( '\n' ) );
+		UT_ASSERT_EQUAL( size_t(2), reader.getPosition().m_lineNo );
+		UT_ASSERT_EQUAL( size_t(1), reader.getPosition().m_column );
+		UT_ASSERT_FALSE( reader.hasUtf8failure() );
+	}
+
+	virtual void PerformTest()
+	{
+		doEnterFunctionEx(gakLogging::llInfo, "TextReaderTest::PerformTest");
+		TestScope scope( "PerformTest" );
+
+		testCharacters();
+		testBulk();
+		testUTF8();
+	}
+};
+
+// --------------------------------------------------------------------- //
+// ----- exported datas ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module static data -------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+static TextReaderTest myTextReaderTest;
+
+// --------------------------------------------------------------------- //
+// ----- class static data --------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- prototypes ---------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- module functions ---------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class inlines ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class constructors/destructors -------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class static functions ---------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class privates ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class protected ----------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class virtuals ------------------------------------------------ //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- class publics ------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+// --------------------------------------------------------------------- //
+// ----- entry points -------------------------------------------------- //
+// --------------------------------------------------------------------- //
+
+}	// namespace gak
+
+#ifdef __BORLANDC__
+#	pragma option -RT.
+#	pragma option -b.
+#	pragma option -a.
+#	pragma option -p.
+#endif
@@ -227,6 +227,99 @@ class ThreadPoolTest : public UnitTest
 
 			UT_ASSERT_GREATER( mainData.waiting, 0 );
 		}
+		{
+			callCount = 0;
+			ThreadPool<Functor>	pool( 5, "ThreadPoolTest3", nullptr, pmWorkStealing );
+
+			UT_ASSERT_EQUAL( pool.getMode(), pmWorkStealing );
+			UT_ASSERT_EQUAL( pool.getCurrentState(), psIdle );
+			pool.start();
+			UT_ASSERT_EQUAL( pool.getCurrentState(), psWaiting );
+			for( size_t i=0; i<count; ++i )
+			{
+				pool.process( Functor( int(i), &callCount ) );
+			}
+			UT_ASSERT_EQUAL( pool.getCurrentState(), psProssesing );
+			pool.flush();
+			UT_ASSERT_EQUAL( pool.getCurrentState(), psWaiting );
+			UT_ASSERT_EQUAL( count, pool.total() );
+			UT_ASSERT_EQUAL( count, callCount );
+			pool.shutdown();
+			UT_ASSERT_EQUAL( pool.getCurrentState(), psIdle );
+			UT_ASSERT_EXCEPTION(
+				pool.process( Functor( int(0), &callCount ) ),
+				ThreadPoolError
+			);
+		}
+		{
+			const int	numItems = 10000;
+			MainData	mainData;
+			ThreadPool<int>	pool(4, "MyStealingPool", &mainData, pmWorkStealing );
+
+			for( int loop=0; loop<2; ++loop )
+			{
+				mainData.sum = 0;
+				pool.start();
+				for( int i=1; i<=numItems; ++i )
+				{
+					pool.process( i );
+				}
+				pool.flush();
+				UT_ASSERT_EQUAL( pool.size(), size_t(0) );
+				UT_ASSERT_EQUAL( mainData.sum, numItems*(numItems+1)/2 );
+				pool.shutdown();
+			}
+			UT_ASSERT_EQUAL( pool.total(), size_t(2*numItems) );
+		}
+		{
+			const int	numItems = 1000;
+			const int	expected = numItems*(numItems+1)/2;
+			Array<int>	items;
+
+			for( int i=1; i<=numItems; ++i )
+			{
+				items += i;
+			}
+			for( int mode=pmDispatcher; mode<=pmWorkStealing; ++mode )
+			{
+				MainData	mainData;
+				ThreadPool<int>	pool(4, "MyBatchPool", &mainData, PoolMode(mode) );
+
+				pool.start();
+				PoolFuture	future = pool.processBatchAsync( items.cbegin(), items.cend() );
+				UT_ASSERT_TRUE( future.isValid() );
+				UT_ASSERT_TRUE( future.wait() );
+				UT_ASSERT_TRUE( future.isDone() );
+				UT_ASSERT_EQUAL( future.pending(), size_t(0) );
+				UT_ASSERT_EQUAL( mainData.sum, expected );
+
+				PoolFuture	single = pool.processAsync( 7 );
+				UT_ASSERT_TRUE( single.wait() );
+				UT_ASSERT_EQUAL( mainData.sum, expected + 7 );
+
+				pool.processBatch( items );
+				pool.flush();
+				UT_ASSERT_EQUAL( mainData.sum, 2*expected + 7 );
+				UT_ASSERT_EQUAL( pool.total(), size_t(2*numItems+1) );
+				pool.shutdown();
+			}
+		}
+		{
+			callCount = 0;
+			ThreadPool<Functor>	pool( 3, "ThreadPoolTest4", nullptr, pmWorkStealing );
+			PoolFuture			future = PoolFuture::create();
+
+			pool.start();
+			for( int i=0; i<3; ++i )
+			{
+				pool.process( Functor( i, &callCount ), future );
+			}
+			UT_ASSERT_FALSE( future.wait( 10 ) );
+			UT_ASSERT_FALSE( future.isDone() );
+			UT_ASSERT_TRUE( future.wait() );
+			UT_ASSERT_EQUAL( callCount, size_t(3) );
+			pool.shutdown();
+		}
 	}
 	virtual bool canThreadTest()
 	{
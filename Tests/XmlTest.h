@@ -43,6 +43,9 @@
 
 #include <gak/xml.h>
 #include <gak/xmlParser.h>
+#include <gak/xmlPullParser.h>
+#include <gak/XPath.h>
+#include <gak/xmlIndex.h>
 
 // --------------------------------------------------------------------- //
 // ----- imported datas ------------------------------------------------ //
@@ -79,16 +82,406 @@ using namespace xml;
 // ----- class definitions --------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+struct XmlRecorder : public XmlNullProcessor
+{
+	STRING	m_events;
+
+	void processTag( const STRING &tag )
+	{
+		// Parser reports an empty tag at the end of the file
+		if( !tag.isEmpty() )
+		{
+			m_events += "T:" + tag + '\n';
+		}
+	}
+	void processAttribute( 
+		const STRING &, const STRING &attribute, const STRING &value 
+	)
+	{
+		m_events += "A:" + attribute + '=' + value + '\n';
+	}
+	void processAttributes( 
+		const STRING &tag, const PairMap<STRING,STRING> &attributes 
+	)
+	{
+		if( attributes.size() )
+		{
+			m_events += "N:" + tag + ' ' + formatNumber( attributes.size() ) + '\n';
+		}
+	}
+	void processPcData( const STRING &pcData )
+	{
+		m_events += "P:" + pcData + '\n';
+	}
+	void processEndTag( const STRING &tag )
+	{
+		m_events += "E:" + tag + '\n';
+	}
+	void processSpecial( Element *subData )
+	{
+		m_events += "S:" + subData->getValue( PLAIN_MODE ) + '\n';
+	}
+	void processProcessorInstructions( const STRING &tag, const STRING &pi )
+	{
+		m_events += "I:" + tag + pi + '\n';
+	}
+};
+
 class XmlTest : public UnitTest
 {
 	virtual const char *GetClassName() const
 	{
 		return "XmlTest";
 	}
+	void pullParserTest()
+	{
+		TestScope scope( "pullParserTest" );
+		{
+			// same processor calls as Parser::parseXML
+			const char	xml[] =
+				"<osm version=\"0.6\">\n"
+				" <node id=\"1\" lat=\"48.3\" lon=\"14.3\"/>\n"
+				" <way id='2'>\n"
+				"  <nd ref=\"1\" />\n"
+				"  <tag k=\"name\" v=\"Tom &amp; Jerry\"/>\n"
+				"  text &lt;A&gt;\n"
+				" </way>\n"
+				"</osm>\n"
+			;
+
+			XmlRecorder		parserRecorder;
+			STRING			xmlCode = xml;
+			iSTRINGstream	str( xmlCode );
+			Parser			theParser( &str, "internal" );
+			theParser.parseXML( parserRecorder );
+
+			XmlRecorder		pullRecorder;
+			PullParser		thePullParser( xml, sizeof(xml)-1, "internal" );
+			thePullParser.parseXML( pullRecorder );
+
+			UT_ASSERT_EQUAL( parserRecorder.m_events, pullRecorder.m_events );
+			UT_ASSERT_TRUE( pullRecorder.m_events.searchText( "A:v=Tom & Jerry\n" ) != STRING::no_index );
+			UT_ASSERT_TRUE( pullRecorder.m_events.searchText( "P:text <A>\n" ) != STRING::no_index );
+			UT_ASSERT_TRUE( thePullParser.getErrors().isEmpty() );
+		}
+		{
+			// the events with their zero copy tokens
+			const char	xml[] =
+				"<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n"
+				"<!DOCTYPE root>"
+				"<root a=\"x&amp;y&#65;&#x42;\"><!-- comment --><![CDATA[<&amp;>]]>"
+				"<?target some data?><empty/></root>"
+			;
+			PullParser	parser( xml, sizeof(xml)-1 );
+
+			UT_ASSERT_EQUAL( PullParser::etTEXT, parser.next() );
+			UT_ASSERT_TRUE( parser.getValue().isBlank() );
+			UT_ASSERT_TRUE( parser.isUTF8() );
+
+			UT_ASSERT_EQUAL( PullParser::etDOCTYPE, parser.next() );
+			UT_ASSERT_EQUAL( STRING(" root"), parser.decodeValue() );
+
+			UT_ASSERT_EQUAL( PullParser::etSTART_TAG, parser.next() );
+			UT_ASSERT_TRUE( parser.getName() == "root" );
+
+			UT_ASSERT_EQUAL( PullParser::etATTRIBUTE, parser.next() );
+			UT_ASSERT_TRUE( parser.getName() == "a" );
+			UT_ASSERT_TRUE( parser.getValue() == "x&amp;y&#65;&#x42;" );
+			UT_ASSERT_TRUE( parser.getValue().begin() >= xml && parser.getValue().end() < xml+sizeof(xml) );
+			UT_ASSERT_EQUAL( STRING("x&yAB"), parser.decodeValue() );
+
+			UT_ASSERT_EQUAL( PullParser::etCOMMENT, parser.next() );
+			UT_ASSERT_TRUE( parser.getValue() == " comment " );
+
+			UT_ASSERT_EQUAL( PullParser::etCDATA, parser.next() );
+			UT_ASSERT_EQUAL( STRING("<&amp;>"), parser.decodeValue() );
+
+			UT_ASSERT_EQUAL( PullParser::etPROCESSING_INSTRUCTION, parser.next() );
+			UT_ASSERT_TRUE( parser.getName() == "target" );
+			UT_ASSERT_TRUE( parser.getValue() == " some data" );
+
+			UT_ASSERT_EQUAL( PullParser::etSTART_TAG, parser.next() );
+			UT_ASSERT_TRUE( parser.getName() == "empty" );
+			UT_ASSERT_EQUAL( PullParser::etEND_TAG, parser.next() );
+			UT_ASSERT_TRUE( parser.isEmptyElement() );
+
+			UT_ASSERT_EQUAL( PullParser::etEND_TAG, parser.next() );
+			UT_ASSERT_TRUE( parser.getName() == "root" );
+			UT_ASSERT_FALSE( parser.isEmptyElement() );
+
+			UT_ASSERT_EQUAL( PullParser::etEND_DOCUMENT, parser.next() );
+			UT_ASSERT_TRUE( parser.getErrors().isEmpty() );
+		}
+		{
+			// the position is computed on demand
+			const char	xml[] = "<root>\n<record a=\"1\" b";
+			PullParser	parser( xml, sizeof(xml)-1, "internal" );
+
+			while( parser.next() != PullParser::etEND_DOCUMENT )
+				;
+			UT_ASSERT_EQUAL( size_t(2), parser.getPosition().m_lineNo );
+			UT_ASSERT_FALSE( parser.getErrors().isEmpty() );
+		}
+	}
+
+	void xpathTest()
+	{
+		TestScope scope( "xpathTest" );
+
+		STRING			xmlCode =
+			"<root>"
+			"<item id=\"1\" v=\"3\">a</item>"
+			"<item id=\"2\" v=\"4\">b<sub id=\"5\">c</sub></item>"
+			"<other id=\"3\"/>"
+			"<item id=\"4\" v=\"5\">d</item>"
+			"</root>"
+		;
+		iSTRINGstream				str( xmlCode );
+		Parser						theParser( &str, "internal" );
+		std::unique_ptr<Document>	theDoc( theParser.readFile( false ) );
+		Element						*root = theDoc->getElement( "root" );
+		XmlArray					source;
+
+		source += root;
+		source.first();
+
+		// expressions
+		UT_ASSERT_EQUAL( STRING("14"), evaluate( "(3 + 4) * 2", &source ) );
+		UT_ASSERT_EQUAL( STRING("1"), evaluate( "7 mod 3", &source ) );
+		UT_ASSERT_EQUAL( STRING("NaN"), evaluate( "7 div 0", &source ) );
+		UT_ASSERT_EQUAL( STRING("text"), evaluate( " 'text' ", &source ) );
+		UT_ASSERT_EQUAL( STRING("1"), evaluate( "item[2]/@id = 2 and other/@id != 2", &source ) );
+		UT_ASSERT_EQUAL( STRING("0"), evaluate( "item[3]/@id = 2 || other/@id = 2", &source ) );
+		UT_ASSERT_EQUAL( STRING("7"), evaluate( "item[1]/@v + item[2]/@v", &source ) );
+		UT_ASSERT_EQUAL( STRING("14"), evaluate( "item[@v != 4]/@id", &source ) );
+		UT_ASSERT_EQUAL( STRING("1"), evaluate( "position()", &source ) );
+		UT_ASSERT_EQUAL( STRING(""), evaluate( "item[0]/@id", &source ) );
+
+		// location paths
+		UT_ASSERT_EQUAL( STRING("124"), valueOf( &source, "item/@id" ) );
+		UT_ASSERT_EQUAL( STRING("5"), valueOf( &source, "descendant::sub/@id" ) );
+		UT_ASSERT_EQUAL( STRING("5"), valueOf( &source, "item/sub/@id" ) );
+
+		XmlArray	subSource;
+		subSource += root->findElement( "sub" );
+		subSource.first();
+		UT_ASSERT_EQUAL( STRING("2"), valueOf( &subSource, "../@id" ) );
+		UT_ASSERT_EQUAL( STRING("1"), valueOf( &subSource, "/root/item[1]/@id" ) );
+		UT_ASSERT_EQUAL( STRING("c"), valueOf( &subSource, "." ) );
+
+		XmlArray	itemSource;
+		itemSource += root->getElement( size_t(0) );
+		itemSource.first();
+		UT_ASSERT_EQUAL( STRING("234"), valueOf( &itemSource, "following-sibling::*/@id" ) );
+		UT_ASSERT_EQUAL( STRING("2534"), valueOf( &itemSource, "following::*/@id" ) );
+
+		// the streamed axis visit the same elements like the old functions
+		XmlArray	expected, found;
+		root->getDescendants( &expected, true );
+		root->locateElements( "descendant::*", &found, true );
+		UT_ASSERT_EQUAL( expected.size(), found.size() );
+		for( size_t i=0; i<expected.size() && i<found.size(); ++i )
+		{
+			UT_ASSERT_TRUE( expected[i] == found[i] );
+		}
+
+		Element	*last = root->getElement( size_t(3) );
+		expected.clear();
+		found.clear();
+		last->getPrecedings( &expected, false );
+		last->locateElements( "preceding::*", &found, false );
+		UT_ASSERT_EQUAL( size_t(4), found.size() );
+		UT_ASSERT_EQUAL( expected.size(), found.size() );
+		for( size_t i=0; i<expected.size() && i<found.size(); ++i )
+		{
+			UT_ASSERT_TRUE( expected[i] == found[i] );
+		}
+
+		bool	isFound;
+		UT_ASSERT_EQUAL(
+			size_t(3),
+			XPathExpression::compileSelect( "item" )->getLocation().count(
+				root, last, &isFound, false
+			)
+		);
+		UT_ASSERT_TRUE( isFound );
+
+		// the cache
+		XPathExpressionPtr	first = XPathExpression::compile( "1 + 2" );
+		UT_ASSERT_EQUAL( XPathExpression::etOPERATOR, first->getType() );
+		UT_ASSERT_TRUE( first == XPathExpression::compile( "1 + 2" ) );
+		UT_ASSERT_TRUE( first != XPathExpression::compileSelect( "1 + 2" ) );
+		for( size_t i=0; i<XPATH_CACHE_SIZE; ++i )
+		{
+			XPathExpression::compile( formatNumber( i ) );
+		}
+		UT_ASSERT_TRUE( first != XPathExpression::compile( "1 + 2" ) );
+		UT_ASSERT_EQUAL( STRING("3"), first->evaluate( &source ) );
+	}
+
+	void atomTest()
+	{
+		TestScope scope( "atomTest" );
+
+		Atom	node( "node" );
+		Atom	xsNode( STRING("xs:node") );
+
+		UT_ASSERT_TRUE( node == Atom( STRING("node") ) );
+		UT_ASSERT_TRUE( node == Atom( "node-", 4, false ) );
+		UT_ASSERT_TRUE( node != Atom( "Node" ) );
+		UT_ASSERT_TRUE( node == xsNode.getLocalName() );
+		UT_ASSERT_TRUE( node == node.getLocalName() );
+		UT_ASSERT_EQUAL( STRING("xs:node"), xsNode.getName() );
+		UT_ASSERT_TRUE( Atom().isNull() );
+		UT_ASSERT_TRUE( Atom( "" ) == Atom() );
+		UT_ASSERT_EQUAL( size_t(0), Atom().getId() );
+		UT_ASSERT_TRUE( Atom().getName().isEmpty() );
+
+		// the character set is part of the name
+		Atom	ansi( "\xE4" );
+		Atom	utf8( "\xE4", 1, true );
+		UT_ASSERT_TRUE( ansi != utf8 );
+		UT_ASSERT_EQUAL( STR_ANSI, ansi.getName().getCharSet() );
+		UT_ASSERT_EQUAL( STR_UTF8, utf8.getName().getCharSet() );
+		UT_ASSERT_TRUE( ansi == Atom( STRING("\xE4") ) );
+
+		// more names than the initial table size
+		size_t	numAtoms = Atom::getNumAtoms();
+		for( size_t i=0; i<1000; ++i )
+		{
+			STRING	name = "atomTest" + formatNumber( i );
+			UT_ASSERT_EQUAL( name, Atom( name ).getName() );
+		}
+		UT_ASSERT_EQUAL( numAtoms+1000, Atom::getNumAtoms() );
+		UT_ASSERT_TRUE( node == Atom( "node" ) );
+
+		// a full table does not grow, new names are compared by their characters
+		Atom::setMaxTableSize( Atom::getTableSize() );
+		Atom	full( "atomTestFull:local" );
+		UT_ASSERT_FALSE( full.isInterned() );
+		UT_ASSERT_FALSE( full.isNull() );
+		UT_ASSERT_EQUAL( size_t(0), full.getId() );
+		UT_ASSERT_EQUAL( STRING("atomTestFull:local"), full.getName() );
+		UT_ASSERT_TRUE( full == Atom( STRING("atomTestFull:local") ) );
+		UT_ASSERT_TRUE( full != Atom( "atomTestFull" ) );
+		UT_ASSERT_TRUE( full != Atom() );
+		UT_ASSERT_EQUAL( hashValue( full ), hashValue( Atom( "atomTestFull:local" ) ) );
+		UT_ASSERT_EQUAL( STRING("local"), full.getLocalName().getName() );
+		UT_ASSERT_TRUE( Atom( "xs:node" ).isInterned() );
+		UT_ASSERT_TRUE( node == Atom( "atomTestFull:node" ).getLocalName() );
+		{
+			STRING						fullCode = "<atomTestDoc><atomTestChild/></atomTestDoc>";
+			iSTRINGstream				str( fullCode );
+			Parser						theParser( &str, "internal" );
+			std::unique_ptr<Document>	theDoc( theParser.readFile( false ) );
+
+			UT_ASSERT_TRUE( Atom( "atomTestChild" ) == theDoc->getRoot()->getElement( size_t(0) )->getTagAtom() );
+		}
+		UT_ASSERT_EQUAL( numAtoms+1000, Atom::getNumAtoms() );
+		Atom::setMaxTableSize( XML_ATOM_TABLE_SIZE );
+
+		// both parsers intern the names
+		STRING						xmlCode = "<root><node id=\"1\"/><xs:node id=\"2\"/></root>";
+		iSTRINGstream				str( xmlCode );
+		Parser						theParser( &str, "internal" );
+		std::unique_ptr<Document>	theDoc( theParser.readFile( false ) );
+		Element						*root = theDoc->getRoot();
+
+		UT_ASSERT_TRUE( node == root->getElement( size_t(0) )->getTagAtom() );
+		UT_ASSERT_TRUE( xsNode == root->getElement( size_t(1) )->getTagAtom() );
+		UT_ASSERT_TRUE( node == root->getElement( size_t(1) )->getLocalNameAtom() );
+		UT_ASSERT_TRUE(
+			(const char *)node.getName()
+			== (const char *)root->getElement( size_t(0) )->getTag()
+		);
+		UT_ASSERT_TRUE(
+			(const char *)Atom( "id" ).getName()
+			== (const char *)root->getElement( size_t(0) )->getAttributeName( 0 )
+		);
+
+		PullParser	pull( xmlCode, xmlCode.strlen() );
+		pull.next();
+		pull.next();
+		UT_ASSERT_EQUAL( PullParser::etSTART_TAG, pull.getEvent() );
+		UT_ASSERT_TRUE( node == pull.getNameAtom() );
+		UT_ASSERT_TRUE( (const char *)node.getName() == (const char *)pull.nameToString() );
+	}
+
+	void indexTest()
+	{
+		TestScope scope( "indexTest" );
+
+		STRING	xmlCode = "<root><head id=\"top\"/><body>";
+		for( int i=0; i<40; ++i )
+		{
+			xmlCode += "<p id=\"p";
+			xmlCode += formatNumber( i );
+			xmlCode += i % 3 ? "\">" : "\" class=\"u big\">";
+			xmlCode += i == 30 ? "<em><b/></em>" : "text";
+			xmlCode += "</p>";
+		}
+		xmlCode += "<b id=\"last\"/></body></root>";
+
+		iSTRINGstream				str( xmlCode );
+		Parser						theParser( &str, "internal" );
+		std::unique_ptr<Document>	theDoc( theParser.readFile( false ) );
+		Element						*root = theDoc->getRoot();
+		Element						*body = root->getElement( "body" );
+
+		// the results with and without index are the same
+		Element	*expectedB = root->findElement( "b" );
+		Element	*expectedEm = theDoc->findElement( "em" );
+		Element	*expectedBody = theDoc->findElement( "body" );
+		Element	*expectedLast = body->getElement( "b" );
+		UT_ASSERT_EQUAL( STRING("em"), expectedEm->getTag() );
+		UT_ASSERT_EQUAL( STRING("last"), expectedLast->getId() );
+		// the children are searched before the grand children
+		UT_ASSERT_TRUE( expectedB == expectedLast );
+
+		theDoc->enableIndex();
+		UT_ASSERT_TRUE( expectedB == root->findElement( "b" ) );
+		UT_ASSERT_TRUE( expectedEm == theDoc->findElement( "em" ) );
+		UT_ASSERT_TRUE( expectedEm->getElement( size_t(0) ) == expectedEm->findElement( "b" ) );
+		UT_ASSERT_TRUE( expectedBody == theDoc->findElement( "body" ) );
+		UT_ASSERT_TRUE( expectedLast == body->getElement( "b" ) );
+		UT_ASSERT_TRUE( NULL == body->getElement( "em" ) );
+		UT_ASSERT_TRUE( NULL == body->findElement( "head" ) );
+
+		Element	*p10 = theDoc->getElementById( "p10" );
+		UT_ASSERT_TRUE( p10 == body->getElement( size_t(10) ) );
+		UT_ASSERT_TRUE( NULL == theDoc->getElementById( "P10" ) );
+		UT_ASSERT_EQUAL( size_t(14), theDoc->getIndex().getElementsByClass( "u" )->size() );
+
+		// changes of the tree invalidate the index
+		p10->setStringAttribute( "id", "ten" );
+		UT_ASSERT_TRUE( NULL == theDoc->getElementById( "p10" ) );
+		UT_ASSERT_TRUE( p10 == theDoc->getElementById( "ten" ) );
+
+		Element	*newEm = body->getElement( size_t(0) )->addObject( new Any( "em" ) );
+		UT_ASSERT_TRUE( newEm == theDoc->findElement( "em" ) );
+		delete body->getElement( size_t(0) )->removeObject( newEm );
+		UT_ASSERT_TRUE( expectedEm == theDoc->findElement( "em" ) );
+
+		// css
+		theDoc->readCssRules( ".u { text-decoration: underline }", false );
+		theDoc->applyCssRules();
+		for( size_t i=0; i<40; ++i )
+		{
+			UT_ASSERT_EQUAL(
+				i % 3 ? 0 : css::DECO_FLAG_UNDERLINE,
+				body->getElement( i )->getTextDecorations() & css::DECO_FLAG_UNDERLINE
+			);
+		}
+	}
+
 	virtual void PerformTest()
 	{
 		doEnterFunctionEx(gakLogging::llInfo, "XmlTest::PerformTest");
 		TestScope scope( "PerformTest" );
+		pullParserTest();
+		xpathTest();
+		indexTest();
+		atomTest();
 		{
 			Any		theRoot( "root" );
 			Any		*theRecord;
@@ -39,7 +39,7 @@
 // --------------------------------------------------------------------- //
 
 #include <gak/osm.h>
-#include <gak/xmlParser.h>
+#include <gak/xmlPullParser.h>
 #include <gak/types.h>
 #include <gak/iostream.h>
 #include <gak/stopWatch.h>
@@ -69,21 +69,26 @@ using namespace math;
 // ----- constants ----------------------------------------------------- //
 // --------------------------------------------------------------------- //
 
+/*
+	the parser interns all names, equal names share their buffer and are
+	compared without comparing the characters
+*/
+
 // element tags
-static const STRING NODE = "node";
-static const STRING WAY = "way";
-static const STRING RELATION = "relation";
-static const STRING ND = "nd";
-static const STRING TAG = "tag";
-static const STRING MEMBER = "member";
+static const STRING NODE = Atom( "node" ).getName();
+static const STRING WAY = Atom( "way" ).getName();
+static const STRING RELATION = Atom( "relation" ).getName();
+static const STRING ND = Atom( "nd" ).getName();
+static const STRING TAG = Atom( "tag" ).getName();
+static const STRING MEMBER = Atom( "member" ).getName();
 
 // attribute names
-static const STRING ID = "id";
-static const STRING K = "k";
-static const STRING V = "v";
-static const STRING TYPE = "type";
-static const STRING ROLE = "role";
-static const STRING REF = "ref";
+static const STRING ID = Atom( "id" ).getName();
+static const STRING K = Atom( "k" ).getName();
+static const STRING V = Atom( "v" ).getName();
+static const STRING TYPE = Atom( "type" ).getName();
+static const STRING ROLE = Atom( "role" ).getName();
+static const STRING REF = Atom( "ref" ).getName();
 
 
 // attribute values
@@ -1302,7 +1307,7 @@ static STRING osm( const CommandLine &cmdLine, const STRING &iOsmFile)
 
 	if(mapFile.isNullPtr())
 		mapFile = resultFile;
-	gak::xml::Parser	myParser( osmName );
+	gak::xml::PullParser	myParser( osmName );
 	XmlProcessor		myProcessor(buildTiles, osmPath);
 
 	std::cout	<< sizeof( OSMviewer::link_container_type::value_type ) << ' ' 